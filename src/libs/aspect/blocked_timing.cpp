@@ -38,6 +38,27 @@ namespace fawkes {
  * Your thread must run in Thread::OPMODE_WAITFORWAKEUP mode, otherwise it
  * is not started. This is a requirement for having the BlockedTimingAspect.
  *
+ * By default each thread runs its loop in its own pthread which is woken up
+ * at the hook. Threads which do not block, e.g. on I/O, may instead choose
+ * EXECUTION_MODE_POOL. Then the executor runs the loop as a task on a thread
+ * pool sized to the number of CPU cores. The hook order and the guarantee
+ * that all threads of a hook have finished before the next hook starts are
+ * the same for both modes. A pooled thread has no pthread of its own and
+ * must not assume that loop() is always executed in the same pthread.
+ *
+ * Threads in EXECUTION_MODE_DATAFLOW additionally declare the interfaces
+ * they read and write with add_blocked_timing_read() and
+ * add_blocked_timing_write() in their constructor or init(). Such a thread
+ * may start before its hook, as soon as all dataflow threads of earlier
+ * hooks which write an interface it reads, or read an interface it writes,
+ * have finished in the current main loop iteration. If it does not read
+ * any interface written by another dataflow thread it is started at its
+ * hook. It is still guaranteed to have finished before the next hook starts.
+ * This allows independent processing chains to overlap across hooks. The
+ * declarations must be complete, in particular the thread must not depend
+ * on data produced by non-dataflow threads of earlier hooks in the same
+ * iteration. Dataflow threads do not emit the end syncpoint of their hook.
+ *
  * @see Thread::OpMode
  * @ingroup Aspects
  * @author Tim Niemueller
@@ -49,15 +70,25 @@ namespace fawkes {
 /** Constructor.
  * This special constructor is needed to define the wakeup point.
  * @param wakeup_hook hook when this thread should be woken up
+ * @param execution_mode how the loop of the thread is executed
  */
-BlockedTimingAspect::BlockedTimingAspect(WakeupHook wakeup_hook)
+BlockedTimingAspect::BlockedTimingAspect(WakeupHook wakeup_hook, ExecutionMode execution_mode)
 : SyncPointAspect(SyncPoint::WAIT_FOR_ALL,
-                  blocked_timing_hook_to_start_syncpoint(wakeup_hook),
-                  blocked_timing_hook_to_end_syncpoint(wakeup_hook))
+                  // pooled threads are scheduled by the executor once the
+                  // start syncpoint has been emitted and must not wait for it
+                  execution_mode == EXECUTION_MODE_THREAD
+                    ? blocked_timing_hook_to_start_syncpoint(wakeup_hook)
+                    : "",
+                  // the executor tracks completion of dataflow threads, they
+                  // may finish before the main loop waits for the hook
+                  execution_mode == EXECUTION_MODE_DATAFLOW
+                    ? ""
+                    : blocked_timing_hook_to_end_syncpoint(wakeup_hook))
 {
 	add_aspect("BlockedTimingAspect");
-	wakeup_hook_   = wakeup_hook;
-	loop_listener_ = new BlockedTimingLoopListener();
+	wakeup_hook_    = wakeup_hook;
+	execution_mode_ = execution_mode;
+	loop_listener_  = new BlockedTimingLoopListener();
 }
 
 /** Virtual empty destructor. */
@@ -68,13 +99,19 @@ BlockedTimingAspect::~BlockedTimingAspect()
 
 /** Init BlockedTiming aspect.
  * This intializes the aspect and adds the loop listener to the thread.
+ * Threads executed on the pool of the executor are marked as pooled,
+ * such that no pthread is started for them.
  * @param thread thread which uses this aspect
  */
 void
 BlockedTimingAspect::init_BlockedTimingAspect(Thread *thread)
 {
-	thread->add_loop_listener(loop_listener_);
-	thread->wakeup();
+	if (execution_mode_ == EXECUTION_MODE_THREAD) {
+		thread->add_loop_listener(loop_listener_);
+		thread->wakeup();
+	} else {
+		thread->set_pooled(true);
+	}
 }
 
 /** Finalize BlockedTiming aspect.
@@ -84,7 +121,9 @@ BlockedTimingAspect::init_BlockedTimingAspect(Thread *thread)
 void
 BlockedTimingAspect::finalize_BlockedTimingAspect(Thread *thread)
 {
-	thread->remove_loop_listener(loop_listener_);
+	if (execution_mode_ == EXECUTION_MODE_THREAD) {
+		thread->remove_loop_listener(loop_listener_);
+	}
 }
 
 /** Get the wakeup hook.
@@ -98,6 +137,57 @@ BlockedTimingAspect::blockedTimingAspectHook() const
 	return wakeup_hook_;
 }
 
+/** Get the execution mode.
+ * The execution mode defines whether the loop runs in the thread's own
+ * pthread or on the thread pool of the executor.
+ * @return execution mode
+ */
+BlockedTimingAspect::ExecutionMode
+BlockedTimingAspect::blockedTimingAspectExecutionMode() const
+{
+	return execution_mode_;
+}
+
+/** Declare interface read by the thread.
+ * Only used in EXECUTION_MODE_DATAFLOW. Must be called before the thread
+ * has been added to the executor, i.e. in the constructor or in init().
+ * @param interface_uid unique ID of the interface, i.e. Type::ID
+ */
+void
+BlockedTimingAspect::add_blocked_timing_read(const char *interface_uid)
+{
+	reads_.insert(interface_uid);
+}
+
+/** Declare interface written by the thread.
+ * Only used in EXECUTION_MODE_DATAFLOW. Must be called before the thread
+ * has been added to the executor, i.e. in the constructor or in init().
+ * @param interface_uid unique ID of the interface, i.e. Type::ID
+ */
+void
+BlockedTimingAspect::add_blocked_timing_write(const char *interface_uid)
+{
+	writes_.insert(interface_uid);
+}
+
+/** Get interfaces read by the thread.
+ * @return unique IDs of interfaces declared with add_blocked_timing_read()
+ */
+const std::set<std::string> &
+BlockedTimingAspect::blocked_timing_reads() const
+{
+	return reads_;
+}
+
+/** Get interfaces written by the thread.
+ * @return unique IDs of interfaces declared with add_blocked_timing_write()
+ */
+const std::set<std::string> &
+BlockedTimingAspect::blocked_timing_writes() const
+{
+	return writes_;
+}
+
 /** Get string for wakeup hook.
  * @param hook wakeup hook to get string for
  * @return string representation of hook
@@ -29,6 +29,7 @@
 #include <core/threading/thread_loop_listener.h>
 
 #include <map>
+#include <set>
 #include <string>
 
 namespace fawkes {
@@ -70,7 +71,20 @@ public:
 		WAKEUP_HOOK_POST_LOOP       /**< run after loop */
 	} WakeupHook;
 
-	BlockedTimingAspect(WakeupHook wakeup_hook);
+	/** Type to define how the loop of the thread is executed.
+   * @see BlockedTimingExecutor
+   */
+	typedef enum {
+		EXECUTION_MODE_THREAD,  /**< loop runs in the thread's own pthread, which
+                             *  is woken up for each hook (default) */
+		EXECUTION_MODE_POOL,    /**< loop runs as a task on the thread pool of
+                             *  the executor */
+		EXECUTION_MODE_DATAFLOW /**< loop runs as a task on the thread pool of
+                             *  the executor as soon as the threads writing
+                             *  the interfaces it reads have finished */
+	} ExecutionMode;
+
+	BlockedTimingAspect(WakeupHook wakeup_hook, ExecutionMode execution_mode = EXECUTION_MODE_THREAD);
 	virtual ~BlockedTimingAspect();
 
 	static const char *blocked_timing_hook_to_string(WakeupHook hook);
@@ -81,16 +95,27 @@ public:
 	void init_BlockedTimingAspect(Thread *thread);
 	void finalize_BlockedTimingAspect(Thread *thread);
 
-	WakeupHook blockedTimingAspectHook() const;
+	WakeupHook    blockedTimingAspectHook() const;
+	ExecutionMode blockedTimingAspectExecutionMode() const;
+
+	const std::set<std::string> &blocked_timing_reads() const;
+	const std::set<std::string> &blocked_timing_writes() const;
 
 	/** Translation from WakeupHooks to SyncPoints. Each WakeupHook corresponds to
    *  exactly one SyncPoint, e.g., WAKEUP_HOOK_PRE_LOOP becomes /preloop.
    */
 	static const std::map<const WakeupHook, const std::string> hook_to_syncpoint;
 
+protected:
+	void add_blocked_timing_read(const char *interface_uid);
+	void add_blocked_timing_write(const char *interface_uid);
+
 private:
 	WakeupHook                 wakeup_hook_;
+	ExecutionMode              execution_mode_;
 	BlockedTimingLoopListener *loop_listener_;
+	std::set<std::string>      reads_;
+	std::set<std::string>      writes_;
 };
 
 } // end namespace fawkes
@@ -49,6 +49,33 @@ namespace fawkes {
  * @param barrier optional barrier that can be used to synchronize to the
  * end of the loop execution of the threads.
  *
+ * @fn void BlockedTimingExecutor::run_pooled(BlockedTimingAspect::WakeupHook hook)
+ * Run pooled threads for given hook.
+ * This schedules one loop iteration of each thread registered for the given
+ * hook with BlockedTimingAspect::EXECUTION_MODE_POOL on the thread pool of
+ * the executor and returns immediately. Threads with their own pthread are
+ * not affected, they are woken up by the start syncpoint of the hook. The
+ * pooled threads emit the end syncpoint of the hook when their loop has
+ * finished, hence waiting for the end syncpoint waits for both kinds of
+ * threads. If the previous iteration of a thread is still running, another
+ * iteration is run right after it has finished.
+ *
+ * Threads with BlockedTimingAspect::EXECUTION_MODE_DATAFLOW of the hook
+ * which have not been started early, because all threads they depend on
+ * have finished already, are started as well. Use wait_pooled() to wait
+ * for them.
+ * @param hook hook for which to run the pooled threads
+ *
+ * @fn void BlockedTimingExecutor::wait_pooled(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec = 0)
+ * Wait for dataflow threads of given hook.
+ * Waits until the loops of all threads of the given hook with
+ * BlockedTimingAspect::EXECUTION_MODE_DATAFLOW started in the current
+ * main loop iteration have finished. These threads do not emit the end
+ * syncpoint of the hook.
+ * @param hook hook for which to wait
+ * @param timeout_usec timeout in microseconds, 0 to wait forever
+ * @exception TimeoutException thrown if the threads did not finish in time
+ *
  * @fn void BlockedTimingExecutor::try_recover(std::list<std::string> &recovered_threads)
  * Try to recover threads.
  * An advanced BlockedTimingExecutor might be able to detect deadlocked threads.
@@ -41,6 +41,9 @@ public:
 	virtual void wakeup_and_wait(BlockedTimingAspect::WakeupHook hook,
 	                             unsigned int                    timeout_usec = 0)                     = 0;
 	virtual void wakeup(BlockedTimingAspect::WakeupHook hook, Barrier *barrier = 0) = 0;
+	virtual void run_pooled(BlockedTimingAspect::WakeupHook hook)                   = 0;
+	virtual void wait_pooled(BlockedTimingAspect::WakeupHook hook,
+	                         unsigned int                    timeout_usec = 0)                         = 0;
 
 	virtual void try_recover(std::list<std::string> &recovered_threads) = 0;
 
@@ -0,0 +1,326 @@
+
+/***************************************************************************
+ *  dataflow_scheduler.cpp - Dependency-aware scheduling of hook threads
+ *
+ *  Created: Fri Oct 16 21:05:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <baseapp/dataflow_scheduler.h>
+#include <baseapp/thread_loop_pool.h>
+#include <core/exceptions/software.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+
+namespace fawkes {
+
+/** @class DataflowScheduler <baseapp/dataflow_scheduler.h>
+ * Dependency-aware scheduler for dataflow hook threads.
+ * Threads with BlockedTimingAspect::EXECUTION_MODE_DATAFLOW declare the
+ * interfaces they read and write. From these declarations the scheduler
+ * derives a dependency graph. A thread depends on every dataflow thread of
+ * an earlier hook which writes an interface it reads or writes, or which
+ * reads an interface it writes. Since edges only point from earlier to
+ * later hooks the graph is acyclic.
+ *
+ * In each main loop iteration a thread is started as soon as all of its
+ * dependencies have finished, if at least one of them produces data the
+ * thread reads. This may be before the hook of the thread. Threads which
+ * have not been started early are started when their hook is run. The
+ * main loop waits for all dataflow threads of a hook before continuing
+ * with the next hook, hence the order guarantees of the hooks still hold.
+ *
+ * The loops are executed on a ThreadLoopPool whose completion callback
+ * must be forwarded to loop_finished().
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param pool thread pool to execute loops on
+ */
+DataflowScheduler::DataflowScheduler(ThreadLoopPool *pool)
+{
+	pool_          = pool;
+	mutex_         = new Mutex();
+	done_cond_     = new WaitCondition(mutex_);
+	last_hook_     = BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP;
+	cycle_started_ = false;
+}
+
+/** Destructor. */
+DataflowScheduler::~DataflowScheduler()
+{
+	for (auto &n : nodes_) {
+		delete n.second;
+	}
+	delete done_cond_;
+	delete mutex_;
+}
+
+/** Add thread.
+ * The thread must have the BlockedTimingAspect. It must have been added to
+ * the thread pool before it is run the first time.
+ * @param thread thread to add
+ */
+void
+DataflowScheduler::add(Thread *thread)
+{
+	BlockedTimingAspect *aspect = dynamic_cast<BlockedTimingAspect *>(thread);
+	if (!aspect) {
+		throw IllegalArgumentException("Thread %s does not have the BlockedTimingAspect",
+		                               thread->name());
+	}
+
+	MutexLocker lock(mutex_);
+	if (nodes_.find(thread) != nodes_.end())
+		return;
+
+	Node *node           = new Node();
+	node->thread         = thread;
+	node->aspect         = aspect;
+	node->hook           = aspect->blockedTimingAspectHook();
+	node->remaining      = 0;
+	node->started        = false;
+	node->done           = false;
+	node->running        = false;
+	node->start_deferred = false;
+	nodes_[thread]       = node;
+
+	rebuild_graph();
+}
+
+/** Remove thread.
+ * Afterwards loop_finished() calls for the thread are ignored.
+ * @param thread thread to remove
+ */
+void
+DataflowScheduler::remove(Thread *thread)
+{
+	MutexLocker lock(mutex_);
+	std::map<Thread *, Node *>::iterator n = nodes_.find(thread);
+	if (n == nodes_.end())
+		return;
+
+	delete n->second;
+	nodes_.erase(n);
+	rebuild_graph();
+	// waiters must not wait for the removed thread
+	done_cond_->wake_all();
+}
+
+/** Check if no threads have been added.
+ * @return true if the scheduler has no threads, false otherwise
+ */
+bool
+DataflowScheduler::empty() const
+{
+	MutexLocker lock(mutex_);
+	return nodes_.empty();
+}
+
+/** Rebuild dependency graph.
+ * Must be called with the mutex locked. Nodes which are currently running
+ * keep their state, the new graph is used from the next iteration.
+ */
+void
+DataflowScheduler::rebuild_graph()
+{
+	for (auto &n : nodes_) {
+		n.second->dependents.clear();
+		n.second->num_dependencies = 0;
+		n.second->has_producers    = false;
+	}
+
+	for (auto &a : nodes_) {
+		Node *                       from        = a.second;
+		const std::set<std::string> &from_reads  = from->aspect->blocked_timing_reads();
+		const std::set<std::string> &from_writes = from->aspect->blocked_timing_writes();
+		for (auto &b : nodes_) {
+			Node *to = b.second;
+			if (from->hook >= to->hook)
+				continue;
+
+			const std::set<std::string> &to_reads  = to->aspect->blocked_timing_reads();
+			const std::set<std::string> &to_writes = to->aspect->blocked_timing_writes();
+
+			bool produces = std::any_of(to_reads.begin(), to_reads.end(), [&](const std::string &uid) {
+				return from_writes.find(uid) != from_writes.end();
+			});
+			bool conflicts =
+			  std::any_of(to_writes.begin(), to_writes.end(), [&](const std::string &uid) {
+				  return (from_reads.find(uid) != from_reads.end())
+				         || (from_writes.find(uid) != from_writes.end());
+			  });
+
+			if (produces || conflicts) {
+				from->dependents.push_back(to);
+				to->num_dependencies += 1;
+				if (produces)
+					to->has_producers = true;
+			}
+		}
+	}
+}
+
+/** Begin a new main loop iteration.
+ * Must be called with the mutex locked.
+ */
+void
+DataflowScheduler::begin_cycle()
+{
+	for (auto &n : nodes_) {
+		n.second->remaining = n.second->num_dependencies;
+		n.second->started   = false;
+		n.second->done      = false;
+	}
+	cycle_started_ = true;
+}
+
+/** Start a node in the current iteration.
+ * Must be called with the mutex locked. If the loop of the previous
+ * iteration is still running the start is deferred until it has finished.
+ * @param node node to start
+ * @param to_execute the thread is appended if it must be passed to the pool
+ */
+void
+DataflowScheduler::start(Node *node, std::list<Thread *> &to_execute)
+{
+	node->started = true;
+	if (node->running) {
+		node->start_deferred = true;
+	} else {
+		node->running = true;
+		to_execute.push_back(node->thread);
+	}
+}
+
+/** Run threads of a hook.
+ * Starts all dataflow threads of the given hook which have not been started
+ * early. Running the first hook of an iteration begins a new iteration.
+ * @param hook hook to run
+ */
+void
+DataflowScheduler::run_hook(BlockedTimingAspect::WakeupHook hook)
+{
+	std::list<Thread *> to_execute;
+
+	mutex_->lock();
+	if (!cycle_started_ || hook <= last_hook_) {
+		begin_cycle();
+	}
+	last_hook_ = hook;
+
+	for (auto &n : nodes_) {
+		if (n.second->hook == hook && !n.second->started) {
+			start(n.second, to_execute);
+		}
+	}
+	mutex_->unlock();
+
+	if (!to_execute.empty()) {
+		pool_->execute(to_execute);
+	}
+}
+
+/** Check if all threads of a hook are done.
+ * Must be called with the mutex locked.
+ * @param hook hook to check
+ * @return true if all started threads of the hook have finished
+ */
+bool
+DataflowScheduler::hook_done(BlockedTimingAspect::WakeupHook hook)
+{
+	for (auto &n : nodes_) {
+		if (n.second->hook == hook && n.second->started && !n.second->done) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** Wait for threads of a hook.
+ * @param hook hook to wait for
+ * @param timeout_usec timeout in microseconds, 0 to wait forever
+ * @return true if all threads of the hook have finished, false if the
+ * timeout has been reached
+ */
+bool
+DataflowScheduler::wait_hook(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
+{
+	Time deadline;
+	deadline += (long int)timeout_usec;
+
+	MutexLocker lock(mutex_);
+	while (!hook_done(hook)) {
+		if (timeout_usec == 0) {
+			done_cond_->wait();
+		} else if (!done_cond_->abstimed_wait(deadline.get_sec(), deadline.get_nsec())) {
+			return hook_done(hook);
+		}
+	}
+	return true;
+}
+
+/** Notify that the loop of a thread has finished.
+ * Marks the thread as done for the current iteration and starts every
+ * dependent thread whose dependencies are now all done.
+ * @param thread thread whose loop has finished
+ */
+void
+DataflowScheduler::loop_finished(Thread *thread)
+{
+	std::list<Thread *> to_execute;
+
+	mutex_->lock();
+	std::map<Thread *, Node *>::iterator n = nodes_.find(thread);
+	if (n == nodes_.end()) {
+		mutex_->unlock();
+		return;
+	}
+
+	Node *node    = n->second;
+	node->running = false;
+	if (node->start_deferred) {
+		// finished the loop of a previous iteration, run the current one now
+		node->start_deferred = false;
+		node->running        = true;
+		to_execute.push_back(thread);
+	} else if (node->started && !node->done) {
+		node->done = true;
+		for (Node *d : node->dependents) {
+			if (d->remaining > 0)
+				d->remaining -= 1;
+			if (d->remaining == 0 && d->has_producers && !d->started) {
+				start(d, to_execute);
+			}
+		}
+		done_cond_->wake_all();
+	}
+	mutex_->unlock();
+
+	if (!to_execute.empty()) {
+		pool_->execute(to_execute);
+	}
+}
+
+} // end namespace fawkes
@@ -0,0 +1,90 @@
+
+/***************************************************************************
+ *  dataflow_scheduler.h - Dependency-aware scheduling of hook threads
+ *
+ *  Created: Fri Oct 16 21:05:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_BASEAPP_DATAFLOW_SCHEDULER_H_
+#define _LIBS_BASEAPP_DATAFLOW_SCHEDULER_H_
+
+#include <aspect/blocked_timing.h>
+
+#include <list>
+#include <map>
+
+namespace fawkes {
+
+class Thread;
+class ThreadLoopPool;
+class Mutex;
+class WaitCondition;
+
+class DataflowScheduler
+{
+public:
+	DataflowScheduler(ThreadLoopPool *pool);
+	~DataflowScheduler();
+
+	void add(Thread *thread);
+	void remove(Thread *thread);
+	bool empty() const;
+
+	void run_hook(BlockedTimingAspect::WakeupHook hook);
+	bool wait_hook(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec = 0);
+
+	void loop_finished(Thread *thread);
+
+private:
+	/// @cond INTERNALS
+	typedef struct Node
+	{
+		Thread *                        thread;
+		BlockedTimingAspect *           aspect;
+		BlockedTimingAspect::WakeupHook hook;
+
+		std::list<struct Node *> dependents;
+		unsigned int             num_dependencies;
+		bool                     has_producers;
+
+		unsigned int remaining;
+		bool         started;
+		bool         done;
+		bool         running;
+		bool         start_deferred;
+	} Node;
+	/// @endcond
+
+	void rebuild_graph();
+	void begin_cycle();
+	void start(Node *node, std::list<Thread *> &to_execute);
+	bool hook_done(BlockedTimingAspect::WakeupHook hook);
+
+	ThreadLoopPool *           pool_;
+	std::map<Thread *, Node *> nodes_;
+
+	Mutex *                         mutex_;
+	WaitCondition *                 done_cond_;
+	BlockedTimingAspect::WakeupHook last_hook_;
+	bool                            cycle_started_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -206,21 +206,20 @@ void
 FawkesMainThread::once()
 {
 	// register to all syncpoints of the main loop
-	std::vector<BlockedTimingAspect::WakeupHook> hooks;
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PREPARE);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_THINK);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_SKILL);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT_EXEC);
-	hooks.push_back(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PREPARE);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_WORLDSTATE);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_THINK);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_SKILL);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_ACT_EXEC);
+	hooks_.push_back(BlockedTimingAspect::WAKEUP_HOOK_POST_LOOP);
 
 	try {
-		for (std::vector<BlockedTimingAspect::WakeupHook>::const_iterator it = hooks.begin();
-		     it != hooks.end();
+		for (std::vector<BlockedTimingAspect::WakeupHook>::const_iterator it = hooks_.begin();
+		     it != hooks_.end();
 		     it++) {
 			syncpoints_start_hook_.push_back(syncpoint_manager_->get_syncpoint(
 			  "FawkesMainThread", BlockedTimingAspect::blocked_timing_hook_to_start_syncpoint(*it)));
@@ -344,10 +343,23 @@ FawkesMainThread::loop()
 				  "Hook syncpoints are not initialized properly, not waking up any threads!");
 			} else {
 				for (uint i = 0; i < num_hooks; i++) {
+					// both waits below share the maximum thread time of the hook
+					Time deadline;
+					deadline += (long int)max_thread_time_usec_;
 					syncpoints_start_hook_[i]->emit("FawkesMainThread");
+					// threads running on the pool emit the end syncpoint as well
+					thread_manager_->run_pooled(hooks_[i]);
 					syncpoints_end_hook_[i]->reltime_wait_for_all("FawkesMainThread",
 					                                              0,
 					                                              max_thread_time_nanosec_);
+					// dataflow threads do not emit the end syncpoint
+					try {
+						Time     now;
+						long int remaining_usec = (deadline - now).in_usec();
+						thread_manager_->wait_pooled(hooks_[i], (remaining_usec > 0) ? remaining_usec : 1);
+					} catch (Exception &e) {
+						multi_logger_->log_warn("FawkesMainThread", e);
+					}
 				}
 			}
 		}
@@ -145,8 +145,9 @@ private:
 	Time *                 loop_end_;
 	bool                   enable_looptime_warnings_;
 
-	std::vector<RefPtr<SyncPoint>> syncpoints_start_hook_;
-	std::vector<RefPtr<SyncPoint>> syncpoints_end_hook_;
+	std::vector<BlockedTimingAspect::WakeupHook> hooks_;
+	std::vector<RefPtr<SyncPoint>>               syncpoints_start_hook_;
+	std::vector<RefPtr<SyncPoint>>               syncpoints_end_hook_;
 };
 
 } // end namespace fawkes
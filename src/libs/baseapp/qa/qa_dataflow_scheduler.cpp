@@ -0,0 +1,191 @@
+/***************************************************************************
+ *  qa_dataflow_scheduler.cpp - QA for dataflow scheduling of thread loops
+ *
+ *  Created: Sat Oct 17 00:41:27 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <aspect/blocked_timing.h>
+#include <baseapp/dataflow_scheduler.h>
+#include <baseapp/thread_loop_pool.h>
+#include <core/threading/thread.h>
+
+#include <atomic>
+#include <cstdio>
+#include <list>
+#include <unistd.h>
+
+using namespace fawkes;
+
+#define NUM_CYCLES 100
+
+static std::atomic<unsigned int> sequence(0);
+
+class DataflowThread : public Thread, public BlockedTimingAspect
+{
+public:
+	DataflowThread(const char * name,
+	               WakeupHook   hook,
+	               const char * reads,
+	               const char * writes,
+	               unsigned int sleep_usec = 0)
+	: Thread(name, Thread::OPMODE_WAITFORWAKEUP),
+	  BlockedTimingAspect(hook, BlockedTimingAspect::EXECUTION_MODE_DATAFLOW),
+	  sleep_usec_(sleep_usec)
+	{
+		if (reads)
+			add_blocked_timing_read(reads);
+		if (writes)
+			add_blocked_timing_write(writes);
+		set_pooled(true);
+		loops    = 0;
+		in_loop  = 0;
+		overlap  = false;
+		last_seq = 0;
+	}
+
+	virtual void
+	loop()
+	{
+		if (++in_loop != 1)
+			overlap = true;
+		if (sleep_usec_ > 0)
+			usleep(sleep_usec_);
+		last_seq = ++sequence;
+		loops += 1;
+		--in_loop;
+	}
+
+	std::atomic<unsigned int> loops;
+	std::atomic<int>          in_loop;
+	std::atomic<bool>         overlap;
+	std::atomic<unsigned int> last_seq;
+
+private:
+	unsigned int sleep_usec_;
+};
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static bool
+wait_for(const std::atomic<unsigned int> &value, unsigned int expected)
+{
+	for (unsigned int i = 0; i < 1000 && value < expected; ++i) {
+		usleep(1000);
+	}
+	return value == expected;
+}
+
+int
+main(int argc, char **argv)
+{
+	int               failures = 0;
+	ThreadLoopPool    pool(4);
+	DataflowScheduler dataflow(&pool);
+	pool.set_completion_callback([&dataflow](Thread *t) { dataflow.loop_finished(t); });
+
+	// producer -> consumer across hooks, plus an unrelated thread and a
+	// later thread writing the interface the consumer writes as well
+	DataflowThread producer("Producer", BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE, NULL, "A");
+	DataflowThread consumer("Consumer", BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS, "A", "B");
+	DataflowThread unrelated("Unrelated",
+	                         BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS,
+	                         "C",
+	                         NULL);
+	DataflowThread late_writer("LateWriter", BlockedTimingAspect::WAKEUP_HOOK_ACT, NULL, "B");
+	std::list<DataflowThread *> threads = {&producer, &consumer, &unrelated, &late_writer};
+	for (DataflowThread *t : threads) {
+		t->start();
+		pool.add(t);
+		dataflow.add(t);
+	}
+
+	bool early_ok = true, order_ok = true, done_ok = true;
+	for (unsigned int c = 1; c <= NUM_CYCLES; ++c) {
+		dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE);
+		done_ok =
+		  done_ok && dataflow.wait_hook(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_ACQUIRE, 1000000);
+
+		// the consumer is started as soon as its producer has finished,
+		// threads without producers wait for their hook
+		early_ok = early_ok && wait_for(consumer.loops, c) && (unrelated.loops == c - 1);
+
+		dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS);
+		done_ok =
+		  done_ok && dataflow.wait_hook(BlockedTimingAspect::WAKEUP_HOOK_SENSOR_PROCESS, 1000000);
+		dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_ACT);
+		done_ok = done_ok && dataflow.wait_hook(BlockedTimingAspect::WAKEUP_HOOK_ACT, 1000000);
+
+		order_ok = order_ok && (producer.last_seq < consumer.last_seq)
+		           && (consumer.last_seq < late_writer.last_seq);
+	}
+	failures += check(done_ok, "Hooks finished in time");
+	failures += check(early_ok, "Consumer started early after producer");
+	failures += check(order_ok, "Producer, consumer, writer ordered");
+
+	bool loops_ok = true;
+	for (DataflowThread *t : threads) {
+		loops_ok = loops_ok && (t->loops == NUM_CYCLES) && !t->overlap;
+	}
+	failures += check(loops_ok, "One iteration per thread and cycle");
+
+	// a thread still running from the previous cycle runs once more
+	// afterwards, but never concurrently to itself
+	DataflowThread slow("Slow", BlockedTimingAspect::WAKEUP_HOOK_THINK, NULL, NULL, 50000);
+	slow.start();
+	pool.add(&slow);
+	dataflow.add(&slow);
+	dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_THINK);
+	failures +=
+	  check(!dataflow.wait_hook(BlockedTimingAspect::WAKEUP_HOOK_THINK, 10000), "Wait times out");
+	dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP);
+	dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_THINK);
+	failures += check(dataflow.wait_hook(BlockedTimingAspect::WAKEUP_HOOK_THINK, 1000000)
+	                    && (slow.loops == 2) && !slow.overlap,
+	                  "Deferred start of busy thread");
+
+	// waiters do not wait for a removed thread
+	dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_PRE_LOOP);
+	dataflow.run_hook(BlockedTimingAspect::WAKEUP_HOOK_THINK);
+	dataflow.remove(&slow);
+	failures += check(dataflow.wait_hook(BlockedTimingAspect::WAKEUP_HOOK_THINK, 10000),
+	                  "Removed thread ignored");
+	pool.remove(&slow);
+	slow.cancel();
+	slow.join();
+
+	pool.wait_idle();
+	for (DataflowThread *t : threads) {
+		dataflow.remove(t);
+		pool.remove(t);
+		t->cancel();
+		t->join();
+	}
+	failures += check(dataflow.empty(), "All threads removed");
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -0,0 +1,169 @@
+/***************************************************************************
+ *  qa_thread_loop_pool.cpp - QA for work-stealing thread loop pool
+ *
+ *  Created: Fri Oct 16 23:58:14 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <baseapp/thread_loop_pool.h>
+#include <core/threading/thread.h>
+
+#include <atomic>
+#include <cstdio>
+#include <list>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_THREADS 32
+#define NUM_ROUNDS 200
+
+class PooledThread : public Thread
+{
+public:
+	PooledThread(unsigned int i, unsigned int sleep_usec)
+	: Thread("PooledThread", Thread::OPMODE_WAITFORWAKEUP), sleep_usec_(sleep_usec)
+	{
+		set_name("PooledThread-%u", i);
+		set_pooled(true);
+		loops       = 0;
+		in_loop     = 0;
+		overlap     = false;
+		wrong_self  = false;
+		once_called = false;
+	}
+
+	virtual void
+	once()
+	{
+		once_called = true;
+	}
+
+	virtual void
+	loop()
+	{
+		// only one iteration of a thread may run at a time
+		if (++in_loop != 1)
+			overlap = true;
+		if (Thread::current_thread_noexc() != this)
+			wrong_self = true;
+		if (sleep_usec_ > 0)
+			usleep(sleep_usec_);
+		loops += 1;
+		--in_loop;
+	}
+
+	std::atomic<unsigned int> loops;
+	std::atomic<int>          in_loop;
+	std::atomic<bool>         overlap;
+	std::atomic<bool>         wrong_self;
+	bool                      once_called;
+
+private:
+	unsigned int sleep_usec_;
+};
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+int
+main(int argc, char **argv)
+{
+	int            failures = 0;
+	ThreadLoopPool pool(4);
+
+	std::atomic<unsigned int> completed(0);
+	pool.set_completion_callback([&completed](Thread *) { completed += 1; });
+
+	// some threads take considerably longer, others must be stolen
+	std::vector<PooledThread *> threads;
+	std::list<Thread *>         tlist;
+	for (unsigned int i = 0; i < NUM_THREADS; ++i) {
+		PooledThread *t = new PooledThread(i, (i % 8 == 0) ? 2000 : 0);
+		t->start();
+		pool.add(t);
+		threads.push_back(t);
+		tlist.push_back(t);
+	}
+
+	bool ok = (pool.num_workers() == 4);
+	for (PooledThread *t : threads) {
+		ok = ok && t->started() && t->once_called && (t->thread_id() == 0);
+	}
+	failures += check(ok, "Pooled threads started without pthread");
+
+	for (unsigned int r = 0; r < NUM_ROUNDS; ++r) {
+		pool.execute(tlist);
+		if (!pool.wait(tlist, 1000000)) {
+			failures += check(false, "Round finished in time");
+			break;
+		}
+	}
+	ok = true;
+	for (PooledThread *t : threads) {
+		ok = ok && (t->loops == NUM_ROUNDS) && !t->overlap && !t->wrong_self;
+	}
+	failures += check(ok, "One iteration per thread and round");
+	failures += check(completed == NUM_THREADS * NUM_ROUNDS, "Completion callback");
+
+	// executing a busy thread runs exactly one more iteration afterwards
+	PooledThread *slow = new PooledThread(NUM_THREADS, 50000);
+	slow->start();
+	pool.add(slow);
+	std::list<Thread *> slist;
+	slist.push_back(slow);
+	pool.execute(slist);
+	usleep(10000);
+	pool.execute(slist);
+	pool.execute(slist);
+	pool.execute(slist);
+	failures += check(!pool.wait(slist, 10000), "Wait times out while busy");
+	pool.wait(slist);
+	failures += check(slow->loops == 2 && !slow->overlap, "Requests for busy thread merged");
+
+	// a cancelled thread is not run anymore
+	slow->cancel();
+	slow->join();
+	pool.execute(slist);
+	pool.wait_idle();
+	failures += check(slow->loops == 2, "No iteration after cancel");
+
+	pool.remove(slow);
+	pool.execute(slist);
+	pool.wait_idle();
+	failures += check(slow->loops == 2, "No iteration after remove");
+	delete slow;
+
+	for (PooledThread *t : threads) {
+		pool.remove(t);
+		t->cancel();
+		t->join();
+		delete t;
+	}
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
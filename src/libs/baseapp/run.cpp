@@ -314,8 +314,9 @@ init(const InitOptions &options, int &retval)
 	bool         enable_ipv6 = true;
 	std::string  listen_ipv4;
 	std::string  listen_ipv6;
-	unsigned int net_tcp_port     = 1910;
-	std::string  net_service_name = "Fawkes on %h";
+	unsigned int net_tcp_port        = 1910;
+	std::string  net_service_name    = "Fawkes on %h";
+	unsigned int net_reactor_threads = 0;
 	if (options.has_net_tcp_port()) {
 		net_tcp_port = options.net_tcp_port();
 	} else {
@@ -334,6 +335,11 @@ init(const InitOptions &options, int &retval)
 		} // ignore, we stick with the default
 	}
 
+	try {
+		net_reactor_threads = config->get_uint("/network/fawkes/reactor_threads");
+	} catch (Exception &e) {
+	} // ignore, we stick with the default
+
 	if (net_tcp_port > 65535) {
 		logger->log_warn("FawkesMainThread", "Invalid port '%u', using 1910", net_tcp_port);
 		net_tcp_port = 1910;
@@ -430,7 +436,8 @@ init(const InitOptions &options, int &retval)
 	                                           listen_ipv4,
 	                                           listen_ipv6,
 	                                           net_tcp_port,
-	                                           net_service_name.c_str());
+	                                           net_service_name.c_str(),
+	                                           net_reactor_threads);
 #	ifdef HAVE_CONFIG_NETWORK_HANDLER
 	nethandler_config = new ConfigNetworkHandler(config, network_manager->hub());
 #	endif
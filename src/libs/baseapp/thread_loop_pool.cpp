@@ -0,0 +1,394 @@
+
+/***************************************************************************
+ *  thread_loop_pool.cpp - Work-stealing pool to execute thread loops
+ *
+ *  Created: Fri Oct 16 20:02:36 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <baseapp/thread_loop_pool.h>
+#include <core/exceptions/software.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <core/threading/wait_condition.h>
+#include <utils/time/time.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+class ThreadLoopPool::Worker : public Thread
+{
+public:
+	Worker(ThreadLoopPool *pool, unsigned int index)
+	: Thread("ThreadLoopPoolWorker", Thread::OPMODE_CONTINUOUS), pool_(pool), index_(index)
+	{
+		set_name("ThreadLoopPoolWorker-%u", index);
+	}
+
+	virtual void
+	loop()
+	{
+		Task *task;
+		if (pool_->next_task(index_, task)) {
+			pool_->run_task(task);
+		} else {
+			pool_->wait_for_work();
+		}
+	}
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	ThreadLoopPool *pool_;
+	unsigned int    index_;
+};
+/// @endcond
+
+/** @class ThreadLoopPool <baseapp/thread_loop_pool.h>
+ * Work-stealing pool to execute thread loops.
+ * The pool runs single loop iterations of threads in wait-for-wakeup mode
+ * as tasks on a fixed number of worker threads, instead of waking up the
+ * pthread of each thread. With many short-running threads this saves the
+ * context switches and wakeup latency of one pthread per thread.
+ *
+ * Each worker has its own task queue. Tasks are distributed to the queues
+ * round-robin. A worker takes tasks from the back of its own queue and,
+ * once that is empty, steals tasks from the front of the queues of the
+ * other workers. Hence the load is balanced if the loops of some threads
+ * take considerably longer than others.
+ *
+ * Threads must be added to the pool before they can be executed. At most
+ * one loop iteration of a thread is scheduled or running at any time. If
+ * a thread is executed while its previous iteration is still pending,
+ * another iteration is run right after the current one has finished,
+ * similar to coalesced wakeups of a thread. A completion callback can be
+ * set to be notified when an iteration has finished.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param num_workers number of worker threads, 0 to start one worker per
+ * online CPU core
+ */
+ThreadLoopPool::ThreadLoopPool(unsigned int num_workers)
+{
+	if (num_workers == 0) {
+		long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		num_workers   = (num_cpus > 0) ? num_cpus : 1;
+	}
+
+	next_queue_  = 0;
+	queued_      = 0;
+	outstanding_ = 0;
+	tasks_mutex_ = new Mutex();
+	mutex_       = new Mutex();
+	work_cond_   = new WaitCondition(mutex_);
+	idle_cond_   = new WaitCondition(mutex_);
+
+	for (unsigned int i = 0; i < num_workers; ++i) {
+		WorkQueue *q = new WorkQueue();
+		q->mutex     = new Mutex();
+		queues_.push_back(q);
+	}
+	for (unsigned int i = 0; i < num_workers; ++i) {
+		Worker *w = new Worker(this, i);
+		workers_.push_back(w);
+		w->start();
+	}
+}
+
+/** Destructor.
+ * Waits for all scheduled tasks to finish and stops the workers.
+ */
+ThreadLoopPool::~ThreadLoopPool()
+{
+	wait_idle();
+
+	for (Worker *w : workers_) {
+		w->cancel();
+		w->join();
+		delete w;
+	}
+	for (WorkQueue *q : queues_) {
+		delete q->mutex;
+		delete q;
+	}
+	for (auto &t : tasks_) {
+		delete t.second;
+	}
+
+	delete work_cond_;
+	delete idle_cond_;
+	delete mutex_;
+	delete tasks_mutex_;
+}
+
+/** Add thread.
+ * @param thread thread to add, must be in wait-for-wakeup mode
+ */
+void
+ThreadLoopPool::add(Thread *thread)
+{
+	if (thread->opmode() != Thread::OPMODE_WAITFORWAKEUP) {
+		throw IllegalArgumentException("Thread %s must be in wait-for-wakeup mode for pool execution",
+		                               thread->name());
+	}
+
+	MutexLocker lock(tasks_mutex_);
+	if (tasks_.find(thread) == tasks_.end()) {
+		Task *task     = new Task();
+		task->thread   = thread;
+		task->state    = TASK_IDLE;
+		tasks_[thread] = task;
+	}
+}
+
+/** Remove thread.
+ * If a loop iteration of the thread is scheduled or running, waits until
+ * it has finished. Afterwards the pool does not access the thread anymore.
+ * @param thread thread to remove
+ */
+void
+ThreadLoopPool::remove(Thread *thread)
+{
+	Task *task;
+	tasks_mutex_->lock();
+	std::map<Thread *, Task *>::iterator t = tasks_.find(thread);
+	if (t == tasks_.end()) {
+		tasks_mutex_->unlock();
+		return;
+	}
+	task = t->second;
+	tasks_.erase(t);
+	tasks_mutex_->unlock();
+
+	mutex_->lock();
+	while (task->state != TASK_IDLE) {
+		idle_cond_->wait();
+	}
+	mutex_->unlock();
+
+	delete task;
+}
+
+/** Execute one loop iteration of the given threads.
+ * The iterations are scheduled and the method returns immediately. Threads
+ * which have not been added to the pool are skipped. If the previous
+ * iteration of a thread is still scheduled or running, another iteration
+ * is run once it has finished. Further requests until then are merged.
+ * @param threads threads to execute
+ */
+void
+ThreadLoopPool::execute(const std::list<Thread *> &threads)
+{
+	unsigned int num_scheduled = 0;
+
+	tasks_mutex_->lock();
+	for (Thread *thread : threads) {
+		std::map<Thread *, Task *>::iterator t = tasks_.find(thread);
+		if (t == tasks_.end()) {
+			continue;
+		}
+		TaskState state = TASK_IDLE;
+		if (!t->second->state.compare_exchange_strong(state, TASK_BUSY)) {
+			if (state == TASK_BUSY) {
+				// the worker runs it again after the current iteration
+				t->second->state.compare_exchange_strong(state, TASK_BUSY_RERUN);
+			}
+			continue;
+		}
+
+		outstanding_ += 1;
+		WorkQueue *q = queues_[next_queue_++ % queues_.size()];
+		q->mutex->lock();
+		q->tasks.push_back(t->second);
+		q->mutex->unlock();
+		num_scheduled += 1;
+	}
+	tasks_mutex_->unlock();
+
+	if (num_scheduled > 0) {
+		// increment under the lock so that no worker misses the wakeup, the
+		// counter may become negative for a moment if a worker has already
+		// taken one of the tasks pushed above
+		mutex_->lock();
+		queued_ += num_scheduled;
+		work_cond_->wake_all();
+		mutex_->unlock();
+	}
+}
+
+/** Wait until loop iterations of the given threads have finished.
+ * Returns once no iteration of any of the given threads is scheduled or
+ * running anymore. Threads which have not been added are ignored. The
+ * threads must not be removed while waiting.
+ * @param threads threads to wait for
+ * @param timeout_usec timeout in microseconds, 0 to wait forever
+ * @return true if all iterations have finished, false on timeout
+ */
+bool
+ThreadLoopPool::wait(const std::list<Thread *> &threads, unsigned int timeout_usec)
+{
+	std::list<Task *> tasks;
+	tasks_mutex_->lock();
+	for (Thread *thread : threads) {
+		std::map<Thread *, Task *>::iterator t = tasks_.find(thread);
+		if (t != tasks_.end()) {
+			tasks.push_back(t->second);
+		}
+	}
+	tasks_mutex_->unlock();
+
+	Time deadline;
+	deadline += (long int)timeout_usec;
+
+	MutexLocker lock(mutex_);
+	for (Task *task : tasks) {
+		while (task->state != TASK_IDLE) {
+			if (timeout_usec == 0) {
+				idle_cond_->wait();
+			} else if (!idle_cond_->abstimed_wait(deadline.get_sec(), deadline.get_nsec())) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/** Wait until all scheduled loop iterations have finished. */
+void
+ThreadLoopPool::wait_idle()
+{
+	mutex_->lock();
+	while (outstanding_ > 0) {
+		idle_cond_->wait();
+	}
+	mutex_->unlock();
+}
+
+/** Get number of workers.
+ * @return number of worker threads
+ */
+unsigned int
+ThreadLoopPool::num_workers() const
+{
+	return workers_.size();
+}
+
+/** Set completion callback.
+ * The callback is called by the worker thread after a loop iteration has
+ * finished. It may schedule further iterations with execute(). Set the
+ * callback before executing any thread.
+ * @param callback function called with the thread whose loop has finished
+ */
+void
+ThreadLoopPool::set_completion_callback(std::function<void(Thread *)> callback)
+{
+	completion_callback_ = callback;
+}
+
+/** Get next task for a worker.
+ * Takes a task from the back of the worker's own queue or steals one from
+ * the front of another worker's queue.
+ * @param worker index of the worker asking for a task
+ * @param task upon successful return the task to run
+ * @return true if a task has been found, false if all queues are empty
+ */
+bool
+ThreadLoopPool::next_task(unsigned int worker, Task *&task)
+{
+	if (queued_ <= 0)
+		return false;
+
+	WorkQueue *own = queues_[worker];
+	own->mutex->lock();
+	if (!own->tasks.empty()) {
+		task = own->tasks.back();
+		own->tasks.pop_back();
+		own->mutex->unlock();
+		queued_ -= 1;
+		return true;
+	}
+	own->mutex->unlock();
+
+	for (unsigned int i = 1; i < queues_.size(); ++i) {
+		WorkQueue *victim = queues_[(worker + i) % queues_.size()];
+		victim->mutex->lock();
+		if (!victim->tasks.empty()) {
+			task = victim->tasks.front();
+			victim->tasks.pop_front();
+			victim->mutex->unlock();
+			queued_ -= 1;
+			return true;
+		}
+		victim->mutex->unlock();
+	}
+	return false;
+}
+
+/** Run a task.
+ * @param task task to run
+ */
+void
+ThreadLoopPool::run_task(Task *task)
+{
+	Thread *thread = task->thread;
+	for (;;) {
+		thread->execute_loop();
+		if (completion_callback_) {
+			completion_callback_(thread);
+		}
+
+		TaskState state = TASK_BUSY;
+		if (task->state.compare_exchange_strong(state, TASK_IDLE)) {
+			break;
+		}
+		// another iteration has been requested while running
+		task->state = TASK_BUSY;
+	}
+
+	mutex_->lock();
+	outstanding_ -= 1;
+	idle_cond_->wake_all();
+	mutex_->unlock();
+}
+
+/** Wait until tasks have been queued. */
+void
+ThreadLoopPool::wait_for_work()
+{
+	mutex_->lock();
+	// workers are cancelled while waiting, release the mutex in that case
+	pthread_cleanup_push(cleanup_mutex, mutex_);
+	while (queued_ <= 0) {
+		work_cond_->wait();
+	}
+	pthread_cleanup_pop(1);
+}
+
+} // end namespace fawkes
@@ -0,0 +1,102 @@
+
+/***************************************************************************
+ *  thread_loop_pool.h - Work-stealing pool to execute thread loops
+ *
+ *  Created: Fri Oct 16 20:02:36 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_BASEAPP_THREAD_LOOP_POOL_H_
+#define _LIBS_BASEAPP_THREAD_LOOP_POOL_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace fawkes {
+
+class Thread;
+class Mutex;
+class WaitCondition;
+
+class ThreadLoopPool
+{
+public:
+	ThreadLoopPool(unsigned int num_workers = 0);
+	~ThreadLoopPool();
+
+	void add(Thread *thread);
+	void remove(Thread *thread);
+
+	void execute(const std::list<Thread *> &threads);
+	bool wait(const std::list<Thread *> &threads, unsigned int timeout_usec = 0);
+	void wait_idle();
+
+	unsigned int num_workers() const;
+
+	void set_completion_callback(std::function<void(Thread *)> callback);
+
+private:
+	class Worker;
+
+	/// @cond INTERNALS
+	typedef enum {
+		TASK_IDLE,      /**< not scheduled */
+		TASK_BUSY,      /**< scheduled or running */
+		TASK_BUSY_RERUN /**< running, another iteration has been requested */
+	} TaskState;
+
+	typedef struct
+	{
+		Thread *               thread;
+		std::atomic<TaskState> state;
+	} Task;
+
+	typedef struct
+	{
+		Mutex *            mutex;
+		std::deque<Task *> tasks;
+	} WorkQueue;
+	/// @endcond
+
+	bool next_task(unsigned int worker, Task *&task);
+	void run_task(Task *task);
+	void wait_for_work();
+
+	std::function<void(Thread *)> completion_callback_;
+
+	std::vector<Worker *>    workers_;
+	std::vector<WorkQueue *> queues_;
+	unsigned int             next_queue_;
+
+	Mutex *                    tasks_mutex_;
+	std::map<Thread *, Task *> tasks_;
+
+	Mutex *                   mutex_;
+	WaitCondition *           work_cond_;
+	WaitCondition *           idle_cond_;
+	std::atomic<int>          queued_;
+	std::atomic<unsigned int> outstanding_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -22,6 +22,8 @@
  */
 
 #include <aspect/blocked_timing.h>
+#include <baseapp/dataflow_scheduler.h>
+#include <baseapp/thread_loop_pool.h>
 #include <baseapp/thread_manager.h>
 #include <core/exceptions/software.h>
 #include <core/exceptions/system.h>
@@ -30,6 +32,7 @@
 #include <core/threading/thread_finalizer.h>
 #include <core/threading/thread_initializer.h>
 #include <core/threading/wait_condition.h>
+#include <utils/time/time.h>
 
 namespace fawkes {
 
@@ -41,6 +44,14 @@ namespace fawkes {
  * can be used for "garbage collection" of threads.
  *
  * The thread manager allows easy wakeup of threads of a given wakeup hook.
+ * Threads with BlockedTimingAspect::EXECUTION_MODE_POOL are not started
+ * with a pthread of their own but registered with a ThreadLoopPool, which
+ * is created when the first such thread is added. Their loops are executed
+ * on the pool by run_pooled(), and by wakeup() and wakeup_and_wait() along
+ * with the threads of the hook which have their own pthread.
+ * Threads with BlockedTimingAspect::EXECUTION_MODE_DATAFLOW are executed
+ * on the same pool, scheduled by a DataflowScheduler according to their
+ * declared interface reads and writes. Use wait_pooled() to wait for them.
  *
  * The thread manager needs a thread initializer. Each thread that is added
  * to the thread manager is initialized with this. The runtime type information
@@ -139,6 +150,9 @@ ThreadManager::ThreadManager()
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	pool_                        = NULL;
+	dataflow_                    = NULL;
+	pooled_thread_list_.set_name("ThreadManagerList Pooled");
 }
 
 /** Constructor.
@@ -155,12 +169,26 @@ ThreadManager::ThreadManager(ThreadInitializer *initializer, ThreadFinalizer *fi
 	waitcond_timedthreads_       = new WaitCondition();
 	interrupt_timed_thread_wait_ = false;
 	aspect_collector_            = new ThreadManagerAspectCollector(this);
+	pool_                        = NULL;
+	dataflow_                    = NULL;
+	pooled_thread_list_.set_name("ThreadManagerList Pooled");
 	set_inifin(initializer, finalizer);
 }
 
 /** Destructor. */
 ThreadManager::~ThreadManager()
 {
+	// no loop may be running while threads are stopped, the dataflow
+	// scheduler is deleted before the pool it schedules iterations on
+	if (pool_) {
+		pool_->wait_idle();
+		pool_->set_completion_callback(nullptr);
+	}
+	delete dataflow_;
+	dataflow_ = NULL;
+	delete pool_;
+	pool_ = NULL;
+
 	// stop all threads, we call finalize, and we run through it as long as there are
 	// still running threads, after that, we force the thread's death.
 	for (tit_ = threads_.begin(); tit_ != threads_.end(); ++tit_) {
@@ -174,6 +202,10 @@ ThreadManager::~ThreadManager()
 	} catch (Exception &e) {
 	} // ignore
 	threads_.clear();
+	try {
+		pooled_thread_list_.force_stop(finalizer_);
+	} catch (Exception &e) {
+	} // ignore
 
 	delete waitcond_timedthreads_;
 	delete aspect_collector_;
@@ -211,6 +243,21 @@ ThreadManager::internal_remove_thread(Thread *t)
 			if (threads_[hook].empty())
 				threads_.erase(hook);
 		}
+		pooled_thread_list_.remove_locked(t);
+		if (pooled_threads_.find(hook) != pooled_threads_.end()) {
+			pooled_threads_[hook].remove(t);
+			if (pooled_threads_[hook].empty())
+				pooled_threads_.erase(hook);
+			if (pool_)
+				pool_->remove(t);
+		}
+		if (timed_thread->blockedTimingAspectExecutionMode()
+		    == BlockedTimingAspect::EXECUTION_MODE_DATAFLOW) {
+			if (dataflow_)
+				dataflow_->remove(t);
+			if (pool_)
+				pool_->remove(t);
+		}
 	} else {
 		untimed_threads_.remove_locked(t);
 	}
@@ -228,13 +275,27 @@ ThreadManager::internal_add_thread(Thread *t)
 {
 	BlockedTimingAspect *timed_thread;
 	if ((timed_thread = dynamic_cast<BlockedTimingAspect *>(t)) != NULL) {
-		BlockedTimingAspect::WakeupHook hook = timed_thread->blockedTimingAspectHook();
-
-		if (threads_.find(hook) == threads_.end()) {
-			threads_[hook].set_name("ThreadManagerList Hook %i", hook);
-			threads_[hook].set_maintain_barrier(true);
+		BlockedTimingAspect::WakeupHook    hook = timed_thread->blockedTimingAspectHook();
+		BlockedTimingAspect::ExecutionMode mode = timed_thread->blockedTimingAspectExecutionMode();
+
+		if (mode == BlockedTimingAspect::EXECUTION_MODE_THREAD) {
+			if (threads_.find(hook) == threads_.end()) {
+				threads_[hook].set_name("ThreadManagerList Hook %i", hook);
+				threads_[hook].set_maintain_barrier(true);
+			}
+			threads_[hook].push_back_locked(t);
+		} else {
+			// pooled threads have no pthread to wake up, hence they are
+			// kept out of the per-hook lists and their wakeup barriers
+			create_pool();
+			pool_->add(t);
+			pooled_thread_list_.push_back_locked(t);
+			if (mode == BlockedTimingAspect::EXECUTION_MODE_POOL) {
+				pooled_threads_[hook].push_back(t);
+			} else {
+				dataflow_->add(t);
+			}
 		}
-		threads_[hook].push_back_locked(t);
 
 		waitcond_timedthreads_->wake_all();
 	} else {
@@ -242,6 +303,18 @@ ThreadManager::internal_add_thread(Thread *t)
 	}
 }
 
+/** Create thread loop pool and dataflow scheduler if not done already. */
+void
+ThreadManager::create_pool()
+{
+	if (!pool_) {
+		pool_     = new ThreadLoopPool();
+		dataflow_ = new DataflowScheduler(pool_);
+		pool_->set_completion_callback(
+		  [this](Thread *thread) { dataflow_->loop_finished(thread); });
+	}
+}
+
 /** Add threads.
  * Add the given threads to the thread manager. The threads are initialised
  * as appropriate and started. See the class documentation for supported
@@ -542,15 +615,37 @@ ThreadManager::wakeup_and_wait(BlockedTimingAspect::WakeupHook hook, unsigned in
 {
 	MutexLocker lock(threads_.mutex());
 
-	unsigned int timeout_sec = 0;
-	if (timeout_usec >= 1000000) {
-		timeout_sec = timeout_usec / 1000000;
-		timeout_usec -= timeout_sec * 1000000;
+	Time deadline;
+	deadline += (long int)timeout_usec;
+
+	// pooled threads run concurrently to the threads with their own pthread
+	run_pooled_unlocked(hook);
+
+	unsigned int timeout_sec  = 0;
+	unsigned int timeout_rest = timeout_usec;
+	if (timeout_rest >= 1000000) {
+		timeout_sec = timeout_rest / 1000000;
+		timeout_rest -= timeout_sec * 1000000;
 	}
 
 	// Note that the following lines might throw an exception, we just pass it on
 	if (threads_.find(hook) != threads_.end()) {
-		threads_[hook].wakeup_and_wait(timeout_sec, timeout_usec * 1000);
+		threads_[hook].wakeup_and_wait(timeout_sec, timeout_rest * 1000);
+	}
+
+	// wait for the pooled threads for the remainder of the same timeout
+	unsigned int remaining_usec = 0;
+	if (timeout_usec > 0) {
+		Time now;
+		long int rem   = (deadline - now).in_usec();
+		remaining_usec = (rem > 0) ? rem : 1;
+	}
+	std::map<BlockedTimingAspect::WakeupHook, std::list<Thread *>>::iterator p =
+	  pooled_threads_.find(hook);
+	if (((p != pooled_threads_.end()) && !pool_->wait(p->second, remaining_usec))
+	    || (dataflow_ && !dataflow_->wait_hook(hook, remaining_usec))) {
+		throw TimeoutException("Pooled threads of hook %s did not finish in time",
+		                       BlockedTimingAspect::blocked_timing_hook_to_string(hook));
 	}
 }
 
@@ -559,6 +654,9 @@ ThreadManager::wakeup(BlockedTimingAspect::WakeupHook hook, Barrier *barrier)
 {
 	MutexLocker lock(threads_.mutex());
 
+	// pooled threads do not wait for the barrier
+	run_pooled_unlocked(hook);
+
 	if (threads_.find(hook) != threads_.end()) {
 		if (barrier) {
 			threads_[hook].wakeup(barrier);
@@ -571,6 +669,39 @@ ThreadManager::wakeup(BlockedTimingAspect::WakeupHook hook, Barrier *barrier)
 	}
 }
 
+void
+ThreadManager::run_pooled(BlockedTimingAspect::WakeupHook hook)
+{
+	MutexLocker lock(threads_.mutex());
+	run_pooled_unlocked(hook);
+}
+
+/** Run pooled threads of hook without locking.
+ * The thread list mutex must be held.
+ * @param hook hook whose pooled threads to run
+ */
+void
+ThreadManager::run_pooled_unlocked(BlockedTimingAspect::WakeupHook hook)
+{
+	std::map<BlockedTimingAspect::WakeupHook, std::list<Thread *>>::iterator p =
+	  pooled_threads_.find(hook);
+	if (p != pooled_threads_.end()) {
+		pool_->execute(p->second);
+	}
+	if (dataflow_) {
+		dataflow_->run_hook(hook);
+	}
+}
+
+void
+ThreadManager::wait_pooled(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec)
+{
+	if (dataflow_ && !dataflow_->wait_hook(hook, timeout_usec)) {
+		throw TimeoutException("Dataflow threads of hook %s did not finish in time",
+		                       BlockedTimingAspect::blocked_timing_hook_to_string(hook));
+	}
+}
+
 void
 ThreadManager::try_recover(std::list<std::string> &recovered_threads)
 {
@@ -584,7 +715,7 @@ ThreadManager::try_recover(std::list<std::string> &recovered_threads)
 bool
 ThreadManager::timed_threads_exist()
 {
-	return (threads_.size() > 0);
+	return (threads_.size() > 0) || !pooled_thread_list_.empty();
 }
 
 void
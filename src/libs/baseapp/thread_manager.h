@@ -32,12 +32,15 @@
 #include <core/utils/lock_map.h>
 
 #include <list>
+#include <map>
 
 namespace fawkes {
 class Mutex;
 class WaitCondition;
 class ThreadInitializer;
 class ThreadFinalizer;
+class ThreadLoopPool;
+class DataflowScheduler;
 
 class ThreadManager : public ThreadCollector, public BlockedTimingExecutor
 {
@@ -77,6 +80,8 @@ public:
 
 	virtual void wakeup_and_wait(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec = 0);
 	virtual void wakeup(BlockedTimingAspect::WakeupHook hook, Barrier *barrier = 0);
+	virtual void run_pooled(BlockedTimingAspect::WakeupHook hook);
+	virtual void wait_pooled(BlockedTimingAspect::WakeupHook hook, unsigned int timeout_usec = 0);
 	virtual void try_recover(std::list<std::string> &recovered_threads);
 
 	virtual bool timed_threads_exist();
@@ -88,6 +93,8 @@ public:
 private:
 	void internal_add_thread(Thread *t);
 	void internal_remove_thread(Thread *t);
+	void create_pool();
+	void run_pooled_unlocked(BlockedTimingAspect::WakeupHook hook);
 	void add_maybelocked(ThreadList &tl, bool lock);
 	void add_maybelocked(Thread *t, bool lock);
 	void remove_maybelocked(ThreadList &tl, bool lock);
@@ -118,6 +125,11 @@ private:
 	LockMap<BlockedTimingAspect::WakeupHook, ThreadList>           threads_;
 	LockMap<BlockedTimingAspect::WakeupHook, ThreadList>::iterator tit_;
 
+	std::map<BlockedTimingAspect::WakeupHook, std::list<Thread *>> pooled_threads_;
+	ThreadList                                                     pooled_thread_list_;
+	ThreadLoopPool *                                               pool_;
+	DataflowScheduler *                                            dataflow_;
+
 	ThreadList     untimed_threads_;
 	WaitCondition *waitcond_timedthreads_;
 
@@ -22,6 +22,7 @@
  */
 
 #include <blackboard/interface_listener.h>
+#include <blackboard/internal/event_dispatcher.h>
 #include <core/exceptions/system.h>
 #include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
@@ -74,6 +75,20 @@ namespace fawkes {
  * the instance is deleted and afterwards an event for that very interface
  * happens. A warning is reported via the LibLogger whenever you forget this.
  *
+ * By default data changed and message received events are delivered
+ * synchronously in the thread that caused the event, i.e. a slow listener
+ * stalls the writer of an interface. Listeners that need more time, like
+ * loggers or network bridges, can call bbil_set_dispatch_mode() before
+ * registering to have these events queued and delivered from a dispatcher
+ * thread instead. The writer then never waits for the listener. If the
+ * queue is full, events are dropped and counted, see bbil_dropped_events().
+ * With DISPATCH_ASYNC_LATEST only one data changed event per interface is
+ * pending at any time, intermediate writes are coalesced. Note that in
+ * asynchronous mode the listener must protect the interfaces it reads
+ * against concurrent access from its own thread, and that the return
+ * value of bb_interface_message_received() is ignored, i.e. asynchronous
+ * listeners cannot prevent enqueuing of messages.
+ *
  * @author Tim Niemueller
  * @see BlackBoardInterfaceManager::register_listener()
  * @see BlackBoardInterfaceManager::unregister_listener()
@@ -94,6 +109,11 @@ BlackBoardInterfaceListener::BlackBoardInterfaceListener(const char *name_format
 
 	bbil_queue_mutex_ = new Mutex();
 	bbil_maps_mutex_  = new Mutex();
+
+	bbil_dispatch_mode_         = DISPATCH_SYNC;
+	bbil_dispatch_queue_length_ = 64;
+	bbil_dropped_events_        = 0;
+	bbil_event_queue_           = NULL;
 }
 
 /** Destructor. */
@@ -101,6 +121,9 @@ BlackBoardInterfaceListener::~BlackBoardInterfaceListener()
 {
 	free(name_);
 
+	if (bbil_event_queue_)
+		bbil_event_queue_->unref();
+
 	delete bbil_queue_mutex_;
 	delete bbil_maps_mutex_;
 }
@@ -114,6 +137,40 @@ BlackBoardInterfaceListener::bbil_name() const
 	return name_;
 }
 
+/** Set event dispatch mode.
+ * This determines how data changed and message received events are delivered.
+ * It must be called before the listener is registered with the BlackBoard,
+ * changes are only considered on the next registration.
+ * @param mode dispatch mode
+ * @param queue_length maximum number of pending events for asynchronous
+ * dispatch modes, events exceeding this limit are dropped
+ */
+void
+BlackBoardInterfaceListener::bbil_set_dispatch_mode(DispatchMode mode, unsigned int queue_length)
+{
+	bbil_dispatch_mode_         = mode;
+	bbil_dispatch_queue_length_ = queue_length;
+}
+
+/** Get event dispatch mode.
+ * @return event dispatch mode
+ */
+BlackBoardInterfaceListener::DispatchMode
+BlackBoardInterfaceListener::bbil_dispatch_mode() const
+{
+	return bbil_dispatch_mode_;
+}
+
+/** Get number of dropped events.
+ * @return number of events that have been dropped because the
+ * asynchronous event queue of this listener was full
+ */
+unsigned int
+BlackBoardInterfaceListener::bbil_dropped_events() const
+{
+	return bbil_dropped_events_;
+}
+
 /** BlackBoard data changed notification.
  * This is called whenever the data in an interface that you registered for is
  * modified. This happens if a writer calls the Interface::write() method.
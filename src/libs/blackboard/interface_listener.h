@@ -28,6 +28,7 @@
 #include <core/utils/lock_queue.h>
 #include <utils/misc/string_compare.h>
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <string>
@@ -37,10 +38,12 @@ namespace fawkes {
 class Interface;
 class Message;
 class BlackBoardNotifier;
+class BlackBoardListenerEventQueue;
 
 class BlackBoardInterfaceListener
 {
 	friend BlackBoardNotifier;
+	friend BlackBoardListenerEventQueue;
 
 public:
 	/** Queue entry type. */
@@ -74,11 +77,21 @@ public:
 		InterfaceMap writer;   ///< Writer event subscriptions
 	} InterfaceMaps;
 
+	/** Event dispatch mode. */
+	typedef enum {
+		DISPATCH_SYNC,        ///< call listener in the thread causing the event
+		DISPATCH_ASYNC,       ///< queue events and call listener from a dispatcher thread
+		DISPATCH_ASYNC_LATEST ///< like DISPATCH_ASYNC, but only keep the latest data event
+	} DispatchMode;
+
 	BlackBoardInterfaceListener(const char *name_format, ...);
 	virtual ~BlackBoardInterfaceListener();
 
 	const char *bbil_name() const;
 
+	DispatchMode bbil_dispatch_mode() const;
+	unsigned int bbil_dropped_events() const;
+
 	virtual void bb_interface_data_changed(Interface *interface) throw();
 	virtual bool bb_interface_message_received(Interface *interface, Message *message) throw();
 	virtual void bb_interface_writer_added(Interface *  interface,
@@ -101,6 +114,8 @@ protected:
 	void bbil_remove_reader_interface(Interface *interface);
 	void bbil_remove_writer_interface(Interface *interface);
 
+	void bbil_set_dispatch_mode(DispatchMode mode, unsigned int queue_length = 64);
+
 	Interface *bbil_data_interface(const char *iuid) throw();
 	Interface *bbil_message_interface(const char *iuid) throw();
 	Interface *bbil_reader_interface(const char *iuid) throw();
@@ -127,6 +142,11 @@ private:
 	InterfaceMaps  bbil_maps_;
 	InterfaceQueue bbil_queue_;
 
+	DispatchMode                  bbil_dispatch_mode_;
+	unsigned int                  bbil_dispatch_queue_length_;
+	std::atomic<unsigned int>     bbil_dropped_events_;
+	BlackBoardListenerEventQueue *bbil_event_queue_;
+
 	char *name_;
 };
 
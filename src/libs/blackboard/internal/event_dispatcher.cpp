@@ -0,0 +1,337 @@
+/***************************************************************************
+ *  event_dispatcher.cpp - BlackBoard asynchronous event dispatching
+ *
+ *  Created: Fri Oct 16 19:10:47 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <blackboard/internal/event_dispatcher.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/thread.h>
+#include <interface/interface.h>
+#include <interface/message.h>
+
+namespace fawkes {
+
+// queue whose events are being delivered by the calling dispatcher thread
+static thread_local BlackBoardListenerEventQueue *processing_queue = NULL;
+
+/** @class BlackBoardListenerEventQueue <blackboard/internal/event_dispatcher.h>
+ * Event queue of an asynchronous BlackBoard interface listener.
+ * The notifier pushes data changed and message received events for a
+ * listener which has requested asynchronous dispatching to this queue
+ * instead of calling the listener directly. The queue is lock-free, hence
+ * the thread causing the event never waits for the listener. The events
+ * are then delivered by a BlackBoardEventDispatcher thread.
+ *
+ * In coalescing mode only one data changed event per interface is pending
+ * at any time. Further data changes before that event has been delivered
+ * are merged into it, the listener will read the latest data anyway.
+ *
+ * The queue is reference counted, the listener holds one reference for
+ * its lifetime and the dispatcher holds one while the queue is scheduled
+ * for processing.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param listener listener to deliver events to
+ * @param coalesce true to coalesce data changed events per interface
+ * @param length maximum number of pending events
+ */
+BlackBoardListenerEventQueue::BlackBoardListenerEventQueue(BlackBoardInterfaceListener *listener,
+                                                           bool                         coalesce,
+                                                           unsigned int                 length)
+: listener_(listener), coalesce_(coalesce), queue_(length)
+{
+	scheduled_      = false;
+	dead_           = false;
+	dispatch_mutex_ = new Mutex();
+}
+
+/** Destructor. */
+BlackBoardListenerEventQueue::~BlackBoardListenerEventQueue()
+{
+	Event e;
+	while (queue_.try_pop(e)) {
+		discard(e);
+	}
+	for (auto &p : pending_) {
+		delete p.second;
+	}
+	delete dispatch_mutex_;
+}
+
+/** Add interface to receive data events for.
+ * In coalescing mode this creates the pending flag for the interface.
+ * The flag is keyed by the listener's interface instance, which is also
+ * passed to push_data(), so that pushing does not need to compare strings.
+ * This must only be called while no events are pushed concurrently,
+ * i.e. while the notifier adds the listener to its data listener map.
+ * @param interface listener's instance of the interface
+ */
+void
+BlackBoardListenerEventQueue::add_data_interface(Interface *interface)
+{
+	if (coalesce_ && (pending_.find(interface) == pending_.end())) {
+		pending_[interface] = new std::atomic<bool>(false);
+	}
+}
+
+/** Push data changed event.
+ * @param interface listener's instance of the interface whose data has changed
+ * @return true if the event has been queued, false if it has been merged
+ * with a pending event or dropped
+ */
+bool
+BlackBoardListenerEventQueue::push_data(Interface *interface)
+{
+	Event e = {BlackBoardInterfaceListener::DATA, interface, NULL, NULL};
+	if (coalesce_) {
+		auto p = pending_.find(interface);
+		if (p != pending_.end()) {
+			if (p->second->exchange(true)) {
+				// an event for this interface is pending already
+				return false;
+			}
+			e.pending = p->second;
+		}
+	}
+	return push(e);
+}
+
+/** Push message received event.
+ * The message is referenced until the event has been delivered.
+ * @param interface listener's instance of the interface
+ * @param message received message
+ * @return true if the event has been queued, false if it has been dropped
+ */
+bool
+BlackBoardListenerEventQueue::push_message(Interface *interface, Message *message)
+{
+	Event e = {BlackBoardInterfaceListener::MESSAGES, interface, message, NULL};
+	message->ref();
+	return push(e);
+}
+
+bool
+BlackBoardListenerEventQueue::push(Event &e)
+{
+	if (dead_ || !queue_.try_push(e)) {
+		if (!dead_)
+			listener_->bbil_dropped_events_ += 1;
+		discard(e);
+		return false;
+	}
+	return true;
+}
+
+void
+BlackBoardListenerEventQueue::discard(Event &e)
+{
+	if (e.pending)
+		e.pending->store(false);
+	if (e.message)
+		e.message->unref();
+}
+
+/** Mark queue as scheduled.
+ * @return true if the queue has not been scheduled for processing before
+ * and must now be passed to the dispatcher, false if it is scheduled already
+ */
+bool
+BlackBoardListenerEventQueue::try_schedule()
+{
+	return !scheduled_.exchange(true);
+}
+
+/** Deliver all pending events.
+ * Called by the dispatcher. Events are delivered in the order in which
+ * they have been pushed.
+ */
+void
+BlackBoardListenerEventQueue::process()
+{
+	MutexLocker lock(dispatch_mutex_);
+	// events pushed from now on reschedule this queue
+	scheduled_       = false;
+	processing_queue = this;
+
+	Event e;
+	while (queue_.try_pop(e)) {
+		if (e.pending)
+			e.pending->store(false);
+		if (!dead_) {
+			if (e.type == BlackBoardInterfaceListener::DATA) {
+				listener_->bb_interface_data_changed(e.interface);
+			} else {
+				listener_->bb_interface_message_received(e.interface, e.message);
+			}
+		}
+		if (e.message)
+			e.message->unref();
+	}
+	processing_queue = NULL;
+}
+
+/** Shutdown queue.
+ * Waits for an event delivery in progress and then discards all pending
+ * events. Afterwards the listener is never called again from this queue.
+ * Called when the listener is unregistered. If the listener unregisters
+ * from within one of its callbacks, the dispatcher thread already holds
+ * the dispatch lock. Then the queue is only marked as dead and process()
+ * discards the remaining events once the callback has returned.
+ */
+void
+BlackBoardListenerEventQueue::shutdown()
+{
+	if (processing_queue == this) {
+		dead_ = true;
+		return;
+	}
+
+	MutexLocker lock(dispatch_mutex_);
+	dead_ = true;
+	Event e;
+	while (queue_.try_pop(e)) {
+		discard(e);
+	}
+}
+
+/** Check if queue has been shut down.
+ * @return true if shutdown() has been called, false otherwise
+ */
+bool
+BlackBoardListenerEventQueue::is_shutdown() const
+{
+	return dead_;
+}
+
+/// @cond INTERNALS
+class BlackBoardEventDispatcher::DispatchThread : public Thread
+{
+public:
+	DispatchThread(BlackBoardEventDispatcher *dispatcher, unsigned int i)
+	: Thread("BlackBoardEventDispatcher", Thread::OPMODE_WAITFORWAKEUP), dispatcher_(dispatcher)
+	{
+		set_name("BlackBoardEventDispatcher-%u", i);
+		set_coalesce_wakeups(true);
+	}
+
+	virtual void
+	loop()
+	{
+		dispatcher_->process_ready();
+	}
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	BlackBoardEventDispatcher *dispatcher_;
+};
+/// @endcond
+
+/** @class BlackBoardEventDispatcher <blackboard/internal/event_dispatcher.h>
+ * BlackBoard event dispatcher.
+ * A small pool of threads which delivers the events queued for asynchronous
+ * interface listeners. Listener event queues with pending events are
+ * scheduled once and then processed by the next available thread. Each
+ * queue is processed by at most one thread at a time, hence events are
+ * delivered to a listener in order.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param num_threads number of dispatcher threads to start
+ */
+BlackBoardEventDispatcher::BlackBoardEventDispatcher(unsigned int num_threads)
+{
+	next_thread_ = 0;
+	for (unsigned int i = 0; i < num_threads; ++i) {
+		DispatchThread *t = new DispatchThread(this, i);
+		threads_.push_back(t);
+		t->start();
+	}
+}
+
+/** Destructor. */
+BlackBoardEventDispatcher::~BlackBoardEventDispatcher()
+{
+	for (DispatchThread *t : threads_) {
+		t->cancel();
+		t->join();
+		delete t;
+	}
+
+	ready_.lock();
+	while (!ready_.empty()) {
+		ready_.front()->unref();
+		ready_.pop();
+	}
+	ready_.unlock();
+}
+
+/** Schedule queue for processing.
+ * Must be called after BlackBoardListenerEventQueue::try_schedule() returned
+ * true. The dispatcher references the queue until it has been processed.
+ * The dispatcher thread is only woken up after the ready queue has been
+ * unlocked, hence the writer never waits for a dispatcher thread.
+ * @param queue listener event queue with pending events
+ */
+void
+BlackBoardEventDispatcher::schedule(BlackBoardListenerEventQueue *queue)
+{
+	queue->ref();
+	ready_.lock();
+	ready_.push(queue);
+	ready_.unlock();
+
+	threads_[next_thread_++ % threads_.size()]->wakeup();
+}
+
+/** Process all scheduled queues.
+ * Called by the dispatcher threads.
+ */
+void
+BlackBoardEventDispatcher::process_ready()
+{
+	for (;;) {
+		ready_.lock();
+		if (ready_.empty()) {
+			ready_.unlock();
+			return;
+		}
+		BlackBoardListenerEventQueue *queue = ready_.front();
+		ready_.pop();
+		ready_.unlock();
+
+		// the reference taken in schedule() is held until all events have
+		// been delivered, even if the listener releases its own meanwhile
+		queue->process();
+		queue->unref();
+	}
+}
+
+} // end namespace fawkes
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *  event_dispatcher.h - BlackBoard asynchronous event dispatching
+ *
+ *  Created: Fri Oct 16 19:10:47 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_INTERNAL_EVENT_DISPATCHER_H_
+#define _BLACKBOARD_INTERNAL_EVENT_DISPATCHER_H_
+
+#include <blackboard/interface_listener.h>
+#include <core/utils/lock_queue.h>
+#include <core/utils/lockfree_queue.h>
+#include <core/utils/refcount.h>
+
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace fawkes {
+
+class Interface;
+class Message;
+class Mutex;
+class Thread;
+
+class BlackBoardListenerEventQueue : public RefCount
+{
+public:
+	BlackBoardListenerEventQueue(BlackBoardInterfaceListener *listener,
+	                             bool                         coalesce,
+	                             unsigned int                 length);
+	virtual ~BlackBoardListenerEventQueue();
+
+	void add_data_interface(Interface *interface);
+
+	bool push_data(Interface *interface);
+	bool push_message(Interface *interface, Message *message);
+
+	bool try_schedule();
+	void process();
+	void shutdown();
+	bool is_shutdown() const;
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		BlackBoardInterfaceListener::QueueEntryType type;
+		Interface *                                 interface;
+		Message *                                   message;
+		std::atomic<bool> *                         pending;
+	} Event;
+	/// @endcond
+
+	bool push(Event &e);
+	void discard(Event &e);
+
+	BlackBoardInterfaceListener *listener_;
+	bool                         coalesce_;
+
+	LockFreeQueue<Event>                                       queue_;
+	std::unordered_map<const Interface *, std::atomic<bool> *> pending_;
+
+	std::atomic<bool> scheduled_;
+	std::atomic<bool> dead_;
+	Mutex *           dispatch_mutex_;
+};
+
+class BlackBoardEventDispatcher
+{
+public:
+	BlackBoardEventDispatcher(unsigned int num_threads);
+	~BlackBoardEventDispatcher();
+
+	void schedule(BlackBoardListenerEventQueue *queue);
+
+private:
+	void process_ready();
+
+	class DispatchThread;
+
+	LockQueue<BlackBoardListenerEventQueue *> ready_;
+	std::vector<DispatchThread *>             threads_;
+	std::atomic<unsigned int>                 next_thread_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -229,7 +229,10 @@ BlackBoardInterfaceManager::create_interface(const char *type,
 	ih->num_readers        = 0;
 	rwlocks[ih->serial]    = new RefCountRWLock();
 
-	interface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+	interface->set_memory(ih->serial,
+	                      ptr,
+	                      (char *)ptr + sizeof(interface_header_t),
+	                      &ih->data_seq);
 }
 
 /** Open interface for reading.
@@ -276,7 +279,7 @@ BlackBoardInterfaceManager::open_for_reading(const char *type,
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
 				throw BlackBoardInterfaceVersionMismatchException();
 			}
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t), &ih->data_seq);
 			rwlocks[ih->serial]->ref();
 		} else {
 			created = true;
@@ -356,7 +359,7 @@ BlackBoardInterfaceManager::open_multiple_for_reading(const char *type_pattern,
 
 			void *ptr = *cit;
 			iface     = new_interface_instance(ih->type, ih->id, owner);
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t), &ih->data_seq);
 
 			if ((iface->hash_size() != INTERFACE_HASH_SIZE_)
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
@@ -445,7 +448,7 @@ BlackBoardInterfaceManager::open_for_writing(const char *type,
 			    || (memcmp(iface->hash(), ih->hash, INTERFACE_HASH_SIZE_) != 0)) {
 				throw BlackBoardInterfaceVersionMismatchException();
 			}
-			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t));
+			iface->set_memory(ih->serial, ptr, (char *)ptr + sizeof(interface_header_t), &ih->data_seq);
 			rwlocks[ih->serial]->ref();
 		} else {
 			created = true;
@@ -32,6 +32,10 @@ namespace fawkes {
 
 /** This struct is used as header for interfaces in memory chunks.
  * This header is stored at the beginning of each allocated memory chunk.
+ * The data sequence counter implements a sequence lock for the data
+ * following the header. It is odd while the writer copies data to the
+ * chunk and even otherwise. Readers copy the data optimistically and retry
+ * if the counter was odd or has changed during the copy.
  */
 typedef struct
 {
@@ -43,6 +47,7 @@ typedef struct
 	uint16_t      num_readers;                /**< number of active readers */
 	uint32_t      refcount;                   /**< reference count */
 	uint32_t      serial;                     /**< memory serial */
+	uint32_t      data_seq;                   /**< data sequence lock counter */
 } interface_header_t;
 
 } // end namespace fawkes
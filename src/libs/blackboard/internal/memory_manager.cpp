@@ -32,6 +32,7 @@
 #include <utils/ipc/shm.h>
 #include <utils/ipc/shm_exceptions.h>
 
+#include <cstddef>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -44,12 +45,27 @@
  */
 #define BBMM_MIN_FREE_CHUNK_SIZE sizeof(chunk_list_t)
 
+/** Marker of a chunk in a free list. */
+#define BBMM_CHUNK_FREE 0x46524545
+/** Marker of a chunk in the allocated chunks list. */
+#define BBMM_CHUNK_ALLOCATED 0x414c4c43
+
 // shortcuts
 #define chunk_ptr(a) (shmem_ ? (chunk_list_t *)shmem_->ptr(a) : a)
 #define chunk_addr(a) (shmem_ ? (chunk_list_t *)shmem_->addr(a) : a)
 
 namespace fawkes {
 
+/** Get size class of a free chunk.
+ * @param size chunk size
+ * @return index of the most significant bit set in size
+ */
+static inline unsigned int
+size_class(unsigned int size)
+{
+	return (size == 0) ? 0 : (sizeof(unsigned int) * 8 - 1 - __builtin_clz(size));
+}
+
 /** @class BlackBoardMemoryManager <blackboard/internal/memory_manager.h>
  * BlackBoard memory manager.
  * This class is used by the BlackBoard to manage the memory in the shared memory
@@ -61,24 +77,32 @@ namespace fawkes {
  * region. The chunk is allocated as shared memory segment to allow for multi-process
  * usage of the memory.
  *
- * The memory is organized in two separate lists. The one is the free chunks list
- * and the other one the allocated chunks list. After startup the allocated
- * chunks list is empty while the free chunks list contains one and only one
- * big chunk of free memory that contains the whole data segment.
+ * The memory is organized in segregated free lists and an allocated chunks list.
+ * Every chunk carries a small header directly in front of its data segment.
+ * Free chunks are binned by size class, class i contains the chunks whose size
+ * is in the range [2^i, 2^(i+1)). A bitmap records which classes are non-empty.
+ * After startup the allocated chunks list is empty while the free lists contain
+ * one and only one big chunk of free memory that contains the whole data segment.
  *
- * When memory is allocated the smallest chunk that is big enough for the requested
- * chunk is used. It is then removed from the free list. If the chunk is big enough
- * to hold another chunk of memory (the remaining size can accomodate the header
- * and at least as many bytes as the header is in size) the chunk is split into an
- * exactly fitting allocated chunk and a remaining free chunk. The chunks are then
- * added to the appropriate lists. If there is more memory then requested but
- * not enough memory to make it a new free chunk the allocated chunk is enlarged
- * to fill the whole chunk. The additional bytes are recorded as overhanging bytes.
+ * When memory is allocated the bitmap is used to find the smallest non-empty size
+ * class of which every chunk is big enough for the requested chunk. The first
+ * chunk of that class is used and removed from its free list. Only if there is
+ * no such class the class that may partially satisfy the request is searched. If
+ * the chunk is big enough to hold another chunk of memory (the remaining size can
+ * accomodate the header and at least as many bytes as the header is in size) the
+ * chunk is split into an exactly fitting allocated chunk and a remaining free
+ * chunk. The chunks are then added to the appropriate lists. If there is more
+ * memory then requested but not enough memory to make it a new free chunk the
+ * allocated chunk is enlarged to fill the whole chunk. The additional bytes are
+ * recorded as overhanging bytes.
  *
- * When memory is freed the chunk is removed from the allocated chunks list and
- * added to the free chunks list. Then the list is cleaned up and adjacent regions
- * of free memory are merged to one. Afterwards the free chunks list will contain
- * non-ajdacent free memory regions of maximum size between allocated chunks.
+ * When memory is freed the chunk header is determined directly from the given
+ * pointer and the chunk is removed from the allocated chunks list. Then it is
+ * merged with its physically adjacent chunks if these are free and the result
+ * is added to the free list of its size class. Thus no two adjacent chunks are
+ * ever free and the free lists contain non-adjacent free memory regions of
+ * maximum size between allocated chunks. Both, allocation and release of
+ * memory, take constant time independent of the number of chunks.
  *
  * The memory manager is thread-safe as all appropriate operations are protected
  * by a mutex.
@@ -110,14 +134,18 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t memsize)
 	// Lock memory to RAM to avoid swapping
 	mlock(memory_, memsize_);
 
+	heap_free_bins_.map = 0;
+	for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+		heap_free_bins_.heads[i] = NULL;
+	}
+	alloc_list_head_ = NULL;
+
 	chunk_list_t *f = (chunk_list_t *)memory_;
 	f->ptr          = (char *)f + sizeof(chunk_list_t);
 	f->size         = memsize_ - sizeof(chunk_list_t);
 	f->overhang     = 0;
-	f->next         = NULL;
-
-	free_list_head_  = f;
-	alloc_list_head_ = NULL;
+	f->prev_phys    = NULL;
+	free_list_add(f);
 }
 
 /** Shared Memory Constructor
@@ -135,9 +163,10 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t       memsize,
                                                  bool         master,
                                                  const char * shmem_token)
 {
-	memory_  = NULL;
-	memsize_ = memsize;
-	master_  = master;
+	memory_          = NULL;
+	memsize_         = memsize;
+	master_          = master;
+	alloc_list_head_ = NULL;
 
 	// open shared memory segment, if it exists try to aquire exclusive
 	// semaphore, if that fails, throw an exception
@@ -186,10 +215,10 @@ BlackBoardMemoryManager::BlackBoardMemoryManager(size_t       memsize,
 		f->ptr          = shmem_->addr((char *)f + sizeof(chunk_list_t));
 		f->size         = memsize_ - sizeof(chunk_list_t);
 		f->overhang     = 0;
-		f->next         = NULL;
+		f->prev_phys    = NULL;
 
-		shmem_header_->set_free_list_head(f);
 		shmem_header_->set_alloc_list_head(NULL);
+		free_list_add(f);
 	}
 
 	mutex_ = new Mutex();
@@ -219,40 +248,16 @@ BlackBoardMemoryManager::~BlackBoardMemoryManager()
 void *
 BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 {
-	// search for smallest chunk just big enough for desired size
-	chunk_list_t *l = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
-
-	// Note: free chunks list sorted ascending by ptr
-	chunk_list_t *f = NULL;
-	while (l) {
-		if ((l->size >= num_bytes) &&               // chunk is big enough
-		    ((f == NULL) || (l->size < f->size))) { // no chunk found or current chunk smaller
-			f = l;
-		}
-		l = chunk_ptr(l->next);
-	}
+	// search for a chunk just big enough for desired size
+	chunk_list_t *f = free_list_find(num_bytes);
 
 	if (f == NULL) {
 		// Doh, did not find chunk
 		throw OutOfMemoryException("BlackBoard ran out of memory");
 	}
 
-	// remove chunk from free_list
-	if (shmem_) {
-		shmem_header_->set_free_list_head(list_remove(shmem_header_->free_list_head(), f));
-	} else {
-		free_list_head_ = list_remove(free_list_head_, f);
-	}
-
-	/*
-  // only chunk's semaphore
-  if ( ptr_sems.find( f->ptr ) != ptr_sems.end() ) {
-    SemaphoreSet *s = ptr_sems[f->ptr];
-    delete s;
-    ptr_sems.erase( f->ptr );
-    f->semset_key = 0;
-  }
-  */
+	// remove chunk from free list
+	free_list_remove(f);
 
 	// our old free list chunk is now our new alloc list chunk
 	// check if there is free space beyond the requested size that makes it worth
@@ -262,14 +267,16 @@ BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 		chunk_list_t *nfc = (chunk_list_t *)((char *)f + sizeof(chunk_list_t) + num_bytes);
 		nfc->ptr          = shmem_ ? shmem_->addr((char *)nfc + sizeof(chunk_list_t))
 		                  : (char *)nfc + sizeof(chunk_list_t);
-		nfc->size     = f->size - num_bytes - sizeof(chunk_list_t);
-		nfc->overhang = 0;
+		nfc->size      = f->size - num_bytes - sizeof(chunk_list_t);
+		nfc->overhang  = 0;
+		nfc->prev_phys = chunk_addr(f);
 
-		if (shmem_) {
-			shmem_header_->set_free_list_head(list_add(shmem_header_->free_list_head(), nfc));
-		} else {
-			free_list_head_ = list_add(free_list_head_, nfc);
-		}
+		// the successor of f cannot be free, otherwise it would have been merged
+		chunk_list_t *n = chunk_phys_next(nfc);
+		if (n)
+			n->prev_phys = chunk_addr(nfc);
+
+		free_list_add(nfc);
 
 		f->size = num_bytes;
 	} else {
@@ -280,13 +287,8 @@ BlackBoardMemoryManager::alloc_nolock(unsigned int num_bytes)
 	}
 
 	// alloc new chunk
-	if (shmem_) {
-		shmem_header_->set_alloc_list_head(list_add(shmem_header_->alloc_list_head(), f));
-		return shmem_->ptr(f->ptr);
-	} else {
-		alloc_list_head_ = list_add(alloc_list_head_, f);
-		return f->ptr;
-	}
+	alloc_list_add(f);
+	return shmem_ ? shmem_->ptr(f->ptr) : f->ptr;
 }
 
 /** Allocate memory.
@@ -332,44 +334,48 @@ void
 BlackBoardMemoryManager::free(void *ptr)
 {
 	mutex_->lock();
-	if (shmem_) {
+	if (shmem_)
 		shmem_->lock_for_write();
 
-		// find chunk in alloc_chunks
-		chunk_list_t *ac = list_find_ptr(shmem_header_->alloc_list_head(), chunk_addr(ptr));
-		if (ac == NULL) {
-			throw BlackBoardMemMgrInvalidPointerException();
-		}
-
-		// remove from alloc_chunks
-		shmem_header_->set_alloc_list_head(list_remove(shmem_header_->alloc_list_head(), ac));
-
-		// reclaim as free memory
-		ac->overhang = 0;
-		shmem_header_->set_free_list_head(list_add(shmem_header_->free_list_head(), ac));
-
-		// merge adjacent regions
-		cleanup_free_chunks();
+	// the chunk header directly precedes the data segment
+	char *        base = (char *)(shmem_ ? shmem_->memptr() : memory_);
+	chunk_list_t *ac   = (chunk_list_t *)((char *)ptr - sizeof(chunk_list_t));
+	if (((char *)ptr < base + sizeof(chunk_list_t)) || ((char *)ptr >= base + memsize_)
+	    || (ac->state != BBMM_CHUNK_ALLOCATED) || (ac->ptr != chunk_addr(ptr))) {
+		if (shmem_)
+			shmem_->unlock();
+		mutex_->unlock();
+		throw BlackBoardMemMgrInvalidPointerException();
+	}
 
-		shmem_->unlock();
-	} else {
-		// find chunk in alloc_chunks
-		chunk_list_t *ac = list_find_ptr(alloc_list_head_, ptr);
-		if (ac == NULL) {
-			throw BlackBoardMemMgrInvalidPointerException();
-		}
+	// remove from alloc_chunks
+	alloc_list_remove(ac);
 
-		// remove from alloc_chunks
-		alloc_list_head_ = list_remove(alloc_list_head_, ac);
+	// reclaim as free memory, merge with adjacent free regions
+	ac->overhang = 0;
 
-		// reclaim as free memory
-		ac->overhang    = 0;
-		free_list_head_ = list_add(free_list_head_, ac);
+	chunk_list_t *n = chunk_phys_next(ac);
+	if (n && (n->state == BBMM_CHUNK_FREE)) {
+		free_list_remove(n);
+		ac->size += n->size + sizeof(chunk_list_t);
+		n = chunk_phys_next(ac);
+		if (n)
+			n->prev_phys = chunk_addr(ac);
+	}
 
-		// merge adjacent regions
-		cleanup_free_chunks();
+	chunk_list_t *p = chunk_phys_prev(ac);
+	if (p && (p->state == BBMM_CHUNK_FREE)) {
+		free_list_remove(p);
+		p->size += ac->size + sizeof(chunk_list_t);
+		if (n)
+			n->prev_phys = chunk_addr(p);
+		ac = p;
 	}
 
+	free_list_add(ac);
+
+	if (shmem_)
+		shmem_->unlock();
 	mutex_->unlock();
 }
 
@@ -383,62 +389,50 @@ BlackBoardMemoryManager::free(void *ptr)
 void
 BlackBoardMemoryManager::check()
 {
-	chunk_list_t *f = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
-	chunk_list_t *a = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
-	chunk_list_t *t = NULL;
-
-	unsigned int mem = 0;
-
-	// we crawl through the memory and analyse if the chunks are continuous,
-	// assumption: chunk list sorted ascending by ptr
-	while (f || a) {
-		if (f == NULL) {
-			mem += a->size + sizeof(chunk_list_t);
-			t = chunk_ptr(a->next);
-			if (t) {
-				// check if a is continuous
-				void *next = (char *)a->ptr + a->size + sizeof(chunk_list_t);
-				if (next != t->ptr) {
-					throw BBInconsistentMemoryException("non-contiguos allocated memory");
-				}
-			}
-			a = t;
-		} else if (a == NULL) {
-			mem += f->size + sizeof(chunk_list_t);
-			t = chunk_ptr(f->next);
-			if (t) {
-				// check if f is continuous
-				void *next = (char *)f->ptr + f->size + sizeof(chunk_list_t);
-				if (next != t->ptr) {
-					throw BBInconsistentMemoryException("non-contiguos allocated memory");
-				}
-			}
-			f = t;
-		} else if (f->ptr == a->ptr) {
-			throw BBInconsistentMemoryException("ptr cannot be free and allocated at the same time");
-		} else if (f->ptr < a->ptr) {
-			mem += f->size + sizeof(chunk_list_t);
-			void *next = (char *)f->ptr + f->size;
-			t          = chunk_ptr(f->next);
-			if ((next != t) && (next != a)) {
-				throw BBInconsistentMemoryException("there are unallocated bytes between chunks (f)");
+	chunk_list_t *c = first_chunk();
+	chunk_list_t *p = NULL;
+
+	unsigned int mem       = 0;
+	unsigned int num_free  = 0;
+	unsigned int num_alloc = 0;
+	bool         prev_free = false;
+
+	// we crawl through the memory and analyse if the chunks are continuous
+	while (c) {
+		if (chunk_phys_prev(c) != p) {
+			throw BBInconsistentMemoryException("chunk does not point to its predecessor");
+		}
+		if ((shmem_ ? shmem_->ptr(c->ptr) : c->ptr) != (char *)c + sizeof(chunk_list_t)) {
+			throw BBInconsistentMemoryException("chunk data does not follow chunk header");
+		}
+		if (c->state == BBMM_CHUNK_FREE) {
+			if (prev_free) {
+				throw BBInconsistentMemoryException("adjacent free chunks have not been merged");
 			}
-			f = t;
+			prev_free = true;
+			++num_free;
+		} else if (c->state == BBMM_CHUNK_ALLOCATED) {
+			prev_free = false;
+			++num_alloc;
 		} else {
-			mem += a->size + sizeof(chunk_list_t);
-			void *next = (char *)a->ptr + a->size;
-			t          = chunk_ptr(a->next);
-			if ((next != t) && (next != f)) {
-				throw BBInconsistentMemoryException("there are unallocated bytes between chunks (a)");
-			}
-			a = t;
+			throw BBInconsistentMemoryException("chunk is neither free nor allocated");
 		}
+		mem += c->size + sizeof(chunk_list_t);
+		p = c;
+		c = chunk_phys_next(c);
 	}
 
 	if (mem != memsize_) {
 		throw BBInconsistentMemoryException(
 		  "unmanaged memory found, managed memory size != total memory size");
 	}
+
+	if (num_free != num_free_chunks()) {
+		throw BBInconsistentMemoryException("free chunk not found in free lists");
+	}
+	if (num_alloc != num_allocated_chunks()) {
+		throw BBInconsistentMemoryException("allocated chunk not found in allocated list");
+	}
 }
 
 /** Check if this BB memory manager is the master.
@@ -457,7 +451,7 @@ BlackBoardMemoryManager::is_master() const
 void
 BlackBoardMemoryManager::print_free_chunks_info() const
 {
-	list_print_info(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
+	chunks_print_info(BBMM_CHUNK_FREE);
 }
 
 /** Print out info about allocated chunks.
@@ -466,7 +460,7 @@ BlackBoardMemoryManager::print_free_chunks_info() const
 void
 BlackBoardMemoryManager::print_allocated_chunks_info() const
 {
-	list_print_info(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_);
+	chunks_print_info(BBMM_CHUNK_ALLOCATED);
 }
 
 /** Prints out performance info.
@@ -478,8 +472,8 @@ void
 BlackBoardMemoryManager::print_performance_info() const
 {
 	printf("free chunks: %6u, alloc chunks: %6u, max free: %10u, max alloc: %10u, overhang: %10u\n",
-	       list_length(shmem_ ? shmem_header_->free_list_head() : free_list_head_),
-	       list_length(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_),
+	       num_free_chunks(),
+	       list_length(alloc_list_head()),
 	       max_free_size(),
 	       max_allocated_size(),
 	       overhang_size());
@@ -493,7 +487,7 @@ BlackBoardMemoryManager::print_performance_info() const
 unsigned int
 BlackBoardMemoryManager::max_free_size() const
 {
-	chunk_list_t *m = list_get_biggest(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
+	chunk_list_t *m = free_list_get_biggest();
 	if (m == NULL) {
 		return 0;
 	} else {
@@ -511,11 +505,12 @@ BlackBoardMemoryManager::max_free_size() const
 unsigned int
 BlackBoardMemoryManager::free_size() const
 {
-	unsigned int  free_size = 0;
-	chunk_list_t *l         = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
-	while (l) {
-		free_size += l->size;
-		l = chunk_ptr(l->next);
+	unsigned int       free_size = 0;
+	chunk_free_bins_t *bins      = free_bins();
+	for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+		for (chunk_list_t *l = chunk_ptr(bins->heads[i]); l; l = chunk_ptr(l->next)) {
+			free_size += l->size;
+		}
 	}
 	return free_size;
 }
@@ -528,7 +523,7 @@ unsigned int
 BlackBoardMemoryManager::allocated_size() const
 {
 	unsigned int  alloc_size = 0;
-	chunk_list_t *l          = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
+	chunk_list_t *l          = alloc_list_head();
 	while (l) {
 		alloc_size += l->size;
 		l = chunk_ptr(l->next);
@@ -542,7 +537,7 @@ BlackBoardMemoryManager::allocated_size() const
 unsigned int
 BlackBoardMemoryManager::num_allocated_chunks() const
 {
-	return list_length(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_);
+	return list_length(alloc_list_head());
 }
 
 /** Get number of free chunks.
@@ -551,7 +546,12 @@ BlackBoardMemoryManager::num_allocated_chunks() const
 unsigned int
 BlackBoardMemoryManager::num_free_chunks() const
 {
-	return list_length(shmem_ ? shmem_header_->free_list_head() : free_list_head_);
+	unsigned int       num  = 0;
+	chunk_free_bins_t *bins = free_bins();
+	for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+		num += list_length(chunk_ptr(bins->heads[i]));
+	}
+	return num;
 }
 
 /** Get size of memory.
@@ -628,7 +628,7 @@ BlackBoardMemoryManager::unlock()
 unsigned int
 BlackBoardMemoryManager::max_allocated_size() const
 {
-	chunk_list_t *m = list_get_biggest(shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_);
+	chunk_list_t *m = list_get_biggest(alloc_list_head());
 	if (m == NULL) {
 		return 0;
 	} else {
@@ -645,7 +645,7 @@ unsigned int
 BlackBoardMemoryManager::overhang_size() const
 {
 	unsigned int  overhang = 0;
-	chunk_list_t *a        = shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
+	chunk_list_t *a        = alloc_list_head();
 	while (a) {
 		overhang += a->overhang;
 		a = chunk_ptr(a->next);
@@ -653,159 +653,198 @@ BlackBoardMemoryManager::overhang_size() const
 	return overhang;
 }
 
-/** Cleanup and merge free chunks.
- * This will merge adjacent free chunks into one big chunk. After this method ran it
- * is guaranteed that the maximum available memory resides in one chunk.
+/** Get segregated free lists.
+ * @return free lists, either from the shared memory header or the local ones
+ */
+chunk_free_bins_t *
+BlackBoardMemoryManager::free_bins() const
+{
+	return shmem_ ? shmem_header_->free_bins() : (chunk_free_bins_t *)&heap_free_bins_;
+}
+
+/** Get head of allocated chunks list.
+ * @return head of allocated chunks list, local pointer
+ */
+chunk_list_t *
+BlackBoardMemoryManager::alloc_list_head() const
+{
+	return shmem_ ? shmem_header_->alloc_list_head() : alloc_list_head_;
+}
+
+/** Set head of allocated chunks list.
+ * @param alh new head of allocated chunks list, local pointer
  */
 void
-BlackBoardMemoryManager::cleanup_free_chunks()
+BlackBoardMemoryManager::set_alloc_list_head(chunk_list_t *alh)
 {
-	bool          modified = true;
-	chunk_list_t *l;
-	chunk_list_t *n; // next
-
-	while (modified) {
-		modified = false;
-		l        = shmem_ ? shmem_header_->free_list_head() : free_list_head_;
-		n        = chunk_ptr(l->next);
-		while (l && n) {
-			if (((char *)l->ptr + l->size + sizeof(chunk_list_t)) == n->ptr) {
-				// re-unite
-				l->size += n->size + sizeof(chunk_list_t);
-				l->next  = n->next;
-				modified = true;
-			}
-			l = n;
-			n = chunk_ptr(l->next);
-		}
+	if (shmem_) {
+		shmem_header_->set_alloc_list_head(alh);
+	} else {
+		alloc_list_head_ = alh;
 	}
 }
 
-/** Remove an element from a list.
- * @param list list to remove the element from
- * @param rmel element to remove
- * @return the head of the new resulting list
- * @exception NullPointerException thrown if list or rmel equals NULL
+/** Get physically first chunk.
+ * @return chunk at the very beginning of the memory segment
  */
 chunk_list_t *
-BlackBoardMemoryManager::list_remove(chunk_list_t *list, chunk_list_t *rmel)
+BlackBoardMemoryManager::first_chunk() const
 {
-	if (list == NULL)
-		throw NullPointerException("BlackBoardMemoryManager::list_remove: list == NULL");
-	if (rmel == NULL)
-		throw NullPointerException("BlackBoardMemoryManager::list_remove: rmel == NULL");
+	return (chunk_list_t *)(shmem_ ? shmem_->memptr() : memory_);
+}
 
-	chunk_list_t *new_head = list;
-	chunk_list_t *l        = list;
-	chunk_list_t *p        = NULL;
+/** Get physically succeeding chunk.
+ * @param c chunk to get the successor of
+ * @return chunk directly following the data segment of c, or NULL if c is
+ * the last chunk in the memory segment
+ */
+chunk_list_t *
+BlackBoardMemoryManager::chunk_phys_next(const chunk_list_t *c) const
+{
+	char *end = (char *)first_chunk() + memsize_;
+	char *n   = (char *)c + sizeof(chunk_list_t) + c->size;
+	return (n < end) ? (chunk_list_t *)n : NULL;
+}
 
-	while (l) {
-		if (l == rmel) {
-			// found element, now remove
-			if (p) {
-				// we have a predecessor
-				p->next = l->next;
-			} else {
-				// new head
-				new_head = chunk_ptr(l->next);
-			}
-			break;
-		}
-		p = l;
-		l = chunk_ptr(l->next);
-	}
+/** Get physically preceding chunk.
+ * @param c chunk to get the predecessor of
+ * @return chunk directly preceding c, or NULL if c is the first chunk
+ */
+chunk_list_t *
+BlackBoardMemoryManager::chunk_phys_prev(const chunk_list_t *c) const
+{
+	return chunk_ptr(c->prev_phys);
+}
 
-	return new_head;
+/** Add chunk to the free list of its size class.
+ * @param c chunk to add
+ */
+void
+BlackBoardMemoryManager::free_list_add(chunk_list_t *c)
+{
+	chunk_free_bins_t *bins = free_bins();
+	unsigned int       sc   = size_class(c->size);
+	chunk_list_t *     h    = chunk_ptr(bins->heads[sc]);
+
+	c->state = BBMM_CHUNK_FREE;
+	c->prev  = NULL;
+	c->next  = chunk_addr(h);
+	if (h)
+		h->prev = chunk_addr(c);
+	bins->heads[sc] = chunk_addr(c);
+	bins->map |= (1u << sc);
 }
 
-/** Add an element to a list.
- * @param list list to add the element to
- * @param rmel element to add
- * @return the head of the new resulting list
- * @exception NullPointerException thrown if addel equals NULL
+/** Remove chunk from the free list of its size class.
+ * @param c chunk to remove
  */
-chunk_list_t *
-BlackBoardMemoryManager::list_add(chunk_list_t *list, chunk_list_t *addel)
+void
+BlackBoardMemoryManager::free_list_remove(chunk_list_t *c)
 {
-	if (addel == NULL)
-		throw NullPointerException("BlackBoardMemoryManager::list_add: addel == NULL");
+	chunk_free_bins_t *bins = free_bins();
+	unsigned int       sc   = size_class(c->size);
+	chunk_list_t *     p    = chunk_ptr(c->prev);
+	chunk_list_t *     n    = chunk_ptr(c->next);
 
-	chunk_list_t *new_head = list;
-	chunk_list_t *l        = list;
-	chunk_list_t *p        = NULL;
+	if (p) {
+		p->next = c->next;
+	} else {
+		bins->heads[sc] = c->next;
+		if (n == NULL)
+			bins->map &= ~(1u << sc);
+	}
+	if (n)
+		n->prev = c->prev;
+	c->next = c->prev = NULL;
+}
 
-	while (l) {
-		if (addel->ptr < l->ptr) {
-			// add it here
-			addel->next = chunk_addr(l);
-			if (p != NULL) {
-				// predecessor needs new successor
-				// before: p->next == l
-				p->next = chunk_addr(addel);
-			} else {
-				new_head = addel;
-			}
-			// used as condition below
-			l = addel;
-			break;
-		} else {
-			p = l;
-			l = chunk_ptr(l->next);
+/** Find a free chunk big enough for the given size.
+ * Prefers the first chunk of the smallest size class all of whose chunks
+ * are big enough, which is found in constant time. Only if there is none
+ * the size class which may contain chunks just big enough is searched.
+ * @param num_bytes number of bytes the chunk must be able to hold at least
+ * @return free chunk with size of at least num_bytes or NULL if no such
+ * chunk exists
+ */
+chunk_list_t *
+BlackBoardMemoryManager::free_list_find(unsigned int num_bytes) const
+{
+	chunk_free_bins_t *bins     = free_bins();
+	unsigned int       floor_sc = size_class(num_bytes);
+	unsigned int       ceil_sc  = floor_sc;
+	if ((num_bytes & (num_bytes - 1)) != 0)
+		++ceil_sc;
+
+	if (ceil_sc < BBMM_NUM_SIZE_CLASSES) {
+		unsigned int map = bins->map & ~((1u << ceil_sc) - 1);
+		if (map != 0) {
+			return chunk_ptr(bins->heads[__builtin_ctz(map)]);
 		}
 	}
 
-	// if l is not addel it has not yet been added
-	if (l != addel) {
-		// p is last element of list and != NULL
-		addel->next = NULL;
-		if (p) {
-			p->next = chunk_addr(addel);
-		} else {
-			new_head = addel;
+	if (ceil_sc != floor_sc) {
+		for (chunk_list_t *l = chunk_ptr(bins->heads[floor_sc]); l; l = chunk_ptr(l->next)) {
+			if (l->size >= num_bytes)
+				return l;
 		}
 	}
 
-	return new_head;
+	return NULL;
 }
 
-/** Find a chunk by ptr.
- * @param list list to search
- * @param ptr Pointer to search for
- * @return the chunk that points to ptr or NULL if not found
+/** Add chunk to the allocated chunks list.
+ * @param c chunk to add
  */
-chunk_list_t *
-BlackBoardMemoryManager::list_find_ptr(chunk_list_t *list, void *ptr)
+void
+BlackBoardMemoryManager::alloc_list_add(chunk_list_t *c)
 {
-	chunk_list_t *l = list;
-	while (l) {
-		if (l->ptr == ptr) {
-			// found it
-			return l;
-		} else {
-			l = chunk_ptr(l->next);
-		}
-	}
-	return NULL;
+	chunk_list_t *h = alloc_list_head();
+
+	c->state = BBMM_CHUNK_ALLOCATED;
+	c->prev  = NULL;
+	c->next  = chunk_addr(h);
+	if (h)
+		h->prev = chunk_addr(c);
+	set_alloc_list_head(c);
 }
 
-/** Print info about chunks in list.
- * Will print information about chunks in list to stdout. Will give pointer as hexadezimal
- * number, size and overhanging bytes of chunk
- * @param list list with chunks to print
+/** Remove chunk from the allocated chunks list.
+ * @param c chunk to remove
  */
 void
-BlackBoardMemoryManager::list_print_info(const chunk_list_t *list) const
+BlackBoardMemoryManager::alloc_list_remove(chunk_list_t *c)
 {
-	chunk_list_t *l = (chunk_list_t *)list;
-	unsigned int  i = 0;
+	chunk_list_t *p = chunk_ptr(c->prev);
+	chunk_list_t *n = chunk_ptr(c->next);
 
-	while (l) {
-		printf("Chunk %3u:  0x%x   size=%10u bytes   overhang=%10u bytes\n",
-		       ++i,
-		       (unsigned int)(size_t)l->ptr,
-		       l->size,
-		       l->overhang);
-		l = chunk_ptr(l->next);
+	if (p) {
+		p->next = c->next;
+	} else {
+		set_alloc_list_head(n);
+	}
+	if (n)
+		n->prev = c->prev;
+	c->next = c->prev = NULL;
+}
+
+/** Print info about chunks in a given state.
+ * Will print information about chunks to stdout ordered by address. Will give
+ * pointer as hexadezimal number, size and overhanging bytes of chunk
+ * @param state state of chunks to print, BBMM_CHUNK_FREE or BBMM_CHUNK_ALLOCATED
+ */
+void
+BlackBoardMemoryManager::chunks_print_info(unsigned int state) const
+{
+	unsigned int i = 0;
+
+	for (chunk_list_t *c = first_chunk(); c; c = chunk_phys_next(c)) {
+		if (c->state == state) {
+			printf("Chunk %3u:  0x%x   size=%10u bytes   overhang=%10u bytes\n",
+			       ++i,
+			       (unsigned int)(size_t)c->ptr,
+			       c->size,
+			       c->overhang);
+		}
 	}
 }
 
@@ -843,6 +882,18 @@ BlackBoardMemoryManager::list_get_biggest(const chunk_list_t *list) const
 	return b;
 }
 
+/** Get biggest chunk from free lists.
+ * @return biggest free chunk or NULL if there is no free memory
+ */
+chunk_list_t *
+BlackBoardMemoryManager::free_list_get_biggest() const
+{
+	chunk_free_bins_t *bins = free_bins();
+	if (bins->map == 0)
+		return NULL;
+	return list_get_biggest(chunk_ptr(bins->heads[size_class(bins->map)]));
+}
+
 /** Get first element for chunk iteration.
  * @return Iterator pointing to first memory chunk
  */
@@ -850,7 +901,7 @@ BlackBoardMemoryManager::ChunkIterator
 BlackBoardMemoryManager::begin()
 {
 	if (shmem_) {
-		return BlackBoardMemoryManager::ChunkIterator(shmem_, shmem_header_->alloc_list_head());
+		return BlackBoardMemoryManager::ChunkIterator(shmem_, alloc_list_head());
 	} else {
 		return BlackBoardMemoryManager::ChunkIterator(alloc_list_head_);
 	}
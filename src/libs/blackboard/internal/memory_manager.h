@@ -35,19 +35,44 @@ class SharedMemory;
 class Mutex;
 class SemaphoreSet;
 
+/** Number of size classes of the segregated free lists.
+ * Free chunks are binned by the position of the most significant bit of
+ * their size, hence one class per bit of an unsigned int.
+ */
+#define BBMM_NUM_SIZE_CLASSES 32
+
 // define our own list type std::list is way too fat
 /** Chunk lists as stored in BlackBoard shared memory segment.
  * The data segment of a chunk follows directly after the header. So if c is a chunk_list_t
  * pointer to a chunk then the data segment of that chunk can be accessed via
  * (char *)c + sizeof(chunk_list_t).
+ * The next and prev pointers link the chunk either into the allocated chunks list
+ * or into the free list of its size class. The physical successor of a chunk is
+ * found right after its data segment, the physical predecessor is recorded
+ * explicitly to allow for merging free neighbours in constant time.
  */
 struct chunk_list_t
 {
-	chunk_list_t *next;     /**< offset to next element in list */
-	void *        ptr;      /**< pointer to data memory */
-	unsigned int  size;     /**< total size of chunk, including overhanging bytes,
+	chunk_list_t *next;      /**< offset to next element in list */
+	chunk_list_t *prev;      /**< offset to previous element in list */
+	chunk_list_t *prev_phys; /**< offset to physically preceding chunk, NULL for first */
+	void *        ptr;       /**< pointer to data memory */
+	unsigned int  size;      /**< total size of chunk, including overhanging bytes,
 				 * excluding header */
-	unsigned int  overhang; /**< number of overhanging bytes in this chunk */
+	unsigned int  overhang;  /**< number of overhanging bytes in this chunk */
+	unsigned int  state;     /**< chunk state, BBMM_CHUNK_FREE or BBMM_CHUNK_ALLOCATED */
+};
+
+/** Segregated free lists as stored in BlackBoard shared memory segment.
+ * Free chunks are kept in one doubly linked list per size class. Class i holds
+ * chunks with a size in [2^i, 2^(i+1)). A bit is set in the map for every
+ * class with a non-empty list, so that a fitting class can be found with a
+ * single bit scan.
+ */
+struct chunk_free_bins_t
+{
+	unsigned int  map;                          /**< bitmap of non-empty size classes */
+	chunk_list_t *heads[BBMM_NUM_SIZE_CLASSES]; /**< offsets of the free list heads */
 };
 
 // May be added later if we want/need per chunk semaphores
@@ -133,16 +158,25 @@ public:
 	ChunkIterator end();
 
 private:
-	chunk_list_t *list_add(chunk_list_t *list, chunk_list_t *addel);
-	chunk_list_t *list_remove(chunk_list_t *list, chunk_list_t *rmel);
-	chunk_list_t *list_find_ptr(chunk_list_t *list, void *ptr);
+	chunk_free_bins_t *free_bins() const;
+	chunk_list_t *     alloc_list_head() const;
+	void               set_alloc_list_head(chunk_list_t *alh);
+
+	chunk_list_t *first_chunk() const;
+	chunk_list_t *chunk_phys_next(const chunk_list_t *c) const;
+	chunk_list_t *chunk_phys_prev(const chunk_list_t *c) const;
+
+	void          free_list_add(chunk_list_t *c);
+	void          free_list_remove(chunk_list_t *c);
+	chunk_list_t *free_list_find(unsigned int num_bytes) const;
+	void          alloc_list_add(chunk_list_t *c);
+	void          alloc_list_remove(chunk_list_t *c);
+
 	unsigned int  list_length(const chunk_list_t *list) const;
 	chunk_list_t *list_get_biggest(const chunk_list_t *list) const;
-	chunk_list_t *list_next(const chunk_list_t *list) const;
-
-	void cleanup_free_chunks();
+	chunk_list_t *free_list_get_biggest() const;
 
-	void list_print_info(const chunk_list_t *list) const;
+	void chunks_print_info(unsigned int state) const;
 
 	void *alloc_nolock(unsigned int num_bytes);
 
@@ -159,9 +193,9 @@ private:
 	SharedMemory *                shmem_;
 
 	// Used for heap memory
-	void *        memory_;
-	chunk_list_t *free_list_head_;  /**< offset of the free chunks list head */
-	chunk_list_t *alloc_list_head_; /**< offset of the allocated chunks list head */
+	void *            memory_;
+	chunk_free_bins_t heap_free_bins_;  /**< segregated free lists */
+	chunk_list_t *    alloc_list_head_; /**< offset of the allocated chunks list head */
 };
 
 } // end namespace fawkes
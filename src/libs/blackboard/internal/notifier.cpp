@@ -24,6 +24,8 @@
 #include <blackboard/blackboard.h>
 #include <blackboard/interface_listener.h>
 #include <blackboard/interface_observer.h>
+#include <blackboard/bbconfig.h>
+#include <blackboard/internal/event_dispatcher.h>
 #include <blackboard/internal/notifier.h>
 #include <core/threading/mutex.h>
 #include <core/threading/mutex_locker.h>
@@ -45,6 +47,11 @@ namespace fawkes {
  * This class is used by the BlackBoard to notify listeners and observers
  * of changes. 
  *
+ * Listeners which requested asynchronous dispatching get data changed and
+ * message received events pushed to their event queue, which is then
+ * processed by a BlackBoardEventDispatcher. The dispatcher threads are
+ * started when the first such listener is registered.
+ *
  * @author Tim Niemueller
  */
 
@@ -65,6 +72,9 @@ BlackBoardNotifier::BlackBoardNotifier()
 
 	bbio_events_ = 0;
 	bbio_mutex_  = new Mutex();
+
+	dispatcher_mutex_ = new Mutex();
+	dispatcher_       = NULL;
 }
 
 /** Destructor */
@@ -76,6 +86,9 @@ BlackBoardNotifier::~BlackBoardNotifier()
 	delete bbil_messages_mutex_;
 
 	delete bbio_mutex_;
+
+	delete dispatcher_;
+	delete dispatcher_mutex_;
 }
 
 /** Register BB event listener.
@@ -99,6 +112,8 @@ void
 BlackBoardNotifier::update_listener(BlackBoardInterfaceListener *    listener,
                                     BlackBoard::ListenerRegisterFlag flag)
 {
+	setup_event_queue(listener);
+
 	const BlackBoardInterfaceListener::InterfaceQueue &queue = listener->bbil_acquire_queue();
 
 	BlackBoardInterfaceListener::InterfaceQueue::const_iterator i = queue.begin();
@@ -245,6 +260,75 @@ BlackBoardNotifier::unregister_listener(BlackBoardInterfaceListener *listener)
 	}
 
 	listener->bbil_release_maps();
+
+	// the queue itself is released with the listener, a notification still
+	// in progress might be about to push to it
+	BlackBoardListenerEventQueue *q = ref_event_queue(listener);
+	if (q) {
+		q->shutdown();
+		q->unref();
+	}
+}
+
+/** Setup event queue for asynchronous listener.
+ * Creates the event queue if the listener requested asynchronous dispatching
+ * and has no active queue, yet. Starts the dispatcher if necessary.
+ * The queue pointer is replaced while holding the listener's map mutex,
+ * notifications take their reference under the same lock. The data
+ * listener mutex is held as well for add_listener(), which accesses the
+ * queue with only that mutex locked.
+ * @param listener listener to setup queue for
+ */
+void
+BlackBoardNotifier::setup_event_queue(BlackBoardInterfaceListener *listener)
+{
+	MutexLocker                   lock(listener->bbil_maps_mutex_);
+	MutexLocker                   data_lock(bbil_data_mutex_);
+	BlackBoardListenerEventQueue *q = listener->bbil_event_queue_;
+	if (q && q->is_shutdown()) {
+		q->unref();
+		listener->bbil_event_queue_ = q = NULL;
+	}
+
+	if (listener->bbil_dispatch_mode_ == BlackBoardInterfaceListener::DISPATCH_SYNC || q)
+		return;
+
+	dispatcher_mutex_->lock();
+	if (!dispatcher_) {
+		dispatcher_ = new BlackBoardEventDispatcher(BLACKBOARD_DISPATCH_THREADS);
+	}
+	dispatcher_mutex_->unlock();
+	listener->bbil_event_queue_ = new BlackBoardListenerEventQueue(
+	  listener,
+	  listener->bbil_dispatch_mode_ == BlackBoardInterfaceListener::DISPATCH_ASYNC_LATEST,
+	  listener->bbil_dispatch_queue_length_);
+}
+
+/** Get referenced event queue of listener.
+ * The reference keeps the queue alive even if setup_event_queue() replaces
+ * it concurrently. It must be released with unref().
+ * @param listener listener to get queue of
+ * @return event queue, NULL if the listener is dispatched synchronously
+ */
+BlackBoardListenerEventQueue *
+BlackBoardNotifier::ref_event_queue(BlackBoardInterfaceListener *listener)
+{
+	MutexLocker                   lock(listener->bbil_maps_mutex_);
+	BlackBoardListenerEventQueue *q = listener->bbil_event_queue_;
+	if (q)
+		q->ref();
+	return q;
+}
+
+/** Schedule listener event queue after pushing an event.
+ * @param queue queue to schedule
+ */
+void
+BlackBoardNotifier::schedule_event_queue(BlackBoardListenerEventQueue *queue)
+{
+	if (queue->try_schedule()) {
+		dispatcher_->schedule(queue);
+	}
 }
 
 /** Add listener for specified map.
@@ -265,6 +349,12 @@ BlackBoardNotifier::add_listener(Interface *                  interface,
 	if (f == ret.second) {
 		ilmap.insert(std::make_pair(interface->uid(), listener));
 	}
+
+	if ((&ilmap == &bbil_data_) && listener->bbil_event_queue_) {
+		// no data notification is running while we are called, and the
+		// queue is not replaced while we hold the data listener mutex
+		listener->bbil_event_queue_->add_data_interface(interface);
+	}
 }
 
 void
@@ -697,7 +787,16 @@ BlackBoardNotifier::notify_of_data_change(const Interface *interface)
 		if (!is_in_queue(/* remove op*/ false, bbil_data_queue_, uid, bbil)) {
 			Interface *bbil_iface = bbil->bbil_data_interface(uid);
 			if (bbil_iface != NULL) {
-				bbil->bb_interface_data_changed(bbil_iface);
+				// hold a reference until scheduled, the dispatcher might
+				// concurrently release the queue after processing it
+				BlackBoardListenerEventQueue *q = ref_event_queue(bbil);
+				if (q) {
+					if (q->push_data(bbil_iface))
+						schedule_event_queue(q);
+					q->unref();
+				} else {
+					bbil->bb_interface_data_changed(bbil_iface);
+				}
 			} else {
 				LibLogger::log_warn("BlackBoardNotifier",
 				                    "BBIL[%s] registered for data change events "
@@ -752,10 +851,18 @@ BlackBoardNotifier::notify_of_message_received(const Interface *interface, Messa
 		if (!is_in_queue(/* remove op*/ false, bbil_messages_queue_, uid, bbil)) {
 			Interface *bbil_iface = bbil->bbil_message_interface(uid);
 			if (bbil_iface != NULL) {
-				bool abort = !bbil->bb_interface_message_received(bbil_iface, message);
-				if (abort) {
-					enqueue = false;
-					break;
+				BlackBoardListenerEventQueue *q = ref_event_queue(bbil);
+				if (q) {
+					// asynchronous listeners cannot veto enqueuing
+					if (q->push_message(bbil_iface, message))
+						schedule_event_queue(q);
+					q->unref();
+				} else {
+					bool abort = !bbil->bb_interface_message_received(bbil_iface, message);
+					if (abort) {
+						enqueue = false;
+						break;
+					}
 				}
 			} else {
 				LibLogger::log_warn("BlackBoardNotifier",
@@ -38,6 +38,8 @@ namespace fawkes {
 class Interface;
 class Message;
 class Mutex;
+class BlackBoardEventDispatcher;
+class BlackBoardListenerEventQueue;
 
 class BlackBoardNotifier
 {
@@ -122,6 +124,10 @@ private:
 
 	bool is_in_queue(bool op, BBilQueue &queue, const char *uid, BlackBoardInterfaceListener *bbil);
 
+	void                          setup_event_queue(BlackBoardInterfaceListener *listener);
+	BlackBoardListenerEventQueue *ref_event_queue(BlackBoardInterfaceListener *listener);
+	void schedule_event_queue(BlackBoardListenerEventQueue *queue);
+
 	BBilMap bbil_data_;
 	BBilMap bbil_reader_;
 	BBilMap bbil_writer_;
@@ -152,6 +158,9 @@ private:
 	Mutex *      bbio_mutex_;
 	unsigned int bbio_events_;
 	BBioQueue    bbio_queue_;
+
+	Mutex *                    dispatcher_mutex_;
+	BlackBoardEventDispatcher *dispatcher_;
 };
 
 } // end namespace fawkes
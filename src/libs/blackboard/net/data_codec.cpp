@@ -0,0 +1,421 @@
+
+/***************************************************************************
+ *  data_codec.cpp - BlackBoard network interface data encoding
+ *
+ *  Created: Fri Oct 16 16:48:20 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <arpa/inet.h>
+#include <blackboard/net/data_codec.h>
+#include <blackboard/net/messages.h>
+#include <core/exception.h>
+#include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <netcomm/fawkes/message.h>
+#include <netcomm/fawkes/message_content.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+/** Maximum number of unused buffers kept per pool. */
+#define MAX_FREE_BUFFERS 8
+
+/** Changed bytes separated by at most this many unchanged bytes are sent
+ * as a single record, which is smaller than two records. */
+#define MAX_RECORD_GAP 3
+
+/* Message content in a pooled buffer, which is returned on deletion. */
+class BlackBoardPooledContent : public FawkesNetworkMessageContent
+{
+public:
+	BlackBoardPooledContent(std::shared_ptr<BlackBoardPayloadPool> pool, void *buffer, size_t size)
+	: pool_(pool)
+	{
+		_payload      = buffer;
+		_payload_size = size;
+	}
+
+	virtual ~BlackBoardPooledContent()
+	{
+		pool_->release(_payload);
+	}
+
+	virtual void
+	serialize()
+	{
+	}
+
+private:
+	std::shared_ptr<BlackBoardPayloadPool> pool_;
+};
+
+static inline size_t
+write_varint(unsigned char *out, size_t value)
+{
+	size_t n = 0;
+	while (value >= 0x80) {
+		out[n++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	out[n++] = value;
+	return n;
+}
+
+static inline bool
+read_varint(const unsigned char *in, size_t size, size_t &offset, size_t &value)
+{
+	value = 0;
+	for (unsigned int shift = 0; shift < 32; shift += 7) {
+		if (offset >= size)
+			return false;
+		unsigned char b = in[offset++];
+		value |= (size_t)(b & 0x7F) << shift;
+		if (!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+/* Encode XOR of data and base run length encoded to out.
+ * Returns the encoded size, or max_size + 1 if it would exceed max_size. */
+static size_t
+encode_delta(const unsigned char *base,
+             const unsigned char *data,
+             size_t               size,
+             unsigned char *      out,
+             size_t               max_size)
+{
+	size_t o = 0, i = 0, last_end = 0;
+	while (i < size) {
+		if (data[i] == base[i]) {
+			++i;
+			continue;
+		}
+
+		size_t last_changed = i;
+		for (size_t j = i + 1; j < size && j - last_changed <= MAX_RECORD_GAP + 1; ++j) {
+			if (data[j] != base[j])
+				last_changed = j;
+		}
+		size_t len = last_changed - i + 1;
+
+		// two varints of at most 5 bytes each for sizes below 2^35
+		if (o + 10 + len > max_size)
+			return max_size + 1;
+
+		o += write_varint(out + o, i - last_end);
+		o += write_varint(out + o, len);
+		for (size_t j = i; j <= last_changed; ++j) {
+			out[o++] = data[j] ^ base[j];
+		}
+		i = last_end = last_changed + 1;
+	}
+	return o;
+}
+
+/* Check that delta is well-formed for data of the given size. */
+static bool
+validate_delta(const unsigned char *delta, size_t delta_size, size_t size)
+{
+	size_t o = 0, pos = 0;
+	while (o < delta_size) {
+		size_t skip, len;
+		if (!read_varint(delta, delta_size, o, skip) || !read_varint(delta, delta_size, o, len)
+		    || (len == 0) || (skip > size - pos) || (len > size - pos - skip)
+		    || (len > delta_size - o)) {
+			return false;
+		}
+		pos += skip + len;
+		o += len;
+	}
+	return true;
+}
+
+/* Apply validated delta to data in place. */
+static void
+apply_delta(const unsigned char *delta, size_t delta_size, unsigned char *data)
+{
+	size_t o = 0, pos = 0;
+	while (o < delta_size) {
+		size_t skip, len;
+		read_varint(delta, delta_size, o, skip);
+		read_varint(delta, delta_size, o, len);
+		pos += skip;
+		for (size_t i = 0; i < len; ++i) {
+			data[pos++] ^= delta[o++];
+		}
+	}
+}
+/// @endcond
+
+/** @class BlackBoardPayloadPool <blackboard/net/data_codec.h>
+ * Pool of network message payload buffers.
+ * Buffers have a fixed size and are kept for re-use when released, up to a
+ * small number of free buffers. Acquire and release may be called from
+ * different threads, typically buffers are released by the network thread
+ * after the message has been sent.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param buffer_size size in bytes of each buffer
+ */
+BlackBoardPayloadPool::BlackBoardPayloadPool(size_t buffer_size) : buffer_size_(buffer_size)
+{
+	mutex_ = new Mutex();
+}
+
+/** Destructor. */
+BlackBoardPayloadPool::~BlackBoardPayloadPool()
+{
+	for (void *b : free_) {
+		free(b);
+	}
+	delete mutex_;
+}
+
+/** Get buffer size.
+ * @return size in bytes of each buffer
+ */
+size_t
+BlackBoardPayloadPool::buffer_size() const
+{
+	return buffer_size_;
+}
+
+/** Acquire a buffer.
+ * @return buffer of buffer_size() bytes, give it back with release()
+ */
+void *
+BlackBoardPayloadPool::acquire()
+{
+	MutexLocker lock(mutex_);
+	if (free_.empty()) {
+		lock.unlock();
+		void *b = malloc(buffer_size_);
+		if (!b)
+			throw OutOfMemoryException("Cannot allocate BlackBoard payload buffer");
+		return b;
+	}
+	void *b = free_.back();
+	free_.pop_back();
+	return b;
+}
+
+/** Release a buffer.
+ * @param buffer buffer previously acquired from this pool
+ */
+void
+BlackBoardPayloadPool::release(void *buffer)
+{
+	MutexLocker lock(mutex_);
+	if (free_.size() < MAX_FREE_BUFFERS) {
+		free_.push_back(buffer);
+	} else {
+		lock.unlock();
+		free(buffer);
+	}
+}
+
+/** @class BlackBoardDataEncoder <blackboard/net/data_codec.h>
+ * Encoder for interface data sent over the network.
+ * Without delta encoding the data is sent as MSG_BB_DATA_CHANGED message.
+ * With delta encoding it is sent as MSG_BB_DATA_DELTA message, which only
+ * contains the bytes changed since the previous message, or the full data
+ * if that is smaller or if there is no previous message. This relies on
+ * the in-order delivery of the Fawkes network protocol, a receiver which
+ * lost track of the data asks for the full data with MSG_BB_DATA_RESYNC.
+ * Payloads are taken from a pool, i.e. encoding does not allocate memory
+ * in the steady state.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param serial instance serial of the interface
+ * @param data_size size in bytes of the interface data
+ */
+BlackBoardDataEncoder::BlackBoardDataEncoder(unsigned int serial, size_t data_size)
+: serial_(serial), data_size_(data_size), delta_(false), base_(data_size)
+{
+	pool_       = std::make_shared<BlackBoardPayloadPool>(sizeof(bb_idelta_msg_t) + data_size);
+	base_valid_ = false;
+	seq_        = 0;
+}
+
+/** Enable or disable delta encoding.
+ * @param delta true to send MSG_BB_DATA_DELTA, false to send
+ * MSG_BB_DATA_CHANGED messages
+ */
+void
+BlackBoardDataEncoder::set_delta(bool delta)
+{
+	delta_ = delta;
+	resync();
+}
+
+/** Check if delta encoding is enabled.
+ * @return true if delta encoding is enabled
+ */
+bool
+BlackBoardDataEncoder::delta() const
+{
+	return delta_;
+}
+
+/** Send the full data with the next message.
+ * Call this if the receiver requested it with MSG_BB_DATA_RESYNC.
+ */
+void
+BlackBoardDataEncoder::resync()
+{
+	base_valid_ = false;
+}
+
+/** Encode data.
+ * @param data interface data of the size given to the constructor
+ * @param msgid upon return the message type of the encoded data
+ * @return message content, pass it to a FawkesNetworkMessage which then
+ * owns it
+ */
+FawkesNetworkMessageContent *
+BlackBoardDataEncoder::encode(const void *data, unsigned short int &msgid)
+{
+	unsigned char *payload = (unsigned char *)pool_->acquire();
+
+	if (!delta_) {
+		bb_idata_msg_t *dm = (bb_idata_msg_t *)payload;
+		dm->serial         = htonl(serial_);
+		dm->data_size      = htonl(data_size_);
+		memcpy(payload + sizeof(bb_idata_msg_t), data, data_size_);
+		msgid = MSG_BB_DATA_CHANGED;
+		return new BlackBoardPooledContent(pool_, payload, sizeof(bb_idata_msg_t) + data_size_);
+	}
+
+	uint32_t base_seq = seq_;
+	seq_ += 1;
+	if (seq_ == 0)
+		seq_ = 1;
+
+	unsigned char *chunk      = payload + sizeof(bb_idelta_msg_t);
+	size_t         delta_size = data_size_ + 1;
+	if (base_valid_) {
+		delta_size =
+		  encode_delta(base_.data(), (const unsigned char *)data, data_size_, chunk, data_size_);
+	}
+	if (delta_size > data_size_) {
+		base_seq   = 0;
+		delta_size = data_size_;
+		memcpy(chunk, data, data_size_);
+	}
+	memcpy(base_.data(), data, data_size_);
+	base_valid_ = true;
+
+	bb_idelta_msg_t *dm = (bb_idelta_msg_t *)payload;
+	dm->serial          = htonl(serial_);
+	dm->data_size       = htonl(data_size_);
+	dm->seq             = htonl(seq_);
+	dm->base_seq        = htonl(base_seq);
+	dm->delta_size      = htonl(delta_size);
+
+	msgid = MSG_BB_DATA_DELTA;
+	return new BlackBoardPooledContent(pool_, payload, sizeof(bb_idelta_msg_t) + delta_size);
+}
+
+/** @class BlackBoardDataDecoder <blackboard/net/data_codec.h>
+ * Decoder for interface data received over the network.
+ * Decodes the messages created by BlackBoardDataEncoder.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param serial instance serial of the interface
+ * @param data_size size in bytes of the interface data
+ */
+BlackBoardDataDecoder::BlackBoardDataDecoder(unsigned int serial, size_t data_size)
+: serial_(serial), data_size_(data_size), seq_(0)
+{
+}
+
+/** Decode data.
+ * The data is not modified if decoding fails.
+ * @param msg MSG_BB_DATA_CHANGED or MSG_BB_DATA_DELTA message
+ * @param data interface data to update, must be the data of the last
+ * successful call if msg is a delta message
+ * @exception Exception thrown if the message is malformed or a delta to
+ * a version other than the current one, the sender should be asked to
+ * send the full data with MSG_BB_DATA_RESYNC in that case
+ */
+void
+BlackBoardDataDecoder::decode(const FawkesNetworkMessage *msg, void *data)
+{
+	if (msg->msgid() == MSG_BB_DATA_CHANGED) {
+		bb_idata_msg_t *dm = msg->msgge<bb_idata_msg_t>();
+		if (ntohl(dm->serial) != serial_) {
+			throw Exception("Serial mismatch, expected %u, but got %u", serial_, ntohl(dm->serial));
+		}
+		if ((ntohl(dm->data_size) != data_size_)
+		    || (msg->payload_size() < sizeof(bb_idata_msg_t) + data_size_)) {
+			throw Exception("Data size mismatch, expected %zu, but got %u",
+			                data_size_,
+			                ntohl(dm->data_size));
+		}
+		memcpy(data, (char *)msg->payload() + sizeof(bb_idata_msg_t), data_size_);
+		seq_ = 0;
+
+	} else if (msg->msgid() == MSG_BB_DATA_DELTA) {
+		bb_idelta_msg_t *dm         = msg->msgge<bb_idelta_msg_t>();
+		size_t           delta_size = ntohl(dm->delta_size);
+		uint32_t         base_seq   = ntohl(dm->base_seq);
+		if (ntohl(dm->serial) != serial_) {
+			throw Exception("Serial mismatch, expected %u, but got %u", serial_, ntohl(dm->serial));
+		}
+		if ((ntohl(dm->data_size) != data_size_)
+		    || (msg->payload_size() < sizeof(bb_idelta_msg_t) + delta_size)) {
+			throw Exception("Data size mismatch, expected %zu, but got %u",
+			                data_size_,
+			                ntohl(dm->data_size));
+		}
+
+		const unsigned char *chunk = (const unsigned char *)msg->payload() + sizeof(bb_idelta_msg_t);
+		if (base_seq == 0) {
+			if (delta_size != data_size_) {
+				throw Exception("Full data of invalid size %zu, expected %zu", delta_size, data_size_);
+			}
+			memcpy(data, chunk, data_size_);
+		} else {
+			if ((seq_ == 0) || (base_seq != seq_)) {
+				throw Exception("Received delta to version %u, but have version %u", base_seq, seq_);
+			}
+			if (!validate_delta(chunk, delta_size, data_size_)) {
+				throw Exception("Malformed delta for version %u", ntohl(dm->seq));
+			}
+			apply_delta(chunk, delta_size, (unsigned char *)data);
+		}
+		seq_ = ntohl(dm->seq);
+
+	} else {
+		throw Exception("Unexpected message of type %u for data", msg->msgid());
+	}
+}
+
+} // end namespace fawkes
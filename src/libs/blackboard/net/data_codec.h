@@ -0,0 +1,90 @@
+
+/***************************************************************************
+ *  data_codec.h - BlackBoard network interface data encoding
+ *
+ *  Created: Fri Oct 16 16:48:20 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _BLACKBOARD_NET_DATA_CODEC_H_
+#define _BLACKBOARD_NET_DATA_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace fawkes {
+
+class FawkesNetworkMessage;
+class FawkesNetworkMessageContent;
+class Mutex;
+
+class BlackBoardPayloadPool
+{
+public:
+	BlackBoardPayloadPool(size_t buffer_size);
+	~BlackBoardPayloadPool();
+
+	size_t buffer_size() const;
+	void * acquire();
+	void   release(void *buffer);
+
+private:
+	size_t              buffer_size_;
+	Mutex *             mutex_;
+	std::vector<void *> free_;
+};
+
+class BlackBoardDataEncoder
+{
+public:
+	BlackBoardDataEncoder(unsigned int serial, size_t data_size);
+
+	void set_delta(bool delta);
+	bool delta() const;
+	void resync();
+
+	FawkesNetworkMessageContent *encode(const void *data, unsigned short int &msgid);
+
+private:
+	unsigned int                           serial_;
+	size_t                                 data_size_;
+	bool                                   delta_;
+	std::shared_ptr<BlackBoardPayloadPool> pool_;
+	std::vector<unsigned char>             base_;
+	bool                                   base_valid_;
+	uint32_t                               seq_;
+};
+
+class BlackBoardDataDecoder
+{
+public:
+	BlackBoardDataDecoder(unsigned int serial, size_t data_size);
+
+	void decode(const FawkesNetworkMessage *msg, void *data);
+
+private:
+	unsigned int serial_;
+	size_t       data_size_;
+	uint32_t     seq_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -29,6 +29,8 @@
 #include <blackboard/net/interface_listener.h>
 #include <blackboard/net/interface_observer.h>
 #include <blackboard/net/messages.h>
+#include <core/threading/mutex.h>
+#include <core/threading/wait_condition.h>
 #include <interface/interface.h>
 #include <interface/interface_info.h>
 #include <logging/liblogger.h>
@@ -53,11 +55,13 @@ namespace fawkes {
  * @param hub Fawkes network hub
  */
 BlackBoardNetworkHandler::BlackBoardNetworkHandler(BlackBoard *blackboard, FawkesNetworkHub *hub)
-: Thread("BlackBoardNetworkHandler", Thread::OPMODE_WAITFORWAKEUP),
+: Thread("BlackBoardNetworkHandler", Thread::OPMODE_CONTINUOUS),
   FawkesNetworkHandler(FAWKES_CID_BLACKBOARD)
 {
-	bb_   = blackboard;
-	nhub_ = hub;
+	bb_         = blackboard;
+	nhub_       = hub;
+	wait_mutex_ = new Mutex();
+	wait_cond_  = new WaitCondition(wait_mutex_);
 	nhub_->add_handler(this);
 
 	observer_ = new BlackBoardNetHandlerInterfaceObserver(blackboard, hub);
@@ -76,9 +80,14 @@ BlackBoardNetworkHandler::~BlackBoardNetworkHandler()
 	for (iit_ = interfaces_.begin(); iit_ != interfaces_.end(); ++iit_) {
 		bb_->close(iit_->second);
 	}
+	delete wait_cond_;
+	delete wait_mutex_;
 }
 
-/** Process all network messages that have been received. */
+/** Process all network messages that have been received.
+ * Afterwards data held back by the delivery policy of an interface is sent
+ * and the thread waits for new messages or until more data is due.
+ */
 void
 BlackBoardNetworkHandler::loop()
 {
@@ -169,8 +178,10 @@ BlackBoardNetworkHandler::loop()
 					interfaces_[iface->serial()] = iface;
 					client_interfaces_[clid].push_back(iface);
 					serial_to_clid_[iface->serial()] = clid;
+					listeners_.lock();
 					listeners_[iface->serial()] =
 					  new BlackBoardNetHandlerInterfaceListener(bb_, iface, nhub_, clid);
+					listeners_.unlock();
 					send_opensuccess(clid, iface);
 				}
 			} catch (BlackBoardInterfaceNotFoundException &nfe) {
@@ -231,8 +242,10 @@ BlackBoardNetworkHandler::loop()
 					                     "Remote %u closing interface %s",
 					                     clid,
 					                     interfaces_[sm_serial]->uid());
+					listeners_.lock();
 					delete listeners_[sm_serial];
 					listeners_.erase(sm_serial);
+					listeners_.unlock();
 					bb_->close(interfaces_[sm_serial]);
 					interfaces_.erase(sm_serial);
 					interfaces_.unlock();
@@ -256,27 +269,49 @@ BlackBoardNetworkHandler::loop()
 			//		     client_interfaces_.size());
 		} break;
 
-		case MSG_BB_DATA_CHANGED: {
-			void *          payload   = msg->payload();
-			bb_idata_msg_t *dm        = (bb_idata_msg_t *)payload;
-			unsigned int    dm_serial = ntohl(dm->serial);
-			if (interfaces_.find(dm_serial) != interfaces_.end()) {
-				if (ntohl(dm->data_size) != interfaces_[dm_serial]->datasize()) {
-					LibLogger::log_error("BlackBoardNetworkHandler",
-					                     "DATA_CHANGED: Data size mismatch, "
-					                     "expected %zu, but got %zu, ignoring.",
-					                     interfaces_[dm_serial]->datasize(),
-					                     ntohl(dm->data_size));
-				} else {
-					interfaces_[dm_serial]->set_from_chunk((char *)payload + sizeof(bb_idata_msg_t));
-					interfaces_[dm_serial]->write();
-				}
+		case MSG_BB_DATA_CHANGED:
+		case MSG_BB_DATA_DELTA: {
+			// both messages start with the serial
+			bb_iserial_msg_t *sm        = msg->msgge<bb_iserial_msg_t>();
+			unsigned int      sm_serial = ntohl(sm->serial);
+			listeners_.lock();
+			if (listeners_.find(sm_serial) != listeners_.end()) {
+				listeners_[sm_serial]->process_data(msg);
 			} else {
 				LibLogger::log_error("BlackBoardNetworkHandler",
 				                     "DATA_CHANGED: Interface with "
 				                     "serial %u not found, ignoring.",
-				                     dm_serial);
+				                     sm_serial);
 			}
+			listeners_.unlock();
+		} break;
+
+		case MSG_BB_SET_DELIVERY: {
+			bb_idelivery_msg_t *dm        = msg->msg<bb_idelivery_msg_t>();
+			unsigned int        dm_serial = ntohl(dm->serial);
+			listeners_.lock();
+			if ((listeners_.find(dm_serial) != listeners_.end())
+			    && (serial_to_clid_.find(dm_serial) != serial_to_clid_.end())
+			    && (serial_to_clid_[dm_serial] == clid)) {
+				listeners_[dm_serial]->set_delivery(ntohl(dm->flags), ntohl(dm->min_interval_msec));
+			} else {
+				LibLogger::log_warn("BlackBoardNetworkHandler",
+				                    "Client %u tried to set delivery of "
+				                    "interface with serial %u which it has not opened",
+				                    clid,
+				                    dm_serial);
+			}
+			listeners_.unlock();
+		} break;
+
+		case MSG_BB_DATA_RESYNC: {
+			bb_iserial_msg_t *sm        = msg->msg<bb_iserial_msg_t>();
+			unsigned int      sm_serial = ntohl(sm->serial);
+			listeners_.lock();
+			if (listeners_.find(sm_serial) != listeners_.end()) {
+				listeners_[sm_serial]->resync();
+			}
+			listeners_.unlock();
 		} break;
 
 		case MSG_BB_INTERFACE_MESSAGE: {
@@ -331,12 +366,44 @@ BlackBoardNetworkHandler::loop()
 		msg->unref();
 		inbound_queue_.pop_locked();
 	}
+
+	unsigned int wait_msec = flush_listeners();
+
+	wait_mutex_->lock();
+	if (inbound_queue_.empty()) {
+		if (wait_msec > 0) {
+			wait_cond_->reltimed_wait(wait_msec / 1000, (wait_msec % 1000) * 1000000);
+		} else {
+			wait_cond_->wait();
+		}
+	}
+	wait_mutex_->unlock();
+}
+
+unsigned int
+BlackBoardNetworkHandler::flush_listeners()
+{
+	unsigned int wait_msec = 0;
+
+	listeners_.lock();
+	for (lit_ = listeners_.begin(); lit_ != listeners_.end(); ++lit_) {
+		unsigned int due_msec = lit_->second->flush();
+		if ((due_msec > 0) && ((wait_msec == 0) || (due_msec < wait_msec))) {
+			wait_msec = due_msec;
+		}
+	}
+	listeners_.unlock();
+	return wait_msec;
 }
 
 void
 BlackBoardNetworkHandler::send_opensuccess(unsigned int clid, Interface *interface)
 {
-	void *              payload = calloc(1, sizeof(bb_iopensucc_msg_t) + interface->datasize());
+	// the data is followed by the supported features
+	size_t   payload_size = sizeof(bb_iopensucc_msg_t) + interface->datasize() + sizeof(uint32_t);
+	uint32_t features     = htonl(BB_FEATURE_DELTA);
+
+	void *              payload = calloc(1, payload_size);
 	bb_iopensucc_msg_t *osm     = (bb_iopensucc_msg_t *)payload;
 	osm->serial                 = htonl(interface->serial());
 	osm->writer_readers         = htonl(interface->num_readers());
@@ -354,13 +421,10 @@ BlackBoardNetworkHandler::send_opensuccess(unsigned int clid, Interface *interfa
 	memcpy((char *)payload + sizeof(bb_iopensucc_msg_t),
 	       interface->datachunk(),
 	       interface->datasize());
+	memcpy((char *)payload + payload_size - sizeof(uint32_t), &features, sizeof(uint32_t));
 
-	FawkesNetworkMessage *omsg =
-	  new FawkesNetworkMessage(clid,
-	                           FAWKES_CID_BLACKBOARD,
-	                           MSG_BB_OPEN_SUCCESS,
-	                           payload,
-	                           sizeof(bb_iopensucc_msg_t) + interface->datasize());
+	FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
+	  clid, FAWKES_CID_BLACKBOARD, MSG_BB_OPEN_SUCCESS, payload, payload_size);
 	try {
 		nhub_->send(omsg);
 	} catch (Exception &e) {
@@ -392,7 +456,7 @@ BlackBoardNetworkHandler::send_openfailure(unsigned int clid, unsigned int error
 }
 
 /** Handle network message.
- * The message is put into the inbound queue and processed in processAfterLoop().
+ * The message is put into the inbound queue and processed in loop().
  * @param msg message
  */
 void
@@ -400,7 +464,9 @@ BlackBoardNetworkHandler::handle_network_message(FawkesNetworkMessage *msg)
 {
 	msg->ref();
 	inbound_queue_.push_locked(msg);
-	wakeup();
+	wait_mutex_->lock();
+	wait_cond_->wake_all();
+	wait_mutex_->unlock();
 }
 
 /** Client connected. Ignored.
@@ -434,8 +500,10 @@ BlackBoardNetworkHandler::client_disconnected(unsigned int clid)
 			unsigned int serial = (*ciit_)->serial();
 			serial_to_clid_.erase(serial);
 			interfaces_.erase_locked(serial);
+			listeners_.lock();
 			delete listeners_[serial];
 			listeners_.erase(serial);
+			listeners_.unlock();
 			bb_->close(*ciit_);
 		}
 		client_interfaces_.erase(clid);
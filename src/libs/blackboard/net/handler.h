@@ -38,6 +38,8 @@ class BlackBoard;
 class FawkesNetworkHub;
 class BlackBoardNetHandlerInterfaceListener;
 class BlackBoardNetHandlerInterfaceObserver;
+class Mutex;
+class WaitCondition;
 
 class BlackBoardNetworkHandler : public Thread, public FawkesNetworkHandler
 {
@@ -60,18 +62,21 @@ protected:
 	}
 
 private:
-	void send_opensuccess(unsigned int clid, Interface *interface);
-	void send_openfailure(unsigned int clid, unsigned int error_code);
+	unsigned int flush_listeners();
+	void         send_opensuccess(unsigned int clid, Interface *interface);
+	void         send_openfailure(unsigned int clid, unsigned int error_code);
 
 	BlackBoard *                      bb_;
 	LockQueue<FawkesNetworkMessage *> inbound_queue_;
+	Mutex *                           wait_mutex_;
+	WaitCondition *                   wait_cond_;
 
 	// All interfaces, key is the instance serial, value the interface
 	LockMap<unsigned int, Interface *>           interfaces_;
 	LockMap<unsigned int, Interface *>::iterator iit_;
 
-	std::map<unsigned int, BlackBoardNetHandlerInterfaceListener *>           listeners_;
-	std::map<unsigned int, BlackBoardNetHandlerInterfaceListener *>::iterator lit_;
+	LockMap<unsigned int, BlackBoardNetHandlerInterfaceListener *>           listeners_;
+	LockMap<unsigned int, BlackBoardNetHandlerInterfaceListener *>::iterator lit_;
 
 	BlackBoardNetHandlerInterfaceObserver *observer_;
 
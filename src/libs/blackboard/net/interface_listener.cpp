@@ -23,8 +23,11 @@
 
 #include <arpa/inet.h>
 #include <blackboard/blackboard.h>
+#include <blackboard/net/data_codec.h>
 #include <blackboard/net/interface_listener.h>
 #include <blackboard/net/messages.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <interface/interface.h>
 #include <logging/liblogger.h>
 #include <netcomm/fawkes/component_ids.h>
@@ -41,6 +44,11 @@ namespace fawkes {
  * Interface listener for network handler.
  * This class is used by the BlackBoardNetworkHandler to track interface changes and
  * send out notifications timely.
+ *
+ * Data changes are sent as set by the client with set_delivery(), either
+ * in full or delta encoded, and either on every change or at most once per
+ * a given interval. In the latter case only the latest data is sent, the
+ * handler must call flush() periodically to send data held back.
  * @author Tim Niemueller
  */
 
@@ -68,6 +76,15 @@ BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(Bla
 	fnh_        = hub;
 	clid_       = clid;
 
+	data_mutex_        = new Mutex();
+	encoder_           = new BlackBoardDataEncoder(interface->serial(), interface->datasize());
+	decoder_           = new BlackBoardDataDecoder(interface->serial(), interface->datasize());
+	min_interval_msec_ = 0;
+	pending_           = false;
+	last_sent_.set_time(0, 0);
+	received_data_.resize(interface->datasize());
+	memcpy(received_data_.data(), interface->datachunk(), interface->datasize());
+
 	blackboard_->register_listener(this);
 }
 
@@ -75,27 +92,123 @@ BlackBoardNetHandlerInterfaceListener::BlackBoardNetHandlerInterfaceListener(Bla
 BlackBoardNetHandlerInterfaceListener::~BlackBoardNetHandlerInterfaceListener()
 {
 	blackboard_->unregister_listener(this);
+	delete encoder_;
+	delete decoder_;
+	delete data_mutex_;
 }
 
+/** Set delivery policy.
+ * @param flags delivery flags, see blackboard_delivery_flags_t
+ * @param min_interval_msec minimum time between two data messages, 0 to send
+ * every change
+ */
 void
-BlackBoardNetHandlerInterfaceListener::bb_interface_data_changed(Interface *interface) throw()
+BlackBoardNetHandlerInterfaceListener::set_delivery(unsigned int flags,
+                                                    unsigned int min_interval_msec)
+{
+	MutexLocker lock(data_mutex_);
+	encoder_->set_delta(flags & BB_DELIVERY_DELTA);
+	min_interval_msec_ = min_interval_msec;
+}
+
+/** Send full data with the next data message.
+ * Called if the client requested it with MSG_BB_DATA_RESYNC.
+ */
+void
+BlackBoardNetHandlerInterfaceListener::resync()
+{
+	MutexLocker lock(data_mutex_);
+	encoder_->resync();
+}
+
+/** Send data held back due to the delivery interval.
+ * @return time in milliseconds after which flush() must be called again,
+ * 0 if there is no data held back
+ */
+unsigned int
+BlackBoardNetHandlerInterfaceListener::flush()
+{
+	MutexLocker lock(data_mutex_);
+	if (!pending_)
+		return 0;
+
+	Time now;
+	now.stamp_systime();
+	long elapsed_msec = (now - last_sent_).in_msec();
+	if ((elapsed_msec >= 0) && (elapsed_msec < (long)min_interval_msec_)) {
+		return min_interval_msec_ - elapsed_msec;
+	}
+	send_data();
+	return 0;
+}
+
+/** Process data received from the client.
+ * Decodes a MSG_BB_DATA_CHANGED or MSG_BB_DATA_DELTA message and writes the
+ * data to the interface. If the message cannot be decoded the client is
+ * asked to send the full data.
+ * @param msg message to process
+ */
+void
+BlackBoardNetHandlerInterfaceListener::process_data(FawkesNetworkMessage *msg)
 {
-	// send out data changed notification
-	interface->read();
+	MutexLocker lock(data_mutex_);
+	try {
+		decoder_->decode(msg, received_data_.data());
+	} catch (Exception &e) {
+		LibLogger::log_warn(bbil_name(), "Failed to decode data, requesting full data");
+		LibLogger::log_warn(bbil_name(), e);
+
+		bb_iserial_msg_t *sm = (bb_iserial_msg_t *)malloc(sizeof(bb_iserial_msg_t));
+		sm->serial           = htonl(interface_->serial());
+		try {
+			fnh_->send(clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_RESYNC, sm, sizeof(bb_iserial_msg_t));
+		} catch (Exception &e) {
+			LibLogger::log_warn(bbil_name(), "Failed to request full data, exception follows");
+			LibLogger::log_warn(bbil_name(), e);
+		}
+		return;
+	}
+
+	interface_->set_from_chunk(received_data_.data());
+	// writing notifies listeners, possibly including this one
+	lock.unlock();
+	interface_->write();
+}
 
-	size_t          payload_size = sizeof(bb_idata_msg_t) + interface->datasize();
-	void *          payload      = malloc(payload_size);
-	bb_idata_msg_t *dm           = (bb_idata_msg_t *)payload;
-	dm->serial                   = htonl(interface->serial());
-	dm->data_size                = htonl(interface->datasize());
-	memcpy((char *)payload + sizeof(bb_idata_msg_t), interface->datachunk(), interface->datasize());
+void
+BlackBoardNetHandlerInterfaceListener::send_data()
+{
+	// called with data_mutex_ locked
+	interface_->read();
 
 	try {
-		fnh_->send(clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_CHANGED, payload, payload_size);
+		unsigned short int           msgid;
+		FawkesNetworkMessageContent *content = encoder_->encode(interface_->datachunk(), msgid);
+		fnh_->send(clid_, FAWKES_CID_BLACKBOARD, msgid, content);
 	} catch (Exception &e) {
 		LibLogger::log_warn(bbil_name(), "Failed to send BlackBoard data, exception follows");
 		LibLogger::log_warn(bbil_name(), e);
 	}
+
+	last_sent_.stamp_systime();
+	pending_ = false;
+}
+
+void
+BlackBoardNetHandlerInterfaceListener::bb_interface_data_changed(Interface *interface) throw()
+{
+	// send out data changed notification, or hold it back until flushed
+	MutexLocker lock(data_mutex_);
+	if (min_interval_msec_ > 0) {
+		Time now;
+		now.stamp_systime();
+		long elapsed_msec = (now - last_sent_).in_msec();
+		if ((elapsed_msec >= 0) && (elapsed_msec < (long)min_interval_msec_)) {
+			pending_ = true;
+			return;
+		}
+	}
+	send_data();
 }
 
 bool
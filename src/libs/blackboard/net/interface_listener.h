@@ -25,11 +25,18 @@
 #define _BLACKBOARD_NET_INTERFACE_LISTENER_H_
 
 #include <blackboard/interface_listener.h>
+#include <utils/time/time.h>
+
+#include <vector>
 
 namespace fawkes {
 
 class FawkesNetworkHub;
+class FawkesNetworkMessage;
 class BlackBoard;
+class BlackBoardDataEncoder;
+class BlackBoardDataDecoder;
+class Mutex;
 
 class BlackBoardNetHandlerInterfaceListener : public BlackBoardInterfaceListener
 {
@@ -51,14 +58,28 @@ public:
 	virtual void bb_interface_reader_removed(Interface *  interface,
 	                                         unsigned int instance_serial) throw();
 
+	void         set_delivery(unsigned int flags, unsigned int min_interval_msec);
+	void         resync();
+	unsigned int flush();
+	void         process_data(FawkesNetworkMessage *msg);
+
 private:
 	void send_event_serial(Interface *interface, unsigned int msg_id, unsigned int event_serial);
+	void send_data();
 
 	BlackBoard *      blackboard_;
 	Interface *       interface_;
 	FawkesNetworkHub *fnh_;
 
 	unsigned int clid_;
+
+	Mutex *                data_mutex_;
+	BlackBoardDataEncoder *encoder_;
+	BlackBoardDataDecoder *decoder_;
+	std::vector<char>      received_data_;
+	unsigned int           min_interval_msec_;
+	bool                   pending_;
+	Time                   last_sent_;
 };
 
 } // end namespace fawkes
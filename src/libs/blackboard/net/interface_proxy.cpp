@@ -25,8 +25,11 @@
 #include <blackboard/internal/instance_factory.h>
 #include <blackboard/internal/interface_mem_header.h>
 #include <blackboard/internal/notifier.h>
+#include <blackboard/net/data_codec.h>
 #include <blackboard/net/interface_proxy.h>
 #include <blackboard/net/messages.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <core/threading/refc_rwlock.h>
 #include <logging/liblogger.h>
 #include <netcomm/fawkes/client.h>
@@ -41,6 +44,10 @@ namespace fawkes {
  * Interface proxy for remote BlackBoard.
  * This proxy is used internally by RemoteBlackBoard to interact with an interface
  * on the one side and the remote BlackBoard on the other side.
+ *
+ * Data written to the interface is sent delta encoded if the remote
+ * BlackBoard supports it. Received data is decoded transparently, no
+ * matter if it is sent in full or delta encoded.
  * @author Tim Niemueller
  */
 
@@ -80,6 +87,19 @@ BlackBoardInterfaceProxy::BlackBoardInterfaceProxy(FawkesNetworkClient * client,
 		throw Exception("Network message does not carry chunk of expected size");
 	}
 
+	// newer BlackBoards append their features after the data
+	features_ = 0;
+	if (msg->payload_size() >= sizeof(bb_iopensucc_msg_t) + data_size_ + sizeof(uint32_t)) {
+		uint32_t features;
+		memcpy(&features, (char *)payload + sizeof(bb_iopensucc_msg_t) + data_size_, sizeof(uint32_t));
+		features_ = ntohl(features);
+	}
+
+	encoder_mutex_ = new Mutex();
+	encoder_       = new BlackBoardDataEncoder(instance_serial_, data_size_);
+	decoder_       = new BlackBoardDataDecoder(instance_serial_, data_size_);
+	encoder_->set_delta(features_ & BB_FEATURE_DELTA);
+
 	rwlock_     = new RefCountRWLock();
 	mem_chunk_  = malloc(sizeof(interface_header_t) + data_size_);
 	data_chunk_ = (char *)mem_chunk_ + sizeof(interface_header_t);
@@ -96,7 +116,7 @@ BlackBoardInterfaceProxy::BlackBoardInterfaceProxy(FawkesNetworkClient * client,
 	ih->refcount           = 1;
 
 	interface->set_instance_serial(instance_serial_);
-	interface->set_memory(0, mem_chunk_, data_chunk_);
+	interface->set_memory(0, mem_chunk_, data_chunk_, &ih->data_seq);
 	interface->set_mediators(this, this);
 	interface->set_readwrite(writer, rwlock_);
 }
@@ -104,16 +124,21 @@ BlackBoardInterfaceProxy::BlackBoardInterfaceProxy(FawkesNetworkClient * client,
 /** Destructor. */
 BlackBoardInterfaceProxy::~BlackBoardInterfaceProxy()
 {
+	delete encoder_;
+	delete decoder_;
+	delete encoder_mutex_;
 	free(mem_chunk_);
 }
 
-/** Process MSG_BB_DATA_CHANGED message.
+/** Process MSG_BB_DATA_CHANGED or MSG_BB_DATA_DELTA message.
+ * If the data cannot be decoded the remote BlackBoard is asked to send the
+ * full data with the next message.
  * @param msg message to process.
  */
 void
 BlackBoardInterfaceProxy::process_data_changed(FawkesNetworkMessage *msg)
 {
-	if (msg->msgid() != MSG_BB_DATA_CHANGED) {
+	if ((msg->msgid() != MSG_BB_DATA_CHANGED) && (msg->msgid() != MSG_BB_DATA_DELTA)) {
 		LibLogger::log_error("BlackBoardInterfaceProxy",
 		                     "Expected data changed BB message, but "
 		                     "received message of type %u, ignoring.",
@@ -121,28 +146,35 @@ BlackBoardInterfaceProxy::process_data_changed(FawkesNetworkMessage *msg)
 		return;
 	}
 
-	void *          payload = msg->payload();
-	bb_idata_msg_t *dm      = (bb_idata_msg_t *)payload;
-	if (ntohl(dm->serial) != instance_serial_) {
-		LibLogger::log_error("BlackBoardInterfaceProxy",
-		                     "Serial mismatch, expected %u, "
-		                     "but got %u, ignoring.",
-		                     instance_serial_,
-		                     ntohl(dm->serial));
-		return;
-	}
+	interface_header_t *ih = (interface_header_t *)mem_chunk_;
 
-	if (ntohl(dm->data_size) != data_size_) {
+	bool decoded = true;
+	rwlock_->lock_for_write();
+	uint32_t seq = __atomic_load_n(&ih->data_seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&ih->data_seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	try {
+		// the decoder does not modify the data if it fails
+		decoder_->decode(msg, data_chunk_);
+	} catch (Exception &e) {
 		LibLogger::log_error("BlackBoardInterfaceProxy",
-		                     "Data size mismatch, expected %zu, "
-		                     "but got %zu, ignoring.",
-		                     data_size_,
-		                     ntohl(dm->data_size));
+		                     "Failed to decode data for %s, requesting full data",
+		                     interface_->uid());
+		LibLogger::log_error("BlackBoardInterfaceProxy", e);
+		decoded = false;
+	}
+	__atomic_store_n(&ih->data_seq, seq + 2, __ATOMIC_RELEASE);
+	rwlock_->unlock();
+
+	if (!decoded) {
+		bb_iserial_msg_t *sm = (bb_iserial_msg_t *)malloc(sizeof(bb_iserial_msg_t));
+		sm->serial           = htonl(instance_serial_);
+		FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
+		  clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_RESYNC, sm, sizeof(bb_iserial_msg_t));
+		fnc_->enqueue(omsg);
 		return;
 	}
 
-	memcpy(data_chunk_, (char *)payload + sizeof(bb_idata_msg_t), data_size_);
-
 	notifier_->notify_of_data_change(interface_);
 }
 
@@ -215,6 +247,48 @@ BlackBoardInterfaceProxy::process_interface_message(FawkesNetworkMessage *msg)
 	}
 }
 
+/** Send full data with the next write.
+ * Called if the remote BlackBoard requested it with MSG_BB_DATA_RESYNC.
+ */
+void
+BlackBoardInterfaceProxy::resync()
+{
+	MutexLocker lock(encoder_mutex_);
+	encoder_->resync();
+}
+
+/** Check if the remote BlackBoard supports delivery policies.
+ * @return true if set_delivery() can be used
+ */
+bool
+BlackBoardInterfaceProxy::supports_delivery() const
+{
+	return features_ & BB_FEATURE_DELTA;
+}
+
+/** Set delivery policy.
+ * Asks the remote BlackBoard to send data changes as given. Ignored if the
+ * remote BlackBoard does not support it.
+ * @param flags delivery flags, see blackboard_delivery_flags_t
+ * @param min_interval_msec minimum time between two data messages, 0 to
+ * receive every change
+ */
+void
+BlackBoardInterfaceProxy::set_delivery(unsigned int flags, unsigned int min_interval_msec)
+{
+	if (!supports_delivery())
+		return;
+
+	bb_idelivery_msg_t *dm = (bb_idelivery_msg_t *)malloc(sizeof(bb_idelivery_msg_t));
+	dm->serial             = htonl(instance_serial_);
+	dm->flags              = htonl(flags);
+	dm->min_interval_msec  = htonl(min_interval_msec);
+
+	FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
+	  clid_, FAWKES_CID_BLACKBOARD, MSG_BB_SET_DELIVERY, dm, sizeof(bb_idelivery_msg_t));
+	fnc_->enqueue(omsg);
+}
+
 /** Reader has been added.
  * @param event_serial instance serial of the interface that caused the event
  */
@@ -313,15 +387,13 @@ void
 BlackBoardInterfaceProxy::notify_of_data_change(const Interface *interface)
 {
 	// need to send write message
-	size_t          payload_size = sizeof(bb_idata_msg_t) + interface->datasize();
-	void *          payload      = malloc(payload_size);
-	bb_idata_msg_t *dm           = (bb_idata_msg_t *)payload;
-	dm->serial                   = htonl(interface->serial());
-	dm->data_size                = htonl(interface->datasize());
-	memcpy((char *)payload + sizeof(bb_idata_msg_t), interface->datachunk(), interface->datasize());
+	MutexLocker                  lock(encoder_mutex_);
+	unsigned short int           msgid;
+	FawkesNetworkMessageContent *content = encoder_->encode(interface->datachunk(), msgid);
+	lock.unlock();
 
-	FawkesNetworkMessage *omsg = new FawkesNetworkMessage(
-	  clid_, FAWKES_CID_BLACKBOARD, MSG_BB_DATA_CHANGED, payload, payload_size);
+	FawkesNetworkMessage *omsg =
+	  new FawkesNetworkMessage(clid_, FAWKES_CID_BLACKBOARD, msgid, content);
 	fnc_->enqueue(omsg);
 }
 
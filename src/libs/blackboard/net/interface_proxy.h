@@ -35,7 +35,10 @@ class FawkesNetworkClient;
 class FawkesNetworkMessage;
 class RefCountRWLock;
 class BlackBoardNotifier;
+class BlackBoardDataEncoder;
+class BlackBoardDataDecoder;
 class Interface;
+class Mutex;
 
 class BlackBoardInterfaceProxy : public InterfaceMediator, public MessageMediator
 {
@@ -49,6 +52,9 @@ public:
 
 	void process_data_changed(FawkesNetworkMessage *msg);
 	void process_interface_message(FawkesNetworkMessage *msg);
+	void resync();
+	bool supports_delivery() const;
+	void set_delivery(unsigned int flags, unsigned int min_interval_msec);
 	void reader_added(unsigned int event_serial);
 	void reader_removed(unsigned int event_serial);
 	void writer_added(unsigned int event_serial);
@@ -86,6 +92,11 @@ private:
 	void * data_chunk_;
 	size_t data_size_;
 
+	Mutex *                encoder_mutex_;
+	BlackBoardDataEncoder *encoder_;
+	BlackBoardDataDecoder *decoder_;
+	unsigned int           features_;
+
 	unsigned short instance_serial_;
 	unsigned short next_msg_id_;
 	unsigned int   num_readers_;
@@ -51,9 +51,23 @@ typedef enum {
 	MSG_BB_WRITER_REMOVED      = 13,
 	MSG_BB_INTERFACE_CREATED   = 14,
 	MSG_BB_INTERFACE_DESTROYED = 15,
-	MSG_BB_LIST                = 16
+	MSG_BB_LIST                = 16,
+	MSG_BB_DATA_DELTA          = 17,
+	MSG_BB_SET_DELIVERY        = 18,
+	MSG_BB_DATA_RESYNC         = 19
 } blackboard_msgid_t;
 
+/** Features of the remote end, sent after the data of MSG_BB_OPEN_SUCCESS. */
+typedef enum {
+	BB_FEATURE_DELTA = 1 /**< MSG_BB_DATA_DELTA, MSG_BB_SET_DELIVERY, and
+			      * MSG_BB_DATA_RESYNC are supported */
+} blackboard_features_t;
+
+/** Delivery flags, used in bb_idelivery_msg_t. */
+typedef enum {
+	BB_DELIVERY_DELTA = 1 /**< Send MSG_BB_DATA_DELTA instead of MSG_BB_DATA_CHANGED */
+} blackboard_delivery_flags_t;
+
 /** Error codes */
 typedef enum {
 	BB_ERR_UNKNOWN_ERR,   /**< Unknown error occured. Check log. */
@@ -112,8 +126,8 @@ typedef struct
 } bb_ievent_msg_t;
 
 /** Message to identify an interface instance.
- * This message is used for MSG_BB_CLOSE, MSG_BB_READER_ADDED, MSG_BB_READER_REMOVED,
- * MSG_BB_WRITER_ADDED, and MSG_BB_READER_REMOVED.
+ * This message is used for MSG_BB_CLOSE, MSG_BB_DATA_RESYNC, MSG_BB_READER_ADDED,
+ * MSG_BB_READER_REMOVED, MSG_BB_WRITER_ADDED, and MSG_BB_READER_REMOVED.
  */
 typedef struct
 {
@@ -136,6 +150,8 @@ typedef struct
  * BlackBoard.
  * This message struct is always followed by a data chunk that is of the
  * size data_size. It contains the current content of the interface.
+ * Newer BlackBoards append a 32 bit big endian number with the
+ * blackboard_features_t they support after the data chunk.
  */
 typedef struct
 {
@@ -166,6 +182,39 @@ typedef struct
 	uint32_t data_size; /**< size in bytes of the following data. */
 } bb_idata_msg_t;
 
+/** Interface delta data message.
+ * Sent instead of MSG_BB_DATA_CHANGED in both directions once the receiver
+ * asked for delta encoding with MSG_BB_SET_DELIVERY, respectively the
+ * BlackBoard supports it. This struct is followed by a chunk of delta_size
+ * bytes. If base_seq is zero it is the full data, otherwise it is the XOR
+ * of the data and the data of version base_seq, run length encoded as
+ * records of a number of unchanged bytes, a number of changed bytes, both
+ * LEB128 encoded, and the changed bytes. If the receiver does not have the
+ * version base_seq it replies with MSG_BB_DATA_RESYNC and the sender sends
+ * the full data next.
+ */
+typedef struct
+{
+	uint32_t serial;     /**< instance serial to unique identify this instance */
+	uint32_t data_size;  /**< size in bytes of the decoded data */
+	uint32_t seq;        /**< version of the data, never zero */
+	uint32_t base_seq;   /**< version the delta is relative to, 0 for full data */
+	uint32_t delta_size; /**< size in bytes of the following chunk */
+} bb_idelta_msg_t;
+
+/** Interface delivery policy message.
+ * Sent as MSG_BB_SET_DELIVERY to the BlackBoard to choose how data changes
+ * of an interface are sent to the client.
+ */
+typedef struct
+{
+	uint32_t serial;            /**< instance serial to unique identify this instance */
+	uint32_t flags;             /**< delivery flags, see blackboard_delivery_flags_t */
+	uint32_t min_interval_msec; /**< minimum time between two data messages, only
+				     * the latest data is sent if the interface is
+				     * written more often, 0 to send every change */
+} bb_idelivery_msg_t;
+
 /** Interface message.
  * This type is used to transport interface messages. This struct is always followed
  * by a data chunk of the size data_size that transports the message data.
@@ -0,0 +1,158 @@
+
+/***************************************************************************
+ *  qa_bb_delta.cpp - BlackBoard network data delta encoding QA
+ *
+ *  Created: Fri Oct 16 17:36:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <arpa/inet.h>
+#include <blackboard/net/data_codec.h>
+#include <blackboard/net/messages.h>
+#include <core/exception.h>
+#include <netcomm/fawkes/component_ids.h>
+#include <netcomm/fawkes/message.h>
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace fawkes;
+
+#define SERIAL 42
+// size of a Laser1080Interface
+#define DATA_SIZE (1080 * 4 * 2 + 40)
+#define NUM_UPDATES 1000
+
+static FawkesNetworkMessage *
+encode(BlackBoardDataEncoder &encoder, const std::vector<unsigned char> &data)
+{
+	unsigned short int           msgid;
+	FawkesNetworkMessageContent *content = encoder.encode(data.data(), msgid);
+	FawkesNetworkMessage *msg = new FawkesNetworkMessage(0, FAWKES_CID_BLACKBOARD, msgid, content);
+	msg->pack();
+	return msg;
+}
+
+int
+main(int argc, char **argv)
+{
+	std::mt19937                       gen(42);
+	std::vector<unsigned char>         data(DATA_SIZE), received(DATA_SIZE);
+	BlackBoardDataEncoder              encoder(SERIAL, DATA_SIZE);
+	BlackBoardDataDecoder              decoder(SERIAL, DATA_SIZE);
+	std::uniform_int_distribution<int> byte(0, 255);
+	unsigned int                       failures = 0;
+
+	for (unsigned char &c : data) {
+		c = byte(gen);
+	}
+
+	// full data without delta encoding
+	FawkesNetworkMessage *msg = encode(encoder, data);
+	decoder.decode(msg, received.data());
+	if ((msg->msgid() != MSG_BB_DATA_CHANGED) || (received != data)) {
+		printf("FAIL: full data not decoded correctly\n");
+		++failures;
+	}
+	msg->unref();
+
+	// delta encoded, some values change per update like in a laser scan
+	encoder.set_delta(true);
+	size_t full_bytes = 0, delta_bytes = 0;
+	for (unsigned int i = 0; i < NUM_UPDATES; ++i) {
+		unsigned int num_changes = gen() % (i % 10 == 0 ? DATA_SIZE : 64);
+		for (unsigned int c = 0; c < num_changes; ++c) {
+			data[gen() % DATA_SIZE] = byte(gen);
+		}
+
+		msg = encode(encoder, data);
+		try {
+			decoder.decode(msg, received.data());
+		} catch (Exception &e) {
+			e.print_trace();
+		}
+		if ((msg->msgid() != MSG_BB_DATA_DELTA) || (received != data)) {
+			printf("FAIL: delta %u not decoded correctly\n", i);
+			++failures;
+		}
+		full_bytes += sizeof(bb_idata_msg_t) + DATA_SIZE;
+		delta_bytes += msg->payload_size();
+		msg->unref();
+	}
+	printf("%u updates, %zu bytes full, %zu bytes delta encoded (%.1f%%)\n",
+	       NUM_UPDATES,
+	       full_bytes,
+	       delta_bytes,
+	       100. * delta_bytes / full_bytes);
+
+	// a lost update must be detected and leave the data untouched
+	data[0] ^= 0xFF;
+	encode(encoder, data)->unref();
+	data[1] ^= 0xFF;
+	msg                                 = encode(encoder, data);
+	std::vector<unsigned char> previous = received;
+	try {
+		decoder.decode(msg, received.data());
+		printf("FAIL: delta to unknown version accepted\n");
+		++failures;
+	} catch (Exception &e) {
+		if (received != previous) {
+			printf("FAIL: data modified by failed decoding\n");
+			++failures;
+		}
+	}
+	msg->unref();
+
+	// after resync the full data is sent
+	encoder.resync();
+	msg = encode(encoder, data);
+	decoder.decode(msg, received.data());
+	if (received != data) {
+		printf("FAIL: data not decoded correctly after resync\n");
+		++failures;
+	}
+	msg->unref();
+
+	// malformed deltas must be rejected
+	data[DATA_SIZE - 1] ^= 0xFF;
+	msg                    = encode(encoder, data);
+	bb_idelta_msg_t *dm    = (bb_idelta_msg_t *)msg->payload();
+	unsigned char *  chunk = (unsigned char *)msg->payload() + sizeof(bb_idelta_msg_t);
+	chunk[0]               = 0xFF;
+	previous               = received;
+	try {
+		decoder.decode(msg, received.data());
+		printf("FAIL: malformed delta of %u bytes accepted\n", ntohl(dm->delta_size));
+		++failures;
+	} catch (Exception &e) {
+		if (received != previous) {
+			printf("FAIL: data modified by malformed delta\n");
+			++failures;
+		}
+	}
+	msg->unref();
+
+	printf("%s\n", failures ? "FAILED" : "OK");
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -0,0 +1,279 @@
+/***************************************************************************
+ *  qa_bb_dispatch.cpp - BlackBoard asynchronous event dispatching QA
+ *
+ *  Created: Fri Oct 16 23:11:20 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/interface_listener.h>
+#include <blackboard/internal/event_dispatcher.h>
+#include <interface/message.h>
+
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_PRODUCERS 4
+#define NUM_EVENTS 20000
+#define NUM_DISPATCH_THREADS 2
+
+// the events only carry the interface pointer, it is never dereferenced
+static char fake_interfaces[NUM_PRODUCERS];
+
+static Interface *
+iface(unsigned int p)
+{
+	return (Interface *)&fake_interfaces[p];
+}
+
+class QaListener : public BlackBoardInterfaceListener
+{
+public:
+	QaListener(const std::map<Message *, unsigned int> &msg_index)
+	: BlackBoardInterfaceListener("QaListener"), msg_index_(msg_index)
+	{
+		data_events = 0;
+		msg_events  = 0;
+		order_ok    = true;
+		in_callback = 0;
+		overlap     = false;
+		for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+			last_[p] = -1;
+		}
+	}
+
+	virtual void
+	bb_interface_data_changed(Interface *interface) throw()
+	{
+		enter();
+		data_events += 1;
+		leave();
+	}
+
+	virtual bool
+	bb_interface_message_received(Interface *interface, Message *message) throw()
+	{
+		enter();
+		unsigned int p = (char *)interface - fake_interfaces;
+		int          i = msg_index_.at(message);
+		if (i <= last_[p])
+			order_ok = false;
+		last_[p] = i;
+		msg_events += 1;
+		leave();
+		return true;
+	}
+
+	unsigned int
+	dropped() const
+	{
+		return bbil_dropped_events();
+	}
+
+	std::atomic<unsigned int> data_events;
+	std::atomic<unsigned int> msg_events;
+	std::atomic<bool>         order_ok;
+	std::atomic<bool>         overlap;
+
+private:
+	void
+	enter()
+	{
+		// events of one listener must never be delivered concurrently
+		if (++in_callback != 1)
+			overlap = true;
+	}
+
+	void
+	leave()
+	{
+		--in_callback;
+	}
+
+	const std::map<Message *, unsigned int> &msg_index_;
+	std::atomic<int>                         in_callback;
+	int                                      last_[NUM_PRODUCERS];
+};
+
+/** Listener which shuts down its queue from within its callback,
+ * as done when unregistering the listener in the callback. */
+class SelfShutdownListener : public BlackBoardInterfaceListener
+{
+public:
+	SelfShutdownListener() : BlackBoardInterfaceListener("SelfShutdownListener")
+	{
+		queue       = NULL;
+		data_events = 0;
+		returned    = 0;
+	}
+
+	virtual void
+	bb_interface_data_changed(Interface *interface) throw()
+	{
+		data_events += 1;
+		queue->shutdown();
+		returned += 1;
+	}
+
+	BlackBoardListenerEventQueue *queue;
+	std::atomic<unsigned int>     data_events;
+	std::atomic<unsigned int>     returned;
+};
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static void
+push(BlackBoardEventDispatcher &d, BlackBoardListenerEventQueue *q, Interface *i, Message *m)
+{
+	// like the notifier, hold a reference until the queue has been scheduled
+	q->ref();
+	if (m ? q->push_message(i, m) : q->push_data(i)) {
+		if (q->try_schedule())
+			d.schedule(q);
+	}
+	q->unref();
+}
+
+static bool
+wait_for(const std::atomic<unsigned int> &value, unsigned int expected)
+{
+	for (unsigned int i = 0; i < 1000 && value < expected; ++i) {
+		usleep(10000);
+	}
+	return value == expected;
+}
+
+int
+main(int argc, char **argv)
+{
+	int                               failures = 0;
+	BlackBoardEventDispatcher         dispatcher(NUM_DISPATCH_THREADS);
+	std::map<Message *, unsigned int> msg_index;
+	std::vector<Message *>            messages[NUM_PRODUCERS];
+
+	for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+		for (unsigned int i = 0; i < NUM_EVENTS; ++i) {
+			Message *m = new Message("QaMessage");
+			messages[p].push_back(m);
+			msg_index[m] = i;
+		}
+	}
+
+	// multiple producers, every message is delivered or counted as dropped,
+	// messages of one producer are delivered in order
+	QaListener                    l(msg_index);
+	BlackBoardListenerEventQueue *q =
+	  new BlackBoardListenerEventQueue(&l, /* coalesce */ false, NUM_PRODUCERS * NUM_EVENTS / 4);
+	std::vector<std::thread> threads;
+	for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+		threads.push_back(std::thread([&dispatcher, q, &messages, p]() {
+			for (Message *m : messages[p]) {
+				push(dispatcher, q, iface(p), m);
+			}
+		}));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+	threads.clear();
+	bool ok = wait_for(l.msg_events, NUM_PRODUCERS * NUM_EVENTS - l.dropped());
+	failures += check(ok, "Concurrent message events delivered or dropped");
+	failures += check(l.order_ok, "Per producer message order");
+	failures += check(!l.overlap, "Listener never called concurrently");
+
+	bool refs_ok = true;
+	for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+		for (Message *m : messages[p]) {
+			refs_ok = refs_ok && (m->refcount() == 1);
+		}
+	}
+	failures += check(refs_ok, "Message references released");
+
+	// coalescing, at most one data event per interface is pending
+	QaListener                    cl(msg_index);
+	BlackBoardListenerEventQueue *cq = new BlackBoardListenerEventQueue(&cl, /* coalesce */ true, 64);
+	for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+		cq->add_data_interface(iface(p));
+	}
+	for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+		threads.push_back(std::thread([&dispatcher, cq, p]() {
+			for (unsigned int i = 0; i < NUM_EVENTS; ++i) {
+				push(dispatcher, cq, iface(p), NULL);
+			}
+		}));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+	threads.clear();
+	usleep(100000);
+	unsigned int coalesced = cl.data_events;
+	failures += check(coalesced >= 1 && coalesced <= NUM_PRODUCERS * NUM_EVENTS && cl.dropped() == 0,
+	                  "Coalesced data events without drops");
+	push(dispatcher, cq, iface(0), NULL);
+	failures += check(wait_for(cl.data_events, coalesced + 1), "Data event after coalescing");
+
+	// after shutdown the listener is never called again
+	cq->shutdown();
+	push(dispatcher, cq, iface(0), NULL);
+	usleep(100000);
+	failures += check(cl.data_events == coalesced + 1, "No events after shutdown");
+
+	// shutdown from within the callback must not deadlock the dispatcher,
+	// events still queued behind the current one are discarded
+	SelfShutdownListener sl;
+	sl.queue = new BlackBoardListenerEventQueue(&sl, /* coalesce */ false, 64);
+	for (unsigned int i = 0; i < 10; ++i) {
+		sl.queue->push_data(iface(0));
+	}
+	if (sl.queue->try_schedule())
+		dispatcher.schedule(sl.queue);
+	ok = wait_for(sl.returned, 1);
+	usleep(100000);
+	failures += check(ok && sl.data_events == 1 && sl.queue->is_shutdown(),
+	                  "Shutdown from within callback");
+	push(dispatcher, q, iface(0), NULL);
+	failures += check(wait_for(l.data_events, 1), "Dispatcher alive after shutdown from callback");
+	sl.queue->unref();
+
+	q->shutdown();
+	q->unref();
+	cq->unref();
+
+	for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+		for (Message *m : messages[p]) {
+			m->unref();
+		}
+	}
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
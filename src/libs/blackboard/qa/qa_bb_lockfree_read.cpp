@@ -0,0 +1,129 @@
+/***************************************************************************
+ *  qa_bb_lockfree_read.cpp - BlackBoard lock-free interface reading QA
+ *
+ *  Created: Fri Oct 16 23:31:05 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/bbconfig.h>
+#include <blackboard/local.h>
+#include <core/exception.h>
+#include <interfaces/TestInterface.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_WRITES 200000
+#define NUM_READERS 4
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+int
+main(int argc, char **argv)
+{
+	int               failures = 0;
+	BlackBoard *      bb       = new LocalBlackBoard(BLACKBOARD_MEMSIZE);
+	TestInterface *   writer   = NULL;
+	std::atomic<bool> done(false);
+
+	std::vector<TestInterface *> readers;
+	try {
+		writer = bb->open_for_writing<TestInterface>("LockFreeRead");
+		for (unsigned int i = 0; i < NUM_READERS; ++i) {
+			readers.push_back(bb->open_for_reading<TestInterface>("LockFreeRead"));
+		}
+	} catch (Exception &e) {
+		e.print_trace();
+		return 1;
+	}
+
+	failures += check(!readers[0]->is_lockfree_read(), "Lock-free reading disabled by default");
+
+	// half of the readers opt in, the others keep using the lock
+	for (unsigned int i = 0; i < NUM_READERS; i += 2) {
+		readers[i]->set_lockfree_read(true);
+	}
+	failures += check(readers[0]->is_lockfree_read() && !readers[1]->is_lockfree_read(),
+	                  "Lock-free reading enabled per reader");
+
+	// the writer keeps all fields consistent to each other, a reader
+	// must never see a partially written update
+	std::vector<std::thread>       threads;
+	std::vector<std::atomic<bool>> consistent(NUM_READERS);
+	std::vector<unsigned int>      num_reads(NUM_READERS, 0);
+	for (unsigned int r = 0; r < NUM_READERS; ++r) {
+		consistent[r] = true;
+		threads.push_back(std::thread([&readers, &done, &consistent, &num_reads, r]() {
+			TestInterface *ti   = readers[r];
+			int            last = 0;
+			while (!done) {
+				ti->read();
+				int v = ti->test_int();
+				if ((ti->test_uint() != (unsigned int)v) || (ti->result() != -v) || (v < last)) {
+					consistent[r] = false;
+				}
+				last = v;
+				num_reads[r] += 1;
+			}
+		}));
+	}
+
+	for (int i = 1; i <= NUM_WRITES; ++i) {
+		writer->set_test_int(i);
+		writer->set_test_uint(i);
+		writer->set_result(-i);
+		writer->write();
+	}
+	done = true;
+	for (std::thread &t : threads) {
+		t.join();
+	}
+
+	bool ok = true;
+	for (unsigned int r = 0; r < NUM_READERS; ++r) {
+		ok = ok && consistent[r];
+		readers[r]->read();
+		ok = ok && (readers[r]->test_int() == NUM_WRITES);
+		printf("Reader %u (%s): %u reads\n",
+		       r,
+		       readers[r]->is_lockfree_read() ? "lock-free" : "locking",
+		       num_reads[r]);
+	}
+	failures += check(ok, "Consistent reads during concurrent writes");
+
+	for (TestInterface *ti : readers) {
+		bb->close(ti);
+	}
+	bb->close(writer);
+	delete bb;
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
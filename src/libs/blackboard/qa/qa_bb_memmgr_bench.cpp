@@ -0,0 +1,144 @@
+/***************************************************************************
+ *  qa_bb_memmgr_bench.cpp - BlackBoard memory manager benchmark
+ *
+ *  Created: Fri Oct 16 18:41:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <blackboard/bbconfig.h>
+#include <blackboard/exceptions.h>
+#include <blackboard/internal/memory_manager.h>
+#include <core/exceptions/system.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace fawkes;
+
+#define NUM_CHUNKS 10000
+#define NUM_CHURN_ROUNDS 20
+#define MIN_CHUNK_SIZE 32
+#define MAX_CHUNK_SIZE 2048
+#define BENCH_MEMORY_SIZE 32 * 1024 * 1024
+
+static unsigned int
+random_size()
+{
+	return MIN_CHUNK_SIZE + (rand() % (MAX_CHUNK_SIZE - MIN_CHUNK_SIZE));
+}
+
+static void
+print_result(const char *what, unsigned int ops, double sec)
+{
+	printf("%-28s %8u ops in %8.4f sec, %10.1f ns/op\n", what, ops, sec, sec * 1.e9 / ops);
+}
+
+static void
+run_benchmark(BlackBoardMemoryManager *mm)
+{
+	vector<void *> ptrs(NUM_CHUNKS);
+	mt19937        rng(0);
+
+	Time start, end;
+
+	// Fill memory with many chunks, this is what happens when many
+	// interfaces are opened during plugin initialization
+	start.stamp();
+	for (unsigned int i = 0; i < NUM_CHUNKS; ++i) {
+		ptrs[i] = mm->alloc(random_size());
+	}
+	end.stamp();
+	print_result("alloc", NUM_CHUNKS, end - &start);
+	mm->print_performance_info();
+
+	// Free and re-allocate random chunks, fragments memory and keeps
+	// the number of chunks high
+	unsigned int churn_ops = 0;
+	start.stamp();
+	for (unsigned int r = 0; r < NUM_CHURN_ROUNDS; ++r) {
+		shuffle(ptrs.begin(), ptrs.end(), rng);
+		for (unsigned int i = 0; i < NUM_CHUNKS / 2; ++i) {
+			mm->free(ptrs[i]);
+		}
+		for (unsigned int i = 0; i < NUM_CHUNKS / 2; ++i) {
+			ptrs[i] = mm->alloc(random_size());
+		}
+		churn_ops += NUM_CHUNKS;
+	}
+	end.stamp();
+	print_result("churn (free+alloc)", churn_ops, end - &start);
+	mm->print_performance_info();
+
+	try {
+		mm->check();
+	} catch (BBInconsistentMemoryException &e) {
+		printf("Inconsistent memory after churn\n");
+		e.print_trace();
+	}
+
+	// Free everything in random order, must merge back to one chunk
+	shuffle(ptrs.begin(), ptrs.end(), rng);
+	start.stamp();
+	for (unsigned int i = 0; i < NUM_CHUNKS; ++i) {
+		mm->free(ptrs[i]);
+	}
+	end.stamp();
+	print_result("free", NUM_CHUNKS, end - &start);
+	mm->print_performance_info();
+
+	if (mm->num_free_chunks() != 1 || mm->num_allocated_chunks() != 0) {
+		printf("Memory has not been merged to a single free chunk\n");
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	srand(0);
+
+	printf("Heap memory manager, %u chunks\n", NUM_CHUNKS);
+	printf("=========================================================================\n");
+	BlackBoardMemoryManager *mm = new BlackBoardMemoryManager(BENCH_MEMORY_SIZE);
+	run_benchmark(mm);
+	delete mm;
+
+	printf("\nShared memory manager, %u chunks\n", NUM_CHUNKS);
+	printf("=========================================================================\n");
+	try {
+		mm = new BlackBoardMemoryManager(BENCH_MEMORY_SIZE,
+		                                 BLACKBOARD_VERSION,
+		                                 /* master */ true,
+		                                 "FawkesBBMemMgrBenchQA");
+		run_benchmark(mm);
+		delete mm;
+	} catch (Exception &e) {
+		printf("Shared memory benchmark failed\n");
+		e.print_trace();
+	}
+
+	return 0;
+}
+
+/// @endcond
@@ -220,6 +220,7 @@ RemoteBlackBoard::open_interface(const char *type,
 		BlackBoardInterfaceProxy *proxy =
 		  new BlackBoardInterfaceProxy(fnc_, m_, notifier_, iface, writer);
 		proxies_[proxy->serial()] = proxy;
+		apply_delivery_policy(iface);
 	} else if (m_->msgid() == MSG_BB_OPEN_FAILURE) {
 		bb_iopenfail_msg_t *fm    = m_->msg<bb_iopenfail_msg_t>();
 		unsigned int        error = ntohl(fm->error_code);
@@ -312,6 +313,56 @@ RemoteBlackBoard::open_multiple_for_reading(const char *type_pattern,
 	return rv;
 }
 
+/** Set delivery policy of an interface.
+ * By default data changes of interfaces are delta encoded, i.e. only the
+ * bytes which changed since the last data message are sent, and every
+ * change is sent. For large interfaces which are written often, for example
+ * laser scans which are only displayed, the remote BlackBoard can send only
+ * the latest data at a lower rate. The policy is retained if the interface
+ * is re-opened after the connection died. It is ignored if the remote
+ * BlackBoard does not support it.
+ * @param interface interface opened with this BlackBoard
+ * @param min_interval_msec minimum time in milliseconds between two data
+ * messages, if the interface is written more often only the latest data is
+ * sent, 0 to receive every change
+ * @param delta true to receive delta encoded data, false to receive full
+ * data with every change
+ */
+void
+RemoteBlackBoard::set_delivery_policy(Interface *  interface,
+                                      unsigned int min_interval_msec,
+                                      bool         delta)
+{
+	if (proxies_.find(interface->serial()) == proxies_.end()) {
+		throw Exception("Interface %s has not been opened with this BlackBoard", interface->uid());
+	}
+
+	mutex_->lock();
+	DeliveryPolicy &policy   = delivery_policies_[interface];
+	policy.min_interval_msec = min_interval_msec;
+	policy.delta             = delta;
+	mutex_->unlock();
+
+	apply_delivery_policy(interface);
+}
+
+void
+RemoteBlackBoard::apply_delivery_policy(Interface *interface)
+{
+	DeliveryPolicy policy = {0, true};
+	mutex_->lock();
+	if (delivery_policies_.find(interface) != delivery_policies_.end()) {
+		policy = delivery_policies_[interface];
+	}
+	mutex_->unlock();
+
+	// may be called while re-opening interfaces with proxies_ locked
+	if (proxies_.find(interface->serial()) != proxies_.end()) {
+		proxies_[interface->serial()]->set_delivery(policy.delta ? BB_DELIVERY_DELTA : 0,
+		                                            policy.min_interval_msec);
+	}
+}
+
 /** Close interface.
  * @param interface interface to close
  */
@@ -327,6 +378,9 @@ RemoteBlackBoard::close(Interface *interface)
 		delete proxies_[serial];
 		proxies_.erase(serial);
 	}
+	mutex_->lock();
+	delivery_policies_.erase(interface);
+	mutex_->unlock();
 
 	if (fnc_->connected()) {
 		// We cannot "officially" close it, if we are disconnected it cannot be used anyway
@@ -458,11 +512,16 @@ RemoteBlackBoard::inbound_received(FawkesNetworkMessage *m, unsigned int id) thr
 	if (m->cid() == FAWKES_CID_BLACKBOARD) {
 		unsigned int msgid = m->msgid();
 		try {
-			if (msgid == MSG_BB_DATA_CHANGED) {
+			if ((msgid == MSG_BB_DATA_CHANGED) || (msgid == MSG_BB_DATA_DELTA)) {
 				unsigned int serial = ntohl(((unsigned int *)m->payload())[0]);
 				if (proxies_.find(serial) != proxies_.end()) {
 					proxies_[serial]->process_data_changed(m);
 				}
+			} else if (msgid == MSG_BB_DATA_RESYNC) {
+				bb_iserial_msg_t *sm = m->msg<bb_iserial_msg_t>();
+				if (proxies_.find(ntohl(sm->serial)) != proxies_.end()) {
+					proxies_[ntohl(sm->serial)]->resync();
+				}
 			} else if (msgid == MSG_BB_INTERFACE_MESSAGE) {
 				unsigned int serial = ntohl(((unsigned int *)m->payload())[0]);
 				if (proxies_.find(serial) != proxies_.end()) {
@@ -29,6 +29,7 @@
 #include <netcomm/fawkes/client_handler.h>
 
 #include <list>
+#include <map>
 
 namespace fawkes {
 
@@ -74,6 +75,7 @@ public:
 	virtual void connection_established(unsigned int id) throw();
 
 	/* extensions for RemoteBlackBoard */
+	void set_delivery_policy(Interface *interface, unsigned int min_interval_msec, bool delta = true);
 
 private: /* methods */
 	void open_interface(const char *type,
@@ -84,6 +86,7 @@ private: /* methods */
 	Interface *
 	     open_interface(const char *type, const char *identifier, const char *owner, bool writer);
 	void reopen_interfaces();
+	void apply_delivery_policy(Interface *interface);
 
 private: /* members */
 	Mutex *                                                     mutex_;
@@ -96,6 +99,15 @@ private: /* members */
 	std::list<BlackBoardInterfaceProxy *>                       invalid_proxies_;
 	std::list<BlackBoardInterfaceProxy *>::iterator             ipit_;
 
+	/// @cond INTERNALS
+	typedef struct
+	{
+		unsigned int min_interval_msec;
+		bool         delta;
+	} DeliveryPolicy;
+	/// @endcond
+	std::map<Interface *, DeliveryPolicy> delivery_policies_;
+
 	Mutex *        wait_mutex_;
 	WaitCondition *wait_cond_;
 
@@ -32,9 +32,9 @@ namespace fawkes {
  * BlackBoard Shared Memory Header.
  * This class is used identify BlackBoard shared memory headers and
  * to interact with the management data in the shared memory segment.
- * The basic options stored in the header is a version identifier
- * and pointers to the list heads of the free and allocated chunk
- * lists.
+ * The basic options stored in the header is a version identifier,
+ * the segregated free chunk lists and the head of the allocated chunk
+ * list.
  *
  * @author Tim Niemueller
  * @see SharedMemoryHeader
@@ -147,8 +147,11 @@ BlackBoardSharedMemoryHeader::initialize(void *memptr)
 	data                  = (BlackBoardSharedMemoryHeaderData *)memptr;
 	data->version         = _version;
 	data->shm_addr        = memptr;
-	data->free_list_head  = NULL;
+	data->free_bins.map   = 0;
 	data->alloc_list_head = NULL;
+	for (unsigned int i = 0; i < BBMM_NUM_SIZE_CLASSES; ++i) {
+		data->free_bins.heads[i] = NULL;
+	}
 }
 
 /** Set data of this header
@@ -177,14 +180,15 @@ BlackBoardSharedMemoryHeader::data_size()
 	return _data_size;
 }
 
-/** Get the head of the free chunks list.
- * @return pointer to the free list head, local pointer, already transformed,
- * you can use this without further conversion.
+/** Get the segregated free chunks lists.
+ * @return pointer to the free lists structure in the shared memory segment.
+ * Note that the list heads stored therein are shared memory addresses that
+ * must be transformed before use.
  */
-chunk_list_t *
-BlackBoardSharedMemoryHeader::free_list_head()
+chunk_free_bins_t *
+BlackBoardSharedMemoryHeader::free_bins()
 {
-	return (chunk_list_t *)shmem->ptr(data->free_list_head);
+	return &data->free_bins;
 }
 
 /** Get the head of the allocated chunks list.
@@ -197,16 +201,6 @@ BlackBoardSharedMemoryHeader::alloc_list_head()
 	return (chunk_list_t *)shmem->ptr(data->alloc_list_head);
 }
 
-/** Set the head of the free chunks list.
- * @param flh pointer to the new free list head, must be a pointer to the local
- * shared memory segment. Will be transformed to a shared memory address.
- */
-void
-BlackBoardSharedMemoryHeader::set_free_list_head(chunk_list_t *flh)
-{
-	data->free_list_head = (chunk_list_t *)shmem->addr(flh);
-}
-
 /** Set the head of the allocated chunks list.
  * @param alh pointer to the new allocated list head, must be a pointer to the local
  * shared memory segment. Will be transformed to a shared memory address.
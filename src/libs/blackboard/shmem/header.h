@@ -38,10 +38,10 @@ private:
    */
 	typedef struct
 	{
-		unsigned int  version;         /**< version of the BB */
-		void *        shm_addr;        /**< base addr of shared memory */
-		chunk_list_t *free_list_head;  /**< offset of the free chunks list head */
-		chunk_list_t *alloc_list_head; /**< offset of the allocated chunks list head */
+		unsigned int      version;         /**< version of the BB */
+		void *            shm_addr;        /**< base addr of shared memory */
+		chunk_free_bins_t free_bins;       /**< segregated free chunks lists */
+		chunk_list_t *    alloc_list_head; /**< offset of the allocated chunks list head */
 	} BlackBoardSharedMemoryHeaderData;
 
 public:
@@ -58,9 +58,8 @@ public:
 	virtual size_t              data_size();
 	virtual SharedMemoryHeader *clone() const;
 	virtual bool                operator==(const fawkes::SharedMemoryHeader &s) const;
-	chunk_list_t *              free_list_head();
+	chunk_free_bins_t *         free_bins();
 	chunk_list_t *              alloc_list_head();
-	void                        set_free_list_head(chunk_list_t *flh);
 	void                        set_alloc_list_head(chunk_list_t *alh);
 
 	unsigned int version() const;
@@ -0,0 +1,129 @@
+/***************************************************************************
+ *  qa_lockfree_queue.cpp - QA for bounded lock-free queue
+ *
+ *  Created: Fri Oct 16 23:02:41 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/utils/lockfree_queue.h>
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_PRODUCERS 4
+#define NUM_CONSUMERS 3
+#define NUM_ITEMS 200000
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+int
+main(int argc, char **argv)
+{
+	int failures = 0;
+
+	// single threaded semantics
+	LockFreeQueue<unsigned int> q(5);
+	unsigned int                v  = 0;
+	bool                        ok = (q.capacity() == 8) && q.empty() && !q.try_pop(v);
+	failures += check(ok, "Capacity rounding and empty queue");
+
+	ok = true;
+	for (unsigned int i = 0; i < q.capacity(); ++i) {
+		ok = ok && q.try_push(i);
+	}
+	ok = ok && !q.try_push(42);
+	failures += check(ok, "Push fails on full queue");
+
+	ok = true;
+	for (unsigned int i = 0; i < q.capacity(); ++i) {
+		ok = ok && q.try_pop(v) && (v == i);
+	}
+	ok = ok && q.empty() && !q.try_pop(v);
+	failures += check(ok, "Elements popped in FIFO order");
+
+	// wrap around several laps
+	ok = true;
+	for (unsigned int i = 0; i < 10 * q.capacity(); ++i) {
+		ok = ok && q.try_push(i) && q.try_push(i + 1) && q.try_pop(v) && (v == i) && q.try_pop(v)
+		     && (v == i + 1);
+	}
+	failures += check(ok && q.empty(), "Wrap around");
+
+	// multiple producers and consumers, every element must be received
+	// exactly once and elements of one producer in the order pushed
+	LockFreeQueue<unsigned int>   sq(64);
+	std::vector<std::atomic<int>> seen(NUM_PRODUCERS * NUM_ITEMS);
+	std::atomic<unsigned int>     consumed(0);
+	std::atomic<bool>             order_ok(true);
+	std::vector<std::thread>      threads;
+	for (std::atomic<int> &s : seen) {
+		s = 0;
+	}
+
+	for (unsigned int p = 0; p < NUM_PRODUCERS; ++p) {
+		threads.push_back(std::thread([&sq, p]() {
+			for (unsigned int i = 0; i < NUM_ITEMS; ++i) {
+				while (!sq.try_push(p * NUM_ITEMS + i)) {
+					std::this_thread::yield();
+				}
+			}
+		}));
+	}
+	for (unsigned int c = 0; c < NUM_CONSUMERS; ++c) {
+		threads.push_back(std::thread([&sq, &seen, &consumed, &order_ok]() {
+			std::vector<int> last(NUM_PRODUCERS, -1);
+			unsigned int     x;
+			while (consumed < NUM_PRODUCERS * NUM_ITEMS) {
+				if (sq.try_pop(x)) {
+					int p = x / NUM_ITEMS, i = x % NUM_ITEMS;
+					if (i <= last[p])
+						order_ok = false;
+					last[p] = i;
+					seen[x] += 1;
+					consumed += 1;
+				} else {
+					std::this_thread::yield();
+				}
+			}
+		}));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+
+	ok = sq.empty();
+	for (std::atomic<int> &s : seen) {
+		ok = ok && (s == 1);
+	}
+	failures += check(ok, "Concurrent producers and consumers");
+	failures += check(order_ok, "Per producer order");
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -263,6 +263,7 @@ Thread::__constructor(const char *name, OpMode op_mode)
 	barrier_         = NULL;
 	started_         = false;
 	cancelled_       = false;
+	pooled_          = false;
 	delete_on_exit_  = false;
 	prepfin_hold_    = false;
 	pending_wakeups_ = 0;
@@ -508,6 +509,18 @@ Thread::start(bool wait)
 	started_   = true;
 	wait_      = wait;
 
+	if (pooled_) {
+		// no pthread, the executor runs the loop with execute_loop()
+		Thread *caller = current_thread_noexc();
+		set_tsd_thread_instance(this);
+		notify_of_startup();
+		loop_mutex->lock();
+		once();
+		loop_mutex->unlock();
+		set_tsd_thread_instance(caller);
+		return;
+	}
+
 	if ((err = pthread_create(&thread_id_, NULL, Thread::entry, this)) != 0) {
 		// An error occured
 		throw Exception("Could not start thread", err);
@@ -596,7 +609,13 @@ Thread::exit()
 void
 Thread::join()
 {
-	if (started_) {
+	if (started_ && pooled_) {
+		// wait for an iteration which is currently executed, afterwards
+		// execute_loop() does not run the loop of the cancelled thread
+		loop_mutex->lock();
+		started_ = false;
+		loop_mutex->unlock();
+	} else if (started_) {
 		void *dont_care;
 		pthread_join(thread_id_, &dont_care);
 		started_ = false;
@@ -645,7 +664,9 @@ Thread::detach()
 void
 Thread::cancel()
 {
-	if (started_ && !cancelled_) {
+	if (started_ && !cancelled_ && pooled_) {
+		cancelled_ = true;
+	} else if (started_ && !cancelled_) {
 		if (pthread_cancel(thread_id_) == 0) {
 			waiting_for_wakeup_ = false;
 			cancelled_          = true;
@@ -812,6 +833,39 @@ Thread::started() const
 	return started_;
 }
 
+/** Set pooled execution.
+ * A pooled thread does not get a pthread of its own. Instead, an executor,
+ * for example a thread pool, runs single loop iterations by calling
+ * execute_loop() from one of its threads. start() then only calls once()
+ * and marks the thread as started, cancel() and join() prevent further
+ * iterations and wait for the one currently running, if any. A pooled
+ * thread must be in wait-for-wakeup mode and is never woken up.
+ * This must be called before the thread is started.
+ * @param pooled true to execute the thread on an executor, false to run
+ * it in its own pthread
+ */
+void
+Thread::set_pooled(bool pooled)
+{
+	if (started_) {
+		throw Exception("Cannot change pooled execution of running thread %s", name_);
+	}
+	if (pooled && (op_mode_ != OPMODE_WAITFORWAKEUP)) {
+		throw Exception("Thread %s must be in wait-for-wakeup mode for pooled execution", name_);
+	}
+	pooled_ = pooled;
+}
+
+/** Check if thread is executed by a pool.
+ * @return true if the thread has no pthread of its own, false otherwise
+ * @see set_pooled()
+ */
+bool
+Thread::pooled() const
+{
+	return pooled_;
+}
+
 /** Check if thread has been cancelled.
  * @return true if the thread has been cancelled, false otherwise
  */
@@ -930,36 +984,7 @@ Thread::run()
 
 	forever
 	{
-		loopinterrupt_antistarve_mutex->stopby();
-
-		if (!finalize_prepared) {
-			loop_done_ = false;
-
-			loop_listeners_->lock();
-			for (LockList<ThreadLoopListener *>::iterator it = loop_listeners_->begin();
-			     it != loop_listeners_->end();
-			     it++) {
-				(*it)->pre_loop(this);
-			}
-			loop_listeners_->unlock();
-
-			loop_mutex->lock();
-			loop();
-			loop_mutex->unlock();
-
-			loop_listeners_->lock();
-			for (LockList<ThreadLoopListener *>::reverse_iterator it = loop_listeners_->rbegin();
-			     it != loop_listeners_->rend();
-			     it++) {
-				(*it)->post_loop(this);
-			}
-			loop_listeners_->unlock();
-		}
-
-		loop_done_mutex_->lock();
-		loop_done_ = true;
-		loop_done_mutex_->unlock();
-		loop_done_waitcond_->wake_all();
+		execute_loop();
 
 		test_cancel();
 		if (op_mode_ == OPMODE_WAITFORWAKEUP) {
@@ -987,6 +1012,61 @@ Thread::run()
 	}
 }
 
+/** Execute a single loop iteration.
+ * Runs the loop listeners and loop() once, unless finalization has been
+ * prepared. This is called by run() in each cycle. It may also be called
+ * by an executor which runs the loop of a thread in wait-for-wakeup mode
+ * as a task on another thread, for example on a thread pool, instead of
+ * waking up the thread. Such threads should be marked with set_pooled()
+ * before they are started, such that no pthread is created for them. The
+ * executor must ensure that only one iteration runs at a time.
+ * While the iteration is executed current_thread() returns this thread.
+ */
+void
+Thread::execute_loop()
+{
+	Thread *caller = current_thread_noexc();
+	if (caller != this)
+		set_tsd_thread_instance(this);
+
+	loopinterrupt_antistarve_mutex->stopby();
+
+	if (!finalize_prepared) {
+		loop_done_ = false;
+
+		loop_listeners_->lock();
+		for (LockList<ThreadLoopListener *>::iterator it = loop_listeners_->begin();
+		     it != loop_listeners_->end();
+		     it++) {
+			(*it)->pre_loop(this);
+		}
+		loop_listeners_->unlock();
+
+		loop_mutex->lock();
+		// a pooled thread may have been cancelled while this iteration was
+		// scheduled, cancellation of a pthread happens at test_cancel()
+		if (!(pooled_ && cancelled_))
+			loop();
+		loop_mutex->unlock();
+
+		loop_listeners_->lock();
+		for (LockList<ThreadLoopListener *>::reverse_iterator it = loop_listeners_->rbegin();
+		     it != loop_listeners_->rend();
+		     it++) {
+			(*it)->post_loop(this);
+		}
+		loop_listeners_->unlock();
+	}
+
+	loop_done_mutex_->lock();
+	loop_done_ = true;
+	loop_done_mutex_->unlock();
+	loop_done_waitcond_->wake_all();
+
+	if (caller != this)
+		set_tsd_thread_instance(caller);
+}
+
 /** Wake up thread.
  * If the thread is being used in wait for wakeup mode this will wake up the
  * waiting thread.
@@ -88,6 +88,9 @@ public:
 	void wakeup(Barrier *barrier);
 
 	void wait_loop_done();
+	void execute_loop();
+	void set_pooled(bool pooled = true);
+	bool pooled() const;
 
 	OpMode    opmode() const;
 	pthread_t thread_id() const;
@@ -182,6 +185,7 @@ private:
 
 	bool  started_;
 	bool  cancelled_;
+	bool  pooled_;
 	bool  detached_;
 	bool  waiting_for_wakeup_;
 	bool  delete_on_exit_;
@@ -0,0 +1,188 @@
+/***************************************************************************
+ *  lockfree_queue.h - Bounded lock-free queue
+ *
+ *  Created: Fri Oct 16 19:02:11 2026
+ *  Copyright  2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _CORE_UTILS_LOCKFREE_QUEUE_H_
+#define _CORE_UTILS_LOCKFREE_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace fawkes {
+
+/** @class LockFreeQueue <core/utils/lockfree_queue.h>
+ * Bounded lock-free queue.
+ * This queue can be used by multiple producers and multiple consumers
+ * concurrently without any locking. It has a fixed capacity which is
+ * allocated on construction. Pushing to a full queue fails instead of
+ * blocking, hence producers never have to wait for consumers.
+ *
+ * Every cell carries a sequence number which tells producers and
+ * consumers whether the cell is ready to be written or read in the
+ * current lap around the ring buffer. Producers and consumers each
+ * claim cells by advancing their position counter with a single
+ * compare-and-swap operation.
+ *
+ * @ingroup FCL
+ * @author Tim Niemueller
+ */
+template <typename Type>
+class LockFreeQueue
+{
+public:
+	/** Constructor.
+   * @param capacity minimum number of elements the queue can hold, will be
+   * rounded up to the next power of two
+   */
+	explicit LockFreeQueue(unsigned int capacity);
+
+	/** Destructor. */
+	~LockFreeQueue();
+
+	/** Push element to queue.
+   * @param x element to add
+   * @return true if the element has been added, false if the queue is full
+   */
+	bool try_push(const Type &x);
+
+	/** Pop element from queue.
+   * @param x upon successful return contains the removed element
+   * @return true if an element has been removed, false if the queue is empty
+   */
+	bool try_pop(Type &x);
+
+	/** Check if queue is empty.
+   * Note that the result may be outdated as soon as it is returned if other
+   * threads access the queue concurrently.
+   * @return true if the queue is empty, false otherwise
+   */
+	bool empty() const;
+
+	/** Get capacity of queue.
+   * @return maximum number of elements the queue can hold
+   */
+	unsigned int
+	capacity() const
+	{
+		return mask_ + 1;
+	}
+
+private:
+	LockFreeQueue(const LockFreeQueue<Type> &q);
+	LockFreeQueue<Type> &operator=(const LockFreeQueue<Type> &q);
+
+	struct Cell
+	{
+		std::atomic<size_t> seq;
+		Type                data;
+	};
+
+	Cell * cells_;
+	size_t mask_;
+
+	alignas(64) std::atomic<size_t> enqueue_pos_;
+	alignas(64) std::atomic<size_t> dequeue_pos_;
+};
+
+template <typename Type>
+LockFreeQueue<Type>::LockFreeQueue(unsigned int capacity)
+{
+	size_t size = 2;
+	while (size < capacity)
+		size <<= 1;
+
+	cells_ = new Cell[size];
+	mask_  = size - 1;
+	for (size_t i = 0; i < size; ++i) {
+		cells_[i].seq.store(i, std::memory_order_relaxed);
+	}
+	enqueue_pos_.store(0, std::memory_order_relaxed);
+	dequeue_pos_.store(0, std::memory_order_relaxed);
+}
+
+template <typename Type>
+LockFreeQueue<Type>::~LockFreeQueue()
+{
+	delete[] cells_;
+}
+
+template <typename Type>
+bool
+LockFreeQueue<Type>::try_push(const Type &x)
+{
+	Cell * cell;
+	size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+	for (;;) {
+		cell          = &cells_[pos & mask_];
+		size_t   seq  = cell->seq.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+		if (diff == 0) {
+			if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			// cell has not been consumed in the last lap, queue is full
+			return false;
+		} else {
+			pos = enqueue_pos_.load(std::memory_order_relaxed);
+		}
+	}
+	cell->data = x;
+	cell->seq.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename Type>
+bool
+LockFreeQueue<Type>::try_pop(Type &x)
+{
+	Cell * cell;
+	size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+	for (;;) {
+		cell          = &cells_[pos & mask_];
+		size_t   seq  = cell->seq.load(std::memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+		if (diff == 0) {
+			if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0) {
+			// cell has not been produced in this lap, queue is empty
+			return false;
+		} else {
+			pos = dequeue_pos_.load(std::memory_order_relaxed);
+		}
+	}
+	x = cell->data;
+	cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename Type>
+bool
+LockFreeQueue<Type>::empty() const
+{
+	size_t pos = dequeue_pos_.load(std::memory_order_acquire);
+	return (cells_[pos & mask_].seq.load(std::memory_order_acquire) != pos + 1);
+}
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,88 @@
+
+/***************************************************************************
+ *  external_buffers.cpp - Cameras capturing into externally provided buffers
+ *
+ *  Created: Fri Oct 16 15:12:44 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvcams/external_buffers.h>
+
+namespace firevision {
+
+/** @class CameraExternalBuffers <fvcams/external_buffers.h>
+ * Camera capturing into externally provided buffers.
+ * Cameras implementing this interface can write images directly into
+ * buffers owned by the caller, for example the slots of a shared memory
+ * image buffer, which avoids copying every image after capture().
+ *
+ * The buffers are set with set_external_buffers() before start(). The
+ * camera then captures into the buffers in the order in which they are
+ * queued. After capture() the index of the filled buffer can be retrieved
+ * with current_external_buffer() and the buffer belongs to the caller, it
+ * is not returned to the camera by dispose_buffer(). Instead the caller
+ * hands it back, or any other of the buffers it currently owns, with
+ * queue_external_buffer() once it may be overwritten again. Initially, all
+ * buffers belong to the caller and nothing is captured before at least one
+ * buffer has been queued after start(). After stop() all buffers belong to
+ * the caller again.
+ *
+ * @fn bool CameraExternalBuffers::external_buffers_supported()
+ * Check if external buffers can be used.
+ * This may depend on the configuration of the camera, for example on the
+ * I/O method, and is only meaningful after the camera has been opened.
+ * @return true if set_external_buffers() may be called, false otherwise
+ *
+ * @fn size_t CameraExternalBuffers::external_buffer_size()
+ * Get minimum buffer size.
+ * @return minimum size in bytes of each external buffer
+ *
+ * @fn void CameraExternalBuffers::set_external_buffers(unsigned int num_buffers, unsigned char **buffers, size_t size)
+ * Set external buffers.
+ * Must be called while the camera is opened but not started. The buffers
+ * must remain valid until the camera has been stopped.
+ * @param num_buffers number of buffers
+ * @param buffers array of num_buffers buffers, the array is copied
+ * @param size size in bytes of each buffer, at least external_buffer_size()
+ *
+ * @fn void CameraExternalBuffers::unset_external_buffers()
+ * Stop using external buffers.
+ * The camera captures to buffers of its own again. Must be called while
+ * the camera is opened but not started. This allows to fall back to copying
+ * the images if the camera rejects the external buffers, for example if
+ * queue_external_buffer() fails.
+ *
+ * @fn void CameraExternalBuffers::queue_external_buffer(unsigned int index)
+ * Queue buffer for capturing.
+ * May only be called while the camera is started. If the camera rejects the
+ * buffer an exception is thrown, the camera remains opened in that case.
+ * @param index index of the buffer in the array given to set_external_buffers()
+ *
+ * @fn int CameraExternalBuffers::current_external_buffer()
+ * Get index of current buffer.
+ * @return index of the buffer filled by the last capture(), -1 if none
+ *
+ * @author Tim Niemueller
+ */
+
+/** Virtual empty destructor. */
+CameraExternalBuffers::~CameraExternalBuffers()
+{
+}
+
+} // end namespace firevision
@@ -0,0 +1,47 @@
+
+/***************************************************************************
+ *  external_buffers.h - Cameras capturing into externally provided buffers
+ *
+ *  Created: Fri Oct 16 15:12:44 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_CAMS_EXTERNAL_BUFFERS_H_
+#define _FIREVISION_CAMS_EXTERNAL_BUFFERS_H_
+
+#include <cstddef>
+
+namespace firevision {
+
+class CameraExternalBuffers
+{
+public:
+	virtual ~CameraExternalBuffers();
+
+	virtual bool   external_buffers_supported() = 0;
+	virtual size_t external_buffer_size()       = 0;
+	virtual void
+	set_external_buffers(unsigned int num_buffers, unsigned char **buffers, size_t size) = 0;
+	virtual void unset_external_buffers()                                                = 0;
+	virtual void queue_external_buffer(unsigned int index)                               = 0;
+	virtual int  current_external_buffer()                                               = 0;
+};
+
+} // end namespace firevision
+
+#endif
@@ -47,6 +47,10 @@ namespace firevision {
  * locking times so that the interference between the two processes is
  * minimal.
  *
+ * If the shared memory buffer has multiple slots no lock is taken. The
+ * latest image is copied in deep-copy mode, otherwise buffer() returns
+ * the latest image at the time of capture() in place.
+ *
  * @author Tim Niemueller
  */
 
@@ -112,11 +116,12 @@ void
 SharedMemoryCamera::init()
 {
 	deep_buffer_  = NULL;
+	frame_buffer_ = NULL;
 	capture_time_ = NULL;
 	try {
 		shm_buffer_ = new SharedMemoryImageBuffer(image_id_);
 		if (deep_copy_) {
-			deep_buffer_ = (unsigned char *)malloc(shm_buffer_->data_size());
+			deep_buffer_ = (unsigned char *)malloc(shm_buffer_->image_size());
 			if (!deep_buffer_) {
 				throw OutOfMemoryException("SharedMemoryCamera: Cannot allocate deep buffer");
 			}
@@ -152,13 +157,18 @@ SharedMemoryCamera::print_info()
 void
 SharedMemoryCamera::capture()
 {
+	SharedMemoryImageBuffer::Frame frame;
 	if (deep_copy_) {
-		shm_buffer_->lock_for_read();
-		memcpy(deep_buffer_, shm_buffer_->buffer(), shm_buffer_->data_size());
-		capture_time_->set_time(shm_buffer_->capture_time());
-		shm_buffer_->unlock();
-	} else
+		if (shm_buffer_->copy_latest(deep_buffer_, frame)) {
+			capture_time_->set_time(frame.capture_time);
+		}
+	} else if ((shm_buffer_->num_slots() > 1) && shm_buffer_->read_latest(frame)) {
+		frame_buffer_ = (unsigned char *)frame.buffer;
+		capture_time_->set_time(frame.capture_time);
+	} else {
+		frame_buffer_ = shm_buffer_->buffer();
 		capture_time_->set_time(shm_buffer_->capture_time());
+	}
 }
 
 unsigned char *
@@ -166,6 +176,8 @@ SharedMemoryCamera::buffer()
 {
 	if (deep_copy_) {
 		return deep_buffer_;
+	} else if (frame_buffer_) {
+		return frame_buffer_;
 	} else {
 		return shm_buffer_->buffer();
 	}
@@ -78,6 +78,7 @@ private:
 	SharedMemoryImageBuffer *shm_buffer_;
 
 	unsigned char *deep_buffer_;
+	unsigned char *frame_buffer_;
 
 	fawkes::Time *capture_time_;
 };
@@ -29,6 +29,7 @@
 #include <logging/liblogger.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 #include <cerrno>
 #include <cstdlib>
@@ -71,7 +72,11 @@ public:
 /** @class V4L2Camera <fvcams/v4l2.h>
  * Video4Linux 2 camera access implementation.
  *
- * @todo UPTR method
+ * With the user pointer read method the driver writes images directly to
+ * buffers in user space. These are allocated internally, or provided by the
+ * user with set_external_buffers(), for example the slots of a shared memory
+ * image buffer, in which case images are captured without any copying.
+ *
  * @todo v4l2_pix_format.field
  * @author Tobias Kellner
  * @author Tim Niemueller
@@ -99,10 +104,11 @@ V4L2Camera::V4L2Camera(const char *device_name)
 	_sharpness.set                  = false;
 	_read_method                    = MMAP;
 	memset(_format, 0, 5);
-	_frame_buffers = NULL;
-	_capture_time  = NULL;
-	_device_name   = strdup(device_name);
-	_data          = new V4L2CameraData();
+	_frame_buffers    = NULL;
+	_external_buffers = false;
+	_capture_time     = NULL;
+	_device_name      = strdup(device_name);
+	_data             = new V4L2CameraData();
 }
 
 /** Constructor.
@@ -114,7 +120,7 @@ V4L2Camera::V4L2Camera(const char *device_name)
  * - read_method=METHOD, preferred read method
  *    READ: read()
  *    MMAP: memory mapping
- *    UPTR: user pointer
+ *    UPTR: user pointer, allows for capturing to external buffers
  * - standard=std, set video standard, e.g. PAL or NTSC
  * - input=inp, set video input, e.g. S-Video
  * - format=FOURCC, preferred format
@@ -145,6 +151,7 @@ V4L2Camera::V4L2Camera(const CameraArgumentParser *cap)
 	_width = _height = _bytes_per_line = _buffers_length = 0;
 	_current_buffer                                      = -1;
 	_frame_buffers                                       = NULL;
+	_external_buffers                                    = false;
 	_capture_time                                        = NULL;
 	_standard                                            = NULL;
 	_input                                               = NULL;
@@ -378,12 +385,13 @@ V4L2Camera::V4L2Camera(const char *device_name, int dev)
 	_sharpness.set                  = false;
 	_read_method                    = UPTR;
 	memset(_format, 0, 5);
-	_frame_buffers = NULL;
-	_capture_time  = NULL;
-	_device_name   = strdup(device_name);
-	_standard      = NULL;
-	_input         = NULL;
-	_data          = new V4L2CameraData();
+	_frame_buffers    = NULL;
+	_external_buffers = false;
+	_capture_time     = NULL;
+	_device_name      = strdup(device_name);
+	_standard         = NULL;
+	_input            = NULL;
+	_data             = new V4L2CameraData();
 
 	_dev = dev;
 
@@ -494,10 +502,19 @@ V4L2Camera::select_read_method()
 			buf.type        = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 			buf.memory      = V4L2_MEMORY_MMAP;
 		} else if (_read_method == UPTR) {
-			_buffers_length = 0;
+			// buffers are requested on start(), just check for support
+			_buffers_length = MMAP_NUM_BUFFERS;
 			buf.count       = 0;
 			buf.type        = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 			buf.memory      = V4L2_MEMORY_USERPTR;
+
+			if (v4l2_ioctl(_dev, VIDIOC_REQBUFS, &buf)) {
+				LibLogger::log_warn("V4L2Cam", "User pointer method not supported, using memory mapping");
+				_read_method    = MMAP;
+				_buffers_length = MMAP_NUM_BUFFERS;
+				buf.count       = _buffers_length;
+				buf.memory      = V4L2_MEMORY_MMAP;
+			}
 		}
 
 		if (v4l2_ioctl(_dev, VIDIOC_REQBUFS, &buf)) {
@@ -521,11 +538,7 @@ V4L2Camera::select_read_method()
 
 	case MMAP: LibLogger::log_debug("V4L2Cam", "Using memory mapping method"); break;
 
-	case UPTR:
-		LibLogger::log_debug("V4L2Cam", "Using user pointer method");
-		//TODO
-		throw Exception("V4L2Cam: user pointer method not supported yet");
-		break;
+	case UPTR: LibLogger::log_debug("V4L2Cam", "Using user pointer method"); break;
 	}
 }
 
@@ -985,10 +998,61 @@ V4L2Camera::create_buffer()
 		break;
 	}
 
+	case UPTR: {
+		// page-aligned, some drivers require it for user pointers
+		size_t page_size = sysconf(_SC_PAGESIZE);
+		size_t size      = (_bytes_per_line * _height + page_size - 1) & ~(page_size - 1);
+		for (unsigned int i = 0; i < _buffers_length; ++i) {
+			void *buffer = NULL;
+			if (posix_memalign(&buffer, page_size, size) != 0) {
+				_buffers_length = i;
+				close();
+				throw Exception("V4L2Cam: Out of memory");
+			}
+			_frame_buffers[i].buffer = static_cast<unsigned char *>(buffer);
+			_frame_buffers[i].size   = size;
+		}
+		break;
+	}
+	}
+}
+
+/**
+ * Free buffers for image transfer.
+ * Postconditions:
+ *  - _frame_buffers is freed and set to NULL
+ */
+void
+V4L2Camera::free_buffer()
+{
+	if (!_frame_buffers)
+		return;
+
+	switch (_read_method) {
+	case READ: {
+		free(_frame_buffers[0].buffer);
+		break;
+	}
+
+	case MMAP: {
+		for (unsigned int i = 0; i < _buffers_length; ++i) {
+			v4l2_munmap(_frame_buffers[i].buffer, _frame_buffers[i].size);
+		}
+		break;
+	}
+
 	case UPTR:
-		/* not supported yet */
+		if (!_external_buffers) {
+			for (unsigned int i = 0; i < _buffers_length; ++i) {
+				free(_frame_buffers[i].buffer);
+			}
+		}
 		break;
 	}
+	delete[] _frame_buffers;
+	_frame_buffers    = NULL;
+	_external_buffers = false;
+	_current_buffer   = -1;
 }
 
 /**
@@ -1035,28 +1099,7 @@ V4L2Camera::close()
 	if (_started)
 		stop();
 
-	if (_frame_buffers) {
-		switch (_read_method) {
-		case READ: {
-			free(_frame_buffers[0].buffer);
-			break;
-		}
-
-		case MMAP: {
-			for (unsigned int i = 0; i < _buffers_length; ++i) {
-				v4l2_munmap(_frame_buffers[i].buffer, _frame_buffers[i].size);
-			}
-			break;
-		}
-
-		case UPTR:
-			/* not supported yet */
-			break;
-		}
-		delete[] _frame_buffers;
-		_frame_buffers  = NULL;
-		_current_buffer = -1;
-	}
+	free_buffer();
 
 	if (_opened) {
 		v4l2_close(_dev);
@@ -1108,10 +1151,32 @@ V4L2Camera::start()
 		break;
 	}
 
-	case UPTR:
-		/* not supported yet */
+	case UPTR: {
+		v4l2_requestbuffers buf;
+		memset(&buf, 0, sizeof(buf));
+		buf.count  = _buffers_length;
+		buf.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		buf.memory = V4L2_MEMORY_USERPTR;
+		if (v4l2_ioctl(_dev, VIDIOC_REQBUFS, &buf) || (buf.count < _buffers_length)) {
+			close();
+			throw Exception("V4L2Cam: Requesting user pointer buffers failed");
+		}
+
+		// external buffers are queued by their owner
+		if (!_external_buffers) {
+			for (unsigned int i = 0; i < _buffers_length; ++i) {
+				queue_buffer(i);
+			}
+		}
+
+		int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		if (v4l2_ioctl(_dev, VIDIOC_STREAMON, &type)) {
+			close();
+			throw Exception("V4L2Cam: Starting stream failed");
+		}
 		break;
 	}
+	}
 
 	//LibLogger::log_debug("V4L2Cam", "start() complete");
 	_started = true;
@@ -1184,12 +1249,13 @@ V4L2Camera::capture()
 		break;
 	}
 
-	case MMAP: {
+	case MMAP:
+	case UPTR: {
 		// dequeue buffer
 		v4l2_buffer buffer;
 		memset(&buffer, 0, sizeof(buffer));
 		buffer.type   = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-		buffer.memory = V4L2_MEMORY_MMAP;
+		buffer.memory = (_read_method == MMAP ? V4L2_MEMORY_MMAP : V4L2_MEMORY_USERPTR);
 
 		if (v4l2_ioctl(_dev, VIDIOC_DQBUF, &buffer)) {
 			close();
@@ -1205,10 +1271,6 @@ V4L2Camera::capture()
 		}
 		break;
 	}
-
-	case UPTR:
-		/* not supported yet */
-		break;
 	}
 }
 
@@ -1259,7 +1321,10 @@ V4L2Camera::dispose_buffer()
 	}
 
 	case UPTR:
-		/* not supported yet */
+		// external buffers are handed back with queue_external_buffer()
+		if (!_external_buffers && (_current_buffer != -1)) {
+			queue_buffer(_current_buffer);
+		}
 		break;
 	}
 
@@ -1299,6 +1364,105 @@ V4L2Camera::capture_time()
 	return _capture_time;
 }
 
+/** Enqueue user pointer buffer.
+ * If an external buffer is rejected, e.g. because the driver cannot use
+ * its alignment or memory type, the device is kept open so that the owner
+ * can fall back to internal buffers with unset_external_buffers().
+ * @param index index of the buffer in _frame_buffers
+ */
+void
+V4L2Camera::queue_buffer(unsigned int index)
+{
+	v4l2_buffer buffer;
+	memset(&buffer, 0, sizeof(buffer));
+	buffer.type      = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+	buffer.memory    = V4L2_MEMORY_USERPTR;
+	buffer.index     = index;
+	buffer.m.userptr = (unsigned long)_frame_buffers[index].buffer;
+	buffer.length    = _frame_buffers[index].size;
+
+	if (v4l2_ioctl(_dev, VIDIOC_QBUF, &buffer)) {
+		int errno_save = errno;
+		if (!_external_buffers) {
+			close();
+		}
+		throw Exception(errno_save, "V4L2Cam: Enqueuing buffer failed");
+	}
+}
+
+bool
+V4L2Camera::external_buffers_supported()
+{
+	return _opened && (_read_method == UPTR);
+}
+
+size_t
+V4L2Camera::external_buffer_size()
+{
+	return _bytes_per_line * _height;
+}
+
+void
+V4L2Camera::set_external_buffers(unsigned int num_buffers, unsigned char **buffers, size_t size)
+{
+	if (!external_buffers_supported()) {
+		throw Exception("V4L2Cam: external buffers require the user pointer read method");
+	}
+	if (_started) {
+		throw Exception("V4L2Cam: cannot set external buffers while started");
+	}
+	if (num_buffers == 0) {
+		throw Exception("V4L2Cam: no external buffers given");
+	}
+	if (size < external_buffer_size()) {
+		throw Exception("V4L2Cam: external buffers too small (%zu < %zu)",
+		                size,
+		                external_buffer_size());
+	}
+
+	free_buffer();
+	_buffers_length = num_buffers;
+	_frame_buffers  = new FrameBuffer[_buffers_length];
+	for (unsigned int i = 0; i < _buffers_length; ++i) {
+		_frame_buffers[i].buffer = buffers[i];
+		_frame_buffers[i].size   = size;
+	}
+	_external_buffers = true;
+}
+
+void
+V4L2Camera::unset_external_buffers()
+{
+	if (!_external_buffers) {
+		return;
+	}
+	if (_started) {
+		throw Exception("V4L2Cam: cannot unset external buffers while started");
+	}
+
+	free_buffer();
+	_buffers_length = MMAP_NUM_BUFFERS;
+	create_buffer();
+}
+
+void
+V4L2Camera::queue_external_buffer(unsigned int index)
+{
+	if (!_external_buffers || (index >= _buffers_length)) {
+		throw Exception("V4L2Cam: invalid external buffer %u", index);
+	}
+	if (!_started) {
+		throw Exception("V4L2Cam: cannot queue external buffer before start()");
+	}
+	queue_buffer(index);
+}
+
+int
+V4L2Camera::current_external_buffer()
+{
+	return _external_buffers ? _current_buffer : -1;
+}
+
 void
 V4L2Camera::set_image_number(unsigned int n)
 {
@@ -27,6 +27,7 @@
 #include <fvcams/camera.h>
 #include <fvcams/control/color.h>
 #include <fvcams/control/image.h>
+#include <fvcams/external_buffers.h>
 #include <linux/types.h>
 #include <linux/videodev2.h>
 
@@ -39,7 +40,10 @@ class CameraArgumentParser;
 class V4L2CameraData;
 class V4LCamera;
 
-class V4L2Camera : public Camera, public CameraControlColor, public CameraControlImage
+class V4L2Camera : public Camera,
+                   public CameraControlColor,
+                   public CameraControlImage,
+                   public CameraExternalBuffers
 {
 	friend V4LCamera;
 
@@ -68,6 +72,13 @@ public:
 
 	virtual void set_image_number(unsigned int n);
 
+	virtual bool   external_buffers_supported();
+	virtual size_t external_buffer_size();
+	virtual void set_external_buffers(unsigned int num_buffers, unsigned char **buffers, size_t size);
+	virtual void unset_external_buffers();
+	virtual void queue_external_buffer(unsigned int index);
+	virtual int  current_external_buffer();
+
 	virtual bool         auto_gain();
 	virtual void         set_auto_gain(bool enabled);
 	virtual bool         auto_white_balance();
@@ -134,6 +145,8 @@ private:
 	virtual void set_fps();
 	virtual void set_controls();
 	virtual void create_buffer();
+	virtual void free_buffer();
+	virtual void queue_buffer(unsigned int index);
 	virtual void reset_cropping();
 
 protected:
@@ -179,8 +192,9 @@ private:
 	unsigned int  _width;          ///< Image width
 	unsigned int  _height;         ///< Image height
 	unsigned int  _bytes_per_line; ///< Image bytes per line
-	FrameBuffer * _frame_buffers;  ///< Image buffers
-	unsigned int  _buffers_length; ///< Image buffer size
+	FrameBuffer * _frame_buffers;    ///< Image buffers
+	unsigned int  _buffers_length;   ///< Image buffer size
+	bool          _external_buffers; ///< Image buffers are owned by the user
 	int           _current_buffer; ///< Current Image buffer (-1 if not set)
 	fawkes::Time *_capture_time;   ///< Time when last picture was captured
 
@@ -26,6 +26,8 @@
 #include <fvutils/color/rgbyuv.h>
 #include <fvutils/color/yuv.h>
 
+#include <cstddef>
+
 namespace firevision {
 
 /* The basic information has been taken from
@@ -87,189 +89,183 @@ bayerGBRG_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
 	}
 }
 
+/** Convert part of a line of a GBRG Bayer mosaic to planar YUV422.
+ * Converts the pixels [col_begin, col_end) of the given line with
+ * bilinear interpolation. The first and last line, and the first and
+ * last two pixels of each line, only use the available neighbours.
+ * Lines may be converted in any order and concurrently.
+ * @param bayer Bayer mosaic of the whole image
+ * @param yuv planar YUV422 buffer of the whole image
+ * @param width width of image in pixels, must be even
+ * @param height height of image in pixels, must be even
+ * @param line line to convert
+ * @param col_begin first pixel to convert, must be even
+ * @param col_end pixel after the last pixel to convert, must be even
+ */
 void
-bayerGBRG_to_yuv422planar_bilinear(const unsigned char *bayer,
-                                   unsigned char *      yuv,
-                                   unsigned int         width,
-                                   unsigned int         height)
+bayerGBRG_to_yuv422planar_bilinear_line(const unsigned char *bayer,
+                                        unsigned char *      yuv,
+                                        unsigned int         width,
+                                        unsigned int         height,
+                                        unsigned int         line,
+                                        unsigned int         col_begin,
+                                        unsigned int         col_end)
 {
-	unsigned char *      y  = yuv;
-	unsigned char *      u  = YUV422_PLANAR_U_PLANE(yuv, width, height);
-	unsigned char *      v  = YUV422_PLANAR_V_PLANE(yuv, width, height);
-	const unsigned char *bf = bayer;
+	const size_t         offset = (size_t)width * line + col_begin;
+	unsigned char *      y      = yuv + offset;
+	unsigned char *      u      = YUV422_PLANAR_U_PLANE(yuv, width, height) + offset / 2;
+	unsigned char *      v      = YUV422_PLANAR_V_PLANE(yuv, width, height) + offset / 2;
+	const unsigned char *bf     = bayer + offset;
+
+	// signed, -width would wrap around for pointer arithmetic
+	const int stride = width;
 
 	int y1, u1, v1, y2, u2, v2;
 	int r, g, b;
 
-	// first line is special
-	// g  b  ... line
-	// not full data in first columns
-	RGB2YUV(bf[width], *bf, bf[1], y1, u1, v1);
-	++bf;
-
-	r = (bf[width - 1] + bf[width + 1]) >> 1;
-	// correct:
-	// g = (bf[-1] + bf[width] + bf[1]) / 3;
-	// faster:
-	g = (bf[-1] + bf[1]) >> 1;
-	RGB2YUV(r, g, *bf, y2, u2, v2);
-	++bf;
-
-	assign(y, u, v, y1, u1, v1, y2, u2, v2);
-
-	// rest of first line
-	for (unsigned int w = 2; w < width - 2; w += 2) {
-		b = (bf[-1] + bf[1]) >> 1;
-		RGB2YUV(bf[width], *bf, b, y1, u1, v1);
-		++bf;
-
-		r = (bf[width - 1] + bf[width + 1]) >> 1;
-		// correct:
-		// g = (bf[-1] + bf[width] + bf[1]) / 3;
-		// faster:
-		g = (bf[-1] + bf[1]) >> 1;
-		RGB2YUV(r, g, *bf, y2, u2, v2);
-		++bf;
-
-		assign(y, u, v, y1, u1, v1, y2, u2, v2);
-	}
-
-	// not full data in last columns
-	b = (bf[-1] + bf[1]) >> 1;
-	RGB2YUV(bf[width], *bf, b, y1, u1, v1);
-	++bf;
-
-	g = (bf[-1] + bf[width]) >> 1;
-	RGB2YUV(bf[width - 1], g, *bf, y2, u2, v2);
-	++bf;
-
-	assign(y, u, v, y1, u1, v1, y2, u2, v2);
-
-	for (unsigned int h = 1; h < height - 1; h += 2) {
-		// r  g  ... line
-		// correct: g = (bf[-width] + bf[1] + bf[width]) / 3;
-		// faster:
-		g = (bf[-width] + bf[1]) >> 1;
-		b = (bf[width - 1] + bf[width + 1]) >> 1;
-		RGB2YUV(*bf, g, b, y1, u1, v1);
-		++bf;
-
-		r = (bf[-1] + bf[1]) >> 1;
-		b = (bf[-width] + bf[width]) >> 1;
-		RGB2YUV(r, *bf, b, y2, u2, v2);
-		++bf;
-
-		assign(y, u, v, y1, u1, v1, y2, u2, v2);
-
-		for (unsigned int w = 2; w < width - 2; w += 2) {
-			g = (bf[-width] + bf[1] + bf[width] + bf[-1]) >> 2;
-			b = (bf[-width - 1] + bf[-width + 1] + bf[width - 1] + bf[width + 1]) >> 2;
-			RGB2YUV(*bf, g, b, y1, u1, v1);
-			++bf;
-
-			r = (bf[-1] + bf[1]) >> 1;
-			b = (bf[-width] + bf[width]) >> 1;
-			RGB2YUV(r, *bf, b, y2, u2, v2);
-			++bf;
-
-			assign(y, u, v, y1, u1, v1, y2, u2, v2);
+	for (unsigned int w = col_begin; w < col_end; w += 2) {
+		if (line == 0) {
+			// first g  b  ... line
+			if (w == 0) {
+				// not full data in first columns
+				RGB2YUV(bf[stride], *bf, bf[1], y1, u1, v1);
+				++bf;
+
+				r = (bf[stride - 1] + bf[stride + 1]) >> 1;
+				// correct:
+				// g = (bf[-1] + bf[stride] + bf[1]) / 3;
+				// faster:
+				g = (bf[-1] + bf[1]) >> 1;
+				RGB2YUV(r, g, *bf, y2, u2, v2);
+				++bf;
+			} else if (w == width - 2) {
+				// not full data in last columns
+				b = (bf[-1] + bf[1]) >> 1;
+				RGB2YUV(bf[stride], *bf, b, y1, u1, v1);
+				++bf;
+
+				g = (bf[-1] + bf[stride]) >> 1;
+				RGB2YUV(bf[stride - 1], g, *bf, y2, u2, v2);
+				++bf;
+			} else {
+				b = (bf[-1] + bf[1]) >> 1;
+				RGB2YUV(bf[stride], *bf, b, y1, u1, v1);
+				++bf;
+
+				r = (bf[stride - 1] + bf[stride + 1]) >> 1;
+				// correct:
+				// g = (bf[-1] + bf[stride] + bf[1]) / 3;
+				// faster:
+				g = (bf[-1] + bf[1]) >> 1;
+				RGB2YUV(r, g, *bf, y2, u2, v2);
+				++bf;
+			}
+
+		} else if (line == height - 1) {
+			// last r  g  ... line
+			if (w == 0) {
+				// correct: g = (bf[-stride] + bf[1] + bf[stride]) / 3;
+				// faster:
+				g = (bf[-stride] + bf[1]) >> 1;
+				b = bf[-stride + 1];
+				RGB2YUV(*bf, g, b, y1, u1, v1);
+				++bf;
+
+				r = (bf[-1] + bf[1]) >> 1;
+				RGB2YUV(r, g, *bf, y2, u2, v2);
+				++bf;
+			} else if (w == width - 2) {
+				// correct: g = (bf[-stride] + bf[1] + bf[-1]) / 3;
+				// faster:
+				g = (bf[-stride] + bf[-1]) >> 1;
+				b = (bf[-stride - 1] + bf[-stride + 1]) >> 1;
+				RGB2YUV(*bf, g, b, y1, u1, v1);
+				++bf;
+
+				b = bf[-stride];
+				RGB2YUV(bf[-1], *bf, b, y2, u2, v2);
+				++bf;
+			} else {
+				// correct: g = (bf[-stride] + bf[1] + bf[-1]) / 3
+				// faster:
+				g = (bf[-stride] + bf[-1]) >> 1;
+				b = (bf[-stride - 1] + bf[-stride + 1]) >> 1;
+				RGB2YUV(*bf, g, b, y1, u1, v1);
+				++bf;
+
+				r = (bf[-1] + bf[1]) >> 1;
+				b = bf[-stride];
+				RGB2YUV(r, *bf, b, y2, u2, v2);
+				++bf;
+			}
+
+		} else if (line % 2 == 1) {
+			// r  g  ... line
+			if (w == 0) {
+				// correct: g = (bf[-stride] + bf[1] + bf[stride]) / 3;
+				// faster:
+				g = (bf[-stride] + bf[1]) >> 1;
+				b = (bf[stride - 1] + bf[stride + 1]) >> 1;
+				RGB2YUV(*bf, g, b, y1, u1, v1);
+				++bf;
+			} else {
+				g = (bf[-stride] + bf[1] + bf[stride] + bf[-1]) >> 2;
+				b = (bf[-stride - 1] + bf[-stride + 1] + bf[stride - 1] + bf[stride + 1]) >> 2;
+				RGB2YUV(*bf, g, b, y1, u1, v1);
+				++bf;
+			}
+
+			if (w == width - 2) {
+				RGB2YUV(bf[-1], *bf, g, y2, u2, v2);
+				++bf;
+			} else {
+				r = (bf[-1] + bf[1]) >> 1;
+				b = (bf[-stride] + bf[stride]) >> 1;
+				RGB2YUV(r, *bf, b, y2, u2, v2);
+				++bf;
+			}
+
+		} else {
+			// g  b  ... line
+			if (w == 0) {
+				r = (bf[stride] + bf[-stride]) >> 1;
+				RGB2YUV(r, *bf, bf[1], y1, u1, v1);
+				++bf;
+			} else {
+				r = (bf[stride] + bf[-stride]) >> 1;
+				b = (bf[-1] + bf[1]) >> 1;
+				RGB2YUV(r, *bf, b, y1, u1, v1);
+				++bf;
+			}
+
+			if (w == width - 2) {
+				r = (bf[-stride - 1] + bf[stride - 1]) >> 1;
+				// correct: g = (bf[-stride] + bf[stride] + bf[-1]) / 3;
+				// faster:
+				g = (bf[-stride] + bf[-1]) >> 1;
+				RGB2YUV(r, g, *bf, y2, u2, v2);
+				++bf;
+			} else {
+				r = (bf[-stride - 1] + bf[-stride + 1] + bf[stride - 1] + bf[stride + 1]) >> 2;
+				g = (bf[-stride] + bf[1] + bf[stride] + bf[-1]) >> 2;
+				RGB2YUV(r, g, *bf, y2, u2, v2);
+				++bf;
+			}
 		}
 
-		g = (bf[-width] + bf[1] + bf[width] + bf[-1]) >> 2;
-		b = (bf[-width - 1] + bf[-width + 1] + bf[width - 1] + bf[width + 1]) >> 2;
-		RGB2YUV(*bf, g, b, y1, u1, v1);
-		++bf;
-
-		b = (bf[-width] + bf[width]) >> 1;
-		RGB2YUV(bf[-1], *bf, g, y2, u2, v2);
-		++bf;
-
-		assign(y, u, v, y1, u1, v1, y2, u2, v2);
-
-		// g  b  ... line
-		r = (bf[width] + bf[-width]) >> 1;
-		RGB2YUV(r, *bf, bf[1], y1, u1, v1);
-		++bf;
-
-		r = (bf[-width - 1] + bf[-width + 1] + bf[width - 1] + bf[width + 1]) >> 2;
-		g = (bf[-width] + bf[1] + bf[width] + bf[-1]) >> 2;
-		RGB2YUV(r, g, *bf, y2, u2, v2);
-		++bf;
-
-		assign(y, u, v, y1, u1, v1, y2, u2, v2);
-
-		for (unsigned int w = 2; w < width - 2; w += 2) {
-			r = (bf[width] + bf[-width]) >> 1;
-			b = (bf[-1] + bf[1]) >> 1;
-			RGB2YUV(r, *bf, b, y1, u1, v1);
-			++bf;
-
-			r = (bf[-width - 1] + bf[-width + 1] + bf[width - 1] + bf[width + 1]) >> 2;
-			g = (bf[-width] + bf[1] + bf[width] + bf[-1]) >> 2;
-			RGB2YUV(r, g, *bf, y2, u2, v2);
-			++bf;
-
-			assign(y, u, v, y1, u1, v1, y2, u2, v2);
-		}
-
-		r = (bf[width] + bf[-width]) >> 1;
-		b = (bf[-1] + bf[1]) >> 1;
-		RGB2YUV(r, *bf, b, y1, u1, v1);
-		++bf;
-
-		r = (bf[-width - 1] + bf[width - 1]) >> 1;
-		// correct: g = (bf[-width] + bf[width] + bf[-1]) / 3;
-		// faster:
-		g = (bf[-width] + bf[-1]) >> 1;
-		RGB2YUV(r, g, *bf, y2, u2, v2);
-		++bf;
-
 		assign(y, u, v, y1, u1, v1, y2, u2, v2);
 	}
+}
 
-	// last r  g  ... line
-	// correct: g = (bf[-width] + bf[1] + bf[width]) / 3;
-	// faster:
-	g = (bf[-width] + bf[1]) >> 1;
-	b = bf[-width + 1];
-	RGB2YUV(*bf, g, b, y1, u1, v1);
-	++bf;
-
-	r = (bf[-1] + bf[1]) >> 1;
-	b = bf[-width];
-	RGB2YUV(r, g, *bf, y2, u2, v2);
-	++bf;
-
-	assign(y, u, v, y1, u1, v1, y2, u2, v2);
-
-	for (unsigned int w = 2; w < width - 2; w += 2) {
-		// correct: g = (bf[-width] + bf[1] + bf[-1]) / 3
-		// faster:
-		g = (bf[-width] + bf[-1]) >> 1;
-		b = (bf[-width - 1] + bf[-width + 1]) >> 1;
-		RGB2YUV(*bf, g, b, y1, u1, v1);
-		++bf;
-
-		r = (bf[-1] + bf[1]) >> 1;
-		b = bf[-width];
-		RGB2YUV(r, *bf, b, y2, u2, v2);
-		++bf;
-
-		assign(y, u, v, y1, u1, v1, y2, u2, v2);
+void
+bayerGBRG_to_yuv422planar_bilinear(const unsigned char *bayer,
+                                   unsigned char *      yuv,
+                                   unsigned int         width,
+                                   unsigned int         height)
+{
+	for (unsigned int h = 0; h < height; ++h) {
+		bayerGBRG_to_yuv422planar_bilinear_line(bayer, yuv, width, height, h, 0, width);
 	}
-
-	// correct: g = (bf[-width] + bf[1] + bf[-1]) / 3;
-	// faster:
-	g = (bf[-width] + bf[-1]) >> 1;
-	b = (bf[-width - 1] + bf[-width + 1]) >> 1;
-	RGB2YUV(*bf, g, b, y1, u1, v1);
-	++bf;
-
-	b = bf[-width];
-	RGB2YUV(bf[-1], *bf, b, y2, u2, v2);
-	++bf;
-
-	assign(y, u, v, y1, u1, v1, y2, u2, v2);
 }
 
 void
@@ -548,22 +544,38 @@ bayerGBRG_to_yuv422planar_bilinear2(const unsigned char *bayer, unsigned char *y
 }
 */
 
+/** Convert part of a line of a GRBG Bayer mosaic to planar YUV422.
+ * Converts the pixels [col_begin, col_end) of the given line taking the
+ * missing colors from the nearest neighbours. Lines may be converted in
+ * any order and concurrently.
+ * @param bayer Bayer mosaic of the whole image
+ * @param yuv planar YUV422 buffer of the whole image
+ * @param width width of image in pixels, must be even
+ * @param height height of image in pixels, must be even
+ * @param line line to convert
+ * @param col_begin first pixel to convert, must be even
+ * @param col_end pixel after the last pixel to convert, must be even
+ */
 void
-bayerGRBG_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
-                                            unsigned char *      yuv,
-                                            unsigned int         width,
-                                            unsigned int         height)
+bayerGRBG_to_yuv422planar_nearest_neighbour_line(const unsigned char *bayer,
+                                                 unsigned char *      yuv,
+                                                 unsigned int         width,
+                                                 unsigned int         height,
+                                                 unsigned int         line,
+                                                 unsigned int         col_begin,
+                                                 unsigned int         col_end)
 {
-	unsigned char *      y = yuv;
-	unsigned char *      u = YUV422_PLANAR_U_PLANE(yuv, width, height);
-	unsigned char *      v = YUV422_PLANAR_V_PLANE(yuv, width, height);
-	const unsigned char *b = bayer;
+	const size_t         offset = (size_t)width * line + col_begin;
+	unsigned char *      y      = yuv + offset;
+	unsigned char *      u      = YUV422_PLANAR_U_PLANE(yuv, width, height) + offset / 2;
+	unsigned char *      v      = YUV422_PLANAR_V_PLANE(yuv, width, height) + offset / 2;
+	const unsigned char *b      = bayer + offset;
 
 	int y1, u1, v1, y2, u2, v2;
 
-	for (unsigned int h = 0; h < height; h += 2) {
+	if (line % 2 == 0) {
 		// g  r  ... line
-		for (unsigned int w = 0; w < width; w += 2) {
+		for (unsigned int w = col_begin; w < col_end; w += 2) {
 			RGB2YUV(b[1], b[width], *b, y1, u1, v1);
 			++b;
 
@@ -572,9 +584,9 @@ bayerGRBG_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
 
 			assign(y, u, v, y1, u1, v1, y2, u2, v2);
 		}
-
+	} else {
 		// b  g  ... line
-		for (unsigned int w = 0; w < width; w += 2) {
+		for (unsigned int w = col_begin; w < col_end; w += 2) {
 			RGB2YUV(*(b - width + 1), b[1], *b, y1, u1, v1);
 			++b;
 
@@ -586,6 +598,17 @@ bayerGRBG_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
 	}
 }
 
+void
+bayerGRBG_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
+                                            unsigned char *      yuv,
+                                            unsigned int         width,
+                                            unsigned int         height)
+{
+	for (unsigned int h = 0; h < height; ++h) {
+		bayerGRBG_to_yuv422planar_nearest_neighbour_line(bayer, yuv, width, height, h, 0, width);
+	}
+}
+
 void
 bayerRGGB_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
                                             unsigned char *      yuv,
@@ -46,6 +46,13 @@ void bayerGRBG_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
                                                  unsigned char *      yuv,
                                                  unsigned int         width,
                                                  unsigned int         height);
+void bayerGRBG_to_yuv422planar_nearest_neighbour_line(const unsigned char *bayer,
+                                                      unsigned char *      yuv,
+                                                      unsigned int         width,
+                                                      unsigned int         height,
+                                                      unsigned int         line,
+                                                      unsigned int         col_begin,
+                                                      unsigned int         col_end);
 void bayerRGGB_to_yuv422planar_nearest_neighbour(const unsigned char *bayer,
                                                  unsigned char *      yuv,
                                                  unsigned int         width,
@@ -55,6 +62,13 @@ void bayerGBRG_to_yuv422planar_bilinear(const unsigned char *bayer,
                                         unsigned char *      yuv,
                                         unsigned int         width,
                                         unsigned int         height);
+void bayerGBRG_to_yuv422planar_bilinear_line(const unsigned char *bayer,
+                                             unsigned char *      yuv,
+                                             unsigned int         width,
+                                             unsigned int         height,
+                                             unsigned int         line,
+                                             unsigned int         col_begin,
+                                             unsigned int         col_end);
 void bayerGBRG_to_yuv422planar_bilinear2(const unsigned char *bayer,
                                          unsigned char *      yuv,
                                          unsigned int         width,
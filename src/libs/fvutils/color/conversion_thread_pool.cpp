@@ -0,0 +1,160 @@
+
+/***************************************************************************
+ *  conversion_thread_pool.cpp - Threads for colorspace conversions
+ *
+ *  Created: Fri Oct 16 12:08:15 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvutils/color/conversion_thread_pool.h>
+
+#include <algorithm>
+
+namespace firevision {
+
+/** @class ConversionThreadPool <fvutils/color/conversion_thread_pool.h>
+ * Thread pool for colorspace conversions.
+ * The image is split into horizontal bands of rows of roughly equal size,
+ * one per thread, which are converted concurrently. The calling thread
+ * converts the first band itself, convert() returns when all bands have
+ * been converted. Pass the pool to firevision::convert() to use it.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param num_threads number of threads converting an image, including the
+ * calling thread, 0 to use one thread per CPU core
+ */
+ConversionThreadPool::ConversionThreadPool(unsigned int num_threads)
+{
+	if (num_threads == 0) {
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	num_threads_     = num_threads;
+	pool_generation_ = 0;
+	pool_pending_    = 0;
+	pool_quit_       = false;
+	conversion_      = NULL;
+	src_             = NULL;
+	dst_             = NULL;
+	width_           = 0;
+	height_          = 0;
+
+	for (unsigned int i = 1; i < num_threads_; ++i) {
+		workers_.push_back(std::thread(&ConversionThreadPool::worker_loop, this, i));
+	}
+}
+
+/** Destructor. */
+ConversionThreadPool::~ConversionThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex_);
+		pool_quit_ = true;
+	}
+	pool_cond_.notify_all();
+	for (std::thread &t : workers_) {
+		t.join();
+	}
+}
+
+/** Get number of threads.
+ * @return number of threads converting an image, including the calling thread
+ */
+unsigned int
+ConversionThreadPool::num_threads() const
+{
+	return num_threads_;
+}
+
+/** Convert image.
+ * The pool converts one image at a time, concurrent calls are serialized.
+ * @param conversion row conversion function
+ * @param src source buffer
+ * @param dst destination buffer
+ * @param width width of image in pixels
+ * @param height height of image in pixels
+ */
+void
+ConversionThreadPool::convert(row_conversion_t     conversion,
+                              const unsigned char *src,
+                              unsigned char *      dst,
+                              unsigned int         width,
+                              unsigned int         height)
+{
+	std::lock_guard<std::mutex> convert_lock(convert_mutex_);
+
+	if (workers_.empty()) {
+		conversion(src, dst, width, height, 0, height);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex_);
+		conversion_   = conversion;
+		src_          = src;
+		dst_          = dst;
+		width_        = width;
+		height_       = height;
+		pool_pending_ = workers_.size();
+		pool_generation_ += 1;
+	}
+	pool_cond_.notify_all();
+
+	convert_band(0);
+
+	std::unique_lock<std::mutex> lock(pool_mutex_);
+	pool_done_cond_.wait(lock, [this]() { return pool_pending_ == 0; });
+}
+
+void
+ConversionThreadPool::convert_band(unsigned int band)
+{
+	// bands start at even rows, 4:2:0 formats share chroma among two rows
+	unsigned int row_begin = (unsigned int)((unsigned long long)height_ * band / num_threads_) & ~1u;
+	unsigned int row_end =
+	  (band + 1 == num_threads_)
+	    ? height_
+	    : (unsigned int)((unsigned long long)height_ * (band + 1) / num_threads_) & ~1u;
+	if (row_begin < row_end) {
+		conversion_(src_, dst_, width_, height_, row_begin, row_end);
+	}
+}
+
+void
+ConversionThreadPool::worker_loop(unsigned int band)
+{
+	unsigned long generation = 0;
+
+	std::unique_lock<std::mutex> lock(pool_mutex_);
+	while (true) {
+		pool_cond_.wait(lock, [&]() { return pool_quit_ || pool_generation_ != generation; });
+		if (pool_quit_)
+			return;
+
+		generation = pool_generation_;
+		lock.unlock();
+		convert_band(band);
+		lock.lock();
+
+		if (--pool_pending_ == 0)
+			pool_done_cond_.notify_one();
+	}
+}
+
+} // end namespace firevision
@@ -0,0 +1,75 @@
+
+/***************************************************************************
+ *  conversion_thread_pool.h - Threads for colorspace conversions
+ *
+ *  Created: Fri Oct 16 12:08:15 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef FIREVISION_UTILS_COLOR_CONVERSION_THREAD_POOL_H_
+#define FIREVISION_UTILS_COLOR_CONVERSION_THREAD_POOL_H_
+
+#include <fvutils/color/conversions_simd.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace firevision {
+
+class ConversionThreadPool
+{
+public:
+	ConversionThreadPool(unsigned int num_threads = 0);
+	~ConversionThreadPool();
+
+	unsigned int num_threads() const;
+
+	void convert(row_conversion_t     conversion,
+	             const unsigned char *src,
+	             unsigned char *      dst,
+	             unsigned int         width,
+	             unsigned int         height);
+
+private:
+	void worker_loop(unsigned int band);
+	void convert_band(unsigned int band);
+
+private:
+	unsigned int             num_threads_;
+	std::vector<std::thread> workers_;
+
+	std::mutex              convert_mutex_;
+	std::mutex              pool_mutex_;
+	std::condition_variable pool_cond_;
+	std::condition_variable pool_done_cond_;
+	unsigned long           pool_generation_;
+	unsigned int            pool_pending_;
+	bool                    pool_quit_;
+
+	row_conversion_t     conversion_;
+	const unsigned char *src_;
+	unsigned char *      dst_;
+	unsigned int         width_;
+	unsigned int         height_;
+};
+
+} // end namespace firevision
+
+#endif
@@ -24,6 +24,8 @@
 
 #include <core/exception.h>
 #include <fvutils/color/bayer.h>
+#include <fvutils/color/conversion_thread_pool.h>
+#include <fvutils/color/conversions_simd.h>
 #include <fvutils/color/rgb.h>
 #include <fvutils/color/rgbyuv.h>
 #include <fvutils/color/yuv.h>
@@ -36,27 +38,50 @@ namespace firevision {
 /** Convert image from one colorspace to another.
  * This is a convenience method for unified access to all conversion routines
  * available in FireVision.
+ *
+ * If there is a vectorized conversion for the given SIMD extension it is
+ * used instead of the plain C conversion, it produces the same output. If
+ * a thread pool is given the image is split into bands of rows which are
+ * converted concurrently, this works for vectorized conversions only.
  * @param from colorspace of the src buffer
  * @param to colorspace to convert to
  * @param src source buffer
  * @param dst destination buffer
  * @param width width of image in pixels
  * @param height height of image in pixels
+ * @param pool thread pool to convert bands of the image concurrently,
+ * NULL to convert in the calling thread only
+ * @param simd SIMD extension to use, defaults to the best one supported by
+ * the CPU, CPU_SIMD_NONE to always use the plain C conversions
  * @exception Exception thrown, if the desired conversion combination is not
  * available.
  */
 void
-convert(colorspace_t         from,
-        colorspace_t         to,
-        const unsigned char *src,
-        unsigned char *      dst,
-        unsigned int         width,
-        unsigned int         height)
+convert(colorspace_t          from,
+        colorspace_t          to,
+        const unsigned char * src,
+        unsigned char *       dst,
+        unsigned int          width,
+        unsigned int          height,
+        ConversionThreadPool *pool,
+        cpu_simd_t            simd)
 {
+	// the vectorized conversions work on complete macro pixels per row
+	row_conversion_t row_conv = NULL;
+	if ((from != to) && (width % 2 == 0)) {
+		row_conv = row_conversion(from, to, simd);
+	}
+
 	if (from == to) {
 		if (src != dst) {
 			memcpy(dst, src, colorspace_buffer_size(from, width, height));
 		}
+	} else if (row_conv) {
+		if (pool) {
+			pool->convert(row_conv, src, dst, width, height);
+		} else {
+			row_conv(src, dst, width, height, 0, height);
+		}
 	} else if ((from == YUV422_PACKED) && (to == YUV422_PLANAR)) {
 		yuv422packed_to_yuv422planar(src, dst, width, height);
 	} else if ((from == YUY2) && (to == YUV422_PLANAR_QUARTER)) {
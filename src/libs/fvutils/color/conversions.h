@@ -26,15 +26,22 @@
 #define FIREVISION_UTILS_COLOR_CONVERSIONS_H_
 
 #include <fvutils/color/colorspaces.h>
+#include <fvutils/cpu/simd.h>
+
+#include <cstddef>
 
 namespace firevision {
 
-extern void convert(colorspace_t         from,
-                    colorspace_t         to,
-                    const unsigned char *src,
-                    unsigned char *      dst,
-                    unsigned int         width,
-                    unsigned int         height);
+class ConversionThreadPool;
+
+extern void convert(colorspace_t          from,
+                    colorspace_t          to,
+                    const unsigned char * src,
+                    unsigned char *       dst,
+                    unsigned int          width,
+                    unsigned int          height,
+                    ConversionThreadPool *pool = NULL,
+                    cpu_simd_t            simd = cpu_simd_support());
 
 extern void grayscale(colorspace_t   cspace,
                       unsigned char *src,
@@ -0,0 +1,1383 @@
+
+/***************************************************************************
+ *  conversions_simd.cpp - Vectorized colorspace conversions
+ *
+ *  Created: Fri Oct 16 11:21:37 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvutils/color/bayer.h>
+#include <fvutils/color/conversions_simd.h>
+#include <fvutils/color/rgbyuv.h>
+#include <fvutils/color/yuvrgb.h>
+
+#include <cstddef>
+
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#	if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+// AVX2 kernels are compiled for the AVX2 target only and selected at
+// run-time, the rest of the library does not require AVX2
+#		define HAVE_AVX2_CONVERSIONS
+#		define AVX2_TARGET __attribute__((target("avx2")))
+#		include <immintrin.h>
+#	endif
+#endif
+#ifdef __ARM_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace firevision {
+
+/// @cond INTERNALS
+
+// All kernels produce exactly the same output as the corresponding plain C
+// functions. For YUV to RGB the fixed point formula of pixel_yuv_to_rgb()
+// is evaluated with 32 bit integers. The coefficients do not fit into 16 bit
+// multiplications, therefore they are split as
+//   76284 * y  = 2 * (19071 * y + 19071 * y)
+//   104595 * v = (v << 17) - 26477 * v
+//   -25625 * u - 53281 * v = -25625 * u + 12255 * v - (v << 16)
+//   132252 * u = (u << 17) + 1180 * u
+// For RGB to YUV the formula of RGB2YUV() fits into 16 bit multiplications
+// with 32 bit sums. The results are always within [0, 255], the chroma of
+// two pixels is averaged as by the plain C functions.
+//
+// The Bayer kernels vectorize the inner pixels of the inner rows and use
+// the line functions of the plain C conversions for the borders. Other
+// Bayer patterns and interpolations are not available through convert()
+// and stay scalar. RGB to YUV411 packed stays scalar as its plain C
+// function accesses memory outside of the image. RGB to YUV and Bayer are
+// SSE2 only, AVX2 uses the SSE2 kernels and NEON the plain C functions.
+
+typedef enum { OUT_RGB, OUT_BGR, OUT_RGBA, OUT_BGRA } rgb_layout_t;
+typedef enum { IN_UYVY, IN_YUY2, IN_YVY2 } packed_layout_t;
+
+#define PIXEL_SIZE(L) ((((L) == OUT_RGBA) || ((L) == OUT_BGRA)) ? 4 : 3)
+#define RGB_ORDER(L) ((((L) == OUT_RGB) || ((L) == OUT_RGBA)))
+#define HAS_ALPHA(L) ((((L) == OUT_RGBA) || ((L) == OUT_BGRA)))
+
+// byte offsets of a macro pixel in the packed formats
+#define PACKED_Y0(F) (((F) == IN_UYVY) ? 1 : 0)
+#define PACKED_Y1(F) (((F) == IN_UYVY) ? 3 : 2)
+#define PACKED_U(F) (((F) == IN_UYVY) ? 0 : (((F) == IN_YUY2) ? 1 : 3))
+#define PACKED_V(F) (((F) == IN_UYVY) ? 2 : (((F) == IN_YUY2) ? 3 : 1))
+
+typedef struct
+{
+	colorspace_t     from;       ///< source colorspace
+	colorspace_t     to;         ///< destination colorspace
+	row_conversion_t conversion; ///< row conversion function
+} row_conversion_entry_t;
+
+/* Plain C, used for the pixels at the end of a row which do not fill
+ * a complete SIMD register. */
+
+template <int L>
+static inline void
+store_pixel(unsigned char *d, unsigned char y, unsigned char u, unsigned char v)
+{
+	unsigned char r, g, b;
+	pixel_yuv_to_rgb(y, u, v, &r, &g, &b);
+	d[0] = RGB_ORDER(L) ? r : b;
+	d[1] = g;
+	d[2] = RGB_ORDER(L) ? b : r;
+	if (HAS_ALPHA(L))
+		d[3] = 255;
+}
+
+template <int L>
+static inline void
+yuv422planar_to_rgb_tail(const unsigned char *yp,
+                         const unsigned char *up,
+                         const unsigned char *vp,
+                         unsigned char *      d,
+                         unsigned int         x,
+                         unsigned int         width)
+{
+	for (; x < width; x += 2) {
+		store_pixel<L>(d + x * PIXEL_SIZE(L), yp[x], up[x / 2], vp[x / 2]);
+		store_pixel<L>(d + (x + 1) * PIXEL_SIZE(L), yp[x + 1], up[x / 2], vp[x / 2]);
+	}
+}
+
+template <int F, int L>
+static inline void
+packed_to_rgb_tail(const unsigned char *s, unsigned char *d, unsigned int x, unsigned int width)
+{
+	for (; x < width; x += 2) {
+		const unsigned char *m = s + 2 * x;
+		store_pixel<L>(d + x * PIXEL_SIZE(L), m[PACKED_Y0(F)], m[PACKED_U(F)], m[PACKED_V(F)]);
+		store_pixel<L>(d + (x + 1) * PIXEL_SIZE(L), m[PACKED_Y1(F)], m[PACKED_U(F)], m[PACKED_V(F)]);
+	}
+}
+
+template <int F>
+static inline void
+packed_to_planar_tail(const unsigned char *s,
+                      unsigned char *      yp,
+                      unsigned char *      up,
+                      unsigned char *      vp,
+                      unsigned int         x,
+                      unsigned int         width)
+{
+	for (; x < width; x += 2) {
+		const unsigned char *m = s + 2 * x;
+		yp[x]                  = m[PACKED_Y0(F)];
+		yp[x + 1]              = m[PACKED_Y1(F)];
+		up[x / 2]              = m[PACKED_U(F)];
+		vp[x / 2]              = m[PACKED_V(F)];
+	}
+}
+
+static inline void
+yuv422planar_to_yuv422packed_tail(const unsigned char *yp,
+                                  const unsigned char *up,
+                                  const unsigned char *vp,
+                                  unsigned char *      d,
+                                  unsigned int         x,
+                                  unsigned int         width)
+{
+	for (; x < width; x += 2) {
+		d[2 * x]     = up[x / 2];
+		d[2 * x + 1] = yp[x];
+		d[2 * x + 2] = vp[x / 2];
+		d[2 * x + 3] = yp[x + 1];
+	}
+}
+
+static inline void
+bgr_to_rgb_tail(const unsigned char *s, unsigned char *d, unsigned int x, unsigned int width)
+{
+	for (; x < width; ++x) {
+		unsigned char b = s[3 * x];
+		d[3 * x + 1]    = s[3 * x + 1];
+		d[3 * x]        = s[3 * x + 2];
+		d[3 * x + 2]    = b;
+	}
+}
+
+template <int L>
+static inline void
+rgb_to_yuv422planar_tail(const unsigned char *s,
+                         unsigned char *      yp,
+                         unsigned char *      up,
+                         unsigned char *      vp,
+                         unsigned int         x,
+                         unsigned int         width)
+{
+	int y1, u1, v1, y2, u2, v2;
+	for (; x < width; x += 2) {
+		const unsigned char *p = s + 3 * x;
+		RGB2YUV(p[RGB_ORDER(L) ? 0 : 2], p[1], p[RGB_ORDER(L) ? 2 : 0], y1, u1, v1);
+		RGB2YUV(p[RGB_ORDER(L) ? 3 : 5], p[4], p[RGB_ORDER(L) ? 5 : 3], y2, u2, v2);
+		yp[x]     = y1;
+		yp[x + 1] = y2;
+		up[x / 2] = (u1 + u2) / 2;
+		vp[x / 2] = (v1 + v2) / 2;
+	}
+}
+
+static inline void
+rgb_to_yuv422packed_tail(const unsigned char *s,
+                         unsigned char *      d,
+                         unsigned int         x,
+                         unsigned int         width)
+{
+	int y1, u1, v1, y2, u2, v2;
+	for (; x < width; x += 2) {
+		const unsigned char *p = s + 3 * x;
+		RGB2YUV(p[0], p[1], p[2], y1, u1, v1);
+		RGB2YUV(p[3], p[4], p[5], y2, u2, v2);
+		d[2 * x]     = (u1 + u2) / 2;
+		d[2 * x + 1] = y1;
+		d[2 * x + 2] = (v1 + v2) / 2;
+		d[2 * x + 3] = y2;
+	}
+}
+
+/* Row pointers, bands always consist of complete rows */
+#define PLANAR_Y_ROW(buf, width, height, row) ((buf) + (size_t)(width) * (row))
+#define PLANAR_U_ROW(buf, width, height, row) \
+	((buf) + (size_t)(width) * (height) + (size_t)(width) / 2 * (row))
+#define PLANAR_V_ROW(buf, width, height, row) \
+	(PLANAR_U_ROW(buf, width, height, row) + (size_t)(width) * (height) / 2)
+#define PACKED_ROW(buf, width, row) ((buf) + (size_t)(width) * 2 * (row))
+
+#ifdef __SSE2__
+
+static inline __m128i
+coef_pair_sse2(short cu, short cv)
+{
+	return _mm_setr_epi16(cu, cv, cu, cv, cu, cv, cu, cv);
+}
+
+/* One color channel of 16 pixels. y0 to y3 contain the luma terms of four
+ * pixels each, c_lo and c_hi the chroma terms of four chroma samples each,
+ * every chroma sample is shared by two successive pixels. */
+static inline __m128i
+channel_sse2(__m128i y0, __m128i y1, __m128i y2, __m128i y3, __m128i c_lo, __m128i c_hi)
+{
+	__m128i p0 = _mm_srai_epi32(_mm_add_epi32(y0, _mm_unpacklo_epi32(c_lo, c_lo)), 16);
+	__m128i p1 = _mm_srai_epi32(_mm_add_epi32(y1, _mm_unpackhi_epi32(c_lo, c_lo)), 16);
+	__m128i p2 = _mm_srai_epi32(_mm_add_epi32(y2, _mm_unpacklo_epi32(c_hi, c_hi)), 16);
+	__m128i p3 = _mm_srai_epi32(_mm_add_epi32(y3, _mm_unpackhi_epi32(c_hi, c_hi)), 16);
+	return _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+}
+
+/* Convert 16 pixels, y8 contains 16 luma bytes, u16 and v16 eight chroma
+ * samples as 16 bit values each. */
+static inline void
+yuv_to_rgb_sse2(__m128i y8, __m128i u16, __m128i v16, __m128i &r, __m128i &g, __m128i &b)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i cy   = _mm_set1_epi16(19071);
+
+	__m128i ylo = _mm_sub_epi16(_mm_unpacklo_epi8(y8, zero), _mm_set1_epi16(16));
+	__m128i yhi = _mm_sub_epi16(_mm_unpackhi_epi8(y8, zero), _mm_set1_epi16(16));
+	__m128i y0  = _mm_slli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(ylo, ylo), cy), 1);
+	__m128i y1  = _mm_slli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(ylo, ylo), cy), 1);
+	__m128i y2  = _mm_slli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(yhi, yhi), cy), 1);
+	__m128i y3  = _mm_slli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(yhi, yhi), cy), 1);
+
+	__m128i u     = _mm_sub_epi16(u16, _mm_set1_epi16(128));
+	__m128i v     = _mm_sub_epi16(v16, _mm_set1_epi16(128));
+	__m128i uv_lo = _mm_unpacklo_epi16(u, v);
+	__m128i uv_hi = _mm_unpackhi_epi16(u, v);
+	// u << 16 and v << 16 as 32 bit values
+	__m128i u_lo = _mm_unpacklo_epi16(zero, u);
+	__m128i u_hi = _mm_unpackhi_epi16(zero, u);
+	__m128i v_lo = _mm_unpacklo_epi16(zero, v);
+	__m128i v_hi = _mm_unpackhi_epi16(zero, v);
+
+	const __m128i cr = coef_pair_sse2(0, -26477);
+	const __m128i cg = coef_pair_sse2(-25625, 12255);
+	const __m128i cb = coef_pair_sse2(1180, 0);
+
+	r = channel_sse2(y0,
+	                 y1,
+	                 y2,
+	                 y3,
+	                 _mm_add_epi32(_mm_slli_epi32(v_lo, 1), _mm_madd_epi16(uv_lo, cr)),
+	                 _mm_add_epi32(_mm_slli_epi32(v_hi, 1), _mm_madd_epi16(uv_hi, cr)));
+	g = channel_sse2(y0,
+	                 y1,
+	                 y2,
+	                 y3,
+	                 _mm_sub_epi32(_mm_madd_epi16(uv_lo, cg), v_lo),
+	                 _mm_sub_epi32(_mm_madd_epi16(uv_hi, cg), v_hi));
+	b = channel_sse2(y0,
+	                 y1,
+	                 y2,
+	                 y3,
+	                 _mm_add_epi32(_mm_slli_epi32(u_lo, 1), _mm_madd_epi16(uv_lo, cb)),
+	                 _mm_add_epi32(_mm_slli_epi32(u_hi, 1), _mm_madd_epi16(uv_hi, cb)));
+}
+
+/* Compact four 32 bit pixels to 12 bytes, upper four bytes are zero. */
+static inline __m128i
+pack24_sse2(__m128i p)
+{
+	const __m128i m0 = _mm_setr_epi32(0x00ffffff, 0, 0, 0);
+	const __m128i m1 = _mm_setr_epi32(0, 0x00ffffff, 0, 0);
+	const __m128i m2 = _mm_setr_epi32(0, 0, 0x00ffffff, 0);
+	const __m128i m3 = _mm_setr_epi32(0, 0, 0, 0x00ffffff);
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(p, m0), _mm_srli_si128(_mm_and_si128(p, m1), 1)),
+	                    _mm_or_si128(_mm_srli_si128(_mm_and_si128(p, m2), 2),
+	                                 _mm_srli_si128(_mm_and_si128(p, m3), 3)));
+}
+
+/* Interleave and store 16 pixels. */
+template <int L>
+static inline void
+store_rgb_sse2(unsigned char *d, __m128i r, __m128i g, __m128i b)
+{
+	__m128i c0 = RGB_ORDER(L) ? r : b;
+	__m128i c2 = RGB_ORDER(L) ? b : r;
+	__m128i a  = HAS_ALPHA(L) ? _mm_set1_epi8(-1) : _mm_setzero_si128();
+
+	__m128i c0g_lo = _mm_unpacklo_epi8(c0, g);
+	__m128i c0g_hi = _mm_unpackhi_epi8(c0, g);
+	__m128i c2a_lo = _mm_unpacklo_epi8(c2, a);
+	__m128i c2a_hi = _mm_unpackhi_epi8(c2, a);
+	__m128i p0     = _mm_unpacklo_epi16(c0g_lo, c2a_lo);
+	__m128i p1     = _mm_unpackhi_epi16(c0g_lo, c2a_lo);
+	__m128i p2     = _mm_unpacklo_epi16(c0g_hi, c2a_hi);
+	__m128i p3     = _mm_unpackhi_epi16(c0g_hi, c2a_hi);
+
+	if (HAS_ALPHA(L)) {
+		_mm_storeu_si128((__m128i *)d, p0);
+		_mm_storeu_si128((__m128i *)(d + 16), p1);
+		_mm_storeu_si128((__m128i *)(d + 32), p2);
+		_mm_storeu_si128((__m128i *)(d + 48), p3);
+	} else {
+		p0 = pack24_sse2(p0);
+		p1 = pack24_sse2(p1);
+		p2 = pack24_sse2(p2);
+		p3 = pack24_sse2(p3);
+		_mm_storeu_si128((__m128i *)d, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+		_mm_storeu_si128((__m128i *)(d + 16),
+		                 _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+		_mm_storeu_si128((__m128i *)(d + 32),
+		                 _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+	}
+}
+
+/* Split 16 packed pixels into luma bytes and 16 bit chroma samples. */
+template <int F>
+static inline void
+load_packed_sse2(const unsigned char *s, __m128i &y8, __m128i &u16, __m128i &v16)
+{
+	const __m128i lo_mask = _mm_set1_epi16(0x00ff);
+
+	__m128i a = _mm_loadu_si128((const __m128i *)s);
+	__m128i b = _mm_loadu_si128((const __m128i *)(s + 16));
+	__m128i c;
+	if (F == IN_UYVY) {
+		y8 = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+		c  = _mm_packus_epi16(_mm_and_si128(a, lo_mask), _mm_and_si128(b, lo_mask));
+	} else {
+		y8 = _mm_packus_epi16(_mm_and_si128(a, lo_mask), _mm_and_si128(b, lo_mask));
+		c  = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+	}
+	if (F == IN_YVY2) {
+		v16 = _mm_and_si128(c, lo_mask);
+		u16 = _mm_srli_epi16(c, 8);
+	} else {
+		u16 = _mm_and_si128(c, lo_mask);
+		v16 = _mm_srli_epi16(c, 8);
+	}
+}
+
+template <int L>
+static void
+yuv422planar_to_rgb_sse2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height,
+                         unsigned int         row_begin,
+                         unsigned int         row_end)
+{
+	const __m128i zero = _mm_setzero_si128();
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *yp = PLANAR_Y_ROW(src, width, height, row);
+		const unsigned char *up = PLANAR_U_ROW(src, width, height, row);
+		const unsigned char *vp = PLANAR_V_ROW(src, width, height, row);
+		unsigned char *      d  = dst + (size_t)width * PIXEL_SIZE(L) * row;
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i r, g, b;
+			__m128i y8  = _mm_loadu_si128((const __m128i *)(yp + x));
+			__m128i u16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(up + x / 2)), zero);
+			__m128i v16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(vp + x / 2)), zero);
+			yuv_to_rgb_sse2(y8, u16, v16, r, g, b);
+			store_rgb_sse2<L>(d + x * PIXEL_SIZE(L), r, g, b);
+		}
+		yuv422planar_to_rgb_tail<L>(yp, up, vp, d, x, width);
+	}
+}
+
+template <int F, int L>
+static void
+packed_to_rgb_sse2(const unsigned char *src,
+                   unsigned char *      dst,
+                   unsigned int         width,
+                   unsigned int         height,
+                   unsigned int         row_begin,
+                   unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s = PACKED_ROW(src, width, row);
+		unsigned char *      d = dst + (size_t)width * PIXEL_SIZE(L) * row;
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i y8, u16, v16, r, g, b;
+			load_packed_sse2<F>(s + 2 * x, y8, u16, v16);
+			yuv_to_rgb_sse2(y8, u16, v16, r, g, b);
+			store_rgb_sse2<L>(d + x * PIXEL_SIZE(L), r, g, b);
+		}
+		packed_to_rgb_tail<F, L>(s, d, x, width);
+	}
+}
+
+template <int F>
+static void
+packed_to_yuv422planar_sse2(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height,
+                            unsigned int         row_begin,
+                            unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s  = PACKED_ROW(src, width, row);
+		unsigned char *      yp = PLANAR_Y_ROW(dst, width, height, row);
+		unsigned char *      up = PLANAR_U_ROW(dst, width, height, row);
+		unsigned char *      vp = PLANAR_V_ROW(dst, width, height, row);
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i y8, u16, v16;
+			load_packed_sse2<F>(s + 2 * x, y8, u16, v16);
+			__m128i uv8 = _mm_packus_epi16(u16, v16);
+			_mm_storeu_si128((__m128i *)(yp + x), y8);
+			_mm_storel_epi64((__m128i *)(up + x / 2), uv8);
+			_mm_storel_epi64((__m128i *)(vp + x / 2), _mm_srli_si128(uv8, 8));
+		}
+		packed_to_planar_tail<F>(s, yp, up, vp, x, width);
+	}
+}
+
+static void
+yuv422planar_to_yuv422packed_sse2(const unsigned char *src,
+                                  unsigned char *      dst,
+                                  unsigned int         width,
+                                  unsigned int         height,
+                                  unsigned int         row_begin,
+                                  unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *yp = PLANAR_Y_ROW(src, width, height, row);
+		const unsigned char *up = PLANAR_U_ROW(src, width, height, row);
+		const unsigned char *vp = PLANAR_V_ROW(src, width, height, row);
+		unsigned char *      d  = PACKED_ROW(dst, width, row);
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i y8 = _mm_loadu_si128((const __m128i *)(yp + x));
+			__m128i uv = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(up + x / 2)),
+			                               _mm_loadl_epi64((const __m128i *)(vp + x / 2)));
+			_mm_storeu_si128((__m128i *)(d + 2 * x), _mm_unpacklo_epi8(uv, y8));
+			_mm_storeu_si128((__m128i *)(d + 2 * x + 16), _mm_unpackhi_epi8(uv, y8));
+		}
+		yuv422planar_to_yuv422packed_tail(yp, up, vp, d, x, width);
+	}
+}
+
+/* RGB2YUV() of eight pixels given as 16 bit values. Returns the luma as
+ * 16 bit values and the chroma of each pair of pixels averaged as 32 bit
+ * values. */
+static inline void
+rgb_to_yuv_sse2(__m128i r, __m128i g, __m128i b, __m128i &y16, __m128i &u32, __m128i &v32)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i c128 = _mm_set1_epi32(128);
+	const __m128i ones = _mm_set1_epi16(1);
+
+	__m128i rg_lo = _mm_unpacklo_epi16(r, g);
+	__m128i rg_hi = _mm_unpackhi_epi16(r, g);
+	__m128i b_lo  = _mm_unpacklo_epi16(b, zero);
+	__m128i b_hi  = _mm_unpackhi_epi16(b, zero);
+
+	const __m128i cy_rg = coef_pair_sse2(306, 601);
+	const __m128i cy_b  = coef_pair_sse2(117, 0);
+	const __m128i cu_rg = coef_pair_sse2(-172, -340);
+	const __m128i cu_b  = coef_pair_sse2(512, 0);
+	const __m128i cv_rg = coef_pair_sse2(512, -429);
+	const __m128i cv_b  = coef_pair_sse2(-83, 0);
+
+	__m128i y_lo = _mm_add_epi32(_mm_madd_epi16(rg_lo, cy_rg), _mm_madd_epi16(b_lo, cy_b));
+	__m128i y_hi = _mm_add_epi32(_mm_madd_epi16(rg_hi, cy_rg), _mm_madd_epi16(b_hi, cy_b));
+	__m128i u_lo = _mm_add_epi32(_mm_madd_epi16(rg_lo, cu_rg), _mm_madd_epi16(b_lo, cu_b));
+	__m128i u_hi = _mm_add_epi32(_mm_madd_epi16(rg_hi, cu_rg), _mm_madd_epi16(b_hi, cu_b));
+	__m128i v_lo = _mm_add_epi32(_mm_madd_epi16(rg_lo, cv_rg), _mm_madd_epi16(b_lo, cv_b));
+	__m128i v_hi = _mm_add_epi32(_mm_madd_epi16(rg_hi, cv_rg), _mm_madd_epi16(b_hi, cv_b));
+
+	y16 = _mm_packs_epi32(_mm_srai_epi32(y_lo, 10), _mm_srai_epi32(y_hi, 10));
+	__m128i u16 = _mm_packs_epi32(_mm_add_epi32(_mm_srai_epi32(u_lo, 10), c128),
+	                              _mm_add_epi32(_mm_srai_epi32(u_hi, 10), c128));
+	__m128i v16 = _mm_packs_epi32(_mm_add_epi32(_mm_srai_epi32(v_lo, 10), c128),
+	                              _mm_add_epi32(_mm_srai_epi32(v_hi, 10), c128));
+	u32 = _mm_srli_epi32(_mm_madd_epi16(u16, ones), 1);
+	v32 = _mm_srli_epi32(_mm_madd_epi16(v16, ones), 1);
+}
+
+/* Convert 16 pixels given as 16 bit values, lo contains the first eight
+ * pixels, hi the last eight. Returns 16 luma bytes, and eight chroma bytes
+ * each in the lower half of u8 and v8. */
+static inline void
+rgb16_to_yuv422_sse2(__m128i  r_lo,
+                     __m128i  g_lo,
+                     __m128i  b_lo,
+                     __m128i  r_hi,
+                     __m128i  g_hi,
+                     __m128i  b_hi,
+                     __m128i &y8,
+                     __m128i &u8,
+                     __m128i &v8)
+{
+	__m128i y_lo, u_lo, v_lo, y_hi, u_hi, v_hi;
+	rgb_to_yuv_sse2(r_lo, g_lo, b_lo, y_lo, u_lo, v_lo);
+	rgb_to_yuv_sse2(r_hi, g_hi, b_hi, y_hi, u_hi, v_hi);
+	y8 = _mm_packus_epi16(y_lo, y_hi);
+	u8 = _mm_packus_epi16(_mm_packs_epi32(u_lo, u_hi), _mm_setzero_si128());
+	v8 = _mm_packus_epi16(_mm_packs_epi32(v_lo, v_hi), _mm_setzero_si128());
+}
+
+/* Expand four 24 bit pixels in the lower 12 bytes to 32 bit pixels. */
+static inline __m128i
+unpack24_sse2(__m128i p)
+{
+	const __m128i m0 = _mm_setr_epi32(0x00ffffff, 0, 0, 0);
+	const __m128i m1 = _mm_setr_epi32(0, 0x00ffffff, 0, 0);
+	const __m128i m2 = _mm_setr_epi32(0, 0, 0x00ffffff, 0);
+	const __m128i m3 = _mm_setr_epi32(0, 0, 0, 0x00ffffff);
+	return _mm_or_si128(_mm_or_si128(_mm_and_si128(p, m0), _mm_and_si128(_mm_slli_si128(p, 1), m1)),
+	                    _mm_or_si128(_mm_and_si128(_mm_slli_si128(p, 2), m2),
+	                                 _mm_and_si128(_mm_slli_si128(p, 3), m3)));
+}
+
+/* Load 16 pixels of three bytes each and split them into 16 bit values of
+ * the first, second, and third channel. */
+static inline void
+load_rgb_sse2(const unsigned char *s, __m128i c16[3][2])
+{
+	const __m128i mask = _mm_set1_epi32(0xff);
+
+	__m128i p[4];
+	p[0] = unpack24_sse2(_mm_loadu_si128((const __m128i *)s));
+	p[1] = unpack24_sse2(_mm_loadu_si128((const __m128i *)(s + 12)));
+	p[2] = unpack24_sse2(_mm_loadu_si128((const __m128i *)(s + 24)));
+	p[3] = unpack24_sse2(_mm_srli_si128(_mm_loadu_si128((const __m128i *)(s + 32)), 4));
+	for (unsigned int c = 0; c < 3; ++c) {
+		for (unsigned int h = 0; h < 2; ++h) {
+			c16[c][h] = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p[2 * h], 8 * c), mask),
+			                            _mm_and_si128(_mm_srli_epi32(p[2 * h + 1], 8 * c), mask));
+		}
+	}
+}
+
+template <int L>
+static void
+rgb_to_yuv422planar_sse2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height,
+                         unsigned int         row_begin,
+                         unsigned int         row_end)
+{
+	const unsigned int r = RGB_ORDER(L) ? 0 : 2;
+	const unsigned int b = RGB_ORDER(L) ? 2 : 0;
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s  = src + (size_t)width * 3 * row;
+		unsigned char *      yp = PLANAR_Y_ROW(dst, width, height, row);
+		unsigned char *      up = PLANAR_U_ROW(dst, width, height, row);
+		unsigned char *      vp = PLANAR_V_ROW(dst, width, height, row);
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i c16[3][2], y8, u8, v8;
+			load_rgb_sse2(s + 3 * x, c16);
+			rgb16_to_yuv422_sse2(
+			  c16[r][0], c16[1][0], c16[b][0], c16[r][1], c16[1][1], c16[b][1], y8, u8, v8);
+			_mm_storeu_si128((__m128i *)(yp + x), y8);
+			_mm_storel_epi64((__m128i *)(up + x / 2), u8);
+			_mm_storel_epi64((__m128i *)(vp + x / 2), v8);
+		}
+		rgb_to_yuv422planar_tail<L>(s, yp, up, vp, x, width);
+	}
+}
+
+static void
+rgb_to_yuv422packed_sse2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height,
+                         unsigned int         row_begin,
+                         unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s = src + (size_t)width * 3 * row;
+		unsigned char *      d = PACKED_ROW(dst, width, row);
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			__m128i c16[3][2], y8, u8, v8;
+			load_rgb_sse2(s + 3 * x, c16);
+			rgb16_to_yuv422_sse2(
+			  c16[0][0], c16[1][0], c16[2][0], c16[0][1], c16[1][1], c16[2][1], y8, u8, v8);
+			__m128i uv = _mm_unpacklo_epi8(u8, v8);
+			_mm_storeu_si128((__m128i *)(d + 2 * x), _mm_unpacklo_epi8(uv, y8));
+			_mm_storeu_si128((__m128i *)(d + 2 * x + 16), _mm_unpackhi_epi8(uv, y8));
+		}
+		rgb_to_yuv422packed_tail(s, d, x, width);
+	}
+}
+
+/* 3x3 neighbourhood of eight pixels of a Bayer mosaic as 16 bit values,
+ * n, c, and s are the rows above, at, and below the pixels, l and r the
+ * left and right neighbours. */
+typedef struct
+{
+	__m128i nl, n, nr; ///< row above
+	__m128i cl, c, cr; ///< current row
+	__m128i sl, s, sr; ///< row below
+} bayer_block_sse2_t;
+
+/* Load 16 pixels at p as 16 bit values, eight into lo and eight into hi. */
+static inline void
+load_bayer_sse2(const unsigned char *p, __m128i &lo, __m128i &hi)
+{
+	__m128i v = _mm_loadu_si128((const __m128i *)p);
+	lo        = _mm_unpacklo_epi8(v, _mm_setzero_si128());
+	hi        = _mm_unpackhi_epi8(v, _mm_setzero_si128());
+}
+
+/* Load the neighbourhood of 16 pixels of the row at c. Neighbours which
+ * are not used by the interpolation are optimized away after inlining. */
+static inline void
+load_bayer_sse2(const unsigned char *c, unsigned int width, bayer_block_sse2_t bb[2])
+{
+	load_bayer_sse2(c - width - 1, bb[0].nl, bb[1].nl);
+	load_bayer_sse2(c - width, bb[0].n, bb[1].n);
+	load_bayer_sse2(c - width + 1, bb[0].nr, bb[1].nr);
+	load_bayer_sse2(c - 1, bb[0].cl, bb[1].cl);
+	load_bayer_sse2(c, bb[0].c, bb[1].c);
+	load_bayer_sse2(c + 1, bb[0].cr, bb[1].cr);
+	load_bayer_sse2(c + width - 1, bb[0].sl, bb[1].sl);
+	load_bayer_sse2(c + width, bb[0].s, bb[1].s);
+	load_bayer_sse2(c + width + 1, bb[0].sr, bb[1].sr);
+}
+
+/* Select a for pixels in even columns, b for pixels in odd columns. */
+static inline __m128i
+even_odd_sse2(__m128i a, __m128i b)
+{
+	const __m128i even = _mm_set1_epi32(0x0000ffff);
+	return _mm_or_si128(_mm_and_si128(even, a), _mm_andnot_si128(even, b));
+}
+
+/* Bilinear interpolation of the GBRG pattern as done by
+ * bayerGBRG_to_yuv422planar_bilinear_line() for inner pixels. */
+static inline void
+bayer_gbrg_bilinear_sse2(const bayer_block_sse2_t &bb,
+                         bool                      rg_line,
+                         __m128i &                 r,
+                         __m128i &                 g,
+                         __m128i &                 b)
+{
+	__m128i cross4 = _mm_srli_epi16(
+	  _mm_add_epi16(_mm_add_epi16(bb.n, bb.cr), _mm_add_epi16(bb.s, bb.cl)), 2);
+	__m128i diag4 = _mm_srli_epi16(
+	  _mm_add_epi16(_mm_add_epi16(bb.nl, bb.nr), _mm_add_epi16(bb.sl, bb.sr)), 2);
+	__m128i horiz2 = _mm_srli_epi16(_mm_add_epi16(bb.cl, bb.cr), 1);
+	__m128i vert2  = _mm_srli_epi16(_mm_add_epi16(bb.n, bb.s), 1);
+
+	if (rg_line) {
+		r = even_odd_sse2(bb.c, horiz2);
+		g = even_odd_sse2(cross4, bb.c);
+		b = even_odd_sse2(diag4, vert2);
+	} else {
+		r = even_odd_sse2(vert2, diag4);
+		g = even_odd_sse2(bb.c, cross4);
+		b = even_odd_sse2(horiz2, bb.c);
+	}
+}
+
+/* Nearest neighbour interpolation of the GRBG pattern as done by
+ * bayerGRBG_to_yuv422planar_nearest_neighbour_line(). */
+static inline void
+bayer_grbg_nearest_sse2(const bayer_block_sse2_t &bb,
+                        bool                      gr_line,
+                        __m128i &                 r,
+                        __m128i &                 g,
+                        __m128i &                 b)
+{
+	if (gr_line) {
+		// the plain C function takes green from below and blue from the
+		// green pixel for even columns, keep the results identical
+		r = even_odd_sse2(bb.cr, bb.c);
+		g = even_odd_sse2(bb.s, bb.cl);
+		b = even_odd_sse2(bb.c, bb.sl);
+	} else {
+		r = even_odd_sse2(bb.nr, bb.n);
+		g = even_odd_sse2(bb.cr, bb.c);
+		b = even_odd_sse2(bb.c, bb.cl);
+	}
+}
+
+/* Convert the inner pixels of a row from column 2 on in blocks of 16
+ * pixels, returns the first column which was not converted. */
+template <bool BILINEAR, bool ODD_ROW>
+static inline unsigned int
+bayer_row_to_yuv422planar_sse2(const unsigned char *c,
+                               unsigned char *      yp,
+                               unsigned char *      up,
+                               unsigned char *      vp,
+                               unsigned int         width)
+{
+	unsigned int x = 2;
+	for (; x + 16 <= width - 2; x += 16) {
+		bayer_block_sse2_t bb[2];
+		__m128i            rgb[3][2], y8, u8, v8;
+		load_bayer_sse2(c + x, width, bb);
+		for (unsigned int h = 0; h < 2; ++h) {
+			if (BILINEAR) {
+				bayer_gbrg_bilinear_sse2(bb[h], ODD_ROW, rgb[0][h], rgb[1][h], rgb[2][h]);
+			} else {
+				bayer_grbg_nearest_sse2(bb[h], !ODD_ROW, rgb[0][h], rgb[1][h], rgb[2][h]);
+			}
+		}
+		rgb16_to_yuv422_sse2(
+		  rgb[0][0], rgb[1][0], rgb[2][0], rgb[0][1], rgb[1][1], rgb[2][1], y8, u8, v8);
+		_mm_storeu_si128((__m128i *)(yp + x), y8);
+		_mm_storel_epi64((__m128i *)(up + x / 2), u8);
+		_mm_storel_epi64((__m128i *)(vp + x / 2), v8);
+	}
+	return x;
+}
+
+/* Convert the inner pixels of the inner rows, the border pixels are
+ * converted by the plain C line function. */
+template <bool BILINEAR>
+static void
+bayer_to_yuv422planar_sse2(const unsigned char *src,
+                           unsigned char *      dst,
+                           unsigned int         width,
+                           unsigned int         height,
+                           unsigned int         row_begin,
+                           unsigned int         row_end)
+{
+	void (*line_func)(const unsigned char *,
+	                  unsigned char *,
+	                  unsigned int,
+	                  unsigned int,
+	                  unsigned int,
+	                  unsigned int,
+	                  unsigned int) = BILINEAR ? bayerGBRG_to_yuv422planar_bilinear_line
+	                                           : bayerGRBG_to_yuv422planar_nearest_neighbour_line;
+
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		if ((row == 0) || (row == height - 1) || (width < 20)) {
+			line_func(src, dst, width, height, row, 0, width);
+			continue;
+		}
+
+		const unsigned char *c  = src + (size_t)width * row;
+		unsigned char *      yp = PLANAR_Y_ROW(dst, width, height, row);
+		unsigned char *      up = PLANAR_U_ROW(dst, width, height, row);
+		unsigned char *      vp = PLANAR_V_ROW(dst, width, height, row);
+
+		line_func(src, dst, width, height, row, 0, 2);
+		unsigned int x = (row % 2 == 1)
+		                   ? bayer_row_to_yuv422planar_sse2<BILINEAR, true>(c, yp, up, vp, width)
+		                   : bayer_row_to_yuv422planar_sse2<BILINEAR, false>(c, yp, up, vp, width);
+		line_func(src, dst, width, height, row, x, width);
+	}
+}
+
+static const row_conversion_entry_t sse2_conversions[] = {
+  {YUV422_PLANAR, RGB, yuv422planar_to_rgb_sse2<OUT_RGB>},
+  {YUV422_PLANAR, BGR, yuv422planar_to_rgb_sse2<OUT_BGR>},
+  {YUV422_PLANAR, RGB_WITH_ALPHA, yuv422planar_to_rgb_sse2<OUT_RGBA>},
+  {YUV422_PLANAR, BGR_WITH_ALPHA, yuv422planar_to_rgb_sse2<OUT_BGRA>},
+  {YUV422_PACKED, RGB, packed_to_rgb_sse2<IN_UYVY, OUT_RGB>},
+  {YUV422_PACKED, BGR_WITH_ALPHA, packed_to_rgb_sse2<IN_UYVY, OUT_BGRA>},
+  {YUV422_PACKED, YUV422_PLANAR, packed_to_yuv422planar_sse2<IN_UYVY>},
+  {YUY2, YUV422_PLANAR, packed_to_yuv422planar_sse2<IN_YUY2>},
+  {YVY2, YUV422_PLANAR, packed_to_yuv422planar_sse2<IN_YVY2>},
+  {YUV422_PLANAR, YUV422_PACKED, yuv422planar_to_yuv422packed_sse2},
+  {RGB, YUV422_PLANAR, rgb_to_yuv422planar_sse2<OUT_RGB>},
+  {BGR, YUV422_PLANAR, rgb_to_yuv422planar_sse2<OUT_BGR>},
+  {RGB, YUV422_PACKED, rgb_to_yuv422packed_sse2},
+  {BAYER_MOSAIC_GBRG, YUV422_PLANAR, bayer_to_yuv422planar_sse2<true>},
+  {BAYER_MOSAIC_GRBG, YUV422_PLANAR, bayer_to_yuv422planar_sse2<false>},
+};
+
+#endif /* __SSE2__ */
+
+#ifdef HAVE_AVX2_CONVERSIONS
+
+/* The AVX2 kernels process 32 pixels at once. Most AVX2 instructions work
+ * on the two 128 bit lanes independently, the data is therefore arranged
+ * such that the low lane contains the first and the high lane the second
+ * 16 pixels, and the computations are the same as for SSE2. */
+
+AVX2_TARGET static inline __m256i
+channel_avx2(__m256i y0, __m256i y1, __m256i y2, __m256i y3, __m256i c_lo, __m256i c_hi)
+{
+	__m256i p0 = _mm256_srai_epi32(_mm256_add_epi32(y0, _mm256_unpacklo_epi32(c_lo, c_lo)), 16);
+	__m256i p1 = _mm256_srai_epi32(_mm256_add_epi32(y1, _mm256_unpackhi_epi32(c_lo, c_lo)), 16);
+	__m256i p2 = _mm256_srai_epi32(_mm256_add_epi32(y2, _mm256_unpacklo_epi32(c_hi, c_hi)), 16);
+	__m256i p3 = _mm256_srai_epi32(_mm256_add_epi32(y3, _mm256_unpackhi_epi32(c_hi, c_hi)), 16);
+	return _mm256_packus_epi16(_mm256_packs_epi32(p0, p1), _mm256_packs_epi32(p2, p3));
+}
+
+/* Convert 32 pixels, u16 and v16 contain 16 chroma samples each, the
+ * first eight in the low lane. */
+AVX2_TARGET static inline void
+yuv_to_rgb_avx2(__m256i y8, __m256i u16, __m256i v16, __m256i &r, __m256i &g, __m256i &b)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i cy   = _mm256_set1_epi16(19071);
+
+	__m256i ylo = _mm256_sub_epi16(_mm256_unpacklo_epi8(y8, zero), _mm256_set1_epi16(16));
+	__m256i yhi = _mm256_sub_epi16(_mm256_unpackhi_epi8(y8, zero), _mm256_set1_epi16(16));
+	__m256i y0  = _mm256_slli_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(ylo, ylo), cy), 1);
+	__m256i y1  = _mm256_slli_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(ylo, ylo), cy), 1);
+	__m256i y2  = _mm256_slli_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(yhi, yhi), cy), 1);
+	__m256i y3  = _mm256_slli_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(yhi, yhi), cy), 1);
+
+	__m256i u     = _mm256_sub_epi16(u16, _mm256_set1_epi16(128));
+	__m256i v     = _mm256_sub_epi16(v16, _mm256_set1_epi16(128));
+	__m256i uv_lo = _mm256_unpacklo_epi16(u, v);
+	__m256i uv_hi = _mm256_unpackhi_epi16(u, v);
+	__m256i u_lo  = _mm256_unpacklo_epi16(zero, u);
+	__m256i u_hi  = _mm256_unpackhi_epi16(zero, u);
+	__m256i v_lo  = _mm256_unpacklo_epi16(zero, v);
+	__m256i v_hi  = _mm256_unpackhi_epi16(zero, v);
+
+	const __m256i cr = _mm256_set1_epi32((int)((unsigned int)(unsigned short)-26477 << 16));
+	const __m256i cg = _mm256_set1_epi32((int)(((unsigned int)12255 << 16) | (unsigned short)-25625));
+	const __m256i cb = _mm256_set1_epi32(1180);
+
+	r = channel_avx2(y0,
+	                 y1,
+	                 y2,
+	                 y3,
+	                 _mm256_add_epi32(_mm256_slli_epi32(v_lo, 1), _mm256_madd_epi16(uv_lo, cr)),
+	                 _mm256_add_epi32(_mm256_slli_epi32(v_hi, 1), _mm256_madd_epi16(uv_hi, cr)));
+	g = channel_avx2(y0,
+	                 y1,
+	                 y2,
+	                 y3,
+	                 _mm256_sub_epi32(_mm256_madd_epi16(uv_lo, cg), v_lo),
+	                 _mm256_sub_epi32(_mm256_madd_epi16(uv_hi, cg), v_hi));
+	b = channel_avx2(y0,
+	                 y1,
+	                 y2,
+	                 y3,
+	                 _mm256_add_epi32(_mm256_slli_epi32(u_lo, 1), _mm256_madd_epi16(uv_lo, cb)),
+	                 _mm256_add_epi32(_mm256_slli_epi32(u_hi, 1), _mm256_madd_epi16(uv_hi, cb)));
+}
+
+template <int L>
+AVX2_TARGET static inline void
+store_rgb_avx2(unsigned char *d, __m256i r, __m256i g, __m256i b)
+{
+	__m256i c0 = RGB_ORDER(L) ? r : b;
+	__m256i c2 = RGB_ORDER(L) ? b : r;
+	__m256i a  = HAS_ALPHA(L) ? _mm256_set1_epi8(-1) : _mm256_setzero_si256();
+
+	__m256i c0g_lo = _mm256_unpacklo_epi8(c0, g);
+	__m256i c0g_hi = _mm256_unpackhi_epi8(c0, g);
+	__m256i c2a_lo = _mm256_unpacklo_epi8(c2, a);
+	__m256i c2a_hi = _mm256_unpackhi_epi8(c2, a);
+	// pixels 0-3 | 16-19, 4-7 | 20-23, 8-11 | 24-27, 12-15 | 28-31
+	__m256i p0 = _mm256_unpacklo_epi16(c0g_lo, c2a_lo);
+	__m256i p1 = _mm256_unpackhi_epi16(c0g_lo, c2a_lo);
+	__m256i p2 = _mm256_unpacklo_epi16(c0g_hi, c2a_hi);
+	__m256i p3 = _mm256_unpackhi_epi16(c0g_hi, c2a_hi);
+
+	if (HAS_ALPHA(L)) {
+		_mm256_storeu_si256((__m256i *)d, _mm256_permute2x128_si256(p0, p1, 0x20));
+		_mm256_storeu_si256((__m256i *)(d + 32), _mm256_permute2x128_si256(p2, p3, 0x20));
+		_mm256_storeu_si256((__m256i *)(d + 64), _mm256_permute2x128_si256(p0, p1, 0x31));
+		_mm256_storeu_si256((__m256i *)(d + 96), _mm256_permute2x128_si256(p2, p3, 0x31));
+	} else {
+		const __m256i pack24 = _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+		                                        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+		p0 = _mm256_shuffle_epi8(p0, pack24);
+		p1 = _mm256_shuffle_epi8(p1, pack24);
+		p2 = _mm256_shuffle_epi8(p2, pack24);
+		p3 = _mm256_shuffle_epi8(p3, pack24);
+		// bytes 0-47 in the low lanes, bytes 48-95 in the high lanes
+		__m256i q0 = _mm256_or_si256(p0, _mm256_slli_si256(p1, 12));
+		__m256i q1 = _mm256_or_si256(_mm256_srli_si256(p1, 4), _mm256_slli_si256(p2, 8));
+		__m256i q2 = _mm256_or_si256(_mm256_srli_si256(p2, 8), _mm256_slli_si256(p3, 4));
+		_mm256_storeu_si256((__m256i *)d, _mm256_permute2x128_si256(q0, q1, 0x20));
+		_mm256_storeu_si256((__m256i *)(d + 32), _mm256_permute2x128_si256(q2, q0, 0x30));
+		_mm256_storeu_si256((__m256i *)(d + 64), _mm256_permute2x128_si256(q1, q2, 0x31));
+	}
+}
+
+/* Split 32 packed pixels into luma bytes and 16 bit chroma samples. */
+template <int F>
+AVX2_TARGET static inline void
+load_packed_avx2(const unsigned char *s, __m256i &y8, __m256i &u16, __m256i &v16)
+{
+	const __m256i lo_mask = _mm256_set1_epi16(0x00ff);
+
+	__m256i a = _mm256_loadu_si256((const __m256i *)s);
+	__m256i b = _mm256_loadu_si256((const __m256i *)(s + 32));
+	__m256i c;
+	if (F == IN_UYVY) {
+		y8 = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+		c  = _mm256_packus_epi16(_mm256_and_si256(a, lo_mask), _mm256_and_si256(b, lo_mask));
+	} else {
+		y8 = _mm256_packus_epi16(_mm256_and_si256(a, lo_mask), _mm256_and_si256(b, lo_mask));
+		c  = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+	}
+	// packing works per lane, restore pixel order
+	y8 = _mm256_permute4x64_epi64(y8, 0xd8);
+	c  = _mm256_permute4x64_epi64(c, 0xd8);
+	if (F == IN_YVY2) {
+		v16 = _mm256_and_si256(c, lo_mask);
+		u16 = _mm256_srli_epi16(c, 8);
+	} else {
+		u16 = _mm256_and_si256(c, lo_mask);
+		v16 = _mm256_srli_epi16(c, 8);
+	}
+}
+
+template <int L>
+AVX2_TARGET static void
+yuv422planar_to_rgb_avx2(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height,
+                         unsigned int         row_begin,
+                         unsigned int         row_end)
+{
+	const __m128i zero = _mm_setzero_si128();
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *yp = PLANAR_Y_ROW(src, width, height, row);
+		const unsigned char *up = PLANAR_U_ROW(src, width, height, row);
+		const unsigned char *vp = PLANAR_V_ROW(src, width, height, row);
+		unsigned char *      d  = dst + (size_t)width * PIXEL_SIZE(L) * row;
+
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			__m256i r, g, b;
+			__m256i y8  = _mm256_loadu_si256((const __m256i *)(yp + x));
+			__m256i u16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(up + x / 2)));
+			__m256i v16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(vp + x / 2)));
+			yuv_to_rgb_avx2(y8, u16, v16, r, g, b);
+			store_rgb_avx2<L>(d + x * PIXEL_SIZE(L), r, g, b);
+		}
+		for (; x + 16 <= width; x += 16) {
+			__m128i r, g, b;
+			__m128i y8  = _mm_loadu_si128((const __m128i *)(yp + x));
+			__m128i u16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(up + x / 2)), zero);
+			__m128i v16 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(vp + x / 2)), zero);
+			yuv_to_rgb_sse2(y8, u16, v16, r, g, b);
+			store_rgb_sse2<L>(d + x * PIXEL_SIZE(L), r, g, b);
+		}
+		yuv422planar_to_rgb_tail<L>(yp, up, vp, d, x, width);
+	}
+}
+
+template <int F, int L>
+AVX2_TARGET static void
+packed_to_rgb_avx2(const unsigned char *src,
+                   unsigned char *      dst,
+                   unsigned int         width,
+                   unsigned int         height,
+                   unsigned int         row_begin,
+                   unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s = PACKED_ROW(src, width, row);
+		unsigned char *      d = dst + (size_t)width * PIXEL_SIZE(L) * row;
+
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			__m256i y8, u16, v16, r, g, b;
+			load_packed_avx2<F>(s + 2 * x, y8, u16, v16);
+			yuv_to_rgb_avx2(y8, u16, v16, r, g, b);
+			store_rgb_avx2<L>(d + x * PIXEL_SIZE(L), r, g, b);
+		}
+		packed_to_rgb_tail<F, L>(s, d, x, width);
+	}
+}
+
+template <int F>
+AVX2_TARGET static void
+packed_to_yuv422planar_avx2(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height,
+                            unsigned int         row_begin,
+                            unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s  = PACKED_ROW(src, width, row);
+		unsigned char *      yp = PLANAR_Y_ROW(dst, width, height, row);
+		unsigned char *      up = PLANAR_U_ROW(dst, width, height, row);
+		unsigned char *      vp = PLANAR_V_ROW(dst, width, height, row);
+
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			__m256i y8, u16, v16;
+			load_packed_avx2<F>(s + 2 * x, y8, u16, v16);
+			// u 0-7 | v 0-7 | u 8-15 | v 8-15 -> u 0-15 | v 0-15
+			__m256i uv8 = _mm256_permute4x64_epi64(_mm256_packus_epi16(u16, v16), 0xd8);
+			_mm256_storeu_si256((__m256i *)(yp + x), y8);
+			_mm_storeu_si128((__m128i *)(up + x / 2), _mm256_castsi256_si128(uv8));
+			_mm_storeu_si128((__m128i *)(vp + x / 2), _mm256_extracti128_si256(uv8, 1));
+		}
+		packed_to_planar_tail<F>(s, yp, up, vp, x, width);
+	}
+}
+
+AVX2_TARGET static void
+yuv422planar_to_yuv422packed_avx2(const unsigned char *src,
+                                  unsigned char *      dst,
+                                  unsigned int         width,
+                                  unsigned int         height,
+                                  unsigned int         row_begin,
+                                  unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *yp = PLANAR_Y_ROW(src, width, height, row);
+		const unsigned char *up = PLANAR_U_ROW(src, width, height, row);
+		const unsigned char *vp = PLANAR_V_ROW(src, width, height, row);
+		unsigned char *      d  = PACKED_ROW(dst, width, row);
+
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			__m256i y8 = _mm256_loadu_si256((const __m256i *)(yp + x));
+			__m128i u8 = _mm_loadu_si128((const __m128i *)(up + x / 2));
+			__m128i v8 = _mm_loadu_si128((const __m128i *)(vp + x / 2));
+			__m256i uv = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi8(u8, v8)),
+			                                     _mm_unpackhi_epi8(u8, v8),
+			                                     1);
+			__m256i p0 = _mm256_unpacklo_epi8(uv, y8);
+			__m256i p1 = _mm256_unpackhi_epi8(uv, y8);
+			_mm256_storeu_si256((__m256i *)(d + 2 * x), _mm256_permute2x128_si256(p0, p1, 0x20));
+			_mm256_storeu_si256((__m256i *)(d + 2 * x + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+		}
+		yuv422planar_to_yuv422packed_tail(yp, up, vp, d, x, width);
+	}
+}
+
+/* Byte shuffles are available on all AVX2 CPUs, swap four pixels at a
+ * time. The last four bytes of each store are written unchanged, they
+ * belong to the next pixel which is converted in the next iteration,
+ * this also makes the conversion safe to run in-place. */
+AVX2_TARGET static void
+bgr_to_rgb_avx2(const unsigned char *src,
+                unsigned char *      dst,
+                unsigned int         width,
+                unsigned int         height,
+                unsigned int         row_begin,
+                unsigned int         row_end)
+{
+	const __m128i swap = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15);
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s = src + (size_t)width * 3 * row;
+		unsigned char *      d = dst + (size_t)width * 3 * row;
+
+		unsigned int x = 0;
+		for (; x + 6 <= width; x += 4) {
+			__m128i p = _mm_loadu_si128((const __m128i *)(s + 3 * x));
+			_mm_storeu_si128((__m128i *)(d + 3 * x), _mm_shuffle_epi8(p, swap));
+		}
+		bgr_to_rgb_tail(s, d, x, width);
+	}
+}
+
+static const row_conversion_entry_t avx2_conversions[] = {
+  {YUV422_PLANAR, RGB, yuv422planar_to_rgb_avx2<OUT_RGB>},
+  {YUV422_PLANAR, BGR, yuv422planar_to_rgb_avx2<OUT_BGR>},
+  {YUV422_PLANAR, RGB_WITH_ALPHA, yuv422planar_to_rgb_avx2<OUT_RGBA>},
+  {YUV422_PLANAR, BGR_WITH_ALPHA, yuv422planar_to_rgb_avx2<OUT_BGRA>},
+  {YUV422_PACKED, RGB, packed_to_rgb_avx2<IN_UYVY, OUT_RGB>},
+  {YUV422_PACKED, BGR_WITH_ALPHA, packed_to_rgb_avx2<IN_UYVY, OUT_BGRA>},
+  {YUV422_PACKED, YUV422_PLANAR, packed_to_yuv422planar_avx2<IN_UYVY>},
+  {YUY2, YUV422_PLANAR, packed_to_yuv422planar_avx2<IN_YUY2>},
+  {YVY2, YUV422_PLANAR, packed_to_yuv422planar_avx2<IN_YVY2>},
+  {YUV422_PLANAR, YUV422_PACKED, yuv422planar_to_yuv422packed_avx2},
+  {BGR, RGB, bgr_to_rgb_avx2},
+};
+
+#endif /* HAVE_AVX2_CONVERSIONS */
+
+#ifdef __ARM_NEON
+
+/* The NEON kernels use the interleaving loads and stores to split and
+ * merge the pixel formats and evaluate the formula with 32 bit lanes. */
+
+static inline int16x4_t
+channel_neon(int16x4_t y, int16x4_t u, int16x4_t v, int cu, int cv)
+{
+	int32x4_t t = vmulq_n_s32(vmovl_s16(y), 76284);
+	t           = vmlaq_n_s32(t, vmovl_s16(u), cu);
+	t           = vmlaq_n_s32(t, vmovl_s16(v), cv);
+	return vqmovn_s32(vshrq_n_s32(t, 16));
+}
+
+/* Convert 8 pixels, one chroma sample per pixel. */
+static inline void
+yuv_to_rgb_neon(uint8x8_t y8, uint8x8_t u8, uint8x8_t v8, uint8x8_t &r, uint8x8_t &g, uint8x8_t &b)
+{
+	int16x8_t y = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y8)), vdupq_n_s16(16));
+	int16x8_t u = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), vdupq_n_s16(128));
+	int16x8_t v = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), vdupq_n_s16(128));
+
+	int16x4_t y_lo = vget_low_s16(y), y_hi = vget_high_s16(y);
+	int16x4_t u_lo = vget_low_s16(u), u_hi = vget_high_s16(u);
+	int16x4_t v_lo = vget_low_s16(v), v_hi = vget_high_s16(v);
+
+	r = vqmovun_s16(vcombine_s16(channel_neon(y_lo, u_lo, v_lo, 0, 104595),
+	                             channel_neon(y_hi, u_hi, v_hi, 0, 104595)));
+	g = vqmovun_s16(vcombine_s16(channel_neon(y_lo, u_lo, v_lo, -25625, -53281),
+	                             channel_neon(y_hi, u_hi, v_hi, -25625, -53281)));
+	b = vqmovun_s16(vcombine_s16(channel_neon(y_lo, u_lo, v_lo, 132252, 0),
+	                             channel_neon(y_hi, u_hi, v_hi, 132252, 0)));
+}
+
+/* Convert 16 pixels, one chroma sample per pixel. */
+static inline void
+yuv_to_rgb_neon(uint8x16_t y, uint8x16_t u, uint8x16_t v, uint8x16_t &r, uint8x16_t &g, uint8x16_t &b)
+{
+	uint8x8_t r_lo, g_lo, b_lo, r_hi, g_hi, b_hi;
+	yuv_to_rgb_neon(vget_low_u8(y), vget_low_u8(u), vget_low_u8(v), r_lo, g_lo, b_lo);
+	yuv_to_rgb_neon(vget_high_u8(y), vget_high_u8(u), vget_high_u8(v), r_hi, g_hi, b_hi);
+	r = vcombine_u8(r_lo, r_hi);
+	g = vcombine_u8(g_lo, g_hi);
+	b = vcombine_u8(b_lo, b_hi);
+}
+
+template <int L>
+static inline void
+store_rgb_neon(unsigned char *d, uint8x16_t r, uint8x16_t g, uint8x16_t b)
+{
+	if (HAS_ALPHA(L)) {
+		uint8x16x4_t p;
+		p.val[0] = RGB_ORDER(L) ? r : b;
+		p.val[1] = g;
+		p.val[2] = RGB_ORDER(L) ? b : r;
+		p.val[3] = vdupq_n_u8(255);
+		vst4q_u8(d, p);
+	} else {
+		uint8x16x3_t p;
+		p.val[0] = RGB_ORDER(L) ? r : b;
+		p.val[1] = g;
+		p.val[2] = RGB_ORDER(L) ? b : r;
+		vst3q_u8(d, p);
+	}
+}
+
+template <int L>
+static void
+yuv422planar_to_rgb_neon(const unsigned char *src,
+                         unsigned char *      dst,
+                         unsigned int         width,
+                         unsigned int         height,
+                         unsigned int         row_begin,
+                         unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *yp = PLANAR_Y_ROW(src, width, height, row);
+		const unsigned char *up = PLANAR_U_ROW(src, width, height, row);
+		const unsigned char *vp = PLANAR_V_ROW(src, width, height, row);
+		unsigned char *      d  = dst + (size_t)width * PIXEL_SIZE(L) * row;
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			uint8x16_t  r, g, b;
+			uint8x8x2_t u = vzip_u8(vld1_u8(up + x / 2), vld1_u8(up + x / 2));
+			uint8x8x2_t v = vzip_u8(vld1_u8(vp + x / 2), vld1_u8(vp + x / 2));
+			yuv_to_rgb_neon(vld1q_u8(yp + x),
+			                vcombine_u8(u.val[0], u.val[1]),
+			                vcombine_u8(v.val[0], v.val[1]),
+			                r,
+			                g,
+			                b);
+			store_rgb_neon<L>(d + x * PIXEL_SIZE(L), r, g, b);
+		}
+		yuv422planar_to_rgb_tail<L>(yp, up, vp, d, x, width);
+	}
+}
+
+template <int F, int L>
+static void
+packed_to_rgb_neon(const unsigned char *src,
+                   unsigned char *      dst,
+                   unsigned int         width,
+                   unsigned int         height,
+                   unsigned int         row_begin,
+                   unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s = PACKED_ROW(src, width, row);
+		unsigned char *      d = dst + (size_t)width * PIXEL_SIZE(L) * row;
+
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			uint8x16x4_t p = vld4q_u8(s + 2 * x);
+			uint8x16_t   re, ge, be, ro, go, bo;
+			// even and odd pixels share the chroma samples
+			yuv_to_rgb_neon(p.val[PACKED_Y0(F)], p.val[PACKED_U(F)], p.val[PACKED_V(F)], re, ge, be);
+			yuv_to_rgb_neon(p.val[PACKED_Y1(F)], p.val[PACKED_U(F)], p.val[PACKED_V(F)], ro, go, bo);
+			uint8x16x2_t r = vzipq_u8(re, ro);
+			uint8x16x2_t g = vzipq_u8(ge, go);
+			uint8x16x2_t b = vzipq_u8(be, bo);
+			store_rgb_neon<L>(d + x * PIXEL_SIZE(L), r.val[0], g.val[0], b.val[0]);
+			store_rgb_neon<L>(d + (x + 16) * PIXEL_SIZE(L), r.val[1], g.val[1], b.val[1]);
+		}
+		packed_to_rgb_tail<F, L>(s, d, x, width);
+	}
+}
+
+template <int F>
+static void
+packed_to_yuv422planar_neon(const unsigned char *src,
+                            unsigned char *      dst,
+                            unsigned int         width,
+                            unsigned int         height,
+                            unsigned int         row_begin,
+                            unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s  = PACKED_ROW(src, width, row);
+		unsigned char *      yp = PLANAR_Y_ROW(dst, width, height, row);
+		unsigned char *      up = PLANAR_U_ROW(dst, width, height, row);
+		unsigned char *      vp = PLANAR_V_ROW(dst, width, height, row);
+
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			uint8x16x4_t p = vld4q_u8(s + 2 * x);
+			uint8x16x2_t y;
+			y.val[0] = p.val[PACKED_Y0(F)];
+			y.val[1] = p.val[PACKED_Y1(F)];
+			vst2q_u8(yp + x, y);
+			vst1q_u8(up + x / 2, p.val[PACKED_U(F)]);
+			vst1q_u8(vp + x / 2, p.val[PACKED_V(F)]);
+		}
+		packed_to_planar_tail<F>(s, yp, up, vp, x, width);
+	}
+}
+
+static void
+yuv422planar_to_yuv422packed_neon(const unsigned char *src,
+                                  unsigned char *      dst,
+                                  unsigned int         width,
+                                  unsigned int         height,
+                                  unsigned int         row_begin,
+                                  unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *yp = PLANAR_Y_ROW(src, width, height, row);
+		const unsigned char *up = PLANAR_U_ROW(src, width, height, row);
+		const unsigned char *vp = PLANAR_V_ROW(src, width, height, row);
+		unsigned char *      d  = PACKED_ROW(dst, width, row);
+
+		unsigned int x = 0;
+		for (; x + 32 <= width; x += 32) {
+			uint8x16x2_t y = vld2q_u8(yp + x);
+			uint8x16x4_t p;
+			p.val[0] = vld1q_u8(up + x / 2);
+			p.val[1] = y.val[0];
+			p.val[2] = vld1q_u8(vp + x / 2);
+			p.val[3] = y.val[1];
+			vst4q_u8(d + 2 * x, p);
+		}
+		yuv422planar_to_yuv422packed_tail(yp, up, vp, d, x, width);
+	}
+}
+
+static void
+bgr_to_rgb_neon(const unsigned char *src,
+                unsigned char *      dst,
+                unsigned int         width,
+                unsigned int         height,
+                unsigned int         row_begin,
+                unsigned int         row_end)
+{
+	for (unsigned int row = row_begin; row < row_end; ++row) {
+		const unsigned char *s = src + (size_t)width * 3 * row;
+		unsigned char *      d = dst + (size_t)width * 3 * row;
+
+		unsigned int x = 0;
+		for (; x + 16 <= width; x += 16) {
+			uint8x16x3_t p = vld3q_u8(s + 3 * x);
+			uint8x16_t   b = p.val[0];
+			p.val[0]       = p.val[2];
+			p.val[2]       = b;
+			vst3q_u8(d + 3 * x, p);
+		}
+		bgr_to_rgb_tail(s, d, x, width);
+	}
+}
+
+static const row_conversion_entry_t neon_conversions[] = {
+  {YUV422_PLANAR, RGB, yuv422planar_to_rgb_neon<OUT_RGB>},
+  {YUV422_PLANAR, BGR, yuv422planar_to_rgb_neon<OUT_BGR>},
+  {YUV422_PLANAR, RGB_WITH_ALPHA, yuv422planar_to_rgb_neon<OUT_RGBA>},
+  {YUV422_PLANAR, BGR_WITH_ALPHA, yuv422planar_to_rgb_neon<OUT_BGRA>},
+  {YUV422_PACKED, RGB, packed_to_rgb_neon<IN_UYVY, OUT_RGB>},
+  {YUV422_PACKED, BGR_WITH_ALPHA, packed_to_rgb_neon<IN_UYVY, OUT_BGRA>},
+  {YUV422_PACKED, YUV422_PLANAR, packed_to_yuv422planar_neon<IN_UYVY>},
+  {YUY2, YUV422_PLANAR, packed_to_yuv422planar_neon<IN_YUY2>},
+  {YVY2, YUV422_PLANAR, packed_to_yuv422planar_neon<IN_YVY2>},
+  {YUV422_PLANAR, YUV422_PACKED, yuv422planar_to_yuv422packed_neon},
+  {BGR, RGB, bgr_to_rgb_neon},
+};
+
+#endif /* __ARM_NEON */
+
+static inline row_conversion_t
+find_row_conversion(const row_conversion_entry_t *table,
+                    size_t                        size,
+                    colorspace_t                  from,
+                    colorspace_t                  to)
+{
+	for (size_t i = 0; i < size; ++i) {
+		if ((table[i].from == from) && (table[i].to == to)) {
+			return table[i].conversion;
+		}
+	}
+	return NULL;
+}
+
+#define FIND_ROW_CONVERSION(table, from, to) \
+	find_row_conversion(table, sizeof(table) / sizeof(table[0]), from, to)
+
+/// @endcond
+
+/** Get vectorized row conversion.
+ * If there is no kernel for the requested SIMD level a kernel of a lower
+ * level on the same architecture is returned if available, e.g. an SSE2
+ * kernel if AVX2 was requested.
+ * @param from colorspace to convert from
+ * @param to colorspace to convert to
+ * @param simd SIMD extension to use
+ * @return row conversion function, NULL if there is no vectorized
+ * conversion for the given colorspaces or if the SIMD extension is
+ * not supported by the CPU
+ */
+row_conversion_t
+row_conversion(colorspace_t from, colorspace_t to, cpu_simd_t simd)
+{
+	if (!cpu_simd_supported(simd))
+		return NULL;
+
+	row_conversion_t conv = NULL;
+#ifdef HAVE_AVX2_CONVERSIONS
+	if (simd == CPU_SIMD_AVX2) {
+		conv = FIND_ROW_CONVERSION(avx2_conversions, from, to);
+	}
+#endif
+#ifdef __SSE2__
+	if (!conv && ((simd == CPU_SIMD_SSE2) || (simd == CPU_SIMD_AVX2))) {
+		conv = FIND_ROW_CONVERSION(sse2_conversions, from, to);
+	}
+#endif
+#ifdef __ARM_NEON
+	if (simd == CPU_SIMD_NEON) {
+		conv = FIND_ROW_CONVERSION(neon_conversions, from, to);
+	}
+#endif
+	return conv;
+}
+
+} // end namespace firevision
@@ -0,0 +1,54 @@
+
+/***************************************************************************
+ *  conversions_simd.h - Vectorized colorspace conversions
+ *
+ *  Created: Fri Oct 16 11:21:37 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef FIREVISION_UTILS_COLOR_CONVERSIONS_SIMD_H_
+#define FIREVISION_UTILS_COLOR_CONVERSIONS_SIMD_H_
+
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/cpu/simd.h>
+
+namespace firevision {
+
+/** Conversion of a band of rows.
+ * Converts the rows [row_begin, row_end) of the src image to the same
+ * rows of the dst image. Bands of the same image may be converted
+ * concurrently.
+ * @param src source buffer of the whole image
+ * @param dst destination buffer of the whole image
+ * @param width width of image in pixels, must be even
+ * @param height height of image in pixels
+ * @param row_begin first row to convert
+ * @param row_end row after the last row to convert
+ */
+typedef void (*row_conversion_t)(const unsigned char *src,
+                                 unsigned char *      dst,
+                                 unsigned int         width,
+                                 unsigned int         height,
+                                 unsigned int         row_begin,
+                                 unsigned int         row_end);
+
+row_conversion_t row_conversion(colorspace_t from, colorspace_t to, cpu_simd_t simd);
+
+} // end namespace firevision
+
+#endif
@@ -0,0 +1,88 @@
+
+/***************************************************************************
+ *  simd.cpp - SIMD CPU extension detection
+ *
+ *  Created: Fri Oct 16 11:04:52 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <fvutils/cpu/simd.h>
+
+namespace firevision {
+
+static cpu_simd_t
+detect_simd_support()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return CPU_SIMD_AVX2;
+	} else if (__builtin_cpu_supports("sse2")) {
+		return CPU_SIMD_SSE2;
+	}
+#elif defined(__ARM_NEON)
+	return CPU_SIMD_NEON;
+#endif
+	return CPU_SIMD_NONE;
+}
+
+/** Get best SIMD extension supported by the CPU.
+ * The CPU is queried only once, later calls return the cached result.
+ * @return highest SIMD level supported by the CPU we are running on
+ */
+cpu_simd_t
+cpu_simd_support()
+{
+	static const cpu_simd_t simd = detect_simd_support();
+	return simd;
+}
+
+/** Check if SIMD extension is supported by the CPU.
+ * @param simd SIMD extension to check
+ * @return true if code for the given SIMD level can be run on this CPU
+ */
+bool
+cpu_simd_supported(cpu_simd_t simd)
+{
+	cpu_simd_t best = cpu_simd_support();
+	switch (simd) {
+	case CPU_SIMD_NONE: return true;
+	case CPU_SIMD_SSE2: return (best == CPU_SIMD_SSE2) || (best == CPU_SIMD_AVX2);
+	case CPU_SIMD_AVX2: return (best == CPU_SIMD_AVX2);
+	case CPU_SIMD_NEON: return (best == CPU_SIMD_NEON);
+	}
+	return false;
+}
+
+/** Get string representation of SIMD extension.
+ * @param simd SIMD extension
+ * @return string name of the extension
+ */
+const char *
+cpu_simd_to_string(cpu_simd_t simd)
+{
+	switch (simd) {
+	case CPU_SIMD_NONE: return "plain";
+	case CPU_SIMD_SSE2: return "SSE2";
+	case CPU_SIMD_AVX2: return "AVX2";
+	case CPU_SIMD_NEON: return "NEON";
+	}
+	return "unknown";
+}
+
+} // end namespace firevision
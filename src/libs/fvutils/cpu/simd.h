@@ -0,0 +1,46 @@
+
+/***************************************************************************
+ *  simd.h - SIMD CPU extension detection
+ *
+ *  Created: Fri Oct 16 11:04:52 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FVUTILS_CPU_SIMD_H_
+#define _FIREVISION_FVUTILS_CPU_SIMD_H_
+
+namespace firevision {
+
+/** SIMD instruction set extensions.
+ * Levels on the same architecture are ordered, a CPU supporting a level
+ * also supports all lower levels.
+ */
+typedef enum {
+	CPU_SIMD_NONE = 0, /**< no SIMD extensions, plain C */
+	CPU_SIMD_SSE2 = 1, /**< x86 SSE2 */
+	CPU_SIMD_AVX2 = 2, /**< x86 AVX2 */
+	CPU_SIMD_NEON = 3  /**< ARM NEON */
+} cpu_simd_t;
+
+cpu_simd_t  cpu_simd_support();
+bool        cpu_simd_supported(cpu_simd_t simd);
+const char *cpu_simd_to_string(cpu_simd_t simd);
+
+} // end namespace firevision
+
+#endif
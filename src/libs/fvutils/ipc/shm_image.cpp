@@ -24,24 +24,58 @@
 #include <core/exception.h>
 #include <fvutils/ipc/shm_exceptions.h>
 #include <fvutils/ipc/shm_image.h>
+#include <utils/ipc/seqlock.h>
 #include <utils/ipc/shm_exceptions.h>
 #include <utils/misc/strndup.h>
 #include <utils/system/console_colors.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <unistd.h>
 
 using namespace std;
 using namespace fawkes;
 
 namespace firevision {
 
+/// Alignment of the control block and slot meta data in the segment, a cache line
+#define SHM_IMAGE_ALIGNMENT 64
+
+/** Get alignment of images in the segment.
+ * Images start at page boundaries, cameras may capture to them directly,
+ * e.g. using V4L2 user pointers, which some drivers only accept if aligned.
+ * @return page size
+ */
+static size_t
+image_alignment()
+{
+	static const size_t page_size = sysconf(_SC_PAGESIZE);
+	return page_size;
+}
+
 /** @class SharedMemoryImageBuffer <fvutils/ipc/shm_image.h>
  * Shared memory image buffer.
  * Write images to or retrieve images from a shared memory segment.
+ *
+ * The segment contains a ring of image slots. With a single slot the
+ * writer overwrites the image in place and readers and writer must
+ * synchronize using the semaphore lock, i.e. use lock_for_read(),
+ * lock_for_write(), and unlock() around accessing buffer(). Writers
+ * which work this way must ask for a single slot explicitly.
+ *
+ * With more slots, three by default, the writer fills the next slot
+ * using begin_write() and publishes it with end_write() without ever
+ * taking a lock. Readers retrieve the newest complete image with
+ * read_latest() or a specific one with read(), each slot is guarded by
+ * a SeqLock. After processing an image a reader must check with
+ * is_valid() that the slot has not been overwritten, which only happens
+ * if the reader takes longer than the given number of slots minus one
+ * images, or copy the image with copy_latest() right away. A slow
+ * reader can therefore no longer stall the writer.
  * @author Tim Niemueller
  */
 
@@ -57,17 +91,24 @@ namespace firevision {
  * @param cspace colorspace
  * @param width image width
  * @param height image height
+ * @param num_slots number of images in the ring buffer, 1 for a single
+ * image guarded by the semaphore lock, 3 or more to allow for lock-free
+ * readers
  */
 SharedMemoryImageBuffer::SharedMemoryImageBuffer(const char * image_id,
                                                  colorspace_t cspace,
                                                  unsigned int width,
-                                                 unsigned int height)
+                                                 unsigned int height,
+                                                 unsigned int num_slots)
 : SharedMemory(FIREVISION_SHM_IMAGE_MAGIC_TOKEN,
                /* read-only */ false,
                /* create */ true,
                /* destroy on delete */ true)
 {
-	constructor(image_id, cspace, width, height, false);
+	if (num_slots == 0) {
+		throw Exception("SharedMemoryImageBuffer: need at least one slot");
+	}
+	constructor(image_id, cspace, width, height, num_slots, false);
 	add_semaphore();
 }
 
@@ -87,7 +128,7 @@ SharedMemoryImageBuffer::SharedMemoryImageBuffer(const char *image_id, bool is_r
                /* create */ false,
                /* destroy */ false)
 {
-	constructor(image_id, CS_UNKNOWN, 0, 0, is_read_only);
+	constructor(image_id, CS_UNKNOWN, 0, 0, 1, is_read_only);
 }
 
 void
@@ -95,6 +136,7 @@ SharedMemoryImageBuffer::constructor(const char * image_id,
                                      colorspace_t cspace,
                                      unsigned int width,
                                      unsigned int height,
+                                     unsigned int num_slots,
                                      bool         is_read_only)
 {
 	_image_id     = strdup(image_id);
@@ -104,11 +146,13 @@ SharedMemoryImageBuffer::constructor(const char * image_id,
 	_width      = width;
 	_height     = height;
 
-	priv_header = new SharedMemoryImageBufferHeader(_image_id, _colorspace, width, height);
-	_header     = priv_header;
+	priv_header =
+	  new SharedMemoryImageBufferHeader(_image_id, _colorspace, width, height, num_slots);
+	_header = priv_header;
 	try {
 		attach();
 		raw_header = priv_header->raw_header();
+		setup_slots();
 	} catch (Exception &e) {
 		e.append("SharedMemoryImageBuffer: could not attach to '%s'\n", image_id);
 		::free(_image_id);
@@ -125,6 +169,33 @@ SharedMemoryImageBuffer::~SharedMemoryImageBuffer()
 	delete priv_header;
 }
 
+void
+SharedMemoryImageBuffer::setup_slots()
+{
+	colorspace_t cspace = (colorspace_t)raw_header->colorspace;
+	unsigned int width  = raw_header->width;
+	unsigned int height = raw_header->height;
+
+	// segments are page-aligned, hence the offset is the same in all processes;
+	// the control block and the meta data of the first slot precede the
+	// first image, which starts at a page boundary like all others
+	size_t    page = image_alignment();
+	uintptr_t image =
+	  ((uintptr_t)_memptr + 2 * SHM_IMAGE_ALIGNMENT + page - 1) & ~(uintptr_t)(page - 1);
+	_num_slots  = priv_header->num_slots();
+	_image_size = colorspace_buffer_size(cspace, width, height);
+	_slot_size  = SharedMemoryImageBufferHeader::slot_size(cspace, width, height);
+	_latest     = (uint64_t *)(image - 2 * SHM_IMAGE_ALIGNMENT);
+	_slots      = (unsigned char *)image - SHM_IMAGE_ALIGNMENT;
+	_write_seq  = SeqLock::read_begin(_latest) + 1;
+}
+
+SharedMemoryImageBuffer_slot_t *
+SharedMemoryImageBuffer::slot(uint64_t seq) const
+{
+	return (SharedMemoryImageBuffer_slot_t *)(_slots + ((seq - 1) % _num_slots) * _slot_size);
+}
+
 /** Set image number.
  * This will close the currently opened image and will try to open the new
  * image. This operation should be avoided.
@@ -140,6 +211,7 @@ SharedMemoryImageBuffer::set_image_id(const char *image_id)
 	priv_header->set_image_id(_image_id);
 	attach();
 	raw_header = priv_header->raw_header();
+	setup_slots();
 	return (_memptr != NULL);
 }
 
@@ -222,12 +294,209 @@ SharedMemoryImageBuffer::set_capture_time(long int sec, long int usec)
 }
 
 /** Get image buffer.
+ * With a single slot this is always the same buffer. Otherwise, for a
+ * writer this is the buffer that begin_write() returns and for a reader
+ * it is the buffer of the latest image at the time of the call.
  * @return image buffer.
  */
 unsigned char *
 SharedMemoryImageBuffer::buffer() const
 {
-	return (unsigned char *)_memptr;
+	uint64_t seq = _is_read_only ? std::max<uint64_t>(1, latest_seq()) : _write_seq;
+	return (unsigned char *)slot(seq) + SHM_IMAGE_ALIGNMENT;
+}
+
+/** Get size of an image.
+ * @return size in bytes of the image in one slot
+ */
+size_t
+SharedMemoryImageBuffer::image_size() const
+{
+	return _image_size;
+}
+
+/** Get number of slots.
+ * @return number of images in the ring buffer
+ */
+unsigned int
+SharedMemoryImageBuffer::num_slots() const
+{
+	return _num_slots;
+}
+
+/** Get buffer of a slot.
+ * This provides raw access to the image buffers of all slots, regardless
+ * of the images they currently contain, for example to register them with
+ * a camera capturing directly to the slots. Use begin_write() and
+ * end_write() to mark the images as being written and to publish them.
+ * @param index index of the slot, less than num_slots()
+ * @return buffer of image_size() bytes of the given slot
+ */
+unsigned char *
+SharedMemoryImageBuffer::slot_buffer(unsigned int index) const
+{
+	if (index >= _num_slots) {
+		throw Exception("SharedMemoryImageBuffer: invalid slot %u", index);
+	}
+	return _slots + index * _slot_size + SHM_IMAGE_ALIGNMENT;
+}
+
+/** Start writing an image.
+ * The returned buffer belongs to the slot after the latest image and may
+ * be filled in place. The image becomes visible to readers with
+ * end_write(). Calling begin_write() again before end_write() returns
+ * the very same buffer. With a single slot the write lock must be held
+ * from begin_write() until after end_write().
+ *
+ * Images may also be written ahead, for example if a camera captures to
+ * several slots at once. The slot is then already marked as being written
+ * and end_write() publishes the images in order once they are complete.
+ * @param ahead number of images after the next one to write, must be less
+ * than num_slots() minus one, i.e. the latest image is never overwritten
+ * @return buffer of image_size() bytes to write the image to
+ */
+unsigned char *
+SharedMemoryImageBuffer::begin_write(unsigned int ahead)
+{
+	if (_is_read_only) {
+		throw Exception("SharedMemoryImageBuffer: cannot write to read-only buffer");
+	}
+	if ((ahead > 0) && (ahead + 1 >= _num_slots)) {
+		throw Exception("SharedMemoryImageBuffer: cannot write %u images ahead with %u slots",
+		                ahead,
+		                _num_slots);
+	}
+	uint64_t                        seq = _write_seq + ahead;
+	SharedMemoryImageBuffer_slot_t *s   = slot(seq);
+	if (s->seq != 2 * seq - 1) {
+		SeqLock::write_begin(&s->seq, 2 * seq - 1);
+	}
+	return (unsigned char *)s + SHM_IMAGE_ALIGNMENT;
+}
+
+/** Publish the image written since begin_write().
+ * @param capture_time time when the image was captured, if NULL the time
+ * last set with set_capture_time() is used
+ */
+void
+SharedMemoryImageBuffer::end_write(const Time *capture_time)
+{
+	SharedMemoryImageBuffer_slot_t *s = slot(_write_seq);
+	if (s->seq != 2 * _write_seq - 1) {
+		throw Exception("SharedMemoryImageBuffer: end_write() without begin_write()");
+	}
+
+	if (capture_time) {
+		raw_header->capture_time_sec  = capture_time->get_sec();
+		raw_header->capture_time_usec = capture_time->get_usec();
+	}
+
+	s->capture_time_sec  = raw_header->capture_time_sec;
+	s->capture_time_usec = raw_header->capture_time_usec;
+
+	SeqLock::write_end(&s->seq, 2 * _write_seq);
+	__atomic_store_n(_latest, _write_seq, __ATOMIC_RELEASE);
+	_write_seq += 1;
+}
+
+/** Get sequence number of latest image.
+ * Sequence numbers start at one and increase with every image. This can
+ * be used to cheaply check for new images.
+ * @return sequence number of the latest image, zero if none has been
+ * published with end_write() so far
+ */
+uint64_t
+SharedMemoryImageBuffer::latest_seq() const
+{
+	return SeqLock::read_begin(_latest);
+}
+
+/** Get latest image.
+ * No data is copied, the buffer of the frame points into the segment.
+ * @param frame upon successful return contains the latest image
+ * @return true if an image has been retrieved, false if no image has
+ * been written so far
+ */
+bool
+SharedMemoryImageBuffer::read_latest(Frame &frame) const
+{
+	for (;;) {
+		uint64_t seq = latest_seq();
+		if (seq == 0)
+			return false;
+		if (read(seq, frame))
+			return true;
+		// overtaken by the writer, retry with the then latest image
+	}
+}
+
+/** Get a specific image.
+ * No data is copied, the buffer of the frame points into the segment.
+ * @param seq sequence number of the image to get
+ * @param frame upon successful return contains the requested image
+ * @return true if the image has been retrieved, false if it has not been
+ * written yet or has already been overwritten
+ */
+bool
+SharedMemoryImageBuffer::read(uint64_t seq, Frame &frame) const
+{
+	if ((seq == 0) || (seq > latest_seq()))
+		return false;
+
+	const SharedMemoryImageBuffer_slot_t *s     = slot(seq);
+	uint64_t                              begin = SeqLock::read_begin(&s->seq);
+	if (begin != 2 * seq)
+		return false;
+
+	frame.seq    = seq;
+	frame.buffer = (const unsigned char *)s + SHM_IMAGE_ALIGNMENT;
+	frame.capture_time.set_time(s->capture_time_sec, s->capture_time_usec);
+
+	return SeqLock::read_validate(&s->seq, begin);
+}
+
+/** Check if image is still valid.
+ * Call this after processing the buffer of a frame retrieved with
+ * read_latest() or read(). If it returns false the writer has
+ * overwritten the slot in the meantime and the result must be discarded.
+ * @param frame frame to check
+ * @return true if the image of the frame has not been modified
+ */
+bool
+SharedMemoryImageBuffer::is_valid(const Frame &frame) const
+{
+	return SeqLock::read_validate(&slot(frame.seq)->seq, 2 * frame.seq);
+}
+
+/** Copy latest image.
+ * With multiple slots this copies the latest complete image without
+ * blocking the writer, retrying if it was overwritten while copying.
+ * With a single slot the image is copied while holding the read lock,
+ * the sequence number is zero if the writer does not use end_write().
+ * @param buffer buffer of at least image_size() bytes to copy the image to
+ * @param frame upon successful return contains the sequence number and
+ * capture time of the image, the buffer is set to the given buffer
+ * @return true if an image has been copied, false if no image has been
+ * written so far
+ */
+bool
+SharedMemoryImageBuffer::copy_latest(unsigned char *buffer, Frame &frame)
+{
+	if (_num_slots == 1) {
+		lock_for_read();
+		memcpy(buffer, (unsigned char *)slot(1) + SHM_IMAGE_ALIGNMENT, _image_size);
+		frame.seq = latest_seq();
+		frame.capture_time.set_time(raw_header->capture_time_sec, raw_header->capture_time_usec);
+		unlock();
+	} else {
+		do {
+			if (!read_latest(frame))
+				return false;
+			memcpy(buffer, frame.buffer, _image_size);
+		} while (!is_valid(frame));
+	}
+	frame.buffer = buffer;
+	return true;
 }
 
 /** Get color space.
@@ -552,6 +821,7 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader()
 	_frame_id      = NULL;
 	_width         = 0;
 	_height        = 0;
+	_num_slots     = 1;
 	_header        = NULL;
 	_orig_image_id = NULL;
 	_orig_frame_id = NULL;
@@ -562,16 +832,19 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader()
  * @param colorspace colorspace
  * @param width width
  * @param height height
+ * @param num_slots number of images in the ring buffer
  */
 SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const char * image_id,
                                                              colorspace_t colorspace,
                                                              unsigned int width,
-                                                             unsigned int height)
+                                                             unsigned int height,
+                                                             unsigned int num_slots)
 {
 	_image_id   = strdup(image_id);
 	_colorspace = colorspace;
 	_width      = width;
 	_height     = height;
+	_num_slots  = num_slots;
 	_header     = NULL;
 	_frame_id   = NULL;
 
@@ -579,6 +852,7 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const char * image_
 	_orig_frame_id   = NULL;
 	_orig_width      = 0;
 	_orig_height     = 0;
+	_orig_num_slots  = 1;
 	_orig_colorspace = CS_UNKNOWN;
 }
 
@@ -600,12 +874,14 @@ SharedMemoryImageBufferHeader::SharedMemoryImageBufferHeader(const SharedMemoryI
 	_colorspace = h->_colorspace;
 	_width      = h->_width;
 	_height     = h->_height;
+	_num_slots  = h->_num_slots;
 	_header     = h->_header;
 
 	_orig_image_id   = NULL;
 	_orig_frame_id   = NULL;
 	_orig_width      = 0;
 	_orig_height     = 0;
+	_orig_num_slots  = 1;
 	_orig_colorspace = CS_UNKNOWN;
 }
 
@@ -634,15 +910,35 @@ SharedMemoryImageBufferHeader::clone() const
 	return new SharedMemoryImageBufferHeader(this);
 }
 
+/** Get size of a slot.
+ * @param colorspace colorspace of the image
+ * @param width width of the image
+ * @param height height of the image
+ * @return size in bytes of one slot including its meta data
+ */
+size_t
+SharedMemoryImageBufferHeader::slot_size(colorspace_t colorspace,
+                                         unsigned int width,
+                                         unsigned int height)
+{
+	// meta data occupies a cache line of its own right before the image,
+	// the slot size is a multiple of the page size to keep images aligned
+	size_t page = image_alignment();
+	size_t s    = SHM_IMAGE_ALIGNMENT + colorspace_buffer_size(colorspace, width, height);
+	return (s + page - 1) & ~(page - 1);
+}
+
 size_t
 SharedMemoryImageBufferHeader::data_size()
 {
+	// alignment slack, control block, and slots
 	if (_header == NULL) {
-		return colorspace_buffer_size(_colorspace, _width, _height);
+		return image_alignment() + 2 * SHM_IMAGE_ALIGNMENT
+		       + _num_slots * slot_size(_colorspace, _width, _height);
 	} else {
-		return colorspace_buffer_size((colorspace_t)_header->colorspace,
-		                              _header->width,
-		                              _header->height);
+		return image_alignment() + 2 * SHM_IMAGE_ALIGNMENT
+		       + num_slots()
+		           * slot_size((colorspace_t)_header->colorspace, _header->width, _header->height);
 	}
 }
 
@@ -657,7 +953,7 @@ SharedMemoryImageBufferHeader::matches(void *memptr)
 	} else if (strncmp(h->image_id, _image_id, IMAGE_ID_MAX_LENGTH) == 0) {
 		if ((_colorspace == CS_UNKNOWN)
 		    || (((colorspace_t)h->colorspace == _colorspace) && (h->width == _width)
-		        && (h->height == _height)
+		        && (h->height == _height) && (std::max(1u, h->num_slots) == _num_slots)
 		        && (!_frame_id || (strncmp(h->frame_id, _frame_id, FRAME_ID_MAX_LENGTH) == 0)))) {
 			return true;
 		} else {
@@ -671,7 +967,7 @@ SharedMemoryImageBufferHeader::matches(void *memptr)
 /** Check for equality of headers.
  * First checks if passed SharedMemoryHeader is an instance of
  * SharedMemoryImageBufferHeader. If not returns false, otherwise it compares
- * image ID, colorspace, width, and height. If all match returns true, false
+ * image ID, colorspace, width, height, and number of slots. If all match returns true, false
  * if any of them differs.
  * @param s shared memory header to compare to
  * @return true if the two instances identify the very same shared memory segments,
@@ -686,7 +982,8 @@ SharedMemoryImageBufferHeader::operator==(const SharedMemoryHeader &s) const
 	} else {
 		return ((strncmp(_image_id, h->_image_id, IMAGE_ID_MAX_LENGTH) == 0)
 		        && (!_frame_id || (strncmp(_frame_id, h->_frame_id, FRAME_ID_MAX_LENGTH) == 0))
-		        && (_colorspace == h->_colorspace) && (_width == h->_width) && (_height == h->_height));
+		        && (_colorspace == h->_colorspace) && (_width == h->_width) && (_height == h->_height)
+		        && (_num_slots == h->_num_slots));
 	}
 }
 
@@ -703,7 +1000,8 @@ SharedMemoryImageBufferHeader::print_info()
 	cout << "    image id:  " << _image_id << endl
 	     << "    frame id:  " << (_frame_id ? _frame_id : "NOT SET") << endl
 	     << "    colorspace: " << _colorspace << endl
-	     << "    dimensions: " << _width << "x" << _height << endl;
+	     << "    dimensions: " << _width << "x" << _height << endl
+	     << "    slots:      " << _num_slots << endl;
 	/*
      << "    ROI:        at (" << header->roi_x << "," << header->roi_y
        << ")  dim " << header->roi_width << "x" << header->roi_height << endl
@@ -736,6 +1034,7 @@ SharedMemoryImageBufferHeader::initialize(void *memptr)
 	header->colorspace = _colorspace;
 	header->width      = _width;
 	header->height     = _height;
+	header->num_slots  = _num_slots;
 
 	_header = header;
 }
@@ -762,6 +1061,7 @@ SharedMemoryImageBufferHeader::set(void *memptr)
 	}
 	_orig_width      = _width;
 	_orig_height     = _height;
+	_orig_num_slots  = _num_slots;
 	_orig_colorspace = _colorspace;
 	_header          = header;
 
@@ -769,6 +1069,7 @@ SharedMemoryImageBufferHeader::set(void *memptr)
 	_frame_id   = strndup(header->frame_id, FRAME_ID_MAX_LENGTH);
 	_width      = header->width;
 	_height     = header->height;
+	_num_slots  = std::max(1u, header->num_slots);
 	_colorspace = (colorspace_t)header->colorspace;
 }
 
@@ -791,6 +1092,7 @@ SharedMemoryImageBufferHeader::reset()
 	}
 	_width      = _orig_width;
 	_height     = _orig_height;
+	_num_slots  = _orig_num_slots;
 	_colorspace = _orig_colorspace;
 	_header     = NULL;
 }
@@ -831,6 +1133,18 @@ SharedMemoryImageBufferHeader::height() const
 		return _height;
 }
 
+/** Get number of slots.
+ * @return number of images in the ring buffer
+ */
+unsigned int
+SharedMemoryImageBufferHeader::num_slots() const
+{
+	if (_header)
+		return std::max(1u, _header->num_slots);
+	else
+		return _num_slots;
+}
+
 /** Get image number
  * @return image number
  */
@@ -30,10 +30,14 @@
 #include <utils/ipc/shm_lister.h>
 #include <utils/time/time.h>
 
+#include <cstdint>
 #include <string>
 
-// Magic token to identify FireVision shared memory images
-#define FIREVISION_SHM_IMAGE_MAGIC_TOKEN "FireVision Image"
+// Magic token to identify FireVision shared memory images. It carries a
+// version, segments of an incompatible layout must not be attached to.
+// Version 2 added the page-aligned image slots.
+// Only the first 15 characters are significant, cf. MAGIC_TOKEN_SIZE.
+#define FIREVISION_SHM_IMAGE_MAGIC_TOKEN "FireVision Img2"
 
 namespace firevision {
 
@@ -61,8 +65,18 @@ typedef struct
 	unsigned int flag_circle_found : 1; /**< 1 if circle found */
 	unsigned int flag_image_ready : 1;  /**< 1 if image ready */
 	unsigned int flag_reserved : 30;    /**< reserved for future use */
+	unsigned int num_slots;             /**< number of images in the ring buffer */
 } SharedMemoryImageBuffer_header_t;
 
+/** Meta data of an image slot in an image buffer.
+ * The image follows after the meta data at the next cache line. */
+typedef struct
+{
+	uint64_t seq;               /**< 2n if image n is valid, 2n-1 during write */
+	int64_t  capture_time_sec;  /**< capture time, seconds part */
+	int64_t  capture_time_usec; /**< capture time, microseconds part */
+} SharedMemoryImageBuffer_slot_t;
+
 class SharedMemoryImageBufferHeader : public fawkes::SharedMemoryHeader
 {
 public:
@@ -70,7 +84,8 @@ public:
 	SharedMemoryImageBufferHeader(const char * image_id,
 	                              colorspace_t colorspace,
 	                              unsigned int width,
-	                              unsigned int height);
+	                              unsigned int height,
+	                              unsigned int num_slots = 3);
 	SharedMemoryImageBufferHeader(const SharedMemoryImageBufferHeader *h);
 	virtual ~SharedMemoryImageBufferHeader();
 
@@ -90,23 +105,28 @@ public:
 	colorspace_t colorspace() const;
 	unsigned int width() const;
 	unsigned int height() const;
+	unsigned int num_slots() const;
 	const char * image_id() const;
 	const char * frame_id() const;
 
 	SharedMemoryImageBuffer_header_t *raw_header();
 
+	static size_t slot_size(colorspace_t colorspace, unsigned int width, unsigned int height);
+
 private:
 	char *       _image_id;
 	char *       _frame_id;
 	colorspace_t _colorspace;
 	unsigned int _width;
 	unsigned int _height;
+	unsigned int _num_slots;
 
 	char *       _orig_image_id;
 	char *       _orig_frame_id;
 	colorspace_t _orig_colorspace;
 	unsigned int _orig_width;
 	unsigned int _orig_height;
+	unsigned int _orig_num_slots;
 
 	SharedMemoryImageBuffer_header_t *_header;
 };
@@ -183,16 +203,31 @@ private:
 class SharedMemoryImageBuffer : public fawkes::SharedMemory
 {
 public:
+	/** Image in the ring buffer.
+   * The buffer points directly into the shared memory segment. It is only
+   * guaranteed to be consistent as long as is_valid() returns true for
+   * the frame. */
+	class Frame
+	{
+	public:
+		uint64_t             seq;          ///< image sequence number
+		const unsigned char *buffer;       ///< image buffer
+		fawkes::Time         capture_time; ///< time when the image was captured
+	};
+
 	SharedMemoryImageBuffer(const char * image_id,
 	                        colorspace_t cspace,
 	                        unsigned int width,
-	                        unsigned int height);
+	                        unsigned int height,
+	                        unsigned int num_slots = 3);
 	SharedMemoryImageBuffer(const char *image_id, bool is_read_only = true);
 	~SharedMemoryImageBuffer();
 
 	const char *   image_id() const;
 	const char *   frame_id() const;
 	unsigned char *buffer() const;
+	size_t         image_size() const;
+	unsigned int   num_slots() const;
 	colorspace_t   colorspace() const;
 	unsigned int   width() const;
 	unsigned int   height() const;
@@ -222,6 +257,16 @@ public:
 	void         set_capture_time(fawkes::Time *time);
 	void         set_capture_time(long int sec, long int usec);
 
+	unsigned char *slot_buffer(unsigned int index) const;
+	unsigned char *begin_write(unsigned int ahead = 0);
+	void           end_write(const fawkes::Time *capture_time = NULL);
+	uint64_t       latest_seq() const;
+	bool           read_latest(Frame &frame) const;
+	bool           read(uint64_t seq, Frame &frame) const;
+	bool           is_valid(const Frame &frame) const;
+	using fawkes::SharedMemory::is_valid;
+	bool           copy_latest(unsigned char *buffer, Frame &frame);
+
 	static void list();
 	static void cleanup(bool use_lister = true);
 	static bool exists(const char *image_id);
@@ -234,7 +279,11 @@ private:
 	                 colorspace_t cspace,
 	                 unsigned int width,
 	                 unsigned int height,
+	                 unsigned int num_slots,
 	                 bool         is_read_only);
+	void setup_slots();
+
+	SharedMemoryImageBuffer_slot_t *slot(uint64_t seq) const;
 
 	SharedMemoryImageBufferHeader *   priv_header;
 	SharedMemoryImageBuffer_header_t *raw_header;
@@ -243,6 +292,13 @@ private:
 	colorspace_t _colorspace;
 	unsigned int _width;
 	unsigned int _height;
+
+	unsigned int   _num_slots;
+	size_t         _image_size;
+	size_t         _slot_size;
+	uint64_t *     _latest;
+	unsigned char *_slots;
+	uint64_t       _write_seq;
 };
 
 } // end namespace firevision
@@ -52,24 +52,27 @@ typedef enum {
 	FUSE_MT_GREETING = 0xFFFFFFFE, /**< version */
 
 	/* server to client, 1000-1999 */
-	FUSE_MT_IMAGE             = 1000, /**< image */
-	FUSE_MT_LUT               = 1001, /**< lookup table */
-	FUSE_MT_IMAGE_LIST        = 1002, /**< image list */
-	FUSE_MT_LUT_LIST          = 1003, /**< lut list */
-	FUSE_MT_GET_IMAGE_FAILED  = 1004, /**< Fetching an image failed */
-	FUSE_MT_GET_LUT_FAILED    = 1005, /**< Fetching a LUT failed */
-	FUSE_MT_SET_LUT_SUCCEEDED = 1006, /**< Setting a LUT succeeded */
-	FUSE_MT_SET_LUT_FAILED    = 1007, /**< Setting a LUT failed */
-	FUSE_MT_IMAGE_INFO        = 1008, /**< image info */
-	FUSE_MT_IMAGE_INFO_FAILED = 1009, /**< Retrieval of image info failed */
+	FUSE_MT_IMAGE                  = 1000, /**< image */
+	FUSE_MT_LUT                    = 1001, /**< lookup table */
+	FUSE_MT_IMAGE_LIST             = 1002, /**< image list */
+	FUSE_MT_LUT_LIST               = 1003, /**< lut list */
+	FUSE_MT_GET_IMAGE_FAILED       = 1004, /**< Fetching an image failed */
+	FUSE_MT_GET_LUT_FAILED         = 1005, /**< Fetching a LUT failed */
+	FUSE_MT_SET_LUT_SUCCEEDED      = 1006, /**< Setting a LUT succeeded */
+	FUSE_MT_SET_LUT_FAILED         = 1007, /**< Setting a LUT failed */
+	FUSE_MT_IMAGE_INFO             = 1008, /**< image info */
+	FUSE_MT_IMAGE_INFO_FAILED      = 1009, /**< Retrieval of image info failed */
+	FUSE_MT_SUBSCRIBE_IMAGE_FAILED = 1010, /**< Subscribing to an image failed */
 
 	/* client to server, 2000-2999 */
-	FUSE_MT_GET_IMAGE      = 2000, /**< request image */
-	FUSE_MT_GET_LUT        = 2001, /**< request lookup table */
-	FUSE_MT_SET_LUT        = 2002, /**< set lookup table */
-	FUSE_MT_GET_IMAGE_LIST = 2003, /**< get image list */
-	FUSE_MT_GET_LUT_LIST   = 2004, /**< get LUT list */
-	FUSE_MT_GET_IMAGE_INFO = 2005, /**< get image info */
+	FUSE_MT_GET_IMAGE         = 2000, /**< request image */
+	FUSE_MT_GET_LUT           = 2001, /**< request lookup table */
+	FUSE_MT_SET_LUT           = 2002, /**< set lookup table */
+	FUSE_MT_GET_IMAGE_LIST    = 2003, /**< get image list */
+	FUSE_MT_GET_LUT_LIST      = 2004, /**< get LUT list */
+	FUSE_MT_GET_IMAGE_INFO    = 2005, /**< get image info */
+	FUSE_MT_SUBSCRIBE_IMAGE   = 2006, /**< subscribe to image stream */
+	FUSE_MT_UNSUBSCRIBE_IMAGE = 2007, /**< unsubscribe from image stream */
 
 } FUSE_message_type_t;
 
@@ -151,6 +154,21 @@ typedef struct
 	uint32_t reserved : 24;                 /**< reserved for future use */
 } FUSE_imagereq_message_t;
 
+/** Image subscription message.
+ * The server pushes FUSE_MT_IMAGE messages with new images until the
+ * client sends FUSE_MT_UNSUBSCRIBE_IMAGE with a FUSE_imagedesc_message_t.
+ * Images are dropped if the client cannot keep up.
+ */
+typedef struct
+{
+	char     image_id[IMAGE_ID_MAX_LENGTH]; /**< image ID */
+	uint32_t format : 8;                    /**< requested image format, see FUSE_image_format_t */
+	uint32_t reserved : 24;                 /**< reserved for future use */
+	uint32_t period_msec;                   /**< minimum time between images in ms, 0 for all */
+	uint32_t max_width;                     /**< maximum width in pixels, 0 for original width */
+	uint32_t max_height;                    /**< maximum height in pixels, 0 for original height */
+} FUSE_imagesub_message_t;
+
 /** Image description message. */
 typedef struct
 {
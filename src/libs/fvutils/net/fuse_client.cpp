@@ -339,4 +339,50 @@ FuseClient::wait_greeting()
 	greeting_mutex_->unlock();
 }
 
+/** Subscribe to an image.
+ * The server then sends FUSE_MT_IMAGE messages with new images without
+ * further requests, they are passed to the client handler as any other
+ * message. If the subscription fails the handler receives a
+ * FUSE_MT_SUBSCRIBE_IMAGE_FAILED message. Subscribing again to the same
+ * image with the same format and resolution only changes the period.
+ * @param image_id ID of the image to subscribe to
+ * @param format format of the images to receive
+ * @param period_msec minimum time between two images in ms, 0 to receive
+ * every image the client can keep up with
+ * @param max_width maximum width in pixels, larger images are scaled
+ * down, 0 for the original width
+ * @param max_height maximum height in pixels, larger images are scaled
+ * down, 0 for the original height
+ */
+void
+FuseClient::subscribe_image(const char *        image_id,
+                            FUSE_image_format_t format,
+                            unsigned int        period_msec,
+                            unsigned int        max_width,
+                            unsigned int        max_height)
+{
+	FUSE_imagesub_message_t *ism =
+	  (FUSE_imagesub_message_t *)calloc(1, sizeof(FUSE_imagesub_message_t));
+	strncpy(ism->image_id, image_id, IMAGE_ID_MAX_LENGTH - 1);
+	ism->format      = format;
+	ism->period_msec = htonl(period_msec);
+	ism->max_width   = htonl(max_width);
+	ism->max_height  = htonl(max_height);
+	enqueue(FUSE_MT_SUBSCRIBE_IMAGE, ism, sizeof(FUSE_imagesub_message_t));
+}
+
+/** Unsubscribe from an image.
+ * Cancels all subscriptions to the given image. Images which have been
+ * sent already may still be received afterwards.
+ * @param image_id ID of the image to unsubscribe from
+ */
+void
+FuseClient::unsubscribe_image(const char *image_id)
+{
+	FUSE_imagedesc_message_t *idm =
+	  (FUSE_imagedesc_message_t *)calloc(1, sizeof(FUSE_imagedesc_message_t));
+	strncpy(idm->image_id, image_id, IMAGE_ID_MAX_LENGTH - 1);
+	enqueue(FUSE_MT_UNSUBSCRIBE_IMAGE, idm, sizeof(FUSE_imagedesc_message_t));
+}
+
 } // end namespace firevision
@@ -57,6 +57,13 @@ public:
 	void wait();
 	void wait_greeting();
 
+	void subscribe_image(const char *        image_id,
+	                     FUSE_image_format_t format,
+	                     unsigned int        period_msec = 0,
+	                     unsigned int        max_width   = 0,
+	                     unsigned int        max_height  = 0);
+	void unsubscribe_image(const char *image_id);
+
 	virtual void loop();
 
 private:
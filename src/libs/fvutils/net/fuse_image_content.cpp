@@ -88,16 +88,16 @@ FuseImageContent::FuseImageContent(SharedMemoryImageBuffer *b)
 	header_->height      = htonl(b->height());
 	header_->buffer_size = htonl(buffer_size_);
 
-	long int cts = 0, ctus = 0;
-	b->capture_time(&cts, &ctus);
-	header_->capture_time_sec  = htonl(cts);
-	header_->capture_time_usec = htonl(ctus);
+	SharedMemoryImageBuffer::Frame frame;
+	if (!b->copy_latest(buffer_, frame)) {
+		// no image has been written, yet
+		memset(buffer_, 0, buffer_size_);
+		frame.capture_time = b->capture_time();
+	}
+	header_->capture_time_sec  = htonl(frame.capture_time.get_sec());
+	header_->capture_time_usec = htonl(frame.capture_time.get_usec());
 
 	capture_time_ = NULL;
-
-	b->lock_for_read();
-	memcpy(buffer_, b->buffer(), buffer_size_);
-	b->unlock();
 }
 
 /** Constructor.
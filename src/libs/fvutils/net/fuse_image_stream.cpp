@@ -0,0 +1,237 @@
+
+/***************************************************************************
+ *  fuse_image_stream.cpp - FUSE image stream shared among subscribers
+ *
+ *  Created: Fri Oct 16 14:31:05 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/compression/jpeg_compressor.h>
+#include <fvutils/ipc/shm_image.h>
+#include <fvutils/net/fuse_image_content.h>
+#include <fvutils/net/fuse_image_stream.h>
+#include <fvutils/net/fuse_message.h>
+
+using namespace fawkes;
+
+namespace firevision {
+
+/** @class FuseImageStream <fvutils/net/fuse_image_stream.h>
+ * Image stream shared among FUSE subscribers.
+ * A stream provides the images of a shared memory image buffer in a
+ * specific format and resolution as ready-to-send FUSE_MT_IMAGE messages.
+ * Each image is scaled and compressed only once, no matter how many
+ * clients subscribed to the stream, and all of them send the very same
+ * reference counted message.
+ *
+ * Streams are reference counted, the FuseServer keeps one per distinct
+ * subscription and client threads share it.
+ * @ingroup FUSE
+ * @ingroup FireVision
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param image_id ID of the shared memory image buffer to stream
+ * @param format image format to send
+ * @param max_width maximum width in pixels, larger images are scaled
+ * down keeping the aspect ratio, 0 for no limit
+ * @param max_height maximum height in pixels, 0 for no limit
+ * @exception Exception thrown if the image buffer cannot be opened
+ */
+FuseImageStream::FuseImageStream(const char *        image_id,
+                                 FUSE_image_format_t format,
+                                 unsigned int        max_width,
+                                 unsigned int        max_height)
+: image_id_(image_id), format_(format), max_width_(max_width), max_height_(max_height)
+{
+	shm_        = new SharedMemoryImageBuffer(image_id);
+	jpeg_       = NULL;
+	message_    = NULL;
+	generation_ = 0;
+	seq_        = 0;
+	mutex_      = new Mutex();
+
+	unsigned int width  = shm_->width();
+	unsigned int height = shm_->height();
+	width_              = width;
+	height_             = height;
+	scale_              = ((max_width_ > 0) && (max_width_ < width))
+	         || ((max_height_ > 0) && (max_height_ < height));
+	if (scale_) {
+		scaler_.set_original_dimensions(width, height);
+		scaler_.set_scaled_dimensions(max_width_ > 0 ? max_width_ : width,
+		                              max_height_ > 0 ? max_height_ : height);
+		width_  = scaler_.needed_scaled_width();
+		height_ = scaler_.needed_scaled_height();
+		scaled_.resize(colorspace_buffer_size(YUV422_PLANAR, width_, height_));
+	}
+
+	image_.resize(shm_->image_size());
+	if ((scale_ || (format_ == FUSE_IF_JPEG)) && (shm_->colorspace() != YUV422_PLANAR)) {
+		// the scaler and the compressor work on YUV422_PLANAR images only
+		yuv_.resize(colorspace_buffer_size(YUV422_PLANAR, width, height));
+	}
+
+	if (format_ == FUSE_IF_JPEG) {
+		jpeg_ = new JpegImageCompressor();
+		jpeg_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
+		jpeg_->set_image_dimensions(width_, height_);
+		compressed_.resize(jpeg_->recommended_compressed_buffer_size());
+	}
+}
+
+/** Destructor. */
+FuseImageStream::~FuseImageStream()
+{
+	if (message_)
+		message_->unref();
+	delete jpeg_;
+	delete shm_;
+	delete mutex_;
+}
+
+/** Get image ID.
+ * @return ID of the streamed image buffer
+ */
+const char *
+FuseImageStream::image_id() const
+{
+	return image_id_.c_str();
+}
+
+/** Get image format.
+ * @return format of the sent images
+ */
+FUSE_image_format_t
+FuseImageStream::format() const
+{
+	return format_;
+}
+
+/** Get maximum width.
+ * @return maximum width in pixels, 0 for no limit
+ */
+unsigned int
+FuseImageStream::max_width() const
+{
+	return max_width_;
+}
+
+/** Get maximum height.
+ * @return maximum height in pixels, 0 for no limit
+ */
+unsigned int
+FuseImageStream::max_height() const
+{
+	return max_height_;
+}
+
+/** Get message with the latest image.
+ * The first caller after the image buffer has been updated encodes the new
+ * image, all others get the very same message.
+ * @param generation generation of the image the caller has last received,
+ * 0 if none, updated to the generation of the returned image
+ * @return message with the latest image, with an additional reference for
+ * the caller, or NULL if there is no image newer than the given generation
+ */
+FuseNetworkMessage *
+FuseImageStream::latest(unsigned long &generation)
+{
+	MutexLocker lock(mutex_);
+
+	uint64_t seq = shm_->latest_seq();
+	if (!message_ || (seq != seq_) || ((seq == 0) && (shm_->capture_time() != capture_time_))) {
+		encode();
+	}
+
+	if (!message_ || (generation == generation_)) {
+		return NULL;
+	}
+	generation = generation_;
+	message_->ref();
+	return message_;
+}
+
+void
+FuseImageStream::encode()
+{
+	SharedMemoryImageBuffer::Frame frame;
+	if (!shm_->copy_latest(image_.data(), frame)) {
+		// no image has been written, yet
+		return;
+	}
+
+	colorspace_t   cspace = shm_->colorspace();
+	unsigned char *buffer = image_.data();
+	if (!yuv_.empty()) {
+		convert(cspace, YUV422_PLANAR, buffer, yuv_.data(), shm_->width(), shm_->height());
+		cspace = YUV422_PLANAR;
+		buffer = yuv_.data();
+	}
+	if (scale_) {
+		scaler_.set_original_buffer(buffer);
+		scaler_.set_scaled_buffer(scaled_.data());
+		scaler_.scale();
+		buffer = scaled_.data();
+	}
+
+	FuseImageContent *ic;
+	if (format_ == FUSE_IF_JPEG) {
+		jpeg_->set_image_buffer(YUV422_PLANAR, buffer);
+		jpeg_->set_destination_buffer(compressed_.data(), compressed_.size());
+		jpeg_->compress();
+		ic = new FuseImageContent(FUSE_IF_JPEG,
+		                          image_id_.c_str(),
+		                          compressed_.data(),
+		                          jpeg_->compressed_size(),
+		                          CS_UNKNOWN,
+		                          width_,
+		                          height_,
+		                          frame.capture_time.get_sec(),
+		                          frame.capture_time.get_usec());
+	} else {
+		ic = new FuseImageContent(FUSE_IF_RAW,
+		                          image_id_.c_str(),
+		                          buffer,
+		                          colorspace_buffer_size(cspace, width_, height_),
+		                          cspace,
+		                          width_,
+		                          height_,
+		                          frame.capture_time.get_sec(),
+		                          frame.capture_time.get_usec());
+	}
+
+	// the message takes over the payload, it needs no packing and can
+	// therefore be sent by several client threads concurrently
+	FuseNetworkMessage *m =
+	  new FuseNetworkMessage(FUSE_MT_IMAGE, ic->payload(), ic->payload_size(), /* copy */ false);
+	delete ic;
+
+	if (message_)
+		message_->unref();
+	message_      = m;
+	seq_          = frame.seq;
+	capture_time_ = frame.capture_time;
+	generation_ += 1;
+}
+
+} // end namespace firevision
@@ -0,0 +1,91 @@
+
+/***************************************************************************
+ *  fuse_image_stream.h - FUSE image stream shared among subscribers
+ *
+ *  Created: Fri Oct 16 14:31:05 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _FIREVISION_FVUTILS_NET_FUSE_IMAGE_STREAM_H_
+#define _FIREVISION_FVUTILS_NET_FUSE_IMAGE_STREAM_H_
+
+#include <core/utils/refcount.h>
+#include <fvutils/net/fuse.h>
+#include <fvutils/scalers/lossy.h>
+#include <utils/time/time.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+class Mutex;
+}
+namespace firevision {
+
+class FuseNetworkMessage;
+class SharedMemoryImageBuffer;
+class JpegImageCompressor;
+
+class FuseImageStream : public fawkes::RefCount
+{
+public:
+	FuseImageStream(const char *        image_id,
+	                FUSE_image_format_t format,
+	                unsigned int        max_width,
+	                unsigned int        max_height);
+	virtual ~FuseImageStream();
+
+	const char *        image_id() const;
+	FUSE_image_format_t format() const;
+	unsigned int        max_width() const;
+	unsigned int        max_height() const;
+
+	FuseNetworkMessage *latest(unsigned long &generation);
+
+private:
+	void encode();
+
+private:
+	std::string         image_id_;
+	FUSE_image_format_t format_;
+	unsigned int        max_width_;
+	unsigned int        max_height_;
+
+	SharedMemoryImageBuffer *shm_;
+	JpegImageCompressor *    jpeg_;
+	LossyScaler              scaler_;
+	bool                     scale_;
+	unsigned int             width_;
+	unsigned int             height_;
+
+	std::vector<unsigned char> image_;
+	std::vector<unsigned char> yuv_;
+	std::vector<unsigned char> scaled_;
+	std::vector<unsigned char> compressed_;
+
+	fawkes::Mutex *     mutex_;
+	FuseNetworkMessage *message_;
+	unsigned long       generation_;
+	uint64_t            seq_;
+	fawkes::Time        capture_time_;
+};
+
+} // end namespace firevision
+
+#endif
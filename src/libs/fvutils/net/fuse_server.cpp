@@ -21,7 +21,9 @@
  *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
  */
 
+#include <core/threading/mutex_locker.h>
 #include <core/threading/thread_collector.h>
+#include <fvutils/net/fuse_image_stream.h>
 #include <fvutils/net/fuse_server.h>
 #include <fvutils/net/fuse_server_client_thread.h>
 #include <netcomm/utils/acceptor_thread.h>
@@ -38,6 +40,10 @@ namespace firevision {
  * connections. For each connection a client thread is started that will process
  * all requests issued by the client.
  *
+ * Client threads share image streams of subscribed images, such that an
+ * image is encoded only once for all clients subscribed to it with the
+ * same format and resolution.
+ *
  * @ingroup FUSE
  * @ingroup FireVision
  * @author Tim Niemueller
@@ -131,6 +137,50 @@ FuseServer::connection_died(FuseServerClientThread *client) throw()
 	wakeup();
 }
 
+/** Subscribe to an image stream.
+ * Returns the existing stream for the given parameters or creates a new one.
+ * @param image_id ID of the shared memory image buffer
+ * @param format image format to send
+ * @param max_width maximum width in pixels, 0 for no limit
+ * @param max_height maximum height in pixels, 0 for no limit
+ * @return image stream, release with unsubscribe_image()
+ * @exception Exception thrown if the image buffer cannot be opened
+ */
+FuseImageStream *
+FuseServer::subscribe_image(const char *        image_id,
+                            FUSE_image_format_t format,
+                            unsigned int        max_width,
+                            unsigned int        max_height)
+{
+	MutexLocker lock(streams_.mutex());
+
+	StreamKey                                       key(image_id, format, max_width, max_height);
+	LockMap<StreamKey, FuseImageStream *>::iterator s = streams_.find(key);
+	if (s != streams_.end()) {
+		s->second->ref();
+		return s->second;
+	}
+
+	FuseImageStream *stream = new FuseImageStream(image_id, format, max_width, max_height);
+	streams_[key]           = stream;
+	return stream;
+}
+
+/** Unsubscribe from an image stream.
+ * @param stream stream returned by subscribe_image()
+ */
+void
+FuseServer::unsubscribe_image(FuseImageStream *stream)
+{
+	MutexLocker lock(streams_.mutex());
+
+	if (stream->refcount() == 1) {
+		streams_.erase(
+		  StreamKey(stream->image_id(), stream->format(), stream->max_width(), stream->max_height()));
+	}
+	stream->unref();
+}
+
 void
 FuseServer::loop()
 {
@@ -26,9 +26,12 @@
 
 #include <core/threading/thread.h>
 #include <core/utils/lock_list.h>
+#include <core/utils/lock_map.h>
+#include <fvutils/net/fuse.h>
 #include <netcomm/utils/incoming_connection_handler.h>
 
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace fawkes {
@@ -39,6 +42,7 @@ class NetworkAcceptorThread;
 namespace firevision {
 
 class FuseServerClientThread;
+class FuseImageStream;
 
 class FuseServer : public fawkes::Thread, public fawkes::NetworkIncomingConnectionHandler
 {
@@ -54,9 +58,17 @@ public:
 	virtual void add_connection(fawkes::StreamSocket *s) throw();
 	void         connection_died(FuseServerClientThread *client) throw();
 
+	FuseImageStream *subscribe_image(const char *        image_id,
+	                                 FUSE_image_format_t format,
+	                                 unsigned int        max_width,
+	                                 unsigned int        max_height);
+	void             unsubscribe_image(FuseImageStream *stream);
+
 	virtual void loop();
 
 private:
+	typedef std::tuple<std::string, FUSE_image_format_t, unsigned int, unsigned int> StreamKey;
+
 	std::vector<fawkes::NetworkAcceptorThread *> acceptor_threads_;
 
 	fawkes::LockList<FuseServerClientThread *>           clients_;
@@ -64,6 +76,8 @@ private:
 
 	fawkes::LockList<FuseServerClientThread *> dead_clients_;
 
+	fawkes::LockMap<StreamKey, FuseImageStream *> streams_;
+
 	fawkes::ThreadCollector *thread_collector_;
 };
 
@@ -26,6 +26,7 @@
 #include <fvutils/ipc/shm_image.h>
 #include <fvutils/ipc/shm_lut.h>
 #include <fvutils/net/fuse_image_content.h>
+#include <fvutils/net/fuse_image_stream.h>
 #include <fvutils/net/fuse_imagelist_content.h>
 #include <fvutils/net/fuse_lut_content.h>
 #include <fvutils/net/fuse_lutlist_content.h>
@@ -50,6 +51,11 @@ namespace firevision {
  * FUSE Server Client Thread.
  * This thread is instantiated and started for each client that connects to a
  * FuseServer.
+ *
+ * Images a client subscribed to are pushed from the thread's loop. At most
+ * one image per subscription is queued per loop and the queue is sent
+ * completely before the next iteration. A client which cannot keep up
+ * therefore skips images instead of building up a backlog.
  * @ingroup FUSE
  * @ingroup FireVision
  * @author Tim Niemueller
@@ -84,6 +90,11 @@ FuseServerClientThread::~FuseServerClientThread()
 	delete socket_;
 	delete jpeg_compressor_;
 
+	for (Subscription &sub : subscriptions_) {
+		fuse_server_->unsubscribe_image(sub.stream);
+	}
+	subscriptions_.clear();
+
 	for (bit_ = buffers_.begin(); bit_ != buffers_.end(); ++bit_) {
 		delete bit_->second;
 	}
@@ -201,18 +212,33 @@ FuseServerClientThread::process_getimage_message(FuseNetworkMessage *m)
 			jpeg_compressor_ = new JpegImageCompressor();
 			jpeg_compressor_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
 		}
-		b->lock_for_read();
 		jpeg_compressor_->set_image_dimensions(b->width(), b->height());
-		jpeg_compressor_->set_image_buffer(b->colorspace(), b->buffer());
 		unsigned char *compressed_buffer =
 		  (unsigned char *)malloc(jpeg_compressor_->recommended_compressed_buffer_size());
 		jpeg_compressor_->set_destination_buffer(
 		  compressed_buffer, jpeg_compressor_->recommended_compressed_buffer_size());
-		jpeg_compressor_->compress();
-		b->unlock();
-		size_t   compressed_buffer_size = jpeg_compressor_->compressed_size();
-		long int sec = 0, usec = 0;
-		b->capture_time(&sec, &usec);
+
+		SharedMemoryImageBuffer::Frame frame;
+		if (b->num_slots() == 1) {
+			b->lock_for_read();
+			jpeg_compressor_->set_image_buffer(b->colorspace(), b->buffer());
+			jpeg_compressor_->compress();
+			frame.capture_time = b->capture_time();
+			b->unlock();
+		} else {
+			// compress in place without blocking the writer, retry if the
+			// slot has been overwritten during compression
+			do {
+				if (!b->read_latest(frame)) {
+					frame.seq          = 0;
+					frame.buffer       = b->buffer();
+					frame.capture_time = b->capture_time();
+				}
+				jpeg_compressor_->set_image_buffer(b->colorspace(), (unsigned char *)frame.buffer);
+				jpeg_compressor_->compress();
+			} while ((frame.seq != 0) && !b->is_valid(frame));
+		}
+		size_t            compressed_buffer_size = jpeg_compressor_->compressed_size();
 		FuseImageContent *im = new FuseImageContent(FUSE_IF_JPEG,
 		                                            b->image_id(),
 		                                            compressed_buffer,
@@ -220,8 +246,8 @@ FuseServerClientThread::process_getimage_message(FuseNetworkMessage *m)
 		                                            CS_UNKNOWN,
 		                                            b->width(),
 		                                            b->height(),
-		                                            sec,
-		                                            usec);
+		                                            frame.capture_time.get_sec(),
+		                                            frame.capture_time.get_usec());
 		outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_IMAGE, im));
 		free(compressed_buffer);
 	} else {
@@ -405,6 +431,116 @@ FuseServerClientThread::process_getlutlist_message(FuseNetworkMessage *m)
 	outbound_queue_->push(new FuseNetworkMessage(FUSE_MT_LUT_LIST, llm));
 }
 
+/** Process image subscription message.
+ * A message of the wrong size, e.g. from a client of a different protocol
+ * revision, is answered with FUSE_MT_SUBSCRIBE_IMAGE_FAILED.
+ * @param m received message
+ */
+void
+FuseServerClientThread::process_subscribeimage_message(FuseNetworkMessage *m)
+{
+	if (m->payload_size() != sizeof(FUSE_imagesub_message_t)) {
+		LibLogger::log_warn("FuseServerClientThread",
+		                    "Image subscription of invalid size %zu (expected %zu)",
+		                    m->payload_size(),
+		                    sizeof(FUSE_imagesub_message_t));
+		FuseNetworkMessage *nm = new FuseNetworkMessage(FUSE_MT_SUBSCRIBE_IMAGE_FAILED,
+		                                                m->payload(),
+		                                                m->payload_size(),
+		                                                /* copy payload */ true);
+		outbound_queue_->push(nm);
+		return;
+	}
+	FUSE_imagesub_message_t *ism = m->msg<FUSE_imagesub_message_t>();
+
+	char tmp_image_id[IMAGE_ID_MAX_LENGTH + 1];
+	tmp_image_id[IMAGE_ID_MAX_LENGTH] = 0;
+	strncpy(tmp_image_id, ism->image_id, IMAGE_ID_MAX_LENGTH);
+
+	FuseImageStream *stream;
+	try {
+		if ((ism->format != FUSE_IF_RAW) && (ism->format != FUSE_IF_JPEG)) {
+			throw Exception("Unknown image format %u", ism->format);
+		}
+		stream = fuse_server_->subscribe_image(tmp_image_id,
+		                                       (FUSE_image_format_t)ism->format,
+		                                       ntohl(ism->max_width),
+		                                       ntohl(ism->max_height));
+	} catch (Exception &e) {
+		FuseNetworkMessage *nm = new FuseNetworkMessage(FUSE_MT_SUBSCRIBE_IMAGE_FAILED,
+		                                                m->payload(),
+		                                                m->payload_size(),
+		                                                /* copy payload */ true);
+		outbound_queue_->push(nm);
+		return;
+	}
+
+	for (Subscription &sub : subscriptions_) {
+		if (sub.stream == stream) {
+			// subscribed already, just update the rate
+			fuse_server_->unsubscribe_image(stream);
+			sub.period_msec = ntohl(ism->period_msec);
+			return;
+		}
+	}
+
+	Subscription sub;
+	sub.stream      = stream;
+	sub.period_msec = ntohl(ism->period_msec);
+	sub.generation  = 0;
+	sub.last_sent.set_time(0, 0);
+	subscriptions_.push_back(sub);
+}
+
+/** Process image unsubscription message.
+ * Cancels all subscriptions to the given image. Messages of the wrong size
+ * are ignored.
+ * @param m received message
+ */
+void
+FuseServerClientThread::process_unsubscribeimage_message(FuseNetworkMessage *m)
+{
+	if (m->payload_size() != sizeof(FUSE_imagedesc_message_t)) {
+		LibLogger::log_warn("FuseServerClientThread",
+		                    "Image unsubscription of invalid size %zu (expected %zu)",
+		                    m->payload_size(),
+		                    sizeof(FUSE_imagedesc_message_t));
+		return;
+	}
+	FUSE_imagedesc_message_t *idm = m->msg<FUSE_imagedesc_message_t>();
+
+	char tmp_image_id[IMAGE_ID_MAX_LENGTH + 1];
+	tmp_image_id[IMAGE_ID_MAX_LENGTH] = 0;
+	strncpy(tmp_image_id, idm->image_id, IMAGE_ID_MAX_LENGTH);
+
+	std::list<Subscription>::iterator s = subscriptions_.begin();
+	while (s != subscriptions_.end()) {
+		if (strcmp(s->stream->image_id(), tmp_image_id) == 0) {
+			fuse_server_->unsubscribe_image(s->stream);
+			s = subscriptions_.erase(s);
+		} else {
+			++s;
+		}
+	}
+}
+
+/** Queue new images of subscribed streams. */
+void
+FuseServerClientThread::process_subscriptions()
+{
+	Time now;
+	for (Subscription &sub : subscriptions_) {
+		if ((now - &sub.last_sent) * 1000. < sub.period_msec)
+			continue;
+
+		FuseNetworkMessage *m = sub.stream->latest(sub.generation);
+		if (m) {
+			outbound_queue_->push(m);
+			sub.last_sent = now;
+		}
+	}
+}
+
 /** Process inbound messages. */
 void
 FuseServerClientThread::process_inbound()
@@ -422,6 +558,8 @@ FuseServerClientThread::process_inbound()
 			case FUSE_MT_GET_LUT_LIST: process_getlutlist_message(m); break;
 			case FUSE_MT_GET_LUT: process_getlut_message(m); break;
 			case FUSE_MT_SET_LUT: process_setlut_message(m); break;
+			case FUSE_MT_SUBSCRIBE_IMAGE: process_subscribeimage_message(m); break;
+			case FUSE_MT_UNSUBSCRIBE_IMAGE: process_unsubscribeimage_message(m); break;
 			default: throw Exception("Unknown message type received\n");
 			}
 		} catch (Exception &e) {
@@ -468,6 +606,9 @@ FuseServerClientThread::loop()
 	}
 
 	if (alive_) {
+		if (!subscriptions_.empty()) {
+			process_subscriptions();
+		}
 		send();
 	}
 }
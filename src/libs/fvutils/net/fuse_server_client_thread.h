@@ -25,7 +25,9 @@
 #define _FIREVISION_FVUTILS_NET_FUSE_SERVER_CLIENT_THREAD_H_
 
 #include <core/threading/thread.h>
+#include <utils/time/time.h>
 
+#include <list>
 #include <map>
 #include <string>
 
@@ -40,6 +42,7 @@ class FuseNetworkMessage;
 class SharedMemoryImageBuffer;
 class SharedMemoryLookupTable;
 class JpegImageCompressor;
+class FuseImageStream;
 
 class FuseServerClientThread : public fawkes::Thread
 {
@@ -58,9 +61,12 @@ public:
 	void process_getlut_message(FuseNetworkMessage *m);
 	void process_setlut_message(FuseNetworkMessage *m);
 	void process_getlutlist_message(FuseNetworkMessage *m);
+	void process_subscribeimage_message(FuseNetworkMessage *m);
+	void process_unsubscribeimage_message(FuseNetworkMessage *m);
 
 private:
 	void                     process_inbound();
+	void                     process_subscriptions();
 	SharedMemoryImageBuffer *get_shmimgbuf(const char *id);
 
 	FuseServer *          fuse_server_;
@@ -77,6 +83,17 @@ private:
 	std::map<std::string, SharedMemoryLookupTable *>           luts_;
 	std::map<std::string, SharedMemoryLookupTable *>::iterator lit_;
 
+	/// @cond INTERNALS
+	typedef struct
+	{
+		FuseImageStream *stream;
+		unsigned int     period_msec;
+		unsigned long    generation;
+		fawkes::Time     last_sent;
+	} Subscription;
+	/// @endcond
+	std::list<Subscription> subscriptions_;
+
 	bool alive_;
 };
 
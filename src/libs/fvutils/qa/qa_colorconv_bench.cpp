@@ -0,0 +1,179 @@
+
+/***************************************************************************
+ *  qa_colorconv_bench.cpp - Benchmark colorspace conversions
+ *
+ *  Created: Fri Oct 16 12:41:09 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+// Runs all conversions supported by convert() on random images in 720p,
+// 1080p, and an odd size with the plain C implementation, each SIMD
+// extension supported by the CPU, and a thread pool. The output of the vectorized conversions
+// must be identical to the plain C conversions.
+
+#include <core/exception.h>
+#include <fvutils/color/colorspaces.h>
+#include <fvutils/color/conversion_thread_pool.h>
+#include <fvutils/color/conversions.h>
+#include <fvutils/color/conversions_simd.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unistd.h>
+
+using namespace fawkes;
+using namespace firevision;
+
+static double
+time_conversion(colorspace_t          from,
+                colorspace_t          to,
+                const unsigned char * src,
+                unsigned char *       dst,
+                unsigned int          width,
+                unsigned int          height,
+                ConversionThreadPool *pool,
+                cpu_simd_t            simd,
+                unsigned int          iterations)
+{
+	Time start, end;
+	start.stamp();
+	for (unsigned int i = 0; i < iterations; ++i) {
+		convert(from, to, src, dst, width, height, pool, simd);
+	}
+	end.stamp();
+	return (end - &start) * 1000. / iterations;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int iterations  = 10;
+	unsigned int num_threads = 0;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:t:h")) != -1) {
+		switch (opt) {
+		case 'n': iterations = atoi(optarg); break;
+		case 't': num_threads = atoi(optarg); break;
+		default:
+			printf("Usage: %s [-n iterations] [-t threads]\n", argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	const unsigned int sizes[][2] = {{1280, 720}, {1920, 1080}, {750, 481}};
+	const cpu_simd_t   simds[]    = {CPU_SIMD_SSE2, CPU_SIMD_AVX2, CPU_SIMD_NEON};
+
+	ConversionThreadPool pool(num_threads);
+	cpu_simd_t           best = cpu_simd_support();
+	std::mt19937         gen(42);
+	unsigned int         failures = 0;
+
+	printf("CPU supports %s, pool with %u threads, %u iterations\n",
+	       cpu_simd_to_string(best),
+	       pool.num_threads(),
+	       iterations);
+
+	for (const auto &size : sizes) {
+		unsigned int width = size[0], height = size[1];
+		printf("\n%ux%u, time per image in ms\n", width, height);
+
+		for (int f = RGB; f < COLORSPACE_N; ++f) {
+			for (int t = RGB; t < COLORSPACE_N; ++t) {
+				colorspace_t from = (colorspace_t)f, to = (colorspace_t)t;
+				size_t       src_size = colorspace_buffer_size(from, width, height);
+				size_t       dst_size = colorspace_buffer_size(to, width, height);
+				if ((from == to) || (src_size == 0) || (dst_size == 0))
+					continue;
+				// plain C conversion which accesses memory outside its buffers
+				if ((from == RGB) && (to == YUV411_PACKED))
+					continue;
+
+				// some plain C conversions access a few bytes beyond the image
+				size_t         padding = (size_t)width * 4;
+				unsigned char *src     = (unsigned char *)calloc(src_size + padding, 1);
+				unsigned char *ref     = (unsigned char *)calloc(dst_size + padding, 1);
+				unsigned char *dst     = (unsigned char *)calloc(dst_size + padding, 1);
+				for (size_t i = 0; i < src_size; ++i) {
+					src[i] = gen() & 0xff;
+				}
+
+				try {
+					convert(from, to, src, ref, width, height, NULL, CPU_SIMD_NONE);
+				} catch (Exception &e) {
+					// conversion not supported
+					free(src);
+					free(ref);
+					free(dst);
+					continue;
+				}
+
+				double plain =
+				  time_conversion(from, to, src, ref, width, height, NULL, CPU_SIMD_NONE, iterations);
+				printf("%-18s -> %-18s plain %7.3f",
+				       colorspace_to_string(from),
+				       colorspace_to_string(to),
+				       plain);
+
+				for (cpu_simd_t simd : simds) {
+					if (!row_conversion(from, to, simd))
+						continue;
+
+					memset(dst, 0, dst_size);
+					double sec = time_conversion(from, to, src, dst, width, height, NULL, simd, iterations);
+					bool   ok  = (memcmp(dst, ref, dst_size) == 0);
+					printf("  %s %7.3f (%4.1fx)%s",
+					       cpu_simd_to_string(simd),
+					       sec,
+					       plain / sec,
+					       ok ? "" : " MISMATCH");
+					failures += ok ? 0 : 1;
+				}
+
+				if (row_conversion(from, to, best)) {
+					memset(dst, 0, dst_size);
+					double sec = time_conversion(from, to, src, dst, width, height, &pool, best, iterations);
+					bool   ok  = (memcmp(dst, ref, dst_size) == 0);
+					printf("  %u threads %7.3f (%4.1fx)%s",
+					       pool.num_threads(),
+					       sec,
+					       plain / sec,
+					       ok ? "" : " MISMATCH");
+					failures += ok ? 0 : 1;
+				}
+				printf("\n");
+
+				free(src);
+				free(ref);
+				free(dst);
+			}
+		}
+	}
+
+	if (failures > 0) {
+		printf("\n%u vectorized conversions differ from plain C\n", failures);
+	}
+	return failures ? 1 : 0;
+}
+
+/// @endcond
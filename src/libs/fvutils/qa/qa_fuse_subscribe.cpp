@@ -0,0 +1,219 @@
+
+/***************************************************************************
+ *  qa_fuse_subscribe.cpp - QA for FUSE image subscriptions
+ *
+ *  Created: Sat Oct 17 03:12:40 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <fvutils/ipc/shm_image.h>
+#include <fvutils/net/fuse_client.h>
+#include <fvutils/net/fuse_client_handler.h>
+#include <fvutils/net/fuse_image_content.h>
+#include <fvutils/net/fuse_message.h>
+#include <fvutils/net/fuse_server.h>
+#include <utils/time/time.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define IMAGE_ID "qa-fuse-subscribe"
+#define WIDTH 64
+#define HEIGHT 48
+#define NUM_SLOTS 3
+#define NUM_IMAGES 100
+
+class SubscribeHandler : public FuseClientHandler
+{
+public:
+	SubscribeHandler()
+	{
+		num_images      = 0;
+		num_failed      = 0;
+		num_torn        = 0;
+		num_wrong_size  = 0;
+		num_out_of_date = 0;
+		last_value      = 0;
+		died            = false;
+	}
+
+	virtual void
+	fuse_invalid_server_version(uint32_t local_version, uint32_t remote_version) throw()
+	{
+		died = true;
+	}
+
+	virtual void
+	fuse_connection_established() throw()
+	{
+	}
+
+	virtual void
+	fuse_connection_died() throw()
+	{
+		died = true;
+	}
+
+	virtual void
+	fuse_inbound_received(FuseNetworkMessage *m) throw()
+	{
+		if (m->type() == FUSE_MT_SUBSCRIBE_IMAGE_FAILED) {
+			num_failed += 1;
+		} else if (m->type() == FUSE_MT_IMAGE) {
+			try {
+				FuseImageContent *ic = m->msgc<FuseImageContent>();
+				if ((ic->pixel_width() != WIDTH) || (ic->pixel_height() != HEIGHT)
+				    || (ic->buffer_size() != colorspace_buffer_size(YUV422_PLANAR, WIDTH, HEIGHT))) {
+					num_wrong_size += 1;
+				} else {
+					// the writer fills each image with a single value
+					unsigned char *buf = ic->buffer();
+					for (size_t i = 1; i < ic->buffer_size(); ++i) {
+						if (buf[i] != buf[0]) {
+							num_torn += 1;
+							break;
+						}
+					}
+					if (buf[0] <= last_value) {
+						num_out_of_date += 1;
+					}
+					last_value = buf[0];
+				}
+				delete ic;
+			} catch (Exception &e) {
+				num_wrong_size += 1;
+			}
+			num_images += 1;
+		}
+	}
+
+	std::atomic<unsigned int> num_images;
+	std::atomic<unsigned int> num_failed;
+	std::atomic<unsigned int> num_torn;
+	std::atomic<unsigned int> num_wrong_size;
+	std::atomic<unsigned int> num_out_of_date;
+	std::atomic<bool>         died;
+	unsigned char             last_value;
+};
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static bool
+wait_for(const std::atomic<unsigned int> &value, unsigned int expected)
+{
+	for (unsigned int i = 0; i < 200 && value < expected; ++i) {
+		usleep(10000);
+	}
+	return value >= expected;
+}
+
+static void
+write_images(SharedMemoryImageBuffer *w, unsigned int first, unsigned int num)
+{
+	for (unsigned int n = first; n < first + num; ++n) {
+		Time t;
+		memset(w->begin_write(), n & 0xff, w->image_size());
+		w->end_write(&t);
+		usleep(5000);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	int                failures = 0;
+	unsigned short int port     = (argc > 1) ? atoi(argv[1]) : 5917;
+
+	SharedMemoryImageBuffer::wipe(IMAGE_ID);
+	SharedMemoryImageBuffer *w =
+	  new SharedMemoryImageBuffer(IMAGE_ID, YUV422_PLANAR, WIDTH, HEIGHT, NUM_SLOTS);
+
+	FuseServer *fs = new FuseServer(true, false, "127.0.0.1", "", port);
+	fs->start();
+
+	SubscribeHandler handler;
+	FuseClient *     fc = new FuseClient("127.0.0.1", port, &handler);
+	fc->connect();
+	fc->start();
+	fc->wait_greeting();
+
+	// a subscription of the wrong size is rejected, the connection is kept
+	FUSE_imagedesc_message_t *idm =
+	  (FUSE_imagedesc_message_t *)calloc(1, sizeof(FUSE_imagedesc_message_t));
+	strncpy(idm->image_id, IMAGE_ID, IMAGE_ID_MAX_LENGTH - 1);
+	fc->enqueue(FUSE_MT_SUBSCRIBE_IMAGE, idm, sizeof(FUSE_imagedesc_message_t));
+	failures += check(wait_for(handler.num_failed, 1) && !handler.died,
+	                  "Subscription of wrong size rejected");
+
+	fc->subscribe_image("qa-fuse-no-such-image", FUSE_IF_RAW);
+	failures += check(wait_for(handler.num_failed, 2) && !handler.died,
+	                  "Subscription of unknown image rejected");
+
+	// an unsubscription of the wrong size is ignored
+	FUSE_imagesub_message_t *ism =
+	  (FUSE_imagesub_message_t *)calloc(1, sizeof(FUSE_imagesub_message_t));
+	fc->enqueue(FUSE_MT_UNSUBSCRIBE_IMAGE, ism, sizeof(FUSE_imagesub_message_t));
+
+	// images are pushed without further requests
+	fc->subscribe_image(IMAGE_ID, FUSE_IF_RAW);
+	usleep(50000);
+	write_images(w, 1, NUM_IMAGES);
+	bool received = wait_for(handler.num_images, NUM_IMAGES / 4);
+	printf("%u of %u images received\n", (unsigned int)handler.num_images, NUM_IMAGES);
+	failures += check(received && !handler.died, "Subscribed images received");
+	failures += check(handler.num_wrong_size == 0 && handler.num_torn == 0,
+	                  "Received images complete and consistent");
+	failures += check(handler.num_out_of_date == 0, "Received images in order");
+	failures += check(handler.num_failed == 2, "No unexpected failures");
+
+	// no more images after unsubscribing
+	fc->unsubscribe_image(IMAGE_ID);
+	usleep(100000);
+	unsigned int num_images = handler.num_images;
+	write_images(w, NUM_IMAGES + 1, 20);
+	usleep(100000);
+	failures +=
+	  check(handler.num_images == num_images && !handler.died, "No images after unsubscribe");
+
+	fc->disconnect();
+	fc->cancel();
+	fc->join();
+	delete fc;
+
+	fs->cancel();
+	fs->join();
+	delete fs;
+	delete w;
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -35,8 +35,8 @@ main(int argc, char **argv)
 {
 	SharedMemoryImageBuffer *buf, *buf2;
 
-	buf  = new SharedMemoryImageBuffer("QA test image", YUV422_PLANAR, 100, 100);
-	buf2 = new SharedMemoryImageBuffer("QA test image 2", YUV422_PLANAR, 100, 100);
+	buf  = new SharedMemoryImageBuffer("QA test image", YUV422_PLANAR, 100, 100, /* slots */ 1);
+	buf2 = new SharedMemoryImageBuffer("QA test image 2", YUV422_PLANAR, 100, 100, /* slots */ 1);
 
 	if (buf->is_valid()) {
 		cout << "IS valid!" << endl;
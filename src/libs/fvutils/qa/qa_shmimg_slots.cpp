@@ -0,0 +1,213 @@
+
+/***************************************************************************
+ *  qa_shmimg_slots.cpp - QA for lock-free shared memory image ring buffer
+ *
+ *  Created: Fri Oct 16 13:52:40 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <fvutils/ipc/shm_image.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+using namespace firevision;
+
+#define IMAGE_ID "QA slot image"
+#define WIDTH 320
+#define HEIGHT 240
+#define NUM_SLOTS 4
+#define NUM_IMAGES 5000
+
+static bool
+uniform(const unsigned char *buffer, size_t size)
+{
+	for (size_t i = 1; i < size; ++i) {
+		if (buffer[i] != buffer[0])
+			return false;
+	}
+	return true;
+}
+
+int
+main(int argc, char **argv)
+{
+	SharedMemoryImageBuffer::wipe(IMAGE_ID);
+
+	SharedMemoryImageBuffer *w;
+	SharedMemoryImageBuffer *r;
+	int                      failures = 0;
+
+	// single slot, images are written in place as before
+	try {
+		w = new SharedMemoryImageBuffer(IMAGE_ID, YUV422_PLANAR, WIDTH, HEIGHT, /* slots */ 1);
+		r = new SharedMemoryImageBuffer(IMAGE_ID);
+	} catch (Exception &e) {
+		e.print_trace();
+		return 1;
+	}
+
+	SharedMemoryImageBuffer::Frame frame;
+	std::vector<unsigned char>     copy(w->image_size());
+	Time                           t;
+
+	w->lock_for_write();
+	memset(w->buffer(), 42, w->image_size());
+	t.stamp();
+	w->set_capture_time(&t);
+	w->unlock();
+	if ((r->num_slots() != 1) || (r->buffer()[0] != 42)
+	    || (r->image_size() != colorspace_buffer_size(YUV422_PLANAR, WIDTH, HEIGHT))
+	    || !r->copy_latest(copy.data(), frame) || (copy[0] != 42) || (frame.capture_time != t)) {
+		printf("FAIL: single slot image not read correctly\n");
+		++failures;
+	}
+	printf("Single slot: %s\n", failures ? "FAILED" : "OK");
+
+	delete r;
+	delete w;
+
+	// ring buffer
+	try {
+		w = new SharedMemoryImageBuffer(IMAGE_ID, YUV422_PLANAR, WIDTH, HEIGHT, NUM_SLOTS);
+		r = new SharedMemoryImageBuffer(IMAGE_ID);
+	} catch (Exception &e) {
+		e.print_trace();
+		return 1;
+	}
+
+	if ((r->num_slots() != NUM_SLOTS) || r->read_latest(frame)) {
+		printf("FAIL: got image from empty buffer\n");
+		++failures;
+	}
+
+	Time times[2 * NUM_SLOTS];
+	for (unsigned int n = 1; n <= 2 * NUM_SLOTS; ++n) {
+		memset(w->begin_write(), n, w->image_size());
+		times[n - 1].stamp();
+		w->end_write(&times[n - 1]);
+	}
+	for (unsigned int n = 1; n <= 2 * NUM_SLOTS; ++n) {
+		bool available = (n > NUM_SLOTS);
+		bool ok        = r->read(n, frame);
+		if (ok != available
+		    || (ok
+		        && ((frame.seq != n) || (frame.buffer[0] != n) || (frame.capture_time != times[n - 1])
+		            || !r->is_valid(frame)))) {
+			printf("FAIL: image %u not read correctly\n", n);
+			++failures;
+		}
+	}
+	if (r->read(2 * NUM_SLOTS + 1, frame) || !r->read_latest(frame) || (frame.seq != 2 * NUM_SLOTS)
+	    || (r->buffer() != frame.buffer) || (r->capture_time() != times[2 * NUM_SLOTS - 1])
+	    || (w->buffer()[0] == 2 * NUM_SLOTS)) {
+		printf("FAIL: latest image not read correctly\n");
+		++failures;
+	}
+	printf("Specific images: %s\n", failures ? "FAILED" : "OK");
+
+	// cameras capture to the slots directly, some only to page-aligned buffers
+	for (unsigned int i = 0; i < NUM_SLOTS; ++i) {
+		if (((uintptr_t)w->slot_buffer(i) % sysconf(_SC_PAGESIZE) != 0)
+		    || ((uintptr_t)r->slot_buffer(i) % sysconf(_SC_PAGESIZE) != 0)) {
+			printf("FAIL: slot %u not page-aligned\n", i);
+			++failures;
+		}
+	}
+	printf("Page-aligned slots: %s\n", failures ? "FAILED" : "OK");
+
+	// writing ahead, as done when capturing to several slots at once
+	unsigned char *ahead[NUM_SLOTS - 1];
+	for (unsigned int i = 0; i < NUM_SLOTS - 1; ++i) {
+		ahead[i] = w->begin_write(i);
+	}
+	uint64_t next = 2 * NUM_SLOTS + 1;
+	for (unsigned int i = 0; i < NUM_SLOTS - 1; ++i) {
+		memset(ahead[i], 100 + i, w->image_size());
+	}
+	if (r->read(next + 1, frame) || !r->read_latest(frame) || (frame.seq != next - 1)) {
+		printf("FAIL: image written ahead visible too early\n");
+		++failures;
+	}
+	for (unsigned int i = 0; i < NUM_SLOTS - 1; ++i) {
+		w->end_write(&t);
+		if (!r->read(next + i, frame) || (frame.buffer[0] != 100 + i)) {
+			printf("FAIL: image written ahead not read correctly\n");
+			++failures;
+		}
+	}
+	try {
+		w->begin_write(NUM_SLOTS - 1);
+		printf("FAIL: latest image may be overwritten\n");
+		++failures;
+	} catch (Exception &e) {
+	} // expected
+	printf("Writing ahead: %s\n", failures ? "FAILED" : "OK");
+
+	// concurrent writer, each image consists of its sequence number only,
+	// a reader must never see a mixed image which it considers valid
+	std::atomic<bool> done(false);
+	std::thread       writer([&]() {
+    for (unsigned int n = 1; n <= NUM_IMAGES; ++n) {
+      memset(w->begin_write(), n & 0xff, w->image_size());
+      w->end_write(&t);
+    }
+    done = true;
+  });
+
+	unsigned int num_read = 0, num_invalid = 0, num_torn = 0;
+	while (!done) {
+		if (!r->read_latest(frame))
+			continue;
+		bool mixed = !uniform(frame.buffer, r->image_size());
+		if (!r->is_valid(frame)) {
+			++num_invalid;
+		} else if (mixed) {
+			++num_torn;
+		} else {
+			++num_read;
+		}
+
+		if (r->copy_latest(copy.data(), frame) && !uniform(copy.data(), copy.size())) {
+			++num_torn;
+		}
+	}
+	writer.join();
+
+	printf("Concurrent access: %u images read, %u overwritten while reading, %u torn: %s\n",
+	       num_read,
+	       num_invalid,
+	       num_torn,
+	       num_torn ? "FAILED" : "OK");
+	failures += num_torn;
+
+	delete r;
+	delete w;
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -42,7 +42,7 @@ main(int argc, char **argv)
 
 	//  unsigned char *yuv422_planar = malloc_buffer(YUV422_PLANAR, WIDTH, HEIGHT);
 	SharedMemoryImageBuffer *shm =
-	  new SharedMemoryImageBuffer("fv_qa_yuvconv", YUV422_PLANAR, WIDTH, HEIGHT);
+	  new SharedMemoryImageBuffer("fv_qa_yuvconv", YUV422_PLANAR, WIDTH, HEIGHT, /* slots */ 1);
 	unsigned char *yuv422_planar = shm->buffer();
 
 	yuv422packed_to_yuv422planar(yuv422_packed, yuv422_planar, WIDTH, HEIGHT);
@@ -36,6 +36,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <regex.h>
+#include <sched.h>
 #include <typeinfo>
 
 namespace fawkes {
@@ -142,6 +143,19 @@ InterfaceInvalidException::InterfaceInvalidException(const Interface *interface,
  * section. Upon opening the interface, the private section is copied
  * once from the shared section, even when opening a writer.
  *
+ * Since an interface has at most one writer, a reader can opt in to
+ * lock-free reading with set_lockfree_read(). Then read() does not
+ * acquire the ReadWriteLock. Instead, the writer maintains a sequence
+ * counter in the memory chunk header which is odd while it is copying
+ * data to the shared section. Readers copy the shared section
+ * optimistically and retry if the counter indicates that the data was
+ * modified during the copy. Hence many readers polling the same
+ * interface do not contend on the lock, and the scheme works for the
+ * heap-backed as well as for the shared memory BlackBoard. Note that
+ * a lock-free reader may spin while the writer updates the interface,
+ * and that it does not block the writer. Readers which do not enable
+ * it keep using the ReadWriteLock.
+ *
  * An interface has an internal timestamp. This timestamp indicates
  * when the data in the interface has been modified last. The
  * timestamp is usually automatically updated. But it some occasions
@@ -234,6 +248,8 @@ Interface::Interface()
 {
 	write_access_         = false;
 	rwlock_               = NULL;
+	mem_data_seq_         = NULL;
+	lockfree_read_        = false;
 	valid_                = true;
 	next_message_id_      = 0;
 	num_fields_           = 0;
@@ -465,12 +481,29 @@ Interface::is_valid() const
 }
 
 /** Read from BlackBoard into local copy.
+ * If lock-free reading has been enabled the data is copied using
+ * the sequence lock of the memory chunk, otherwise the read lock of the
+ * interface is acquired for the copy.
  * @exception InterfaceInvalidException thrown if the interface has
  * been marked invalid
  */
 void
 Interface::read()
 {
+	if (lockfree_read_ && mem_data_seq_) {
+		data_mutex_->lock();
+		if (valid_) {
+			copy_shared_data(data_ptr);
+			*local_read_timestamp_ = *timestamp_;
+			timestamp_->set_time(data_ts->timestamp_sec, data_ts->timestamp_usec);
+		} else {
+			data_mutex_->unlock();
+			throw InterfaceInvalidException(this, "read()");
+		}
+		data_mutex_->unlock();
+		return;
+	}
+
 	rwlock_->lock_for_read();
 	data_mutex_->lock();
 	if (valid_) {
@@ -511,7 +544,16 @@ Interface::write()
 			data_changed            = false;
 			do_notify               = true;
 		}
-		memcpy(mem_data_ptr_, data_ptr, data_size);
+		if (mem_data_seq_) {
+			// odd sequence number tells readers that an update is in progress
+			uint32_t seq = __atomic_load_n(mem_data_seq_, __ATOMIC_RELAXED);
+			__atomic_store_n(mem_data_seq_, seq + 1, __ATOMIC_RELAXED);
+			__atomic_thread_fence(__ATOMIC_RELEASE);
+			memcpy(mem_data_ptr_, data_ptr, data_size);
+			__atomic_store_n(mem_data_seq_, seq + 2, __ATOMIC_RELEASE);
+		} else {
+			memcpy(mem_data_ptr_, data_ptr, data_size);
+		}
 	} else {
 		data_mutex_->unlock();
 		rwlock_->unlock();
@@ -524,6 +566,74 @@ Interface::write()
 		interface_mediator_->notify_of_data_change(this);
 }
 
+/** Enable or disable lock-free reading.
+ * With lock-free reading enabled read() and copy_shared_to_buffer() do
+ * not acquire the read lock of the interface but copy the data guarded
+ * by the sequence lock maintained by the writer. It is disabled by
+ * default. Enable it for readers which poll an interface frequently and
+ * do not rely on holding off the writer while reading, for example
+ * readers in the main loop which only need a consistent snapshot.
+ * @param enabled true to enable lock-free reading, false to disable
+ */
+void
+Interface::set_lockfree_read(bool enabled)
+{
+	lockfree_read_ = enabled;
+}
+
+/** Check if lock-free reading is enabled.
+ * @return true if read() copies the data without acquiring the read lock,
+ * false otherwise
+ */
+bool
+Interface::is_lockfree_read() const
+{
+	return lockfree_read_ && mem_data_seq_;
+}
+
+/** Get version of the shared data.
+ * The version changes with every write to the shared memory, be it by
+ * the writer or, for remote interfaces, by received data. Compare it to
+ * the version of a previous call to find out if copying the shared data
+ * can be skipped. The version is read without locking, a write might be
+ * in progress, therefore get the version before copying the data.
+ * @return data version, 0 if the interface has no data sequence counter
+ * and thus has to be assumed to have changed
+ */
+uint32_t
+Interface::data_version() const
+{
+	if (!mem_data_seq_)
+		return 0;
+	return __atomic_load_n(mem_data_seq_, __ATOMIC_ACQUIRE);
+}
+
+/** Copy shared data guarded by sequence lock.
+ * Copies the shared memory section optimistically and retries if the
+ * writer has modified the data during the copy. Must only be called if
+ * a data sequence counter has been set.
+ * @param dest destination buffer of at least data_size bytes
+ */
+void
+Interface::copy_shared_data(void *dest)
+{
+	unsigned int tries = 0;
+	uint32_t     seq_begin, seq_end;
+	do {
+		seq_begin = __atomic_load_n(mem_data_seq_, __ATOMIC_ACQUIRE);
+		if (seq_begin & 1) {
+			// writer is copying, give it a chance to finish
+			if (++tries > 100)
+				sched_yield();
+			seq_end = seq_begin + 1;
+			continue;
+		}
+		memcpy(dest, mem_data_ptr_, data_size);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		seq_end = __atomic_load_n(mem_data_seq_, __ATOMIC_RELAXED);
+	} while (seq_begin != seq_end);
+}
+
 /** Get data size.
  * @return size in bytes of data segment
  */
@@ -575,13 +685,16 @@ Interface::set_mediators(InterfaceMediator *iface_mediator, MessageMediator *msg
  * @param serial mem serial
  * @param real_ptr pointer to whole chunk
  * @param data_ptr pointer to data chunk
+ * @param data_seq pointer to data sequence lock counter in the chunk
+ * header, may be NULL to always use the read/write lock
  */
 void
-Interface::set_memory(unsigned int serial, void *real_ptr, void *data_ptr)
+Interface::set_memory(unsigned int serial, void *real_ptr, void *data_ptr, uint32_t *data_seq)
 {
 	mem_serial_   = serial;
 	mem_real_ptr_ = real_ptr;
 	mem_data_ptr_ = data_ptr;
+	mem_data_seq_ = data_seq;
 }
 
 /** Set read/write info.
@@ -1266,11 +1379,20 @@ Interface::copy_shared_to_buffer(unsigned int buffer)
 		throw OutOfBoundsException("Buffer ID out of bounds", buffer, 0, num_buffers_);
 	}
 
+	void *buf = (char *)buffers_ + buffer * data_size;
+
+	if (lockfree_read_ && mem_data_seq_) {
+		MutexLocker lock(data_mutex_);
+		if (!valid_) {
+			throw InterfaceInvalidException(this, "copy_shared_to_buffer()");
+		}
+		copy_shared_data(buf);
+		return;
+	}
+
 	rwlock_->lock_for_read();
 	data_mutex_->lock();
 
-	void *buf = (char *)buffers_ + buffer * data_size;
-
 	if (valid_) {
 		memcpy(buf, mem_data_ptr_, data_size);
 	} else {
@@ -117,8 +117,11 @@ public:
 	Time         buffer_timestamp(unsigned int buffer);
 	void         buffer_timestamp(unsigned int buffer, Time *timestamp);
 
-	void read();
-	void write();
+	void     read();
+	void     write();
+	void     set_lockfree_read(bool enabled);
+	bool     is_lockfree_read() const;
+	uint32_t data_version() const;
 
 	bool                   has_writer() const;
 	unsigned int           num_readers() const;
@@ -231,9 +234,10 @@ private:
 	void set_type_id(const char *type, const char *id);
 	void set_instance_serial(unsigned short instance_serial);
 	void set_mediators(InterfaceMediator *iface_mediator, MessageMediator *msg_mediator);
-	void set_memory(unsigned int serial, void *real_ptr, void *data_ptr);
+	void set_memory(unsigned int serial, void *real_ptr, void *data_ptr, uint32_t *data_seq);
 	void set_readwrite(bool write_access, RefCountRWLock *rwlock);
 	void set_owner(const char *owner);
+	void copy_shared_data(void *dest);
 
 	inline unsigned int
 	next_msg_id()
@@ -253,8 +257,10 @@ private:
 
 	void *       mem_data_ptr_;
 	void *       mem_real_ptr_;
+	uint32_t *   mem_data_seq_;
 	unsigned int mem_serial_;
 	bool         write_access_;
+	bool         lockfree_read_;
 
 	void *       buffers_;
 	unsigned int num_buffers_;
@@ -69,8 +69,9 @@ LuaContext::LuaContext(bool enable_tracebacks)
 
 	lua_mutex_ = new Mutex();
 
-	start_script_ = NULL;
-	L_            = init_state();
+	start_script_      = NULL;
+	next_chunk_handle_ = 1;
+	L_                 = init_state();
 }
 
 /** Wrapper contstructor.
@@ -83,12 +84,13 @@ LuaContext::LuaContext(bool enable_tracebacks)
  */
 LuaContext::LuaContext(lua_State *L)
 {
-	owns_L_       = false;
-	L_            = L;
-	lua_mutex_    = new Mutex();
-	start_script_ = NULL;
-	fam_          = NULL;
-	fam_thread_   = NULL;
+	owns_L_            = false;
+	L_                 = L;
+	lua_mutex_         = new Mutex();
+	start_script_      = NULL;
+	next_chunk_handle_ = 1;
+	fam_               = NULL;
+	fam_thread_        = NULL;
 }
 
 /** Destructor. */
@@ -294,6 +296,16 @@ LuaContext::restart()
 		lock.relock();
 		lua_State *tL = L_;
 
+		std::map<unsigned int, int> refs;
+		try {
+			compile_chunks(L, refs);
+		} catch (...) {
+			if (!finalize_call_.empty())
+				do_string(L, "%s", finalize_call_.c_str());
+			lua_close(L);
+			throw;
+		}
+
 		try {
 			if (!finalize_call_.empty())
 				do_string(L_, "%s", finalize_call_.c_str());
@@ -305,6 +317,7 @@ LuaContext::restart()
 		}
 
 		L_ = L;
+		chunk_refs_.swap(refs);
 		if (owns_L_)
 			lua_close(tL);
 		owns_L_ = true;
@@ -578,11 +591,21 @@ LuaContext::do_string(const char *format, ...)
  */
 void
 LuaContext::load_string(const char *s)
+{
+	load_string(L_, s);
+}
+
+/** Load Lua string on a specific Lua state.
+ * @param L Lua state to load the string in
+ * @param s string to load
+ */
+void
+LuaContext::load_string(lua_State *L, const char *s)
 {
 	int err;
-	if ((err = luaL_loadstring(L_, s)) != 0) {
-		std::string errmsg = lua_tostring(L_, -1);
-		lua_pop(L_, 1);
+	if ((err = luaL_loadstring(L, s)) != 0) {
+		std::string errmsg = lua_tostring(L, -1);
+		lua_pop(L, 1);
 		switch (err) {
 		case LUA_ERRSYNTAX:
 			throw SyntaxErrorException("Lua syntax error in string '%s': %s", s, errmsg.c_str());
@@ -620,6 +643,90 @@ LuaContext::pcall(int nargs, int nresults, int errfunc)
 	}
 }
 
+/** Compile Lua string.
+ * The string is compiled once and stored as a function in the registry,
+ * call it with call_compiled() to avoid parsing it again, for example
+ * for code which is executed in every loop. The string is compiled again
+ * on restart(), the handle remains valid.
+ * @param s string to compile
+ * @return handle to pass to call_compiled() and release_compiled()
+ * @exception SyntaxErrorException thrown if the string cannot be compiled
+ */
+unsigned int
+LuaContext::compile_string(const char *s)
+{
+	MutexLocker lock(lua_mutex_);
+	load_string(L_, s);
+
+	unsigned int handle = next_chunk_handle_++;
+	chunks_[handle]     = s;
+	chunk_refs_[handle] = luaL_ref(L_, LUA_REGISTRYINDEX);
+	return handle;
+}
+
+/** Execute compiled string.
+ * Executes a string compiled with compile_string(), results are discarded.
+ * @param handle handle returned by compile_string()
+ * @exception Exception thrown if the handle is invalid
+ * @exception LuaRuntimeException thrown for a runtime error during execution
+ */
+void
+LuaContext::call_compiled(unsigned int handle)
+{
+	MutexLocker lock(lua_mutex_);
+
+	std::map<unsigned int, int>::const_iterator r = chunk_refs_.find(handle);
+	if (r == chunk_refs_.end()) {
+		throw Exception("LuaContext: no compiled string with handle %u", handle);
+	}
+	lua_rawgeti(L_, LUA_REGISTRYINDEX, r->second);
+
+	int errfunc = enable_tracebacks_ ? 1 : 0;
+	int err     = lua_pcall(L_, 0, 0, errfunc);
+
+	if (err != 0) {
+		std::string errmsg = lua_tostring(L_, -1);
+		lua_pop(L_, 1);
+		switch (err) {
+		case LUA_ERRRUN: throw LuaRuntimeException("call_compiled", errmsg.c_str());
+
+		case LUA_ERRMEM: throw OutOfMemoryException("Could not execute Lua chunk via pcall");
+
+		case LUA_ERRERR: throw LuaErrorException("call_compiled", errmsg.c_str());
+		}
+	}
+}
+
+/** Release compiled string.
+ * @param handle handle returned by compile_string(), invalid afterwards
+ */
+void
+LuaContext::release_compiled(unsigned int handle)
+{
+	MutexLocker lock(lua_mutex_);
+
+	std::map<unsigned int, int>::iterator r = chunk_refs_.find(handle);
+	if (r != chunk_refs_.end()) {
+		luaL_unref(L_, LUA_REGISTRYINDEX, r->second);
+		chunk_refs_.erase(r);
+	}
+	chunks_.erase(handle);
+}
+
+/** Compile all strings of compile_string() on a specific Lua state.
+ * @param L Lua state to compile the strings in
+ * @param refs upon return maps handles to registry references in L
+ */
+void
+LuaContext::compile_chunks(lua_State *L, std::map<unsigned int, int> &refs)
+{
+	std::map<unsigned int, std::string>::iterator c;
+	for (c = chunks_.begin(); c != chunks_.end(); ++c) {
+		load_string(L, c->second.c_str());
+		refs[c->first] = luaL_ref(L, LUA_REGISTRYINDEX);
+	}
+}
+
 /** Assert that the name is unique.
  * Checks the internal context structures if the name has been used
  * already. It will accept a value that has already been set that is of the same
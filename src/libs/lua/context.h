@@ -73,6 +73,10 @@ public:
 	void load_string(const char *s);
 	void pcall(int nargs = 0, int nresults = 0, int errfunc = 0);
 
+	unsigned int compile_string(const char *s);
+	void         call_compiled(unsigned int handle);
+	void         release_compiled(unsigned int handle);
+
 	void
 	     set_usertype(const char *name, void *data, const char *type_name, const char *name_space = 0);
 	void set_string(const char *name, const char *value);
@@ -150,6 +154,8 @@ private:
 	lua_State *init_state();
 	void       do_string(lua_State *L, const char *format, ...);
 	void       do_file(lua_State *L, const char *s);
+	void       load_string(lua_State *L, const char *s);
+	void       compile_chunks(lua_State *L, std::map<unsigned int, int> &refs);
 	void       assert_unique_name(const char *name, std::string type);
 
 private:
@@ -178,6 +184,10 @@ private:
 	std::map<std::string, lua_CFunction>                            cfuncs_;
 	std::map<std::string, lua_CFunction>::iterator                  cfuncs_it_;
 
+	std::map<unsigned int, std::string> chunks_;
+	std::map<unsigned int, int>         chunk_refs_;
+	unsigned int                        next_chunk_handle_;
+
 	std::string finalize_call_;
 	std::string finalize_prepare_call_;
 	std::string finalize_cancel_call_;
@@ -242,6 +242,7 @@ LuaInterfaceImporter::close_reading_interfaces()
 		blackboard_->close(i->second);
 	}
 	reading_ifs_.clear();
+	buffer_versions_.clear();
 
 	for (ObserverMap::iterator o = observers_.begin(); o != observers_.end(); ++o) {
 		blackboard_->unregister_observer(o->second);
@@ -296,6 +297,8 @@ LuaInterfaceImporter::read()
 }
 
 /** Read from all reading interfaces into a buffer.
+ * Interfaces whose data has not been written since the last call are
+ * skipped, the buffer already holds their current data.
  */
 void
 LuaInterfaceImporter::read_to_buffer()
@@ -308,7 +311,14 @@ LuaInterfaceImporter::read_to_buffer()
 		two_stage_ = true;
 	}
 	for (i = reading_ifs_.begin(); i != reading_ifs_.end(); ++i) {
+		uint32_t version = i->second->data_version();
+		if ((version != 0) && ((version & 1) == 0)) {
+			std::map<Interface *, uint32_t>::iterator v = buffer_versions_.find(i->second);
+			if ((v != buffer_versions_.end()) && (v->second == version))
+				continue;
+		}
 		i->second->copy_shared_to_buffer(0);
+		buffer_versions_[i->second] = version;
 	}
 }
 
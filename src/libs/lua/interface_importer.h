@@ -27,7 +27,9 @@
 #include <core/utils/lock_map.h>
 #include <lua/context_watcher.h>
 
+#include <cstdint>
 #include <list>
+#include <map>
 #include <string>
 
 namespace fawkes {
@@ -105,7 +107,8 @@ private:
 	Configuration *config_;
 	Logger *       logger_;
 
-	bool two_stage_;
+	bool                            two_stage_;
+	std::map<Interface *, uint32_t> buffer_versions_;
 
 	InterfaceMap     reading_ifs_;
 	InterfaceListMap reading_multi_ifs_;
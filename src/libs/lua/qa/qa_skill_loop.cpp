@@ -0,0 +1,119 @@
+
+/***************************************************************************
+ *  qa_skill_loop.cpp - Benchmark a skill loop executed via LuaContext
+ *
+ *  Created: Fri Oct 16 22:31:05 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+// Do not include in api reference
+///@cond QA
+
+#include <core/exception.h>
+#include <lua/context.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace fawkes;
+
+#define LOOP_PERIOD_USEC 10000
+
+// a minimal skill environment, loop() steps a small state machine
+static const char *SKILLENV = "skillenv = { cycles = 0, state = \"INIT\", x = 0.0 }\n"
+                              "function skillenv.loop()\n"
+                              "  local s = skillenv\n"
+                              "  s.cycles = s.cycles + 1\n"
+                              "  if s.state == \"INIT\" then s.state = \"DRIVE\"\n"
+                              "  elseif s.state == \"DRIVE\" then\n"
+                              "    s.x = s.x + 0.01\n"
+                              "    if s.x > 1.0 then s.state = \"FINAL\" end\n"
+                              "  else s.state = \"INIT\"; s.x = 0.0 end\n"
+                              "end\n";
+
+static void
+run(LuaContext &lua, unsigned int cycles, bool compiled, bool paced)
+{
+	unsigned int handle = 0;
+	if (compiled)
+		handle = lua.compile_string("skillenv.loop()");
+
+	double total = 0., max = 0.;
+	Time   start;
+	for (unsigned int i = 0; i < cycles; ++i) {
+		Time cycle_start;
+		if (compiled) {
+			lua.call_compiled(handle);
+		} else {
+			lua.do_string("skillenv.loop()");
+		}
+		double exec_usec = (Time() - &cycle_start) * 1000000.;
+		total += exec_usec;
+		if (exec_usec > max)
+			max = exec_usec;
+
+		if (paced) {
+			long int sleep_usec = LOOP_PERIOD_USEC - (long int)((Time() - &cycle_start) * 1000000.);
+			if (sleep_usec > 0)
+				usleep(sleep_usec);
+		}
+	}
+	double duration = Time() - &start;
+
+	if (compiled)
+		lua.release_compiled(handle);
+
+	printf("%-10s %-8s %8u cycles in %7.3f s: avg %7.2f usec, max %8.2f usec",
+	       compiled ? "compiled" : "do_string",
+	       paced ? "100 Hz" : "free",
+	       cycles,
+	       duration,
+	       total / cycles,
+	       max);
+	if (paced) {
+		printf(", %.3f%% of period\n", total / cycles / LOOP_PERIOD_USEC * 100.);
+	} else {
+		printf(", %.0f cycles/sec\n", cycles / duration);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int paced_cycles = (argc > 1) ? atoi(argv[1]) : 500;
+	unsigned int free_cycles  = (argc > 2) ? atoi(argv[2]) : 1000000;
+
+	try {
+		LuaContext lua;
+		lua.do_string("%s", SKILLENV);
+
+		run(lua, paced_cycles, false, true);
+		run(lua, paced_cycles, true, true);
+		run(lua, free_cycles, false, false);
+		run(lua, free_cycles, true, false);
+	} catch (Exception &e) {
+		e.print_trace();
+		return 1;
+	}
+
+	return 0;
+}
+
+/// @endcond
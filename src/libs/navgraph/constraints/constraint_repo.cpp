@@ -36,6 +36,7 @@ namespace fawkes {
 NavGraphConstraintRepo::NavGraphConstraintRepo()
 {
 	modified_ = false;
+	version_  = 0;
 }
 
 /** Destructor. */
@@ -50,6 +51,7 @@ void
 NavGraphConstraintRepo::register_constraint(NavGraphNodeConstraint *constraint)
 {
 	modified_ = true;
+	version_ += 1;
 	node_constraints_.push_back(constraint);
 }
 
@@ -60,6 +62,7 @@ void
 NavGraphConstraintRepo::register_constraint(NavGraphEdgeConstraint *constraint)
 {
 	modified_ = true;
+	version_ += 1;
 	edge_constraints_.push_back(constraint);
 }
 
@@ -70,6 +73,7 @@ void
 NavGraphConstraintRepo::register_constraint(NavGraphEdgeCostConstraint *constraint)
 {
 	modified_ = true;
+	version_ += 1;
 	edge_cost_constraints_.push_back(constraint);
 }
 
@@ -80,6 +84,7 @@ void
 NavGraphConstraintRepo::unregister_constraint(std::string name)
 {
 	modified_ = true;
+	version_ += 1;
 
 	NodeConstraintList::iterator nc =
 	  std::find_if(node_constraints_.begin(),
@@ -230,6 +235,7 @@ NavGraphConstraintRepo::has_constraints() const
 }
 
 /** Call compute method on all registered constraints.
+ * The version is increased if any constraint reported a change.
  * @return true if any constraint reported a change, false otherwise
  */
 bool
@@ -249,6 +255,9 @@ NavGraphConstraintRepo::compute()
 			modified = true;
 	}
 
+	if (modified) {
+		version_ += 1;
+	}
 	return modified;
 }
 
@@ -457,4 +466,17 @@ NavGraphConstraintRepo::modified(bool reset_modified)
 	}
 }
 
+/** Get version of the constraints.
+ * The version is increased whenever a constraint is registered or
+ * unregistered, and whenever compute() reports a change. It may be used
+ * to determine whether results computed with the constraints are still
+ * valid. Unlike modified() it is never reset.
+ * @return version of the constraints
+ */
+unsigned int
+NavGraphConstraintRepo::version() const
+{
+	return version_;
+}
+
 } // namespace fawkes
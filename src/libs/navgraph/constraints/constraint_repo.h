@@ -85,13 +85,15 @@ public:
 	std::list<std::tuple<std::string, std::string, std::string, float>>
 	cost_factor(const std::vector<fawkes::NavGraphEdge> &edges);
 
-	bool modified(bool reset_modified = false);
+	bool         modified(bool reset_modified = false);
+	unsigned int version() const;
 
 private:
 	NodeConstraintList     node_constraints_;
 	EdgeConstraintList     edge_constraints_;
 	EdgeCostConstraintList edge_cost_constraints_;
 	bool                   modified_;
+	unsigned int           version_;
 };
 } // namespace fawkes
 
@@ -23,6 +23,7 @@
 #include <core/exception.h>
 #include <navgraph/constraints/constraint_repo.h>
 #include <navgraph/navgraph.h>
+#include <navgraph/search_graph.h>
 #include <navgraph/search_state.h>
 #include <utils/math/common.h>
 #include <utils/search/astar.h>
@@ -111,6 +112,7 @@ NavGraph::operator=(const NavGraph &g)
 	nodes_ = g.nodes_;
 	edges_.clear();
 	edges_ = g.edges_;
+	invalidate_search_graph();
 
 	notify_of_change();
 
@@ -465,6 +467,7 @@ NavGraph::add_node(const NavGraphNode &node)
 		nodes_.push_back(node);
 		apply_default_properties(nodes_.back());
 		reachability_calced_ = false;
+		invalidate_search_graph();
 		notify_of_change();
 	}
 }
@@ -601,6 +604,7 @@ NavGraph::add_edge(const NavGraphEdge &edge, NavGraph::EdgeMode mode, bool allow
 		}
 
 		reachability_calced_ = false;
+		invalidate_search_graph();
 		notify_of_change();
 	}
 }
@@ -619,6 +623,7 @@ NavGraph::remove_node(const NavGraphNode &node)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	invalidate_search_graph();
 	notify_of_change();
 }
 
@@ -641,6 +646,7 @@ NavGraph::remove_node(const std::string &node_name)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	invalidate_search_graph();
 	notify_of_change();
 }
 
@@ -685,6 +691,7 @@ NavGraph::remove_edge(const NavGraphEdge &edge)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	invalidate_search_graph();
 	notify_of_change();
 }
 
@@ -704,6 +711,7 @@ NavGraph::remove_edge(const std::string &from, const std::string &to)
 	                            }),
 	             edges_.end());
 	reachability_calced_ = false;
+	invalidate_search_graph();
 	notify_of_change();
 }
 
@@ -718,6 +726,7 @@ NavGraph::update_node(const NavGraphNode &node)
 	std::vector<NavGraphNode>::iterator n = std::find(nodes_.begin(), nodes_.end(), node);
 	if (n != nodes_.end()) {
 		*n = node;
+		invalidate_search_graph();
 	} else {
 		throw Exception("No node with name %s known", node.name().c_str());
 	}
@@ -735,6 +744,7 @@ NavGraph::update_edge(const NavGraphEdge &edge)
 	std::vector<NavGraphEdge>::iterator e = std::find(edges_.begin(), edges_.end(), edge);
 	if (e != edges_.end()) {
 		*e = edge;
+		invalidate_search_graph();
 	} else {
 		throw Exception("No edge from %s to %s is known", edge.from().c_str(), edge.to().c_str());
 	}
@@ -749,6 +759,7 @@ NavGraph::clear()
 	nodes_.clear();
 	edges_.clear();
 	default_properties_.clear();
+	invalidate_search_graph();
 	notify_of_change();
 }
 
@@ -937,6 +948,7 @@ NavGraph::set_search_funcs(navgraph::EstimateFunction estimate_func,
 	search_default_funcs_ = false;
 	search_estimate_func_ = estimate_func;
 	search_cost_func_     = cost_func;
+	invalidate_search_graph();
 }
 
 /** Reset actual and estimated cost function to defaults. */
@@ -946,8 +958,21 @@ NavGraph::unset_search_funcs()
 	search_default_funcs_ = true;
 	search_estimate_func_ = NavGraphSearchState::straight_line_estimate;
 	search_cost_func_     = NavGraphSearchState::euclidean_cost;
+	invalidate_search_graph();
 }
 
+/// @cond INTERNAL
+typedef float (*SearchFunction)(const NavGraphNode &, const NavGraphNode &);
+
+static bool
+is_search_func(const std::function<float(const NavGraphNode &, const NavGraphNode &)> &f,
+               SearchFunction                                                          func)
+{
+	const SearchFunction *target = f.target<SearchFunction>();
+	return target && *target == func;
+}
+/// @endcond
+
 /** Search for a path between two nodes with default distance costs.
  * This function executes an A* search to find an (optimal) path
  * from node @p from to node @p to.
@@ -1076,7 +1101,64 @@ NavGraph::search_path(const NavGraphNode &       from,
 {
 	if (!reachability_calced_)
 		calc_reachability(/* allow multi graph */ true);
+	std::shared_ptr<const NavGraphSearchGraph> graph = search_graph();
+
+	int from_idx = graph->node_index(from.name());
+	int to_idx   = graph->node_index(to.name());
+	if (from_idx < 0 || to_idx < 0) {
+		// nodes which are not part of the graph, only reachable nodes are known
+		return search_path_generic(
+		  from, to, estimate_func, cost_func, use_constraints, compute_constraints);
+	}
+
+	bool default_funcs =
+	  is_search_func(estimate_func, NavGraphSearchState::straight_line_estimate)
+	  && is_search_func(cost_func, NavGraphSearchState::euclidean_cost);
+
+	std::vector<unsigned int> path_idx;
+	float                     cost;
+	if (use_constraints) {
+		constraint_repo_.lock();
+		if (compute_constraints && constraint_repo_->has_constraints()) {
+			constraint_repo_->compute();
+		}
+		cost = graph->search(
+		  from_idx, to_idx, estimate_func, cost_func, default_funcs, *constraint_repo_, path_idx);
+		constraint_repo_.unlock();
+	} else {
+		cost = graph->search(from_idx, to_idx, estimate_func, cost_func, default_funcs, NULL, path_idx);
+	}
+
+	std::vector<fawkes::NavGraphNode> path(path_idx.size());
+	for (unsigned int i = 0; i < path_idx.size(); ++i) {
+		path[i] = graph->node(path_idx[i]);
+	}
+
+	return NavGraphPath(this, path, cost);
+}
 
+/** Search for a path between two nodes using generic A* search.
+ * This uses NavGraphSearchState and the reachable nodes stored in the
+ * nodes. It is used if a node is not part of the graph.
+ * @param from node to search from
+ * @param to goal node
+ * @param estimate_func function to estimate the cost from any node to the goal
+ * @param cost_func function to calculate the cost from a node to another
+ * adjacent node
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository
+ * @param compute_constraints if true re-compute constraints, otherwise use
+ * constraints as-is
+ * @return path from @p from to @p to, empty if no path could be found
+ */
+fawkes::NavGraphPath
+NavGraph::search_path_generic(const NavGraphNode &       from,
+                              const NavGraphNode &       to,
+                              navgraph::EstimateFunction estimate_func,
+                              navgraph::CostFunction     cost_func,
+                              bool                       use_constraints,
+                              bool                       compute_constraints)
+{
 	AStar astar;
 
 	std::vector<AStarState *> a_star_solution;
@@ -1111,6 +1193,102 @@ NavGraph::search_path(const NavGraphNode &       from,
 	return NavGraphPath(this, path, cost);
 }
 
+/** Get compiled search graph.
+ * The graph is compiled if it has been modified since the last search.
+ * The compiled graph is immutable, searches keep it alive even if the
+ * graph is modified concurrently.
+ * @return compiled search graph
+ */
+std::shared_ptr<const NavGraphSearchGraph>
+NavGraph::search_graph()
+{
+	std::lock_guard<std::mutex> lock(search_graph_mutex_);
+	if (!search_graph_) {
+		search_graph_ = std::make_shared<const NavGraphSearchGraph>(nodes_, edges_);
+	}
+	return search_graph_;
+}
+
+/** Invalidate compiled search graph.
+ * Must be called whenever nodes, edges, or the search functions are modified.
+ */
+void
+NavGraph::invalidate_search_graph()
+{
+	std::lock_guard<std::mutex> lock(search_graph_mutex_);
+	search_graph_.reset();
+}
+
+/** Search for the costs of paths between many nodes.
+ * Determines the costs of the shortest paths from each of the nodes in
+ * @p from to each of the nodes in @p to using the currently registered
+ * cost function. This is much faster than running search_path() for each
+ * pair of nodes. For each source node the costs to all nodes are computed
+ * at once, in parallel for multiple source nodes. They are cached until
+ * the graph or the search functions are modified, or the constraints
+ * change. Constraints change when they are registered or unregistered, or
+ * when computing them reports a change, see
+ * NavGraphConstraintRepo::version().
+ * @param from names of nodes to search from
+ * @param to names of goal nodes
+ * @param use_constraints true to respect constraints imposed by the constraint
+ * repository, false to ignore the repository searching as if there were no
+ * constraints whatsoever.
+ * @param compute_constraints if true re-compute constraints, otherwise use constraints
+ * as-is, for example if they have been computed before to check for changes.
+ * @return cost matrix, the element [i][j] is the cost of the path from node
+ * from[i] to node to[j]. It is -1 if there is no such path or if one of the
+ * nodes does not exist.
+ */
+std::vector<std::vector<float>>
+NavGraph::search_costs(const std::vector<std::string> &from,
+                       const std::vector<std::string> &to,
+                       bool                            use_constraints,
+                       bool                            compute_constraints)
+{
+	if (!reachability_calced_)
+		calc_reachability(/* allow multi graph */ true);
+	std::shared_ptr<const NavGraphSearchGraph> graph = search_graph();
+
+	bool default_funcs = is_search_func(search_cost_func_, NavGraphSearchState::euclidean_cost);
+
+	std::shared_ptr<const std::vector<float>> edge_costs;
+	if (use_constraints) {
+		constraint_repo_.lock();
+		if (compute_constraints && constraint_repo_->has_constraints()) {
+			constraint_repo_->compute();
+		}
+		edge_costs = graph->edge_costs(search_cost_func_, default_funcs, *constraint_repo_);
+		constraint_repo_.unlock();
+	} else {
+		edge_costs = graph->edge_costs(search_cost_func_, default_funcs, NULL);
+	}
+
+	std::vector<unsigned int> sources;
+	for (const std::string &f : from) {
+		int idx = graph->node_index(f);
+		if (idx >= 0)
+			sources.push_back(idx);
+	}
+	std::vector<std::vector<float>> rows = graph->cost_rows(edge_costs, sources);
+
+	std::vector<std::vector<float>> rv(from.size(), std::vector<float>(to.size(), -1.f));
+	unsigned int                    r = 0;
+	for (unsigned int i = 0; i < from.size(); ++i) {
+		if (graph->node_index(from[i]) < 0)
+			continue;
+		const std::vector<float> &row = rows[r++];
+		for (unsigned int j = 0; j < to.size(); ++j) {
+			int idx = graph->node_index(to[j]);
+			if (idx >= 0 && std::isfinite(row[idx])) {
+				rv[i][j] = row[idx];
+			}
+		}
+	}
+
+	return rv;
+}
+
 /** Calculate cost between two adjacent nodes.
  * It is not verified whether the nodes are actually adjacent, but the cost
  * function is simply applied. This is done to increase performance.
@@ -1427,6 +1605,7 @@ NavGraph::calc_reachability(bool allow_multi_graph)
 	if (!allow_multi_graph)
 		assert_connected();
 	reachability_calced_ = true;
+	invalidate_search_graph();
 }
 
 /** Generate a unique node name for the given prefix.
@@ -1523,7 +1702,7 @@ NavGraph::notify_of_change() throw()
  * Function called if the graph has been changed.
  */
 
-/** Virtual empty destructor. */
+/** Virtual destructor. */
 NavGraph::ChangeListener::~ChangeListener()
 {
 }
@@ -30,6 +30,8 @@
 
 #include <functional>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -45,6 +47,7 @@ extern const char *PROP_ORIENTATION;
 } // namespace navgraph
 
 class NavGraphConstraintRepo;
+class NavGraphSearchGraph;
 
 class NavGraph
 {
@@ -146,6 +149,11 @@ public:
 	                                 bool                       use_constraints     = true,
 	                                 bool                       compute_constraints = true);
 
+	std::vector<std::vector<float>> search_costs(const std::vector<std::string> &from,
+	                                             const std::vector<std::string> &to,
+	                                             bool use_constraints     = true,
+	                                             bool compute_constraints = true);
+
 	void add_node(const NavGraphNode &node);
 	void add_node_and_connect(const NavGraphNode &node, ConnectionMode conn_mode);
 	void connect_node_to_closest_node(const NavGraphNode &n);
@@ -205,6 +213,16 @@ public:
 	std::string        gen_unique_name(const char *prefix = "U-");
 
 private:
+	fawkes::NavGraphPath search_path_generic(const NavGraphNode &       from,
+	                                         const NavGraphNode &       to,
+	                                         navgraph::EstimateFunction estimate_func,
+	                                         navgraph::CostFunction     cost_func,
+	                                         bool                       use_constraints,
+	                                         bool                       compute_constraints);
+
+	std::shared_ptr<const NavGraphSearchGraph> search_graph();
+	void                                       invalidate_search_graph();
+
 	void assert_valid_edges();
 	void assert_connected();
 	void edge_add_no_intersection(const NavGraphEdge &edge);
@@ -222,7 +240,9 @@ private:
 	navgraph::EstimateFunction search_estimate_func_;
 	navgraph::CostFunction     search_cost_func_;
 
-	bool reachability_calced_;
+	bool                                       reachability_calced_;
+	std::mutex                                 search_graph_mutex_;
+	std::shared_ptr<const NavGraphSearchGraph> search_graph_;
 
 	bool notifications_enabled_;
 };
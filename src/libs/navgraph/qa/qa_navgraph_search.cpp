@@ -0,0 +1,293 @@
+/***************************************************************************
+ *  qa_navgraph_search.cpp - QA for navgraph path search
+ *
+ *  Created: Sat Oct 17 01:50:36 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/constraints/static_list_node_constraint.h>
+#include <navgraph/navgraph.h>
+#include <navgraph/search_state.h>
+#include <utils/search/astar.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace fawkes;
+
+#define GRID_SIZE 30
+#define NUM_QUERIES 300
+#define NUM_THREADS 8
+#define EPSILON 1e-3
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static bool
+close_to(float a, float b)
+{
+	return std::fabs(a - b) <= EPSILON * std::max(1.f, std::fabs(b));
+}
+
+static std::string
+node_name(unsigned int x, unsigned int y)
+{
+	return NavGraph::format_name("N-%u-%u", x, y);
+}
+
+/** Search with the generic A* search on the navgraph search state.
+ * This is how paths were searched before the compiled search graph.
+ */
+static float
+reference_cost(NavGraph &graph, const std::string &from, const std::string &to, bool constraints)
+{
+	AStar                astar;
+	NavGraphSearchState *initial =
+	  new NavGraphSearchState(graph.node(from),
+	                          graph.node(to),
+	                          &graph,
+	                          NavGraphSearchState::straight_line_estimate,
+	                          NavGraphSearchState::euclidean_cost,
+	                          constraints ? *graph.constraint_repo() : NULL);
+	std::vector<AStarState *> solution = astar.solve(initial);
+	return solution.empty() ? -1 : solution.back()->total_estimated_cost;
+}
+
+/** Compare a cost matrix to the costs of paths searched one by one. */
+static bool
+same_as_paths(NavGraph &                             graph,
+              const std::vector<std::string> &       nodes,
+              const std::vector<std::vector<float>> &costs,
+              bool                                   constraints)
+{
+	bool ok = (costs.size() == nodes.size());
+	for (unsigned int i = 0; ok && i < nodes.size(); ++i) {
+		ok = (costs[i].size() == nodes.size());
+		for (unsigned int j = 0; ok && j < nodes.size(); ++j) {
+			NavGraphPath path = graph.search_path(nodes[i], nodes[j], constraints);
+			if (path.empty()) {
+				ok = (costs[i][j] < 0);
+			} else {
+				ok = close_to(costs[i][j], path.cost());
+			}
+		}
+	}
+	return ok;
+}
+
+/** Cost function twice as expensive as the euclidean distance along y. */
+static float
+y_penalty_cost(const NavGraphNode &from, const NavGraphNode &to)
+{
+	return NavGraphSearchState::euclidean_cost(from, to) + std::fabs(to.y() - from.y());
+}
+
+/** Check that a path consists of edges of the graph and has the given cost. */
+static bool
+valid_path(NavGraph &graph, const NavGraphPath &path)
+{
+	const std::vector<NavGraphNode> &nodes = path.nodes();
+	float                            cost  = 0.f;
+	for (unsigned int i = 1; i < nodes.size(); ++i) {
+		if (!graph.edge(nodes[i - 1].name(), nodes[i].name()))
+			return false;
+		cost += NavGraphSearchState::euclidean_cost(nodes[i - 1], nodes[i]);
+	}
+	return close_to(cost, path.cost());
+}
+
+int
+main(int argc, char **argv)
+{
+	int failures = 0;
+	srand(4711);
+
+	// jittered grid with some edges missing and some one-way edges
+	NavGraph graph("QA");
+	for (unsigned int x = 0; x < GRID_SIZE; ++x) {
+		for (unsigned int y = 0; y < GRID_SIZE; ++y) {
+			graph.add_node(NavGraphNode(node_name(x, y),
+			                            x + (rand() % 100) / 250.f,
+			                            y + (rand() % 100) / 250.f));
+		}
+	}
+	for (unsigned int x = 0; x < GRID_SIZE; ++x) {
+		for (unsigned int y = 0; y < GRID_SIZE; ++y) {
+			if (x + 1 < GRID_SIZE && rand() % 8 != 0) {
+				graph.add_edge(NavGraphEdge(node_name(x, y), node_name(x + 1, y), rand() % 6 == 0),
+				               NavGraph::EDGE_FORCE);
+			}
+			if (y + 1 < GRID_SIZE && rand() % 8 != 0) {
+				graph.add_edge(NavGraphEdge(node_name(x, y), node_name(x, y + 1), rand() % 6 == 0),
+				               NavGraph::EDGE_FORCE);
+			}
+		}
+	}
+	graph.calc_reachability(/* allow multi graph */ true);
+
+	std::vector<std::pair<std::string, std::string>> queries;
+	for (unsigned int i = 0; i < NUM_QUERIES; ++i) {
+		queries.push_back(std::make_pair(node_name(rand() % GRID_SIZE, rand() % GRID_SIZE),
+		                                 node_name(rand() % GRID_SIZE, rand() % GRID_SIZE)));
+	}
+
+	// the compiled search must find paths of the same cost as the generic one
+	std::vector<float> ref_costs;
+	bool               ok        = true;
+	unsigned int       num_paths = 0;
+	for (const auto &q : queries) {
+		float        ref  = reference_cost(graph, q.first, q.second, false);
+		NavGraphPath path = graph.search_path(q.first, q.second, false);
+		ref_costs.push_back(ref);
+		if (ref < 0) {
+			ok = ok && path.empty() && path.cost() < 0;
+		} else {
+			ok = ok && close_to(path.cost(), ref) && valid_path(graph, path)
+			     && (path.nodes().front().name() == q.first)
+			     && (path.nodes().back().name() == q.second);
+			num_paths += 1;
+		}
+	}
+	printf("%u of %u queries have a path\n", num_paths, NUM_QUERIES);
+	failures += check(ok && num_paths > 0, "Same costs as generic search");
+
+	// cost matrices must match the costs of the paths searched one by one,
+	// including unknown nodes which get a cost of -1
+	std::vector<std::string> matrix_nodes;
+	for (unsigned int i = 0; i < 20; ++i) {
+		matrix_nodes.push_back(node_name(rand() % GRID_SIZE, rand() % GRID_SIZE));
+	}
+	std::vector<std::string> with_unknown(matrix_nodes);
+	with_unknown.push_back("Unknown");
+	std::vector<std::vector<float>> unknown_costs = graph.search_costs(with_unknown, with_unknown);
+	ok = (unknown_costs.back()[0] == -1.f) && (unknown_costs[0].back() == -1.f)
+	     && same_as_paths(graph, matrix_nodes, graph.search_costs(matrix_nodes, matrix_nodes), false);
+	failures += check(ok, "Cost matrix equals path costs");
+
+	// blocked nodes are avoided by both searches
+	NavGraphStaticListNodeConstraint *c = new NavGraphStaticListNodeConstraint("qa-blocked");
+	for (unsigned int i = 0; i < GRID_SIZE * 3; ++i) {
+		c->add_node(graph.node(node_name(rand() % GRID_SIZE, rand() % GRID_SIZE)));
+	}
+	graph.constraint_repo()->register_constraint(c);
+	ok = true;
+	for (const auto &q : queries) {
+		float        ref  = reference_cost(graph, q.first, q.second, true);
+		NavGraphPath path = graph.search_path(q.first, q.second, true);
+		if (ref < 0) {
+			ok = ok && path.empty();
+		} else {
+			ok = ok && close_to(path.cost(), ref) && valid_path(graph, path);
+		}
+		for (const NavGraphNode &n : path.nodes()) {
+			ok = ok && (n.name() == q.first || !c->has_node(n));
+		}
+	}
+	failures += check(ok, "Same costs with node constraints");
+	failures += check(same_as_paths(graph,
+	                                matrix_nodes,
+	                                graph.search_costs(matrix_nodes, matrix_nodes, true),
+	                                true),
+	                  "Cost matrix with node constraints");
+
+	// cached cost rows are dropped when a constraint changes
+	for (unsigned int i = 0; i < GRID_SIZE; ++i) {
+		c->add_node(graph.node(node_name(i, GRID_SIZE / 2)));
+	}
+	failures += check(same_as_paths(graph,
+	                                matrix_nodes,
+	                                graph.search_costs(matrix_nodes, matrix_nodes, true),
+	                                true),
+	                  "Cost matrix after constraint change");
+	graph.constraint_repo()->unregister_constraint("qa-blocked");
+	delete c;
+	failures += check(same_as_paths(graph,
+	                                matrix_nodes,
+	                                graph.search_costs(matrix_nodes, matrix_nodes, true),
+	                                false),
+	                  "Cost matrix after constraint removal");
+
+	// cached edge costs are dropped when the cost function changes
+	graph.set_search_funcs(NavGraphSearchState::straight_line_estimate, y_penalty_cost);
+	std::vector<std::vector<float>> penalty_costs = graph.search_costs(matrix_nodes, matrix_nodes);
+	ok = same_as_paths(graph, matrix_nodes, penalty_costs, false);
+	graph.unset_search_funcs();
+	std::vector<std::vector<float>> default_costs = graph.search_costs(matrix_nodes, matrix_nodes);
+	ok = ok && same_as_paths(graph, matrix_nodes, default_costs, false);
+	for (unsigned int i = 0; i < matrix_nodes.size(); ++i) {
+		for (unsigned int j = 0; j < matrix_nodes.size(); ++j) {
+			ok = ok && (penalty_costs[i][j] + EPSILON >= default_costs[i][j]);
+		}
+	}
+	failures += check(ok, "Cost matrix with custom cost function");
+
+	// concurrent queries on a graph which has not been compiled yet
+	graph.add_node(NavGraphNode("Isolated", -10.f, -10.f));
+	graph.calc_reachability(/* allow multi graph */ true);
+	std::atomic<bool>        concurrent_ok(true);
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < NUM_THREADS; ++t) {
+		threads.push_back(std::thread([&, t]() {
+			for (unsigned int r = 0; r < 5; ++r) {
+				for (unsigned int i = t; i < queries.size(); i += NUM_THREADS / 2) {
+					NavGraphPath path = graph.search_path(queries[i].first, queries[i].second, false);
+					bool         same =
+					  (ref_costs[i] < 0) ? path.empty() : close_to(path.cost(), ref_costs[i]);
+					if (!same || (!path.empty() && !valid_path(graph, path))) {
+						concurrent_ok = false;
+					}
+				}
+			}
+		}));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+	failures += check(concurrent_ok, "Concurrent queries");
+
+	// the compiled graph follows modifications
+	std::string  from = node_name(0, 0), to = node_name(GRID_SIZE - 1, GRID_SIZE - 1);
+	NavGraphPath before = graph.search_path(from, to, false);
+	graph.add_edge(NavGraphEdge(from, to), NavGraph::EDGE_FORCE);
+	graph.calc_reachability(/* allow multi graph */ true);
+	NavGraphPath after = graph.search_path(from, to, false);
+	ok = (after.size() == 2) && close_to(after.cost(), reference_cost(graph, from, to, false))
+	     && (before.empty() || after.cost() <= before.cost() + EPSILON);
+	failures += check(ok, "Search after modification");
+
+	matrix_nodes.push_back(from);
+	matrix_nodes.push_back(to);
+	std::vector<std::vector<float>> mod_costs = graph.search_costs(matrix_nodes, matrix_nodes);
+	failures += check(same_as_paths(graph, matrix_nodes, mod_costs, false)
+	                    && close_to(mod_costs[mod_costs.size() - 2].back(), after.cost()),
+	                  "Cost matrix after modification");
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -0,0 +1,486 @@
+
+/***************************************************************************
+ *  search_graph.cpp - Graph-based global path planning - compiled search graph
+ *
+ *  Created: Fri Oct 16 22:41:37 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include <navgraph/constraints/constraint_repo.h>
+#include <navgraph/search_graph.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+namespace fawkes {
+
+/// @cond INTERNAL
+typedef struct
+{
+	float        f;
+	unsigned int node;
+} OpenEntry;
+
+/** Per-thread state of A* searches.
+ * Entries are only valid if the corresponding stamp equals the current
+ * search ID, hence nothing must be cleared between searches. The state is
+ * shared by all graphs searched from the same thread.
+ */
+typedef struct
+{
+	uint32_t                  search_id;
+	std::vector<uint32_t>     seen;
+	std::vector<uint32_t>     closed;
+	std::vector<uint32_t>     checked;
+	std::vector<uint8_t>      blocked;
+	std::vector<float>        g;
+	std::vector<float>        h;
+	std::vector<unsigned int> parent;
+	std::vector<OpenEntry>    open;
+} SearchScratch;
+
+static thread_local SearchScratch search_scratch;
+
+static bool
+open_greater(const OpenEntry &a, const OpenEntry &b)
+{
+	return a.f > b.f;
+}
+/// @endcond
+
+/** @class NavGraphSearchGraph <navgraph/search_graph.h>
+ * Compiled representation of a navgraph for path search.
+ * Nodes are identified by their index in the node vector of the graph.
+ * The adjacency is stored in compressed sparse row form together with
+ * the euclidean length of each edge. Searches run A* on flat arrays
+ * which are kept per thread and re-used for subsequent searches.
+ * Costs of edges and of shortest paths from a node to all other nodes
+ * are cached for many-to-many queries.
+ *
+ * The graph is immutable once constructed, it keeps a copy of the nodes.
+ * A modified navgraph is compiled anew. Searches may run concurrently.
+ *
+ * Constraints are evaluated lazily during a search, each node is checked
+ * at most once per search. They are not cached across searches as the
+ * result of a constraint may change without the repository being
+ * modified, for example for timed reservations.
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * Compiles the given graph.
+ * @param nodes nodes of the graph, the index of a node in this vector
+ * is its ID in the compiled graph
+ * @param edges edges of the graph, edges with unknown nodes are ignored
+ */
+NavGraphSearchGraph::NavGraphSearchGraph(const std::vector<NavGraphNode> &nodes,
+                                         const std::vector<NavGraphEdge> &edges)
+: nodes_(nodes), constrained_version_(0)
+{
+	const unsigned int num_nodes = nodes.size();
+
+	index_.reserve(num_nodes);
+	x_.resize(num_nodes);
+	y_.resize(num_nodes);
+	for (unsigned int i = 0; i < num_nodes; ++i) {
+		index_[nodes[i].name()] = i;
+		x_[i]                   = nodes[i].x();
+		y_[i]                   = nodes[i].y();
+	}
+
+	// resolve edges to pairs of indexes, undirected edges in both directions
+	std::vector<std::pair<unsigned int, unsigned int>> arcs;
+	arcs.reserve(2 * edges.size());
+	for (const NavGraphEdge &e : edges) {
+		auto from = index_.find(e.from());
+		auto to   = index_.find(e.to());
+		if (from == index_.end() || to == index_.end())
+			continue;
+		arcs.push_back(std::make_pair(from->second, to->second));
+		if (!e.is_directed()) {
+			arcs.push_back(std::make_pair(to->second, from->second));
+		}
+	}
+	std::sort(arcs.begin(), arcs.end());
+	arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+
+	offsets_.assign(num_nodes + 1, 0);
+	targets_.resize(arcs.size());
+	lengths_.resize(arcs.size());
+	for (unsigned int a = 0; a < arcs.size(); ++a) {
+		const unsigned int from = arcs[a].first, to = arcs[a].second;
+		offsets_[from + 1] += 1;
+		targets_[a] = to;
+		lengths_[a] = sqrtf(powf(x_[to] - x_[from], 2) + powf(y_[to] - y_[from], 2));
+	}
+	for (unsigned int i = 0; i < num_nodes; ++i) {
+		offsets_[i + 1] += offsets_[i];
+	}
+}
+
+/** Get index of a node.
+ * @param node_name name of the node
+ * @return index of the node, -1 if no such node exists
+ */
+int
+NavGraphSearchGraph::node_index(const std::string &node_name) const
+{
+	auto n = index_.find(node_name);
+	return (n != index_.end()) ? (int)n->second : -1;
+}
+
+/** Get node.
+ * @param index index of the node
+ * @return node with the given index as it was when the graph was compiled
+ */
+const NavGraphNode &
+NavGraphSearchGraph::node(unsigned int index) const
+{
+	return nodes_[index];
+}
+
+/** Get number of nodes.
+ * @return number of nodes in compiled graph
+ */
+unsigned int
+NavGraphSearchGraph::num_nodes() const
+{
+	return x_.size();
+}
+
+/** Get number of edges.
+ * @return number of directed edges in compiled graph, undirected edges
+ * of the original graph count twice
+ */
+unsigned int
+NavGraphSearchGraph::num_edges() const
+{
+	return targets_.size();
+}
+
+/** Search for a path.
+ * Runs A* search from node @p from to node @p to. The search state is kept
+ * per thread, searches may run concurrently.
+ * @param from index of node to start from
+ * @param to index of goal node
+ * @param estimate_func function to estimate the cost from a node to the goal
+ * @param cost_func function to calculate the cost between adjacent nodes
+ * @param default_funcs true if @p estimate_func and @p cost_func are the
+ * default straight line estimate and euclidean cost functions. In that case
+ * the pre-computed edge lengths and node positions are used instead.
+ * @param constraint_repo constraint repository to respect, may be NULL.
+ * It must be locked during the search.
+ * @param path upon return contains the indexes of the path nodes from
+ * @p from to @p to, empty if no path could be found
+ * @return cost of the path, -1 if no path could be found
+ */
+float
+NavGraphSearchGraph::search(unsigned int                      from,
+                            unsigned int                      to,
+                            const navgraph::EstimateFunction &estimate_func,
+                            const navgraph::CostFunction &    cost_func,
+                            bool                              default_funcs,
+                            NavGraphConstraintRepo *          constraint_repo,
+                            std::vector<unsigned int> &       path) const
+{
+	path.clear();
+
+	if (constraint_repo && !constraint_repo->has_constraints()) {
+		constraint_repo = NULL;
+	}
+
+	SearchScratch &s = search_scratch;
+	if (s.seen.size() < num_nodes()) {
+		// new entries are zero, which is never a valid search ID
+		s.seen.resize(num_nodes(), 0);
+		s.closed.resize(num_nodes(), 0);
+		s.checked.resize(num_nodes(), 0);
+		s.blocked.resize(num_nodes());
+		s.g.resize(num_nodes());
+		s.h.resize(num_nodes());
+		s.parent.resize(num_nodes());
+		s.open.reserve(num_nodes());
+	}
+	if (++s.search_id == 0) {
+		// wrapped around, stamps of previous searches could become valid again
+		std::fill(s.seen.begin(), s.seen.end(), 0);
+		std::fill(s.closed.begin(), s.closed.end(), 0);
+		std::fill(s.checked.begin(), s.checked.end(), 0);
+		s.search_id = 1;
+	}
+	const uint32_t search_id = s.search_id;
+
+	auto estimate = [&](unsigned int n) -> float {
+		if (default_funcs) {
+			return sqrtf(powf(x_[to] - x_[n], 2) + powf(y_[to] - y_[n], 2));
+		} else {
+			return estimate_func(nodes_[n], nodes_[to]);
+		}
+	};
+
+	// constraints are checked at most once per node and search
+	auto blocked = [&](unsigned int n) -> bool {
+		if (s.checked[n] != search_id) {
+			s.checked[n] = search_id;
+			s.blocked[n] = (constraint_repo->blocks(nodes_[n]) != NULL) ? 1 : 0;
+		}
+		return s.blocked[n] != 0;
+	};
+
+	s.open.clear();
+	s.seen[from]   = search_id;
+	s.g[from]      = 0.f;
+	s.h[from]      = estimate(from);
+	s.parent[from] = from;
+	s.open.push_back({s.h[from], from});
+
+	bool found = false;
+	while (!s.open.empty()) {
+		std::pop_heap(s.open.begin(), s.open.end(), open_greater);
+		const unsigned int n = s.open.back().node;
+		s.open.pop_back();
+
+		// stale entry of a node which has been reached more cheaply before
+		if (s.closed[n] == search_id)
+			continue;
+		s.closed[n] = search_id;
+
+		if (n == to) {
+			found = true;
+			break;
+		}
+
+		for (unsigned int e = offsets_[n]; e < offsets_[n + 1]; ++e) {
+			const unsigned int d = targets_[e];
+			if (s.closed[d] == search_id)
+				continue;
+
+			float d_cost = default_funcs ? lengths_[e] : cost_func(nodes_[n], nodes_[d]);
+
+			if (constraint_repo) {
+				if (blocked(d) || constraint_repo->blocks(nodes_[n], nodes_[d])) {
+					continue;
+				}
+				float cost_factor = 0.;
+				if (constraint_repo->increases_cost(nodes_[n], nodes_[d], cost_factor)) {
+					d_cost *= cost_factor;
+				}
+			}
+
+			const float g = s.g[n] + d_cost;
+			if (s.seen[d] != search_id) {
+				s.seen[d] = search_id;
+				s.h[d]    = estimate(d);
+			} else if (g >= s.g[d]) {
+				continue;
+			}
+			s.g[d]      = g;
+			s.parent[d] = n;
+			s.open.push_back({g + s.h[d], d});
+			std::push_heap(s.open.begin(), s.open.end(), open_greater);
+		}
+	}
+
+	if (!found)
+		return -1;
+
+	for (unsigned int n = to; n != from; n = s.parent[n]) {
+		path.push_back(n);
+	}
+	path.push_back(from);
+	std::reverse(path.begin(), path.end());
+
+	// the estimate of the goal is zero for admissible estimate functions,
+	// add it anyway to report the same cost as the generic A* search
+	return s.g[to] + s.h[to];
+}
+
+/** Calculate effective cost of all edges.
+ * The costs of the edges without constraints are cached for the lifetime
+ * of the compiled graph. The navgraph compiles a new graph whenever it is
+ * modified or its search functions change. The costs including constraints
+ * are cached until the version of the constraint repository changes, that
+ * is when a constraint is registered or unregistered, or when computing
+ * the constraints reports a change.
+ * @param cost_func function to calculate the cost between adjacent nodes,
+ * must be the same for all calls
+ * @param default_funcs true if @p cost_func is the default euclidean cost
+ * function, in that case the pre-computed edge lengths are used
+ * @param constraint_repo constraint repository to respect, may be NULL.
+ * It must be locked during the call and be the same for all calls.
+ * @return cost of each edge in the order of the compiled adjacency. Edges
+ * which are blocked by a constraint, or whose target node is blocked, have
+ * infinite cost.
+ */
+std::shared_ptr<const std::vector<float>>
+NavGraphSearchGraph::edge_costs(const navgraph::CostFunction &cost_func,
+                                bool                          default_funcs,
+                                NavGraphConstraintRepo *      constraint_repo) const
+{
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+
+	if (!base_costs_) {
+		std::vector<float> *costs = new std::vector<float>(lengths_);
+		if (!default_funcs) {
+			for (unsigned int n = 0; n < num_nodes(); ++n) {
+				for (unsigned int e = offsets_[n]; e < offsets_[n + 1]; ++e) {
+					(*costs)[e] = cost_func(nodes_[n], nodes_[targets_[e]]);
+				}
+			}
+		}
+		base_costs_.reset(costs);
+	}
+
+	if (!constraint_repo || !constraint_repo->has_constraints()) {
+		return base_costs_;
+	}
+
+	if (constrained_costs_ && constrained_version_ == constraint_repo->version()) {
+		return constrained_costs_;
+	}
+
+	const float inf = std::numeric_limits<float>::infinity();
+
+	std::vector<uint8_t> blocked(num_nodes(), 0);
+	for (unsigned int n = 0; n < num_nodes(); ++n) {
+		blocked[n] = (constraint_repo->blocks(nodes_[n]) != NULL) ? 1 : 0;
+	}
+
+	std::vector<float> *costs = new std::vector<float>(*base_costs_);
+	for (unsigned int n = 0; n < num_nodes(); ++n) {
+		for (unsigned int e = offsets_[n]; e < offsets_[n + 1]; ++e) {
+			const unsigned int d           = targets_[e];
+			float              cost_factor = 0.;
+			if (blocked[d] || constraint_repo->blocks(nodes_[n], nodes_[d])) {
+				(*costs)[e] = inf;
+			} else if (constraint_repo->increases_cost(nodes_[n], nodes_[d], cost_factor)) {
+				(*costs)[e] *= cost_factor;
+			}
+		}
+	}
+	constrained_costs_.reset(costs);
+	constrained_version_ = constraint_repo->version();
+	return constrained_costs_;
+}
+
+/** Calculate cost of shortest paths from a node to all nodes.
+ * Runs Dijkstra's algorithm. The method only uses local state and may be
+ * called concurrently.
+ * @param from index of node to start from
+ * @param edge_costs edge costs as determined by edge_costs()
+ * @param costs upon return contains the cost of the shortest path to each
+ * node, infinity for nodes which cannot be reached
+ */
+void
+NavGraphSearchGraph::shortest_costs(unsigned int              from,
+                                    const std::vector<float> &edge_costs,
+                                    std::vector<float> &      costs) const
+{
+	costs.assign(num_nodes(), std::numeric_limits<float>::infinity());
+	std::vector<uint8_t>   closed(num_nodes(), 0);
+	std::vector<OpenEntry> open;
+	open.reserve(num_nodes());
+
+	costs[from] = 0.f;
+	open.push_back({0.f, from});
+	while (!open.empty()) {
+		std::pop_heap(open.begin(), open.end(), open_greater);
+		const unsigned int n = open.back().node;
+		open.pop_back();
+
+		if (closed[n])
+			continue;
+		closed[n] = 1;
+
+		for (unsigned int e = offsets_[n]; e < offsets_[n + 1]; ++e) {
+			const unsigned int d = targets_[e];
+			const float        g = costs[n] + edge_costs[e];
+			if (!closed[d] && g < costs[d]) {
+				costs[d] = g;
+				open.push_back({g, d});
+				std::push_heap(open.begin(), open.end(), open_greater);
+			}
+		}
+	}
+}
+
+/** Get cost of shortest paths from source nodes to all nodes.
+ * Rows are cached as long as the edge costs stay the same. The graph
+ * itself is never modified, a modified navgraph is compiled anew with an
+ * empty cache. Missing rows are computed in parallel.
+ * @param edge_costs edge costs as determined by edge_costs()
+ * @param sources indexes of source nodes
+ * @return for each source node the costs to all nodes as computed by
+ * shortest_costs()
+ */
+std::vector<std::vector<float>>
+NavGraphSearchGraph::cost_rows(const std::shared_ptr<const std::vector<float>> &edge_costs,
+                               const std::vector<unsigned int> &                sources) const
+{
+	std::lock_guard<std::mutex> lock(cache_mutex_);
+
+	if (edge_costs != rows_edge_costs_) {
+		// edge_costs() returns the cached costs until constraints change
+		rows_.clear();
+		rows_edge_costs_ = edge_costs;
+	}
+
+	// insert all missing rows before computing them, the map must not be
+	// modified while worker threads access it
+	std::vector<unsigned int>         missing;
+	std::vector<std::vector<float> *> missing_rows;
+	for (unsigned int s : sources) {
+		if (rows_.find(s) == rows_.end()) {
+			missing.push_back(s);
+			missing_rows.push_back(&rows_[s]);
+		}
+	}
+
+	if (!missing.empty()) {
+		std::atomic<unsigned int> next(0);
+
+		auto worker = [&]() {
+			unsigned int i;
+			while ((i = next++) < missing.size()) {
+				shortest_costs(missing[i], *rows_edge_costs_, *missing_rows[i]);
+			}
+		};
+
+		// threads are only spawned if more than one row is missing
+		unsigned int num_threads =
+		  std::min<unsigned int>(std::thread::hardware_concurrency(), missing.size());
+		std::vector<std::thread> threads;
+		for (unsigned int t = 1; t < num_threads; ++t) {
+			threads.push_back(std::thread(worker));
+		}
+		worker();
+		for (std::thread &t : threads) {
+			t.join();
+		}
+	}
+
+	std::vector<std::vector<float>> rv(sources.size());
+	for (unsigned int i = 0; i < sources.size(); ++i) {
+		rv[i] = rows_[sources[i]];
+	}
+	return rv;
+}
+
+} // end of namespace fawkes
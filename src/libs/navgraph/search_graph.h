@@ -0,0 +1,96 @@
+
+/***************************************************************************
+ *  search_graph.h - Graph-based global path planning - compiled search graph
+ *
+ *  Created: Fri Oct 16 22:41:37 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _LIBS_NAVGRAPH_SEARCH_GRAPH_H_
+#define _LIBS_NAVGRAPH_SEARCH_GRAPH_H_
+
+#include <navgraph/navgraph.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fawkes {
+
+class NavGraphConstraintRepo;
+
+class NavGraphSearchGraph
+{
+public:
+	NavGraphSearchGraph(const std::vector<NavGraphNode> &nodes,
+	                    const std::vector<NavGraphEdge> &edges);
+
+	int                 node_index(const std::string &node_name) const;
+	const NavGraphNode &node(unsigned int index) const;
+	unsigned int        num_nodes() const;
+	unsigned int        num_edges() const;
+
+	float search(unsigned int                      from,
+	             unsigned int                      to,
+	             const navgraph::EstimateFunction &estimate_func,
+	             const navgraph::CostFunction &    cost_func,
+	             bool                              default_funcs,
+	             NavGraphConstraintRepo *          constraint_repo,
+	             std::vector<unsigned int> &       path) const;
+
+	std::shared_ptr<const std::vector<float>>
+	edge_costs(const navgraph::CostFunction &cost_func,
+	           bool                          default_funcs,
+	           NavGraphConstraintRepo *      constraint_repo) const;
+
+	void shortest_costs(unsigned int              from,
+	                    const std::vector<float> &edge_costs,
+	                    std::vector<float> &      costs) const;
+
+	std::vector<std::vector<float>>
+	cost_rows(const std::shared_ptr<const std::vector<float>> &edge_costs,
+	          const std::vector<unsigned int> &                sources) const;
+
+private:
+	// copy of the nodes, the index in this vector is the node ID
+	std::vector<NavGraphNode> nodes_;
+
+	// compressed sparse row adjacency, the edges leaving node i are
+	// targets_[offsets_[i]] to targets_[offsets_[i+1] - 1]
+	std::vector<unsigned int>                     offsets_;
+	std::vector<unsigned int>                     targets_;
+	std::vector<float>                            lengths_;
+	std::vector<float>                            x_;
+	std::vector<float>                            y_;
+	std::unordered_map<std::string, unsigned int> index_;
+
+	// costs of edges without and with constraints, the latter for the
+	// given constraint repository version, and costs from a source node to
+	// all nodes for the given edge costs, the caches do not change the
+	// graph itself and are dropped with it
+	mutable std::mutex                                           cache_mutex_;
+	mutable std::shared_ptr<const std::vector<float>>            base_costs_;
+	mutable std::shared_ptr<const std::vector<float>>            constrained_costs_;
+	mutable unsigned int                                         constrained_version_;
+	mutable std::shared_ptr<const std::vector<float>>            rows_edge_costs_;
+	mutable std::unordered_map<unsigned int, std::vector<float>> rows_;
+};
+
+} // end of namespace fawkes
+
+#endif
@@ -22,6 +22,9 @@
  */
 
 #include <core/exception.h>
+#include <core/exceptions/system.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
 #include <netcomm/fawkes/message.h>
 #include <netcomm/fawkes/message_content.h>
 #include <netinet/in.h>
@@ -29,9 +32,105 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 namespace fawkes {
 
+/// @cond INTERNALS
+/** Maximum number of unused message objects kept for re-use. */
+#define MAX_FREE_MESSAGES 256
+/** Maximum number of unused payload buffers kept per size class. */
+#define MAX_FREE_PAYLOADS 64
+/** Size of the smallest payload size class as power of two, 64 bytes. */
+#define MIN_PAYLOAD_SHIFT 6
+/** Number of payload size classes, the largest is 64 KB. */
+#define NUM_PAYLOAD_CLASSES 11
+
+/* Free lists for message objects and received payloads.
+ * Receiving many small messages otherwise is dominated by allocations.
+ * Pooled buffers are allocated with malloc() and can be freed as usual. */
+class FawkesNetworkMessagePool
+{
+public:
+	static FawkesNetworkMessagePool *
+	instance()
+	{
+		// never destroyed, messages may still be deleted during shutdown
+		static FawkesNetworkMessagePool *pool = new FawkesNetworkMessagePool();
+		return pool;
+	}
+
+	void *
+	acquire_message(size_t size)
+	{
+		MutexLocker lock(&mutex_);
+		if (messages_.empty()) {
+			lock.unlock();
+			return ::operator new(size);
+		}
+		void *m = messages_.back();
+		messages_.pop_back();
+		return m;
+	}
+
+	void
+	release_message(void *m)
+	{
+		MutexLocker lock(&mutex_);
+		if (messages_.size() < MAX_FREE_MESSAGES) {
+			messages_.push_back(m);
+		} else {
+			lock.unlock();
+			::operator delete(m);
+		}
+	}
+
+	/* Acquire buffer of at least size bytes, capacity is set to its actual
+	 * size, or to zero if the buffer is not taken from the pool. */
+	void *
+	acquire_payload(size_t size, size_t &capacity)
+	{
+		unsigned int c = 0;
+		while ((c < NUM_PAYLOAD_CLASSES) && (((size_t)1 << (MIN_PAYLOAD_SHIFT + c)) < size))
+			++c;
+		if (c == NUM_PAYLOAD_CLASSES) {
+			capacity = 0;
+			return malloc(size);
+		}
+
+		capacity = (size_t)1 << (MIN_PAYLOAD_SHIFT + c);
+		MutexLocker lock(&mutex_);
+		if (payloads_[c].empty()) {
+			lock.unlock();
+			return malloc(capacity);
+		}
+		void *p = payloads_[c].back();
+		payloads_[c].pop_back();
+		return p;
+	}
+
+	void
+	release_payload(void *p, size_t capacity)
+	{
+		unsigned int c = 0;
+		while (((size_t)1 << (MIN_PAYLOAD_SHIFT + c)) < capacity)
+			++c;
+		MutexLocker lock(&mutex_);
+		if (payloads_[c].size() < MAX_FREE_PAYLOADS) {
+			payloads_[c].push_back(p);
+		} else {
+			lock.unlock();
+			free(p);
+		}
+	}
+
+private:
+	Mutex               mutex_;
+	std::vector<void *> messages_;
+	std::vector<void *> payloads_[NUM_PAYLOAD_CLASSES];
+};
+/// @endcond
+
 /** @class FawkesNetworkMessageTooBigException message.h <netcomm/fawkes/message.h>
  * The given message size exceeds the limit.
  * The message payload can only be of a certain size, which is limited especially
@@ -76,6 +175,10 @@ FawkesNetworkMessageTooBigException::FawkesNetworkMessageTooBigException(size_t
  * FawkesNetworkMessage *m = new FawkesNetworkMessage(clid, cid, msgid, u, sizeof(unsigned int));
  * @endcode
  *
+ * Message objects and the payloads of received messages are taken from and
+ * returned to pools, since typically many small messages are received and
+ * dropped in short succession.
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -87,8 +190,9 @@ FawkesNetworkMessageTooBigException::FawkesNetworkMessageTooBigException(size_t
 FawkesNetworkMessage::FawkesNetworkMessage()
 {
 	memset(&_msg, 0, sizeof(_msg));
-	_clid    = 0;
-	_content = NULL;
+	_clid        = 0;
+	_content     = NULL;
+	_pooled_size = 0;
 }
 
 /** Constructor to set message and client ID.
@@ -97,8 +201,9 @@ FawkesNetworkMessage::FawkesNetworkMessage()
  */
 FawkesNetworkMessage::FawkesNetworkMessage(unsigned int clid, fawkes_message_t &msg)
 {
-	_content = NULL;
-	_clid    = clid;
+	_content     = NULL;
+	_pooled_size = 0;
+	_clid        = clid;
 	memcpy(&_msg, &msg, sizeof(fawkes_message_t));
 }
 
@@ -108,8 +213,9 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int clid, fawkes_message_t &
  */
 FawkesNetworkMessage::FawkesNetworkMessage(fawkes_message_t &msg)
 {
-	_content = NULL;
-	_clid    = 0;
+	_content     = NULL;
+	_pooled_size = 0;
+	_clid        = 0;
 	memcpy(&_msg, &msg, sizeof(fawkes_message_t));
 }
 
@@ -125,8 +231,9 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid,
                                            void *             payload,
                                            size_t             payload_size)
 {
-	_clid    = 0;
-	_content = NULL;
+	_clid        = 0;
+	_content     = NULL;
+	_pooled_size = 0;
 	if (payload_size > 0xFFFFFFFF) {
 		// cannot carry that many bytes
 		throw FawkesNetworkMessageTooBigException(payload_size);
@@ -147,8 +254,9 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid,
                                            unsigned short int msg_id,
                                            size_t             payload_size)
 {
-	_content = NULL;
-	_clid    = 0;
+	_content     = NULL;
+	_pooled_size = 0;
+	_clid        = 0;
 	if (payload_size > 0xFFFFFFFF) {
 		// cannot carry that many bytes
 		throw FawkesNetworkMessageTooBigException(payload_size);
@@ -167,6 +275,7 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid,
 FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int cid, unsigned short int msg_id)
 {
 	_content                 = NULL;
+	_pooled_size             = 0;
 	_clid                    = 0;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -185,6 +294,7 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned short int           cid,
                                            FawkesNetworkMessageContent *content)
 {
 	_content                 = content;
+	_pooled_size             = 0;
 	_clid                    = 0;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -204,6 +314,7 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int                 clid,
                                            FawkesNetworkMessageContent *content)
 {
 	_content                 = content;
+	_pooled_size             = 0;
 	_clid                    = clid;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -224,7 +335,8 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int       clid,
                                            void *             payload,
                                            size_t             payload_size)
 {
-	_content = NULL;
+	_content     = NULL;
+	_pooled_size = 0;
 	if (payload_size > 0xFFFFFFFF) {
 		// cannot carry that many bytes
 		throw FawkesNetworkMessageTooBigException(payload_size);
@@ -246,6 +358,7 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int       clid,
                                            unsigned short int msg_id)
 {
 	_content                 = NULL;
+	_pooled_size             = 0;
 	_clid                    = clid;
 	_msg.header.cid          = htons(cid);
 	_msg.header.msg_id       = htons(msg_id);
@@ -253,13 +366,38 @@ FawkesNetworkMessage::FawkesNetworkMessage(unsigned int       clid,
 	_msg.payload             = NULL;
 }
 
+/** Constructor for received messages.
+ * Allocates a payload buffer of the size given in the header from the
+ * payload pool, the caller has to fill it.
+ * @param header message header as received from the network
+ */
+FawkesNetworkMessage::FawkesNetworkMessage(const fawkes_message_header_t &header)
+{
+	_content    = NULL;
+	_clid       = 0;
+	_msg.header = header;
+	if (header.payload_size != 0) {
+		FawkesNetworkMessagePool *pool = FawkesNetworkMessagePool::instance();
+		_msg.payload = pool->acquire_payload(ntohl(header.payload_size), _pooled_size);
+		if (!_msg.payload) {
+			throw OutOfMemoryException("Cannot allocate network message payload");
+		}
+	} else {
+		_msg.payload = NULL;
+		_pooled_size = 0;
+	}
+}
+
 /** Destructor.
  * This destructor also frees the payload buffer if set!
  */
 FawkesNetworkMessage::~FawkesNetworkMessage()
 {
 	if (_content == NULL) {
-		if (_msg.payload != NULL) {
+		if (_pooled_size > 0) {
+			FawkesNetworkMessagePool::instance()->release_payload(_msg.payload, _pooled_size);
+			_msg.payload = NULL;
+		} else if (_msg.payload != NULL) {
 			free(_msg.payload);
 			_msg.payload = NULL;
 		}
@@ -363,6 +501,7 @@ FawkesNetworkMessage::set_payload(void *payload, size_t payload_size)
 	}
 	_msg.payload             = payload;
 	_msg.header.payload_size = htonl(payload_size);
+	_pooled_size             = 0;
 }
 
 /** Set from message.
@@ -372,6 +511,7 @@ void
 FawkesNetworkMessage::set(fawkes_message_t &msg)
 {
 	memcpy(&_msg, &msg, sizeof(fawkes_message_t));
+	_pooled_size = 0;
 }
 
 /** Set complex message content.
@@ -398,4 +538,33 @@ FawkesNetworkMessage::pack()
 	}
 }
 
+/** Allocate message object.
+ * Message objects are kept in a pool for re-use.
+ * @param size size of the object to allocate
+ * @return memory for the message object
+ */
+void *
+FawkesNetworkMessage::operator new(size_t size)
+{
+	if (size != sizeof(FawkesNetworkMessage)) {
+		// derived class, not pooled
+		return ::operator new(size);
+	}
+	return FawkesNetworkMessagePool::instance()->acquire_message(size);
+}
+
+/** Free message object.
+ * @param ptr message object to free
+ * @param size size of the object
+ */
+void
+FawkesNetworkMessage::operator delete(void *ptr, size_t size)
+{
+	if (size != sizeof(FawkesNetworkMessage)) {
+		::operator delete(ptr);
+	} else {
+		FawkesNetworkMessagePool::instance()->release_message(ptr);
+	}
+}
+
 } // end namespace fawkes
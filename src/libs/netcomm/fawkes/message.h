@@ -78,6 +78,7 @@ class FawkesNetworkMessage : public RefCount
 public:
 	FawkesNetworkMessage(unsigned int clid, fawkes_message_t &msg);
 	FawkesNetworkMessage(fawkes_message_t &msg);
+	FawkesNetworkMessage(const fawkes_message_header_t &header);
 	FawkesNetworkMessage(unsigned int       clid,
 	                     unsigned short int cid,
 	                     unsigned short int msg_id,
@@ -101,6 +102,9 @@ public:
 
 	virtual ~FawkesNetworkMessage();
 
+	static void *operator new(size_t size);
+	static void  operator delete(void *ptr, size_t size);
+
 	unsigned int            clid() const;
 	unsigned short int      cid() const;
 	unsigned short int      msgid() const;
@@ -183,6 +187,7 @@ private:
 
 	unsigned int     _clid;
 	fawkes_message_t _msg;
+	size_t           _pooled_size;
 
 	FawkesNetworkMessageContent *_content;
 };
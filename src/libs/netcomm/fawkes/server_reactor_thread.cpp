@@ -0,0 +1,524 @@
+
+/***************************************************************************
+ *  server_reactor_thread.cpp - Fawkes network server event loop thread
+ *
+ *  Created: Fri Oct 16 21:40:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <core/threading/mutex.h>
+#include <core/threading/mutex_locker.h>
+#include <core/threading/wait_condition.h>
+#include <netcomm/fawkes/message.h>
+#include <netcomm/fawkes/server_reactor_thread.h>
+#include <netcomm/fawkes/server_thread.h>
+#include <netcomm/socket/stream.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace fawkes {
+
+/// @cond INTERNALS
+/** Maximum number of events handled per epoll_wait() call. */
+#define MAX_EVENTS 64
+/** Maximum number of messages gathered into a single write. */
+#define MAX_BATCH_MESSAGES 64
+/** Size of the per-client receive buffer. */
+#define RECV_BUFFER_SIZE 65536
+/** Epoll user data of the event file descriptor, client IDs start at 1. */
+#define EVENT_FD_ID 0
+
+/* Connection state of a client handled by the reactor. */
+struct FawkesNetworkServerReactorThread::Client
+{
+	unsigned int  clid;
+	StreamSocket *socket;
+	int           fd;
+	bool          alive;
+	bool          pending;
+	bool          want_write;
+
+	std::vector<char>     recv_buffer;
+	size_t                recv_size;
+	FawkesNetworkMessage *recv_msg;
+	size_t                recv_offset;
+
+	std::deque<FawkesNetworkMessage *> outbound;
+	size_t                             outbound_offset;
+};
+/// @endcond
+
+/** @class FawkesNetworkServerReactorThread <netcomm/fawkes/server_reactor_thread.h>
+ * Event loop thread of the Fawkes network server.
+ * Instead of running a receive and a send thread per client the server can
+ * multiplex any number of client connections on a few of these threads.
+ * The sockets are set to non-blocking mode and watched with epoll. Inbound
+ * messages are passed on to the FawkesNetworkServerThread just like the
+ * client threads do. Outbound messages are appended to a per-client queue,
+ * the thread is woken up via an event file descriptor and writes as much
+ * as the socket accepts, further data is written once the socket becomes
+ * writable again.
+ *
+ * @ingroup NetComm
+ * @author Tim Niemueller
+ */
+
+/** Constructor.
+ * @param parent parent network server thread
+ * @param name name of the thread
+ */
+FawkesNetworkServerReactorThread::FawkesNetworkServerReactorThread(
+  FawkesNetworkServerThread *parent,
+  const char *               name)
+: Thread(name, Thread::OPMODE_CONTINUOUS)
+{
+	parent_ = parent;
+	died_   = false;
+
+	epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd_ == -1) {
+		throw Exception(errno, "Failed to create epoll instance");
+	}
+	event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (event_fd_ == -1) {
+		::close(epoll_fd_);
+		throw Exception(errno, "Failed to create event file descriptor");
+	}
+
+	struct epoll_event ev;
+	ev.events   = EPOLLIN;
+	ev.data.u64 = EVENT_FD_ID;
+	if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, event_fd_, &ev) == -1) {
+		::close(event_fd_);
+		::close(epoll_fd_);
+		throw Exception(errno, "Failed to watch event file descriptor");
+	}
+
+	mutex_     = new Mutex();
+	sent_cond_ = new WaitCondition(mutex_);
+}
+
+/** Destructor. */
+FawkesNetworkServerReactorThread::~FawkesNetworkServerReactorThread()
+{
+	for (auto &c : clients_) {
+		delete_client(c.second);
+	}
+	clients_.clear();
+	::close(event_fd_);
+	::close(epoll_fd_);
+	delete sent_cond_;
+	delete mutex_;
+}
+
+/** Add a client connection.
+ * From now on the connection is handled by this thread.
+ * @param clid client ID
+ * @param s socket to client, ownership is taken
+ */
+void
+FawkesNetworkServerReactorThread::add_client(unsigned int clid, StreamSocket *s)
+{
+	Client *c          = new Client();
+	c->clid            = clid;
+	c->socket          = s;
+	c->fd              = s->fd();
+	c->alive           = true;
+	c->pending         = false;
+	c->want_write      = false;
+	c->recv_size       = 0;
+	c->recv_msg        = NULL;
+	c->recv_offset     = 0;
+	c->outbound_offset = 0;
+	c->recv_buffer.resize(RECV_BUFFER_SIZE);
+
+	MutexLocker lock(mutex_);
+	clients_[clid] = c;
+
+	// failures are reported as dead client
+	struct epoll_event ev;
+	ev.events   = EPOLLIN | EPOLLRDHUP;
+	ev.data.u64 = clid;
+	int flags   = fcntl(c->fd, F_GETFL);
+	if ((flags == -1) || (fcntl(c->fd, F_SETFL, flags | O_NONBLOCK) == -1)
+	    || (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, c->fd, &ev) == -1)) {
+		c->alive = false;
+		dead_clients_.push_back(clid);
+	}
+}
+
+/** Remove a client connection.
+ * Closes the connection and frees all resources. Call this only after the
+ * client has been reported by collect_dead_clients().
+ * @param clid client ID
+ */
+void
+FawkesNetworkServerReactorThread::remove_client(unsigned int clid)
+{
+	MutexLocker lock(mutex_);
+	auto        c = clients_.find(clid);
+	if (c != clients_.end()) {
+		kill_client(c->second);
+		dead_clients_.remove(clid);
+		delete_client(c->second);
+		clients_.erase(c);
+	}
+}
+
+/** Get clients whose connection died.
+ * Each client is reported once.
+ * @param dead_clients upon return contains the IDs of the dead clients
+ * appended to any previous entries
+ */
+void
+FawkesNetworkServerReactorThread::collect_dead_clients(std::list<unsigned int> &dead_clients)
+{
+	MutexLocker lock(mutex_);
+	dead_clients.splice(dead_clients.end(), dead_clients_);
+}
+
+/** Enqueue message to outbound queue of a client.
+ * If the client is not connected the message is silently dropped.
+ * @param clid ID of the client to send to
+ * @param msg message to send, ownership is taken
+ */
+void
+FawkesNetworkServerReactorThread::enqueue(unsigned int clid, FawkesNetworkMessage *msg)
+{
+	msg->pack();
+
+	MutexLocker lock(mutex_);
+	auto        c = clients_.find(clid);
+	if ((c == clients_.end()) || !c->second->alive) {
+		lock.unlock();
+		msg->unref();
+		return;
+	}
+
+	c->second->outbound.push_back(msg);
+	if (!c->second->pending) {
+		c->second->pending = true;
+		pending_.push_back(clid);
+		if (pending_.size() == 1) {
+			notify();
+		}
+	}
+}
+
+/** Enqueue message to outbound queues of all clients.
+ * @param msg message to send, it must have been packed before and is
+ * referenced for each client, the caller keeps its reference
+ */
+void
+FawkesNetworkServerReactorThread::broadcast(FawkesNetworkMessage *msg)
+{
+	MutexLocker lock(mutex_);
+	bool        was_pending = !pending_.empty();
+	for (auto &c : clients_) {
+		if (c.second->alive) {
+			msg->ref();
+			c.second->outbound.push_back(msg);
+			if (!c.second->pending) {
+				c.second->pending = true;
+				pending_.push_back(c.first);
+			}
+		}
+	}
+	if (!was_pending && !pending_.empty()) {
+		notify();
+	}
+}
+
+/** Wait until all enqueued messages have been sent. */
+void
+FawkesNetworkServerReactorThread::force_send()
+{
+	MutexLocker lock(mutex_);
+	bool        all_sent;
+	do {
+		all_sent = true;
+		for (auto &c : clients_) {
+			if (c.second->alive && !c.second->outbound.empty()) {
+				all_sent = false;
+				break;
+			}
+		}
+		if (!all_sent)
+			sent_cond_->wait();
+	} while (!all_sent);
+}
+
+/** Event loop.
+ * Waits for events on any client connection or for new outbound messages
+ * and processes them. Received messages are dispatched via the parent
+ * server thread.
+ */
+void
+FawkesNetworkServerReactorThread::loop()
+{
+	struct epoll_event events[MAX_EVENTS];
+
+	int num_events = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+	if (num_events == -1) {
+		if (errno == EINTR)
+			return;
+		throw Exception(errno, "Waiting for client events failed");
+	}
+
+	// no cancellation while state is modified and the mutex is held
+	CancelState old_cancel_state;
+	set_cancel_state(CANCEL_DISABLED, &old_cancel_state);
+
+	std::list<FawkesNetworkMessage *> inbound;
+
+	mutex_->lock();
+	for (int i = 0; i < num_events; ++i) {
+		if (events[i].data.u64 == EVENT_FD_ID) {
+			uint64_t count;
+			if (::read(event_fd_, &count, sizeof(count)) == -1) {
+				// nothing to read, already drained
+			}
+			for (unsigned int clid : pending_) {
+				auto c = clients_.find(clid);
+				if (c != clients_.end()) {
+					c->second->pending = false;
+					if (c->second->alive)
+						write_client(c->second);
+				}
+			}
+			pending_.clear();
+			continue;
+		}
+
+		auto c = clients_.find(events[i].data.u64);
+		if ((c == clients_.end()) || !c->second->alive)
+			continue;
+
+		if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+			read_client(c->second, inbound);
+		}
+		if ((events[i].events & EPOLLOUT) && c->second->alive) {
+			write_client(c->second);
+		}
+	}
+	sent_cond_->wake_all();
+	bool died = died_;
+	died_     = false;
+	mutex_->unlock();
+
+	// dispatch without holding the mutex, handlers may send right away
+	for (FawkesNetworkMessage *m : inbound) {
+		parent_->dispatch(m);
+		m->unref();
+	}
+	if (!inbound.empty() || died) {
+		parent_->wakeup();
+	}
+
+	set_cancel_state(old_cancel_state);
+}
+
+void
+FawkesNetworkServerReactorThread::notify()
+{
+	uint64_t one = 1;
+	if (::write(event_fd_, &one, sizeof(one)) == -1) {
+		// counter overflow only, the thread is woken up anyway
+	}
+}
+
+void
+FawkesNetworkServerReactorThread::read_client(Client *c, std::list<FawkesNetworkMessage *> &inbound)
+{
+	while (c->alive) {
+		size_t  space = c->recv_buffer.size() - c->recv_size;
+		ssize_t bytes = ::read(c->fd, &c->recv_buffer[c->recv_size], space);
+		if (bytes == 0) {
+			kill_client(c);
+		} else if (bytes == -1) {
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				break;
+			if (errno != EINTR)
+				kill_client(c);
+		} else {
+			c->recv_size += bytes;
+			parse_client(c, inbound);
+			if ((size_t)bytes < space) {
+				// socket drained, avoid another system call
+				break;
+			}
+		}
+	}
+}
+
+void
+FawkesNetworkServerReactorThread::parse_client(Client *                           c,
+                                               std::list<FawkesNetworkMessage *> &inbound)
+{
+	size_t pos = 0;
+	while (pos < c->recv_size) {
+		if (c->recv_msg) {
+			size_t remaining = c->recv_msg->payload_size() - c->recv_offset;
+			size_t n         = std::min(remaining, c->recv_size - pos);
+			memcpy((char *)c->recv_msg->payload() + c->recv_offset, &c->recv_buffer[pos], n);
+			pos += n;
+			c->recv_offset += n;
+			if (c->recv_offset == c->recv_msg->payload_size()) {
+				inbound.push_back(c->recv_msg);
+				c->recv_msg = NULL;
+			}
+		} else {
+			if (c->recv_size - pos < sizeof(fawkes_message_header_t))
+				break;
+			fawkes_message_header_t header;
+			memcpy(&header, &c->recv_buffer[pos], sizeof(header));
+			pos += sizeof(header);
+
+			FawkesNetworkMessage *m;
+			try {
+				m = new FawkesNetworkMessage(header);
+			} catch (Exception &e) {
+				kill_client(c);
+				return;
+			}
+			m->set_client_id(c->clid);
+			if (m->payload_size() == 0) {
+				inbound.push_back(m);
+			} else {
+				c->recv_msg    = m;
+				c->recv_offset = 0;
+			}
+		}
+	}
+
+	c->recv_size -= pos;
+	if (c->recv_size > 0) {
+		memmove(&c->recv_buffer[0], &c->recv_buffer[pos], c->recv_size);
+	}
+}
+
+void
+FawkesNetworkServerReactorThread::write_client(Client *c)
+{
+	struct iovec iov[2 * MAX_BATCH_MESSAGES];
+
+	while (!c->outbound.empty()) {
+		int    num_iov = 0;
+		size_t skip    = c->outbound_offset;
+		for (auto m = c->outbound.begin();
+		     (m != c->outbound.end()) && (num_iov < 2 * MAX_BATCH_MESSAGES - 1);
+		     ++m) {
+			const fawkes_message_t &f = (*m)->fmsg();
+			if (skip < sizeof(f.header)) {
+				iov[num_iov].iov_base = (char *)&(f.header) + skip;
+				iov[num_iov].iov_len  = sizeof(f.header) - skip;
+				++num_iov;
+				skip = 0;
+			} else {
+				skip -= sizeof(f.header);
+			}
+			size_t payload_size = (*m)->payload_size();
+			if (payload_size > 0) {
+				iov[num_iov].iov_base = (char *)f.payload + skip;
+				iov[num_iov].iov_len  = payload_size - skip;
+				++num_iov;
+			}
+			skip = 0;
+		}
+
+		ssize_t bytes = ::writev(c->fd, iov, num_iov);
+		if (bytes == -1) {
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+				break;
+			if (errno == EINTR)
+				continue;
+			kill_client(c);
+			return;
+		}
+
+		size_t written = c->outbound_offset + bytes;
+		while (!c->outbound.empty()) {
+			FawkesNetworkMessage *m    = c->outbound.front();
+			size_t                size = sizeof(fawkes_message_header_t) + m->payload_size();
+			if (written < size)
+				break;
+			written -= size;
+			m->unref();
+			c->outbound.pop_front();
+		}
+		c->outbound_offset = written;
+	}
+
+	// wait for the socket to become writable if data remains
+	bool want_write = !c->outbound.empty();
+	if (want_write != c->want_write) {
+		struct epoll_event ev;
+		ev.events   = EPOLLIN | EPOLLRDHUP | (want_write ? EPOLLOUT : 0);
+		ev.data.u64 = c->clid;
+		if (epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, c->fd, &ev) == -1) {
+			kill_client(c);
+			return;
+		}
+		c->want_write = want_write;
+	}
+}
+
+void
+FawkesNetworkServerReactorThread::kill_client(Client *c)
+{
+	if (!c->alive)
+		return;
+
+	c->alive = false;
+	epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, c->fd, NULL);
+	while (!c->outbound.empty()) {
+		c->outbound.front()->unref();
+		c->outbound.pop_front();
+	}
+	if (c->recv_msg) {
+		c->recv_msg->unref();
+		c->recv_msg = NULL;
+	}
+	dead_clients_.push_back(c->clid);
+	died_ = true;
+}
+
+void
+FawkesNetworkServerReactorThread::delete_client(Client *c)
+{
+	while (!c->outbound.empty()) {
+		c->outbound.front()->unref();
+		c->outbound.pop_front();
+	}
+	if (c->recv_msg)
+		c->recv_msg->unref();
+	delete c->socket;
+	delete c;
+}
+
+} // end namespace fawkes
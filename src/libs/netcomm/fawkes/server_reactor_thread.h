@@ -0,0 +1,92 @@
+
+/***************************************************************************
+ *  server_reactor_thread.h - Fawkes network server event loop thread
+ *
+ *  Created: Fri Oct 16 21:40:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _NETCOMM_FAWKES_SERVER_REACTOR_THREAD_H_
+#define _NETCOMM_FAWKES_SERVER_REACTOR_THREAD_H_
+
+#include <core/threading/thread.h>
+
+#include <list>
+#include <map>
+#include <vector>
+
+namespace fawkes {
+
+class StreamSocket;
+class FawkesNetworkServerThread;
+class FawkesNetworkMessage;
+class Mutex;
+class WaitCondition;
+
+class FawkesNetworkServerReactorThread : public Thread
+{
+public:
+	FawkesNetworkServerReactorThread(FawkesNetworkServerThread *parent, const char *name);
+	virtual ~FawkesNetworkServerReactorThread();
+
+	virtual void loop();
+
+	void add_client(unsigned int clid, StreamSocket *s);
+	void remove_client(unsigned int clid);
+	void collect_dead_clients(std::list<unsigned int> &dead_clients);
+
+	void enqueue(unsigned int clid, FawkesNetworkMessage *msg);
+	void broadcast(FawkesNetworkMessage *msg);
+	void force_send();
+
+	/** Stub to see name in backtrace for easier debugging. @see Thread::run() */
+protected:
+	virtual void
+	run()
+	{
+		Thread::run();
+	}
+
+private:
+	struct Client;
+
+	void notify();
+	void read_client(Client *c, std::list<FawkesNetworkMessage *> &inbound);
+	void parse_client(Client *c, std::list<FawkesNetworkMessage *> &inbound);
+	void write_client(Client *c);
+	void kill_client(Client *c);
+	void delete_client(Client *c);
+
+private:
+	FawkesNetworkServerThread *parent_;
+
+	int epoll_fd_;
+	int event_fd_;
+
+	Mutex *        mutex_;
+	WaitCondition *sent_cond_;
+
+	std::map<unsigned int, Client *> clients_;
+	std::vector<unsigned int>        pending_;
+	std::list<unsigned int>          dead_clients_;
+	bool                             died_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -30,6 +30,7 @@
 #include <netcomm/fawkes/message_content.h>
 #include <netcomm/fawkes/message_queue.h>
 #include <netcomm/fawkes/server_client_thread.h>
+#include <netcomm/fawkes/server_reactor_thread.h>
 #include <netcomm/fawkes/server_thread.h>
 #include <netcomm/utils/acceptor_thread.h>
 
@@ -42,6 +43,12 @@ namespace fawkes {
  * Maintains a list of clients and reacts on events triggered by the clients.
  * Also runs the acceptor thread.
  *
+ * By default every client is handled by its own pair of threads. With
+ * many connections, for example remote BlackBoard and tool connections,
+ * this results in many threads which are mostly idle. Alternatively the
+ * clients can be multiplexed on a fixed number of event loop threads, see
+ * FawkesNetworkServerReactorThread. Handlers are unaffected by this choice.
+ *
  * @ingroup NetComm
  * @author Tim Niemueller
  */
@@ -55,19 +62,28 @@ namespace fawkes {
  * :: to listen on any local address
  * @param fawkes_port port for Fawkes network protocol
  * @param thread_collector thread collector to register new threads with
+ * @param num_reactor_threads number of event loop threads to handle all
+ * clients, 0 to run a thread per client
  */
 FawkesNetworkServerThread::FawkesNetworkServerThread(bool               enable_ipv4,
                                                      bool               enable_ipv6,
                                                      const std::string &listen_ipv4,
                                                      const std::string &listen_ipv6,
                                                      unsigned int       fawkes_port,
-                                                     ThreadCollector *  thread_collector)
+                                                     ThreadCollector *  thread_collector,
+                                                     unsigned int       num_reactor_threads)
 : Thread("FawkesNetworkServerThread", Thread::OPMODE_WAITFORWAKEUP)
 {
 	this->thread_collector = thread_collector;
 	clients.clear();
-	next_client_id   = 1;
-	inbound_messages = new FawkesNetworkMessageQueue();
+	next_client_id      = 1;
+	next_reactor_thread = 0;
+	inbound_messages    = new FawkesNetworkMessageQueue();
+
+	for (unsigned int i = 0; i < num_reactor_threads; ++i) {
+		std::string name = "FawkesNetworkServerReactorThread " + std::to_string(i);
+		reactor_threads.push_back(new FawkesNetworkServerReactorThread(this, name.c_str()));
+	}
 
 	if (enable_ipv4) {
 		acceptor_threads.push_back(new NetworkAcceptorThread(
@@ -79,10 +95,16 @@ FawkesNetworkServerThread::FawkesNetworkServerThread(bool               enable_i
 	}
 
 	if (thread_collector) {
+		for (size_t i = 0; i < reactor_threads.size(); ++i) {
+			thread_collector->add(reactor_threads[i]);
+		}
 		for (size_t i = 0; i < acceptor_threads.size(); ++i) {
 			thread_collector->add(acceptor_threads[i]);
 		}
 	} else {
+		for (size_t i = 0; i < reactor_threads.size(); ++i) {
+			reactor_threads[i]->start();
+		}
 		for (size_t i = 0; i < acceptor_threads.size(); ++i) {
 			acceptor_threads[i]->start();
 		}
@@ -111,6 +133,16 @@ FawkesNetworkServerThread::~FawkesNetworkServerThread()
 		delete acceptor_threads[i];
 	}
 	acceptor_threads.clear();
+	for (size_t i = 0; i < reactor_threads.size(); ++i) {
+		if (thread_collector) {
+			thread_collector->remove(reactor_threads[i]);
+		} else {
+			reactor_threads[i]->cancel();
+			reactor_threads[i]->join();
+		}
+		delete reactor_threads[i];
+	}
+	reactor_threads.clear();
 
 	delete inbound_messages;
 }
@@ -122,17 +154,25 @@ FawkesNetworkServerThread::~FawkesNetworkServerThread()
 void
 FawkesNetworkServerThread::add_connection(StreamSocket *s) throw()
 {
-	FawkesNetworkServerClientThread *client = new FawkesNetworkServerClientThread(s, this);
-
 	clients.lock();
-	client->set_clid(next_client_id);
-	if (thread_collector) {
-		thread_collector->add(client);
+	unsigned int cid = next_client_id++;
+	if (reactor_threads.empty()) {
+		FawkesNetworkServerClientThread *client = new FawkesNetworkServerClientThread(s, this);
+		client->set_clid(cid);
+		if (thread_collector) {
+			thread_collector->add(client);
+		} else {
+			client->start();
+		}
+		clients[cid] = client;
 	} else {
-		client->start();
+		FawkesNetworkServerReactorThread *reactor = reactor_threads[next_reactor_thread];
+		next_reactor_thread = (next_reactor_thread + 1) % reactor_threads.size();
+		reactor_clients.lock();
+		reactor_clients[cid] = reactor;
+		reactor_clients.unlock();
+		reactor->add_client(cid, s);
 	}
-	unsigned int cid = next_client_id++;
-	clients[cid]     = client;
 	clients.unlock();
 
 	MutexLocker handlers_lock(handlers.mutex());
@@ -187,6 +227,9 @@ FawkesNetworkServerThread::loop()
 		}
 	}
 	clients.unlock();
+	for (size_t i = 0; i < reactor_threads.size(); ++i) {
+		reactor_threads[i]->collect_dead_clients(dead_clients);
+	}
 
 	std::list<unsigned int>::iterator dci;
 	for (dci = dead_clients.begin(); dci != dead_clients.end(); ++dci) {
@@ -199,7 +242,7 @@ FawkesNetworkServerThread::loop()
 			}
 		}
 
-		{
+		if (reactor_threads.empty()) {
 			MutexLocker clients_lock(clients.mutex());
 			if (thread_collector) {
 				thread_collector->remove(clients[clid]);
@@ -210,6 +253,12 @@ FawkesNetworkServerThread::loop()
 			usleep(5000);
 			delete clients[clid];
 			clients.erase(clid);
+		} else {
+			MutexLocker reactor_clients_lock(reactor_clients.mutex());
+			if ((rcit = reactor_clients.find(clid)) != reactor_clients.end()) {
+				rcit->second->remove_client(clid);
+				reactor_clients.erase(rcit);
+			}
 		}
 	}
 
@@ -233,6 +282,9 @@ FawkesNetworkServerThread::loop()
 void
 FawkesNetworkServerThread::force_send()
 {
+	for (size_t i = 0; i < reactor_threads.size(); ++i) {
+		reactor_threads[i]->force_send();
+	}
 	clients.lock();
 	for (cit = clients.begin(); cit != clients.end(); ++cit) {
 		(*cit).second->force_send();
@@ -249,6 +301,16 @@ FawkesNetworkServerThread::force_send()
 void
 FawkesNetworkServerThread::broadcast(FawkesNetworkMessage *msg)
 {
+	if (!reactor_threads.empty()) {
+		// pack once for all clients
+		msg->pack();
+		for (size_t i = 0; i < reactor_threads.size(); ++i) {
+			reactor_threads[i]->broadcast(msg);
+		}
+		msg->unref();
+		return;
+	}
+
 	clients.lock();
 	for (cit = clients.begin(); cit != clients.end(); ++cit) {
 		if ((*cit).second->alive()) {
@@ -303,6 +365,16 @@ FawkesNetworkServerThread::broadcast(unsigned short int component_id, unsigned s
 void
 FawkesNetworkServerThread::send(FawkesNetworkMessage *msg)
 {
+	if (!reactor_threads.empty()) {
+		MutexLocker lock(reactor_clients.mutex());
+		if ((rcit = reactor_clients.find(msg->clid())) != reactor_clients.end()) {
+			rcit->second->enqueue(msg->clid(), msg);
+		} else {
+			msg->unref();
+		}
+		return;
+	}
+
 	MutexLocker  lock(clients.mutex());
 	unsigned int clid = msg->clid();
 	if (clients.find(clid) != clients.end()) {
@@ -37,6 +37,7 @@ namespace fawkes {
 class ThreadCollector;
 class Mutex;
 class FawkesNetworkServerClientThread;
+class FawkesNetworkServerReactorThread;
 class NetworkAcceptorThread;
 class FawkesNetworkHandler;
 class FawkesNetworkMessage;
@@ -53,7 +54,8 @@ public:
 	                          const std::string &listen_ipv4,
 	                          const std::string &listen_ipv6,
 	                          unsigned int       fawkes_port,
-	                          ThreadCollector *  thread_collector = 0);
+	                          ThreadCollector *  thread_collector    = 0,
+	                          unsigned int       num_reactor_threads = 0);
 	virtual ~FawkesNetworkServerThread();
 
 	virtual void loop();
@@ -107,6 +109,14 @@ private:
 	LockMap<unsigned int, FawkesNetworkServerClientThread *>           clients;
 	LockMap<unsigned int, FawkesNetworkServerClientThread *>::iterator cit;
 
+	// event loop threads, empty to run a thread per client
+	std::vector<FawkesNetworkServerReactorThread *> reactor_threads;
+	unsigned int                                    next_reactor_thread;
+
+	// key: client id,     value: event loop thread handling the client
+	LockMap<unsigned int, FawkesNetworkServerReactorThread *>           reactor_clients;
+	LockMap<unsigned int, FawkesNetworkServerReactorThread *>::iterator rcit;
+
 	FawkesNetworkMessageQueue *inbound_messages;
 };
 
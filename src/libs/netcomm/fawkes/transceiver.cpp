@@ -27,11 +27,17 @@
 #include <netcomm/socket/stream.h>
 #include <netcomm/utils/exceptions.h>
 #include <netinet/in.h>
+#include <sys/uio.h>
 
 #include <cstdlib>
 
 namespace fawkes {
 
+/// @cond INTERNALS
+/** Maximum number of messages gathered into a single write. */
+#define MAX_BATCH_MESSAGES 64
+/// @endcond
+
 /** @class FawkesNetworkTransceiver transceiver.h <netcomm/fawkes/transceiver.h>
  * Fawkes Network Transceiver.
  * Utility class that provides methods to send and receive messages via
@@ -42,6 +48,8 @@ namespace fawkes {
  */
 
 /** Send messages.
+ * All queued messages are gathered and written with as few system calls as
+ * possible, typically a single one.
  * @param s socket over which the data shall be transmitted.
  * @param msgq message queue that contains the messages that have to be sent
  * @exception ConnectionDiedException Thrown if any error occurs during the
@@ -50,21 +58,41 @@ namespace fawkes {
 void
 FawkesNetworkTransceiver::send(StreamSocket *s, FawkesNetworkMessageQueue *msgq)
 {
+	FawkesNetworkMessage *batch[MAX_BATCH_MESSAGES];
+	struct iovec          iov[2 * MAX_BATCH_MESSAGES];
+
 	msgq->lock();
-	try {
-		while (!msgq->empty()) {
+	while (!msgq->empty()) {
+		unsigned int num_msgs = 0;
+		int          num_iov  = 0;
+		while (!msgq->empty() && (num_msgs < MAX_BATCH_MESSAGES)) {
 			FawkesNetworkMessage *m = msgq->front();
 			m->pack();
-			const fawkes_message_t &f            = m->fmsg();
-			unsigned int            payload_size = m->payload_size();
-			s->write(&(f.header), sizeof(f.header));
-			s->write(f.payload, payload_size);
-			m->unref();
+			const fawkes_message_t &f = m->fmsg();
+			iov[num_iov].iov_base     = (void *)&(f.header);
+			iov[num_iov].iov_len      = sizeof(f.header);
+			++num_iov;
+			if (m->payload_size() > 0) {
+				iov[num_iov].iov_base = f.payload;
+				iov[num_iov].iov_len  = m->payload_size();
+				++num_iov;
+			}
+			batch[num_msgs++] = m;
 			msgq->pop();
 		}
-	} catch (SocketException &e) {
-		msgq->unlock();
-		throw ConnectionDiedException("Write failed");
+
+		try {
+			s->writev(iov, num_iov);
+		} catch (SocketException &e) {
+			for (unsigned int i = 0; i < num_msgs; ++i) {
+				batch[i]->unref();
+			}
+			msgq->unlock();
+			throw ConnectionDiedException("Write failed");
+		}
+		for (unsigned int i = 0; i < num_msgs; ++i) {
+			batch[i]->unref();
+		}
 	}
 	msgq->unlock();
 }
@@ -91,19 +119,19 @@ FawkesNetworkTransceiver::recv(StreamSocket *             s,
 	try {
 		unsigned int num_msgs = 0;
 		while (s->available() && (num_msgs++ < max_num_msgs)) {
-			fawkes_message_t msg;
-			s->read(&(msg.header), sizeof(msg.header));
-
-			unsigned int payload_size = ntohl(msg.header.payload_size);
+			fawkes_message_header_t header;
+			s->read(&header, sizeof(header));
 
-			if (payload_size > 0) {
-				msg.payload = malloc(payload_size);
-				s->read(msg.payload, payload_size);
-			} else {
-				msg.payload = NULL;
+			// payload buffer and message are taken from a pool
+			FawkesNetworkMessage *m = new FawkesNetworkMessage(header);
+			if (m->payload_size() > 0) {
+				try {
+					s->read(m->payload(), m->payload_size());
+				} catch (SocketException &e) {
+					m->unref();
+					throw;
+				}
 			}
-
-			FawkesNetworkMessage *m = new FawkesNetworkMessage(msg);
 			msgq->push(m);
 		}
 	} catch (SocketException &e) {
@@ -0,0 +1,379 @@
+/***************************************************************************
+ *  qa_fawkes_reactor.cpp - QA for the Fawkes network server event loop
+ *
+ *  Created: Sat Oct 17 04:05:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+// Runs the Fawkes network server with event loop threads on loopback and
+// talks to it with FawkesNetworkClient and with plain sockets to control
+// exactly how data arrives at the server.
+
+#include <core/exception.h>
+#include <netcomm/fawkes/client.h>
+#include <netcomm/fawkes/client_handler.h>
+#include <netcomm/fawkes/handler.h>
+#include <netcomm/fawkes/message.h>
+#include <netcomm/fawkes/message_queue.h>
+#include <netcomm/fawkes/server_thread.h>
+#include <netcomm/fawkes/transceiver.h>
+#include <netcomm/socket/stream.h>
+#include <utils/system/signal.h>
+#include <utils/time/time.h>
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+using namespace fawkes;
+
+#define PORT 19912
+#define NUM_REACTOR_THREADS 2
+#define COMPONENT_ID 42
+#define MSG_ECHO 1
+#define MSG_BULK 2
+#define MSG_FLOOD 3
+#define BULK_SIZE (1024 * 1024)
+#define NUM_BULK 48
+
+typedef struct
+{
+	uint32_t num;
+	uint32_t size;
+} bulk_request_t;
+
+static void
+fill(unsigned char *buffer, size_t size, unsigned int seed)
+{
+	for (size_t i = 0; i < size; ++i) {
+		buffer[i] = (seed + i) & 0xff;
+	}
+}
+
+static bool
+verify(const unsigned char *buffer, size_t size, unsigned int seed)
+{
+	for (size_t i = 0; i < size; ++i) {
+		if (buffer[i] != ((seed + i) & 0xff))
+			return false;
+	}
+	return true;
+}
+
+/** Server side, echoes messages and sends bulk data on request. */
+class ServerHandler : public FawkesNetworkHandler
+{
+public:
+	ServerHandler(FawkesNetworkHub *hub) : FawkesNetworkHandler(COMPONENT_ID), hub_(hub)
+	{
+		num_connected    = 0;
+		num_disconnected = 0;
+		num_flooded      = 0;
+		flood_msg        = new FawkesNetworkMessage(COMPONENT_ID, MSG_FLOOD, (size_t)BULK_SIZE);
+	}
+
+	~ServerHandler()
+	{
+		flood_msg->unref();
+	}
+
+	virtual void
+	handle_network_message(FawkesNetworkMessage *msg)
+	{
+		if (msg->msgid() == MSG_ECHO) {
+			void *payload = malloc(msg->payload_size());
+			memcpy(payload, msg->payload(), msg->payload_size());
+			hub_->send(msg->clid(), COMPONENT_ID, MSG_ECHO, payload, msg->payload_size());
+		} else if (msg->msgid() == MSG_BULK) {
+			bulk_request_t *r = msg->msg<bulk_request_t>();
+			for (unsigned int i = 0; i < r->num; ++i) {
+				FawkesNetworkMessage *m =
+				  new FawkesNetworkMessage(msg->clid(), COMPONENT_ID, MSG_BULK, malloc(r->size), r->size);
+				fill((unsigned char *)m->payload(), r->size, i);
+				hub_->send(m);
+			}
+		} else if (msg->msgid() == MSG_FLOOD) {
+			// the same message queued many times, references must be released
+			bulk_request_t *r = msg->msg<bulk_request_t>();
+			flood_msg->set_client_id(msg->clid());
+			for (unsigned int i = 0; i < r->num; ++i) {
+				flood_msg->ref();
+				hub_->send(flood_msg);
+			}
+			num_flooded += r->num;
+		}
+	}
+
+	virtual void
+	client_connected(unsigned int clid)
+	{
+		num_connected += 1;
+	}
+
+	virtual void
+	client_disconnected(unsigned int clid)
+	{
+		num_disconnected += 1;
+	}
+
+	std::atomic<unsigned int> num_connected;
+	std::atomic<unsigned int> num_disconnected;
+	std::atomic<unsigned int> num_flooded;
+	FawkesNetworkMessage *    flood_msg;
+
+private:
+	FawkesNetworkHub *hub_;
+};
+
+/** Client side, checks received messages. */
+class ClientHandler : public FawkesNetworkClientHandler
+{
+public:
+	ClientHandler()
+	{
+		num_echo   = 0;
+		num_bulk   = 0;
+		num_errors = 0;
+		died       = false;
+		slow       = false;
+	}
+
+	virtual void
+	deregistered(unsigned int id) throw()
+	{
+	}
+
+	virtual void
+	inbound_received(FawkesNetworkMessage *m, unsigned int id) throw()
+	{
+		if (m->msgid() == MSG_ECHO) {
+			if (!verify((unsigned char *)m->payload(), m->payload_size(), num_echo))
+				num_errors += 1;
+			num_echo += 1;
+		} else if (m->msgid() == MSG_BULK) {
+			if (slow && num_bulk == 0) {
+				// let the server run into a full socket buffer
+				usleep(200000);
+			}
+			if ((m->payload_size() != BULK_SIZE)
+			    || !verify((unsigned char *)m->payload(), m->payload_size(), num_bulk))
+				num_errors += 1;
+			num_bulk += 1;
+		}
+	}
+
+	virtual void
+	connection_died(unsigned int id) throw()
+	{
+		died = true;
+	}
+
+	virtual void
+	connection_established(unsigned int id) throw()
+	{
+	}
+
+	std::atomic<unsigned int> num_echo;
+	std::atomic<unsigned int> num_bulk;
+	std::atomic<unsigned int> num_errors;
+	std::atomic<bool>         died;
+	std::atomic<bool>         slow;
+};
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static bool
+wait_for(const std::atomic<unsigned int> &value, unsigned int expected, unsigned int sec = 10)
+{
+	for (unsigned int i = 0; i < sec * 100 && value < expected; ++i) {
+		usleep(10000);
+	}
+	return value >= expected;
+}
+
+static FawkesNetworkMessage *
+bulk_request(unsigned short int msg_id, unsigned int num, unsigned int size)
+{
+	FawkesNetworkMessage *m = new FawkesNetworkMessage(COMPONENT_ID, msg_id, sizeof(bulk_request_t));
+	bulk_request_t *      r = m->msg<bulk_request_t>();
+	r->num                  = num;
+	r->size                 = size;
+	return m;
+}
+
+static StreamSocket *
+raw_connect()
+{
+	StreamSocket *s = new StreamSocket(Socket::IPv4);
+	s->connect("127.0.0.1", PORT);
+	s->set_nodelay(true);
+	return s;
+}
+
+/** Write packed message in tiny chunks, splitting header and payload. */
+static void
+write_trickled(StreamSocket *s, FawkesNetworkMessage *m, size_t chunk_size)
+{
+	m->pack();
+	const fawkes_message_t &f = m->fmsg();
+	const char *            h = (const char *)&f.header;
+	for (size_t i = 0; i < sizeof(f.header); i += chunk_size) {
+		s->write(h + i, std::min(chunk_size, sizeof(f.header) - i));
+		usleep(1000);
+	}
+	const char *p = (const char *)f.payload;
+	for (size_t i = 0; i < m->payload_size(); i += chunk_size) {
+		s->write(p + i, std::min(chunk_size, m->payload_size() - i));
+		usleep(1000);
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	int failures = 0;
+	SignalManager::ignore(SIGPIPE);
+
+	FawkesNetworkServerThread *server =
+	  new FawkesNetworkServerThread(true, false, "127.0.0.1", "", PORT, NULL, NUM_REACTOR_THREADS);
+	ServerHandler server_handler(server);
+	server->add_handler(&server_handler);
+	server->start();
+
+	try {
+		ClientHandler       client_handler;
+		FawkesNetworkClient client("127.0.0.1", PORT);
+		client.register_handler(&client_handler, COMPONENT_ID);
+		client.connect();
+
+		// partial reads: messages larger than the receive buffer, and a
+		// message trickling in a few bytes at a time
+		const size_t sizes[] = {0, 1, 17, 4096, 65535, 65536, 300000, 2 * BULK_SIZE, 3};
+		unsigned int num     = 0;
+		for (size_t size : sizes) {
+			FawkesNetworkMessage *m = new FawkesNetworkMessage(COMPONENT_ID, MSG_ECHO, size);
+			fill((unsigned char *)m->payload(), size, num++);
+			client.enqueue(m);
+		}
+		failures += check(wait_for(client_handler.num_echo, num) && client_handler.num_errors == 0,
+		                  "Echo of messages of all sizes");
+
+		StreamSocket *trickle = raw_connect();
+		{
+			FawkesNetworkMessage *m = new FawkesNetworkMessage(COMPONENT_ID, MSG_ECHO, (size_t)100);
+			fill((unsigned char *)m->payload(), 100, 0);
+			write_trickled(trickle, m, 3);
+			m->unref();
+		}
+		FawkesNetworkMessageQueue inq;
+		for (unsigned int i = 0; i < 500 && inq.empty(); ++i) {
+			if (trickle->available())
+				FawkesNetworkTransceiver::recv(trickle, &inq);
+			else
+				usleep(10000);
+		}
+		bool trickle_ok = (inq.size() == 1) && (inq.front()->payload_size() == 100)
+		                  && verify((unsigned char *)inq.front()->payload(), 100, 0);
+		while (!inq.empty()) {
+			inq.front()->unref();
+			inq.pop();
+		}
+		failures += check(trickle_ok, "Message split into tiny reads");
+		delete trickle;
+
+		// partial writes: more data than the socket buffer holds to a client
+		// which does not read for a while
+		client_handler.slow = true;
+		client.enqueue(bulk_request(MSG_BULK, NUM_BULK, BULK_SIZE));
+		failures += check(wait_for(client_handler.num_bulk, NUM_BULK) && client_handler.num_errors == 0,
+		                  "Bulk data to slow reader");
+
+		// client disconnects while the server is writing to it
+		unsigned int  num_disconnected = server_handler.num_disconnected;
+		StreamSocket *quitter          = raw_connect();
+		FawkesNetworkMessage *m        = bulk_request(MSG_BULK, NUM_BULK, BULK_SIZE);
+		m->pack();
+		quitter->write(&m->fmsg().header, sizeof(fawkes_message_header_t));
+		quitter->write(m->payload(), m->payload_size());
+		m->unref();
+		char buf[1000];
+		quitter->read(buf, sizeof(buf));
+		delete quitter;
+		failures += check(wait_for(server_handler.num_disconnected, num_disconnected + 1),
+		                  "Disconnect during write detected");
+
+		unsigned int num_echo = client_handler.num_echo;
+		m                     = new FawkesNetworkMessage(COMPONENT_ID, MSG_ECHO, (size_t)64);
+		fill((unsigned char *)m->payload(), 64, num_echo);
+		client.enqueue(m);
+		failures += check(wait_for(client_handler.num_echo, num_echo + 1) && !client_handler.died
+		                    && client_handler.num_errors == 0,
+		                  "Other client unaffected");
+
+		// shutdown while messages are queued for a client which never reads
+		StreamSocket *sleeper = raw_connect();
+		m                     = bulk_request(MSG_FLOOD, 100, 0);
+		m->pack();
+		sleeper->write(&m->fmsg().header, sizeof(fawkes_message_header_t));
+		sleeper->write(m->payload(), m->payload_size());
+		m->unref();
+		bool flooded = wait_for(server_handler.num_flooded, 100);
+
+		Time start;
+		server->cancel();
+		server->join();
+		delete server;
+		server             = NULL;
+		double shutdown_sec = Time() - &start;
+		printf("Shutdown took %.3f sec\n", shutdown_sec);
+		failures += check(flooded && shutdown_sec < 5. && server_handler.flood_msg->refcount() == 1,
+		                  "Shutdown with queued messages");
+
+		for (unsigned int i = 0; i < 500 && !client_handler.died; ++i) {
+			usleep(10000);
+		}
+		failures += check(client_handler.died, "Client noticed shutdown");
+		delete sleeper;
+
+		client.disconnect();
+		client.deregister_handler(COMPONENT_ID);
+	} catch (Exception &e) {
+		e.print_trace();
+		failures += 1;
+	}
+
+	if (server) {
+		server->cancel();
+		server->join();
+		delete server;
+	}
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -0,0 +1,138 @@
+
+/***************************************************************************
+ *  qa_fawkes_transceiver.cpp - Fawkes network transceiver throughput QA
+ *
+ *  Created: Fri Oct 16 21:12:37 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <netcomm/fawkes/message.h>
+#include <netcomm/fawkes/message_queue.h>
+#include <netcomm/fawkes/transceiver.h>
+#include <netcomm/socket/stream.h>
+#include <utils/time/time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+using namespace fawkes;
+
+#define PORT 19911
+#define QUEUE_LENGTH 64
+
+// sends like the transceiver did before, header and payload separately
+static void
+send_unbatched(StreamSocket *s, FawkesNetworkMessageQueue *msgq)
+{
+	msgq->lock();
+	while (!msgq->empty()) {
+		FawkesNetworkMessage *m = msgq->front();
+		m->pack();
+		const fawkes_message_t &f = m->fmsg();
+		s->write(&(f.header), sizeof(f.header));
+		s->write(f.payload, m->payload_size());
+		m->unref();
+		msgq->pop();
+	}
+	msgq->unlock();
+}
+
+static double
+run(StreamSocket *out, StreamSocket *in, unsigned int num_msgs, size_t size, bool batched)
+{
+	FawkesNetworkMessageQueue outq, inq;
+
+	Time        start;
+	std::thread sender([&]() {
+		for (unsigned int n = 0; n < num_msgs;) {
+			for (unsigned int i = 0; (i < QUEUE_LENGTH) && (n < num_msgs); ++i, ++n) {
+				FawkesNetworkMessage *m = new FawkesNetworkMessage(1, 1, size);
+				memcpy(m->payload(), &n, sizeof(n));
+				outq.push_locked(m);
+			}
+			if (batched) {
+				FawkesNetworkTransceiver::send(out, &outq);
+			} else {
+				send_unbatched(out, &outq);
+			}
+		}
+	});
+
+	unsigned int num_recv = 0, num_errors = 0;
+	while (num_recv < num_msgs) {
+		in->poll();
+		FawkesNetworkTransceiver::recv(in, &inq);
+		inq.lock();
+		while (!inq.empty()) {
+			FawkesNetworkMessage *m = inq.front();
+			unsigned int          n;
+			memcpy(&n, m->payload(), sizeof(n));
+			if ((n != num_recv) || (m->payload_size() != size))
+				++num_errors;
+			++num_recv;
+			m->unref();
+			inq.pop();
+		}
+		inq.unlock();
+	}
+	sender.join();
+	double duration = Time() - &start;
+
+	if (num_errors > 0) {
+		throw Exception("%u messages received out of order or corrupted", num_errors);
+	}
+	return num_msgs / duration;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int num_msgs = (argc > 1) ? atoi(argv[1]) : 200000;
+	size_t       size     = (argc > 2) ? atoi(argv[2]) : 32;
+	if (size < sizeof(unsigned int))
+		size = sizeof(unsigned int);
+
+	try {
+		StreamSocket server(Socket::IPv4);
+		server.bind(PORT, "127.0.0.1");
+		server.listen();
+		StreamSocket client(Socket::IPv4);
+		client.connect("127.0.0.1", PORT);
+		StreamSocket *peer = server.accept<StreamSocket>();
+
+		printf("%u messages of %zu bytes over loopback\n", num_msgs, size);
+		double unbatched = run(&client, peer, num_msgs, size, false);
+		printf("Separate writes: %10.0f msgs/sec\n", unbatched);
+		double batched = run(&client, peer, num_msgs, size, true);
+		printf("Gathered writes: %10.0f msgs/sec (%.1fx)\n", batched, batched / unbatched);
+
+		delete peer;
+	} catch (Exception &e) {
+		e.print_trace();
+		return 1;
+	}
+
+	return 0;
+}
+
+/// @endcond
@@ -32,6 +32,7 @@
 
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 #include <cstdlib>
 #include <cstring>
@@ -703,6 +704,17 @@ Socket::poll(int timeout, short what)
 	}
 }
 
+/** Get file descriptor.
+ * Use this to watch the socket for events along with other file
+ * descriptors, e.g. with epoll. The socket remains the owner.
+ * @return file descriptor of the socket, -1 if not initialized
+ */
+int
+Socket::fd() const
+{
+	return sock_fd;
+}
+
 /** Write to the socket.
  * Write to the socket. This method can only be used on streams.
  * @param buf buffer to write
@@ -730,6 +742,7 @@ Socket::write(const void *buf, size_t count)
 			} else {
 				// just to meet loop condition
 				retval = 0;
+				usleep(0);
 			}
 		} else {
 			bytes_written += retval;
@@ -737,7 +750,6 @@ Socket::write(const void *buf, size_t count)
 			gettimeofday(&start, NULL);
 		}
 		gettimeofday(&now, NULL);
-		usleep(0);
 	} while ((bytes_written < count) && (time_diff_sec(now, start) < timeout));
 
 	if (bytes_written < count) {
@@ -745,6 +757,54 @@ Socket::write(const void *buf, size_t count)
 	}
 }
 
+/** Write several buffers to the socket at once.
+ * Gathers all buffers into as few system calls as possible. This method can
+ * only be used on streams.
+ * @param iov buffers to write, the array is modified to keep track of
+ * partial writes and its contents are undefined afterwards
+ * @param iovcnt number of elements in iov
+ * @exception SocketException if the data could not be written or if a timeout occured.
+ */
+void
+Socket::writev(struct iovec *iov, int iovcnt)
+{
+	if (sock_fd == -1) {
+		throw SocketException("Socket not initialized, call bind() or connect()");
+	}
+
+	struct timeval start, now;
+	gettimeofday(&start, NULL);
+
+	while (iovcnt > 0) {
+		ssize_t retval = ::writev(sock_fd, iov, iovcnt);
+		if (retval == -1) {
+			if ((errno != EAGAIN) && (errno != EINTR)) {
+				throw SocketException(errno, "Could not write data");
+			}
+			gettimeofday(&now, NULL);
+			if ((timeout > 0) && (time_diff_sec(now, start) >= timeout)) {
+				throw SocketException("Write timeout");
+			}
+			usleep(0);
+			continue;
+		}
+
+		// skip buffers which have been written completely
+		size_t bytes_written = retval;
+		while ((iovcnt > 0) && (bytes_written >= iov->iov_len)) {
+			bytes_written -= iov->iov_len;
+			++iov;
+			--iovcnt;
+		}
+		if (iovcnt > 0) {
+			iov->iov_base = (char *)iov->iov_base + bytes_written;
+			iov->iov_len -= bytes_written;
+		}
+		// reset timeout
+		gettimeofday(&start, NULL);
+	}
+}
+
 /** Read from socket.
  * Read from the socket. This method can only be used on streams.
  * @param buf buffer to write from
@@ -780,6 +840,7 @@ Socket::read(void *buf, size_t count, bool read_all)
 					} else {
 						// just to meet loop condition
 						retval = 0;
+						usleep(0);
 					}
 				} else {
 					bytes_read += retval;
@@ -787,7 +848,6 @@ Socket::read(void *buf, size_t count, bool read_all)
 					gettimeofday(&start, NULL);
 				}
 				gettimeofday(&now, NULL);
-				usleep(0);
 			} while ((bytes_read < count) && (time_diff_sec(now, start) < timeout));
 		} else {
 			do {
@@ -797,7 +857,8 @@ Socket::read(void *buf, size_t count, bool read_all)
 				} else {
 					bytes_read = retval;
 				}
-				usleep(0);
+				if (retval < 0)
+					usleep(0);
 			} while (retval < 0);
 		}
 	} else {
@@ -811,7 +872,6 @@ Socket::read(void *buf, size_t count, bool read_all)
 				} else {
 					bytes_read += retval;
 				}
-				usleep(0);
 			} while (bytes_read < count);
 		} else {
 			do {
@@ -821,7 +881,8 @@ Socket::read(void *buf, size_t count, bool read_all)
 				} else {
 					bytes_read = retval;
 				}
-				usleep(0);
+				if (retval < 0)
+					usleep(0);
 			} while (retval < 0);
 		}
 	}
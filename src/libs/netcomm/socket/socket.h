@@ -32,6 +32,8 @@
 // just to be safe nobody else can do it
 #include <sys/signal.h>
 
+struct iovec;
+
 #ifdef POLL_IN
 #	undef POLL_IN
 #endif
@@ -104,6 +106,7 @@ public:
 
 	virtual size_t read(void *buf, size_t count, bool read_all = true);
 	virtual void   write(const void *buf, size_t count);
+	virtual void   writev(struct iovec *iov, int iovcnt);
 	virtual void   send(void *buf, size_t buf_len);
 	virtual void send(void *buf, size_t buf_len, const struct sockaddr *to_addr, socklen_t addr_len);
 	virtual size_t recv(void *buf, size_t buf_len);
@@ -119,6 +122,8 @@ public:
 
 	virtual bool listening();
 
+	int fd() const;
+
 	virtual unsigned int mtu();
 
 	/** Accept connection.
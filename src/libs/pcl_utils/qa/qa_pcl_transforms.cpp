@@ -0,0 +1,154 @@
+
+/***************************************************************************
+ *  qa_pcl_transforms.cpp - QA for in-place point cloud transforms
+ *
+ *  Created: Sat Oct 17 01:23:09 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+// Do not include in api reference
+///@cond QA
+
+#include <pcl/point_types.h>
+#include <pcl/register_point_struct.h>
+#include <pcl_utils/transforms.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+// coordinates do not start the point, must not use the in-place kernel
+struct QaPointOffsetXYZ
+{
+	int32_t label;
+	float   x;
+	float   y;
+	float   z;
+};
+POINT_CLOUD_REGISTER_POINT_STRUCT(QaPointOffsetXYZ,
+                                  (int32_t, label, label)(float, x, x)(float, y, y)(float, z, z))
+
+using namespace fawkes;
+
+static_assert(pcl_utils::xyz_leading_floats<pcl::PointXYZ>::value, "PointXYZ in place");
+static_assert(pcl_utils::xyz_leading_floats<pcl::PointXYZRGB>::value, "PointXYZRGB in place");
+static_assert(!pcl_utils::xyz_leading_floats<QaPointOffsetXYZ>::value, "Offset XYZ copied");
+static_assert(!pcl_utils::xyz_leading_floats<pcl::Normal>::value, "No XYZ copied");
+
+#define NUM_POINTS 10007
+#define EPSILON 1e-4
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static float
+rand_coord()
+{
+	return ((float)rand() / RAND_MAX - 0.5f) * 200.f;
+}
+
+static bool
+close_to(float a, float b)
+{
+	return std::fabs(a - b) <= EPSILON * std::max(1.f, std::fabs(b));
+}
+
+/** Compare in-place transform to transforming into a new cloud.
+ * @param transform transform to apply
+ * @param cloud input cloud, all points must be finite
+ * @param same_extra function checking the non-coordinate fields
+ * @return true if all points are equal
+ */
+template <typename PointT, typename ExtraCompare>
+static bool
+in_place_equals_copy(const tf::Transform &          transform,
+                     const pcl::PointCloud<PointT> &cloud,
+                     ExtraCompare                   same_extra)
+{
+	pcl::PointCloud<PointT> copied, in_place(cloud);
+	pcl_utils::transform_pointcloud(cloud, copied, transform);
+	pcl_utils::transform_pointcloud(in_place, transform);
+
+	if (in_place.points.size() != cloud.points.size())
+		return false;
+	for (size_t i = 0; i < cloud.points.size(); ++i) {
+		const PointT &a = in_place.points[i], &b = copied.points[i];
+		if (!close_to(a.x, b.x) || !close_to(a.y, b.y) || !close_to(a.z, b.z)
+		    || !same_extra(a, cloud.points[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int
+main(int argc, char **argv)
+{
+	int failures = 0;
+	srand(4711);
+
+	tf::Transform t(tf::Quaternion(tf::Vector3(0.3, -0.5, 0.8).normalized(), 1.234),
+	                tf::Vector3(1.5, -2.25, 0.75));
+
+	pcl::PointCloud<pcl::PointXYZ>    xyz;
+	pcl::PointCloud<pcl::PointXYZRGB> xyzrgb;
+	pcl::PointCloud<QaPointOffsetXYZ> offset;
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		float x = rand_coord(), y = rand_coord(), z = rand_coord();
+		xyz.push_back(pcl::PointXYZ(x, y, z));
+		pcl::PointXYZRGB p(i % 256, (i / 256) % 256, 42);
+		p.x = x;
+		p.y = y;
+		p.z = z;
+		xyzrgb.push_back(p);
+		QaPointOffsetXYZ o;
+		o.label = i;
+		o.x     = x;
+		o.y     = y;
+		o.z     = z;
+		offset.push_back(o);
+	}
+
+	failures += check(in_place_equals_copy(t,
+	                                       xyz,
+	                                       [](const pcl::PointXYZ &, const pcl::PointXYZ &) {
+		                                       return true;
+	                                       }),
+	                  "PointXYZ in place equals copy");
+	failures += check(in_place_equals_copy(t,
+	                                       xyzrgb,
+	                                       [](const pcl::PointXYZRGB &a, const pcl::PointXYZRGB &b) {
+		                                       return a.rgba == b.rgba;
+	                                       }),
+	                  "PointXYZRGB in place equals copy");
+	failures += check(in_place_equals_copy(t,
+	                                       offset,
+	                                       [](const QaPointOffsetXYZ &a, const QaPointOffsetXYZ &b) {
+		                                       return a.label == b.label;
+	                                       }),
+	                  "Offset coordinates fall back to copy");
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
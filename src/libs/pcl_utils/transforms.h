@@ -25,10 +25,14 @@
 
 #include <pcl/common/transforms.h>
 #include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
 #include <pcl_utils/utils.h>
+#include <tf/batch_transform.h>
 #include <tf/transformer.h>
 #include <tf/types.h>
 
+#include <type_traits>
+
 namespace fawkes {
 namespace pcl_utils {
 
@@ -59,19 +63,69 @@ transform_pointcloud(const pcl::PointCloud<PointT> &cloud_in,
 	pcl::transformPointCloud(cloud_in, cloud_out, origin, rotation);
 }
 
-/** Apply a rigid transform.
- * @param cloud_inout input and output point cloud
- * @param transform a rigid transformation from tf
- * @note calls the Eigen version
+/// @cond INTERNALS
+/** Check if a point type starts with packed float x, y, z coordinates.
+ * Only then the batch transform kernel of tf can be used in place.
  */
+template <typename PointT, bool HasXYZ = pcl::traits::has_xyz<PointT>::value>
+struct xyz_leading_floats : std::false_type
+{
+};
+
+template <typename PointT>
+struct xyz_leading_floats<PointT, true>
+: std::integral_constant<
+    bool,
+    std::is_same<typename pcl::traits::datatype<PointT, pcl::fields::x>::type, float>::value
+      && std::is_same<typename pcl::traits::datatype<PointT, pcl::fields::y>::type, float>::value
+      && std::is_same<typename pcl::traits::datatype<PointT, pcl::fields::z>::type, float>::value
+      && pcl::traits::offset<PointT, pcl::fields::x>::value == 0
+      && pcl::traits::offset<PointT, pcl::fields::y>::value == sizeof(float)
+      && pcl::traits::offset<PointT, pcl::fields::z>::value == 2 * sizeof(float)
+      && sizeof(PointT) % sizeof(float) == 0>
+{
+};
+
 template <typename PointT>
 void
-transform_pointcloud(pcl::PointCloud<PointT> &cloud_inout, const tf::Transform &transform)
+transform_pointcloud_inplace(pcl::PointCloud<PointT> &cloud_inout,
+                             const tf::Transform &    transform,
+                             std::true_type)
+{
+	if (cloud_inout.points.empty())
+		return;
+	tf::transform_points(transform,
+	                     &cloud_inout.points[0].x,
+	                     cloud_inout.points.size(),
+	                     sizeof(PointT) / sizeof(float));
+}
+
+template <typename PointT>
+void
+transform_pointcloud_inplace(pcl::PointCloud<PointT> &cloud_inout,
+                             const tf::Transform &    transform,
+                             std::false_type)
 {
 	pcl::PointCloud<PointT> tmp;
 	transform_pointcloud(cloud_inout, tmp, transform);
 	cloud_inout = tmp;
 }
+/// @endcond
+
+/** Apply a rigid transform in place.
+ * If the point type starts with float x, y, and z coordinates, as all PCL
+ * XYZ point types do, the points are transformed in place with the batch
+ * transform kernel of tf without copying the point cloud. Other point types
+ * are transformed with the Eigen version through a temporary copy.
+ * @param cloud_inout input and output point cloud
+ * @param transform a rigid transformation from tf
+ */
+template <typename PointT>
+void
+transform_pointcloud(pcl::PointCloud<PointT> &cloud_inout, const tf::Transform &transform)
+{
+	transform_pointcloud_inplace(cloud_inout, transform, xyz_leading_floats<PointT>());
+}
 
 /** Transform a point cloud in a given target TF frame using the given transfomer.
  * @param target_frame the target TF frame the point cloud should be transformed to
@@ -113,9 +167,40 @@ transform_pointcloud(const std::string &      target_frame,
                      pcl::PointCloud<PointT> &cloud_inout,
                      const tf::Transformer &  transformer)
 {
-	pcl::PointCloud<PointT> tmp;
-	transform_pointcloud(target_frame, cloud_inout, tmp, transformer);
-	cloud_inout = tmp;
+	if (cloud_inout.header.frame_id == target_frame)
+		return;
+
+	fawkes::Time source_time;
+	pcl_utils::get_time(cloud_inout, source_time);
+	tf::StampedTransform transform;
+	transformer.lookup_transform(target_frame, cloud_inout.header.frame_id, source_time, transform);
+
+	transform_pointcloud(cloud_inout, transform);
+	cloud_inout.header.frame_id = target_frame;
+}
+
+/** Transform a point cloud in place using a resolved frame chain.
+ * Use this for clouds which are repeatedly transformed between the same
+ * frames, the frames are not looked up again for each cloud. The cloud
+ * must be given in the source frame of the chain.
+ * @param chain frame chain resolved with tf::Transformer::resolve_frame_chain()
+ * @param cloud_inout input and output point cloud
+ * @param transformer TF transformer
+ * @exception tf::TransformException if transform retrieval fails
+ */
+template <typename PointT>
+void
+transform_pointcloud(const tf::FrameChain &   chain,
+                     pcl::PointCloud<PointT> &cloud_inout,
+                     const tf::Transformer &  transformer)
+{
+	fawkes::Time source_time;
+	pcl_utils::get_time(cloud_inout, source_time);
+	tf::StampedTransform transform;
+	transformer.lookup_transform(chain, source_time, transform);
+
+	transform_pointcloud(cloud_inout, transform);
+	cloud_inout.header.frame_id = chain.target_frame();
 }
 
 /** Transform a point cloud in a given target TF frame using the given transfomer.
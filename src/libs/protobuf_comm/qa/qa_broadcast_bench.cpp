@@ -0,0 +1,174 @@
+
+/***************************************************************************
+ *  qa_broadcast_bench.cpp - protobuf_comm broadcast benchmark
+ *
+ *  Created: Fri Oct 16 15:48:27 2026
+ *  Copyright  2013-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in
+ *   the documentation and/or other materials provided with the
+ *   distribution.
+ * - Neither the name of the authors nor the names of its contributors
+ *   may be used to endorse or promote products derived from this
+ *   software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/// @cond QA
+
+// Broadcasts messages from a server to a number of local clients and
+// measures the time and CPU time until all clients received all messages.
+// Messages are either sent with send_to_all(), which serializes each message
+// once, or with send() per client, which serializes it for every client.
+
+#include <google/protobuf/wrappers.pb.h>
+#include <protobuf_comm/client.h>
+#include <protobuf_comm/server.h>
+#include <sys/resource.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace protobuf_comm;
+
+static std::atomic<unsigned int>  num_connected(0);
+static std::atomic<unsigned long> num_received(0);
+
+static double
+cpu_time()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec
+	       + usage.ru_stime.tv_usec / 1e6;
+}
+
+static void
+handle_message(uint16_t, uint16_t, std::shared_ptr<google::protobuf::Message>)
+{
+	++num_received;
+}
+
+static bool
+run(ProtobufStreamServer &                     server,
+    std::list<ProtobufStreamServer::ClientID> &clients,
+    google::protobuf::BytesValue &             msg,
+    unsigned int                               num_messages,
+    bool                                       per_client)
+{
+	unsigned long expected = num_received + (unsigned long)num_messages * clients.size();
+
+	auto   start     = std::chrono::steady_clock::now();
+	double start_cpu = cpu_time();
+	for (unsigned int i = 0; i < num_messages; ++i) {
+		if (per_client) {
+			for (ProtobufStreamServer::ClientID c : clients) {
+				server.send(c, 1, 1, msg);
+			}
+		} else {
+			server.send_to_all(1, 1, msg);
+		}
+	}
+	double send_cpu = cpu_time() - start_cpu;
+
+	auto timeout = start + std::chrono::seconds(60);
+	while (num_received < expected && std::chrono::steady_clock::now() < timeout) {
+		usleep(1000);
+	}
+	double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	double cpu = cpu_time() - start_cpu;
+
+	printf("%-12s %8.3f s  %8.0f msg/s  CPU %7.3f s (send %7.3f s)%s\n",
+	       per_client ? "per client" : "send_to_all",
+	       sec,
+	       num_messages * clients.size() / sec,
+	       cpu,
+	       send_cpu,
+	       num_received < expected ? "  TIMEOUT" : "");
+	return num_received >= expected;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned short port         = 4444;
+	unsigned int   num_clients  = 20;
+	unsigned int   num_messages = 10000;
+	unsigned int   size         = 256;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "p:c:n:s:h")) != -1) {
+		switch (opt) {
+		case 'p': port = atoi(optarg); break;
+		case 'c': num_clients = atoi(optarg); break;
+		case 'n': num_messages = atoi(optarg); break;
+		case 's': size = atoi(optarg); break;
+		default:
+			printf("Usage: %s [-p port] [-c clients] [-n messages] [-s size]\n", argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	ProtobufStreamServer server(port);
+	server.message_register().add_message_type<google::protobuf::BytesValue>(1, 1);
+
+	std::list<ProtobufStreamServer::ClientID> clients;
+	server.signal_connected().connect(
+	  [&clients](ProtobufStreamServer::ClientID c, boost::asio::ip::tcp::endpoint &) {
+		  clients.push_back(c);
+		  ++num_connected;
+	  });
+
+	std::list<std::shared_ptr<ProtobufStreamClient>> pb_clients;
+	for (unsigned int i = 0; i < num_clients; ++i) {
+		std::shared_ptr<ProtobufStreamClient> c = std::make_shared<ProtobufStreamClient>();
+		c->message_register().add_message_type<google::protobuf::BytesValue>(1, 1);
+		c->signal_received().connect(handle_message);
+		c->async_connect("localhost", port);
+		pb_clients.push_back(c);
+	}
+	while (num_connected < num_clients) {
+		usleep(1000);
+	}
+
+	google::protobuf::BytesValue msg;
+	msg.set_value(std::string(size, 'x'));
+
+	printf("%u clients, %u messages of %u bytes\n", num_clients, num_messages, size);
+	bool ok = run(server, clients, msg, num_messages, true);
+	ok      = run(server, clients, msg, num_messages, false) && ok;
+
+	pb_clients.clear();
+	google::protobuf::ShutdownProtobufLibrary();
+	return ok ? 0 : 1;
+}
+
+/// @endcond
@@ -39,6 +39,9 @@
 
 #include <array>
 #include <boost/asio.hpp>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace protobuf_comm {
 
@@ -60,6 +63,71 @@ public:
 	std::string encrypted_message;                    ///< encrypted buffer if encryption is used
 };
 
+/** Pool of outgoing queue entries.
+ * Entries are handed out as shared pointers which return the entry to the
+ * pool once the last reference is gone. Recycled entries keep the memory
+ * of their serialized message, so that messages of similar size can be
+ * serialized without allocating memory. The pool must itself be managed
+ * by a shared pointer, entries keep it alive.
+ */
+class QueueEntryPool : public std::enable_shared_from_this<QueueEntryPool>
+{
+public:
+	/** Constructor.
+	 * @param max_free maximum number of unused entries to keep
+	 */
+	explicit QueueEntryPool(size_t max_free = 64) : max_free_(max_free)
+	{
+	}
+
+	/** Destructor. */
+	~QueueEntryPool()
+	{
+		for (QueueEntry *e : free_) {
+			delete e;
+		}
+	}
+
+	/** Get an entry.
+	 * @return unused entry, the frame header and the message must be set
+	 */
+	std::shared_ptr<QueueEntry>
+	get()
+	{
+		QueueEntry *e = NULL;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!free_.empty()) {
+				e = free_.back();
+				free_.pop_back();
+			}
+		}
+		if (!e)
+			e = new QueueEntry();
+
+		std::shared_ptr<QueueEntryPool> pool = shared_from_this();
+		return std::shared_ptr<QueueEntry>(e, [pool](QueueEntry *e) { pool->put(e); });
+	}
+
+private:
+	void
+	put(QueueEntry *e)
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (free_.size() < max_free_) {
+			e->encrypted_message.clear();
+			free_.push_back(e);
+		} else {
+			delete e;
+		}
+	}
+
+private:
+	size_t                    max_free_;
+	std::mutex                mutex_;
+	std::vector<QueueEntry *> free_;
+};
+
 } // end namespace protobuf_comm
 
 #endif
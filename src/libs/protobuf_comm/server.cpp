@@ -36,6 +36,7 @@
 
 #include <protobuf_comm/server.h>
 
+#include <algorithm>
 #include <cstdlib>
 
 using namespace boost::asio;
@@ -43,10 +44,15 @@ using namespace boost::system;
 
 namespace protobuf_comm {
 
+/// Maximum number of messages written at once, asio gathers up to 64 buffers
+#define MAX_ENTRIES_PER_WRITE 21
+
 /** @class ProtobufStreamServer::Session <protobuf_comm/server.h>
  * Internal class representing a client session.
  * This class represents a connection to a particular client. It handles
  * connection management, reading from, and writing to the client.
+ * Messages queued while a write is in progress are sent together with a
+ * single gathering write once it completes.
  * @author Tim Niemueller 
  */
 
@@ -100,42 +106,43 @@ ProtobufStreamServer::Session::start_read()
 }
 
 /** Send a message.
- * @param component_id ID of the component to address
- * @param msg_type numeric message type
- * @param m Message to send
+ * The entry is not modified and may be sent to several sessions at once.
+ * @param entry queue entry with the serialized message to send
  */
 void
-ProtobufStreamServer::Session::send(uint16_t                   component_id,
-                                    uint16_t                   msg_type,
-                                    google::protobuf::Message &m)
+ProtobufStreamServer::Session::send(std::shared_ptr<QueueEntry> entry)
 {
-	QueueEntry *entry = new QueueEntry();
-	parent_->message_register().serialize(component_id,
-	                                      msg_type,
-	                                      m,
-	                                      entry->frame_header,
-	                                      entry->message_header,
-	                                      entry->serialized_message);
-
-	entry->buffers[0] = boost::asio::buffer(&entry->frame_header, sizeof(frame_header_t));
-	entry->buffers[1] = boost::asio::buffer(&entry->message_header, sizeof(message_header_t));
-	entry->buffers[2] = boost::asio::buffer(entry->serialized_message);
-
 	std::lock_guard<std::mutex> lock(outbound_mutex_);
-	if (outbound_active_) {
-		outbound_queue_.push(entry);
-	} else {
+	outbound_queue_.push_back(entry);
+	if (!outbound_active_) {
 		outbound_active_ = true;
-		boost::asio::async_write(socket_,
-		                         entry->buffers,
-		                         boost::bind(&ProtobufStreamServer::Session::handle_write,
-		                                     shared_from_this(),
-		                                     boost::asio::placeholders::error,
-		                                     boost::asio::placeholders::bytes_transferred,
-		                                     entry));
+		start_write();
 	}
 }
 
+/** Write queued messages.
+ * Must be called with the outbound mutex locked.
+ */
+void
+ProtobufStreamServer::Session::start_write()
+{
+	size_t n = std::min<size_t>(outbound_queue_.size(), MAX_ENTRIES_PER_WRITE);
+	outbound_writing_.assign(outbound_queue_.begin(), outbound_queue_.begin() + n);
+	outbound_queue_.erase(outbound_queue_.begin(), outbound_queue_.begin() + n);
+
+	outbound_buffers_.clear();
+	for (const std::shared_ptr<QueueEntry> &e : outbound_writing_) {
+		outbound_buffers_.insert(outbound_buffers_.end(), e->buffers.begin(), e->buffers.end());
+	}
+
+	boost::asio::async_write(socket_,
+	                         outbound_buffers_,
+	                         boost::bind(&ProtobufStreamServer::Session::handle_write,
+	                                     shared_from_this(),
+	                                     boost::asio::placeholders::error,
+	                                     boost::asio::placeholders::bytes_transferred));
+}
+
 /** Disconnect from client. */
 void
 ProtobufStreamServer::Session::disconnect()
@@ -150,29 +157,22 @@ ProtobufStreamServer::Session::disconnect()
 /** Write completion handler. */
 void
 ProtobufStreamServer::Session::handle_write(const boost::system::error_code &error,
-                                            size_t /*bytes_transferred*/,
-                                            QueueEntry *entry)
+                                            size_t /*bytes_transferred*/)
 {
-	delete entry;
-
-	if (!error) {
+	{
 		std::lock_guard<std::mutex> lock(outbound_mutex_);
-		if (!outbound_queue_.empty()) {
-			QueueEntry *front_entry = outbound_queue_.front();
-			outbound_queue_.pop();
-			boost::asio::async_write(socket_,
-			                         front_entry->buffers,
-			                         boost::bind(&ProtobufStreamServer::Session::handle_write,
-			                                     shared_from_this(),
-			                                     boost::asio::placeholders::error,
-			                                     boost::asio::placeholders::bytes_transferred,
-			                                     front_entry));
-		} else {
-			outbound_active_ = false;
+		outbound_writing_.clear();
+		if (!error) {
+			if (!outbound_queue_.empty()) {
+				start_write();
+			} else {
+				outbound_active_ = false;
+			}
+			return;
 		}
-	} else {
-		parent_->disconnected(shared_from_this(), error);
+		outbound_queue_.clear();
 	}
+	parent_->disconnected(shared_from_this(), error);
 }
 
 /** Incoming data handler for header.
@@ -242,6 +242,9 @@ ProtobufStreamServer::Session::handle_read_message(const boost::system::error_co
  * The server opens a TCP socket (IPv4) and waits for incoming connections.
  * Each incoming connection is given a unique client ID. Signals are
  * provided that can be used to react to connections and incoming data.
+ *
+ * Messages sent to all clients are serialized only once and the very same
+ * buffers are written to every client. Queue entries are recycled.
  * @author Tim Niemueller
  */
 
@@ -254,6 +257,7 @@ ProtobufStreamServer::ProtobufStreamServer(unsigned short port)
 	message_register_     = new MessageRegister();
 	own_message_register_ = true;
 	next_cid_             = 1;
+	entry_pool_           = std::make_shared<QueueEntryPool>();
 
 	acceptor_.set_option(socket_base::reuse_address(true));
 
@@ -274,6 +278,7 @@ ProtobufStreamServer::ProtobufStreamServer(unsigned short            port,
 	message_register_     = new MessageRegister(proto_path);
 	own_message_register_ = true;
 	next_cid_             = 1;
+	entry_pool_           = std::make_shared<QueueEntryPool>();
 
 	acceptor_.set_option(socket_base::reuse_address(true));
 
@@ -291,7 +296,8 @@ ProtobufStreamServer::ProtobufStreamServer(unsigned short port, MessageRegister
   message_register_(mr),
   own_message_register_(false)
 {
-	next_cid_ = 1;
+	next_cid_   = 1;
+	entry_pool_ = std::make_shared<QueueEntryPool>();
 
 	acceptor_.set_option(socket_base::reuse_address(true));
 
@@ -325,7 +331,7 @@ ProtobufStreamServer::send(ClientID                   client,
 		throw std::runtime_error("Client does not exist");
 	}
 
-	sessions_[client]->send(component_id, msg_type, m);
+	sessions_[client]->send(serialize(component_id, msg_type, m));
 }
 
 /** Send a message.
@@ -350,6 +356,22 @@ ProtobufStreamServer::send(ClientID                                   client,
  */
 void
 ProtobufStreamServer::send(ClientID client, google::protobuf::Message &m)
+{
+	uint16_t comp_id, msg_type;
+	comp_type(m, comp_id, msg_type);
+	send(client, comp_id, msg_type, m);
+}
+
+/** Determine component ID and message type of a message.
+ * @param m message, the message must have an CompType enum type to
+ * specify component ID and message type.
+ * @param component_id upon return contains the component ID
+ * @param msg_type upon return contains the message type
+ */
+void
+ProtobufStreamServer::comp_type(google::protobuf::Message &m,
+                                uint16_t &                 component_id,
+                                uint16_t &                 msg_type)
 {
 	const google::protobuf::Descriptor *    desc     = m.GetDescriptor();
 	const google::protobuf::EnumDescriptor *enumdesc = desc->FindEnumTypeByName("CompType");
@@ -361,16 +383,41 @@ ProtobufStreamServer::send(ClientID client, google::protobuf::Message &m)
 	if (!compdesc || !msgtdesc) {
 		throw std::logic_error("Message CompType enum hs no COMP_ID or MSG_TYPE value");
 	}
-	int comp_id  = compdesc->number();
-	int msg_type = msgtdesc->number();
+	int comp_id = compdesc->number();
+	int type    = msgtdesc->number();
 	if (comp_id < 0 || comp_id > std::numeric_limits<uint16_t>::max()) {
 		throw std::logic_error("Message has invalid COMP_ID");
 	}
-	if (msg_type < 0 || msg_type > std::numeric_limits<uint16_t>::max()) {
+	if (type < 0 || type > std::numeric_limits<uint16_t>::max()) {
 		throw std::logic_error("Message has invalid MSG_TYPE");
 	}
+	component_id = comp_id;
+	msg_type     = type;
+}
 
-	send(client, comp_id, msg_type, m);
+/** Serialize a message into a queue entry.
+ * @param component_id ID of the component to address
+ * @param msg_type numeric message type
+ * @param m message to serialize
+ * @return queue entry ready to be sent to any number of sessions
+ */
+std::shared_ptr<QueueEntry>
+ProtobufStreamServer::serialize(uint16_t                   component_id,
+                                uint16_t                   msg_type,
+                                google::protobuf::Message &m)
+{
+	std::shared_ptr<QueueEntry> entry = entry_pool_->get();
+	message_register_->serialize(component_id,
+	                             msg_type,
+	                             m,
+	                             entry->frame_header,
+	                             entry->message_header,
+	                             entry->serialized_message);
+
+	entry->buffers[0] = boost::asio::buffer(&entry->frame_header, sizeof(frame_header_t));
+	entry->buffers[1] = boost::asio::buffer(&entry->message_header, sizeof(message_header_t));
+	entry->buffers[2] = boost::asio::buffer(entry->serialized_message);
+	return entry;
 }
 
 /** Send a message.
@@ -394,9 +441,14 @@ ProtobufStreamServer::send_to_all(uint16_t                   component_id,
                                   uint16_t                   msg_type,
                                   google::protobuf::Message &m)
 {
+	if (sessions_.empty())
+		return;
+
+	std::shared_ptr<QueueEntry> entry = serialize(component_id, msg_type, m);
+
 	std::map<ClientID, boost::shared_ptr<Session>>::iterator s;
 	for (s = sessions_.begin(); s != sessions_.end(); ++s) {
-		send(s->first, component_id, msg_type, m);
+		s->second->send(entry);
 	}
 }
 
@@ -410,10 +462,7 @@ ProtobufStreamServer::send_to_all(uint16_t                                   com
                                   uint16_t                                   msg_type,
                                   std::shared_ptr<google::protobuf::Message> m)
 {
-	std::map<ClientID, boost::shared_ptr<Session>>::iterator s;
-	for (s = sessions_.begin(); s != sessions_.end(); ++s) {
-		send(s->first, component_id, msg_type, m);
-	}
+	send_to_all(component_id, msg_type, *m);
 }
 
 /** Send a message to all clients.
@@ -422,10 +471,7 @@ ProtobufStreamServer::send_to_all(uint16_t                                   com
 void
 ProtobufStreamServer::send_to_all(std::shared_ptr<google::protobuf::Message> m)
 {
-	std::map<ClientID, boost::shared_ptr<Session>>::iterator s;
-	for (s = sessions_.begin(); s != sessions_.end(); ++s) {
-		send(s->first, m);
-	}
+	send_to_all(*m);
 }
 
 /** Send a message to all clients.
@@ -434,10 +480,9 @@ ProtobufStreamServer::send_to_all(std::shared_ptr<google::protobuf::Message> m)
 void
 ProtobufStreamServer::send_to_all(google::protobuf::Message &m)
 {
-	std::map<ClientID, boost::shared_ptr<Session>>::iterator s;
-	for (s = sessions_.begin(); s != sessions_.end(); ++s) {
-		send(s->first, m);
-	}
+	uint16_t comp_id, msg_type;
+	comp_type(m, comp_id, msg_type);
+	send_to_all(comp_id, msg_type, m);
 }
 
 /** Disconnect specific client.
@@ -49,9 +49,10 @@
 #ifndef _GLIBCXX_USE_SCHED_YIELD
 #	define _GLIBCXX_USE_SCHED_YIELD
 #endif
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <vector>
 #if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 7))
 #	include <atomic>
 #endif
@@ -168,15 +169,14 @@ private:
 
 		void start_session();
 		void start_read();
-		void send(uint16_t component_id, uint16_t msg_type, google::protobuf::Message &m);
+		void send(std::shared_ptr<QueueEntry> entry);
 		void disconnect();
 
 	private:
 		void handle_read_message(const boost::system::error_code &error);
 		void handle_read_header(const boost::system::error_code &error);
-		void handle_write(const boost::system::error_code &error,
-		                  size_t /*bytes_transferred*/,
-		                  QueueEntry *entry);
+		void start_write();
+		void handle_write(const boost::system::error_code &error, size_t /*bytes_transferred*/);
 
 	private:
 		ClientID                       id_;
@@ -188,9 +188,11 @@ private:
 		size_t         in_data_size_;
 		void *         in_data_;
 
-		std::queue<QueueEntry *> outbound_queue_;
-		std::mutex               outbound_mutex_;
-		bool                     outbound_active_;
+		std::vector<std::shared_ptr<QueueEntry>> outbound_queue_;
+		std::vector<std::shared_ptr<QueueEntry>> outbound_writing_;
+		std::vector<boost::asio::const_buffer>   outbound_buffers_;
+		std::mutex                               outbound_mutex_;
+		bool                                     outbound_active_;
 	};
 
 private: // methods
@@ -200,6 +202,10 @@ private: // methods
 
 	void disconnected(boost::shared_ptr<Session> session, const boost::system::error_code &error);
 
+	std::shared_ptr<QueueEntry>
+	     serialize(uint16_t component_id, uint16_t msg_type, google::protobuf::Message &m);
+	void comp_type(google::protobuf::Message &m, uint16_t &component_id, uint16_t &msg_type);
+
 private: // members
 	boost::asio::io_service        io_service_;
 	boost::asio::ip::tcp::acceptor acceptor_;
@@ -223,6 +229,8 @@ private: // members
 
 	MessageRegister *message_register_;
 	bool             own_message_register_;
+
+	std::shared_ptr<QueueEntryPool> entry_pool_;
 };
 
 } // end namespace protobuf_comm
@@ -0,0 +1,130 @@
+
+/***************************************************************************
+ *  batch_transform.cpp - Fawkes tf apply transforms to many points at once
+ *
+ *  Created: Fri Oct 16 22:14:05 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <tf/batch_transform.h>
+
+#include <cstdint>
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
+
+namespace fawkes {
+namespace tf {
+
+/** Transform points.
+ * The rotation matrix of the transform is computed once and then applied
+ * to all points in a tight loop.
+ * @param transform transform to apply
+ * @param in input points
+ * @param out output points, may be the same as @p in
+ * @param num_points number of points in @p in and @p out
+ */
+void
+transform_points(const Transform &transform, const Point *in, Point *out, size_t num_points)
+{
+	const Matrix3x3 &basis = transform.getBasis();
+	const Vector3 &  o     = transform.getOrigin();
+
+	const Scalar r00 = basis[0].x(), r01 = basis[0].y(), r02 = basis[0].z();
+	const Scalar r10 = basis[1].x(), r11 = basis[1].y(), r12 = basis[1].z();
+	const Scalar r20 = basis[2].x(), r21 = basis[2].y(), r22 = basis[2].z();
+	const Scalar tx = o.x(), ty = o.y(), tz = o.z();
+
+	for (size_t i = 0; i < num_points; ++i) {
+		const Scalar x = in[i].x(), y = in[i].y(), z = in[i].z();
+		out[i].setValue(r00 * x + r01 * y + r02 * z + tx,
+		                r10 * x + r11 * y + r12 * z + ty,
+		                r20 * x + r21 * y + r22 * z + tz);
+	}
+}
+
+/** Transform points in place stored as floats.
+ * This is meant for point clouds which store the coordinates of each point
+ * as consecutive x, y, and z floats, followed by other data. The transform
+ * is applied in single precision. If the stride is four floats and the data
+ * is 16 byte aligned, for example for PCL points, an SSE2 kernel processes
+ * all coordinates of a point at once. All other data, including the fourth
+ * float of each point, is preserved.
+ * @param transform transform to apply
+ * @param xyz pointer to x coordinate of first point
+ * @param num_points number of points
+ * @param stride distance between the x coordinates of two consecutive
+ * points in number of floats, must be at least three
+ */
+void
+transform_points(const Transform &transform, float *xyz, size_t num_points, size_t stride)
+{
+	const Matrix3x3 &basis = transform.getBasis();
+	const Vector3 &  o     = transform.getOrigin();
+
+	const float r00 = basis[0].x(), r01 = basis[0].y(), r02 = basis[0].z();
+	const float r10 = basis[1].x(), r11 = basis[1].y(), r12 = basis[1].z();
+	const float r20 = basis[2].x(), r21 = basis[2].y(), r22 = basis[2].z();
+	const float tx = o.x(), ty = o.y(), tz = o.z();
+
+#ifdef __SSE2__
+	if (stride == 4 && ((uintptr_t)xyz & 0xF) == 0) {
+		// columns of the rotation matrix and the translation
+		const __m128 c0   = _mm_setr_ps(r00, r10, r20, 0.f);
+		const __m128 c1   = _mm_setr_ps(r01, r11, r21, 0.f);
+		const __m128 c2   = _mm_setr_ps(r02, r12, r22, 0.f);
+		const __m128 t    = _mm_setr_ps(tx, ty, tz, 0.f);
+		const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+
+		float *p = xyz;
+		for (size_t i = 0; i < num_points; ++i, p += 4) {
+			__m128 v = _mm_load_ps(p);
+			__m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))), t);
+			r        = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+			r        = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+			// keep the fourth element of the input
+			_mm_store_ps(p, _mm_or_ps(_mm_and_ps(mask, r), _mm_andnot_ps(mask, v)));
+		}
+		return;
+	}
+#endif
+
+	float *p = xyz;
+	for (size_t i = 0; i < num_points; ++i, p += stride) {
+		const float x = p[0], y = p[1], z = p[2];
+		p[0]          = r00 * x + r01 * y + r02 * z + tx;
+		p[1]          = r10 * x + r11 * y + r12 * z + ty;
+		p[2]          = r20 * x + r21 * y + r22 * z + tz;
+	}
+}
+
+/** Transform poses.
+ * @param transform transform to apply
+ * @param in input poses
+ * @param out output poses, may be the same as @p in
+ * @param num_poses number of poses in @p in and @p out
+ */
+void
+transform_poses(const Transform &transform, const Pose *in, Pose *out, size_t num_poses)
+{
+	for (size_t i = 0; i < num_poses; ++i) {
+		out[i] = transform * in[i];
+	}
+}
+
+} // end namespace tf
+} // end namespace fawkes
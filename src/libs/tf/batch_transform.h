@@ -0,0 +1,42 @@
+
+/***************************************************************************
+ *  batch_transform.h - Fawkes tf apply transforms to many points at once
+ *
+ *  Created: Fri Oct 16 22:14:05 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_TF_BATCH_TRANSFORM_H_
+#define _LIBS_TF_BATCH_TRANSFORM_H_
+
+#include <tf/types.h>
+
+#include <cstddef>
+
+namespace fawkes {
+namespace tf {
+
+void transform_points(const Transform &transform, const Point *in, Point *out, size_t num_points);
+
+void transform_points(const Transform &transform, float *xyz, size_t num_points, size_t stride);
+
+void transform_poses(const Transform &transform, const Pose *in, Pose *out, size_t num_poses);
+
+} // end namespace tf
+} // end namespace fawkes
+
+#endif
@@ -124,7 +124,7 @@ BufferCore::validate_frame_id(const char *function_name_arg, const std::string &
 /** Constructor
  * @param cache_time How long to keep a history of transforms in nanoseconds
  */
-BufferCore::BufferCore(float cache_time) : cache_time_(cache_time)
+BufferCore::BufferCore(float cache_time) : cache_time_(cache_time), frame_tree_version_(1)
 {
 	frameIDs_["NO_PARENT"] = 0;
 	frames_.push_back(TimeCacheInterfacePtr());
@@ -141,6 +141,7 @@ BufferCore::clear()
 {
 	//old_tf_.clear();
 	std::unique_lock<std::mutex> lock(frame_mutex_);
+	frame_tree_version_ += 1;
 	if (frames_.size() > 1) {
 		for (std::vector<TimeCacheInterfacePtr>::iterator cache_it = frames_.begin() + 1;
 		     cache_it != frames_.end();
@@ -220,9 +221,13 @@ BufferCore::set_transform(const StampedTransform &transform_in,
 		if (!frame)
 			frame = allocate_frame(frame_number, is_static);
 
-		if (frame->insert_data(TransformStorage(stripped,
-		                                        lookup_or_insert_frame_number(stripped.frame_id),
-		                                        frame_number))) {
+		CompactFrameID parent_number = lookup_or_insert_frame_number(stripped.frame_id);
+		if (frame->get_latest_time_and_parent().second != parent_number) {
+			// new frame or changed parent, resolved frame chains are outdated
+			frame_tree_version_ += 1;
+		}
+
+		if (frame->insert_data(TransformStorage(stripped, parent_number, frame_number))) {
 			frame_authority_[frame_number] = authority;
 		} else {
 			printf("TF_OLD_DATA ignoring data from the past for frame %s "
@@ -252,7 +257,7 @@ BufferCore::allocate_frame(CompactFrameID cfid, bool is_static)
 	if (is_static) {
 		frames_[cfid] = TimeCacheInterfacePtr(new StaticCache());
 	} else {
-		frames_[cfid] = TimeCacheInterfacePtr(new TimeCache(cache_time_));
+		frames_[cfid] = TimeCacheInterfacePtr(new CircularTimeCache(cache_time_));
 	}
 
 	return frames_[cfid];
@@ -339,7 +344,7 @@ BufferCore::walk_to_top_parent(F &                          f,
 			break;
 		}
 
-		CompactFrameID parent = f.gather(cache, time, &extrapolation_error_string);
+		CompactFrameID parent = f.gather(cache.get(), time, &extrapolation_error_string);
 		if (parent == 0) {
 			// Just break out here... there may still be a path from source -> target
 			top_parent                        = frame;
@@ -384,7 +389,7 @@ BufferCore::walk_to_top_parent(F &                          f,
 			break;
 		}
 
-		CompactFrameID parent = f.gather(cache, time, error_string);
+		CompactFrameID parent = f.gather(cache.get(), time, error_string);
 		if (parent == 0) {
 			if (error_string) {
 				std::stringstream ss;
@@ -462,6 +467,95 @@ BufferCore::walk_to_top_parent(F &                          f,
 	return NO_ERROR;
 }
 
+/** Accumulate transform along the edges of a resolved frame chain.
+ * Must be called with the frame mutex locked.
+ * @param f accumulator
+ * @param time timestamp, set to (0,0) to use the latest common time of the edges
+ * @param chain resolved frame chain
+ * @param error_string accumulated error string
+ * @return error flag from ErrorValues, LOOKUP_ERROR if the edges of the
+ * chain are outdated and the tree must be walked instead
+ */
+template <typename F>
+int
+BufferCore::walk_frame_chain(F &               f,
+                             fawkes::Time      time,
+                             const FrameChain &chain,
+                             std::string *     error_string) const
+{
+	if (!chain.edges_resolved_ || chain.tree_version_ != frame_tree_version_) {
+		return LOOKUP_ERROR;
+	}
+
+	if (chain.source_id_ == chain.target_id_) {
+		f.finalize(Identity, time);
+		return NO_ERROR;
+	}
+
+	const std::vector<FrameChain::Edge> *edges[2] = {&chain.source_edges_, &chain.target_edges_};
+
+	if (time == fawkes::Time(0, 0)) {
+		fawkes::Time common_time = fawkes::TIME_MAX;
+		for (const std::vector<FrameChain::Edge> *side : edges) {
+			for (const FrameChain::Edge &e : *side) {
+				fawkes::Time latest = e.cache->get_latest_time_and_parent().first;
+				if (!latest.is_zero()) {
+					common_time = std::min(latest, common_time);
+				}
+			}
+		}
+		time = (common_time == fawkes::TIME_MAX) ? fawkes::Time(0, 0) : common_time;
+	}
+
+	std::string extrapolation_error_string;
+	for (const std::vector<FrameChain::Edge> *side : edges) {
+		for (const FrameChain::Edge &e : *side) {
+			CompactFrameID parent = f.gather(e.cache, time, &extrapolation_error_string);
+			if (parent == 0) {
+				if (error_string) {
+					std::stringstream ss;
+					ss << extrapolation_error_string << ", when looking up transform from frame ["
+					   << lookup_frame_string(chain.source_id_) << "] to frame ["
+					   << lookup_frame_string(chain.target_id_) << "]";
+					*error_string = ss.str();
+				}
+				return EXTRAPOLATION_ERROR;
+			} else if (parent != e.parent) {
+				// different parent at the requested time
+				return LOOKUP_ERROR;
+			}
+			f.accum(side == edges[0]);
+		}
+	}
+
+	f.finalize(FullPath, time);
+	return NO_ERROR;
+}
+
+/** Get edges from a frame to the root of its tree.
+ * Follows the latest parent of each frame. Must be called with the frame
+ * mutex locked.
+ * @param frame frame to start at
+ * @param edges upon return contains the edges, starting at the given frame
+ */
+void
+BufferCore::resolve_frame_edges(CompactFrameID frame, std::vector<FrameChain::Edge> &edges) const
+{
+	edges.clear();
+	while (frame != 0 && edges.size() <= MAX_GRAPH_DEPTH) {
+		TimeCacheInterfacePtr cache = get_frame(frame);
+		if (!cache) {
+			break;
+		}
+		CompactFrameID parent = cache->get_latest_time_and_parent().second;
+		if (parent == 0) {
+			break;
+		}
+		edges.push_back({cache.get(), parent});
+		frame = parent;
+	}
+}
+
 /// @cond INTERNAL
 struct TransformAccum
 {
@@ -476,7 +570,7 @@ struct TransformAccum
 	}
 
 	CompactFrameID
-	gather(TimeCacheInterfacePtr cache, fawkes::Time time, std::string *error_string)
+	gather(TimeCacheInterface *cache, fawkes::Time time, std::string *error_string)
 	{
 		if (!cache->get_data(time, st, error_string)) {
 			return 0;
@@ -602,6 +696,103 @@ BufferCore::lookup_transform(const std::string & target_frame,
 	transform.stamp          = accum.time;
 }
 
+/** Resolve frame chain.
+ * @param target_frame target frame ID
+ * @param source_frame source frame ID
+ * @return chain which can be passed to lookup_transform() repeatedly
+ * @exception LookupException at least one of the two given frames is
+ * unknown or invalid
+ */
+FrameChain
+BufferCore::resolve_frame_chain(const std::string &target_frame,
+                                const std::string &source_frame) const
+{
+	std::unique_lock<std::mutex> lock(frame_mutex_);
+
+	FrameChain chain;
+	chain.target_id_ = validate_frame_id("resolve_frame_chain argument target_frame", target_frame);
+	chain.source_id_ = validate_frame_id("resolve_frame_chain argument source_frame", source_frame);
+
+	chain.target_frame_ = target_frame;
+	chain.source_frame_ = source_frame;
+	chain.tree_version_ = frame_tree_version_;
+
+	// keep the edges from both frames up to their closest common ancestor
+	resolve_frame_edges(chain.source_id_, chain.source_edges_);
+	resolve_frame_edges(chain.target_id_, chain.target_edges_);
+	std::vector<CompactFrameID> source_path(1, chain.source_id_);
+	for (const FrameChain::Edge &e : chain.source_edges_) {
+		source_path.push_back(e.parent);
+	}
+	CompactFrameID ancestor = chain.target_id_;
+	size_t         t        = 0;
+	for (; t <= chain.target_edges_.size(); ++t) {
+		ancestor = (t == 0) ? chain.target_id_ : chain.target_edges_[t - 1].parent;
+		if (std::find(source_path.begin(), source_path.end(), ancestor) != source_path.end())
+			break;
+	}
+	if (t <= chain.target_edges_.size()) {
+		size_t s = std::find(source_path.begin(), source_path.end(), ancestor) - source_path.begin();
+		chain.source_edges_.resize(s);
+		chain.target_edges_.resize(t);
+		chain.edges_resolved_ = true;
+	} else {
+		// not connected (yet), lookups walk the tree
+		chain.source_edges_.clear();
+		chain.target_edges_.clear();
+	}
+
+	return chain;
+}
+
+/** Lookup transform for pre-resolved frames.
+ * @param chain frame chain created by resolve_frame_chain()
+ * @param time time for which to get the transform, set to (0,0) to get latest
+ * common time frame
+ * @param transform upon return contains the transform
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException the chain has not been resolved
+ */
+void
+BufferCore::lookup_transform(const FrameChain &  chain,
+                             const fawkes::Time &time,
+                             StampedTransform &  transform) const
+{
+	if (!chain.valid()) {
+		throw LookupException("Frame chain passed to lookup_transform has not been resolved");
+	}
+
+	std::string    error_string;
+	TransformAccum accum;
+	int            retval;
+	{
+		std::unique_lock<std::mutex> lock(frame_mutex_);
+		retval = walk_frame_chain(accum, time, chain, &error_string);
+		if (retval == LOOKUP_ERROR) {
+			// edges outdated, search the tree
+			accum  = TransformAccum();
+			retval = walk_to_top_parent(accum, time, chain.target_id_, chain.source_id_, &error_string);
+		}
+	}
+	if (retval != NO_ERROR) {
+		switch (retval) {
+		case CONNECTIVITY_ERROR: throw ConnectivityException("%s", error_string.c_str());
+		case EXTRAPOLATION_ERROR: throw ExtrapolationException("%s", error_string.c_str());
+		case LOOKUP_ERROR: throw LookupException("%s", error_string.c_str());
+		default: throw TransformException();
+		}
+	}
+
+	transform.setOrigin(accum.result_vec);
+	transform.setRotation(accum.result_quat);
+	transform.child_frame_id = chain.source_frame_;
+	transform.frame_id       = chain.target_frame_;
+	transform.stamp          = accum.time;
+}
+
 /** Lookup transform assuming a fixed frame.
  * This will lookup a transformation from source to target, assuming
  * that there is a fixed frame, by first finding the transform of the
@@ -645,7 +836,7 @@ BufferCore::lookup_transform(const std::string & target_frame,
 struct CanTransformAccum
 {
 	CompactFrameID
-	gather(TimeCacheInterfacePtr cache, fawkes::Time time, std::string *error_string)
+	gather(TimeCacheInterface *cache, fawkes::Time time, std::string *error_string)
 	{
 		return cache->get_parent(time, error_string);
 	}
@@ -52,6 +52,7 @@
 #ifndef _LIBS_TF_BUFFER_CORE_H_
 #define _LIBS_TF_BUFFER_CORE_H_
 
+#include <tf/frame_chain.h>
 #include <tf/transform_storage.h>
 #include <tf/types.h>
 #include <utils/time/time.h>
@@ -132,6 +133,13 @@ public:
 	                      const std::string & fixed_frame,
 	                      StampedTransform &  transform) const;
 
+	FrameChain resolve_frame_chain(const std::string &target_frame,
+	                               const std::string &source_frame) const;
+
+	void lookup_transform(const FrameChain &  chain,
+	                      const fawkes::Time &time,
+	                      StampedTransform &  transform) const;
+
 	bool can_transform(const std::string & target_frame,
 	                   const std::string & source_frame,
 	                   const fawkes::Time &time,
@@ -186,6 +194,10 @@ protected:
 	/// How long to cache transform history
 	float cache_time_;
 
+	/// Version of the frame tree, increased whenever frames are added or a
+	/// frame changes its parent, invalidates the edges of frame chains
+	uint64_t frame_tree_version_;
+
 	/************************* Internal Functions ****************************/
 
 	TimeCacheInterfacePtr get_frame(CompactFrameID c_frame_id) const;
@@ -229,6 +241,14 @@ protected:
 	                       std::string *                error_string,
 	                       std::vector<CompactFrameID> *frame_chain) const;
 
+	template <typename F>
+	int walk_frame_chain(F &               f,
+	                     fawkes::Time      time,
+	                     const FrameChain &chain,
+	                     std::string *     error_string) const;
+
+	void resolve_frame_edges(CompactFrameID frame, std::vector<FrameChain::Edge> &edges) const;
+
 	bool can_transform_internal(CompactFrameID      target_id,
 	                            CompactFrameID      source_id,
 	                            const fawkes::Time &time,
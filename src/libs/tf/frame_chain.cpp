@@ -0,0 +1,81 @@
+
+/***************************************************************************
+ *  frame_chain.cpp - Fawkes tf pre-resolved frame chain
+ *
+ *  Created: Fri Oct 16 22:10:31 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <tf/frame_chain.h>
+
+namespace fawkes {
+namespace tf {
+
+/** @class FrameChain <tf/frame_chain.h>
+ * Pre-resolved path between target and source frame.
+ * A frame chain is created by BufferCore::resolve_frame_chain(). It maps
+ * the frame names to their internal IDs and stores the transform caches
+ * of the edges from both frames to their common ancestor in the tree.
+ * Lookups with the chain interpolate along these edges directly, without
+ * searching the tree. This is meant for code which repeatedly transforms
+ * data between the same frames, for example each incoming point cloud.
+ *
+ * The chain remembers the version of the frame tree it has been resolved
+ * for. If a frame has been added or has changed its parent since, or if an
+ * edge has a different parent at the requested time, lookups fall back to
+ * searching the tree. Resolve the chain again to use the stored edges.
+ * A chain must not be used after the BufferCore it was created by has
+ * been destroyed.
+ */
+
+/** Constructor.
+ * Creates an invalid chain, use BufferCore::resolve_frame_chain().
+ */
+FrameChain::FrameChain()
+: target_id_(0), source_id_(0), edges_resolved_(false), tree_version_(0)
+{
+}
+
+/** Check if chain has been resolved.
+ * @return true if the chain has been resolved, false otherwise
+ */
+bool
+FrameChain::valid() const
+{
+	return target_id_ != 0 && source_id_ != 0;
+}
+
+/** Get target frame.
+ * @return target frame ID
+ */
+const std::string &
+FrameChain::target_frame() const
+{
+	return target_frame_;
+}
+
+/** Get source frame.
+ * @return source frame ID
+ */
+const std::string &
+FrameChain::source_frame() const
+{
+	return source_frame_;
+}
+
+} // end namespace tf
+} // end namespace fawkes
@@ -0,0 +1,73 @@
+
+/***************************************************************************
+ *  frame_chain.h - Fawkes tf pre-resolved frame chain
+ *
+ *  Created: Fri Oct 16 22:10:31 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _LIBS_TF_FRAME_CHAIN_H_
+#define _LIBS_TF_FRAME_CHAIN_H_
+
+#include <tf/types.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace fawkes {
+namespace tf {
+
+class BufferCore;
+class TimeCacheInterface;
+
+class FrameChain
+{
+	friend BufferCore;
+
+public:
+	FrameChain();
+
+	bool valid() const;
+
+	const std::string &target_frame() const;
+	const std::string &source_frame() const;
+
+private:
+	/// @cond INTERNALS
+	typedef struct
+	{
+		TimeCacheInterface *cache;
+		CompactFrameID      parent;
+	} Edge;
+	/// @endcond
+
+	std::string    target_frame_;
+	std::string    source_frame_;
+	CompactFrameID target_id_;
+	CompactFrameID source_id_;
+
+	std::vector<Edge> source_edges_;
+	std::vector<Edge> target_edges_;
+	bool              edges_resolved_;
+	uint64_t          tree_version_;
+};
+
+} // end namespace tf
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,187 @@
+
+/***************************************************************************
+ *  qa_tf_batch_transform.cpp - QA for tf batch transforms and frame chains
+ *
+ *  Created: Sat Oct 17 01:02:18 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+// Do not include in api reference
+///@cond QA
+
+#include <tf/batch_transform.h>
+#include <tf/transformer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace fawkes;
+using namespace fawkes::tf;
+
+#define NUM_POINTS 10007
+#define EPSILON 1e-4
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static float
+rand_coord()
+{
+	return ((float)rand() / RAND_MAX - 0.5f) * 200.f;
+}
+
+static bool
+close_to(double a, double b)
+{
+	return std::fabs(a - b) <= EPSILON * std::max(1.0, std::fabs(b));
+}
+
+int
+main(int argc, char **argv)
+{
+	int failures = 0;
+	srand(4711);
+
+	Transform t(Quaternion(Vector3(0.3, -0.5, 0.8).normalized(), 1.234),
+	            Vector3(1.5, -2.25, 0.75));
+
+	// reference, each point transformed on its own in double precision
+	std::vector<Point> points(NUM_POINTS), ref(NUM_POINTS);
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		points[i].setValue(rand_coord(), rand_coord(), rand_coord());
+		ref[i] = t * points[i];
+	}
+
+	std::vector<Point> batch(NUM_POINTS);
+	transform_points(t, &points[0], &batch[0], NUM_POINTS);
+	bool ok = true;
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		ok = ok && close_to(batch[i].x(), ref[i].x()) && close_to(batch[i].y(), ref[i].y())
+		     && close_to(batch[i].z(), ref[i].z());
+	}
+	failures += check(ok, "Batch points equal single transforms");
+
+	// 16 byte aligned stride 4 data uses the SSE2 kernel where available,
+	// shifting by one float and a stride of 5 force the scalar kernel
+	float *aligned   = (float *)aligned_alloc(16, NUM_POINTS * 4 * sizeof(float));
+	float *unaligned = (float *)aligned_alloc(16, (NUM_POINTS + 1) * 4 * sizeof(float)) + 1;
+	std::vector<float> strided(NUM_POINTS * 5);
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		float xyzw[4] = {(float)points[i].x(), (float)points[i].y(), (float)points[i].z(), (float)i};
+		memcpy(&aligned[i * 4], xyzw, sizeof(xyzw));
+		memcpy(&unaligned[i * 4], xyzw, sizeof(xyzw));
+		memcpy(&strided[i * 5], xyzw, sizeof(xyzw));
+		strided[i * 5 + 4] = -(float)i;
+	}
+	transform_points(t, aligned, NUM_POINTS, 4);
+	transform_points(t, unaligned, NUM_POINTS, 4);
+	transform_points(t, &strided[0], NUM_POINTS, 5);
+
+	bool ok_ref = true, ok_equal = true, ok_kept = true;
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		for (unsigned int c = 0; c < 3; ++c) {
+			ok_ref   = ok_ref && close_to(aligned[i * 4 + c], ref[i][c]);
+			ok_equal = ok_equal && close_to(aligned[i * 4 + c], unaligned[i * 4 + c])
+			           && (unaligned[i * 4 + c] == strided[i * 5 + c]);
+		}
+		ok_kept = ok_kept && (aligned[i * 4 + 3] == (float)i) && (unaligned[i * 4 + 3] == (float)i)
+		          && (strided[i * 5 + 3] == (float)i) && (strided[i * 5 + 4] == -(float)i);
+	}
+	failures += check(ok_ref, "Float points equal single transforms");
+	failures += check(ok_equal, "Vectorized equals scalar kernel");
+	failures += check(ok_kept, "Data after coordinates preserved");
+	free(aligned);
+	free(unaligned - 1);
+
+	std::vector<Pose> poses(NUM_POINTS), batch_poses(NUM_POINTS);
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		poses[i] = Pose(Quaternion(Vector3(0, 0, 1), i * 0.01), points[i]);
+	}
+	transform_poses(t, &poses[0], &batch_poses[0], NUM_POINTS);
+	ok = true;
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		Pose p = t * poses[i];
+		ok     = ok && close_to(batch_poses[i].getOrigin().x(), p.getOrigin().x())
+		     && close_to(batch_poses[i].getRotation().w(), p.getRotation().w());
+	}
+	failures += check(ok, "Batch poses equal single transforms");
+
+	// lookups through a resolved chain equal lookups by frame name
+	fawkes::Time time;
+	Transformer  transformer;
+	transformer.set_transform(StampedTransform(t, time, "/world", "/base_link"), "qa");
+	transformer.set_transform(StampedTransform(Transform(Quaternion(0, 0, 0, 1),
+	                                                     Vector3(0.2, 0, 0.4)),
+	                                           time,
+	                                           "/base_link",
+	                                           "/laser"),
+	                          "qa");
+
+	StampedTransform by_name, by_chain;
+	transformer.lookup_transform("/world", "/laser", time, by_name);
+	FrameChain chain = transformer.resolve_frame_chain("/world", "/laser");
+	transformer.lookup_transform(chain, time, by_chain);
+	ok = chain.valid() && (by_chain.frame_id == by_name.frame_id)
+	     && (by_chain.child_frame_id == by_name.child_frame_id) && (by_chain.stamp == by_name.stamp)
+	     && (by_chain.getOrigin() == by_name.getOrigin())
+	     && (by_chain.getRotation() == by_name.getRotation());
+	failures += check(ok, "Frame chain lookup equals lookup by name");
+
+	std::vector<Point> chain_points(points);
+	transformer.transform_points(chain, time, chain_points);
+	ok = true;
+	for (unsigned int i = 0; i < NUM_POINTS; ++i) {
+		Point p = by_name * points[i];
+		ok      = ok && close_to(chain_points[i].x(), p.x()) && close_to(chain_points[i].z(), p.z());
+	}
+	failures += check(ok, "Frame chain point transform");
+
+	// a chain resolved before a parent change still yields the new transform
+	fawkes::Time later = time + 1.0;
+	transformer.set_transform(StampedTransform(Transform(Quaternion(0, 0, 0, 1),
+	                                                     Vector3(1.0, 2.0, 3.0)),
+	                                           later,
+	                                           "/world",
+	                                           "/laser"),
+	                          "qa");
+	transformer.lookup_transform("/world", "/laser", later, by_name);
+	transformer.lookup_transform(chain, later, by_chain);
+	ok = (by_chain.getOrigin() == by_name.getOrigin())
+	     && (by_chain.getOrigin() == Vector3(1.0, 2.0, 3.0));
+	failures += check(ok, "Frame chain lookup after parent change");
+
+	try {
+		FrameChain unresolved;
+		transformer.lookup_transform(unresolved, time, by_chain);
+		failures += check(false, "Unresolved chain rejected");
+	} catch (LookupException &e) {
+		failures += check(true, "Unresolved chain rejected");
+	}
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
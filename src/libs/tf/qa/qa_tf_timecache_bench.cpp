@@ -0,0 +1,160 @@
+
+/***************************************************************************
+ *  qa_tf_timecache_bench.cpp - Benchmark tf time cache implementations
+ *
+ *  Created: Fri Oct 16 21:48:20 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <tf/time_cache.h>
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace fawkes;
+using namespace fawkes::tf;
+
+#define CACHE_TIME_SEC 10.
+#define RATE_HZ 100
+#define NUM_LOOKUPS 200000
+#define NUM_INSERT_SECONDS 60
+
+static void
+print_result(const char *what, unsigned int ops, double sec)
+{
+	printf("%-28s %8u ops in %8.4f sec, %10.1f ns/op\n", what, ops, sec, sec * 1.e9 / ops);
+}
+
+static TransformStorage
+make_storage(const Time &stamp, unsigned int i)
+{
+	StampedTransform st(Transform(create_quaternion_from_yaw(0.001 * i), Vector3(0.01 * i, 0, 0)),
+	                    stamp,
+	                    "base_link",
+	                    "laser");
+	return TransformStorage(st, 1, 2);
+}
+
+static void
+run_benchmark(TimeCacheInterface *cache, std::vector<Time> &lookup_times)
+{
+	Time start, end;
+	Time stamp(1000, 0);
+
+	// Insert transforms for one minute at the given rate, the cache
+	// keeps the last 10 seconds
+	unsigned int num_inserts = NUM_INSERT_SECONDS * RATE_HZ;
+	start.stamp();
+	for (unsigned int i = 0; i < num_inserts; ++i) {
+		stamp += (long int)(1000000 / RATE_HZ);
+		cache->insert_data(make_storage(stamp, i));
+	}
+	end.stamp();
+	print_result("insert", num_inserts, end - &start);
+	printf("%-28s %8u\n", "cached transforms", cache->get_list_length());
+
+	// Random lookups within the cached time window, as done by pointcloud
+	// and laser data transforms with the stamp of the sensor data
+	TransformStorage out;
+	unsigned int     num_ok = 0;
+	start.stamp();
+	for (const Time &t : lookup_times) {
+		if (cache->get_data(t, out))
+			num_ok += 1;
+	}
+	end.stamp();
+	print_result("lookup (interpolated)", lookup_times.size(), end - &start);
+	if (num_ok != lookup_times.size()) {
+		printf("%u of %zu lookups failed\n", (unsigned int)(lookup_times.size() - num_ok),
+		       lookup_times.size());
+	}
+
+	// Lookups of the latest transform
+	start.stamp();
+	Time zero(0, 0);
+	for (unsigned int i = 0; i < NUM_LOOKUPS; ++i) {
+		cache->get_data(zero, out);
+	}
+	end.stamp();
+	print_result("lookup (latest)", NUM_LOOKUPS, end - &start);
+}
+
+static bool
+compare_caches(TimeCacheInterface *a, TimeCacheInterface *b, std::vector<Time> &lookup_times)
+{
+	if (a->get_list_length() != b->get_list_length()
+	    || a->get_oldest_timestamp() != b->get_oldest_timestamp()
+	    || a->get_latest_timestamp() != b->get_latest_timestamp()) {
+		return false;
+	}
+
+	TransformStorage out_a, out_b;
+	for (const Time &t : lookup_times) {
+		bool ok_a = a->get_data(t, out_a);
+		bool ok_b = b->get_data(t, out_b);
+		if (ok_a != ok_b)
+			return false;
+		if (ok_a
+		    && (out_a.stamp != out_b.stamp || out_a.translation.distance(out_b.translation) > 1e-9
+		        || std::fabs(out_a.rotation.x() - out_b.rotation.x()) > 1e-9
+		        || std::fabs(out_a.rotation.y() - out_b.rotation.y()) > 1e-9
+		        || std::fabs(out_a.rotation.z() - out_b.rotation.z()) > 1e-9
+		        || std::fabs(out_a.rotation.w() - out_b.rotation.w()) > 1e-9)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+int
+main(int argc, char **argv)
+{
+	// lookup times within the window cached at the end of the insertions
+	std::mt19937                     rng(0);
+	std::uniform_real_distribution<> dist(0.01, CACHE_TIME_SEC - 0.01);
+	std::vector<Time>                lookup_times(NUM_LOOKUPS);
+	Time                             latest(1000 + NUM_INSERT_SECONDS, 0);
+	for (Time &t : lookup_times) {
+		t = latest - dist(rng);
+	}
+
+	printf("TimeCache (linked list), %u Hz, %.0f sec cache time\n", RATE_HZ, CACHE_TIME_SEC);
+	printf("=========================================================================\n");
+	TimeCache *list_cache = new TimeCache(CACHE_TIME_SEC);
+	run_benchmark(list_cache, lookup_times);
+
+	printf("\nCircularTimeCache, %u Hz, %.0f sec cache time\n", RATE_HZ, CACHE_TIME_SEC);
+	printf("=========================================================================\n");
+	CircularTimeCache *circular_cache = new CircularTimeCache(CACHE_TIME_SEC);
+	run_benchmark(circular_cache, lookup_times);
+	printf("%-28s %8u\n", "capacity", circular_cache->capacity());
+
+	if (!compare_caches(list_cache, circular_cache, lookup_times)) {
+		printf("\nResults of time caches differ\n");
+		return 1;
+	}
+
+	delete list_cache;
+	delete circular_cache;
+	return 0;
+}
+
+/// @endcond
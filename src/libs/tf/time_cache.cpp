@@ -300,11 +300,17 @@ TimeCache::find_closest(TransformStorage *&one,
 	return 2;
 }
 
-void
-TimeCache::interpolate(const TransformStorage &one,
-                       const TransformStorage &two,
-                       fawkes::Time            time,
-                       TransformStorage &      output)
+/** Interpolate between two transforms.
+ * @param one older transform
+ * @param two newer transform
+ * @param time time to interpolate for
+ * @param output upon return contains the interpolated transform
+ */
+static inline void
+interpolate_storage(const TransformStorage &one,
+                    const TransformStorage &two,
+                    fawkes::Time            time,
+                    TransformStorage &      output)
 {
 	// Check for zero distance case
 	if (two.stamp == one.stamp) {
@@ -325,6 +331,15 @@ TimeCache::interpolate(const TransformStorage &one,
 	output.child_frame_id = one.child_frame_id;
 }
 
+void
+TimeCache::interpolate(const TransformStorage &one,
+                       const TransformStorage &two,
+                       fawkes::Time            time,
+                       TransformStorage &      output)
+{
+	interpolate_storage(one, two, time, output);
+}
+
 TimeCacheInterfacePtr
 TimeCache::clone(const fawkes::Time &look_back_until) const
 {
@@ -462,5 +477,290 @@ TimeCache::prune_list()
 	}
 }
 
+/** @class CircularTimeCache <tf/time_cache.h>
+ * Time based transform cache using a circular buffer.
+ * This cache provides the same semantics as TimeCache, but keeps the
+ * transforms in a contiguous ring buffer sorted by time instead of a
+ * linked list. Transforms are looked up by binary search and inserting a
+ * transform, which usually is the newest one, does not allocate memory.
+ * Only if the buffer is full the capacity is doubled, this happens just
+ * until the cache has reached the size required for the maximum storage
+ * time and the rate of the transform.
+ */
+
+/** Constructor.
+ * @param max_storage_time maximum time in seconds to cache
+ * @param initial_capacity number of transforms to preallocate storage for,
+ * rounded up to the next power of two
+ */
+CircularTimeCache::CircularTimeCache(float max_storage_time, unsigned int initial_capacity)
+: first_(0), size_(0), max_storage_time_(max_storage_time)
+{
+	// power of two capacity to wrap indices with a mask
+	unsigned int capacity = 1;
+	while (capacity < initial_capacity)
+		capacity <<= 1;
+	buffer_.resize(capacity);
+}
+
+/** Destructor. */
+CircularTimeCache::~CircularTimeCache()
+{
+}
+
+/** Get capacity.
+ * @return number of transforms that can be stored without allocation
+ */
+unsigned int
+CircularTimeCache::capacity() const
+{
+	return buffer_.size();
+}
+
+/** Find index of the first element newer than the given time.
+ * @param time time to compare to
+ * @return index of the first element with a stamp greater than time, or
+ * the number of elements if there is none
+ */
+unsigned int
+CircularTimeCache::upper_bound(const fawkes::Time &time) const
+{
+	unsigned int lo = 0, hi = size_;
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		if (at(mid).stamp <= time) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+/// A helper function for getData
+uint8_t
+CircularTimeCache::find_closest(TransformStorage *&one,
+                                TransformStorage *&two,
+                                fawkes::Time       target_time,
+                                std::string *      error_str)
+{
+	//No values stored
+	if (size_ == 0) {
+		if (error_str)
+			*error_str = "Transform cache storage is empty";
+		return 0;
+	}
+
+	TransformStorage &latest = at(size_ - 1);
+
+	//If time == 0 return the latest
+	if (target_time.is_zero()) {
+		one = &latest;
+		return 1;
+	}
+
+	// One value stored
+	if (size_ == 1) {
+		if (latest.stamp == target_time) {
+			one = &latest;
+			return 1;
+		} else {
+			create_extrapolation_exception1(target_time, latest.stamp, error_str);
+			return 0;
+		}
+	}
+
+	TransformStorage &earliest = at(0);
+
+	if (target_time == latest.stamp) {
+		one = &latest;
+		return 1;
+	} else if (target_time == earliest.stamp) {
+		one = &earliest;
+		return 1;
+	} else if (target_time > latest.stamp) {
+		create_extrapolation_exception2(target_time, latest.stamp, error_str);
+		return 0;
+	} else if (target_time < earliest.stamp) {
+		create_extrapolation_exception3(target_time, earliest.stamp, error_str);
+		return 0;
+	}
+
+	// earliest < target_time < latest, hence 1 <= i <= size_ - 1
+	unsigned int i = upper_bound(target_time);
+	one            = &at(i - 1); //Older
+	two            = &at(i);     //Newer
+	return 2;
+}
+
+TimeCacheInterfacePtr
+CircularTimeCache::clone(const fawkes::Time &look_back_until) const
+{
+	CircularTimeCache *copy = new CircularTimeCache(max_storage_time_, buffer_.size());
+	unsigned int       i    = look_back_until.is_zero() ? 0 : upper_bound(look_back_until);
+	for (; i < size_; ++i) {
+		copy->buffer_[copy->size_++] = at(i);
+	}
+	return std::shared_ptr<TimeCacheInterface>(copy);
+}
+
+bool
+CircularTimeCache::get_data(fawkes::Time time, TransformStorage &data_out, std::string *error_str)
+{
+	TransformStorage *p_temp_1 = NULL;
+	TransformStorage *p_temp_2 = NULL;
+
+	int num_nodes = find_closest(p_temp_1, p_temp_2, time, error_str);
+	if (num_nodes == 0) {
+		return false;
+	} else if (num_nodes == 1) {
+		data_out = *p_temp_1;
+	} else if (num_nodes == 2) {
+		if (p_temp_1->frame_id == p_temp_2->frame_id) {
+			interpolate_storage(*p_temp_1, *p_temp_2, time, data_out);
+		} else {
+			data_out = *p_temp_1;
+		}
+	}
+
+	return true;
+}
+
+CompactFrameID
+CircularTimeCache::get_parent(fawkes::Time time, std::string *error_str)
+{
+	TransformStorage *p_temp_1 = NULL;
+	TransformStorage *p_temp_2 = NULL;
+
+	int num_nodes = find_closest(p_temp_1, p_temp_2, time, error_str);
+	if (num_nodes == 0) {
+		return 0;
+	}
+
+	return p_temp_1->frame_id;
+}
+
+bool
+CircularTimeCache::insert_data(const TransformStorage &new_data)
+{
+	if (size_ > 0) {
+		if (at(size_ - 1).stamp > new_data.stamp + max_storage_time_) {
+			return false;
+		}
+	}
+
+	if (size_ == buffer_.size()) {
+		if (buffer_.size() < TimeCache::MAX_LENGTH_LINKED_LIST) {
+			grow();
+		} else {
+			// drop oldest
+			first_ = (first_ + 1) & (buffer_.size() - 1);
+			size_ -= 1;
+		}
+	}
+
+	if (size_ == 0 || at(size_ - 1).stamp <= new_data.stamp) {
+		// common case, new data is the latest
+		at(size_) = new_data;
+	} else {
+		// insert after all elements with the same or an older stamp
+		unsigned int pos = upper_bound(new_data.stamp);
+		for (unsigned int i = size_; i > pos; --i) {
+			at(i) = at(i - 1);
+		}
+		at(pos) = new_data;
+	}
+	size_ += 1;
+
+	prune();
+	return true;
+}
+
+/** Double buffer capacity. */
+void
+CircularTimeCache::grow()
+{
+	std::vector<TransformStorage> new_buffer(buffer_.size() * 2);
+	for (unsigned int i = 0; i < size_; ++i) {
+		new_buffer[i] = at(i);
+	}
+	buffer_.swap(new_buffer);
+	first_ = 0;
+}
+
+/** Prune buffer based on maximum cache lifetime. */
+void
+CircularTimeCache::prune()
+{
+	fawkes::Time latest_time = at(size_ - 1).stamp;
+
+	while (size_ > 0 && at(0).stamp + max_storage_time_ < latest_time) {
+		first_ = (first_ + 1) & (buffer_.size() - 1);
+		size_ -= 1;
+	}
+}
+
+void
+CircularTimeCache::clear_list()
+{
+	first_ = 0;
+	size_  = 0;
+}
+
+unsigned int
+CircularTimeCache::get_list_length() const
+{
+	return size_;
+}
+
+/** Get storage list.
+ * The list is created from the buffer on each call, newest transform first,
+ * and is valid until the next call. Prefer the lookup methods where possible.
+ * @return reference to list of storage elements
+ */
+const TimeCacheInterface::L_TransformStorage &
+CircularTimeCache::get_storage() const
+{
+	storage_list_ = get_storage_copy();
+	return storage_list_;
+}
+
+TimeCacheInterface::L_TransformStorage
+CircularTimeCache::get_storage_copy() const
+{
+	L_TransformStorage l;
+	for (unsigned int i = size_; i > 0; --i) {
+		l.push_back(at(i - 1));
+	}
+	return l;
+}
+
+P_TimeAndFrameID
+CircularTimeCache::get_latest_time_and_parent()
+{
+	if (size_ == 0) {
+		return std::make_pair(fawkes::Time(), 0);
+	}
+
+	const TransformStorage &ts = at(size_ - 1);
+	return std::make_pair(ts.stamp, ts.frame_id);
+}
+
+fawkes::Time
+CircularTimeCache::get_latest_timestamp() const
+{
+	if (size_ == 0)
+		return fawkes::Time(0, 0); //empty list case
+	return at(size_ - 1).stamp;
+}
+
+fawkes::Time
+CircularTimeCache::get_oldest_timestamp() const
+{
+	if (size_ == 0)
+		return fawkes::Time(0, 0); //empty list case
+	return at(0).stamp;
+}
+
 } // end namespace tf
 } // end namespace fawkes
@@ -58,6 +58,7 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace fawkes {
 namespace tf {
@@ -138,6 +139,73 @@ private:
 	void prune_list();
 };
 
+class CircularTimeCache : public TimeCacheInterface
+{
+public:
+	/// Initial number of transforms for which storage is preallocated.
+	/// The capacity is always a power of two.
+	static const unsigned int DEFAULT_INITIAL_CAPACITY = 256;
+
+	CircularTimeCache(float        max_storage_time = TimeCache::DEFAULT_MAX_STORAGE_TIME,
+	                  unsigned int initial_capacity = DEFAULT_INITIAL_CAPACITY);
+	virtual ~CircularTimeCache();
+
+	virtual TimeCacheInterfacePtr clone(const fawkes::Time &look_back_until = fawkes::Time(0,
+	                                                                                       0)) const;
+	virtual bool get_data(fawkes::Time time, TransformStorage &data_out, std::string *error_str = 0);
+	virtual bool insert_data(const TransformStorage &new_data);
+	virtual void clear_list();
+	virtual CompactFrameID   get_parent(fawkes::Time time, std::string *error_str);
+	virtual P_TimeAndFrameID get_latest_time_and_parent();
+
+	virtual const L_TransformStorage &get_storage() const;
+	virtual L_TransformStorage        get_storage_copy() const;
+
+	virtual unsigned int get_list_length() const;
+	virtual fawkes::Time get_latest_timestamp() const;
+	virtual fawkes::Time get_oldest_timestamp() const;
+
+	unsigned int capacity() const;
+
+private:
+	/** Get element by age.
+	 * @param i index, 0 is the oldest element
+	 * @return element
+	 */
+	inline TransformStorage &
+	at(unsigned int i)
+	{
+		return buffer_[(first_ + i) & (buffer_.size() - 1)];
+	}
+
+	/** Get element by age.
+	 * @param i index, 0 is the oldest element
+	 * @return element
+	 */
+	inline const TransformStorage &
+	at(unsigned int i) const
+	{
+		return buffer_[(first_ + i) & (buffer_.size() - 1)];
+	}
+
+	inline uint8_t find_closest(TransformStorage *&one,
+	                            TransformStorage *&two,
+	                            fawkes::Time       target_time,
+	                            std::string *      error_str);
+
+	unsigned int upper_bound(const fawkes::Time &time) const;
+	void         grow();
+	void         prune();
+
+	std::vector<TransformStorage> buffer_;
+	unsigned int                  first_;
+	unsigned int                  size_;
+
+	float max_storage_time_;
+
+	mutable L_TransformStorage storage_list_;
+};
+
 class StaticCache : public TimeCacheInterface
 {
 public:
@@ -51,6 +51,7 @@
 
 #include <core/macros.h>
 #include <core/threading/mutex_locker.h>
+#include <tf/batch_transform.h>
 #include <tf/exceptions.h>
 #include <tf/time_cache.h>
 #include <tf/transformer.h>
@@ -445,6 +446,95 @@ Transformer::transform_pose(const std::string &  target_frame,
 	stamped_out.frame_id = target_frame;
 }
 
+/** Resolve frame chain.
+ * Resolves the given frames once for repeated lookups and batch
+ * transformations with the returned chain.
+ * @param target_frame target frame ID
+ * @param source_frame source frame ID
+ * @return resolved frame chain
+ * @exception LookupException at least one of the two given frames is
+ * unknown
+ */
+FrameChain
+Transformer::resolve_frame_chain(const std::string &target_frame,
+                                 const std::string &source_frame) const
+{
+	if (!enabled_) {
+		throw DisabledException("Transformer has been disabled");
+	}
+
+	return BufferCore::resolve_frame_chain(strip_slash(target_frame), strip_slash(source_frame));
+}
+
+/** Lookup transform for a resolved frame chain.
+ * @param chain frame chain created by resolve_frame_chain()
+ * @param time time for which to get the transform, set to (0,0) to get latest
+ * common time frame
+ * @param transform upon return contains the transform
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException the chain has not been resolved
+ */
+void
+Transformer::lookup_transform(const FrameChain &  chain,
+                              const fawkes::Time &time,
+                              StampedTransform &  transform) const
+{
+	if (!enabled_) {
+		throw DisabledException("Transformer has been disabled");
+	}
+
+	BufferCore::lookup_transform(chain, time, transform);
+}
+
+/** Transform points in place.
+ * The transform for the given chain and time is looked up once and then
+ * applied to all points.
+ * @param chain resolved frame chain, the points are given in its source
+ * frame and are transformed into its target frame
+ * @param time time for which to transform the points
+ * @param points points to transform
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException the chain has not been resolved
+ */
+void
+Transformer::transform_points(const FrameChain &  chain,
+                              const fawkes::Time &time,
+                              std::vector<Point> &points) const
+{
+	StampedTransform transform;
+	lookup_transform(chain, time, transform);
+	tf::transform_points(transform, points.data(), points.data(), points.size());
+}
+
+/** Transform poses in place.
+ * The transform for the given chain and time is looked up once and then
+ * applied to all poses.
+ * @param chain resolved frame chain, the poses are given in its source
+ * frame and are transformed into its target frame
+ * @param time time for which to transform the poses
+ * @param poses poses to transform
+ * @exception ConnectivityException thrown if no connection between
+ * the source and target frame could be found in the tree.
+ * @exception ExtrapolationException returning a value would have
+ * required extrapolation beyond current limits.
+ * @exception LookupException the chain has not been resolved
+ */
+void
+Transformer::transform_poses(const FrameChain &  chain,
+                             const fawkes::Time &time,
+                             std::vector<Pose> & poses) const
+{
+	StampedTransform transform;
+	lookup_transform(chain, time, transform);
+	tf::transform_poses(transform, poses.data(), poses.data(), poses.size());
+}
+
 /** Transform ident pose from one frame to another.
  * This utility method can be used to transform the ident pose,
  * i.e. the origin of one frame, into another. Note that this method
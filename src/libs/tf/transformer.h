@@ -96,6 +96,13 @@ public:
 	                      const std::string &source_frame,
 	                      StampedTransform & transform) const;
 
+	FrameChain resolve_frame_chain(const std::string &target_frame,
+	                               const std::string &source_frame) const;
+
+	void lookup_transform(const FrameChain &  chain,
+	                      const fawkes::Time &time,
+	                      StampedTransform &  transform) const;
+
 	bool can_transform(const std::string & target_frame,
 	                   const std::string & source_frame,
 	                   const fawkes::Time &time,
@@ -121,6 +128,13 @@ public:
 	                    const Stamped<Pose> &stamped_in,
 	                    Stamped<Pose> &      stamped_out) const;
 
+	void transform_points(const FrameChain &  chain,
+	                      const fawkes::Time &time,
+	                      std::vector<Point> &points) const;
+	void transform_poses(const FrameChain &  chain,
+	                     const fawkes::Time &time,
+	                     std::vector<Pose> & poses) const;
+
 	bool transform_origin(const std::string &source_frame,
 	                      const std::string &target_frame,
 	                      Stamped<Pose> &    stamped_out,
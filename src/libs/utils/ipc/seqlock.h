@@ -0,0 +1,96 @@
+
+/***************************************************************************
+ *  seqlock.h - sequence lock for lock-free shared memory buffers
+ *
+ *  Created: Fri Oct 16 09:12:47 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_IPC_SEQLOCK_H_
+#define _UTILS_IPC_SEQLOCK_H_
+
+#include <cstdint>
+
+namespace fawkes {
+
+/** Sequence lock on a 64 bit counter.
+ * A sequence lock allows a single writer to update data which is read by
+ * any number of readers without ever blocking the writer. The counter is
+ * odd while the data is written and even when the data is consistent.
+ * Readers remember the counter before reading the data and verify
+ * afterwards that it did not change, otherwise they must discard what
+ * they have read.
+ *
+ * The counter may live in shared memory, in that case it must be aligned
+ * to 8 bytes. The operations are lock-free on all supported platforms.
+ * @author Tim Niemueller
+ */
+class SeqLock
+{
+public:
+	/** Start writing.
+   * @param seq sequence counter
+   * @param odd_value odd value to set the counter to, usually the
+   * current value plus one
+   */
+	static inline void
+	write_begin(uint64_t *seq, uint64_t odd_value)
+	{
+		__atomic_store_n(seq, odd_value, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+
+	/** Finish writing.
+   * @param seq sequence counter
+   * @param even_value even value to set the counter to, usually the value
+   * passed to write_begin() plus one
+   */
+	static inline void
+	write_end(uint64_t *seq, uint64_t even_value)
+	{
+		__atomic_store_n(seq, even_value, __ATOMIC_RELEASE);
+	}
+
+	/** Start reading.
+   * @param seq sequence counter
+   * @return counter value to pass to read_validate(), odd if data is
+   * currently being written
+   */
+	static inline uint64_t
+	read_begin(const uint64_t *seq)
+	{
+		return __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+	}
+
+	/** Check if data read is consistent.
+   * @param seq sequence counter
+   * @param begin_value value returned by read_begin()
+   * @return true if the data read since read_begin() is consistent, false
+   * if it has been modified in the meantime
+   */
+	static inline bool
+	read_validate(const uint64_t *seq, uint64_t begin_value)
+	{
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		return ((begin_value & 1) == 0) && (__atomic_load_n(seq, __ATOMIC_RELAXED) == begin_value);
+	}
+};
+
+} // end namespace fawkes
+
+#endif
@@ -0,0 +1,658 @@
+
+/***************************************************************************
+ *  shm_laser.cpp - shared memory laser scan buffer
+ *
+ *  Created: Fri Oct 16 09:48:22 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <core/exception.h>
+#include <utils/ipc/seqlock.h>
+#include <utils/ipc/shm_exceptions.h>
+#include <utils/ipc/shm_laser.h>
+#include <utils/misc/strndup.h>
+#include <utils/system/console_colors.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace fawkes {
+
+/// Alignment of the control block and slots in the segment, a cache line
+#define SHM_LASER_ALIGNMENT 64
+
+/** @class SharedMemoryLaserBuffer <utils/ipc/shm_laser.h>
+ * Shared memory laser scan buffer.
+ * The buffer transports laser scans of arbitrary size between threads and
+ * processes. Each scan carries its number of values, the angle of the
+ * first value and the angle between consecutive values, hence any sensor
+ * resolution and field of view can be represented.
+ *
+ * The segment contains a ring of a few scan slots. A single writer fills
+ * the next slot in place and then publishes it as the latest scan. Readers
+ * access the values directly in the segment without copying. Access is
+ * lock-free and guarded by a SeqLock per slot, the writer is never blocked
+ * by readers. A reader must check with is_valid() after processing a scan
+ * that the slot has not been overwritten in the meantime, which only
+ * happens if the reader takes longer than the given number of slots minus
+ * one times the scan period.
+ * @author Tim Niemueller
+ */
+
+/** Write Constructor.
+ * Create a new shared memory segment for the given laser. Use this
+ * constructor to open a laser buffer for writing.
+ * @param laser_id laser buffer ID
+ * @param max_num_values maximum number of values per scan
+ * @param num_slots number of scans in the ring buffer, must be at least two
+ */
+SharedMemoryLaserBuffer::SharedMemoryLaserBuffer(const char * laser_id,
+                                                 unsigned int max_num_values,
+                                                 unsigned int num_slots)
+: SharedMemory(FAWKES_SHM_LASER_MAGIC_TOKEN,
+               /* read-only */ false,
+               /* create */ true,
+               /* destroy on delete */ true)
+{
+	if (max_num_values == 0 || num_slots < 2) {
+		throw Exception("SharedMemoryLaserBuffer: need at least one value and two slots");
+	}
+	constructor(laser_id, max_num_values, num_slots, false);
+}
+
+/** Read Constructor.
+ * Search for an existing laser buffer. Throws an exception if no segment
+ * with the given ID exists. Use this constructor to open a laser buffer
+ * for reading.
+ * @param laser_id laser buffer ID
+ * @param is_read_only true to open the buffer read-only
+ */
+SharedMemoryLaserBuffer::SharedMemoryLaserBuffer(const char *laser_id, bool is_read_only)
+: SharedMemory(FAWKES_SHM_LASER_MAGIC_TOKEN,
+               is_read_only,
+               /* create */ false,
+               /* destroy */ false)
+{
+	constructor(laser_id, 0, 0, is_read_only);
+}
+
+void
+SharedMemoryLaserBuffer::constructor(const char * laser_id,
+                                     unsigned int max_num_values,
+                                     unsigned int num_slots,
+                                     bool         is_read_only)
+{
+	laser_id_     = strdup(laser_id);
+	_is_read_only = is_read_only;
+	writing_      = false;
+
+	priv_header_ = new SharedMemoryLaserBufferHeader(laser_id_, max_num_values, num_slots);
+	_header      = priv_header_;
+	try {
+		attach();
+	} catch (Exception &e) {
+		e.append("SharedMemoryLaserBuffer: could not attach to '%s'", laser_id);
+		::free(laser_id_);
+		laser_id_ = NULL;
+		delete priv_header_;
+		throw;
+	}
+
+	// segments are page-aligned, hence the offset is the same in all processes
+	char *base = (char *)(((uintptr_t)_memptr + SHM_LASER_ALIGNMENT - 1)
+	                      & ~(uintptr_t)(SHM_LASER_ALIGNMENT - 1));
+
+	max_num_values_ = priv_header_->max_num_values();
+	num_slots_      = priv_header_->num_slots();
+	slot_size_      = SharedMemoryLaserBufferHeader::slot_size(max_num_values_);
+	latest_         = (uint64_t *)base;
+	slots_          = base + SHM_LASER_ALIGNMENT;
+	write_seq_      = SeqLock::read_begin(latest_) + 1;
+}
+
+/** Destructor. */
+SharedMemoryLaserBuffer::~SharedMemoryLaserBuffer()
+{
+	::free(laser_id_);
+	delete priv_header_;
+}
+
+/** Get laser buffer ID.
+ * @return laser buffer ID
+ */
+const char *
+SharedMemoryLaserBuffer::laser_id() const
+{
+	return laser_id_;
+}
+
+/** Get maximum number of values per scan.
+ * @return maximum number of values per scan
+ */
+unsigned int
+SharedMemoryLaserBuffer::max_num_values() const
+{
+	return max_num_values_;
+}
+
+/** Get number of slots.
+ * @return number of scans in the ring buffer
+ */
+unsigned int
+SharedMemoryLaserBuffer::num_slots() const
+{
+	return num_slots_;
+}
+
+SharedMemoryLaserBuffer_slot_t *
+SharedMemoryLaserBuffer::slot(uint64_t seq) const
+{
+	return (SharedMemoryLaserBuffer_slot_t *)(slots_ + ((seq - 1) % num_slots_) * slot_size_);
+}
+
+/** Start writing a scan.
+ * The returned array belongs to the slot after the latest scan and may
+ * be filled in place. The scan becomes visible to readers with
+ * end_write(). Calling begin_write() again before end_write() returns
+ * the very same array.
+ * @return array of max_num_values() floats to write distances to
+ */
+float *
+SharedMemoryLaserBuffer::begin_write()
+{
+	if (_is_read_only) {
+		throw Exception("SharedMemoryLaserBuffer: cannot write to read-only buffer");
+	}
+	SharedMemoryLaserBuffer_slot_t *s = slot(write_seq_);
+	if (!writing_) {
+		SeqLock::write_begin(&s->seq, 2 * write_seq_ - 1);
+		writing_ = true;
+	}
+	return (float *)(s + 1);
+}
+
+/** Publish the scan written since begin_write().
+ * The values after the written ones up to max_num_values() are set to NaN.
+ * Readers set up for the maximum number of values can then process any
+ * scan in place.
+ * @param num_values number of values written, at most max_num_values()
+ * @param angle_min angle of the first value in rad
+ * @param angle_increment angle between consecutive values in rad
+ * @param frame_id coordinate frame ID of the sensor
+ * @param timestamp acquisition time of the scan
+ */
+void
+SharedMemoryLaserBuffer::end_write(unsigned int num_values,
+                                   float        angle_min,
+                                   float        angle_increment,
+                                   const char * frame_id,
+                                   const Time * timestamp)
+{
+	if (!writing_) {
+		throw Exception("SharedMemoryLaserBuffer: end_write() without begin_write()");
+	}
+	if (num_values > max_num_values_) {
+		throw Exception("SharedMemoryLaserBuffer: %u values exceed maximum of %u",
+		                num_values,
+		                max_num_values_);
+	}
+
+	SharedMemoryLaserBuffer_slot_t *s      = slot(write_seq_);
+	float *                         values = (float *)(s + 1);
+	std::fill(values + num_values, values + max_num_values_, std::numeric_limits<float>::quiet_NaN());
+
+	s->timestamp_sec   = timestamp->get_sec();
+	s->timestamp_usec  = timestamp->get_usec();
+	s->angle_min       = angle_min;
+	s->angle_increment = angle_increment;
+	s->num_values      = num_values;
+	strncpy(s->frame_id, frame_id, LASER_FRAME_ID_MAX_LENGTH - 1);
+	s->frame_id[LASER_FRAME_ID_MAX_LENGTH - 1] = 0;
+
+	SeqLock::write_end(&s->seq, 2 * write_seq_);
+	__atomic_store_n(latest_, write_seq_, __ATOMIC_RELEASE);
+	write_seq_ += 1;
+	writing_ = false;
+}
+
+/** Get sequence number of latest scan.
+ * Sequence numbers start at one and increase with every scan. This can
+ * be used to cheaply check for new data.
+ * @return sequence number of the latest scan, zero if none has been written
+ */
+uint64_t
+SharedMemoryLaserBuffer::latest_seq() const
+{
+	return SeqLock::read_begin(latest_);
+}
+
+/** Get latest scan.
+ * No data is copied, the values of the scan point into the segment.
+ * @param scan upon successful return contains the latest scan
+ * @return true if a scan has been retrieved, false if no scan has been
+ * written so far
+ */
+bool
+SharedMemoryLaserBuffer::read_latest(Scan &scan) const
+{
+	for (;;) {
+		uint64_t seq = SeqLock::read_begin(latest_);
+		if (seq == 0)
+			return false;
+
+		const SharedMemoryLaserBuffer_slot_t *s     = slot(seq);
+		uint64_t                              begin = SeqLock::read_begin(&s->seq);
+		if (begin != 2 * seq) {
+			// overtaken by the writer, retry with the then latest scan
+			continue;
+		}
+
+		scan.seq             = seq;
+		scan.values          = (const float *)(s + 1);
+		scan.num_values      = std::min(s->num_values, max_num_values_);
+		scan.angle_min       = s->angle_min;
+		scan.angle_increment = s->angle_increment;
+		scan.timestamp.set_time(s->timestamp_sec, s->timestamp_usec);
+		memcpy(scan.frame_id, s->frame_id, LASER_FRAME_ID_MAX_LENGTH);
+		scan.frame_id[LASER_FRAME_ID_MAX_LENGTH - 1] = 0;
+
+		if (SeqLock::read_validate(&s->seq, begin))
+			return true;
+	}
+}
+
+/** Check if scan is still valid.
+ * Call this after processing the values of a scan retrieved with
+ * read_latest(). If it returns false the writer has overwritten the
+ * slot in the meantime and the result must be discarded.
+ * @param scan scan to check
+ * @return true if the values of the scan have not been modified
+ */
+bool
+SharedMemoryLaserBuffer::is_valid(const Scan &scan) const
+{
+	return SeqLock::read_validate(&slot(scan.seq)->seq, 2 * scan.seq);
+}
+
+/** Clean up orphaned segments.
+ * @param use_lister true to print info about the erased segments
+ */
+void
+SharedMemoryLaserBuffer::cleanup(bool use_lister)
+{
+	SharedMemoryLaserBufferLister *lister = NULL;
+	SharedMemoryLaserBufferHeader *h      = new SharedMemoryLaserBufferHeader();
+
+	if (use_lister) {
+		lister = new SharedMemoryLaserBufferLister();
+	}
+
+	SharedMemory::erase_orphaned(FAWKES_SHM_LASER_MAGIC_TOKEN, h, lister);
+
+	delete lister;
+	delete h;
+}
+
+/** Check laser buffer availability.
+ * @param laser_id laser buffer ID to check
+ * @return true if shared memory segment with requested laser buffer exists
+ */
+bool
+SharedMemoryLaserBuffer::exists(const char *laser_id)
+{
+	SharedMemoryLaserBufferHeader *h = new SharedMemoryLaserBufferHeader(laser_id, 0, 0);
+
+	bool ex = SharedMemory::exists(FAWKES_SHM_LASER_MAGIC_TOKEN, h);
+
+	delete h;
+	return ex;
+}
+
+/** Erase a specific shared memory segment that contains a laser buffer.
+ * @param laser_id ID of laser buffer to wipe
+ */
+void
+SharedMemoryLaserBuffer::wipe(const char *laser_id)
+{
+	SharedMemoryLaserBufferHeader *h = new SharedMemoryLaserBufferHeader(laser_id, 0, 0);
+
+	SharedMemory::erase(FAWKES_SHM_LASER_MAGIC_TOKEN, h, NULL);
+
+	delete h;
+}
+
+/** @class SharedMemoryLaserBufferHeader <utils/ipc/shm_laser.h>
+ * Shared memory laser buffer header.
+ */
+
+/** Constructor. */
+SharedMemoryLaserBufferHeader::SharedMemoryLaserBufferHeader()
+{
+	laser_id_            = NULL;
+	max_num_values_      = 0;
+	num_slots_           = 0;
+	header_              = NULL;
+	orig_laser_id_       = NULL;
+	orig_max_num_values_ = 0;
+	orig_num_slots_      = 0;
+}
+
+/** Constructor.
+ * @param laser_id laser buffer ID
+ * @param max_num_values maximum number of values per scan
+ * @param num_slots number of scans in the ring buffer
+ */
+SharedMemoryLaserBufferHeader::SharedMemoryLaserBufferHeader(const char * laser_id,
+                                                             unsigned int max_num_values,
+                                                             unsigned int num_slots)
+{
+	laser_id_       = strdup(laser_id);
+	max_num_values_ = max_num_values;
+	num_slots_      = num_slots;
+	header_         = NULL;
+
+	orig_laser_id_       = NULL;
+	orig_max_num_values_ = 0;
+	orig_num_slots_      = 0;
+}
+
+/** Copy constructor.
+ * @param h shared memory laser buffer header to copy
+ */
+SharedMemoryLaserBufferHeader::SharedMemoryLaserBufferHeader(const SharedMemoryLaserBufferHeader *h)
+{
+	laser_id_       = h->laser_id_ ? strdup(h->laser_id_) : NULL;
+	max_num_values_ = h->max_num_values_;
+	num_slots_      = h->num_slots_;
+	header_         = h->header_;
+
+	orig_laser_id_       = NULL;
+	orig_max_num_values_ = 0;
+	orig_num_slots_      = 0;
+}
+
+/** Destructor. */
+SharedMemoryLaserBufferHeader::~SharedMemoryLaserBufferHeader()
+{
+	if (laser_id_ != NULL)
+		free(laser_id_);
+	if (orig_laser_id_ != NULL)
+		free(orig_laser_id_);
+}
+
+/** Get size of a slot.
+ * @param max_num_values maximum number of values per scan
+ * @return size in bytes of one slot including its meta data
+ */
+size_t
+SharedMemoryLaserBufferHeader::slot_size(unsigned int max_num_values)
+{
+	size_t s = sizeof(SharedMemoryLaserBuffer_slot_t) + max_num_values * sizeof(float);
+	return (s + SHM_LASER_ALIGNMENT - 1) & ~(size_t)(SHM_LASER_ALIGNMENT - 1);
+}
+
+size_t
+SharedMemoryLaserBufferHeader::size()
+{
+	return sizeof(SharedMemoryLaserBuffer_header_t);
+}
+
+SharedMemoryHeader *
+SharedMemoryLaserBufferHeader::clone() const
+{
+	return new SharedMemoryLaserBufferHeader(this);
+}
+
+size_t
+SharedMemoryLaserBufferHeader::data_size()
+{
+	unsigned int max_num_values = header_ ? header_->max_num_values : max_num_values_;
+	unsigned int num_slots      = header_ ? header_->num_slots : num_slots_;
+
+	// alignment slack, control block, and slots
+	return 2 * SHM_LASER_ALIGNMENT + num_slots * slot_size(max_num_values);
+}
+
+bool
+SharedMemoryLaserBufferHeader::matches(void *memptr)
+{
+	SharedMemoryLaserBuffer_header_t *h = (SharedMemoryLaserBuffer_header_t *)memptr;
+
+	if (laser_id_ == NULL) {
+		return true;
+
+	} else if (strncmp(h->laser_id, laser_id_, LASER_ID_MAX_LENGTH) == 0) {
+		if ((max_num_values_ == 0)
+		    || ((h->max_num_values == max_num_values_) && (h->num_slots == num_slots_))) {
+			return true;
+		} else {
+			throw Exception("Inconsistent laser buffer '%s' found in memory "
+			                "(%u values/%u slots, expected %u/%u)",
+			                laser_id_,
+			                h->max_num_values,
+			                h->num_slots,
+			                max_num_values_,
+			                num_slots_);
+		}
+	} else {
+		return false;
+	}
+}
+
+/** Check for equality of headers.
+ * @param s shared memory header to compare to
+ * @return true if the two instances identify the very same shared memory segments,
+ * false otherwise
+ */
+bool
+SharedMemoryLaserBufferHeader::operator==(const SharedMemoryHeader &s) const
+{
+	const SharedMemoryLaserBufferHeader *h = dynamic_cast<const SharedMemoryLaserBufferHeader *>(&s);
+	if (!h) {
+		return false;
+	} else {
+		return ((strncmp(laser_id_, h->laser_id_, LASER_ID_MAX_LENGTH) == 0)
+		        && (max_num_values_ == h->max_num_values_) && (num_slots_ == h->num_slots_));
+	}
+}
+
+/** Print some info. */
+void
+SharedMemoryLaserBufferHeader::print_info()
+{
+	if (laser_id_ == NULL) {
+		cout << "No laser buffer set" << endl;
+		return;
+	}
+	cout << "SharedMemory Laser Info: " << endl;
+	printf("    address:  %p\n", header_);
+	cout << "    laser id:   " << laser_id_ << endl
+	     << "    max values: " << max_num_values() << endl
+	     << "    slots:      " << num_slots() << endl;
+}
+
+/** Create if number of values and slots have been supplied.
+ * @return true if the number of values and slots are greater than zero.
+ */
+bool
+SharedMemoryLaserBufferHeader::create()
+{
+	return ((max_num_values_ > 0) && (num_slots_ > 0));
+}
+
+void
+SharedMemoryLaserBufferHeader::initialize(void *memptr)
+{
+	SharedMemoryLaserBuffer_header_t *header = (SharedMemoryLaserBuffer_header_t *)memptr;
+	memset(memptr, 0, sizeof(SharedMemoryLaserBuffer_header_t));
+
+	strncpy(header->laser_id, laser_id_, LASER_ID_MAX_LENGTH - 1);
+	header->max_num_values = max_num_values_;
+	header->num_slots      = num_slots_;
+
+	header_ = header;
+}
+
+void
+SharedMemoryLaserBufferHeader::set(void *memptr)
+{
+	SharedMemoryLaserBuffer_header_t *header = (SharedMemoryLaserBuffer_header_t *)memptr;
+	if (NULL != orig_laser_id_)
+		free(orig_laser_id_);
+	if (NULL != laser_id_) {
+		orig_laser_id_ = strdup(laser_id_);
+		free(laser_id_);
+	} else {
+		orig_laser_id_ = NULL;
+	}
+	orig_max_num_values_ = max_num_values_;
+	orig_num_slots_      = num_slots_;
+	header_              = header;
+
+	laser_id_       = strndup(header->laser_id, LASER_ID_MAX_LENGTH);
+	max_num_values_ = header->max_num_values;
+	num_slots_      = header->num_slots;
+}
+
+void
+SharedMemoryLaserBufferHeader::reset()
+{
+	if (NULL != laser_id_) {
+		free(laser_id_);
+		laser_id_ = NULL;
+	}
+	if (orig_laser_id_ != NULL) {
+		laser_id_ = strdup(orig_laser_id_);
+	}
+	max_num_values_ = orig_max_num_values_;
+	num_slots_      = orig_num_slots_;
+	header_         = NULL;
+}
+
+/** Get laser buffer ID.
+ * @return laser buffer ID
+ */
+const char *
+SharedMemoryLaserBufferHeader::laser_id() const
+{
+	return laser_id_;
+}
+
+/** Get maximum number of values per scan.
+ * @return maximum number of values per scan
+ */
+unsigned int
+SharedMemoryLaserBufferHeader::max_num_values() const
+{
+	if (header_)
+		return header_->max_num_values;
+	else
+		return max_num_values_;
+}
+
+/** Get number of slots.
+ * @return number of scans in the ring buffer
+ */
+unsigned int
+SharedMemoryLaserBufferHeader::num_slots() const
+{
+	if (header_)
+		return header_->num_slots;
+	else
+		return num_slots_;
+}
+
+/** @class SharedMemoryLaserBufferLister <utils/ipc/shm_laser.h>
+ * Shared memory laser buffer lister.
+ */
+
+/** Constructor. */
+SharedMemoryLaserBufferLister::SharedMemoryLaserBufferLister()
+{
+}
+
+/** Destructor. */
+SharedMemoryLaserBufferLister::~SharedMemoryLaserBufferLister()
+{
+}
+
+void
+SharedMemoryLaserBufferLister::print_header()
+{
+	cout << endl
+	     << cgreen << "Fawkes Shared Memory Segments - Laser Scans" << cnormal << endl
+	     << "========================================================================================"
+	     << endl
+	     << cdarkgray;
+	printf("%-32s %-10s %-10s %-9s %-10s %-5s %s\n",
+	       "Laser ID",
+	       "ShmID",
+	       "Semaphore",
+	       "Bytes",
+	       "Max Values",
+	       "Slots",
+	       "State");
+	cout << cnormal
+	     << "----------------------------------------------------------------------------------------"
+	     << endl;
+}
+
+void
+SharedMemoryLaserBufferLister::print_footer()
+{
+}
+
+void
+SharedMemoryLaserBufferLister::print_no_segments()
+{
+	cout << "No laser shared memory segments found" << endl;
+}
+
+void
+SharedMemoryLaserBufferLister::print_no_orphaned_segments()
+{
+	cout << "No orphaned laser shared memory segments found" << endl;
+}
+
+void
+SharedMemoryLaserBufferLister::print_info(const SharedMemoryHeader *header,
+                                          int                       shm_id,
+                                          int                       semaphore,
+                                          unsigned int              mem_size,
+                                          const void *              memptr)
+{
+	SharedMemoryLaserBufferHeader *h = (SharedMemoryLaserBufferHeader *)header;
+
+	printf("%-32s %-10d %-10d %-9u %-10u %-5u %s%s\n",
+	       h->laser_id(),
+	       shm_id,
+	       semaphore,
+	       mem_size,
+	       h->max_num_values(),
+	       h->num_slots(),
+	       (SharedMemory::is_swapable(shm_id) ? "S" : ""),
+	       (SharedMemory::is_destroyed(shm_id) ? "D" : ""));
+}
+
+} // end namespace fawkes
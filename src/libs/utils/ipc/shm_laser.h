@@ -0,0 +1,185 @@
+
+/***************************************************************************
+ *  shm_laser.h - shared memory laser scan buffer
+ *
+ *  Created: Fri Oct 16 09:31:05 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_IPC_SHM_LASER_H_
+#define _UTILS_IPC_SHM_LASER_H_
+
+#include <utils/ipc/shm.h>
+#include <utils/ipc/shm_lister.h>
+#include <utils/time/time.h>
+
+#include <cstdint>
+
+// Magic token to identify Fawkes shared memory laser buffers
+#define FAWKES_SHM_LASER_MAGIC_TOKEN "Fawkes Laser"
+
+/** Maximum length of laser buffer IDs. */
+#define LASER_ID_MAX_LENGTH 64
+/** Maximum length of laser frame IDs. */
+#define LASER_FRAME_ID_MAX_LENGTH 32
+
+namespace fawkes {
+
+/** Shared memory header struct for laser scan buffers. */
+typedef struct
+{
+	char         laser_id[LASER_ID_MAX_LENGTH]; /**< laser buffer ID */
+	unsigned int max_num_values;                /**< maximum number of values per scan */
+	unsigned int num_slots;                     /**< number of scans in the ring buffer */
+} SharedMemoryLaserBuffer_header_t;
+
+/** Meta data of a scan slot in a laser buffer.
+ * The distance values follow immediately after the meta data. */
+typedef struct
+{
+	uint64_t     seq;                                 /**< 2n if scan n is valid, 2n-1 during write */
+	int64_t      timestamp_sec;                       /**< acquisition time, seconds part */
+	int64_t      timestamp_usec;                      /**< acquisition time, microseconds part */
+	float        angle_min;                           /**< angle of the first value in rad */
+	float        angle_increment;                     /**< angle between values in rad */
+	unsigned int num_values;                          /**< number of valid values */
+	unsigned int reserved;                            /**< reserved for future use */
+	char         frame_id[LASER_FRAME_ID_MAX_LENGTH]; /**< coordinate frame ID */
+} SharedMemoryLaserBuffer_slot_t;
+
+class SharedMemoryLaserBufferHeader : public SharedMemoryHeader
+{
+public:
+	SharedMemoryLaserBufferHeader();
+	SharedMemoryLaserBufferHeader(const char * laser_id,
+	                              unsigned int max_num_values,
+	                              unsigned int num_slots);
+	SharedMemoryLaserBufferHeader(const SharedMemoryLaserBufferHeader *h);
+	virtual ~SharedMemoryLaserBufferHeader();
+
+	virtual SharedMemoryHeader *clone() const;
+	virtual bool                matches(void *memptr);
+	virtual size_t              size();
+	virtual void                print_info();
+	virtual bool                create();
+	virtual void                initialize(void *memptr);
+	virtual void                set(void *memptr);
+	virtual void                reset();
+	virtual size_t              data_size();
+	virtual bool                operator==(const SharedMemoryHeader &s) const;
+
+	const char * laser_id() const;
+	unsigned int max_num_values() const;
+	unsigned int num_slots() const;
+
+	static size_t slot_size(unsigned int max_num_values);
+
+private:
+	char *       laser_id_;
+	unsigned int max_num_values_;
+	unsigned int num_slots_;
+
+	char *       orig_laser_id_;
+	unsigned int orig_max_num_values_;
+	unsigned int orig_num_slots_;
+
+	SharedMemoryLaserBuffer_header_t *header_;
+};
+
+class SharedMemoryLaserBufferLister : public SharedMemoryLister
+{
+public:
+	SharedMemoryLaserBufferLister();
+	virtual ~SharedMemoryLaserBufferLister();
+
+	virtual void print_header();
+	virtual void print_footer();
+	virtual void print_no_segments();
+	virtual void print_no_orphaned_segments();
+	virtual void print_info(const SharedMemoryHeader *header,
+	                        int                       shm_id,
+	                        int                       semaphore,
+	                        unsigned int              mem_size,
+	                        const void *              memptr);
+};
+
+class SharedMemoryLaserBuffer : public SharedMemory
+{
+public:
+	/** Laser scan in the ring buffer.
+   * The values point directly into the shared memory segment. They are
+   * only guaranteed to be consistent as long as is_valid() returns true
+   * for the scan. */
+	class Scan
+	{
+	public:
+		uint64_t     seq;                                 ///< scan sequence number
+		const float *values;                              ///< distance values
+		unsigned int num_values;                          ///< number of distance values
+		float        angle_min;                           ///< angle of first value in rad
+		float        angle_increment;                     ///< angle between values in rad
+		char         frame_id[LASER_FRAME_ID_MAX_LENGTH]; ///< coordinate frame ID
+		Time         timestamp;                           ///< acquisition time
+	};
+
+	SharedMemoryLaserBuffer(const char * laser_id,
+	                        unsigned int max_num_values,
+	                        unsigned int num_slots);
+	SharedMemoryLaserBuffer(const char *laser_id, bool is_read_only = true);
+	~SharedMemoryLaserBuffer();
+
+	const char * laser_id() const;
+	unsigned int max_num_values() const;
+	unsigned int num_slots() const;
+
+	float *begin_write();
+	void   end_write(unsigned int num_values,
+	                 float        angle_min,
+	                 float        angle_increment,
+	                 const char * frame_id,
+	                 const Time * timestamp);
+
+	uint64_t latest_seq() const;
+	bool     read_latest(Scan &scan) const;
+	bool     is_valid(const Scan &scan) const;
+
+	static void cleanup(bool use_lister = true);
+	static bool exists(const char *laser_id);
+	static void wipe(const char *laser_id);
+
+private:
+	void                            constructor(const char * laser_id,
+	                                            unsigned int max_num_values,
+	                                            unsigned int num_slots,
+	                                            bool         is_read_only);
+	SharedMemoryLaserBuffer_slot_t *slot(uint64_t seq) const;
+
+	char *                         laser_id_;
+	SharedMemoryLaserBufferHeader *priv_header_;
+	uint64_t *                     latest_;
+	char *                         slots_;
+	size_t                         slot_size_;
+	unsigned int                   num_slots_;
+	unsigned int                   max_num_values_;
+	uint64_t                       write_seq_;
+	bool                           writing_;
+};
+
+} // end namespace fawkes
+
+#endif
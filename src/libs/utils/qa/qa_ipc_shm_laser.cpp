@@ -0,0 +1,137 @@
+
+/***************************************************************************
+ *  qa_ipc_shm_laser.cpp - QA for shared memory laser buffer
+ *
+ *  Created: Fri Oct 16 10:27:36 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+// Do not include in api reference
+///@cond QA
+
+#include <core/exception.h>
+#include <utils/ipc/shm_laser.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+using namespace fawkes;
+
+#define LASER_ID "QA Laser"
+#define MAX_NUM_VALUES 1440
+#define NUM_SCANS 200000
+
+int
+main(int argc, char **argv)
+{
+	SharedMemoryLaserBuffer::wipe(LASER_ID);
+
+	SharedMemoryLaserBuffer *w;
+	SharedMemoryLaserBuffer *r;
+	try {
+		w = new SharedMemoryLaserBuffer(LASER_ID, MAX_NUM_VALUES, 4);
+		r = new SharedMemoryLaserBuffer(LASER_ID);
+	} catch (Exception &e) {
+		e.print_trace();
+		return 1;
+	}
+
+	SharedMemoryLaserBuffer::Scan scan;
+	int                           failures = 0;
+
+	if (r->read_latest(scan)) {
+		printf("FAIL: got scan from empty buffer\n");
+		++failures;
+	}
+
+	// scans of different sizes and fields of view
+	const unsigned int sizes[] = {360, 541, 720, 1080, 1440};
+	Time               t;
+	for (unsigned int s : sizes) {
+		float *values = w->begin_write();
+		for (unsigned int i = 0; i < s; ++i) {
+			values[i] = i;
+		}
+		t.stamp();
+		w->end_write(s, -M_PI / 2., M_PI / (s - 1), "/base_laser", &t);
+
+		if (!r->read_latest(scan) || scan.num_values != s || scan.values[s - 1] != s - 1
+		    || scan.angle_increment != (float)(M_PI / (s - 1)) || scan.timestamp != t
+		    || !r->is_valid(scan)) {
+			printf("FAIL: scan with %u values not read correctly\n", s);
+			++failures;
+		}
+		// the remaining values up to the maximum are NaN
+		if (s < MAX_NUM_VALUES
+		    && !(std::isnan(scan.values[s]) && std::isnan(scan.values[MAX_NUM_VALUES - 1]))) {
+			printf("FAIL: scan with %u values not padded with NaN\n", s);
+			++failures;
+		}
+	}
+	printf("Variable size scans: %s\n", failures ? "FAILED" : "OK");
+
+	// concurrent writer, each scan consists of its sequence number only,
+	// a reader must never see a mixed scan which it considers valid
+	uint64_t          first_seq = w->latest_seq() + 1;
+	std::atomic<bool> done(false);
+	std::thread       writer([&]() {
+    for (unsigned int n = 1; n <= NUM_SCANS; ++n) {
+      float *values = w->begin_write();
+      for (unsigned int i = 0; i < MAX_NUM_VALUES; ++i) {
+        values[i] = n;
+      }
+      w->end_write(MAX_NUM_VALUES, 0., 2 * M_PI / MAX_NUM_VALUES, "/base_laser", &t);
+    }
+    done = true;
+  });
+
+	unsigned int num_read = 0, num_invalid = 0, num_torn = 0;
+	while (!done) {
+		if (!r->read_latest(scan) || scan.seq < first_seq)
+			continue;
+		float first = scan.values[0];
+		bool  mixed = false;
+		for (unsigned int i = 1; i < scan.num_values; ++i) {
+			mixed |= (scan.values[i] != first);
+		}
+		if (!r->is_valid(scan)) {
+			++num_invalid;
+		} else if (mixed) {
+			++num_torn;
+		} else {
+			++num_read;
+		}
+	}
+	writer.join();
+
+	printf("Concurrent access: %u scans read, %u overwritten while reading, %u torn: %s\n",
+	       num_read,
+	       num_invalid,
+	       num_torn,
+	       num_torn ? "FAILED" : "OK");
+	failures += num_torn;
+
+	delete r;
+	delete w;
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
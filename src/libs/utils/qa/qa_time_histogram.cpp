@@ -0,0 +1,178 @@
+
+/***************************************************************************
+ *  qa_time_histogram.cpp - QA for time histogram and tracker
+ *
+ *  Created: Fri Oct 16 16:24:51 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+/// @cond QA
+
+#include <core/exception.h>
+#include <utils/time/histogram.h>
+#include <utils/time/tracker.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_THREADS 4
+#define NUM_RECORDS 100000
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static bool
+close_to(double value, double expected)
+{
+	// buckets keep 7 significant bits, relative error is below 2^-6
+	return std::fabs(value - expected) <= expected / 64.;
+}
+
+int
+main(int argc, char **argv)
+{
+	int failures = 0;
+
+	// uniformly distributed values from 1 us to 100 ms
+	TimeHistogram h;
+	for (uint64_t v = 1; v <= NUM_RECORDS; ++v) {
+		h.record(v * 1000);
+	}
+	failures += check(h.count() == NUM_RECORDS && h.min() == 1000 && h.max() == NUM_RECORDS * 1000,
+	                  "Count, minimum, and maximum");
+	failures += check(close_to(h.mean(), (NUM_RECORDS + 1) * 500.), "Mean");
+	failures += check(close_to(h.deviation(), NUM_RECORDS * 250.), "Deviation");
+	failures += check(close_to(h.percentile(0.5), NUM_RECORDS * 500.)
+	                    && close_to(h.percentile(0.99), NUM_RECORDS * 990.)
+	                    && close_to(h.percentile(0.999), NUM_RECORDS * 999.),
+	                  "Percentiles");
+	failures += check(h.percentile(1.0) == h.max() && h.percentile(0.0) == h.min(),
+	                  "Percentiles clamped to minimum and maximum");
+
+	// small values are exact
+	TimeHistogram small;
+	for (uint64_t v = 0; v < 64; ++v) {
+		small.record(v);
+	}
+	failures += check(small.percentile(0.5) == 31 && small.sum() == 63 * 32, "Small values");
+
+	// merge
+	TimeHistogram other;
+	other.record(1);
+	other.record(1ull << 45);
+	h.merge(other);
+	failures += check(h.count() == NUM_RECORDS + 2 && h.min() == 1 && h.max() == (1ull << 45),
+	                  "Merge");
+	h.reset();
+	failures += check(h.count() == 0 && h.percentile(0.5) == 0 && h.mean() == 0., "Reset");
+
+	// concurrent recording, values must not get lost
+	std::vector<std::thread> threads;
+	for (unsigned int t = 0; t < NUM_THREADS; ++t) {
+		threads.push_back(std::thread([&h, t]() {
+			for (uint64_t v = 1; v <= NUM_RECORDS; ++v) {
+				h.record(v + t);
+			}
+		}));
+	}
+	for (std::thread &t : threads) {
+		t.join();
+	}
+	failures += check(h.count() == NUM_THREADS * NUM_RECORDS && h.min() == 1
+	                    && h.max() == NUM_RECORDS + NUM_THREADS - 1,
+	                  "Concurrent recording");
+
+	// tracker
+	TimeTracker  tt, tt2;
+	unsigned int ttc_a = tt.add_class("A");
+	unsigned int ttc_b = tt2.add_class("B");
+	for (unsigned int i = 0; i < 10; ++i) {
+		tt.ping_start(ttc_a);
+		tt.ping_end(ttc_a);
+		tt2.ping_start(ttc_b);
+		tt2.ping_abort(ttc_b);
+		tt2.ping_end(ttc_b);
+	}
+	tt.merge(tt2);
+	tt.merge(tt);
+	failures += check(tt.num_classes() == 2 && tt.class_name(1) == "B"
+	                    && tt.histogram(ttc_a).count() == 20 && tt.histogram(1).count() == 0,
+	                  "Tracker classes");
+	tt.print_to_stdout();
+
+	// classless pings are limited, this must not grow indefinitely
+	for (unsigned int i = 0; i < 2 * TimeTracker::MAX_CLASSLESS_PINGS; ++i) {
+		tt.ping("classless");
+	}
+	tt.reset();
+	failures += check(tt.histogram(ttc_a).count() == 0, "Tracker reset");
+
+	// classes are added and removed while another thread reads and merges
+	TimeTracker       owner;
+	std::atomic<bool> done(false);
+	std::thread       adder([&owner, &done]() {
+		for (unsigned int i = 0; i + 1 < TimeTracker::MAX_CLASSES; ++i) {
+			char name[16];
+			snprintf(name, sizeof(name), "C%u", i);
+			unsigned int cls = owner.add_class(name);
+			owner.ping_start(cls);
+			owner.ping_end(cls);
+			if (i % 3 == 0)
+				owner.remove_class(cls);
+		}
+		done = true;
+	});
+	bool reads_ok = true;
+	while (!done) {
+		TimeTracker  merged;
+		unsigned int num = owner.num_classes();
+		for (unsigned int cls = 0; cls < num; ++cls) {
+			const std::string &name = owner.class_name(cls);
+			reads_ok = reads_ok && (name.empty() || name[0] == 'C') && owner.histogram(cls).count() <= 1;
+		}
+		merged.merge(owner);
+		reads_ok = reads_ok && merged.num_classes() <= owner.num_classes();
+	}
+	adder.join();
+	TimeTracker merged;
+	merged.merge(owner);
+	failures += check(reads_ok && merged.num_classes() == (TimeTracker::MAX_CLASSES - 1) * 2 / 3,
+	                  "Concurrent class changes");
+
+	bool too_many = false;
+	owner.add_class("Last");
+	try {
+		owner.add_class("Too many");
+	} catch (Exception &e) {
+		too_many = true;
+	}
+	failures += check(too_many, "Class limit");
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
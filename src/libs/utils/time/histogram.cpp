@@ -0,0 +1,236 @@
+
+/***************************************************************************
+ *  histogram.cpp - Lock-free histogram of durations
+ *
+ *  Created: Fri Oct 16 16:05:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#include <utils/time/histogram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fawkes {
+
+/** @class TimeHistogram <utils/time/histogram.h>
+ * Lock-free histogram of durations.
+ * Durations are recorded in nanoseconds into a fixed number of buckets,
+ * linear for small values and logarithmic with linear sub-buckets for
+ * larger ones. The relative error of percentiles is below one percent,
+ * independent of the number of recorded values, and the memory is fixed.
+ *
+ * Values are recorded with atomic operations only. Therefore other threads
+ * may read or merge the histogram while it is being recorded to, for
+ * example to export it, without blocking the measured thread. The result
+ * of such a read may be off by the values recorded concurrently.
+ * @author Tim Niemueller
+ */
+
+/** Constructor. */
+TimeHistogram::TimeHistogram()
+{
+	reset();
+}
+
+/** Reset histogram.
+ * Must not be called concurrently with record().
+ */
+void
+TimeHistogram::reset()
+{
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		buckets_[i].store(0, std::memory_order_relaxed);
+	}
+	count_.store(0, std::memory_order_relaxed);
+	sum_.store(0, std::memory_order_relaxed);
+	min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+	max_.store(0, std::memory_order_relaxed);
+}
+
+unsigned int
+TimeHistogram::bucket(uint64_t nsec)
+{
+	const uint64_t linear = 1ull << SUB_BUCKET_BITS;
+	if (nsec < linear)
+		return nsec;
+	if (nsec >= (1ull << MAX_VALUE_BITS))
+		return NUM_BUCKETS - 1;
+
+	unsigned int msb   = 63 - __builtin_clzll(nsec);
+	unsigned int shift = msb - SUB_BUCKET_BITS + 1;
+	return shift * (1u << (SUB_BUCKET_BITS - 1)) + (nsec >> shift);
+}
+
+uint64_t
+TimeHistogram::bucket_value(unsigned int bucket)
+{
+	const unsigned int linear = 1u << SUB_BUCKET_BITS;
+	if (bucket < linear)
+		return bucket;
+
+	unsigned int shift = bucket / (1u << (SUB_BUCKET_BITS - 1)) - 1;
+	uint64_t     sub   = bucket - shift * (1u << (SUB_BUCKET_BITS - 1));
+	// middle of the bucket
+	return (sub << shift) + ((1ull << shift) >> 1);
+}
+
+/** Record a duration.
+ * @param nsec duration in nanoseconds
+ */
+void
+TimeHistogram::record(uint64_t nsec)
+{
+	buckets_[bucket(nsec)].fetch_add(1, std::memory_order_relaxed);
+	count_.fetch_add(1, std::memory_order_relaxed);
+	sum_.fetch_add(nsec, std::memory_order_relaxed);
+
+	uint64_t v = min_.load(std::memory_order_relaxed);
+	while (nsec < v && !min_.compare_exchange_weak(v, nsec, std::memory_order_relaxed)) {
+	}
+	v = max_.load(std::memory_order_relaxed);
+	while (nsec > v && !max_.compare_exchange_weak(v, nsec, std::memory_order_relaxed)) {
+	}
+}
+
+/** Merge another histogram.
+ * Adds all values recorded in the other histogram to this one, for example
+ * to combine the histograms of several threads.
+ * @param other histogram to merge
+ */
+void
+TimeHistogram::merge(const TimeHistogram &other)
+{
+	if (other.count() == 0)
+		return;
+
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		uint64_t c = other.buckets_[i].load(std::memory_order_relaxed);
+		if (c > 0)
+			buckets_[i].fetch_add(c, std::memory_order_relaxed);
+	}
+	count_.fetch_add(other.count(), std::memory_order_relaxed);
+	sum_.fetch_add(other.sum(), std::memory_order_relaxed);
+
+	uint64_t o = other.min_.load(std::memory_order_relaxed);
+	uint64_t v = min_.load(std::memory_order_relaxed);
+	while (o < v && !min_.compare_exchange_weak(v, o, std::memory_order_relaxed)) {
+	}
+	o = other.max();
+	v = max_.load(std::memory_order_relaxed);
+	while (o > v && !max_.compare_exchange_weak(v, o, std::memory_order_relaxed)) {
+	}
+}
+
+/** Get number of recorded values.
+ * @return number of recorded values
+ */
+uint64_t
+TimeHistogram::count() const
+{
+	return count_.load(std::memory_order_relaxed);
+}
+
+/** Get sum of recorded values.
+ * @return sum of all recorded durations in nanoseconds
+ */
+uint64_t
+TimeHistogram::sum() const
+{
+	return sum_.load(std::memory_order_relaxed);
+}
+
+/** Get minimum.
+ * @return shortest recorded duration in nanoseconds, 0 if none recorded
+ */
+uint64_t
+TimeHistogram::min() const
+{
+	return count() > 0 ? min_.load(std::memory_order_relaxed) : 0;
+}
+
+/** Get maximum.
+ * @return longest recorded duration in nanoseconds
+ */
+uint64_t
+TimeHistogram::max() const
+{
+	return max_.load(std::memory_order_relaxed);
+}
+
+/** Get mean.
+ * @return average duration in nanoseconds, 0 if none recorded
+ */
+double
+TimeHistogram::mean() const
+{
+	uint64_t c = count();
+	return c > 0 ? (double)sum() / c : 0.;
+}
+
+/** Get mean absolute deviation.
+ * This is computed from the buckets and hence approximate.
+ * @return mean absolute deviation from the mean in nanoseconds
+ */
+double
+TimeHistogram::deviation() const
+{
+	uint64_t c = count();
+	if (c == 0)
+		return 0.;
+
+	double avg = mean();
+	double dev = 0.;
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+		if (n > 0)
+			dev += n * std::fabs((double)bucket_value(i) - avg);
+	}
+	return dev / c;
+}
+
+/** Get percentile.
+ * @param p percentile in the range [0, 1], e.g. 0.99 for the 99th percentile
+ * @return duration in nanoseconds which p of all recorded durations do not
+ * exceed, 0 if none recorded
+ */
+uint64_t
+TimeHistogram::percentile(double p) const
+{
+	uint64_t c = count();
+	if (c == 0)
+		return 0;
+
+	uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(std::min(1., std::max(0., p)) * c));
+	if (rank == 1)
+		return min();
+	if (rank >= c)
+		return max();
+
+	uint64_t seen = 0;
+	for (unsigned int i = 0; i < NUM_BUCKETS; ++i) {
+		seen += buckets_[i].load(std::memory_order_relaxed);
+		if (seen >= rank) {
+			return std::min(std::max(bucket_value(i), min()), max());
+		}
+	}
+	return max();
+}
+
+} // end namespace fawkes
@@ -0,0 +1,74 @@
+
+/***************************************************************************
+ *  histogram.h - Lock-free histogram of durations
+ *
+ *  Created: Fri Oct 16 16:05:12 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version. A runtime exception applies to
+ *  this software (see LICENSE.GPL_WRE file mentioned below for details).
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL_WRE file in the doc directory.
+ */
+
+#ifndef _UTILS_TIME_HISTOGRAM_H_
+#define _UTILS_TIME_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace fawkes {
+
+class TimeHistogram
+{
+public:
+	/** Number of bits of a value kept exactly, relative error is 2^-(bits-1). */
+	static const unsigned int SUB_BUCKET_BITS = 7;
+	/** Values of at least 2^MAX_VALUE_BITS nanoseconds share the last bucket. */
+	static const unsigned int MAX_VALUE_BITS = 40;
+	/** Number of buckets. */
+	static const unsigned int NUM_BUCKETS =
+	  (MAX_VALUE_BITS - SUB_BUCKET_BITS) * (1u << (SUB_BUCKET_BITS - 1)) + (1u << SUB_BUCKET_BITS);
+
+	TimeHistogram();
+
+	void record(uint64_t nsec);
+	void merge(const TimeHistogram &other);
+	void reset();
+
+	uint64_t count() const;
+	uint64_t sum() const;
+	uint64_t min() const;
+	uint64_t max() const;
+	double   mean() const;
+	double   deviation() const;
+	uint64_t percentile(double p) const;
+
+private:
+	TimeHistogram(const TimeHistogram &) = delete;
+	TimeHistogram &operator=(const TimeHistogram &) = delete;
+
+	static unsigned int bucket(uint64_t nsec);
+	static uint64_t     bucket_value(unsigned int bucket);
+
+private:
+	std::atomic<uint64_t> buckets_[NUM_BUCKETS];
+	std::atomic<uint64_t> count_;
+	std::atomic<uint64_t> sum_;
+	std::atomic<uint64_t> min_;
+	std::atomic<uint64_t> max_;
+};
+
+} // end namespace fawkes
+
+#endif
@@ -26,7 +26,6 @@
 #include <utils/time/tracker.h>
 
 #include <cerrno>
-#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <iostream>
@@ -40,8 +39,9 @@ namespace fawkes {
  * This class provides means to track time of different tasks in a process.
  * You can assign an arbitrary number of tracking classes per object (although
  * using a few classes is recommended for minimal influence of the measurement
- * on the measured process). You can then print out averages and (max) deviation
- * to get a feeling for the average performance and how flaky the runtimes are.
+ * on the measured process). You can then print out averages, (max) deviation
+ * and percentiles to get a feeling for the average performance and how flaky
+ * the runtimes are.
  *
  * The time tracker can also be operated without any class if you only want to
  * track a single process.
@@ -53,23 +53,46 @@ namespace fawkes {
  * a specific point in time and then stop it after the sub-task is done to measure
  * only this very task. This can be done by using pingStart() and pingEnd().
  *
+ * Class times are measured with nanosecond resolution and recorded into a
+ * TimeHistogram per class, hence the memory does not grow with the number of
+ * measurements and the tracker can stay enabled indefinitely. Only the last
+ * MAX_CLASSLESS_PINGS classless pings are kept. A tracker is meant to be used
+ * by a single thread, but other threads may read the classes and histograms
+ * at any time, for example to export them as metrics. Therefore, the storage
+ * for up to MAX_CLASSES classes is allocated once and classes are never
+ * moved or deleted while the tracker exists, a class added by the owner
+ * becomes visible to readers once it is complete. Trackers of several
+ * threads can be combined with merge().
+ *
  * @author Tim Niemueller
  */
 
 /** The default tracking class. Optionally added in the constructor. */
 const unsigned int TimeTracker::DEFAULT_CLASS = 0;
 
+/** Maximum number of classes, including removed ones. */
+const unsigned int TimeTracker::MAX_CLASSES = 256;
+
+/** Maximum number of classless pings kept for printing. */
+const unsigned int TimeTracker::MAX_CLASSLESS_PINGS = 1000;
+
+static inline uint64_t
+nsec_since(const timespec &start, const timespec &end)
+{
+	int64_t nsec = (int64_t)(end.tv_sec - start.tv_sec) * 1000000000ll + (end.tv_nsec - start.tv_nsec);
+	return nsec > 0 ? nsec : 0;
+}
+
 /** Constructor.
  * @param add_default_class if true a default time class is added.
  */
-TimeTracker::TimeTracker(bool add_default_class)
+TimeTracker::TimeTracker(bool add_default_class) : classes_(MAX_CLASSES), num_classes_(0)
 {
 	timelog_     = NULL;
 	write_cycle_ = 0;
 	reset();
 	if (add_default_class) {
-		class_times_.push_back(vector<struct timeval *>());
-		class_names_.push_back("Default");
+		add_class("Default");
 	}
 }
 
@@ -78,12 +101,12 @@ TimeTracker::TimeTracker(bool add_default_class)
  * @param add_default_class if true a default time class is added.
  */
 TimeTracker::TimeTracker(const char *filename, bool add_default_class)
+: classes_(MAX_CLASSES), num_classes_(0)
 {
 	write_cycle_ = 0;
 	reset();
 	if (add_default_class) {
-		class_times_.push_back(vector<struct timeval *>());
-		class_names_.push_back("Default");
+		add_class("Default");
 	}
 	timelog_ = fopen(filename, "w");
 	if (!timelog_) {
@@ -97,9 +120,6 @@ TimeTracker::~TimeTracker()
 	if (timelog_) {
 		fclose(timelog_);
 	}
-	reset();
-	class_times_.clear();
-	class_names_.clear();
 }
 
 /** Reset times.
@@ -110,17 +130,14 @@ void
 TimeTracker::reset(std::string comment)
 {
 	tracker_comment_ = comment;
-	for (vector<vector<struct timeval *>>::iterator i = class_times_.begin(); i != class_times_.end();
-	     ++i) {
-		for (vector<struct timeval *>::iterator j = i->begin(); j != i->end(); ++j) {
-			free(*j);
-		}
-		i->clear();
+	for (unsigned int i = 0; i < num_classes_; ++i) {
+		classes_[i]->histogram.reset();
+		classes_[i]->started = false;
 	}
-	times_.clear();
-	comments_.clear();
-	gettimeofday(&start_time, NULL);
-	gettimeofday(&last_time, NULL);
+	pings_.clear();
+	num_dropped_pings_ = 0;
+	clock_gettime(CLOCK_REALTIME, &start_time_);
+	clock_gettime(CLOCK_MONOTONIC, &last_time_);
 }
 
 /** Ping classless.
@@ -131,19 +148,23 @@ TimeTracker::reset(std::string comment)
 void
 TimeTracker::ping(std::string comment)
 {
-	timeval *t = (timeval *)malloc(sizeof(timeval));
-	gettimeofday(t, NULL);
-	times_.push_back(t);
-	if (!comment.empty()) {
-		comments_[times_.size() - 1] = comment;
+	ClasslessPing p;
+	clock_gettime(CLOCK_REALTIME, &p.time);
+	p.comment = comment;
+	pings_.push_back(p);
+	if (pings_.size() > MAX_CLASSLESS_PINGS) {
+		pings_.pop_front();
+		num_dropped_pings_ += 1;
 	}
 }
 
 /** Add a new class.
- * Adds a new class and gives the class ID.
+ * Adds a new class and gives the class ID. Only the thread using the tracker
+ * may add classes, readers see the class once it has been added.
  * @param name name of the class
  * @return new class ID which is used for pinging this specific
  * class.
+ * @exception Exception thrown if MAX_CLASSES classes have been added already
  */
 unsigned int
 TimeTracker::add_class(std::string name)
@@ -151,27 +172,34 @@ TimeTracker::add_class(std::string name)
 	if (name == "") {
 		throw Exception("TimeTracker::add_class(): Class name may not be empty");
 	}
-	class_times_.push_back(vector<struct timeval *>());
-	class_names_.push_back(name);
-	return class_times_.size() - 1;
+	unsigned int cls = num_classes_.load(std::memory_order_relaxed);
+	if (cls >= MAX_CLASSES) {
+		throw Exception("TimeTracker::add_class(): Cannot add more than %u classes", MAX_CLASSES);
+	}
+	TimeClass *c = new TimeClass();
+	c->name      = name;
+	c->removed   = false;
+	c->started   = false;
+	classes_[cls].reset(c);
+	num_classes_.store(cls + 1, std::memory_order_release);
+	return cls;
 }
 
 /** Remove a class.
  * This marks the class as unused. It is not longer possible to add times to this
- * class but they will not be printed anymore. The space associated with this
- * class is freed.
+ * class but they will not be printed anymore.
  * @param cls ID of the class to remove
  */
 void
 TimeTracker::remove_class(unsigned int cls)
 {
-	if (cls < class_names_.size()) {
-		class_names_[cls] = "";
+	if (cls < num_classes_) {
+		classes_[cls]->removed = true;
 	} else {
-		if (class_times_.size() == 0) {
+		if (num_classes_ == 0) {
 			throw Exception("No classes have been added, cannot delete class %u", cls);
 		} else {
-			throw OutOfBoundsException("Invalid class given", cls, 0, class_times_.size() - 1);
+			throw OutOfBoundsException("Invalid class given", cls, 0, num_classes_ - 1);
 		}
 	}
 }
@@ -184,30 +212,18 @@ TimeTracker::remove_class(unsigned int cls)
 void
 TimeTracker::ping(unsigned int cls)
 {
-	timeval *t = (timeval *)malloc(sizeof(timeval));
-	gettimeofday(t, NULL);
-
-	long sec  = t->tv_sec - last_time.tv_sec;
-	long usec = t->tv_usec - last_time.tv_usec;
-	if (usec < 0) {
-		sec -= 1;
-		usec += 1000000;
-	}
-	last_time.tv_sec  = t->tv_sec;
-	last_time.tv_usec = t->tv_usec;
-
-	t->tv_sec  = sec;
-	t->tv_usec = usec;
-
-	if (cls < class_times_.size()) {
-		class_times_[cls].push_back(t);
-	} else {
-		if (class_times_.size() == 0) {
+	if (cls >= num_classes_) {
+		if (num_classes_ == 0) {
 			throw Exception("No classes have been added, cannot track times");
 		} else {
-			throw OutOfBoundsException("Invalid class given", cls, 0, class_times_.size() - 1);
+			throw OutOfBoundsException("Invalid class given", cls, 0, num_classes_ - 1);
 		}
 	}
+
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	classes_[cls]->histogram.record(nsec_since(last_time_, now));
+	last_time_ = now;
 }
 
 /** Start of given class task.
@@ -217,21 +233,12 @@ TimeTracker::ping(unsigned int cls)
 void
 TimeTracker::ping_start(unsigned int cls)
 {
-	if (cls >= class_times_.size())
+	if (cls >= num_classes_)
 		return;
 
-	timeval *t = (timeval *)malloc(sizeof(timeval));
-	gettimeofday(t, NULL);
-
-	if (cls < class_times_.size()) {
-		class_times_[cls].push_back(t);
-	} else {
-		if (class_times_.size() == 0) {
-			throw Exception("No classes have been added, cannot track times");
-		} else {
-			throw OutOfBoundsException("Invalid class given", cls, 0, class_times_.size() - 1);
-		}
-	}
+	TimeClass *c = classes_[cls].get();
+	clock_gettime(CLOCK_MONOTONIC, &c->start);
+	c->started = true;
 }
 
 /** End of given class task.
@@ -242,24 +249,15 @@ TimeTracker::ping_start(unsigned int cls)
 void
 TimeTracker::ping_end(unsigned int cls)
 {
-	if (cls >= class_times_.size())
+	if (cls >= num_classes_ || !classes_[cls]->started)
 		return;
 
-	timeval t2;
-	gettimeofday(&t2, NULL);
-
-	timeval *t1 = class_times_[cls].back();
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
 
-	long sec  = t2.tv_sec - t1->tv_sec;
-	long usec = t2.tv_usec - t1->tv_usec;
-
-	if (usec < 0) {
-		sec -= 1;
-		usec += 1000000;
-	}
-
-	t1->tv_sec  = sec;
-	t1->tv_usec = usec;
+	TimeClass *c = classes_[cls].get();
+	c->histogram.record(nsec_since(c->start, now));
+	c->started = false;
 }
 
 /** End of given class task without recording.
@@ -269,113 +267,120 @@ TimeTracker::ping_end(unsigned int cls)
 void
 TimeTracker::ping_abort(unsigned int cls)
 {
-	if (cls >= class_times_.size())
+	if (cls >= num_classes_)
 		return;
 
-	free(class_times_[cls].back());
-	class_times_[cls].pop_back();
+	classes_[cls]->started = false;
 }
 
-void
-TimeTracker::average_and_deviation(vector<struct timeval *> &values,
-                                   double &                  average_sec,
-                                   double &                  average_ms,
-                                   double &                  deviation_sec,
-                                   double &                  deviation_ms)
+/** Get number of classes.
+ * @return number of classes, including removed ones, valid class IDs are
+ * smaller than this number
+ */
+unsigned int
+TimeTracker::num_classes() const
 {
-	vector<struct timeval *>::iterator tit;
-
-	average_sec = average_ms = deviation_sec = deviation_ms = 0.f;
+	return num_classes_;
+}
 
-	for (tit = values.begin(); tit != values.end(); ++tit) {
-		average_sec += float((*tit)->tv_sec);
-		average_sec += (*tit)->tv_usec / 1000000.f;
+/** Get class name.
+ * @param cls class ID
+ * @return name of the class, empty if the class has been removed
+ */
+const std::string &
+TimeTracker::class_name(unsigned int cls) const
+{
+	static const std::string removed_name;
+	if (cls >= num_classes_) {
+		throw OutOfBoundsException("Invalid class given", cls, 0, num_classes_);
 	}
-	average_sec /= values.size();
+	return classes_[cls]->removed ? removed_name : classes_[cls]->name;
+}
 
-	for (tit = values.begin(); tit != values.end(); ++tit) {
-		deviation_sec += fabs((*tit)->tv_sec + ((*tit)->tv_usec / 1000000.f) - average_sec);
+/** Get class histogram.
+ * The histogram may be read while the tracker is being used.
+ * @param cls class ID
+ * @return histogram of the times tracked for the class
+ */
+const TimeHistogram &
+TimeTracker::histogram(unsigned int cls) const
+{
+	if (cls >= num_classes_) {
+		throw OutOfBoundsException("Invalid class given", cls, 0, num_classes_);
 	}
-	deviation_sec /= values.size();
+	return classes_[cls]->histogram;
+}
 
-	average_ms   = average_sec * 1000.f;
-	deviation_ms = deviation_sec * 1000.f;
+/** Merge times of another tracker.
+ * The times of each class of the other tracker are added to the class with
+ * the same name, which is added if it does not exist, yet. Classless pings
+ * are not merged.
+ * @param other tracker to merge, may be in use by another thread
+ */
+void
+TimeTracker::merge(const TimeTracker &other)
+{
+	unsigned int num_other = other.num_classes_;
+	for (unsigned int o = 0; o < num_other; ++o) {
+		const TimeClass *oc = other.classes_[o].get();
+		if (oc->removed)
+			continue;
+
+		unsigned int cls = 0;
+		while (cls < num_classes_ && (classes_[cls]->removed || classes_[cls]->name != oc->name))
+			++cls;
+		if (cls == num_classes_)
+			cls = add_class(oc->name);
+
+		classes_[cls]->histogram.merge(oc->histogram);
+	}
 }
 
 /** Print results to stdout. */
 void
 TimeTracker::print_to_stdout()
 {
-	if (!times_.empty()) {
-		unsigned int i               = 0;
-		unsigned int j               = 0;
-		long         diff_sec_start  = 0;
-		long         diff_usec_start = 0;
-		long         diff_sec_last   = 0;
-		long         diff_usec_last  = 0;
-		float        diff_msec_start = 0.0;
-		float        diff_msec_last  = 0.0;
-		time_t       last_sec        = start_time.tv_sec;
-		suseconds_t  last_usec       = start_time.tv_usec;
+	if (!pings_.empty()) {
+		unsigned int i = num_dropped_pings_;
 		char         time_string[26];
 
-		ctime_r(&(start_time.tv_sec), time_string);
-		for (j = 26; j > 0; --j) {
-			if (time_string[j] == '\n') {
-				time_string[j] = 0;
-				break;
-			}
-		}
-
 		cout << endl << "TimeTracker stats - individual times";
-		if (tracker_comment_.empty()) {
+		if (!tracker_comment_.empty()) {
 			cout << " (" << tracker_comment_ << ")";
 		}
+		ctime_r(&start_time_.tv_sec, time_string);
+		time_string[24] = 0;
 		cout << endl
 		     << "==================================================================" << endl
-		     << "Initialized: " << time_string << " (" << start_time.tv_sec << ")" << endl
-		     << endl;
+		     << "Initialized: " << time_string << " (" << start_time_.tv_sec << ")" << endl;
+		if (num_dropped_pings_ > 0) {
+			cout << "Omitted:     " << num_dropped_pings_ << " oldest pings" << endl;
+		}
+		cout << endl;
 
-		for (time_it_ = times_.begin(); time_it_ != times_.end(); ++time_it_) {
-			char tmp[10];
+		timespec last = start_time_;
+		for (const ClasslessPing &p : pings_) {
+			char tmp[16];
 			sprintf(tmp, "%3u.", i + 1);
 			cout << tmp;
-			if (comments_.count(i) > 0) {
-				cout << "  (" << comments_[i] << ")";
+			if (!p.comment.empty()) {
+				cout << "  (" << p.comment << ")";
 			}
 			cout << endl;
 
-			diff_sec_start  = (*time_it_)->tv_sec - start_time.tv_sec;
-			diff_usec_start = (*time_it_)->tv_usec - start_time.tv_usec;
-			if (diff_usec_start < 0) {
-				diff_sec_start -= 1;
-				diff_usec_start = 1000000 + diff_usec_start;
-			}
-			diff_msec_start = diff_usec_start / 1000.f;
-
-			diff_sec_last  = (*time_it_)->tv_sec - last_sec;
-			diff_usec_last = (*time_it_)->tv_usec - last_usec;
-			if (diff_usec_last < 0) {
-				diff_sec_last -= 1;
-				diff_usec_last = 1000000 + diff_usec_last;
-			}
-			diff_msec_last = diff_usec_last / 1000.f;
-
-			last_sec  = (*time_it_)->tv_sec;
-			last_usec = (*time_it_)->tv_usec;
-
-			ctime_r(&(*time_it_)->tv_sec, time_string);
-			for (j = 26; j > 0; --j) {
-				if (time_string[j] == '\n') {
-					time_string[j] = 0;
-					break;
-				}
-			}
-			cout << time_string << " (" << (*time_it_)->tv_sec << ")" << endl;
-			cout << "Diff to start: " << diff_sec_start << " sec and " << diff_usec_start
-			     << " usec  (which are " << diff_msec_start << " msec)" << endl;
-			cout << "Diff to last:  " << diff_sec_last << " sec and " << diff_usec_last
-			     << " usec (which are " << diff_msec_last << " msec)" << endl
+			uint64_t diff_start = nsec_since(start_time_, p.time);
+			uint64_t diff_last  = nsec_since(last, p.time);
+			last                = p.time;
+
+			ctime_r(&p.time.tv_sec, time_string);
+			time_string[24] = 0;
+			cout << time_string << " (" << p.time.tv_sec << ")" << endl;
+			cout << "Diff to start: " << diff_start / 1000000000 << " sec and "
+			     << (diff_start % 1000000000) / 1000 << " usec  (which are "
+			     << (diff_start % 1000000000) / 1e6 << " msec)" << endl;
+			cout << "Diff to last:  " << diff_last / 1000000000 << " sec and "
+			     << (diff_last % 1000000000) / 1000 << " usec (which are "
+			     << (diff_last % 1000000000) / 1e6 << " msec)" << endl
 			     << endl;
 
 			i += 1;
@@ -388,27 +393,29 @@ TimeTracker::print_to_stdout()
 	}
 	cout << endl << "==================================================================" << endl;
 
-	vector<vector<struct timeval *>>::iterator it  = class_times_.begin();
-	vector<string>::iterator                   sit = class_names_.begin();
-
-	double deviation    = 0.f;
-	double average      = 0.f;
-	double average_ms   = 0.f;
-	double deviation_ms = 0.f;
-
-	for (; (it != class_times_.end()) && (sit != class_names_.end()); ++it, ++sit) {
-		if (sit->empty())
+	for (unsigned int i = 0; i < num_classes_; ++i) {
+		const TimeClass *c = classes_[i].get();
+		if (c->removed)
 			continue;
 
-		if (it->size() > 0) {
-			average_and_deviation(*it, average, average_ms, deviation, deviation_ms);
-
-			cout << "Class '" << *sit << "'" << endl
-			     << "  avg=" << average << " (" << average_ms << " ms)" << endl
-			     << "  dev=" << deviation << " (" << deviation_ms << " ms)" << endl
-			     << "  res=" << it->size() << " results" << endl;
+		const TimeHistogram &h = c->histogram;
+		if (h.count() > 0) {
+			char tmp[128];
+			snprintf(tmp,
+			         sizeof(tmp),
+			         "  p50=%.3f ms  p99=%.3f ms  p99.9=%.3f ms  max=%.3f ms",
+			         h.percentile(0.5) / 1e6,
+			         h.percentile(0.99) / 1e6,
+			         h.percentile(0.999) / 1e6,
+			         h.max() / 1e6);
+
+			cout << "Class '" << c->name << "'" << endl
+			     << "  avg=" << h.mean() / 1e9 << " (" << h.mean() / 1e6 << " ms)" << endl
+			     << "  dev=" << h.deviation() / 1e9 << " (" << h.deviation() / 1e6 << " ms)" << endl
+			     << tmp << endl
+			     << "  res=" << h.count() << " results" << endl;
 		} else {
-			cout << "Class '" << *sit << "' has no results." << endl;
+			cout << "Class '" << c->name << "' has no results." << endl;
 		}
 	}
 
@@ -428,24 +435,24 @@ TimeTracker::print_to_file()
 	if (!timelog_)
 		throw Exception("Time log not opened, use other ctor");
 
-	vector<vector<struct timeval *>>::iterator it  = class_times_.begin();
-	vector<string>::iterator                   sit = class_names_.begin();
-
-	double deviation    = 0.f;
-	double average      = 0.f;
-	double average_ms   = 0.f;
-	double deviation_ms = 0.f;
-	double avgsum       = 0.f;
+	double avgsum = 0.f;
 
 	fprintf(timelog_, "%u ", ++write_cycle_);
-	for (; (it != class_times_.end()) && (sit != class_names_.end()); ++it, ++sit) {
-		if (sit->empty())
+	for (unsigned int i = 0; i < num_classes_; ++i) {
+		const TimeClass *c = classes_[i].get();
+		if (c->removed)
 			continue;
 
-		average_and_deviation(*it, average, average_ms, deviation, deviation_ms);
-
+		double average   = c->histogram.mean() / 1e9;
+		double deviation = c->histogram.deviation() / 1e9;
 		avgsum += average;
-		fprintf(timelog_, "%lf %lf %lf %lf %lf ", average, average_ms, avgsum, deviation, deviation_ms);
+		fprintf(timelog_,
+		        "%lf %lf %lf %lf %lf ",
+		        average,
+		        average * 1000.,
+		        avgsum,
+		        deviation,
+		        deviation * 1000.);
 	}
 	fprintf(timelog_, "\n");
 	fflush(timelog_);
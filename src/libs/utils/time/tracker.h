@@ -24,10 +24,13 @@
 #ifndef _UTILS_TIME_TRACKER_H_
 #define _UTILS_TIME_TRACKER_H_
 
-#include <sys/time.h>
+#include <utils/time/histogram.h>
 
+#include <atomic>
 #include <cstdio>
-#include <map>
+#include <ctime>
+#include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -37,6 +40,8 @@ class TimeTracker
 {
 public:
 	static const unsigned int DEFAULT_CLASS;
+	static const unsigned int MAX_CLASSES;
+	static const unsigned int MAX_CLASSLESS_PINGS;
 
 	TimeTracker(const char *filename, bool add_default_class = false);
 	TimeTracker(bool add_default_class = false);
@@ -56,23 +61,36 @@ public:
 
 	void print_to_file();
 
+	unsigned int         num_classes() const;
+	const std::string &  class_name(unsigned int cls) const;
+	const TimeHistogram &histogram(unsigned int cls) const;
+	void                 merge(const TimeTracker &other);
+
 private:
-	void average_and_deviation(std::vector<struct timeval *> &values,
-	                           double &                       average_sec,
-	                           double &                       average_ms,
-	                           double &                       deviation_sec,
-	                           double &                       deviation_ms);
+	/// @cond INTERNALS
+	struct TimeClass
+	{
+		std::string       name;
+		std::atomic<bool> removed;
+		TimeHistogram     histogram;
+		timespec          start;
+		bool              started;
+	};
+	struct ClasslessPing
+	{
+		timespec    time;
+		std::string comment;
+	};
+	/// @endcond
 
 private:
-	timeval                                       start_time;
-	timeval                                       last_time;
-	std::vector<std::vector<struct timeval *>>    class_times_;
-	std::vector<std::string>                      class_names_;
-	std::vector<struct timeval *>                 times_;
-	std::map<unsigned int, std::string>           comments_;
-	std::vector<struct timeval *>::iterator       time_it_;
-	std::map<unsigned int, std::string>::iterator comment_it_;
-	std::string                                   tracker_comment_;
+	timespec                                start_time_;
+	timespec                                last_time_;
+	std::vector<std::unique_ptr<TimeClass>> classes_;
+	std::atomic<unsigned int>               num_classes_;
+	std::deque<ClasslessPing>               pings_;
+	unsigned int                            num_dropped_pings_;
+	std::string                             tracker_comment_;
 
 	unsigned int write_cycle_;
 	FILE *       timelog_;
@@ -358,6 +358,32 @@ AmclThread::init()
 		logger->log_info(name(), "Done initializing likelihood field model.");
 	}
 
+	cfg_laser_threads_ = 1;
+	try {
+		cfg_laser_threads_ = config->get_uint(AMCL_CFG_PREFIX "laser_threads");
+	} catch (Exception &e) {
+	} // ignored, use default
+	laser_->SetNumThreads(cfg_laser_threads_);
+
+	cfg_range_table_angles_ = 0;
+	try {
+		cfg_range_table_angles_ = config->get_uint(AMCL_CFG_PREFIX "laser_range_table_angles");
+	} catch (Exception &e) {
+	} // ignored, use default
+
+	if (laser_model_type_ == ::amcl::LASER_MODEL_BEAM && cfg_range_table_angles_ > 0) {
+		if (laser_max_range_ > 0.0) {
+			logger->log_info(name(),
+			                 "Pre-computing ranges for %u angles; "
+			                 "this can take some time on large maps...",
+			                 cfg_range_table_angles_);
+			laser_->SetRangeTable(cfg_range_table_angles_, (float)laser_max_range_);
+			logger->log_info(name(), "Done pre-computing ranges.");
+		} else {
+			logger->log_warn(name(), "Range table requires laser_max_range, disabled");
+		}
+	}
+
 	laser_if_ = blackboard->open_for_reading<Laser360Interface>(cfg_laser_ifname_.c_str());
 	pos3d_if_ = blackboard->open_for_writing<Position3DInterface>(cfg_pose_ifname_.c_str());
 	loc_if_   = blackboard->open_for_writing<LocalizationInterface>("AMCL");
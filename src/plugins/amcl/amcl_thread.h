@@ -126,6 +126,9 @@ private:
 	bool        cfg_buffer_debug_;
 	bool        cfg_use_latest_odom_;
 
+	unsigned int cfg_laser_threads_;
+	unsigned int cfg_range_table_angles_;
+
 	std::string cfg_laser_ifname_;
 	std::string cfg_pose_ifname_;
 
@@ -59,6 +59,12 @@ map_t *map_alloc(void)
   
   // Allocate storage for main map
   map->cells = (map_cell_t*) NULL;
+
+  // No ranges have been pre-computed
+  map->range_table = NULL;
+  map->range_table_index = NULL;
+  map->range_table_angles = 0;
+  map->range_table_max_range = 0;
   
   return map;
 }
@@ -68,6 +74,8 @@ map_t *map_alloc(void)
 void map_free(map_t *map)
 {
   free(map->cells);
+  free(map->range_table);
+  free(map->range_table_index);
   free(map);
   return;
 }
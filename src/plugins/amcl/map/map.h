@@ -82,6 +82,19 @@ typedef struct
 	// likelihood field
 	double max_occ_dist;
 
+	// Pre-computed ranges for discrete angles from free cells, cf.
+	// map_update_range_table(). Ranges are stored in units of
+	// range_table_max_range / MAP_RANGE_TABLE_MAX.
+	uint16_t *range_table;
+
+	// Row of each cell in range_table, each row holds range_table_angles
+	// ranges, -1 if the ranges have not been computed for the cell
+	int *range_table_index;
+
+	// Number of discrete angles and maximum range of the range table
+	int    range_table_angles;
+	double range_table_max_range;
+
 } map_t;
 
 /**************************************************************************
@@ -106,6 +119,12 @@ int map_load_occ(map_t *map, const char *filename, double scale, int negate);
 // Update the cspace distances
 void map_update_cspace(map_t *map, double max_occ_dist);
 
+// Pre-compute ranges from all free cells for discrete angles
+void map_update_range_table(map_t *map, int num_angles, double max_range);
+
+// Free the pre-computed ranges
+void map_free_range_table(map_t *map);
+
 /**************************************************************************
  * Range functions
  **************************************************************************/
@@ -113,6 +132,10 @@ void map_update_cspace(map_t *map, double max_occ_dist);
 // Extract a single range reading from the map
 double map_calc_range(map_t *map, double ox, double oy, double oa, double max_range);
 
+// Get a single range reading from the range table, falls back to
+// map_calc_range() if no range has been pre-computed
+double map_lookup_range(map_t *map, double ox, double oy, double oa, double max_range);
+
 /**************************************************************************
  * GUI/diagnostic functions
  **************************************************************************/
@@ -144,6 +167,9 @@ void map_draw_wifi(map_t *map, struct _rtk_fig_t *fig, int index);
 // Compute the cell index for the given map coords.
 #define MAP_INDEX(map, i, j) ((i) + (j)*map->size_x)
 
+// Maximum value of a range table entry, it represents the maximum range
+#define MAP_RANGE_TABLE_MAX 65535
+
 /// @endcond
 
 #ifdef __cplusplus
@@ -29,10 +29,14 @@
 
 #include "map.h"
 
+#include <algorithm>
+#include <atomic>
 #include <math.h>
 #include <queue>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
+#include <vector>
 
 /// @cond EXTERNAL
 
@@ -255,6 +259,80 @@ map_update_cspace(map_t *map, double max_occ_dist)
 	delete[] marked;
 }
 
+// Pre-compute ranges from the center of all free cells for num_angles
+// discrete angles evenly spread over the full circle. This is done once
+// per map and in parallel, as it requires one raytrace per cell and angle.
+void
+map_update_range_table(map_t *map, int num_angles, double max_range)
+{
+	map_free_range_table(map);
+	if (num_angles <= 0 || max_range <= 0.)
+		return;
+
+	const int num_cells = map->size_x * map->size_y;
+	int       num_free  = 0;
+
+	map->range_table_index = (int *)malloc(sizeof(int) * num_cells);
+	for (int c = 0; c < num_cells; ++c) {
+		if (map->cells[c].occ_state == -1) {
+			map->range_table_index[c] = num_free++;
+		} else {
+			// raytracing from non-free cells is trivial
+			map->range_table_index[c] = -1;
+		}
+	}
+
+	map->range_table           = (uint16_t *)malloc(sizeof(uint16_t) * (size_t)num_free * num_angles);
+	map->range_table_angles    = num_angles;
+	map->range_table_max_range = max_range;
+
+	std::atomic<int> next_row(0);
+	auto             worker = [&]() {
+    int j;
+    while ((j = next_row++) < map->size_y) {
+      for (int i = 0; i < map->size_x; ++i) {
+        int row = map->range_table_index[MAP_INDEX(map, i, j)];
+        if (row < 0)
+          continue;
+        uint16_t *ranges = map->range_table + (size_t)row * num_angles;
+        double ox = MAP_WXGX(map, i);
+        double oy = MAP_WYGY(map, j);
+        for (int a = 0; a < num_angles; ++a) {
+          double range = map_calc_range(map, ox, oy, a * 2 * M_PI / num_angles, max_range);
+          if (range >= max_range) {
+            ranges[a] = MAP_RANGE_TABLE_MAX;
+          } else {
+            ranges[a] = (uint16_t)std::min(floor(range / max_range * MAP_RANGE_TABLE_MAX + 0.5),
+                                           MAP_RANGE_TABLE_MAX - 1.);
+          }
+        }
+      }
+    }
+	};
+
+	unsigned int             num_threads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<std::thread> threads;
+	for (unsigned int t = 1; t < num_threads; ++t) {
+		threads.push_back(std::thread(worker));
+	}
+	worker();
+	for (std::thread &t : threads) {
+		t.join();
+	}
+}
+
+// Free the pre-computed ranges, map_lookup_range() falls back to raytracing
+void
+map_free_range_table(map_t *map)
+{
+	free(map->range_table);
+	free(map->range_table_index);
+	map->range_table           = NULL;
+	map->range_table_index     = NULL;
+	map->range_table_angles    = 0;
+	map->range_table_max_range = 0.;
+}
+
 #if 0
 // TODO: replace this with a more efficient implementation.  Not crucial,
 // because we only do it once, at startup.
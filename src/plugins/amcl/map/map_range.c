@@ -126,4 +126,35 @@ double map_calc_range(map_t *map, double ox, double oy, double oa, double max_ra
   return max_range;
 }
 
+// Get a single range reading from the range table.  The reading is taken
+// from the center of the cell containing the given point along the closest
+// discrete angle.  If no ranges have been computed for the cell or for the
+// given maximum range, the range is calculated by raytracing.
+double map_lookup_range(map_t *map, double ox, double oy, double oa, double max_range)
+{
+  int i, j, a, row;
+  uint16_t range;
+
+  if (map->range_table == NULL || fabs(max_range - map->range_table_max_range) > 1e-6)
+    return map_calc_range(map, ox, oy, oa, max_range);
+
+  i = MAP_GXWX(map, ox);
+  j = MAP_GYWY(map, oy);
+  if (!MAP_VALID(map, i, j))
+    return map_calc_range(map, ox, oy, oa, max_range);
+
+  row = map->range_table_index[MAP_INDEX(map, i, j)];
+  if (row < 0)
+    return map_calc_range(map, ox, oy, oa, max_range);
+
+  a = (int) floor(oa * map->range_table_angles / (2 * M_PI) + 0.5) % map->range_table_angles;
+  if (a < 0)
+    a += map->range_table_angles;
+
+  range = map->range_table[(size_t)row * map->range_table_angles + a];
+  if (range == MAP_RANGE_TABLE_MAX)
+    return max_range;
+  return range * (map->range_table_max_range / MAP_RANGE_TABLE_MAX);
+}
+
 /// @endcond
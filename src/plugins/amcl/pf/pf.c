@@ -96,8 +96,8 @@ pf_t *pf_alloc(int min_samples, int max_samples,
       sample->weight = 1.0 / max_samples;
     }
 
-    // HACK: is 3 times max_samples enough?
-    set->kdtree = pf_kdtree_alloc(3 * max_samples);
+    // There are at most as many histogram bins as samples
+    set->kdtree = pf_kdtree_alloc(max_samples);
 
     set->cluster_count = 0;
     set->cluster_max_count = max_samples;
@@ -275,15 +275,14 @@ void pf_update_sensor(pf_t *pf, pf_sensor_model_fn_t sensor_fn, void *sensor_dat
 // Resample the distribution
 void pf_update_resample(pf_t *pf)
 {
-  int i;
+  int i, m, num_candidates;
   double total;
   pf_sample_set_t *set_a, *set_b;
   pf_sample_t *sample_a, *sample_b;
 
-  //double r,c,U;
-  //int m;
-  //double count_inv;
+  double r, step;
   double* c;
+  int* candidates;
 
   double w_diff;
 
@@ -291,13 +290,27 @@ void pf_update_resample(pf_t *pf)
   set_b = pf->sets + (pf->current_set + 1) % 2;
 
   // Build up cumulative probability table for resampling.
-  // TODO: Replace this with a more efficient procedure
-  // (e.g., http://www.network-theory.co.uk/docs/gslref/GeneralDiscreteDistributions.html)
   c = (double*)malloc(sizeof(double)*(set_a->sample_count+1));
   c[0] = 0.0;
   for(i=0;i<set_a->sample_count;i++)
     c[i+1] = c[i]+set_a->samples[i].weight;
 
+  // Low-variance resampler, taken from Probabilistic Robotics, p110.
+  // Draw as many candidates as we may need at most in a single pass
+  // over the cumulative table.
+  num_candidates = pf->max_samples;
+  candidates = (int*)malloc(sizeof(int)*num_candidates);
+  step = c[set_a->sample_count] / num_candidates;
+  r = drand48() * step;
+  i = 0;
+  for (m = 0; m < num_candidates; m++)
+  {
+    double U = r + m * step;
+    while ((i < set_a->sample_count - 1) && (c[i+1] <= U))
+      i++;
+    candidates[m] = i;
+  }
+
   // Create the kd tree for adaptive sampling
   pf_kdtree_clear(set_b->kdtree);
   
@@ -310,16 +323,11 @@ void pf_update_resample(pf_t *pf)
     w_diff = 0.0;
   //printf("w_diff: %9.6f\n", w_diff);
 
-  // Can't (easily) combine low-variance sampler with KLD adaptive
-  // sampling, so we'll take the more traditional route.
-  /*
-  // Low-variance resampler, taken from Probabilistic Robotics, p110
-  count_inv = 1.0/set_a->sample_count;
-  r = drand48() * count_inv;
-  c = set_a->samples[0].weight;
-  i = 0;
+  // KLD adaptive sampling may stop after any number of samples.  To
+  // combine it with the low-variance resampler, the candidates are taken
+  // in random order, i.e., each prefix is a random subset of the
+  // candidates and not biased towards the first samples of set a.
   m = 0;
-  */
   while(set_b->sample_count < pf->max_samples)
   {
     sample_b = set_b->samples + set_b->sample_count++;
@@ -328,39 +336,13 @@ void pf_update_resample(pf_t *pf)
       sample_b->pose = (pf->random_pose_fn)(pf->random_pose_data);
     else
     {
-      // Can't (easily) combine low-variance sampler with KLD adaptive
-      // sampling, so we'll take the more traditional route.
-      /*
-      // Low-variance resampler, taken from Probabilistic Robotics, p110
-      U = r + m * count_inv;
-      while(U>c)
-      {
-        i++;
-        // Handle wrap-around by resetting counters and picking a new random
-        // number
-        if(i >= set_a->sample_count)
-        {
-          r = drand48() * count_inv;
-          c = set_a->samples[0].weight;
-          i = 0;
-          m = 0;
-          U = r + m * count_inv;
-          continue;
-        }
-        c += set_a->samples[i].weight;
-      }
-      m++;
-      */
-
-      // Naive discrete event sampler
-      double r;
-      r = drand48();
-      for(i=0;i<set_a->sample_count;i++)
-      {
-        if((c[i] <= r) && (r < c[i+1]))
-          break;
-      }
-      assert(i<set_a->sample_count);
+      // Pick one of the remaining candidates (partial Fisher-Yates shuffle)
+      int j = m + (int)(drand48() * (num_candidates - m));
+      if (j >= num_candidates)
+        j = num_candidates - 1;
+      i = candidates[j];
+      candidates[j] = candidates[m];
+      candidates[m++] = i;
 
       sample_a = set_a->samples + i;
 
@@ -400,6 +382,7 @@ void pf_update_resample(pf_t *pf)
   // Use the newly created sample set
   pf->current_set = (pf->current_set + 1) % 2;
 
+  free(candidates);
   free(c);
   return;
 }
@@ -42,30 +42,14 @@
 #include "pf_kdtree.h"
 
 
-// Compare keys to see if they are equal
-static int pf_kdtree_equal(pf_kdtree_t *self, int key_a[], int key_b[]);
+// Compute the key of the bin for the given pose
+static void pf_kdtree_key(pf_kdtree_t *self, pf_vector_t pose, int key[]);
 
-// Insert a node into the tree
-static pf_kdtree_node_t *pf_kdtree_insert_node(pf_kdtree_t *self, pf_kdtree_node_t *parent,
-                                               pf_kdtree_node_t *node, int key[], double value);
-
-// Recursive node search
-static pf_kdtree_node_t *pf_kdtree_find_node(pf_kdtree_t *self, pf_kdtree_node_t *node, int key[]);
-
-// Recursively label nodes in this cluster
-static void pf_kdtree_cluster_node(pf_kdtree_t *self, pf_kdtree_node_t *node, int depth);
-
-// Recursive node printing
-//static void pf_kdtree_print_node(pf_kdtree_t *self, pf_kdtree_node_t *node);
-
-
-#ifdef INCLUDE_RTKGUI
-
-// Recursively draw nodes
-static void pf_kdtree_draw_node(pf_kdtree_t *self, pf_kdtree_node_t *node, rtk_fig_t *fig);
-
-#endif
+// Find the slot of the given key in the hash table
+static int pf_kdtree_find_slot(pf_kdtree_t *self, int key[]);
 
+// Find the node for the given key, NULL if there is none
+static pf_kdtree_node_t *pf_kdtree_find_node(pf_kdtree_t *self, int key[]);
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -80,12 +64,16 @@ pf_kdtree_t *pf_kdtree_alloc(int max_size)
   self->size[1] = 0.50;
   self->size[2] = (10 * M_PI / 180);
 
-  self->root = NULL;
-
   self->node_count = 0;
   self->node_max_count = max_size;
   self->nodes = calloc(self->node_max_count, sizeof(pf_kdtree_node_t));
 
+  // Keep the load factor of the hash table below one half
+  self->table_size = 1;
+  while (self->table_size < 2 * max_size)
+    self->table_size *= 2;
+  self->table = calloc(self->table_size, sizeof(int));
+
   self->leaf_count = 0;
 
   return self;
@@ -96,6 +84,7 @@ pf_kdtree_t *pf_kdtree_alloc(int max_size)
 // Destroy a tree
 void pf_kdtree_free(pf_kdtree_t *self)
 {
+  free(self->table);
   free(self->nodes);
   free(self);
   return;
@@ -106,7 +95,12 @@ void pf_kdtree_free(pf_kdtree_t *self)
 // Clear all entries from the tree
 void pf_kdtree_clear(pf_kdtree_t *self)
 {
-  self->root = NULL;
+  int i;
+
+  // Only reset the used slots, there are far less than the table size
+  for (i = 0; i < self->node_count; i++)
+    self->table[self->nodes[i].slot] = 0;
+
   self->leaf_count = 0;
   self->node_count = 0;
 
@@ -119,33 +113,30 @@ void pf_kdtree_clear(pf_kdtree_t *self)
 void pf_kdtree_insert(pf_kdtree_t *self, pf_vector_t pose, double value)
 {
   int key[3];
+  int slot;
+  pf_kdtree_node_t *node;
 
-  key[0] = floor(pose.v[0] / self->size[0]);
-  key[1] = floor(pose.v[1] / self->size[1]);
-  key[2] = floor(pose.v[2] / self->size[2]);
-
-  self->root = pf_kdtree_insert_node(self, NULL, self->root, key, value);
-
-  // Test code
-  /*
-  printf("find %d %d %d\n", key[0], key[1], key[2]);
-  assert(pf_kdtree_find_node(self, self->root, key) != NULL);
-
-  pf_kdtree_print_node(self, self->root);
-
-  printf("\n");
+  pf_kdtree_key(self, pose, key);
 
-  for (i = 0; i < self->node_count; i++)
+  slot = pf_kdtree_find_slot(self, key);
+  if (self->table[slot] != 0)
   {
-    node = self->nodes + i;
-    if (node->leaf)
-    {
-      printf("find %d %d %d\n", node->key[0], node->key[1], node->key[2]);
-      assert(pf_kdtree_find_node(self, self->root, node->key) == node);
-    }
+    // Existing bin, increment the value
+    self->nodes[self->table[slot] - 1].value += value;
+    return;
   }
-  printf("\n\n");
-  */
+
+  assert(self->node_count < self->node_max_count);
+  node = self->nodes + self->node_count++;
+  node->key[0] = key[0];
+  node->key[1] = key[1];
+  node->key[2] = key[2];
+  node->value = value;
+  node->cluster = -1;
+  node->slot = slot;
+  self->table[slot] = self->node_count;
+
+  self->leaf_count += 1;
 
   return;
 }
@@ -159,11 +150,9 @@ double pf_kdtree_get_prob(pf_kdtree_t *self, pf_vector_t pose)
   int key[3];
   pf_kdtree_node_t *node;
 
-  key[0] = floor(pose.v[0] / self->size[0]);
-  key[1] = floor(pose.v[1] / self->size[1]);
-  key[2] = floor(pose.v[2] / self->size[2]);
+  pf_kdtree_key(self, pose, key);
 
-  node = pf_kdtree_find_node(self, self->root, key);
+  node = pf_kdtree_find_node(self, key);
   if (node == NULL)
     return 0.0;
   return node->value;
@@ -177,11 +166,9 @@ int pf_kdtree_get_cluster(pf_kdtree_t *self, pf_vector_t pose)
   int key[3];
   pf_kdtree_node_t *node;
 
-  key[0] = floor(pose.v[0] / self->size[0]);
-  key[1] = floor(pose.v[1] / self->size[1]);
-  key[2] = floor(pose.v[2] / self->size[2]);
+  pf_kdtree_key(self, pose, key);
 
-  node = pf_kdtree_find_node(self, self->root, key);
+  node = pf_kdtree_find_node(self, key);
   if (node == NULL)
     return -1;
   return node->cluster;
@@ -189,258 +176,109 @@ int pf_kdtree_get_cluster(pf_kdtree_t *self, pf_vector_t pose)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Compare keys to see if they are equal
-int pf_kdtree_equal(pf_kdtree_t *self, int key_a[], int key_b[])
+// Compute the key of the bin for the given pose
+void pf_kdtree_key(pf_kdtree_t *self, pf_vector_t pose, int key[])
 {
-  //double a, b;
-
-  if (key_a[0] != key_b[0])
-    return 0;
-  if (key_a[1] != key_b[1])
-    return 0;
-
-  if (key_a[2] != key_b[2])
-    return 0;
-
-  /* TODO: make this work (pivot selection needs fixing, too)
-  // Normalize angles
-  a = key_a[2] * self->size[2];
-  a = atan2(sin(a), cos(a)) / self->size[2];
-  b = key_b[2] * self->size[2];
-  b = atan2(sin(b), cos(b)) / self->size[2];
-
- if ((int) a != (int) b)
-    return 0;
-  */
-
-  return 1;
+  key[0] = floor(pose.v[0] / self->size[0]);
+  key[1] = floor(pose.v[1] / self->size[1]);
+  key[2] = floor(pose.v[2] / self->size[2]);
+  return;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Insert a node into the tree
-pf_kdtree_node_t *pf_kdtree_insert_node(pf_kdtree_t *self, pf_kdtree_node_t *parent,
-                                        pf_kdtree_node_t *node, int key[], double value)
+// Find the slot of the given key in the hash table, this is either the
+// slot of the node with this key, or the empty slot to put it into
+int pf_kdtree_find_slot(pf_kdtree_t *self, int key[])
 {
-  int i;
-  int split, max_split;
-
-  // If the node doesnt exist yet...
-  if (node == NULL)
-  {
-    assert(self->node_count < self->node_max_count);
-    node = self->nodes + self->node_count++;
-    memset(node, 0, sizeof(pf_kdtree_node_t));
-
-    node->leaf = 1;
-
-    if (parent == NULL)
-      node->depth = 0;
-    else
-      node->depth = parent->depth + 1;
-
-    for (i = 0; i < 3; i++)
-      node->key[i] = key[i];
-
-    node->value = value;
-    self->leaf_count += 1;
-  }
-
-  // If the node exists, and it is a leaf node...
-  else if (node->leaf)
-  {
-    // If the keys are equal, increment the value
-    if (pf_kdtree_equal(self, key, node->key))
-    {
-      node->value += value;
-    }
-
-    // The keys are not equal, so split this node
-    else
-    {
-      // Find the dimension with the largest variance and do a mean
-      // split
-      max_split = 0;
-      node->pivot_dim = -1;
-      for (i = 0; i < 3; i++)
-      {
-        split = abs(key[i] - node->key[i]);
-        if (split > max_split)
-        {
-          max_split = split;
-          node->pivot_dim = i;
-        }
-      }
-      assert(node->pivot_dim >= 0);
-
-      node->pivot_value = (key[node->pivot_dim] + node->key[node->pivot_dim]) / 2.0;
-
-      if (key[node->pivot_dim] < node->pivot_value)
-      {
-        node->children[0] = pf_kdtree_insert_node(self, node, NULL, key, value);
-        node->children[1] = pf_kdtree_insert_node(self, node, NULL, node->key, node->value);
-      }
-      else
-      {
-        node->children[0] = pf_kdtree_insert_node(self, node, NULL, node->key, node->value);
-        node->children[1] = pf_kdtree_insert_node(self, node, NULL, key, value);
-      }
+  unsigned int hash;
+  int slot;
+  pf_kdtree_node_t *node;
 
-      node->leaf = 0;
-      self->leaf_count -= 1;
-    }
-  }
+  hash = ((unsigned int) key[0] * 73856093u) ^ ((unsigned int) key[1] * 19349663u) ^
+         ((unsigned int) key[2] * 83492791u);
+  slot = hash & (self->table_size - 1);
 
-  // If the node exists, and it has children...
-  else
+  // Linear probing, the table is never full
+  while (self->table[slot] != 0)
   {
-    assert(node->children[0] != NULL);
-    assert(node->children[1] != NULL);
-
-    if (key[node->pivot_dim] < node->pivot_value)
-      pf_kdtree_insert_node(self, node, node->children[0], key, value);
-    else
-      pf_kdtree_insert_node(self, node, node->children[1], key, value);
+    node = self->nodes + self->table[slot] - 1;
+    if (node->key[0] == key[0] && node->key[1] == key[1] && node->key[2] == key[2])
+      break;
+    slot = (slot + 1) & (self->table_size - 1);
   }
 
-  return node;
+  return slot;
 }
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Recursive node search
-pf_kdtree_node_t *pf_kdtree_find_node(pf_kdtree_t *self, pf_kdtree_node_t *node, int key[])
+// Find the node for the given key
+pf_kdtree_node_t *pf_kdtree_find_node(pf_kdtree_t *self, int key[])
 {
-  if (node->leaf)
-  {
-    //printf("find  : leaf %p %d %d %d\n", node, node->key[0], node->key[1], node->key[2]);
-
-    // If the keys are the same...
-    if (pf_kdtree_equal(self, key, node->key))
-      return node;
-    else
-      return NULL;
-  }
-  else
-  {
-    //printf("find  : brch %p %d %f\n", node, node->pivot_dim, node->pivot_value);
-
-    assert(node->children[0] != NULL);
-    assert(node->children[1] != NULL);
+  int slot;
 
-    // If the keys are different...
-    if (key[node->pivot_dim] < node->pivot_value)
-      return pf_kdtree_find_node(self, node->children[0], key);
-    else
-      return pf_kdtree_find_node(self, node->children[1], key);
-  }
-
-  return NULL;
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Recursive node printing
-/*
-void pf_kdtree_print_node(pf_kdtree_t *self, pf_kdtree_node_t *node)
-{
-  if (node->leaf)
-  {
-    printf("(%+02d %+02d %+02d)\n", node->key[0], node->key[1], node->key[2]);
-    printf("%*s", node->depth * 11, "");
-  }
-  else
-  {
-    printf("(%+02d %+02d %+02d) ", node->key[0], node->key[1], node->key[2]);
-    pf_kdtree_print_node(self, node->children[0]);
-    pf_kdtree_print_node(self, node->children[1]);
-  }
-  return;
+  slot = pf_kdtree_find_slot(self, key);
+  if (self->table[slot] == 0)
+    return NULL;
+  return self->nodes + self->table[slot] - 1;
 }
-*/
 
 
 ////////////////////////////////////////////////////////////////////////////////
-// Cluster the leaves in the tree
+// Cluster the leaves in the tree.  Bins are in the same cluster if they
+// are adjacent, including diagonally.
 void pf_kdtree_cluster(pf_kdtree_t *self)
 {
-  int i;
-  int queue_count, cluster_count;
-  pf_kdtree_node_t **queue, *node;
-
-  queue_count = 0;
-  queue = calloc(self->node_count, sizeof(queue[0]));
+  int i, j;
+  int stack_count, cluster_count;
+  int *stack;
+  int nkey[3];
+  pf_kdtree_node_t *node, *nnode;
 
-  // Put all the leaves in a queue
   for (i = 0; i < self->node_count; i++)
-  {
-    node = self->nodes + i;
-    if (node->leaf)
-    {
-      node->cluster = -1;
-      assert(queue_count < self->node_count);
-      queue[queue_count++] = node;
-
-      // TESTING; remove
-      assert(node == pf_kdtree_find_node(self, self->root, node->key));
-    }
-  }
+    self->nodes[i].cluster = -1;
 
+  stack = malloc(sizeof(int) * (self->node_count + 1));
   cluster_count = 0;
 
-  // Do connected components for each node
-  while (queue_count > 0)
+  // Do connected components for each node, with an explicit stack
+  // instead of recursion
+  for (i = 0; i < self->node_count; i++)
   {
-    node = queue[--queue_count];
-
     // If this node has already been labelled, skip it
-    if (node->cluster >= 0)
+    if (self->nodes[i].cluster >= 0)
       continue;
 
     // Assign a label to this cluster
-    node->cluster = cluster_count++;
-
-    // Recursively label nodes in this cluster
-    pf_kdtree_cluster_node(self, node, 0);
-  }
+    self->nodes[i].cluster = cluster_count++;
+    stack_count = 0;
+    stack[stack_count++] = i;
 
-  free(queue);
-  return;
-}
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Recursively label nodes in this cluster
-void pf_kdtree_cluster_node(pf_kdtree_t *self, pf_kdtree_node_t *node, int depth)
-{
-  int i;
-  int nkey[3];
-
-  for (i = 0; i < 3 * 3 * 3; i++)
-  {
-    nkey[0] = node->key[0] + (i / 9) - 1;
-    nkey[1] = node->key[1] + ((i % 9) / 3) - 1;
-    nkey[2] = node->key[2] + ((i % 9) % 3) - 1;
-
-    pf_kdtree_node_t *nnode = pf_kdtree_find_node(self, self->root, nkey);
-    if (nnode == NULL)
-      continue;
-
-    assert(nnode->leaf);
-
-    // This node already has a label; skip it.  The label should be
-    // consistent, however.
-    if (nnode->cluster >= 0)
+    // Label all nodes connected to this one
+    while (stack_count > 0)
     {
-      assert(nnode->cluster == node->cluster);
-      continue;
-    }
-
-    // Label this node and recurse
-    nnode->cluster = node->cluster;
+      node = self->nodes + stack[--stack_count];
 
-    pf_kdtree_cluster_node(self, nnode, depth + 1);
+      for (j = 0; j < 3 * 3 * 3; j++)
+      {
+        nkey[0] = node->key[0] + (j / 9) - 1;
+        nkey[1] = node->key[1] + ((j % 9) / 3) - 1;
+        nkey[2] = node->key[2] + ((j % 9) % 3) - 1;
+
+        nnode = pf_kdtree_find_node(self, nkey);
+        if (nnode == NULL || nnode->cluster >= 0)
+          continue;
+
+        // Label this node, every node is pushed at most once
+        nnode->cluster = node->cluster;
+        assert(stack_count <= self->node_count);
+        stack[stack_count++] = nnode - self->nodes;
+      }
+    }
   }
+
+  free(stack);
   return;
 }
 
@@ -452,18 +290,13 @@ void pf_kdtree_cluster_node(pf_kdtree_t *self, pf_kdtree_node_t *node, int depth
 // Draw the tree
 void pf_kdtree_draw(pf_kdtree_t *self, rtk_fig_t *fig)
 {
-  if (self->root != NULL)
-    pf_kdtree_draw_node(self, self->root, fig);
-  return;
-}
-
+  int i;
+  pf_kdtree_node_t *node;
 
-////////////////////////////////////////////////////////////////////////////////
-// Recursively draw nodes
-void pf_kdtree_draw_node(pf_kdtree_t *self, pf_kdtree_node_t *node, rtk_fig_t *fig)
-{
-  if (node->leaf)
+  for (i = 0; i < self->node_count; i++)
   {
+    node = self->nodes + i;
+
     double ox = (node->key[0] + 0.5) * self->size[0];
     double oy = (node->key[1] + 0.5) * self->size[1];
     char text[64];
@@ -476,13 +309,6 @@ void pf_kdtree_draw_node(pf_kdtree_t *self, pf_kdtree_node_t *node, rtk_fig_t *f
     snprintf(text, sizeof(text), "%d", node->cluster);
     rtk_fig_text(fig, ox, oy, 0.0, text);
   }
-  else
-  {
-    assert(node->children[0] != NULL);
-    assert(node->children[1] != NULL);
-    pf_kdtree_draw_node(self, node->children[0], fig);
-    pf_kdtree_draw_node(self, node->children[1], fig);
-  }
 
   return;
 }
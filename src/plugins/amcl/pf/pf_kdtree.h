@@ -40,45 +40,46 @@
 #	include "rtk.h"
 #endif
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /// @cond EXTERNAL
 
-// Info for a node in the tree
+// Info for a node in the tree, i.e., a bin of the histogram
 typedef struct pf_kdtree_node
 {
-	// Depth in the tree
-	int leaf, depth;
-
-	// Pivot dimension and value
-	int    pivot_dim;
-	double pivot_value;
-
 	// The key for this node
 	int key[3];
 
 	// The value for this node
 	double value;
 
-	// The cluster label (leaf nodes)
+	// The cluster label
 	int cluster;
 
-	// Child nodes
-	struct pf_kdtree_node *children[2];
+	// Slot of this node in the hash table
+	int slot;
 
 } pf_kdtree_node_t;
 
-// A kd tree
+// A histogram over poses.  Despite the name the bins are not stored in
+// a kd tree, but in an open addressing hash table, which makes inserting
+// and finding a bin a constant time operation.
 typedef struct
 {
 	// Cell size
 	double size[3];
 
-	// The root node of the tree
-	pf_kdtree_node_t *root;
-
 	// The number of nodes in the tree
 	int               node_count, node_max_count;
 	pf_kdtree_node_t *nodes;
 
+	// Hash table of node indexes plus one, zero marks empty slots.
+	// The size is a power of two.
+	int  table_size;
+	int *table;
+
 	// The number of leaf nodes in the tree
 	int leaf_count;
 
@@ -114,4 +115,8 @@ extern void pf_kdtree_draw(pf_kdtree_t *self, rtk_fig_t *fig);
 
 /// @endcond
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -0,0 +1,359 @@
+/***************************************************************************
+ *  qa_amcl_kdtree.cpp - QA and benchmark for the AMCL pose histogram
+ *
+ *  Created: Sat Oct 17 02:31:48 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+// Compares the hash table histogram of pf_kdtree to the kd tree it has
+// replaced on random sample sets, and measures the time to build and
+// cluster the histogram as done for every particle filter update.
+//
+// The reference kd tree below is the former implementation from
+// pf_kdtree.c, reduced to the operations used by the particle filter.
+// Both must yield the same bins with the same values, and the same
+// partition of bins into clusters. The numbering of the clusters may
+// differ, it depends on the order in which bins are visited.
+
+#include <plugins/amcl/pf/pf_kdtree.h>
+#include <utils/time/time.h>
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_SETS 50
+#define NUM_BENCH_ROUNDS 20
+
+class RefKdTree
+{
+public:
+	struct Node
+	{
+		int    leaf, depth;
+		int    pivot_dim;
+		double pivot_value;
+		int    key[3];
+		double value;
+		int    cluster;
+		Node * children[2];
+	};
+
+	RefKdTree(int max_size) : nodes_(max_size)
+	{
+		size_[0]   = 0.50;
+		size_[1]   = 0.50;
+		size_[2]   = (10 * M_PI / 180);
+		root_      = NULL;
+		node_count = 0;
+		leaf_count = 0;
+	}
+
+	void
+	clear()
+	{
+		root_      = NULL;
+		node_count = 0;
+		leaf_count = 0;
+	}
+
+	void
+	insert(pf_vector_t pose, double value)
+	{
+		int k[3];
+		key(pose, k);
+		root_ = insert_node(NULL, root_, k, value);
+	}
+
+	Node *
+	find(pf_vector_t pose)
+	{
+		int k[3];
+		key(pose, k);
+		return root_ ? find_node(root_, k) : NULL;
+	}
+
+	void
+	cluster()
+	{
+		std::vector<Node *> queue;
+		for (int i = 0; i < node_count; i++) {
+			if (nodes_[i].leaf) {
+				nodes_[i].cluster = -1;
+				queue.push_back(&nodes_[i]);
+			}
+		}
+		int cluster_count = 0;
+		while (!queue.empty()) {
+			Node *node = queue.back();
+			queue.pop_back();
+			if (node->cluster >= 0)
+				continue;
+			node->cluster = cluster_count++;
+			cluster_node(node);
+		}
+	}
+
+	int node_count;
+	int leaf_count;
+
+private:
+	void
+	key(pf_vector_t pose, int k[])
+	{
+		k[0] = floor(pose.v[0] / size_[0]);
+		k[1] = floor(pose.v[1] / size_[1]);
+		k[2] = floor(pose.v[2] / size_[2]);
+	}
+
+	static bool
+	equal(int a[], int b[])
+	{
+		return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+	}
+
+	Node *
+	insert_node(Node *parent, Node *node, int key[], double value)
+	{
+		if (node == NULL) {
+			assert(node_count < (int)nodes_.size());
+			node = &nodes_[node_count++];
+			*node       = Node();
+			node->leaf  = 1;
+			node->depth = parent ? parent->depth + 1 : 0;
+			for (int i = 0; i < 3; i++)
+				node->key[i] = key[i];
+			node->value = value;
+			leaf_count += 1;
+		} else if (node->leaf) {
+			if (equal(key, node->key)) {
+				node->value += value;
+			} else {
+				int max_split   = 0;
+				node->pivot_dim = -1;
+				for (int i = 0; i < 3; i++) {
+					int split = abs(key[i] - node->key[i]);
+					if (split > max_split) {
+						max_split       = split;
+						node->pivot_dim = i;
+					}
+				}
+				node->pivot_value = (key[node->pivot_dim] + node->key[node->pivot_dim]) / 2.0;
+				if (key[node->pivot_dim] < node->pivot_value) {
+					node->children[0] = insert_node(node, NULL, key, value);
+					node->children[1] = insert_node(node, NULL, node->key, node->value);
+				} else {
+					node->children[0] = insert_node(node, NULL, node->key, node->value);
+					node->children[1] = insert_node(node, NULL, key, value);
+				}
+				node->leaf = 0;
+				leaf_count -= 1;
+			}
+		} else {
+			if (key[node->pivot_dim] < node->pivot_value)
+				insert_node(node, node->children[0], key, value);
+			else
+				insert_node(node, node->children[1], key, value);
+		}
+		return node;
+	}
+
+	Node *
+	find_node(Node *node, int key[])
+	{
+		while (!node->leaf) {
+			node = node->children[(key[node->pivot_dim] < node->pivot_value) ? 0 : 1];
+		}
+		return equal(key, node->key) ? node : NULL;
+	}
+
+	void
+	cluster_node(Node *node)
+	{
+		for (int i = 0; i < 3 * 3 * 3; i++) {
+			int nkey[3];
+			nkey[0]     = node->key[0] + (i / 9) - 1;
+			nkey[1]     = node->key[1] + ((i % 9) / 3) - 1;
+			nkey[2]     = node->key[2] + ((i % 9) % 3) - 1;
+			Node *nnode = find_node(root_, nkey);
+			if (nnode == NULL || nnode->cluster >= 0)
+				continue;
+			nnode->cluster = node->cluster;
+			cluster_node(nnode);
+		}
+	}
+
+	double            size_[3];
+	Node *            root_;
+	std::vector<Node> nodes_;
+};
+
+static int
+check(bool ok, const char *what)
+{
+	printf("%-50s %s\n", what, ok ? "OK" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+static void
+print_result(const char *what, unsigned int ops, double sec)
+{
+	printf("%-36s %8u ops in %8.4f sec, %10.1f ns/op\n", what, ops, sec, sec * 1.e9 / ops);
+}
+
+static double
+normalize_angle(double a)
+{
+	return atan2(sin(a), cos(a));
+}
+
+/** Random particle cloud as it occurs during localization.
+ * A few clusters of varying spread, from converged to global
+ * localization, with angles around the wrap-around at +/- pi.
+ */
+static std::vector<pf_vector_t>
+random_cloud(std::mt19937 &rng, unsigned int num_samples)
+{
+	std::uniform_real_distribution<double> uniform(-1., 1.);
+	std::uniform_int_distribution<int>     num_clusters(1, 8);
+	std::vector<pf_vector_t>               mean(num_clusters(rng));
+	std::vector<double>                    spread(mean.size());
+	for (unsigned int c = 0; c < mean.size(); ++c) {
+		mean[c].v[0] = uniform(rng) * 20.;
+		mean[c].v[1] = uniform(rng) * 20.;
+		mean[c].v[2] = uniform(rng) * M_PI;
+		spread[c]    = std::pow(10., uniform(rng) * 1.5);
+	}
+
+	std::normal_distribution<double> normal(0., 1.);
+	std::vector<pf_vector_t>         cloud(num_samples);
+	for (unsigned int i = 0; i < num_samples; ++i) {
+		unsigned int c = i % mean.size();
+		cloud[i].v[0]  = mean[c].v[0] + normal(rng) * spread[c];
+		cloud[i].v[1]  = mean[c].v[1] + normal(rng) * spread[c];
+		cloud[i].v[2]  = normalize_angle(mean[c].v[2] + normal(rng) * spread[c] * 0.2);
+	}
+	return cloud;
+}
+
+int
+main(int argc, char **argv)
+{
+	int          failures = 0;
+	std::mt19937 rng(4711);
+
+	const unsigned int sizes[] = {100, 1000, 5000, 20000};
+
+	bool bins_ok = true, values_ok = true, partition_ok = true;
+	for (unsigned int size : sizes) {
+		pf_kdtree_t *hist = pf_kdtree_alloc(3 * size);
+		RefKdTree    ref(3 * size);
+		for (unsigned int s = 0; s < NUM_SETS; ++s) {
+			std::vector<pf_vector_t>               cloud = random_cloud(rng, size);
+			std::uniform_real_distribution<double> weight(0., 1.);
+			pf_kdtree_clear(hist);
+			ref.clear();
+			for (const pf_vector_t &p : cloud) {
+				double w = weight(rng);
+				pf_kdtree_insert(hist, p, w);
+				ref.insert(p, w);
+			}
+			pf_kdtree_cluster(hist);
+			ref.cluster();
+
+			bins_ok = bins_ok && (hist->leaf_count == ref.leaf_count);
+
+			// labels must map one to one onto each other
+			std::map<int, int> to_ref, from_ref;
+			for (const pf_vector_t &p : cloud) {
+				RefKdTree::Node *n = ref.find(p);
+				values_ok          = values_ok && n && (pf_kdtree_get_prob(hist, p) == n->value);
+				int c              = pf_kdtree_get_cluster(hist, p);
+				auto t             = to_ref.insert(std::make_pair(c, n->cluster)).first;
+				auto f             = from_ref.insert(std::make_pair(n->cluster, c)).first;
+				partition_ok = partition_ok && (t->second == n->cluster) && (f->second == c);
+			}
+
+			// poses next to the samples may or may not be in a bin
+			for (unsigned int i = 0; i < cloud.size(); i += 7) {
+				pf_vector_t p = cloud[i];
+				p.v[0] += 0.6;
+				p.v[2] = normalize_angle(p.v[2] - 0.2);
+				RefKdTree::Node *n = ref.find(p);
+				values_ok = values_ok && (pf_kdtree_get_prob(hist, p) == (n ? n->value : 0.0))
+				            && (pf_kdtree_get_cluster(hist, p) < 0) == (n == NULL);
+			}
+		}
+		pf_kdtree_free(hist);
+	}
+	failures += check(bins_ok, "Same number of bins as kd tree");
+	failures += check(values_ok, "Same bin values as kd tree");
+	failures += check(partition_ok, "Same cluster partition as kd tree");
+
+	// build and cluster the histogram as pf_update_resample() does
+	for (unsigned int size : sizes) {
+		std::vector<std::vector<pf_vector_t>> clouds;
+		for (unsigned int r = 0; r < NUM_BENCH_ROUNDS; ++r) {
+			clouds.push_back(random_cloud(rng, size));
+		}
+		unsigned int ops = NUM_BENCH_ROUNDS * size;
+		char         what[64];
+
+		pf_kdtree_t *hist = pf_kdtree_alloc(3 * size);
+		Time         start, end;
+		start.stamp();
+		for (const auto &cloud : clouds) {
+			pf_kdtree_clear(hist);
+			for (const pf_vector_t &p : cloud) {
+				pf_kdtree_insert(hist, p, 1.0);
+			}
+			pf_kdtree_cluster(hist);
+		}
+		end.stamp();
+		double hist_sec = end - &start;
+		pf_kdtree_free(hist);
+
+		RefKdTree ref(3 * size);
+		start.stamp();
+		for (const auto &cloud : clouds) {
+			ref.clear();
+			for (const pf_vector_t &p : cloud) {
+				ref.insert(p, 1.0);
+			}
+			ref.cluster();
+		}
+		end.stamp();
+		double ref_sec = end - &start;
+
+		snprintf(what, sizeof(what), "Hash table, %u samples", size);
+		print_result(what, ops, hist_sec);
+		snprintf(what, sizeof(what), "Kd tree, %u samples", size);
+		print_result(what, ops, ref_sec);
+		printf("Speedup: %.2f\n", ref_sec / hist_sec);
+	}
+
+	return failures ? 1 : 0;
+}
+
+/// @endcond
@@ -0,0 +1,320 @@
+
+/***************************************************************************
+ *  qa_amcl_laser_bench.cpp - Benchmark AMCL laser sensor models
+ *
+ *  Created: Fri Oct 16 23:52:14 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+// Replays a set of laser scans against a map and measures the time of the
+// sensor update for the beam and likelihood field models with different
+// numbers of threads and with and without the pre-computed range table.
+//
+// Scans are read from a text file with one scan per line in the format
+//   x y theta range_max angle_min angle_increment range_0 ... range_n
+// where x, y, and theta are the pose the scan was taken from, which is
+// used as the mean of the particle distribution. Without a scan file
+// scans are simulated from random poses. Without a map file a synthetic
+// map of an office-like environment is used.
+
+#include <plugins/amcl/amcl_utils.h>
+#include <plugins/amcl/map/map.h>
+#include <plugins/amcl/pf/pf.h>
+#include <plugins/amcl/sensors/amcl_laser.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace fawkes;
+
+#define NUM_SIMULATED_SCANS 50
+#define NUM_RANGES 360
+#define RANGE_MAX 20.0
+#define MAX_BEAMS 180
+
+typedef struct
+{
+	pf_vector_t         pose;
+	double              range_max;
+	double              angle_min;
+	double              angle_inc;
+	std::vector<double> ranges;
+} scan_t;
+
+static void
+print_result(const char *what, unsigned int ops, double sec)
+{
+	printf("%-36s %8u ops in %8.4f sec, %10.1f ns/op\n", what, ops, sec, sec * 1.e9 / ops);
+}
+
+static map_t *
+synthetic_map()
+{
+	map_t *map    = map_alloc();
+	map->size_x   = 600;
+	map->size_y   = 400;
+	map->scale    = 0.05;
+	map->origin_x = 0.;
+	map->origin_y = 0.;
+	map->cells    = (map_cell_t *)calloc(map->size_x * map->size_y, sizeof(map_cell_t));
+
+	for (int j = 0; j < map->size_y; ++j) {
+		for (int i = 0; i < map->size_x; ++i) {
+			bool occ = (i < 2 || j < 2 || i >= map->size_x - 2 || j >= map->size_y - 2);
+			// walls of rooms with doors
+			occ |= (i % 150 < 2 && (j % 100 < 40 || j % 100 > 60));
+			occ |= (j == 200 && (i % 150 < 60 || i % 150 > 90));
+			// pillars
+			occ |= (i % 50 >= 24 && i % 50 < 28 && j % 70 >= 30 && j % 70 < 34);
+			map->cells[MAP_INDEX(map, i, j)].occ_state = occ ? +1 : -1;
+		}
+	}
+	return map;
+}
+
+static std::vector<scan_t>
+simulate_scans(map_t *map)
+{
+	std::mt19937                           gen(42);
+	std::uniform_int_distribution<int>     cell_dist(0, map->size_x * map->size_y - 1);
+	std::uniform_real_distribution<double> angle_dist(-M_PI, M_PI);
+	std::normal_distribution<double>       noise_dist(0., 0.02);
+
+	std::vector<scan_t> scans;
+	while (scans.size() < NUM_SIMULATED_SCANS) {
+		int c = cell_dist(gen);
+		if (map->cells[c].occ_state != -1 || map->cells[c].occ_dist < 0.5)
+			continue;
+
+		scan_t scan;
+		scan.pose.v[0] = MAP_WXGX(map, c % map->size_x);
+		scan.pose.v[1] = MAP_WYGY(map, c / map->size_x);
+		scan.pose.v[2] = angle_dist(gen);
+		scan.range_max = RANGE_MAX;
+		scan.angle_min = -M_PI;
+		scan.angle_inc = 2 * M_PI / NUM_RANGES;
+		for (int i = 0; i < NUM_RANGES; ++i) {
+			double a = scan.pose.v[2] + scan.angle_min + i * scan.angle_inc;
+			double r = map_calc_range(map, scan.pose.v[0], scan.pose.v[1], a, RANGE_MAX);
+			if (r < RANGE_MAX)
+				r = std::min(RANGE_MAX, std::max(0., r + noise_dist(gen)));
+			scan.ranges.push_back(r);
+		}
+		scans.push_back(scan);
+	}
+	return scans;
+}
+
+static std::vector<scan_t>
+read_scans(const char *filename)
+{
+	std::vector<scan_t> scans;
+	std::ifstream       f(filename);
+	std::string         line;
+	while (std::getline(f, line)) {
+		std::istringstream ls(line);
+		scan_t             scan;
+		if (!(ls >> scan.pose.v[0] >> scan.pose.v[1] >> scan.pose.v[2] >> scan.range_max
+		      >> scan.angle_min >> scan.angle_inc))
+			continue;
+		double r;
+		while (ls >> r)
+			scan.ranges.push_back(r);
+		if (!scan.ranges.empty())
+			scans.push_back(scan);
+	}
+	return scans;
+}
+
+static void
+fill_data(::amcl::AMCLLaserData &data, ::amcl::AMCLLaser *laser, const scan_t &scan)
+{
+	delete[] data.ranges;
+	data.sensor      = laser;
+	data.range_count = scan.ranges.size();
+	data.range_max   = scan.range_max;
+	data.ranges      = new double[data.range_count][2];
+	for (int i = 0; i < data.range_count; ++i) {
+		data.ranges[i][0] = scan.ranges[i];
+		data.ranges[i][1] = scan.angle_min + i * scan.angle_inc;
+	}
+}
+
+static void
+run_benchmark(const char *               what,
+              map_t *                    map,
+              ::amcl::AMCLLaser *        laser,
+              const std::vector<scan_t> &scans,
+              int                        num_particles,
+              std::vector<double> &      first_weights)
+{
+	pf_t *pf = pf_alloc(num_particles, num_particles, 0.001, 0.1, NULL, NULL);
+
+	::amcl::AMCLLaserData data;
+	Time                  start, end;
+	double                sec = 0.;
+
+	first_weights.clear();
+	for (size_t s = 0; s < scans.size(); ++s) {
+		// same particles for each run, pf_init() re-seeds on each call
+		std::mt19937                     gen(s);
+		std::normal_distribution<double> pos_dist(0., 0.5);
+		std::normal_distribution<double> ori_dist(0., 0.2);
+		pf_sample_set_t *                set = pf->sets + pf->current_set;
+		set->sample_count                    = num_particles;
+		for (int i = 0; i < set->sample_count; ++i) {
+			set->samples[i].pose.v[0] = scans[s].pose.v[0] + pos_dist(gen);
+			set->samples[i].pose.v[1] = scans[s].pose.v[1] + pos_dist(gen);
+			set->samples[i].pose.v[2] = scans[s].pose.v[2] + ori_dist(gen);
+			set->samples[i].weight    = 1.0 / num_particles;
+		}
+
+		fill_data(data, laser, scans[s]);
+
+		start.stamp();
+		laser->UpdateSensor(pf, &data);
+		end.stamp();
+		sec += end - &start;
+
+		if (s == 0) {
+			for (int i = 0; i < set->sample_count; ++i) {
+				first_weights.push_back(set->samples[i].weight);
+			}
+		}
+	}
+
+	pf_free(pf);
+	print_result(what, scans.size() * num_particles, sec);
+}
+
+static double
+max_rel_diff(const std::vector<double> &a, const std::vector<double> &b)
+{
+	double d = 0.;
+	for (size_t i = 0; i < std::min(a.size(), b.size()); ++i) {
+		d = std::max(d, fabs(a[i] - b[i]) / std::max(fabs(a[i]), 1e-300));
+	}
+	return d;
+}
+
+int
+main(int argc, char **argv)
+{
+	const char * map_file      = NULL;
+	const char * scan_file     = NULL;
+	float        resolution    = 0.05;
+	int          num_particles = 5000;
+	int          num_angles    = 360;
+	unsigned int num_threads   = 0;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "m:r:s:p:a:t:h")) != -1) {
+		switch (opt) {
+		case 'm': map_file = optarg; break;
+		case 'r': resolution = atof(optarg); break;
+		case 's': scan_file = optarg; break;
+		case 'p': num_particles = atoi(optarg); break;
+		case 'a': num_angles = atoi(optarg); break;
+		case 't': num_threads = atoi(optarg); break;
+		default:
+			printf("Usage: %s [-m map.png [-r resolution]] [-s scans.txt] [-p particles]\n"
+			       "          [-a range table angles] [-t threads]\n",
+			       argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	map_t *map;
+	if (map_file) {
+		std::vector<std::pair<int, int>> free_space_indices;
+		map = fawkes::amcl::read_map(map_file, 0., 0., resolution, 0.65, 0.196, free_space_indices);
+	} else {
+		map = synthetic_map();
+	}
+
+	std::vector<scan_t> scans;
+	if (scan_file) {
+		scans = read_scans(scan_file);
+	} else {
+		map_update_cspace(map, 2.0);
+		scans = simulate_scans(map);
+	}
+	if (scans.empty()) {
+		printf("No scans to replay\n");
+		map_free(map);
+		return 1;
+	}
+
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	printf("Map %ix%i cells, %zu scans, %i particles, %u threads\n",
+	       map->size_x,
+	       map->size_y,
+	       scans.size(),
+	       num_particles,
+	       num_threads);
+
+	::amcl::AMCLLaser * laser = new ::amcl::AMCLLaser(MAX_BEAMS, map);
+	std::vector<double> ref_weights, weights;
+	char                what[64];
+
+	laser->SetModelLikelihoodField(0.95, 0.05, 0.2, 2.0);
+	run_benchmark("likelihood field, 1 thread", map, laser, scans, num_particles, ref_weights);
+	laser->SetNumThreads(num_threads);
+	snprintf(what, sizeof(what), "likelihood field, %u threads", num_threads);
+	run_benchmark(what, map, laser, scans, num_particles, weights);
+	printf("  max relative weight difference %g\n", max_rel_diff(ref_weights, weights));
+
+	laser->SetNumThreads(1);
+	laser->SetModelBeam(0.95, 0.05, 0.05, 0.05, 0.2, 0.1, 0.0);
+	run_benchmark("beam raytrace, 1 thread", map, laser, scans, num_particles, ref_weights);
+	laser->SetNumThreads(num_threads);
+	snprintf(what, sizeof(what), "beam raytrace, %u threads", num_threads);
+	run_benchmark(what, map, laser, scans, num_particles, weights);
+	printf("  max relative weight difference %g\n", max_rel_diff(ref_weights, weights));
+
+	Time start, end;
+	start.stamp();
+	laser->SetRangeTable(num_angles, scans[0].range_max);
+	end.stamp();
+	printf("Range table for %i angles computed in %.3f sec\n", num_angles, end - &start);
+
+	laser->SetNumThreads(1);
+	run_benchmark("beam range table, 1 thread", map, laser, scans, num_particles, weights);
+	printf("  max relative weight difference %g\n", max_rel_diff(ref_weights, weights));
+	laser->SetNumThreads(num_threads);
+	snprintf(what, sizeof(what), "beam range table, %u threads", num_threads);
+	run_benchmark(what, map, laser, scans, num_particles, weights);
+
+	delete laser;
+	map_free(map);
+	return 0;
+}
+
+/// @endcond
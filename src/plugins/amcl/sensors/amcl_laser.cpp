@@ -33,6 +33,7 @@
 
 #include <sys/types.h> // required by Darwin
 
+#include <algorithm>
 #include <math.h>
 #include <stdlib.h>
 #ifdef USE_ASSERT_EXCEPTION
@@ -43,6 +44,9 @@
 #include "amcl_laser.h"
 
 #include <unistd.h>
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
 
 using namespace amcl;
 
@@ -66,9 +70,22 @@ AMCLLaser::AMCLLaser(size_t max_beams, map_t *map) : AMCLSensor()
 	this->lambda_short = .1;
 	this->chi_outlier  = 0.0;
 
+	this->lf_field_off_map = 0.f;
+	this->lf_z_rand        = 0.f;
+
+	this->num_threads     = 1;
+	this->pool_generation = 0;
+	this->pool_pending    = 0;
+	this->pool_quit       = false;
+
 	return;
 }
 
+AMCLLaser::~AMCLLaser()
+{
+	StopWorkers();
+}
+
 void
 AMCLLaser::SetModelBeam(double z_hit,
                         double z_short,
@@ -100,6 +117,113 @@ AMCLLaser::SetModelLikelihoodField(double z_hit,
 	this->sigma_hit  = sigma_hit;
 
 	map_update_cspace(this->map, max_occ_dist);
+
+	// The distance of a cell to the closest obstacle never changes,
+	// hence the Gaussian of the likelihood field can be pre-computed
+	double z_hit_denom = 2 * this->sigma_hit * this->sigma_hit;
+	this->lf_field.resize((size_t)this->map->size_x * this->map->size_y);
+	for (size_t c = 0; c < this->lf_field.size(); ++c) {
+		double z          = this->map->cells[c].occ_dist;
+		this->lf_field[c] = this->z_hit * exp(-(z * z) / z_hit_denom);
+	}
+	this->lf_field_off_map =
+	  this->z_hit * exp(-(this->map->max_occ_dist * this->map->max_occ_dist) / z_hit_denom);
+}
+
+void
+AMCLLaser::SetRangeTable(int num_angles, double max_range)
+{
+	map_update_range_table(this->map, num_angles, max_range);
+}
+
+void
+AMCLLaser::SetNumThreads(unsigned int num_threads)
+{
+	if (num_threads == 0)
+		num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	StopWorkers();
+	this->num_threads = num_threads;
+	this->pool_quit   = false;
+	for (unsigned int i = 1; i < num_threads; ++i) {
+		this->workers.push_back(
+		  std::thread(&AMCLLaser::WorkerLoop, this, i, (unsigned long)this->pool_generation));
+	}
+}
+
+void
+AMCLLaser::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->pool_mutex);
+		this->pool_quit = true;
+	}
+	this->pool_cond.notify_all();
+	for (std::thread &t : this->workers) {
+		t.join();
+	}
+	this->workers.clear();
+}
+
+void
+AMCLLaser::WorkerLoop(unsigned int index, unsigned long generation)
+{
+	std::unique_lock<std::mutex> lock(this->pool_mutex);
+	while (true) {
+		this->pool_cond.wait(lock, [&]() {
+			return this->pool_quit || this->pool_generation != generation;
+		});
+		if (this->pool_quit)
+			return;
+
+		generation = this->pool_generation;
+		lock.unlock();
+		this->pool_job(index);
+		lock.lock();
+
+		if (--this->pool_pending == 0)
+			this->pool_done_cond.notify_one();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Split the samples into one chunk per thread and apply the model to
+// each chunk concurrently
+double
+AMCLLaser::ParallelModel(pf_sample_set_t *set, const std::function<double(int, int)> &model)
+{
+	if (this->workers.empty())
+		return model(0, set->sample_count);
+
+	const unsigned int  num_chunks = this->workers.size() + 1;
+	std::vector<double> weights(num_chunks, 0.0);
+
+	auto job = [&](unsigned int index) {
+		int begin      = (int)((long long)set->sample_count * index / num_chunks);
+		int end        = (int)((long long)set->sample_count * (index + 1) / num_chunks);
+		weights[index] = model(begin, end);
+	};
+
+	{
+		std::lock_guard<std::mutex> lock(this->pool_mutex);
+		this->pool_job     = job;
+		this->pool_pending = this->workers.size();
+		this->pool_generation += 1;
+	}
+	this->pool_cond.notify_all();
+
+	job(0);
+
+	{
+		std::unique_lock<std::mutex> lock(this->pool_mutex);
+		this->pool_done_cond.wait(lock, [this]() { return this->pool_pending == 0; });
+		this->pool_job = nullptr;
+	}
+
+	double total_weight = 0.0;
+	for (double w : weights)
+		total_weight += w;
+	return total_weight;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -129,44 +253,53 @@ AMCLLaser::UpdateSensor(pf_t *pf, AMCLSensorData *data)
 double
 AMCLLaser::BeamModel(AMCLLaserData *data, pf_sample_set_t *set)
 {
-	AMCLLaser *self         = static_cast<AMCLLaser *>(data->sensor);
-	double     total_weight = 0.0;
+	AMCLLaser *self = static_cast<AMCLLaser *>(data->sensor);
+
+	return self->ParallelModel(set, [self, data, set](int begin, int end) {
+		return self->BeamModelSamples(data, set, begin, end);
+	});
+}
+
+double
+AMCLLaser::BeamModelSamples(AMCLLaserData *data, pf_sample_set_t *set, int begin, int end)
+{
+	double total_weight = 0.0;
 
 	// Compute the sample weights
-	for (int j = 0; j < set->sample_count; j++) {
+	for (int j = begin; j < end; j++) {
 		pf_sample_t *sample = set->samples + j;
 		pf_vector_t  pose{sample->pose};
 
 		// Take account of the laser pose relative to the robot
-		pose = pf_vector_coord_add(self->laser_pose, pose);
+		pose = pf_vector_coord_add(this->laser_pose, pose);
 
 		double p = 1.0;
 
-		int step = (data->range_count - 1) / (self->max_beams - 1);
+		int step = (data->range_count - 1) / (this->max_beams - 1);
 		for (int i = 0; i < data->range_count; i += step) {
 			double obs_range   = data->ranges[i][0];
 			double obs_bearing = data->ranges[i][1];
 
-			// Compute the range according to the map
+			// Compute the range according to the map, pre-computed if available
 			double map_range =
-			  map_calc_range(self->map, pose.v[0], pose.v[1], pose.v[2] + obs_bearing, data->range_max);
+			  map_lookup_range(this->map, pose.v[0], pose.v[1], pose.v[2] + obs_bearing, data->range_max);
 			double pz = 0.0;
 
 			// Part 1: good, but noisy, hit
 			double z = obs_range - map_range;
-			pz += self->z_hit * exp(-(z * z) / (2 * self->sigma_hit * self->sigma_hit));
+			pz += this->z_hit * exp(-(z * z) / (2 * this->sigma_hit * this->sigma_hit));
 
 			// Part 2: short reading from unexpected obstacle (e.g., a person)
 			if (z < 0)
-				pz += self->z_short * self->lambda_short * exp(-self->lambda_short * obs_range);
+				pz += this->z_short * this->lambda_short * exp(-this->lambda_short * obs_range);
 
 			// Part 3: Failure to detect obstacle, reported as max-range
 			if (obs_range == data->range_max)
-				pz += self->z_max * 1.0;
+				pz += this->z_max * 1.0;
 
 			// Part 4: Random measurements
 			if (obs_range < data->range_max)
-				pz += self->z_rand * 1.0 / data->range_max;
+				pz += this->z_rand * 1.0 / data->range_max;
 
 			// TODO: outlier rejection for short readings
 
@@ -191,78 +324,124 @@ AMCLLaser::BeamModel(AMCLLaserData *data, pf_sample_set_t *set)
 double
 AMCLLaser::LikelihoodFieldModel(AMCLLaserData *data, pf_sample_set_t *set)
 {
-	AMCLLaser *  self;
-	int          i, j;
-	double       z, pz;
-	double       obs_range, obs_bearing;
-	double       total_weight;
-	pf_sample_t *sample;
-	pf_vector_t  pose;
-	pf_vector_t  hit;
+	AMCLLaser *self = static_cast<AMCLLaser *>(data->sensor);
 
-	self = (AMCLLaser *)data->sensor;
+	// Pre-compute the beam endpoints relative to the laser in map cells,
+	// they are the same for all samples
+	self->lf_beam_x.clear();
+	self->lf_beam_y.clear();
 
-	total_weight = 0.0;
+	int step = (data->range_count - 1) / (self->max_beams - 1);
+	for (int i = 0; i < data->range_count; i += step) {
+		double obs_range   = data->ranges[i][0];
+		double obs_bearing = data->ranges[i][1];
 
-	// Compute the sample weights
-	for (j = 0; j < set->sample_count; j++) {
-		sample = set->samples + j;
-		pose   = sample->pose;
+		// This model ignores max range readings
+		if (obs_range >= data->range_max)
+			continue;
 
-		// Take account of the laser pose relative to the robot
-		pose = pf_vector_coord_add(self->laser_pose, pose);
+		self->lf_beam_x.push_back(obs_range * cos(obs_bearing) / self->map->scale);
+		self->lf_beam_y.push_back(obs_range * sin(obs_bearing) / self->map->scale);
+	}
 
-		double p = 1.0;
+	// Part 2: random measurements
+	self->lf_z_rand = self->z_rand * 1.0 / data->range_max;
 
-		// Pre-compute a couple of things
-		double z_hit_denom = 2 * self->sigma_hit * self->sigma_hit;
-		double z_rand_mult = 1.0 / data->range_max;
+	return self->ParallelModel(set, [self, set](int begin, int end) {
+		return self->LikelihoodFieldModelSamples(set, begin, end);
+	});
+}
 
-		int step = (data->range_count - 1) / (self->max_beams - 1);
-		for (i = 0; i < data->range_count; i += step) {
-			obs_range   = data->ranges[i][0];
-			obs_bearing = data->ranges[i][1];
+double
+AMCLLaser::LikelihoodFieldModelSamples(pf_sample_set_t *set, int begin, int end)
+{
+	const int    num_beams = this->lf_beam_x.size();
+	const float *beam_x    = this->lf_beam_x.data();
+	const float *beam_y    = this->lf_beam_y.data();
+	const float *field     = this->lf_field.data();
+	const float  size_x    = this->map->size_x;
+	const float  size_y    = this->map->size_y;
 
-			// This model ignores max range readings
-			if (obs_range >= data->range_max)
-				continue;
+	double total_weight = 0.0;
 
-			pz = 0.0;
+	// Compute the sample weights
+	for (int j = begin; j < end; j++) {
+		pf_sample_t *sample = set->samples + j;
 
-			// Compute the endpoint of the beam
-			hit.v[0] = pose.v[0] + obs_range * cos(pose.v[2] + obs_bearing);
-			hit.v[1] = pose.v[1] + obs_range * sin(pose.v[2] + obs_bearing);
+		// Take account of the laser pose relative to the robot
+		pf_vector_t pose = pf_vector_coord_add(this->laser_pose, sample->pose);
+
+		// Map grid coords of the laser, cf. MAP_GXWX() and MAP_GYWY(), the
+		// grid coords of a beam endpoint are the floor of the rotated beam
+		// plus these coords
+		float gx = (pose.v[0] - this->map->origin_x) / this->map->scale + 0.5 + this->map->size_x / 2;
+		float gy = (pose.v[1] - this->map->origin_y) / this->map->scale + 0.5 + this->map->size_y / 2;
+		float ca = cos(pose.v[2]);
+		float sa = sin(pose.v[2]);
+
+		float sum = 0.f;
+		int   i   = 0;
+#ifdef __SSE2__
+		const __m128 v_zero   = _mm_setzero_ps();
+		const __m128 v_one    = _mm_set1_ps(1.f);
+		const __m128 v_size_x = _mm_set1_ps(size_x);
+		const __m128 v_size_y = _mm_set1_ps(size_y);
+		const __m128 v_gx     = _mm_set1_ps(gx);
+		const __m128 v_gy     = _mm_set1_ps(gy);
+		const __m128 v_ca     = _mm_set1_ps(ca);
+		const __m128 v_sa     = _mm_set1_ps(sa);
+		const __m128 v_z_rand = _mm_set1_ps(this->lf_z_rand);
+		__m128       v_sum    = _mm_setzero_ps();
+		for (; i + 4 <= num_beams; i += 4) {
+			__m128 bx = _mm_loadu_ps(beam_x + i);
+			__m128 by = _mm_loadu_ps(beam_y + i);
+			__m128 hx = _mm_add_ps(v_gx, _mm_sub_ps(_mm_mul_ps(v_ca, bx), _mm_mul_ps(v_sa, by)));
+			__m128 hy = _mm_add_ps(v_gy, _mm_add_ps(_mm_mul_ps(v_sa, bx), _mm_mul_ps(v_ca, by)));
 
-			// Convert to map grid coords.
-			int mi, mj;
-			mi = MAP_GXWX(self->map, hit.v[0]);
-			mj = MAP_GYWY(self->map, hit.v[1]);
+			// Off-map penalized as max distance
+			__m128 valid = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(hx, v_zero), _mm_cmplt_ps(hx, v_size_x)),
+			                          _mm_and_ps(_mm_cmpge_ps(hy, v_zero), _mm_cmplt_ps(hy, v_size_y)));
+			int    mask  = _mm_movemask_ps(valid);
+			int    mi[4], mj[4];
+			float  z[4];
+			_mm_storeu_si128((__m128i *)mi, _mm_cvttps_epi32(hx));
+			_mm_storeu_si128((__m128i *)mj, _mm_cvttps_epi32(hy));
+			for (int l = 0; l < 4; ++l) {
+				z[l] = (mask & (1 << l)) ? field[MAP_INDEX(this->map, mi[l], mj[l])]
+				                         : this->lf_field_off_map;
+			}
+
+			__m128 pz = _mm_add_ps(_mm_loadu_ps(z), v_z_rand);
+			pz        = _mm_and_ps(pz, _mm_and_ps(_mm_cmpge_ps(pz, v_zero), _mm_cmple_ps(pz, v_one)));
+			v_sum     = _mm_add_ps(v_sum, _mm_mul_ps(pz, _mm_mul_ps(pz, pz)));
+		}
+		float sums[4];
+		_mm_storeu_ps(sums, v_sum);
+		sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#endif
+		for (; i < num_beams; ++i) {
+			float hx = gx + (ca * beam_x[i] - sa * beam_y[i]);
+			float hy = gy + (sa * beam_x[i] + ca * beam_y[i]);
 
-			// Part 1: Get distance from the hit to closest obstacle.
 			// Off-map penalized as max distance
-			if (!MAP_VALID(self->map, mi, mj))
-				z = self->map->max_occ_dist;
+			float pz;
+			if (hx >= 0.f && hx < size_x && hy >= 0.f && hy < size_y)
+				pz = field[MAP_INDEX(this->map, (int)hx, (int)hy)];
 			else
-				z = self->map->cells[MAP_INDEX(self->map, mi, mj)].occ_dist;
-			// Gaussian model
-			// NOTE: this should have a normalization of 1/(sqrt(2pi)*sigma)
-			pz += self->z_hit * exp(-(z * z) / z_hit_denom);
-			// Part 2: random measurements
-			pz += self->z_rand * z_rand_mult;
-
-			// TODO: outlier rejection for short readings
+				pz = this->lf_field_off_map;
+			pz += this->lf_z_rand;
 
 			//assert(pz <= 1.0);
 			//assert(pz >= 0.0);
-			if ((pz < 0.) || (pz > 1.))
-				pz = 0.;
+			if ((pz < 0.f) || (pz > 1.f))
+				pz = 0.f;
 
-			//      p *= pz;
 			// here we have an ad-hoc weighting scheme for combining beam probs
 			// works well, though...
-			p += pz * pz * pz;
+			sum += pz * pz * pz;
 		}
 
+		double p = 1.0 + sum;
 		sample->weight *= p;
 		total_weight += sample->weight;
 	}
@@ -38,6 +38,12 @@
 #include "../map/map.h"
 #include "amcl_sensor.h"
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 /// @cond EXTERNAL
 
 namespace amcl {
@@ -74,6 +80,10 @@ class AMCLLaser : public AMCLSensor
 public:
 	AMCLLaser(size_t max_beams, map_t *map);
 
+	// Destructor, stops worker threads
+public:
+	virtual ~AMCLLaser();
+
 public:
 	void SetModelBeam(double z_hit,
 	                  double z_short,
@@ -86,6 +96,15 @@ public:
 public:
 	void SetModelLikelihoodField(double z_hit, double z_rand, double sigma_hit, double max_occ_dist);
 
+	// Pre-compute ranges for the beam model for the given number of
+	// discrete angles, 0 to raytrace each beam
+public:
+	void SetRangeTable(int num_angles, double max_range);
+
+	// Set the number of threads to compute sample weights with
+public:
+	void SetNumThreads(unsigned int num_threads);
+
 	// Update the filter based on the sensor model.  Returns true if the
 	// filter has been updated.
 public:
@@ -106,6 +125,23 @@ private:
 private:
 	static double LikelihoodFieldModel(AMCLLaserData *data, pf_sample_set_t *set);
 
+	// Determine the probability for the samples in [begin, end)
+private:
+	double BeamModelSamples(AMCLLaserData *data, pf_sample_set_t *set, int begin, int end);
+
+private:
+	double LikelihoodFieldModelSamples(pf_sample_set_t *set, int begin, int end);
+
+	// Split the samples among the worker threads, returns the total weight
+private:
+	double ParallelModel(pf_sample_set_t *set, const std::function<double(int, int)> &model);
+
+private:
+	void WorkerLoop(unsigned int index, unsigned long generation);
+
+private:
+	void StopWorkers();
+
 private:
 	laser_model_t model_type;
 
@@ -149,6 +185,53 @@ private:
 	// Threshold for outlier rejection (unused)
 private:
 	double chi_outlier;
+
+	// Likelihood field, z_hit weighted Gaussian of the distance of each
+	// cell to the closest obstacle, and its value for off-map cells
+private:
+	std::vector<float> lf_field;
+
+private:
+	float lf_field_off_map;
+
+	// Beam endpoints relative to the laser, in map cells, for the
+	// current update of the likelihood field model
+private:
+	std::vector<float> lf_beam_x;
+
+private:
+	std::vector<float> lf_beam_y;
+
+private:
+	float lf_z_rand;
+
+	// Worker threads, the calling thread works on the first chunk
+private:
+	unsigned int num_threads;
+
+private:
+	std::vector<std::thread> workers;
+
+private:
+	std::mutex pool_mutex;
+
+private:
+	std::condition_variable pool_cond;
+
+private:
+	std::condition_variable pool_done_cond;
+
+private:
+	std::function<void(unsigned int)> pool_job;
+
+private:
+	unsigned long pool_generation;
+
+private:
+	unsigned int pool_pending;
+
+private:
+	bool pool_quit;
 };
 
 } // namespace amcl
@@ -357,26 +357,61 @@ Bumblebee2Thread::init()
 		pcl_manager->add_pointcloud("bumblebee2-xyz", pcl_xyz_);
 		pcl_manager->add_pointcloud("bumblebee2-xyzrgb", pcl_xyzrgb_);
 
-		shm_img_rgb_right_ = new SharedMemoryImageBuffer("bumblebee2-rgb-right", RGB, width_, height_);
-		shm_img_rgb_left_  = new SharedMemoryImageBuffer("bumblebee2-rgb-left", RGB, width_, height_);
-		shm_img_yuv_right_ =
-		  new SharedMemoryImageBuffer("bumblebee2-yuv-right", YUV422_PLANAR, width_, height_);
-		shm_img_yuv_left_ =
-		  new SharedMemoryImageBuffer("bumblebee2-yuv-left", YUV422_PLANAR, width_, height_);
-		shm_img_rgb_rect_right_ =
-		  new SharedMemoryImageBuffer("bumblebee2-rgb-rectified-right", RGB_PLANAR, width_, height_);
-		shm_img_rgb_rect_left_ =
-		  new SharedMemoryImageBuffer("bumblebee2-rgb-rectified-left", RGB_PLANAR, width_, height_);
-		shm_img_rectified_right_ =
-		  new SharedMemoryImageBuffer("bumblebee2-rectified-right", MONO8, width_, height_);
-		shm_img_rectified_left_ =
-		  new SharedMemoryImageBuffer("bumblebee2-rectified-left", MONO8, width_, height_);
-		shm_img_prefiltered_right_ =
-		  new SharedMemoryImageBuffer("bumblebee2-prefiltered-right", MONO8, width_, height_);
-		shm_img_prefiltered_left_ =
-		  new SharedMemoryImageBuffer("bumblebee2-prefiltered-left", MONO8, width_, height_);
-		shm_img_disparity_ =
-		  new SharedMemoryImageBuffer("bumblebee2-disparity", MONO8, width_, height_);
+		shm_img_rgb_right_ = new SharedMemoryImageBuffer("bumblebee2-rgb-right",
+		                                                 RGB,
+		                                                 width_,
+		                                                 height_,
+		                                                 /* slots */ 1);
+		shm_img_rgb_left_ = new SharedMemoryImageBuffer("bumblebee2-rgb-left",
+		                                                RGB,
+		                                                width_,
+		                                                height_,
+		                                                /* slots */ 1);
+		shm_img_yuv_right_ = new SharedMemoryImageBuffer("bumblebee2-yuv-right",
+		                                                 YUV422_PLANAR,
+		                                                 width_,
+		                                                 height_,
+		                                                 /* slots */ 1);
+		shm_img_yuv_left_ = new SharedMemoryImageBuffer("bumblebee2-yuv-left",
+		                                                YUV422_PLANAR,
+		                                                width_,
+		                                                height_,
+		                                                /* slots */ 1);
+		shm_img_rgb_rect_right_ = new SharedMemoryImageBuffer("bumblebee2-rgb-rectified-right",
+		                                                      RGB_PLANAR,
+		                                                      width_,
+		                                                      height_,
+		                                                      /* slots */ 1);
+		shm_img_rgb_rect_left_ = new SharedMemoryImageBuffer("bumblebee2-rgb-rectified-left",
+		                                                     RGB_PLANAR,
+		                                                     width_,
+		                                                     height_,
+		                                                     /* slots */ 1);
+		shm_img_rectified_right_ = new SharedMemoryImageBuffer("bumblebee2-rectified-right",
+		                                                       MONO8,
+		                                                       width_,
+		                                                       height_,
+		                                                       /* slots */ 1);
+		shm_img_rectified_left_ = new SharedMemoryImageBuffer("bumblebee2-rectified-left",
+		                                                      MONO8,
+		                                                      width_,
+		                                                      height_,
+		                                                      /* slots */ 1);
+		shm_img_prefiltered_right_ = new SharedMemoryImageBuffer("bumblebee2-prefiltered-right",
+		                                                         MONO8,
+		                                                         width_,
+		                                                         height_,
+		                                                         /* slots */ 1);
+		shm_img_prefiltered_left_ = new SharedMemoryImageBuffer("bumblebee2-prefiltered-left",
+		                                                        MONO8,
+		                                                        width_,
+		                                                        height_,
+		                                                        /* slots */ 1);
+		shm_img_disparity_ = new SharedMemoryImageBuffer("bumblebee2-disparity",
+		                                                 MONO8,
+		                                                 width_,
+		                                                 height_,
+		                                                 /* slots */ 1);
 
 		tf_last_publish_ = new fawkes::Time(clock);
 		fawkes::Time   now(clock);
@@ -87,6 +87,10 @@ ClipsNavGraphThread::clips_context_init(const std::string &          env_name,
 	                      sigc::mem_fun(*this, &ClipsNavGraphThread::clips_navgraph_unblock_edge),
 	                      env_name)));
 
+	clips->add_function("navgraph-cost-matrix",
+	                    sigc::slot<CLIPS::Values, CLIPS::Values, CLIPS::Values>(
+	                      sigc::mem_fun(*this, &ClipsNavGraphThread::clips_navgraph_cost_matrix)));
+
 	clips.unlock();
 }
 
@@ -184,6 +188,31 @@ ClipsNavGraphThread::clips_navgraph_unblock_edge(std::string env_name,
 	                 to.c_str());
 }
 
+CLIPS::Values
+ClipsNavGraphThread::clips_navgraph_cost_matrix(CLIPS::Values from, CLIPS::Values to)
+{
+	std::vector<std::string> from_nodes, to_nodes;
+	for (const CLIPS::Value &v : from) {
+		from_nodes.push_back(v.as_string());
+	}
+	for (const CLIPS::Value &v : to) {
+		to_nodes.push_back(v.as_string());
+	}
+
+	navgraph.lock();
+	std::vector<std::vector<float>> costs = navgraph->search_costs(from_nodes, to_nodes);
+	navgraph.unlock();
+
+	CLIPS::Values rv;
+	rv.reserve(from_nodes.size() * to_nodes.size());
+	for (const std::vector<float> &row : costs) {
+		for (float c : row) {
+			rv.push_back(CLIPS::Value(c));
+		}
+	}
+	return rv;
+}
+
 void
 ClipsNavGraphThread::graph_changed() throw()
 {
@@ -30,6 +30,7 @@
 #include <navgraph/navgraph.h>
 #include <plugins/clips/aspect/clips_feature.h>
 
+#include <clipsmm.h>
 #include <map>
 #include <string>
 #include <vector>
@@ -70,9 +71,10 @@ protected:
 	}
 
 private:
-	void clips_navgraph_load(fawkes::LockPtr<CLIPS::Environment> &clips);
-	void clips_navgraph_block_edge(std::string env_name, std::string from, std::string to);
-	void clips_navgraph_unblock_edge(std::string env_name, std::string from, std::string to);
+	void          clips_navgraph_load(fawkes::LockPtr<CLIPS::Environment> &clips);
+	void          clips_navgraph_block_edge(std::string env_name, std::string from, std::string to);
+	void          clips_navgraph_unblock_edge(std::string env_name, std::string from, std::string to);
+	CLIPS::Values clips_navgraph_cost_matrix(CLIPS::Values from, CLIPS::Values to);
 
 private:
 	std::map<std::string, fawkes::LockPtr<CLIPS::Environment>> envs_;
@@ -27,14 +27,53 @@
 #include <core/threading/mutex_locker.h>
 #include <interface/interface_info.h>
 #include <logging/logger.h>
-#include <utils/misc/string_conversions.h>
 #include <utils/misc/string_split.h>
 #include <utils/time/time.h>
 
 #include <clipsmm.h>
+#include <cmath>
+#include <limits>
 
 using namespace fawkes;
 
+/// @cond INTERNALS
+/* Map values CLIPS cannot represent like the string conversion did. */
+static double
+clips_double(double v)
+{
+	if (std::isinf(v)) {
+		return (v < 0) ? std::numeric_limits<double>::min() : std::numeric_limits<double>::max();
+	} else if (std::isnan(v)) {
+		return std::signbit(v) ? std::numeric_limits<double>::min() + 1
+		                       : std::numeric_limits<double>::max() - 1;
+	}
+	return v;
+}
+
+/* Get CLIPS value of a field, index is the array index. */
+static CLIPS::Value
+clips_field_value(const InterfaceFieldIterator &f, unsigned int index)
+{
+	switch (f.get_type()) {
+	case IFT_BOOL: return CLIPS::Value(f.get_bool(index) ? "TRUE" : "FALSE", CLIPS::TYPE_SYMBOL);
+	case IFT_INT8: return CLIPS::Value((long int)f.get_int8(index));
+	case IFT_UINT8: return CLIPS::Value((long int)f.get_uint8(index));
+	case IFT_INT16: return CLIPS::Value((long int)f.get_int16(index));
+	case IFT_UINT16: return CLIPS::Value((long int)f.get_uint16(index));
+	case IFT_INT32: return CLIPS::Value((long int)f.get_int32(index));
+	case IFT_UINT32: return CLIPS::Value((long int)f.get_uint32(index));
+	case IFT_INT64: return CLIPS::Value((long int)f.get_int64(index));
+	case IFT_UINT64: return CLIPS::Value((long int)f.get_uint64(index));
+	case IFT_BYTE: return CLIPS::Value((long int)f.get_byte(index));
+	case IFT_FLOAT: return CLIPS::Value(clips_double(f.get_float(index)));
+	case IFT_DOUBLE: return CLIPS::Value(clips_double(f.get_double(index)));
+	case IFT_STRING: return CLIPS::Value(f.get_string(), CLIPS::TYPE_STRING);
+	case IFT_ENUM: return CLIPS::Value(f.get_enum_string(index), CLIPS::TYPE_SYMBOL);
+	}
+	return CLIPS::Value("nil", CLIPS::TYPE_SYMBOL);
+}
+/// @endcond
+
 /** @class BlackboardCLIPSFeature "feature_blackboard.h"
  * CLIPS blackboard feature.
  * @author Tim Niemueller
@@ -458,6 +497,7 @@ BlackboardCLIPSFeature::clips_blackboard_close_interface(const std::string &env_
 		auto  iface_it =
 		  find_if(l.begin(), l.end(), [&id](const Interface *iface) { return id == iface->id(); });
 		if (iface_it != l.end()) {
+			interfaces_[env_name].facts.erase(*iface_it);
 			blackboard_->close(*iface_it);
 			l.erase(iface_it);
 			// do NOT remove the list, even if empty, because we need to remember
@@ -493,72 +533,101 @@ BlackboardCLIPSFeature::clips_blackboard_read(const std::string &env_name)
 	}
 
 	fawkes::MutexLocker lock(envs_[env_name].objmutex_ptr());
-	CLIPS::Environment &env = **(envs_[env_name]);
-	for (auto &iface_map : interfaces_[env_name].reading) {
+	Interfaces &        ifs = interfaces_[env_name];
+	for (auto &iface_map : ifs.reading) {
 		for (auto i : iface_map.second) {
+			// skip interfaces which have not been written since the last read,
+			// an odd version means a write is in progress, read again next time
+			InterfaceFact &ifact   = ifs.facts[i];
+			uint32_t       version = i->data_version();
+			if ((version != 0) && ((version & 1) == 0) && (version == ifact.version))
+				continue;
+			ifact.version = version;
+
 			i->read();
 			if (i->changed()) {
-				if (!cfg_retract_early_) {
-					std::string fun = std::string("(") + i->type() + "-cleanup-late \"" + i->id() + "\")";
-					env.evaluate(fun);
-				}
-				const Time *t = i->timestamp();
-
-				std::string fact = std::string("(") + i->type() + " (id \"" + i->id() + "\")" + " (time "
-				                   + StringConversions::to_string(t->get_sec()) + " "
-				                   + StringConversions::to_string(t->get_usec()) + ")";
-
-				InterfaceFieldIterator f, f_end = i->fields_end();
-				for (f = i->fields(); f != f_end; ++f) {
-					std::string value;
-					if (f.get_type() == IFT_STRING) {
-						value                      = f.get_value_string();
-						std::string::size_type pos = 0;
-						while ((pos = value.find("\"", pos)) != std::string::npos) {
-							value.replace(pos, 1, "\\\"");
-							pos += 2;
-						}
-						value = std::string("\"") + value + "\"";
-					} else {
-						value = f.get_value_string();
-						std::string::size_type pos;
-						while ((pos = value.find(",")) != std::string::npos) {
-							value = value.erase(pos, 1);
-						}
-
-						if (f.get_type() == IFT_FLOAT || f.get_type() == IFT_DOUBLE) {
-							std::string::size_type pos;
-							while ((pos = value.find("-inf")) != std::string::npos) {
-								value = value.replace(pos, 4, std::to_string(std::numeric_limits<double>::min()));
-							}
-							while ((pos = value.find("inf")) != std::string::npos) {
-								value = value.replace(pos, 3, std::to_string(std::numeric_limits<double>::max()));
-							}
-							while ((pos = value.find("-nan")) != std::string::npos) {
-								value =
-								  value.replace(pos, 4, std::to_string(std::numeric_limits<double>::min() + 1));
-							}
-							while ((pos = value.find("nan")) != std::string::npos) {
-								value =
-								  value.replace(pos, 3, std::to_string(std::numeric_limits<double>::max() - 1));
-							}
-						} else if (f.get_type() == IFT_BOOL) {
-							std::string::size_type pos;
-							while ((pos = value.find("false")) != std::string::npos) {
-								value = value.replace(pos, 5, "FALSE");
-							}
-							while ((pos = value.find("true")) != std::string::npos) {
-								value = value.replace(pos, 4, "TRUE");
-							}
-						}
-					}
-					fact += std::string(" (") + f.get_name() + " " + value + ")";
-				}
-				fact += ")";
-				env.assert_fact(fact);
+				clips_blackboard_assert_interface(env_name, i, ifact);
+			}
+		}
+	}
+}
+
+/** Assert fact for an interface.
+ * Unless retracting early, the fact previously asserted for the interface
+ * is retracted. The fact is created from the deftemplate of the interface
+ * type, which is looked up once per type.
+ * @param env_name name of the environment, must be locked
+ * @param iface interface to assert the fact for
+ * @param ifact fact record of the interface, updated with the new fact
+ * @return true if the fact has been asserted, false otherwise
+ */
+bool
+BlackboardCLIPSFeature::clips_blackboard_assert_interface(const std::string &env_name,
+                                                          fawkes::Interface *iface,
+                                                          InterfaceFact &    ifact)
+{
+	CLIPS::Environment &env = **(envs_[env_name]);
+
+	InterfaceTemplate &itemp = interfaces_[env_name].templates[iface->type()];
+	if (!itemp.temp) {
+		itemp.temp = env.get_template(iface->type());
+		if (!itemp.temp) {
+			logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
+			                  "No deftemplate for interface type %s",
+			                  iface->type());
+			return false;
+		}
+		itemp.slots.clear();
+		InterfaceFieldIterator f, f_end = iface->fields_end();
+		for (f = iface->fields(); f != f_end; ++f) {
+			itemp.slots.push_back(f.get_name());
+		}
+	}
+
+	if (!cfg_retract_early_) {
+		if (ifact.fact && ifact.fact->exists()) {
+			ifact.fact->retract();
+		} else {
+			std::string fun = std::string("(") + iface->type() + "-cleanup-late \"" + iface->id() + "\")";
+			env.evaluate(fun);
+		}
+	}
+	ifact.fact.reset();
+
+	const Time *  t = iface->timestamp();
+	CLIPS::Values time(2, CLIPS::Value(CLIPS::TYPE_INTEGER));
+	time[0] = t->get_sec();
+	time[1] = t->get_usec();
+
+	CLIPS::Fact::pointer fact = CLIPS::Fact::create(env, itemp.temp);
+	fact->set_slot("id", CLIPS::Value(iface->id(), CLIPS::TYPE_STRING));
+	fact->set_slot("time", time);
+
+	InterfaceFieldIterator f, f_end = iface->fields_end();
+	size_t                 slot = 0;
+	for (f = iface->fields(); f != f_end && slot < itemp.slots.size(); ++f, ++slot) {
+		if ((f.get_type() != IFT_STRING) && (f.get_length() > 1)) {
+			CLIPS::Values values;
+			values.reserve(f.get_length());
+			for (unsigned int j = 0; j < f.get_length(); ++j) {
+				values.push_back(clips_field_value(f, j));
 			}
+			fact->set_slot(itemp.slots[slot], values);
+		} else {
+			fact->set_slot(itemp.slots[slot], clips_field_value(f, 0));
 		}
 	}
+
+	CLIPS::Fact::pointer new_fact = env.assert_fact(fact);
+	if (!new_fact) {
+		logger_->log_warn(("BBCLIPS|" + env_name).c_str(),
+		                  "Asserting fact for %s failed",
+		                  iface->uid());
+		return false;
+	}
+	if (!cfg_retract_early_)
+		ifact.fact = new_fact;
+	return true;
 }
 
 void
@@ -23,12 +23,16 @@
 #ifndef _PLUGINS_CLIPS_FEATURE_BLACKBOARD_H_
 #define _PLUGINS_CLIPS_FEATURE_BLACKBOARD_H_
 
+#include <clipsmm/fact.h>
+#include <clipsmm/template.h>
 #include <clipsmm/value.h>
 #include <plugins/clips/aspect/clips_feature.h>
 
+#include <cstdint>
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace CLIPS {
 class Environment;
@@ -61,10 +65,24 @@ private: // members
 	bool                cfg_retract_early_;
 
 	typedef std::map<std::string, std::list<fawkes::Interface *>> InterfaceMap;
+	// deftemplate of an interface type and slot names in field order
 	typedef struct
 	{
-		InterfaceMap reading;
-		InterfaceMap writing;
+		CLIPS::Template::pointer temp;
+		std::vector<std::string> slots;
+	} InterfaceTemplate;
+	// data version of the last read and last asserted fact of an interface
+	typedef struct
+	{
+		uint32_t             version;
+		CLIPS::Fact::pointer fact;
+	} InterfaceFact;
+	typedef struct
+	{
+		InterfaceMap                                 reading;
+		InterfaceMap                                 writing;
+		std::map<std::string, InterfaceTemplate>     templates;
+		std::map<fawkes::Interface *, InterfaceFact> facts;
 	} Interfaces;
 	std::map<std::string, Interfaces>                          interfaces_;
 	std::map<std::string, fawkes::LockPtr<CLIPS::Environment>> envs_;
@@ -86,6 +104,9 @@ private: // methods
 	                                      const std::string &type,
 	                                      const std::string &id);
 	void clips_blackboard_read(const std::string &env_name);
+	bool clips_blackboard_assert_interface(const std::string &env_name,
+	                                       fawkes::Interface *iface,
+	                                       InterfaceFact &    ifact);
 	void clips_blackboard_write(const std::string &env_name, const std::string &uid);
 
 	void          clips_blackboard_enable_time_read(const std::string &env_name);
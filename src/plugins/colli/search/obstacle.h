@@ -27,11 +27,29 @@
 
 #include <utils/math/common.h>
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <vector>
 
 namespace fawkes {
 
+/** Dense stencil of an obstacle for stamping it into a grid.
+ * The stencil covers the bounding box of the obstacle cells. It is stored
+ * row by row for each x offset, each row contains the costs for the
+ * consecutive y offsets. Cells which are not part of the obstacle have the
+ * lowest float value, such that taking the maximum with the grid cells
+ * leaves the grid unchanged.
+ */
+typedef struct
+{
+	int                x_min;      /**< x offset of the first row */
+	int                y_min;      /**< y offset of the first cell of each row */
+	int                num_rows;   /**< number of rows */
+	int                row_length; /**< number of cells per row */
+	std::vector<float> costs;      /**< costs, num_rows * row_length cells */
+} colli_obstacle_stencil_t;
+
 /** @class ColliFastObstacle <plugins/colli/search/obstacle.h>
  * This is an implementation of a a fast obstacle.
  */
@@ -52,6 +70,19 @@ public:
 		return occupied_cells_;
 	}
 
+	/** Return the occupied cells as dense stencil.
+   * The stencil is created on the first call.
+   * @return stencil of the obstacle
+   */
+	inline const colli_obstacle_stencil_t &
+	get_stencil()
+	{
+		if (stencil_.costs.empty() && !occupied_cells_.empty()) {
+			create_stencil();
+		}
+		return stencil_;
+	}
+
 	/** Get the key
    * @return The key
    */
@@ -79,10 +110,40 @@ protected:
 	std::vector<int> occupied_cells_;
 
 private:
+	void create_stencil();
+
 	// a unique identifier for each obstacle
 	int key_;
+
+	colli_obstacle_stencil_t stencil_;
 };
 
+inline void
+ColliFastObstacle::create_stencil()
+{
+	int x_min = occupied_cells_[0], x_max = occupied_cells_[0];
+	int y_min = occupied_cells_[1], y_max = occupied_cells_[1];
+	for (unsigned int i = 0; i < occupied_cells_.size(); i += 3) {
+		x_min = std::min(x_min, occupied_cells_[i]);
+		x_max = std::max(x_max, occupied_cells_[i]);
+		y_min = std::min(y_min, occupied_cells_[i + 1]);
+		y_max = std::max(y_max, occupied_cells_[i + 1]);
+	}
+
+	stencil_.x_min      = x_min;
+	stencil_.y_min      = y_min;
+	stencil_.num_rows   = x_max - x_min + 1;
+	stencil_.row_length = y_max - y_min + 1;
+	stencil_.costs.assign(stencil_.num_rows * stencil_.row_length,
+	                      -std::numeric_limits<float>::max());
+
+	for (unsigned int i = 0; i < occupied_cells_.size(); i += 3) {
+		float &c = stencil_.costs[(occupied_cells_[i] - x_min) * stencil_.row_length
+		                          + (occupied_cells_[i + 1] - y_min)];
+		c        = std::max(c, (float)occupied_cells_[i + 2]);
+	}
+}
+
 /** @class ColliFastRectangle
  * This is an implementation of a a fast rectangle.
  */
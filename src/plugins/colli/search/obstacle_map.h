@@ -46,6 +46,12 @@ public:
 
 	const std::vector<int> get_obstacle(int width, int height, bool obstacle_increasement = true);
 
+	const colli_obstacle_stencil_t &
+	get_stencil(int width, int height, bool obstacle_increasement = true);
+
+private:
+	ColliFastObstacle *obstacle(int width, int height, bool obstacle_increasement);
+
 private:
 	std::map<unsigned int, ColliFastObstacle *> obstacles_;
 	bool                                        is_rectangle_;
@@ -70,6 +76,30 @@ inline ColliObstacleMap::ColliObstacleMap(colli_cell_cost_t cell_costs, bool is_
  */
 inline const std::vector<int>
 ColliObstacleMap::get_obstacle(int width, int height, bool obstacle_increasement)
+{
+	return obstacle(width, height, obstacle_increasement)->get_obstacle();
+}
+
+/** Get the dense stencil of a given obstacle.
+ * @param width The width of the obstacle
+ * @param height The height of the obstacle
+ * @param obstacle_increasement Enable obstacle increasement?
+ * @return stencil of such an obstacle, valid as long as the obstacle map exists
+ */
+inline const colli_obstacle_stencil_t &
+ColliObstacleMap::get_stencil(int width, int height, bool obstacle_increasement)
+{
+	return obstacle(width, height, obstacle_increasement)->get_stencil();
+}
+
+/** Get an obstacle, it is created if it does not exist, yet.
+ * @param width The width of the obstacle
+ * @param height The height of the obstacle
+ * @param obstacle_increasement Enable obstacle increasement?
+ * @return obstacle
+ */
+inline ColliFastObstacle *
+ColliObstacleMap::obstacle(int width, int height, bool obstacle_increasement)
 {
 	unsigned int key = ((unsigned int)width << 16) | (unsigned int)height;
 
@@ -83,11 +113,11 @@ ColliObstacleMap::get_obstacle(int width, int height, bool obstacle_increasement
 			obstacle = new ColliFastEllipse(width, height, cell_costs_, obstacle_increasement);
 		obstacle->set_key(key);
 		obstacles_[key] = obstacle;
-		return obstacle->get_obstacle();
+		return obstacle;
 
 	} else {
 		// obstacle found in p (previously created obstacles)
-		return obstacles_[key]->get_obstacle();
+		return p->second;
 	}
 }
 
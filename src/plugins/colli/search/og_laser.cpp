@@ -33,7 +33,12 @@
 #include <utils/math/coord.h>
 #include <utils/time/clock.h>
 
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#ifdef __SSE__
+#	include <xmmintrin.h>
+#endif
 
 namespace fawkes {
 
@@ -137,6 +142,9 @@ LaserOccupancyGrid::LaserOccupancyGrid(Laser360Interface *laser,
 	robo_shape_.reset(new RoboShapeColli((cfg_prefix + "roboshape/").c_str(), logger, config));
 	old_readings_.clear();
 	init_grid();
+	grid_valid_     = false;
+	stamped_width_  = width_;
+	stamped_height_ = height_;
 
 	logger->log_debug("LaserOccupancyGrid", "Generating obstacle map");
 	bool obstacle_shape = robo_shape_->is_angular_robot() && !cfg_force_elipse_obstacle_;
@@ -389,10 +397,6 @@ LaserOccupancyGrid::update_occ_grid(int midX, int midY, float inc, float vx, flo
 	laser_pos_.x = midX;
 	laser_pos_.y = midY;
 
-	for (int y = 0; y < width_; ++y)
-		for (int x = 0; x < height_; ++x)
-			occupancy_probs_[x][y] = cell_costs_.free;
-
 	update_laser();
 
 	tf::StampedTransform transform;
@@ -405,11 +409,15 @@ LaserOccupancyGrid::update_occ_grid(int midX, int midY, float inc, float vx, flo
 		                   "Unable to transform %s to %s. Can't put obstacles into the grid",
 		                   reference_frame_.c_str(),
 		                   laser_frame_.c_str());
+		std::fill(occupancy_probs_.begin(), occupancy_probs_.end(), cell_costs_.free);
+		grid_valid_ = false;
 		return 0.;
 	}
 
+	stamps_.clear();
 	integrate_old_readings(midX, midY, inc, vel, transform);
 	integrate_new_readings(midX, midY, inc, vel, transform);
+	stamp_obstacles();
 
 	return next_obstacle;
 }
@@ -587,26 +595,139 @@ LaserOccupancyGrid::integrate_new_readings(int                   midX,
 	delete pointsTransformed;
 }
 
+/** Take the cell-wise maximum of grid cells and obstacle costs.
+ * @param cells first grid cell to update
+ * @param costs obstacle costs
+ * @param num number of cells to update
+ */
+static inline void
+max_blend(Probability *cells, const float *costs, int num)
+{
+	int i = 0;
+#ifdef __SSE__
+	for (; i + 4 <= num; i += 4) {
+		_mm_storeu_ps(cells + i, _mm_max_ps(_mm_loadu_ps(cells + i), _mm_loadu_ps(costs + i)));
+	}
+#endif
+	for (; i < num; ++i) {
+		if (cells[i] < costs[i])
+			cells[i] = costs[i];
+	}
+}
+
 void
 LaserOccupancyGrid::integrate_obstacle(int x, int y, int width, int height)
 {
-	std::vector<int> fast_obstacle = obstacle_map_->get_obstacle(width, height, cfg_obstacle_inc_);
-
-	// i = x offset, i+1 = y offset, i+2 is cost
-	for (unsigned int i = 0; i < fast_obstacle.size(); i += 3) {
-		/* On the laser-points, we draw obstacles based on base_link. The obstacle has the robot-shape,
-     * which means that we need to rotate the shape 180° around base_link and move that rotation-
-     * point onto the laser-point on the grid. That's the same as adding the center_to_base_offset
-     * to the calculated position of the obstacle-center ("x + fast_obstacle[i]" and "y" respectively).
-     */
-		int posX = x + fast_obstacle[i] + offset_base_.x;
-		int posY = y + fast_obstacle[i + 1] + offset_base_.y;
-
-		if ((posX > 0) && (posX < height_) && (posY > 0) && (posY < width_)
-		    && (occupancy_probs_[posX][posY] < fast_obstacle[i + 2])) {
-			occupancy_probs_[posX][posY] = fast_obstacle[i + 2];
+	/* On the laser-points, we draw obstacles based on base_link. The obstacle has the robot-shape,
+   * which means that we need to rotate the shape 180° around base_link and move that rotation-
+   * point onto the laser-point on the grid. That's the same as adding the center_to_base_offset
+   * to the calculated position of the obstacle-center ("x + fast_obstacle[i]" and "y" respectively).
+   */
+	ObstacleStamp stamp;
+	stamp.x       = x + offset_base_.x;
+	stamp.y       = y + offset_base_.y;
+	stamp.stencil = &obstacle_map_->get_stencil(width, height, cfg_obstacle_inc_);
+	stamps_.push_back(stamp);
+}
+
+/** Stamp a single obstacle into the grid.
+ * Only cells within the given rectangle are updated.
+ * @param stamp obstacle to stamp
+ * @param x_min minimum x coordinate of cells to update
+ * @param y_min minimum y coordinate of cells to update
+ * @param x_max maximum x coordinate of cells to update plus one
+ * @param y_max maximum y coordinate of cells to update plus one
+ */
+void
+LaserOccupancyGrid::stamp_obstacle(const ObstacleStamp &stamp,
+                                   int                  x_min,
+                                   int                  y_min,
+                                   int                  x_max,
+                                   int                  y_max)
+{
+	const colli_obstacle_stencil_t &stencil = *stamp.stencil;
+
+	int x_start = stamp.x + stencil.x_min;
+	int y_start = stamp.y + stencil.y_min;
+	int x_begin = std::max(x_min, x_start);
+	int x_end   = std::min(x_max, x_start + stencil.num_rows);
+	int y_begin = std::max(y_min, y_start);
+	int y_end   = std::min(y_max, y_start + stencil.row_length);
+	if (x_begin >= x_end || y_begin >= y_end)
+		return;
+
+	for (int x = x_begin; x < x_end; ++x) {
+		max_blend(&occupancy_probs_[x * stride_ + y_begin],
+		          &stencil.costs[(x - x_start) * stencil.row_length + (y_begin - y_start)],
+		          y_end - y_begin);
+	}
+}
+
+/** Stamp the obstacles of the current update into the grid.
+ * The grid is only updated where obstacles have been added or removed
+ * since the last update. If the obstacles did not change at all, for
+ * example while the robot is standing still, the grid is not touched.
+ */
+void
+LaserOccupancyGrid::stamp_obstacles()
+{
+	// multiple readings often result in the very same obstacle
+	std::sort(stamps_.begin(), stamps_.end());
+	stamps_.erase(std::unique(stamps_.begin(), stamps_.end()), stamps_.end());
+
+	if (stamped_width_ != width_ || stamped_height_ != height_) {
+		// grid has been re-initialized
+		grid_valid_ = false;
+	}
+
+	// obstacles are never drawn on the first row and column of the grid
+	int x_min = 1, y_min = 1, x_max = height_, y_max = width_;
+
+	if (grid_valid_) {
+		if (stamps_ == stamped_)
+			return;
+
+		// only update the bounding box of all added and removed obstacles
+		changed_stamps_.clear();
+		std::set_symmetric_difference(stamped_.begin(),
+		                              stamped_.end(),
+		                              stamps_.begin(),
+		                              stamps_.end(),
+		                              std::back_inserter(changed_stamps_));
+		int cx_min = x_max, cy_min = y_max, cx_max = x_min, cy_max = y_min;
+		for (const ObstacleStamp &s : changed_stamps_) {
+			cx_min = std::min(cx_min, s.x + s.stencil->x_min);
+			cy_min = std::min(cy_min, s.y + s.stencil->y_min);
+			cx_max = std::max(cx_max, s.x + s.stencil->x_min + s.stencil->num_rows);
+			cy_max = std::max(cy_max, s.y + s.stencil->y_min + s.stencil->row_length);
 		}
+		x_min = std::max(x_min, cx_min);
+		y_min = std::max(y_min, cy_min);
+		x_max = std::min(x_max, cx_max);
+		y_max = std::min(y_max, cy_max);
+		if (x_min >= x_max || y_min >= y_max) {
+			// changes only outside of the area obstacles are drawn on
+			stamped_.swap(stamps_);
+			return;
+		}
+
+		for (int x = x_min; x < x_max; ++x) {
+			std::fill(occupancy_probs_.begin() + x * stride_ + y_min,
+			          occupancy_probs_.begin() + x * stride_ + y_max,
+			          cell_costs_.free);
+		}
+	} else {
+		std::fill(occupancy_probs_.begin(), occupancy_probs_.end(), cell_costs_.free);
 	}
+
+	for (const ObstacleStamp &s : stamps_) {
+		stamp_obstacle(s, x_min, y_min, x_max, y_max);
+	}
+
+	stamped_.swap(stamps_);
+	stamped_width_  = width_;
+	stamped_height_ = height_;
+	grid_valid_     = true;
 }
 
 } // namespace fawkes
@@ -26,6 +26,7 @@
 
 #include "../common/types.h"
 #include "../utils/occupancygrid/occupancygrid.h"
+#include "obstacle.h"
 
 #include <tf/transformer.h>
 #include <utils/math/types.h>
@@ -92,6 +93,35 @@ private:
 		//    }
 	};
 
+	/** Obstacle stamped into the grid at a cell. */
+	class ObstacleStamp
+	{
+	public:
+		int                             x;       /**< x coordinate of the obstacle center */
+		int                             y;       /**< y coordinate of the obstacle center */
+		const colli_obstacle_stencil_t *stencil; /**< stencil of the obstacle */
+
+		/** Less than operator.
+		 * @param o other stamp to compare to
+		 * @return true if this stamp is ordered before @p o
+		 */
+		bool
+		operator<(const ObstacleStamp &o) const
+		{
+			return (x != o.x) ? (x < o.x) : (y != o.y) ? (y < o.y) : (stencil < o.stencil);
+		}
+
+		/** Equality operator.
+		 * @param o other stamp to compare to
+		 * @return true if both stamps are the same
+		 */
+		bool
+		operator==(const ObstacleStamp &o) const
+		{
+			return x == o.x && y == o.y && stencil == o.stencil;
+		}
+	};
+
 	void update_laser();
 
 	float obstacle_in_path_distance(float vx, float vy);
@@ -123,6 +153,9 @@ private:
    */
 	void integrate_obstacle(int x, int y, int width, int height);
 
+	void stamp_obstacles();
+	void stamp_obstacle(const ObstacleStamp &stamp, int x_min, int y_min, int x_max, int y_max);
+
 	tf::Transformer *tf_listener_;
 	std::string      reference_frame_;
 	std::string      laser_frame_;
@@ -136,6 +169,13 @@ private:
 	std::vector<LaserPoint> new_readings_;
 	std::vector<LaserPoint> old_readings_; /**< readings history */
 
+	std::vector<ObstacleStamp> stamps_;         /**< obstacles of the current update */
+	std::vector<ObstacleStamp> stamped_;        /**< obstacles currently in the grid */
+	std::vector<ObstacleStamp> changed_stamps_; /**< obstacles added or removed */
+	bool                       grid_valid_;     /**< grid contains exactly stamped_ */
+	int                        stamped_width_;  /**< grid width when stamped_ was stamped */
+	int                        stamped_height_; /**< grid height when stamped_ was stamped */
+
 	point_t laser_pos_; /**< the laser's position in the grid */
 
 	/** Costs for the cells in grid */
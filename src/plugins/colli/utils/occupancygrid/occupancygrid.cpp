@@ -22,6 +22,8 @@
 
 #include "occupancygrid.h"
 
+#include <algorithm>
+
 namespace fawkes {
 
 /** @class OccupancyGrid <plugins/colli/utils/occupancygrid/occupancygrid.h>
@@ -29,6 +31,11 @@ namespace fawkes {
  * exist, which are usually used instead of this general class.
  * Note: the coord system is assumed to map x onto width an y onto
  * height, with x being the first coordinate !
+ *
+ * The cells are stored in a single contiguous array. All cells with
+ * the same x coordinate form a row. Rows are padded to a multiple of
+ * four cells, such that each row starts 16 byte aligned and can be
+ * processed with SIMD instructions.
  */
 
 /** Constructs an empty occupancy grid
@@ -90,6 +97,17 @@ OccupancyGrid::get_height()
 	return height_;
 }
 
+/** Get the number of cells stored per row.
+ * A row contains all cells with the same x coordinate, it is padded
+ * for alignment and may be larger than the height of the grid.
+ * @return the number of cells from one row to the next
+ */
+int
+OccupancyGrid::get_stride()
+{
+	return stride_;
+}
+
 /** Resets the cell width
  * @param width the width of the cells in cm
  */
@@ -137,7 +155,7 @@ void
 OccupancyGrid::set_prob(int x, int y, Probability prob)
 {
 	if ((x < width_) && (y < height_) && ((isProb(prob)) || (prob == 2.f)))
-		occupancy_probs_[x][y] = prob;
+		occupancy_probs_[x * stride_ + y] = prob;
 }
 
 /** Resets all occupancy probabilities
@@ -147,11 +165,7 @@ void
 OccupancyGrid::fill(Probability prob)
 {
 	if ((isProb(prob)) || (prob == -1.f)) {
-		for (int x = 0; x < width_; x++) {
-			for (int y = 0; y < height_; y++) {
-				occupancy_probs_[x][y] = prob;
-			}
-		}
+		std::fill(occupancy_probs_.begin(), occupancy_probs_.end(), prob);
 	}
 }
 
@@ -164,7 +178,7 @@ Probability
 OccupancyGrid::get_prob(int x, int y)
 {
 	if ((x >= 0) && (x < width_) && (y >= 0) && (y < height_)) {
-		return occupancy_probs_[x][y];
+		return occupancy_probs_[x * stride_ + y];
 	} else {
 		return 1;
 	}
@@ -178,18 +192,16 @@ OccupancyGrid::get_prob(int x, int y)
 Probability &
 OccupancyGrid::operator()(const int x, const int y)
 {
-	return occupancy_probs_[x][y];
+	return occupancy_probs_[x * stride_ + y];
 }
 
 /** Init a new empty grid with the predefined parameters */
 void
 OccupancyGrid::init_grid()
 {
+	stride_ = (height_ + 3) & ~3;
 	occupancy_probs_.clear();
-	std::vector<Probability> column;
-	column.resize(height_, 0.f);
-	occupancy_probs_.resize(width_, column);
-	fill(0.f);
+	occupancy_probs_.resize(width_ * stride_, 0.f);
 }
 
 } // namespace fawkes
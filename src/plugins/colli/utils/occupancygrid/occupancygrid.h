@@ -50,6 +50,9 @@ public:
 	///\brief Get the height of the grid
 	int get_height();
 
+	///\brief Get the number of cells stored per row of the grid
+	int get_stride();
+
 	///\brief Resets the cell width (in cm)
 	void set_cell_width(int cell_width);
 
@@ -77,14 +80,16 @@ public:
 	///\brief Init a new empty grid with the predefined parameters */
 	void init_grid();
 
-	/// The occupancy probability of the cells in a 2D array
-	std::vector<std::vector<Probability>> occupancy_probs_;
+	/// The occupancy probability of the cells, stored contiguously row by row.
+	/// Cell (x,y) is at index x * get_stride() + y.
+	std::vector<Probability> occupancy_probs_;
 
 protected:
 	int cell_width_;  /**< Cell width in cm */
 	int cell_height_; /**< Cell height in cm */
 	int width_;       /**< Width of the grid in # cells */
 	int height_;      /**< Height of the grid in # cells */
+	int stride_;      /**< Number of cells stored per row, padded for alignment */
 };
 
 } // namespace fawkes
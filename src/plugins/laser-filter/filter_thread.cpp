@@ -45,6 +45,8 @@
 #include <interfaces/Laser720Interface.h>
 #include <utils/time/time.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <memory>
@@ -129,6 +131,13 @@ LaserFilterThread::init()
 			LaserDataFilterCascade *cascade =
 			  new LaserDataFilterCascade(cfg_name_, in_[0].size, in_bufs_);
 
+			bool fused = false;
+			try {
+				fused = config->get_bool((cfg_prefix_ + "fused").c_str());
+			} catch (Exception &e) {
+			} // ignored, use default
+			cascade->set_fused(fused);
+
 			try {
 				std::map<std::string, std::string>::iterator f;
 				for (f = filters.begin(); f != filters.end(); ++f) {
@@ -152,24 +161,36 @@ LaserFilterThread::init()
 			filter_ = cascade;
 		}
 
-		if (out_[0].size != filter_->get_out_data_size()) {
-			Exception e("Output interface and filter data size for %s do not match (%u != %u)",
-			            cfg_name_.c_str(),
-			            out_[0].size,
-			            filter_->get_out_data_size());
-			delete filter_;
-			throw e;
+		for (unsigned int i = 0; i < out_.size(); ++i) {
+			if (out_[i].size == 0) {
+				// shared memory laser buffer, any size
+				out_[i].size = filter_->get_out_data_size();
+				logger->log_debug(name(),
+				                  "Opening writing SharedMemoryLaserBuffer::%s (%u values)",
+				                  out_[i].id.c_str(),
+				                  out_[i].size);
+				try {
+					out_[i].shm          = new SharedMemoryLaserBuffer(out_[i].id.c_str(), out_[i].size, 4);
+					out_bufs_[i]->values = out_[i].shm->begin_write();
+				} catch (Exception &e) {
+					delete filter_;
+					throw;
+				}
+			} else if (out_[i].size != filter_->get_out_data_size()) {
+				Exception e("Output interface and filter data size for %s do not match (%u != %u)",
+				            cfg_name_.c_str(),
+				            out_[i].size,
+				            filter_->get_out_data_size());
+				delete filter_;
+				throw e;
+			}
 		}
 
 		filter_->set_out_vector(out_bufs_);
 
 	} catch (Exception &e) {
-		for (unsigned int i = 0; i < in_.size(); ++i) {
-			blackboard->close(in_[i].interface);
-		}
-		for (unsigned int i = 0; i < out_.size(); ++i) {
-			blackboard->close(out_[i].interface);
-		}
+		close_interfaces(in_);
+		close_interfaces(out_);
 		throw;
 	}
 
@@ -190,14 +211,8 @@ LaserFilterThread::finalize()
 	delete wait_cond_;
 	delete wait_mutex_;
 
-	for (unsigned int i = 0; i < in_.size(); ++i) {
-		blackboard->close(in_[i].interface);
-	}
-	in_.clear();
-	for (unsigned int i = 0; i < out_.size(); ++i) {
-		blackboard->close(out_[i].interface);
-	}
-	out_.clear();
+	close_interfaces(in_);
+	close_interfaces(out_);
 }
 
 void
@@ -211,9 +226,37 @@ LaserFilterThread::loop()
 		}
 	}
 
-	// Read input interfaces
-	const size_t in_num = in_.size();
+	// Read input interfaces, shared memory buffers are used in place.
+	// The writer sets values after the end of shorter scans to NaN, hence
+	// the filters set up for the maximum number of values can be used.
+	bool         valid       = true;
+	bool         new_data    = false;
+	unsigned int in_values   = 0;
+	unsigned int in_max_size = 0;
+	const size_t in_num      = in_.size();
 	for (size_t i = 0; i != in_num; ++i) {
+		if (in_[i].shm) {
+			SharedMemoryLaserBuffer::Scan &scan = in_[i].scan;
+			if (!in_[i].shm->read_latest(scan)) {
+				// no data, yet
+				valid = false;
+				continue;
+			}
+			if (scan.seq != in_[i].last_seq) {
+				new_data = true;
+			}
+			in_bufs_[i]->values          = const_cast<float *>(scan.values);
+			in_bufs_[i]->frame           = scan.frame_id;
+			in_bufs_[i]->angle_min       = scan.angle_min;
+			in_bufs_[i]->angle_increment = scan.angle_increment;
+			*in_bufs_[i]->timestamp      = scan.timestamp;
+			in_values   = std::max(in_values, scan.num_values);
+			in_max_size = std::max(in_max_size, in_[i].size);
+			continue;
+		}
+
+		// blackboard inputs are filtered in every loop
+		new_data = true;
 		in_[i].interface->read();
 		if (in_[i].size == 360) {
 			in_bufs_[i]->frame      = in_[i].interface_typed.as360->frame();
@@ -228,16 +271,53 @@ LaserFilterThread::loop()
 	}
 
 	// Filter!
-	try {
-		filter_->filter();
-	} catch (Exception &e) {
-		logger->log_warn(name(), "Filtering failed, exception follows");
-		logger->log_warn(name(), e);
+	valid = valid && new_data;
+	if (valid) {
+		try {
+			filter_->filter();
+		} catch (Exception &e) {
+			logger->log_warn(name(), "Filtering failed, exception follows");
+			logger->log_warn(name(), e);
+		}
+
+		for (size_t i = 0; i != in_num; ++i) {
+			if (in_[i].shm && !in_[i].shm->is_valid(in_[i].scan)) {
+				logger->log_warn(name(),
+				                 "SharedMemoryLaserBuffer::%s overwritten while filtering, "
+				                 "dropping result",
+				                 in_[i].id.c_str());
+				valid = false;
+			}
+		}
+		if (valid) {
+			for (size_t i = 0; i != in_num; ++i) {
+				if (in_[i].shm) {
+					in_[i].last_seq = in_[i].scan.seq;
+				}
+			}
+		}
 	}
 
 	// Write output interfaces
-	const size_t num = out_.size();
+	const size_t num = valid ? out_.size() : 0;
 	for (size_t i = 0; i < num; ++i) {
+		if (out_[i].shm) {
+			// padded values are not published, the scan keeps its length
+			// relative to the input buffers
+			unsigned int out_values = out_[i].size;
+			if (in_max_size > 0 && in_values < in_max_size) {
+				out_values = (unsigned int)((uint64_t)out_[i].size * in_values / in_max_size);
+			}
+			out_[i].shm->end_write(out_values,
+			                       out_bufs_[i]->angle_min,
+			                       out_bufs_[i]->angle_increment,
+			                       out_bufs_[i]->frame.c_str(),
+			                       out_bufs_[i]->timestamp);
+			// filter directly into the next slot
+			out_bufs_[i]->values = out_[i].shm->begin_write();
+			continue;
+		}
+
 		if (out_[i].size == 360) {
 			out_[i].interface_typed.as360->set_timestamp(out_bufs_[i]->timestamp);
 			out_[i].interface_typed.as360->set_frame(out_bufs_[i]->frame.c_str());
@@ -304,8 +384,13 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 
 			LaserInterface lif;
 			lif.interface = NULL;
+			lif.shm       = NULL;
+			lif.last_seq  = 0;
 
-			if (type == "Laser360Interface") {
+			if (type == "SharedMemoryLaserBuffer") {
+				// size is determined by the buffer or the filter
+				lif.size = 0;
+			} else if (type == "Laser360Interface") {
 				lif.size = 360;
 			} else if (type == "Laser720Interface") {
 				lif.size = 720;
@@ -313,8 +398,8 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 				lif.size = 1080;
 			} else {
 				throw Exception("Interfaces must be of type Laser360Interface, "
-				                "Laser720Interface, or Laser1080Interface, "
-				                "but it is '%s'",
+				                "Laser720Interface, Laser1080Interface, or "
+				                "SharedMemoryLaserBuffer, but it is '%s'",
 				                type.c_str());
 			}
 
@@ -329,16 +414,24 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 
 	bufs.resize(ifs.size());
 
-	unsigned int req_size = ifs[0].size;
+	unsigned int req_size = 0;
 
 	try {
 		if (writing) {
 			for (unsigned int i = 0; i < ifs.size(); ++i) {
-				if (req_size != ifs[i].size) {
-					throw Exception("Interfaces of mixed sizes for %s", cfg_name_.c_str());
+				if (ifs[i].size != 0) {
+					if (req_size != 0 && req_size != ifs[i].size) {
+						throw Exception("Interfaces of mixed sizes for %s", cfg_name_.c_str());
+					}
+					req_size = ifs[i].size;
 				}
 
-				if (ifs[i].size == 360) {
+				if (ifs[i].size == 0) {
+					// opened once the output size of the filter is known
+					bufs[i]       = new LaserDataFilter::Buffer();
+					bufs[i]->name = "SharedMemoryLaserBuffer::" + ifs[i].id;
+
+				} else if (ifs[i].size == 360) {
 					logger->log_debug(name(), "Opening writing Laser360Interface::%s", ifs[i].id.c_str());
 					Laser360Interface *laser360 =
 					  blackboard->open_for_writing<Laser360Interface>(ifs[i].id.c_str());
@@ -380,7 +473,16 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 			}
 		} else {
 			for (unsigned int i = 0; i < ifs.size(); ++i) {
-				if (ifs[i].size == 360) {
+				if (ifs[i].size == 0) {
+					logger->log_debug(name(),
+					                  "Opening reading SharedMemoryLaserBuffer::%s",
+					                  ifs[i].id.c_str());
+					ifs[i].shm    = new SharedMemoryLaserBuffer(ifs[i].id.c_str());
+					ifs[i].size   = ifs[i].shm->max_num_values();
+					bufs[i]       = new LaserDataFilter::Buffer();
+					bufs[i]->name = "SharedMemoryLaserBuffer::" + ifs[i].id;
+
+				} else if (ifs[i].size == 360) {
 					logger->log_debug(name(), "Opening reading Laser360Interface::%s", ifs[i].id.c_str());
 					Laser360Interface *laser360 =
 					  blackboard->open_for_reading<Laser360Interface>(ifs[i].id.c_str());
@@ -418,16 +520,31 @@ LaserFilterThread::open_interfaces(std::string                             prefi
 				}
 			}
 		}
-	} catch (Exception &e) {
+
+		// interface data covers a full circle
 		for (unsigned int i = 0; i < ifs.size(); ++i) {
-			blackboard->close(ifs[i].interface);
+			if (ifs[i].interface) {
+				bufs[i]->angle_min       = 0.;
+				bufs[i]->angle_increment = 2 * M_PI / ifs[i].size;
+			}
 		}
-		ifs.clear();
+	} catch (Exception &e) {
+		close_interfaces(ifs);
 		bufs.clear();
 		throw;
 	}
 }
 
+void
+LaserFilterThread::close_interfaces(std::vector<LaserInterface> &ifs)
+{
+	for (unsigned int i = 0; i < ifs.size(); ++i) {
+		blackboard->close(ifs[i].interface);
+		delete ifs[i].shm;
+	}
+	ifs.clear();
+}
+
 LaserDataFilter *
 LaserFilterThread::create_filter(std::string                             filter_name,
                                  std::string                             filter_type,
@@ -30,6 +30,7 @@
 #include <aspect/configurable.h>
 #include <aspect/logging.h>
 #include <core/threading/thread.h>
+#include <utils/ipc/shm_laser.h>
 #ifdef HAVE_TF
 #	include <aspect/tf.h>
 #endif
@@ -76,7 +77,10 @@ private:
 			fawkes::Laser720Interface * as720;
 			fawkes::Laser1080Interface *as1080;
 		} interface_typed;
-		fawkes::Interface *interface;
+		fawkes::Interface *                   interface;
+		fawkes::SharedMemoryLaserBuffer *     shm;
+		fawkes::SharedMemoryLaserBuffer::Scan scan;
+		uint64_t                              last_seq;
 	} LaserInterface;
 	/// @endcond
 
@@ -85,6 +89,8 @@ private:
 	                     std::vector<LaserDataFilter::Buffer *> &bufs,
 	                     bool                                    writing);
 
+	void close_interfaces(std::vector<LaserInterface> &ifs);
+
 	LaserDataFilter *create_filter(std::string                             filter_name,
 	                               std::string                             filter_type,
 	                               std::string                             prefix,
@@ -58,7 +58,9 @@ Laser1080to360DataFilter::filter()
 {
 	const unsigned int vecsize = std::min(in.size(), out.size());
 	for (unsigned int a = 0; a < vecsize; ++a) {
-		out[a]->frame = in[a]->frame;
+		out[a]->frame           = in[a]->frame;
+		out[a]->angle_min       = in[a]->angle_min;
+		out[a]->angle_increment = in[a]->angle_increment * 3;
 		out[a]->timestamp->set_time(in[a]->timestamp);
 		float *inbuf  = in[a]->values;
 		float *outbuf = out[a]->values;
@@ -120,6 +120,26 @@ LaserBoxFilterDataFilter::dot(LaserBoxFilterDataFilter::Vector u,
 
 void
 LaserBoxFilterDataFilter::filter()
+{
+	filter_by_in_place();
+}
+
+/** Check if filter can operate in place.
+ * @return true
+ */
+bool
+LaserBoxFilterDataFilter::supports_in_place() const
+{
+	return true;
+}
+
+/** Prepare filtering of a new set of scans.
+ * Processes new boxes and looks up the transforms of the scans to the map.
+ * @param bufs buffers which are about to be filtered
+ * @return true if all transforms could be determined, false otherwise
+ */
+bool
+LaserBoxFilterDataFilter::prepare_in_place(const std::vector<Buffer *> &bufs)
 {
 	while (!box_filter_if_->msgq_empty()) {
 		if (box_filter_if_->msgq_first_is<LaserBoxFilterInterface::CreateNewBoxFilterMessage>()) {
@@ -143,57 +163,65 @@ LaserBoxFilterDataFilter::filter()
 		box_filter_if_->msgq_pop();
 	}
 
-	const unsigned int vecsize = in.size();
-	if (vecsize == 0)
-		return;
-
-	for (unsigned int a = 0; a < vecsize; ++a) {
+	transforms_.resize(bufs.size());
+	angle_min_.resize(bufs.size());
+	angle_increment_.resize(bufs.size());
+	for (unsigned int a = 0; a < bufs.size(); ++a) {
 		// get tf to map of laser input
-		fawkes::tf::StampedTransform transform;
 		try {
 			tf_listener_->lookup_transform(frame_map_.c_str(),
-			                               in[a]->frame,
-			                               *(in[a]->timestamp),
-			                               transform);
+			                               bufs[a]->frame,
+			                               *(bufs[a]->timestamp),
+			                               transforms_[a]);
 		} catch (fawkes::tf::TransformException &e) {
 			try {
 				tf_listener_->lookup_transform(frame_map_.c_str(),
-				                               in[a]->frame,
+				                               bufs[a]->frame,
 				                               fawkes::Time(0, 0),
-				                               transform);
+				                               transforms_[a]);
 			} catch (fawkes::tf::TransformException &e) {
 				logger_->log_warn("box_filter",
 				                  "Can't transform laser-data (%s -> %s)",
 				                  frame_map_.c_str(),
-				                  in[a]->frame.c_str());
-				return;
+				                  bufs[a]->frame.c_str());
+				return false;
 			}
 		}
-		// set out meta info
-		out[a]->frame     = in[a]->frame;
-		out[a]->timestamp = in[a]->timestamp;
-		// for each point
-		for (unsigned int i = 0; i < out_data_size; ++i) {
-			bool add = true;
-			// check nan
-			if (std::isfinite(in[a]->values[i])) {
-				// transform to cartesian
-				double angle = M_PI * (360.f / out_data_size * i) / 180;
-
-				float x, y;
-				fawkes::polar2cart2d(angle, in[a]->values[i], &x, &y);
-
-				// transform into map
-				fawkes::tf::Point p;
-				p.setValue(x, y, 0.);
-				p = transform * p;
-
-				add = !point_in_rectangle(p.getX(), p.getY());
-			}
-			if (add) {
-				out[a]->values[i] = in[a]->values[i];
-			} else {
-				out[a]->values[i] = std::numeric_limits<float>::quiet_NaN();
+		angle_min_[a]       = bufs[a]->angle_min;
+		angle_increment_[a] = bufs[a]->angle_increment;
+	}
+
+	return !boxes_.empty();
+}
+
+/** Filter a range of values in place.
+ * @param a index of the buffer
+ * @param values values of the buffer
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserBoxFilterDataFilter::filter_in_place(unsigned int a,
+                                          float *      values,
+                                          unsigned int begin,
+                                          unsigned int end)
+{
+	for (unsigned int i = begin; i < end; ++i) {
+		// check nan
+		if (std::isfinite(values[i])) {
+			// transform to cartesian
+			double angle = angle_min_[a] + i * angle_increment_[a];
+
+			float x, y;
+			fawkes::polar2cart2d(angle, values[i], &x, &y);
+
+			// transform into map
+			fawkes::tf::Point p;
+			p.setValue(x, y, 0.);
+			p = transforms_[a] * p;
+
+			if (point_in_rectangle(p.getX(), p.getY())) {
+				values[i] = std::numeric_limits<float>::quiet_NaN();
 			}
 		}
 	}
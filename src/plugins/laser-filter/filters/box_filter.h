@@ -68,8 +68,18 @@ public:
 
 	virtual void filter();
 
+	virtual bool supports_in_place() const;
+	virtual bool prepare_in_place(const std::vector<Buffer *> &bufs);
+	virtual void filter_in_place(unsigned int a,
+	                             float *      values,
+	                             unsigned int begin,
+	                             unsigned int end);
+
 private:
-	std::vector<Box> boxes_;
+	std::vector<Box>                          boxes_;
+	std::vector<fawkes::tf::StampedTransform> transforms_;
+	std::vector<float>                        angle_min_;
+	std::vector<float>                        angle_increment_;
 	bool             point_in_rectangle(float x, float y);
 	Vector           d_vec(Vector p1, Vector p2);
 	inline double    dot(Vector u, Vector v);
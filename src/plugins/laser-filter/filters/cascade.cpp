@@ -22,9 +22,26 @@
 
 #include "cascade.h"
 
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cstring>
+
+/** Number of values processed by all fused filters at once.
+ * Small enough to keep the values in the L1 cache while running all
+ * filters of a fused stage on them. */
+#define FUSED_BLOCK_SIZE 128
+
 /** @class LaserDataFilterCascade "filters/cascade.h"
  * Cascade of several laser filters to one.
  * The filters are executed in the order they are added to the cascade.
+ *
+ * In fused mode consecutive filters which support in place filtering
+ * (cf. LaserDataFilter::supports_in_place()) are combined into a single
+ * stage. The values are copied once from the input to the output of the
+ * stage, block by block, and all filters of the stage process a block
+ * while it is still in the cache. The output buffers of all but the last
+ * filter of a fused stage are not written in this mode.
  * @author Tim Niemueller
  */
 
@@ -40,6 +57,7 @@ LaserDataFilterCascade::LaserDataFilterCascade(const std::string &    filter_nam
 {
 	out_data_size = in_data_size;
 	out           = in;
+	fused_        = false;
 	set_array_ownership(false, false);
 }
 
@@ -60,6 +78,7 @@ LaserDataFilterCascade::set_out_vector(std::vector<LaserDataFilter::Buffer *> &o
 {
 	filters_.back()->set_out_vector(out);
 	this->out = filters_.back()->get_out_vector();
+	update_stages();
 }
 
 /** Add a filter to the cascade.
@@ -71,6 +90,7 @@ LaserDataFilterCascade::add_filter(LaserDataFilter *filter)
 	filters_.push_back(filter);
 	out_data_size = filter->get_out_data_size();
 	out           = filter->get_out_vector();
+	update_stages();
 }
 
 /** Remove a filter from the cascade.
@@ -80,6 +100,7 @@ void
 LaserDataFilterCascade::remove_filter(LaserDataFilter *filter)
 {
 	filters_.remove(filter);
+	update_stages();
 }
 
 /** Delete all filters. */
@@ -90,12 +111,107 @@ LaserDataFilterCascade::delete_filters()
 		delete *fit_;
 	}
 	filters_.clear();
+	stages_.clear();
 }
 
+/** Enable or disable fused filtering.
+ * @param fused true to fuse consecutive in place filters into a single
+ * pass over the values, false to run each filter on its own
+ */
 void
-LaserDataFilterCascade::filter()
+LaserDataFilterCascade::set_fused(bool fused)
+{
+	fused_ = fused;
+	update_stages();
+}
+
+/** Group filters into stages.
+ * A stage is either a single filter which is run as is, or a number of
+ * consecutive in place filters which are fused.
+ */
+void
+LaserDataFilterCascade::update_stages()
 {
+	stages_.clear();
+	if (!fused_)
+		return;
+
+	LaserDataFilter *prev = NULL;
 	for (fit_ = filters_.begin(); fit_ != filters_.end(); ++fit_) {
-		(*fit_)->filter();
+		const std::vector<Buffer *> &fin      = prev ? prev->get_out_vector() : in;
+		const unsigned int           fin_size = prev ? prev->get_out_data_size() : in_data_size;
+
+		bool in_place = (*fit_)->supports_in_place() && (*fit_)->get_out_vector().size() == fin.size()
+		                && (*fit_)->get_out_data_size() == fin_size;
+
+		if (in_place && !stages_.empty() && stages_.back().fused) {
+			stages_.back().filters.push_back(*fit_);
+		} else {
+			Stage s;
+			s.prev  = prev;
+			s.fused = in_place;
+			s.filters.push_back(*fit_);
+			stages_.push_back(s);
+		}
+		prev = *fit_;
+	}
+}
+
+/** Run fused in place filters.
+ * @param prev filter providing the input, NULL for the cascade input
+ * @param filters filters to run in place on the output of the last filter
+ */
+void
+LaserDataFilterCascade::filter_fused(LaserDataFilter *                prev,
+                                     std::vector<LaserDataFilter *> &filters)
+{
+	std::vector<Buffer *> &sin       = prev ? prev->get_out_vector() : in;
+	std::vector<Buffer *> &sout      = filters.back()->get_out_vector();
+	const unsigned int     data_size = filters.back()->get_out_data_size();
+	const unsigned int     vecsize   = std::min(sin.size(), sout.size());
+
+	prepared_.resize(filters.size());
+	for (unsigned int f = 0; f < filters.size(); ++f) {
+		prepared_[f] = filters[f]->prepare_in_place(sin);
+	}
+
+	for (unsigned int a = 0; a < vecsize; ++a) {
+		sout[a]->frame           = sin[a]->frame;
+		sout[a]->angle_min       = sin[a]->angle_min;
+		sout[a]->angle_increment = sin[a]->angle_increment;
+		sout[a]->timestamp->set_time(sin[a]->timestamp);
+
+		float *inbuf  = sin[a]->values;
+		float *outbuf = sout[a]->values;
+		for (unsigned int begin = 0; begin < data_size; begin += FUSED_BLOCK_SIZE) {
+			const unsigned int end = std::min(begin + FUSED_BLOCK_SIZE, data_size);
+			if (outbuf != inbuf) {
+				memcpy(&outbuf[begin], &inbuf[begin], (end - begin) * sizeof(float));
+			}
+			for (unsigned int f = 0; f < filters.size(); ++f) {
+				if (prepared_[f]) {
+					filters[f]->filter_in_place(a, outbuf, begin, end);
+				}
+			}
+		}
+	}
+}
+
+void
+LaserDataFilterCascade::filter()
+{
+	if (!fused_) {
+		for (fit_ = filters_.begin(); fit_ != filters_.end(); ++fit_) {
+			(*fit_)->filter();
+		}
+		return;
+	}
+
+	for (unsigned int s = 0; s < stages_.size(); ++s) {
+		if (stages_[s].fused) {
+			filter_fused(stages_[s].prev, stages_[s].filters);
+		} else {
+			stages_[s].filters[0]->filter();
+		}
 	}
 }
@@ -26,6 +26,7 @@
 #include "filter.h"
 
 #include <list>
+#include <vector>
 
 class LaserDataFilterCascade : public LaserDataFilter
 {
@@ -51,6 +52,15 @@ public:
 
 	void filter();
 
+	void set_fused(bool fused);
+	/** Check if fused filtering is enabled.
+   * @return true if consecutive in place filters are fused, false otherwise */
+	bool
+	is_fused() const
+	{
+		return fused_;
+	}
+
 	/** Get filters.
    * @return list of active filters. */
 	const std::list<LaserDataFilter *> &
@@ -59,9 +69,26 @@ public:
 		return filters_;
 	}
 
+private:
+	void update_stages();
+	void filter_fused(LaserDataFilter *prev, std::vector<LaserDataFilter *> &filters);
+
 private:
 	std::list<LaserDataFilter *>           filters_;
 	std::list<LaserDataFilter *>::iterator fit_;
+
+	/// @cond INTERNALS
+	typedef struct
+	{
+		LaserDataFilter *              prev;
+		std::vector<LaserDataFilter *> filters;
+		bool                           fused;
+	} Stage;
+	/// @endcond
+
+	bool               fused_;
+	std::vector<Stage> stages_;
+	std::vector<bool>  prepared_;
 };
 
 #endif
@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 
 using namespace fawkes;
 
@@ -59,27 +60,44 @@ LaserCircleSectorDataFilter::LaserCircleSectorDataFilter(const std::string &filt
 void
 LaserCircleSectorDataFilter::filter()
 {
-	const unsigned int vecsize = std::min(in.size(), out.size());
-	const unsigned int arrsize = std::min(in_data_size, out_data_size);
-	for (unsigned int a = 0; a < vecsize; ++a) {
-		reset_outbuf(out[a]);
-		out[a]->frame = in[a]->frame;
-		out[a]->timestamp->set_time(in[a]->timestamp);
+	filter_by_in_place();
+}
 
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
+/** Check if filter can operate in place.
+ * @return true
+ */
+bool
+LaserCircleSectorDataFilter::supports_in_place() const
+{
+	return true;
+}
 
-		if (from_ > to_) {
-			for (unsigned int i = from_; i < arrsize; ++i) {
-				outbuf[i] = inbuf[i];
-			}
-			for (unsigned int i = 0; i <= std::min(to_, arrsize - 1); ++i) {
-				outbuf[i] = inbuf[i];
-			}
-		} else {
-			for (unsigned int i = from_; i <= std::min(to_, arrsize - 1); ++i) {
-				outbuf[i] = inbuf[i];
-			}
+/** Filter a range of values in place.
+ * @param a index of the buffer
+ * @param values values of the buffer
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserCircleSectorDataFilter::filter_in_place(unsigned int a,
+                                             float *      values,
+                                             unsigned int begin,
+                                             unsigned int end)
+{
+	// erase the values in [lo, hi) which are within [begin, end)
+	auto erase = [values, begin, end](unsigned int lo, unsigned int hi) {
+		lo = std::max(lo, begin);
+		hi = std::min(hi, end);
+		if (lo < hi) {
+			std::fill(values + lo, values + hi, std::numeric_limits<float>::quiet_NaN());
 		}
+	};
+
+	if (from_ > to_) {
+		// sector wraps around
+		erase(to_ + 1, from_);
+	} else {
+		erase(0, from_);
+		erase(to_ + 1, end);
 	}
 }
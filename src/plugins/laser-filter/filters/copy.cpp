@@ -43,15 +43,29 @@ LaserCopyDataFilter::LaserCopyDataFilter(const std::string &    filter_name,
 void
 LaserCopyDataFilter::filter()
 {
-	const unsigned int num_buffers = std::min(in.size(), out.size());
-	const unsigned int data_size   = std::min(in_data_size, out_data_size);
-	for (unsigned int buffer_i = 0; buffer_i < num_buffers; buffer_i++) {
-		out[buffer_i]->frame = in[buffer_i]->frame;
-		out[buffer_i]->timestamp->set_time(in[buffer_i]->timestamp);
-		float *inbuf  = in[buffer_i]->values;
-		float *outbuf = out[buffer_i]->values;
-		for (unsigned int i = 0; i < data_size; i++) {
-			outbuf[i] = inbuf[i];
-		}
-	}
+	filter_by_in_place();
+}
+
+/** Check if filter can operate in place.
+ * @return true
+ */
+bool
+LaserCopyDataFilter::supports_in_place() const
+{
+	return true;
+}
+
+/** Filter a range of values in place.
+ * This is a no-op, the values are already in place.
+ * @param a index of the buffer
+ * @param values values of the buffer
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserCopyDataFilter::filter_in_place(unsigned int a,
+                                     float *      values,
+                                     unsigned int begin,
+                                     unsigned int end)
+{
 }
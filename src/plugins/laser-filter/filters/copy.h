@@ -30,6 +30,12 @@ public:
 	                    unsigned int           in_data_size,
 	                    std::vector<Buffer *> &in);
 	void filter();
+
+	virtual bool supports_in_place() const;
+	virtual void filter_in_place(unsigned int a,
+	                             float *      values,
+	                             unsigned int begin,
+	                             unsigned int end);
 };
 
 #endif /* !PLUGINS_LASER_FILTER_FILTERS_COPY_H__ */
@@ -30,6 +30,8 @@
 #include <utils/math/angle.h>
 #include <utils/time/time.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <regex.h>
@@ -113,7 +115,7 @@ LaserDeadSpotsDataFilter::LaserDeadSpotsDataFilter(const std::string &    filter
 		  "Dead spots filter enabled but no calibration data exists. Run fflaser_deadspots.");
 	}
 
-	calc_spots();
+	calc_spots(0., 2 * M_PI / in_data_size);
 }
 
 /** Constructor.
@@ -123,8 +125,11 @@ LaserDeadSpotsDataFilter::LaserDeadSpotsDataFilter(const LaserDeadSpotsDataFilte
 : LaserDataFilter(other.filter_name, other.in_data_size, other.in, other.in.size()),
   logger_(other.logger_),
   num_spots_(other.num_spots_),
+  num_active_spots_(other.num_active_spots_),
   dead_spots_size_(other.dead_spots_size_),
-  cfg_dead_spots_(other.cfg_dead_spots_)
+  cfg_dead_spots_(other.cfg_dead_spots_),
+  spots_angle_min_(other.spots_angle_min_),
+  spots_angle_increment_(other.spots_angle_increment_)
 {
 	dead_spots_ = new unsigned int[dead_spots_size_];
 	for (unsigned int i = 0; i < dead_spots_size_; ++i) {
@@ -154,10 +159,13 @@ LaserDeadSpotsDataFilter::operator=(const LaserDeadSpotsDataFilter &other)
 	in           = other.in;
 	logger_      = other.logger_;
 
-	cfg_dead_spots_  = other.cfg_dead_spots_;
-	num_spots_       = other.num_spots_;
-	dead_spots_size_ = other.dead_spots_size_;
-	dead_spots_      = new unsigned int[dead_spots_size_];
+	cfg_dead_spots_        = other.cfg_dead_spots_;
+	num_spots_             = other.num_spots_;
+	num_active_spots_      = other.num_active_spots_;
+	spots_angle_min_       = other.spots_angle_min_;
+	spots_angle_increment_ = other.spots_angle_increment_;
+	dead_spots_size_       = other.dead_spots_size_;
+	dead_spots_            = new unsigned int[dead_spots_size_];
 	for (unsigned int i = 0; i < dead_spots_size_; ++i) {
 		dead_spots_[i] = other.dead_spots_[i];
 	}
@@ -169,50 +177,109 @@ void
 LaserDeadSpotsDataFilter::set_out_vector(std::vector<LaserDataFilter::Buffer *> &out)
 {
 	LaserDataFilter::set_out_vector(out);
-	calc_spots();
+	calc_spots(spots_angle_min_, spots_angle_increment_);
 }
 
+/** Calculate beam ranges of dead spots.
+ * The dead spots are configured in degrees counter-clockwise from the
+ * front. Dead spots outside of the field of view of the laser are ignored.
+ * @param angle_min angle of the first value in rad
+ * @param angle_increment angle between consecutive values in rad
+ */
 void
-LaserDeadSpotsDataFilter::calc_spots()
+LaserDeadSpotsDataFilter::calc_spots(float angle_min, float angle_increment)
 {
 	if (in_data_size != out_data_size) {
 		throw Exception("Dead spots filter requires equal input and output data size");
 	}
+	if (angle_increment <= 0.) {
+		throw Exception("Dead spots filter requires increasing angles");
+	}
 
 	// need to calculate new beam ranges and allocate different memory segment
-	float angle_factor = 360.0 / in_data_size;
+	std::vector<std::pair<unsigned int, unsigned int>> spots;
+
+	float angle_factor = rad2deg(angle_increment);
+	float angle_offset = rad2deg(angle_min);
+	float angle_range  = in_data_size * angle_factor;
 	for (unsigned int i = 0; i < num_spots_; ++i) {
-		dead_spots_[i * 2] =
-		  std::min(in_data_size - 1, (unsigned int)ceilf(cfg_dead_spots_[i].first / angle_factor));
-		dead_spots_[i * 2 + 1] =
-		  std::min(in_data_size - 1, (unsigned int)ceilf(cfg_dead_spots_[i].second / angle_factor));
+		float start = cfg_dead_spots_[i].first - angle_offset;
+		float end   = cfg_dead_spots_[i].second - angle_offset;
+		while (start < 0.) {
+			start += 360.;
+			end += 360.;
+		}
+		while (start >= 360.) {
+			start -= 360.;
+			end -= 360.;
+		}
+		if (start >= angle_range)
+			continue;
+
+		// tolerate rounding errors of the angle increment
+		spots.push_back(
+		  std::make_pair(std::min(in_data_size - 1, (unsigned int)ceilf(start / angle_factor - 1e-3)),
+		                 std::min(in_data_size - 1, (unsigned int)ceilf(end / angle_factor - 1e-3))));
+	}
+	std::sort(spots.begin(), spots.end());
+
+	num_active_spots_ = spots.size();
+	for (unsigned int i = 0; i < num_active_spots_; ++i) {
+		dead_spots_[i * 2]     = spots[i].first;
+		dead_spots_[i * 2 + 1] = spots[i].second;
 	}
+	spots_angle_min_       = angle_min;
+	spots_angle_increment_ = angle_increment;
 }
 
 void
 LaserDeadSpotsDataFilter::filter()
 {
-	const unsigned int vecsize = std::min(in.size(), out.size());
-	for (unsigned int a = 0; a < vecsize; ++a) {
-		out[a]->frame = in[a]->frame;
-		out[a]->timestamp->set_time(in[a]->timestamp);
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
-
-		unsigned int start = 0;
-		for (unsigned int i = 0; i < num_spots_; ++i) {
-			const unsigned int spot_start = dead_spots_[i * 2];
-			const unsigned int spot_end   = dead_spots_[i * 2 + 1];
-			for (unsigned int j = start; j < spot_start; ++j) {
-				outbuf[j] = inbuf[j];
-			}
-			for (unsigned int j = spot_start; j <= spot_end; ++j) {
-				outbuf[j] = 0.0;
-			}
-			start = spot_end + 1;
-		}
-		for (unsigned int j = start; j < in_data_size; ++j) {
-			outbuf[j] = inbuf[j];
+	filter_by_in_place();
+}
+
+/** Check if filter can operate in place.
+ * @return true
+ */
+bool
+LaserDeadSpotsDataFilter::supports_in_place() const
+{
+	return true;
+}
+
+/** Prepare filtering of a new set of scans.
+ * Recalculates the beam ranges if the angles of the scans changed.
+ * @param bufs buffers which are about to be filtered
+ * @return true
+ */
+bool
+LaserDeadSpotsDataFilter::prepare_in_place(const std::vector<Buffer *> &bufs)
+{
+	if (!bufs.empty()
+	    && (bufs[0]->angle_min != spots_angle_min_
+	        || bufs[0]->angle_increment != spots_angle_increment_)) {
+		calc_spots(bufs[0]->angle_min, bufs[0]->angle_increment);
+	}
+	return true;
+}
+
+/** Filter a range of values in place.
+ * @param a index of the buffer
+ * @param values values of the buffer
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserDeadSpotsDataFilter::filter_in_place(unsigned int a,
+                                          float *      values,
+                                          unsigned int begin,
+                                          unsigned int end)
+{
+	for (unsigned int i = 0; i < num_active_spots_; ++i) {
+		const unsigned int spot_start = std::max(begin, dead_spots_[i * 2]);
+		const unsigned int spot_end   = std::min(end, dead_spots_[i * 2 + 1] + 1);
+		for (unsigned int j = spot_start; j < spot_end; ++j) {
+			values[j] = 0.0;
 		}
 	}
 }
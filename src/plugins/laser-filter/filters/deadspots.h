@@ -50,17 +50,27 @@ public:
 
 	void filter();
 
+	virtual bool supports_in_place() const;
+	virtual bool prepare_in_place(const std::vector<Buffer *> &bufs);
+	virtual void filter_in_place(unsigned int a,
+	                             float *      values,
+	                             unsigned int begin,
+	                             unsigned int end);
+
 private:
-	void calc_spots();
+	void calc_spots(float angle_min, float angle_increment);
 	void set_out_vector(std::vector<LaserDataFilter::Buffer *> &out);
 
 private:
 	fawkes::Logger *logger_;
 
 	unsigned int                         num_spots_;
+	unsigned int                         num_active_spots_;
 	unsigned int *                       dead_spots_;
 	unsigned int                         dead_spots_size_;
 	std::vector<std::pair<float, float>> cfg_dead_spots_;
+	float                                spots_angle_min_;
+	float                                spots_angle_increment_;
 };
 
 #endif
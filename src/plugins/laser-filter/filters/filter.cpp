@@ -24,6 +24,8 @@
 #include <core/exception.h>
 #include <utils/time/time.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
@@ -40,6 +42,16 @@
  * to the "out" member vector.
  */
 
+/** @fn bool LaserDataFilter::supports_in_place() const
+ * Check if filter can operate in place.
+ * Filters which only modify individual values but neither the number of
+ * values nor the meta data of a buffer can implement prepare_in_place()
+ * and filter_in_place(). A LaserDataFilterCascade then fuses consecutive
+ * filters of this kind into a single pass over the values.
+ * @return true if prepare_in_place() and filter_in_place() are
+ * implemented, false otherwise
+ */
+
 /** @var LaserDataFilter::filter_name
  * Name of the specific filter instance.
  */
@@ -66,7 +78,10 @@
 
 /** @class LaserDataFilter::Buffer "filter.h"
  * Laser data buffer.
- * A buffer comprises the value array and a reference frame ID.
+ * A buffer comprises the value array and a reference frame ID. The angle
+ * of value i is angle_min + i * angle_increment. By default the values
+ * cover a full circle counter-clockwise starting at the front, which is
+ * the layout of the laser interfaces.
  */
 
 /** Constructor.
@@ -202,6 +217,70 @@ LaserDataFilter::copy_to_outbuf(LaserDataFilter::Buffer *      outbuf,
 	memcpy(outbuf->values, inbuf->values, sizeof(float) * out_data_size);
 }
 
+/** Check if filter can operate in place.
+ * @return false, filters must override this method if they implement
+ * prepare_in_place() and filter_in_place().
+ */
+bool
+LaserDataFilter::supports_in_place() const
+{
+	return false;
+}
+
+/** Prepare in place filtering of a new set of scans.
+ * This is called once for each set of scans before filter_in_place() is
+ * called on ranges of the values. Use it to process messages or to
+ * determine per-scan parameters, e.g. transforms. Note that during fused
+ * filtering the "in" member is not up to date, only use @p bufs.
+ * @param bufs buffers which are about to be filtered, values may not be
+ * accessed, only the meta data (frame, timestamp, angles)
+ * @return true to filter the scans, false to pass them through unmodified
+ */
+bool
+LaserDataFilter::prepare_in_place(const std::vector<Buffer *> &bufs)
+{
+	return true;
+}
+
+/** Filter a range of values in place.
+ * @param a index of the buffer in the vector passed to prepare_in_place()
+ * @param values values of the buffer, modified in place
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserDataFilter::filter_in_place(unsigned int a,
+                                 float *      values,
+                                 unsigned int begin,
+                                 unsigned int end)
+{
+	throw fawkes::Exception("Filter %s cannot operate in place", filter_name.c_str());
+}
+
+/** Filter all buffers by means of the in place filter.
+ * Filters which implement filter_in_place() can use this to implement
+ * filter(). Values and meta data are copied from the input to the output
+ * buffers which are then filtered in place.
+ */
+void
+LaserDataFilter::filter_by_in_place()
+{
+	const unsigned int vecsize  = std::min(in.size(), out.size());
+	const bool         prepared = prepare_in_place(in);
+	for (unsigned int a = 0; a < vecsize; ++a) {
+		out[a]->frame           = in[a]->frame;
+		out[a]->angle_min       = in[a]->angle_min;
+		out[a]->angle_increment = in[a]->angle_increment;
+		out[a]->timestamp->set_time(in[a]->timestamp);
+		if (out[a]->values != in[a]->values) {
+			copy_to_outbuf(out[a], in[a]);
+		}
+		if (prepared) {
+			filter_in_place(a, out[a]->values, 0, out_data_size);
+		}
+	}
+}
+
 /** Set input/output array ownership.
  * Owned arrays will be freed on destruction or when setting new arrays.
  * @param own_in true to assign ownership of input arrays, false otherwise
@@ -223,7 +302,9 @@ LaserDataFilter::Buffer::Buffer(size_t num_values) : values(NULL), num_values_(n
 	if (num_values_ > 0) {
 		values = (float *)malloc(num_values_ * sizeof(float));
 	}
-	timestamp = new fawkes::Time(0, 0);
+	timestamp       = new fawkes::Time(0, 0);
+	angle_min       = 0.;
+	angle_increment = (num_values_ > 0) ? 2 * M_PI / num_values_ : 0.;
 }
 
 /** Copy constructor.
@@ -232,7 +313,9 @@ LaserDataFilter::Buffer::Buffer(size_t num_values) : values(NULL), num_values_(n
 LaserDataFilter::Buffer::Buffer(const Buffer &other)
 : values(NULL), timestamp(new fawkes::Time(other.timestamp))
 {
-	num_values_ = other.num_values_;
+	angle_min       = other.angle_min;
+	angle_increment = other.angle_increment;
+	num_values_     = other.num_values_;
 	if (num_values_ > 0) {
 		values = (float *)malloc(num_values_ * sizeof(float));
 		memcpy(values, other.values, num_values_ * sizeof(float));
@@ -259,7 +342,9 @@ LaserDataFilter::Buffer::operator=(const Buffer &other)
 	if (num_values_ > 0) {
 		memcpy(values, other.values, num_values_ * sizeof(float));
 	}
-	*timestamp = *other.timestamp;
+	*timestamp      = *other.timestamp;
+	angle_min       = other.angle_min;
+	angle_increment = other.angle_increment;
 
 	return *this;
 }
@@ -280,5 +365,7 @@ LaserDataFilter::Buffer::resize(unsigned int num_values)
 		if (num_values_ > 0) {
 			values = (float *)malloc(num_values_ * sizeof(float));
 		}
+		angle_min       = 0.;
+		angle_increment = (num_values_ > 0) ? 2 * M_PI / num_values_ : 0.;
 	}
 }
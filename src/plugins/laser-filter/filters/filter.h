@@ -40,10 +40,12 @@ public:
 		~Buffer();
 		Buffer &      operator=(const Buffer &other);
 		void          resize(unsigned int num_values);
-		std::string   name;      ///< name of the input buffer
-		std::string   frame;     ///< reference coordinate frame ID
-		float *       values;    ///< values
-		fawkes::Time *timestamp; ///< timestamp of data
+		std::string   name;            ///< name of the input buffer
+		std::string   frame;           ///< reference coordinate frame ID
+		float *       values;          ///< values
+		fawkes::Time *timestamp;       ///< timestamp of data
+		float         angle_min;       ///< angle of first value in rad
+		float         angle_increment; ///< angle between consecutive values in rad
 	private:
 		unsigned int num_values_;
 	};
@@ -60,6 +62,13 @@ public:
 
 	virtual void filter() = 0;
 
+	virtual bool supports_in_place() const;
+	virtual bool prepare_in_place(const std::vector<Buffer *> &bufs);
+	virtual void filter_in_place(unsigned int a,
+	                             float *      values,
+	                             unsigned int begin,
+	                             unsigned int end);
+
 	void set_array_ownership(bool own_in, bool own_out);
 	/** Check if input arrays are owned by filter.
    * @return true if arrays are owned by this filter, false otherwise. */
@@ -81,6 +90,7 @@ protected:
 
 	void reset_outbuf(Buffer *b);
 	void copy_to_outbuf(Buffer *outbuf, const Buffer *inbuf);
+	void filter_by_in_place();
 
 protected:
 	std::string           filter_name;
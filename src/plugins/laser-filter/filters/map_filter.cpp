@@ -114,77 +114,106 @@ LaserMapFilterDataFilter::is_in_map(int cell_x, int cell_y)
 void
 LaserMapFilterDataFilter::filter()
 {
-	const unsigned int vecsize = in.size();
-	if (vecsize == 0)
-		return;
+	filter_by_in_place();
+}
 
-	for (unsigned int a = 0; a < vecsize; ++a) {
+/** Check if filter can operate in place.
+ * @return true
+ */
+bool
+LaserMapFilterDataFilter::supports_in_place() const
+{
+	return true;
+}
+
+/** Prepare filtering of a new set of scans.
+ * Looks up the transforms of the scans to the map.
+ * @param bufs buffers which are about to be filtered
+ * @return true if all transforms could be determined, false otherwise
+ */
+bool
+LaserMapFilterDataFilter::prepare_in_place(const std::vector<Buffer *> &bufs)
+{
+	transforms_.resize(bufs.size());
+	angle_min_.resize(bufs.size());
+	angle_increment_.resize(bufs.size());
+	for (unsigned int a = 0; a < bufs.size(); ++a) {
 		// get tf to map of laser input
-		fawkes::tf::StampedTransform transform;
 		try {
 			tf_listener_->lookup_transform(frame_map_.c_str(),
-			                               in[a]->frame,
-			                               *(in[a]->timestamp),
-			                               transform);
+			                               bufs[a]->frame,
+			                               *(bufs[a]->timestamp),
+			                               transforms_[a]);
 		} catch (fawkes::tf::TransformException &e) {
 			try {
 				tf_listener_->lookup_transform(frame_map_.c_str(),
-				                               in[a]->frame,
+				                               bufs[a]->frame,
 				                               fawkes::Time(0, 0),
-				                               transform);
-				//logger_->log_debug("map_filter", "Can't transform laser-data using newest tf\n(%s\t%s\t\%lf)",
-				//    frame_map_.c_str(), in[a]->frame.c_str(), in[a]->timestamp->in_sec());
+				                               transforms_[a]);
 			} catch (fawkes::tf::TransformException &e) {
 				logger_->log_warn("map_filter",
 				                  "Can't transform laser-data (%s -> %s)",
 				                  frame_map_.c_str(),
-				                  in[a]->frame.c_str());
-				return;
+				                  bufs[a]->frame.c_str());
+				return false;
 			}
 		}
-		// set out meta info
-		out[a]->frame     = in[a]->frame;
-		out[a]->timestamp = in[a]->timestamp;
-		// for each point
-		for (unsigned int i = 0; i < out_data_size; ++i) {
-			bool add = true;
-			// check nan
-			if (std::isfinite(in[a]->values[i])) {
-				// transform to cartesian
-				double angle = M_PI * (360.f / out_data_size * i) / 180;
-
-				float x, y;
-				fawkes::polar2cart2d(angle, in[a]->values[i], &x, &y);
-
-				// transform into map
-				fawkes::tf::Point p;
-				p.setValue(x, y, 0.);
-				p = transform * p;
-
-				// transform to map cells
-				int cell_x = (int)MAP_GXWX(map_, p.getX());
-				int cell_y = (int)MAP_GYWY(map_, p.getY());
-
-				// search in for a neighborhood in num_pixels_ * num_pixels_ - 1
-				// and itself for occupied pixels in map
-				for (int ox = -num_pixels_; add && ox <= num_pixels_; ++ox) {
-					for (int oy = -num_pixels_; oy <= num_pixels_; ++oy) {
-						int x = cell_x + ox;
-						int y = cell_y + oy;
-						if (MAP_VALID(map_, x, y)) {
-							if (map_->cells[MAP_INDEX(map_, x, y)].occ_state > 0) {
-								add = false;
-								break;
-							}
-						}
+		angle_min_[a]       = bufs[a]->angle_min;
+		angle_increment_[a] = bufs[a]->angle_increment;
+	}
+	return true;
+}
+
+/** Filter a range of values in place.
+ * @param a index of the buffer
+ * @param values values of the buffer
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserMapFilterDataFilter::filter_in_place(unsigned int a,
+                                          float *      values,
+                                          unsigned int begin,
+                                          unsigned int end)
+{
+	for (unsigned int i = begin; i < end; ++i) {
+		// check nan
+		if (!std::isfinite(values[i])) {
+			continue;
+		}
+
+		// transform to cartesian
+		double angle = angle_min_[a] + i * angle_increment_[a];
+
+		float x, y;
+		fawkes::polar2cart2d(angle, values[i], &x, &y);
+
+		// transform into map
+		fawkes::tf::Point p;
+		p.setValue(x, y, 0.);
+		p = transforms_[a] * p;
+
+		// transform to map cells
+		int cell_x = (int)MAP_GXWX(map_, p.getX());
+		int cell_y = (int)MAP_GYWY(map_, p.getY());
+
+		// search in for a neighborhood in num_pixels_ * num_pixels_ - 1
+		// and itself for occupied pixels in map
+		bool add = true;
+		for (int ox = -num_pixels_; add && ox <= num_pixels_; ++ox) {
+			for (int oy = -num_pixels_; oy <= num_pixels_; ++oy) {
+				int x = cell_x + ox;
+				int y = cell_y + oy;
+				if (MAP_VALID(map_, x, y)) {
+					if (map_->cells[MAP_INDEX(map_, x, y)].occ_state > 0) {
+						add = false;
+						break;
 					}
 				}
 			}
-			if (add) {
-				out[a]->values[i] = in[a]->values[i];
-			} else {
-				out[a]->values[i] = std::numeric_limits<float>::quiet_NaN();
-			}
+		}
+		if (!add) {
+			values[i] = std::numeric_limits<float>::quiet_NaN();
 		}
 	}
 }
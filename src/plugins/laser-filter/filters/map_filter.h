@@ -55,6 +55,18 @@ public:
 
 	virtual void filter();
 
+	virtual bool supports_in_place() const;
+	virtual bool prepare_in_place(const std::vector<Buffer *> &bufs);
+	virtual void filter_in_place(unsigned int a,
+	                             float *      values,
+	                             unsigned int begin,
+	                             unsigned int end);
+
+private:
+	std::vector<fawkes::tf::StampedTransform> transforms_;
+	std::vector<float>                        angle_min_;
+	std::vector<float>                        angle_increment_;
+
 private:
 	map_t *load_map();
 	bool   is_in_map(int cell_x, int cell_y);
@@ -26,6 +26,9 @@
 #include <utils/time/time.h>
 
 #include <cstdlib>
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
 
 /** @class LaserMaxCircleDataFilter "circle.h"
  * Cut of laser data at max distance.
@@ -51,19 +54,40 @@ LaserMaxCircleDataFilter::LaserMaxCircleDataFilter(const std::string &filter_nam
 void
 LaserMaxCircleDataFilter::filter()
 {
-	const unsigned int vecsize = std::min(in.size(), out.size());
-	const unsigned int arrsize = std::min(in_data_size, out_data_size);
-	for (unsigned int a = 0; a < vecsize; ++a) {
-		out[a]->frame = in[a]->frame;
-		out[a]->timestamp->set_time(in[a]->timestamp);
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
-		for (unsigned int i = 0; i < arrsize; ++i) {
-			if (inbuf[i] > radius_) {
-				outbuf[i] = radius_;
-			} else {
-				outbuf[i] = inbuf[i];
-			}
-		}
+	filter_by_in_place();
+}
+
+/** Check if filter can operate in place.
+ * @return true
+ */
+bool
+LaserMaxCircleDataFilter::supports_in_place() const
+{
+	return true;
+}
+
+/** Filter a range of values in place.
+ * @param a index of the buffer
+ * @param values values of the buffer
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserMaxCircleDataFilter::filter_in_place(unsigned int a,
+                                          float *      values,
+                                          unsigned int begin,
+                                          unsigned int end)
+{
+	const float  radius = radius_;
+	unsigned int i      = begin;
+#ifdef __SSE2__
+	// minps returns the second operand if any is NaN, i.e. NaNs are kept
+	const __m128 v_radius = _mm_set1_ps(radius);
+	for (; i + 4 <= end; i += 4) {
+		_mm_storeu_ps(&values[i], _mm_min_ps(v_radius, _mm_loadu_ps(&values[i])));
+	}
+#endif
+	for (; i < end; ++i) {
+		values[i] = (values[i] > radius) ? radius : values[i];
 	}
 }
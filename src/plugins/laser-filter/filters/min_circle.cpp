@@ -27,6 +27,9 @@
 
 #include <cstdlib>
 #include <limits>
+#ifdef __SSE2__
+#	include <emmintrin.h>
+#endif
 
 /** @class LaserMinCircleDataFilter "min_circle.h"
  * Erase beams below a certain minimum distance distance.
@@ -52,19 +55,43 @@ LaserMinCircleDataFilter::LaserMinCircleDataFilter(const std::string &filter_nam
 void
 LaserMinCircleDataFilter::filter()
 {
-	const unsigned int vecsize = std::min(in.size(), out.size());
-	const unsigned int arrsize = std::min(in_data_size, out_data_size);
-	for (unsigned int a = 0; a < vecsize; ++a) {
-		out[a]->frame = in[a]->frame;
-		out[a]->timestamp->set_time(in[a]->timestamp);
-		float *inbuf  = in[a]->values;
-		float *outbuf = out[a]->values;
-		for (unsigned int i = 0; i < arrsize; ++i) {
-			if (inbuf[i] < radius_) {
-				outbuf[i] = std::numeric_limits<float>::quiet_NaN();
-			} else {
-				outbuf[i] = inbuf[i];
-			}
-		}
+	filter_by_in_place();
+}
+
+/** Check if filter can operate in place.
+ * @return true
+ */
+bool
+LaserMinCircleDataFilter::supports_in_place() const
+{
+	return true;
+}
+
+/** Filter a range of values in place.
+ * @param a index of the buffer
+ * @param values values of the buffer
+ * @param begin index of the first value to filter
+ * @param end index after the last value to filter
+ */
+void
+LaserMinCircleDataFilter::filter_in_place(unsigned int a,
+                                          float *      values,
+                                          unsigned int begin,
+                                          unsigned int end)
+{
+	const float  radius = radius_;
+	const float  nan    = std::numeric_limits<float>::quiet_NaN();
+	unsigned int i      = begin;
+#ifdef __SSE2__
+	const __m128 v_radius = _mm_set1_ps(radius);
+	const __m128 v_nan    = _mm_set1_ps(nan);
+	for (; i + 4 <= end; i += 4) {
+		__m128 v    = _mm_loadu_ps(&values[i]);
+		__m128 less = _mm_cmplt_ps(v, v_radius);
+		_mm_storeu_ps(&values[i], _mm_or_ps(_mm_and_ps(less, v_nan), _mm_andnot_ps(less, v)));
+	}
+#endif
+	for (; i < end; ++i) {
+		values[i] = (values[i] < radius) ? nan : values[i];
 	}
 }
@@ -35,6 +35,12 @@ public:
 
 	void filter();
 
+	virtual bool supports_in_place() const;
+	virtual void filter_in_place(unsigned int a,
+	                             float *      values,
+	                             unsigned int begin,
+	                             unsigned int end);
+
 private:
 	float radius_;
 };
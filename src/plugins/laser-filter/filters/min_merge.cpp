@@ -88,7 +88,9 @@ LaserMinMergeDataFilter::filter()
 	if (ignored_.size() != in.size())
 		ignored_.resize(in.size(), false);
 
-	out[0]->frame = in[0]->frame;
+	out[0]->frame           = in[0]->frame;
+	out[0]->angle_min       = in[0]->angle_min;
+	out[0]->angle_increment = in[0]->angle_increment;
 
 	int first = -1;
 
@@ -75,23 +75,39 @@ LaserProjectionDataFilter::LaserProjectionDataFilter(const std::string &filter_n
   only_from_z_(only_from_z),
   only_to_z_(only_to_z)
 {
-	// Generate lookup tables for sin and cos
-	for (unsigned int i = 0; i < 360; ++i) {
-		sin_angles360[i] = sinf(deg2rad(i));
-		cos_angles360[i] = cosf(deg2rad(i));
-	}
-	for (unsigned int i = 0; i < 720; ++i) {
-		sin_angles720[i] = sinf(deg2rad((float)i / 2.));
-		cos_angles720[i] = cosf(deg2rad((float)i / 2.));
-	}
-
-	index_factor_ = out_data_size / 360.;
+	tables_angle_min_       = 0.;
+	tables_angle_increment_ = 0.;
+	index_factor_           = out_data_size / 360.;
 }
 
 LaserProjectionDataFilter::~LaserProjectionDataFilter()
 {
 }
 
+/** Update lookup tables for sin and cos.
+ * The tables are only re-generated if the angles of the input buffer
+ * differ from the ones the tables have been generated for.
+ * @param b input buffer to generate the tables for
+ */
+void
+LaserProjectionDataFilter::update_tables(const LaserDataFilter::Buffer *b)
+{
+	if (sin_angles_.size() == in_data_size && b->angle_min == tables_angle_min_
+	    && b->angle_increment == tables_angle_increment_) {
+		return;
+	}
+
+	sin_angles_.resize(in_data_size);
+	cos_angles_.resize(in_data_size);
+	for (unsigned int i = 0; i < in_data_size; ++i) {
+		float a        = b->angle_min + i * b->angle_increment;
+		sin_angles_[i] = sinf(a);
+		cos_angles_[i] = cosf(a);
+	}
+	tables_angle_min_       = b->angle_min;
+	tables_angle_increment_ = b->angle_increment;
+}
+
 /** Set the output buffer applying filtering.
  * This checks the given point against the configured bounds. If and
  * only if the point satisfies the given criteria it is set at the
@@ -114,7 +130,7 @@ LaserProjectionDataFilter::set_output(float *outbuf, fawkes::tf::Point &p)
 	float phi = atan2f(p.y(), p.x());
 
 	unsigned int j = (unsigned int)roundf(rad2deg(normalize_rad(phi)) * index_factor_);
-	if (j > out_data_size)
+	if (j >= out_data_size)
 		j = 0; // might happen just at the boundary
 
 	if (outbuf[j] == 0.) {
@@ -129,7 +145,9 @@ LaserProjectionDataFilter::filter()
 {
 	const unsigned int vecsize = std::min(in.size(), out.size());
 	for (unsigned int a = 0; a < vecsize; ++a) {
-		out[a]->frame = target_frame_;
+		out[a]->frame           = target_frame_;
+		out[a]->angle_min       = 0.;
+		out[a]->angle_increment = 2 * M_PI / out_data_size;
 		out[a]->timestamp->set_time(in[a]->timestamp);
 		float *inbuf  = in[a]->values;
 		float *outbuf = out[a]->values;
@@ -140,40 +158,15 @@ LaserProjectionDataFilter::filter()
 
 		tf_->lookup_transform(target_frame_, in[a]->frame, fawkes::Time(0, 0), t);
 
-		if (in_data_size == 360) {
-			for (unsigned int i = 0; i < 360; ++i) {
-				if (inbuf[i] == 0.)
-					continue;
-				p.setValue((btScalar)inbuf[i] * cos_angles360[i],
-				           (btScalar)inbuf[i] * sin_angles360[i],
-				           0.);
-				p = t * p;
-
-				set_output(outbuf, p);
-			}
-		} else if (in_data_size == 720) {
-			for (unsigned int i = 0; i < 720; ++i) {
-				if (inbuf[i] == 0.)
-					continue;
-
-				p.setValue((btScalar)inbuf[i] * cos_angles720[i],
-				           (btScalar)inbuf[i] * sin_angles720[i],
-				           0.);
-				p = t * p;
-
-				set_output(outbuf, p);
-			}
-		} else {
-			for (unsigned int i = 0; i < in_data_size; ++i) {
-				if (inbuf[i] == 0.)
-					continue;
-
-				float a = deg2rad((float)i / ((float)in_data_size / 360.f));
-				p.setValue((btScalar)inbuf[i] * cos(a), (btScalar)inbuf[i] * sin(a), 0.);
-				p = t * p;
-
-				set_output(outbuf, p);
-			}
+		update_tables(in[a]);
+		for (unsigned int i = 0; i < in_data_size; ++i) {
+			if (inbuf[i] == 0.)
+				continue;
+
+			p.setValue((btScalar)inbuf[i] * cos_angles_[i], (btScalar)inbuf[i] * sin_angles_[i], 0.);
+			p = t * p;
+
+			set_output(outbuf, p);
 		}
 	}
 }
@@ -32,6 +32,7 @@
 #include <tf/transformer.h>
 
 #include <string>
+#include <vector>
 
 namespace fawkes {
 class Configuration;
@@ -58,6 +59,7 @@ public:
 
 private:
 	inline void set_output(float *outbuf, fawkes::tf::Point &p);
+	void        update_tables(const LaserDataFilter::Buffer *b);
 
 private:
 	fawkes::tf::Transformer *tf_;
@@ -66,10 +68,10 @@ private:
 	const float              not_from_y_, not_to_y_;
 	const float              only_from_z_, only_to_z_;
 
-	float sin_angles360[360];
-	float cos_angles360[360];
-	float sin_angles720[720];
-	float cos_angles720[720];
+	std::vector<float> sin_angles_;
+	std::vector<float> cos_angles_;
+	float              tables_angle_min_;
+	float              tables_angle_increment_;
 
 	float index_factor_;
 };
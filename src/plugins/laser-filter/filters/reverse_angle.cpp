@@ -56,7 +56,9 @@ LaserReverseAngleDataFilter::filter()
 	const unsigned int vecsize = std::min(in.size(), out.size());
 	const unsigned int arrsize = std::min(in_data_size, out_data_size);
 	for (unsigned int a = 0; a < vecsize; ++a) {
-		out[a]->frame = in[a]->frame;
+		out[a]->frame           = in[a]->frame;
+		out[a]->angle_min       = in[a]->angle_min;
+		out[a]->angle_increment = in[a]->angle_increment;
 		out[a]->timestamp->set_time(in[a]->timestamp);
 		float *inbuf  = in[a]->values;
 		float *outbuf = out[a]->values;
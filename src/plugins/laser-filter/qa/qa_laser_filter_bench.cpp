@@ -0,0 +1,311 @@
+
+/***************************************************************************
+ *  qa_laser_filter_bench.cpp - Benchmark laser filter cascade
+ *
+ *  Created: Fri Oct 16 14:11:47 2026
+ *  Copyright  2006-2026  Tim Niemueller [www.niemueller.de]
+ *
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+/// @cond QA
+
+// Measures the time each filter takes on its own and compares the cascade
+// of all filters run one after another to the fused cascade. The output of
+// both cascades is verified to be identical.
+
+#include "../filters/cascade.h"
+#include "../filters/circle_sector.h"
+#include "../filters/copy.h"
+#include "../filters/deadspots.h"
+#include "../filters/max_circle.h"
+#include "../filters/min_circle.h"
+#include "../filters/min_merge.h"
+#ifdef HAVE_TF
+#	include "../filters/box_filter.h"
+#	include "../filters/map_filter.h"
+#	include "../filters/projection.h"
+
+#	include <blackboard/local.h>
+#	include <tf/transformer.h>
+#endif
+
+#include <config/memory.h>
+#include <logging/console.h>
+#include <utils/time/time.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+using namespace fawkes;
+
+#define CFG_PREFIX "/plugins/laser-filter/bench/filters/"
+
+static void
+print_result(const char *what, unsigned int ops, double sec)
+{
+	printf("%-28s %8u scans in %8.4f sec, %10.1f ns/scan\n", what, ops, sec, sec * 1.e9 / ops);
+}
+
+static void
+fill_scans(std::vector<LaserDataFilter::Buffer *> &in, unsigned int num_values, std::mt19937 &gen)
+{
+	std::uniform_real_distribution<float> dist(0.02, 6.0);
+	for (LaserDataFilter::Buffer *buf : in) {
+		for (unsigned int i = 0; i < num_values; ++i) {
+			buf->values[i] = dist(gen);
+		}
+		buf->frame = "/base_laser";
+		buf->timestamp->stamp();
+	}
+}
+
+/** Environment needed to create the filters of the cascade. */
+typedef struct
+{
+	MemoryConfiguration *config;     ///< configuration
+	Logger *             logger;     ///< logger
+#ifdef HAVE_TF
+	tf::Transformer *    tf;         ///< transformer with the laser and map frames
+	BlackBoard *         blackboard; ///< blackboard for the box filter interface
+#endif
+} BenchEnv;
+
+static LaserDataFilterCascade *
+create_cascade(BenchEnv &                              env,
+               unsigned int                            num_values,
+               std::vector<LaserDataFilter::Buffer *> &in,
+               std::vector<std::string> &              names)
+{
+	LaserDataFilterCascade *cascade = new LaserDataFilterCascade("bench", num_values, in);
+
+	names.push_back("min_merge");
+	cascade->add_filter(
+	  new LaserMinMergeDataFilter("min_merge", env.logger, num_values, cascade->get_out_vector()));
+	names.push_back("deadspots");
+	cascade->add_filter(new LaserDeadSpotsDataFilter("deadspots",
+	                                                 env.config,
+	                                                 env.logger,
+	                                                 CFG_PREFIX "deadspots/",
+	                                                 num_values,
+	                                                 cascade->get_out_vector()));
+	names.push_back("min_circle");
+	cascade->add_filter(
+	  new LaserMinCircleDataFilter("min_circle", 0.12, num_values, cascade->get_out_vector()));
+	names.push_back("circle_sector");
+	cascade->add_filter(new LaserCircleSectorDataFilter(
+	  "circle_sector", num_values * 5 / 6, num_values / 6, num_values, cascade->get_out_vector()));
+	names.push_back("max_circle");
+	cascade->add_filter(
+	  new LaserMaxCircleDataFilter("max_circle", 4.0, num_values, cascade->get_out_vector()));
+#ifdef HAVE_TF
+	names.push_back("box_filter");
+	cascade->add_filter(new LaserBoxFilterDataFilter("box_filter",
+	                                                 num_values,
+	                                                 cascade->get_out_vector(),
+	                                                 env.tf,
+	                                                 env.config,
+	                                                 env.logger,
+	                                                 env.blackboard));
+	try {
+		LaserDataFilter *map_filter = new LaserMapFilterDataFilter("map_filter",
+		                                                           num_values,
+		                                                           cascade->get_out_vector(),
+		                                                           env.tf,
+		                                                           env.config,
+		                                                           CFG_PREFIX "map_filter/",
+		                                                           env.logger);
+		names.push_back("map_filter");
+		cascade->add_filter(map_filter);
+	} catch (Exception &e) {
+		printf("Omitting map_filter, cannot load map: %s\n", e.what_no_backtrace());
+	}
+	names.push_back("projection");
+	cascade->add_filter(new LaserProjectionDataFilter("projection",
+	                                                  env.tf,
+	                                                  "/base_link",
+	                                                  -0.2,
+	                                                  0.2,
+	                                                  -0.2,
+	                                                  0.2,
+	                                                  -1.0,
+	                                                  1.0,
+	                                                  num_values,
+	                                                  cascade->get_out_vector()));
+#endif
+	names.push_back("copy");
+	cascade->add_filter(new LaserCopyDataFilter("copy", num_values, cascade->get_out_vector()));
+	return cascade;
+}
+
+int
+main(int argc, char **argv)
+{
+	unsigned int num_values = 1080;
+	unsigned int num_scans  = 20000;
+	std::string  map_file   = "map.png";
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:s:m:h")) != -1) {
+		switch (opt) {
+		case 'n': num_values = atoi(optarg); break;
+		case 's': num_scans = atoi(optarg); break;
+		case 'm': map_file = optarg; break;
+		default:
+			printf("Usage: %s [-n values per scan] [-s scans] [-m map file in config dir]\n", argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (num_values < 6 || num_scans == 0) {
+		printf("Need at least 6 values and one scan\n");
+		return 1;
+	}
+
+	MemoryConfiguration config;
+	config.set_float(CFG_PREFIX "deadspots/0/start", 20.);
+	config.set_float(CFG_PREFIX "deadspots/0/end", 25.);
+	config.set_float(CFG_PREFIX "deadspots/1/start", 200.);
+	config.set_float(CFG_PREFIX "deadspots/1/end", 210.);
+	config.set_string("/frames/fixed", "/map");
+	config.set_string("/plugins/amcl/map_file", map_file);
+	config.set_float("/plugins/amcl/resolution", 0.05);
+	config.set_float("/plugins/amcl/origin_x", -10.);
+	config.set_float("/plugins/amcl/origin_y", -10.);
+	config.set_float("/plugins/amcl/origin_theta", 0.);
+	config.set_float("/plugins/amcl/occupied_threshold", 0.65);
+	config.set_float("/plugins/amcl/free_threshold", 0.2);
+	ConsoleLogger logger(Logger::LL_WARN);
+
+	BenchEnv env;
+	env.config = &config;
+	env.logger = &logger;
+#ifdef HAVE_TF
+	tf::Transformer transformer;
+	transformer.set_transform(tf::StampedTransform(tf::Transform(tf::Quaternion(0, 0, 0, 1),
+	                                                             tf::Vector3(0.2, 0., 0.3)),
+	                                               Time(0, 0),
+	                                               "/base_link",
+	                                               "/base_laser"),
+	                          "bench",
+	                          /* static */ true);
+	transformer.set_transform(tf::StampedTransform(tf::Transform(tf::Quaternion(0, 0, 0.38, 0.92),
+	                                                             tf::Vector3(1.5, -0.5, 0.)),
+	                                               Time(0, 0),
+	                                               "/map",
+	                                               "/base_link"),
+	                          "bench",
+	                          /* static */ true);
+	LocalBlackBoard blackboard(512 * 1024);
+	env.tf         = &transformer;
+	env.blackboard = &blackboard;
+#endif
+
+	std::mt19937                           gen(42);
+	std::vector<LaserDataFilter::Buffer *> in;
+	in.push_back(new LaserDataFilter::Buffer(num_values));
+	in.push_back(new LaserDataFilter::Buffer(num_values));
+	fill_scans(in, num_values, gen);
+
+	std::vector<std::string> names;
+	LaserDataFilterCascade * cascade = create_cascade(env, num_values, in, names);
+
+#ifdef HAVE_TF
+	// a box in front of the robot, the box filter does nothing without boxes
+	LaserBoxFilterInterface *box_if =
+	  env.blackboard->open_for_reading<LaserBoxFilterInterface>("Laser Box Filter");
+	LaserBoxFilterInterface::CreateNewBoxFilterMessage *box_msg =
+	  new LaserBoxFilterInterface::CreateNewBoxFilterMessage();
+	const double box[4][2] = {{2.0, -1.0}, {3.0, -1.0}, {3.0, 0.0}, {2.0, 0.0}};
+	for (unsigned int i = 0; i < 2; ++i) {
+		box_msg->set_p1(i, box[0][i]);
+		box_msg->set_p2(i, box[1][i]);
+		box_msg->set_p3(i, box[2][i]);
+		box_msg->set_p4(i, box[3][i]);
+	}
+	box_if->msgq_enqueue(box_msg);
+#endif
+
+	printf("%u values per scan, %u scans\n", num_values, num_scans);
+
+	Time start, end;
+
+	// each filter on its own, values are reset by the first filter
+	const std::list<LaserDataFilter *> &         filters = cascade->get_filters();
+	std::list<LaserDataFilter *>::const_iterator f;
+	unsigned int                                 i = 0;
+	for (f = filters.begin(); f != filters.end(); ++f, ++i) {
+		start.stamp();
+		for (unsigned int s = 0; s < num_scans; ++s) {
+			(*f)->filter();
+		}
+		end.stamp();
+		print_result(names[i].c_str(), num_scans, end - &start);
+	}
+
+	std::vector<LaserDataFilter::Buffer *> &out = cascade->get_out_vector();
+	unsigned int                            num_out_values = cascade->get_out_data_size();
+
+	start.stamp();
+	for (unsigned int s = 0; s < num_scans; ++s) {
+		cascade->filter();
+	}
+	end.stamp();
+	print_result("cascade, sequential", num_scans, end - &start);
+
+	cascade->set_fused(true);
+	start.stamp();
+	for (unsigned int s = 0; s < num_scans; ++s) {
+		cascade->filter();
+	}
+	end.stamp();
+	print_result("cascade, fused", num_scans, end - &start);
+
+	// verify on fresh data
+	std::vector<float> seq_values(num_out_values);
+	unsigned int       num_diff = 0;
+	for (unsigned int s = 0; s < 100; ++s) {
+		fill_scans(in, num_values, gen);
+		cascade->set_fused(false);
+		cascade->filter();
+		std::copy(out[0]->values, out[0]->values + num_out_values, seq_values.begin());
+		cascade->set_fused(true);
+		cascade->filter();
+		for (unsigned int v = 0; v < num_out_values; ++v) {
+			float a = seq_values[v];
+			float b = out[0]->values[v];
+			if (!(a == b || (std::isnan(a) && std::isnan(b)))) {
+				++num_diff;
+			}
+		}
+	}
+	printf("Fused output %s (%u differences)\n", num_diff ? "DIFFERS" : "matches", num_diff);
+
+	delete cascade;
+#ifdef HAVE_TF
+	env.blackboard->close(box_if);
+#endif
+	delete in[0];
+	delete in[1];
+
+	return num_diff ? 1 : 0;
+}
+
+/// @endcond
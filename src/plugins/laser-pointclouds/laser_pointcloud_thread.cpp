@@ -26,8 +26,11 @@
 #include <interfaces/Laser360Interface.h>
 #include <interfaces/Laser720Interface.h>
 #include <pcl_utils/utils.h>
+#include <utils/ipc/shm_laser.h>
 #include <utils/math/angle.h>
 
+#include <cmath>
+
 using namespace fawkes;
 
 /** @class LaserPointCloudThread "tf_thread.h"
@@ -76,6 +79,8 @@ LaserPointCloudThread::init()
 		mapping.cloud->header.frame_id = (*i)->frame();
 		mapping.cloud->height          = 1;
 		mapping.cloud->width           = 360;
+		mapping.shm                    = NULL;
+		update_angles(mapping, 360, 0., 2 * M_PI / 360);
 		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
 		bbil_add_reader_interface(*i);
 		bbil_add_writer_interface(*i);
@@ -94,6 +99,8 @@ LaserPointCloudThread::init()
 		mapping.cloud->header.frame_id = (*j)->frame();
 		mapping.cloud->height          = 1;
 		mapping.cloud->width           = 720;
+		mapping.shm                    = NULL;
+		update_angles(mapping, 720, 0., 2 * M_PI / 720);
 		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
 		bbil_add_reader_interface(*j);
 		bbil_add_writer_interface(*j);
@@ -113,6 +120,8 @@ LaserPointCloudThread::init()
 		mapping.cloud->header.frame_id = (*k)->frame();
 		mapping.cloud->height          = 1;
 		mapping.cloud->width           = 1080;
+		mapping.shm                    = NULL;
+		update_angles(mapping, 1080, 0., 2 * M_PI / 1080);
 		pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
 		bbil_add_reader_interface(*k);
 		bbil_add_writer_interface(*k);
@@ -126,19 +135,7 @@ LaserPointCloudThread::init()
 	bbio_add_observed_create("Laser1080Interface", "*");
 	blackboard->register_observer(this);
 
-	// Generate lookup tables for sin and cos
-	for (unsigned int i = 0; i < 360; ++i) {
-		sin_angles360[i] = sinf(deg2rad(i));
-		cos_angles360[i] = cosf(deg2rad(i));
-	}
-	for (unsigned int i = 0; i < 720; ++i) {
-		sin_angles720[i] = sinf(deg2rad((float)i / 2.));
-		cos_angles720[i] = cosf(deg2rad((float)i / 2.));
-	}
-	for (unsigned int i = 0; i < 1080; ++i) {
-		sin_angles1080[i] = sinf(deg2rad((float)i / 3.));
-		cos_angles1080[i] = cosf(deg2rad((float)i / 3.));
-	}
+	open_shm_buffers();
 }
 
 void
@@ -149,12 +146,86 @@ LaserPointCloudThread::finalize()
 
 	LockList<InterfaceCloudMapping>::iterator m;
 	for (m = mappings_.begin(); m != mappings_.end(); ++m) {
-		blackboard->close(m->interface);
+		if (m->interface) {
+			blackboard->close(m->interface);
+		}
+		delete m->shm;
 		pcl_manager->remove_pointcloud(m->id.c_str());
 	}
 	mappings_.clear();
 }
 
+/** Open all shared memory laser buffers.
+ * Buffers are only detected on initialization. Each scan is converted
+ * directly from shared memory into a spare point vector, which replaces
+ * the points of the cloud once the scan has been verified to be consistent.
+ */
+void
+LaserPointCloudThread::open_shm_buffers()
+{
+	SharedMemoryLaserBufferHeader *    h    = new SharedMemoryLaserBufferHeader();
+	SharedMemory::SharedMemoryIterator i    = SharedMemory::find(FAWKES_SHM_LASER_MAGIC_TOKEN, h);
+	SharedMemory::SharedMemoryIterator endi = SharedMemory::end();
+
+	while (i != endi) {
+		const SharedMemoryLaserBufferHeader *lh =
+		  dynamic_cast<const SharedMemoryLaserBufferHeader *>(*i);
+		if (lh) {
+			InterfaceCloudMapping mapping;
+			try {
+				mapping.shm = new SharedMemoryLaserBuffer(lh->laser_id());
+			} catch (Exception &e) {
+				logger->log_warn(name(), "Failed to open laser buffer %s: %s", lh->laser_id(), e.what());
+				++i;
+				continue;
+			}
+			mapping.id                    = interface_to_pcl_name(lh->laser_id());
+			mapping.size                  = 0;
+			mapping.interface_typed.as360 = NULL;
+			mapping.interface             = NULL;
+			mapping.shm_seq               = 0;
+			mapping.angle_min             = 0.;
+			mapping.angle_increment       = 0.;
+			mapping.cloud                 = new pcl::PointCloud<pcl::PointXYZ>();
+			mapping.cloud->height         = 1;
+			mapping.cloud->width          = 0;
+			try {
+				pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
+				mappings_.push_back(mapping);
+			} catch (Exception &e) {
+				logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
+				delete mapping.shm;
+			}
+		}
+
+		++i;
+	}
+
+	delete h;
+}
+
+/** Update lookup tables for sin and cos.
+ * @param mapping mapping to update the tables of
+ * @param num_values number of values per scan
+ * @param angle_min angle of the first value in rad
+ * @param angle_increment angle between consecutive values in rad
+ */
+void
+LaserPointCloudThread::update_angles(InterfaceCloudMapping &mapping,
+                                     unsigned int           num_values,
+                                     float                  angle_min,
+                                     float                  angle_increment)
+{
+	mapping.angle_min       = angle_min;
+	mapping.angle_increment = angle_increment;
+	mapping.sin_angles.resize(num_values);
+	mapping.cos_angles.resize(num_values);
+	for (unsigned int i = 0; i < num_values; ++i) {
+		mapping.sin_angles[i] = sinf(angle_min + i * angle_increment);
+		mapping.cos_angles[i] = cosf(angle_min + i * angle_increment);
+	}
+}
+
 void
 LaserPointCloudThread::loop()
 {
@@ -162,33 +233,54 @@ LaserPointCloudThread::loop()
 
 	LockList<InterfaceCloudMapping>::iterator m;
 	for (m = mappings_.begin(); m != mappings_.end(); ++m) {
+		if (m->shm) {
+			// convert directly from shared memory into the spare points, they
+			// are only published once the scan has been verified not to have
+			// been overwritten while converting
+			SharedMemoryLaserBuffer::Scan scan;
+			if (m->shm->latest_seq() == m->shm_seq || !m->shm->read_latest(scan)) {
+				continue;
+			}
+			if (scan.num_values != m->sin_angles.size() || scan.angle_min != m->angle_min
+			    || scan.angle_increment != m->angle_increment) {
+				update_angles(*m, scan.num_values, scan.angle_min, scan.angle_increment);
+			}
+			m->shm_points.resize(scan.num_values);
+			for (unsigned int i = 0; i < scan.num_values; ++i) {
+				m->shm_points[i].x = scan.values[i] * m->cos_angles[i];
+				m->shm_points[i].y = scan.values[i] * m->sin_angles[i];
+			}
+			if (!m->shm->is_valid(scan)) {
+				logger->log_warn(name(), "Laser buffer %s overwritten while reading", m->id.c_str());
+				continue;
+			}
+			m->shm_seq = scan.seq;
+
+			m->cloud->points.swap(m->shm_points);
+			m->cloud->width           = scan.num_values;
+			m->cloud->header.frame_id = scan.frame_id;
+			pcl_utils::set_time(m->cloud, scan.timestamp);
+			continue;
+		}
+
 		m->interface->read();
 		if (!m->interface->changed()) {
 			continue;
 		}
+		float *distances = NULL;
 		if (m->size == 360) {
 			m->cloud->header.frame_id = m->interface_typed.as360->frame();
-			float *distances          = m->interface_typed.as360->distances();
-			for (unsigned int i = 0; i < 360; ++i) {
-				m->cloud->points[i].x = distances[i] * cos_angles360[i];
-				m->cloud->points[i].y = distances[i] * sin_angles360[i];
-			}
-
+			distances                 = m->interface_typed.as360->distances();
 		} else if (m->size == 720) {
 			m->cloud->header.frame_id = m->interface_typed.as720->frame();
-			float *distances          = m->interface_typed.as720->distances();
-			for (unsigned int i = 0; i < 720; ++i) {
-				m->cloud->points[i].x = distances[i] * cos_angles720[i];
-				m->cloud->points[i].y = distances[i] * sin_angles720[i];
-			}
-
+			distances                 = m->interface_typed.as720->distances();
 		} else if (m->size == 1080) {
 			m->cloud->header.frame_id = m->interface_typed.as1080->frame();
-			float *distances          = m->interface_typed.as1080->distances();
-			for (unsigned int i = 0; i < 1080; ++i) {
-				m->cloud->points[i].x = distances[i] * cos_angles1080[i];
-				m->cloud->points[i].y = distances[i] * sin_angles1080[i];
-			}
+			distances                 = m->interface_typed.as1080->distances();
+		}
+		for (unsigned int i = 0; i < m->size; ++i) {
+			m->cloud->points[i].x = distances[i] * m->cos_angles[i];
+			m->cloud->points[i].y = distances[i] * m->sin_angles[i];
 		}
 
 		pcl_utils::set_time(m->cloud, *(m->interface->timestamp()));
@@ -202,6 +294,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) th
 	mapping.id    = interface_to_pcl_name(id);
 	mapping.cloud = RefPtr<pcl::PointCloud<pcl::PointXYZ>>(new pcl::PointCloud<pcl::PointXYZ>);
 	mapping.cloud->height = 1;
+	mapping.shm           = NULL;
 
 	if (strncmp(type, "Laser360Interface", INTERFACE_TYPE_SIZE_) == 0) {
 		Laser360Interface *lif;
@@ -219,6 +312,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) th
 			mapping.cloud->points.resize(360);
 			mapping.cloud->header.frame_id = lif->frame();
 			mapping.cloud->width           = 360;
+			update_angles(mapping, 360, 0., 2 * M_PI / 360);
 			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
@@ -242,6 +336,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) th
 			mapping.cloud->points.resize(720);
 			mapping.cloud->header.frame_id = lif->frame();
 			mapping.cloud->width           = 720;
+			update_angles(mapping, 720, 0., 2 * M_PI / 720);
 			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
@@ -265,6 +360,7 @@ LaserPointCloudThread::bb_interface_created(const char *type, const char *id) th
 			mapping.cloud->points.resize(1080);
 			mapping.cloud->header.frame_id = lif->frame();
 			mapping.cloud->width           = 1080;
+			update_angles(mapping, 1080, 0., 2 * M_PI / 1080);
 			pcl_manager->add_pointcloud(mapping.id.c_str(), mapping.cloud);
 		} catch (Exception &e) {
 			logger->log_warn(name(), "Failed to add pointcloud %s: %s", mapping.id.c_str(), e.what());
@@ -321,6 +417,10 @@ LaserPointCloudThread::conditional_close(Interface *interface) throw()
 
 	fawkes::LockList<InterfaceCloudMapping>::iterator m;
 	for (m = mappings_.begin(); m != mappings_.end(); ++m) {
+		if (!m->interface) {
+			// shared memory laser buffer
+			continue;
+		}
 		bool match = ((m->size == 360 && l360if && (*l360if == *m->interface_typed.as360))
 		              || (m->size == 720 && l720if && (*l720if == *m->interface_typed.as720))
 		              || (m->size == 1080 && l1080if && (*l1080if == *m->interface_typed.as1080)));
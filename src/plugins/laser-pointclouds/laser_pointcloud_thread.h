@@ -34,11 +34,15 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace fawkes {
 class Interface;
 class Laser360Interface;
 class Laser720Interface;
 class Laser1080Interface;
+class SharedMemoryLaserBuffer;
 } // namespace fawkes
 
 class LaserPointCloudThread : public fawkes::Thread,
@@ -89,20 +93,27 @@ private:
 			fawkes::Laser720Interface * as720;
 			fawkes::Laser1080Interface *as1080;
 		} interface_typed;
-		fawkes::Interface *interface;
+		fawkes::Interface *                        interface;
+		fawkes::SharedMemoryLaserBuffer *          shm;
+		uint64_t                                   shm_seq;
+		pcl::PointCloud<pcl::PointXYZ>::VectorType shm_points;
+
+		float              angle_min;
+		float              angle_increment;
+		std::vector<float> sin_angles;
+		std::vector<float> cos_angles;
 
 		fawkes::RefPtr<pcl::PointCloud<pcl::PointXYZ>> cloud;
 	} InterfaceCloudMapping;
 	/// @endcond
 
-	fawkes::LockList<InterfaceCloudMapping> mappings_;
+	void update_angles(InterfaceCloudMapping &mapping,
+	                   unsigned int           num_values,
+	                   float                  angle_min,
+	                   float                  angle_increment);
+	void open_shm_buffers();
 
-	float sin_angles360[360];
-	float cos_angles360[360];
-	float sin_angles720[720];
-	float cos_angles720[720];
-	float sin_angles1080[1080];
-	float cos_angles1080[1080];
+	fawkes::LockList<InterfaceCloudMapping> mappings_;
 };
 
 #endif
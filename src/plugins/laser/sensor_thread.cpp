@@ -27,6 +27,10 @@
 #include <interfaces/Laser1080Interface.h>
 #include <interfaces/Laser360Interface.h>
 #include <interfaces/Laser720Interface.h>
+#include <utils/ipc/shm_laser.h>
+
+#include <cmath>
+#include <cstring>
 
 using namespace fawkes;
 
@@ -34,6 +38,9 @@ using namespace fawkes;
  * Laser sensor thread.
  * This thread integrates into the Fawkes main loop at the sensor hook and
  * publishes new data when available from the LaserAcquisitionThread.
+ * Data of 360, 720, or 1080 values is written to the respective laser
+ * interface. If a shared memory ID is configured the data is additionally
+ * written to a SharedMemoryLaserBuffer, which supports any number of values.
  * @author Tim Niemueller
  */
 
@@ -60,8 +67,10 @@ LaserSensorThread::init()
 	laser360_if_  = NULL;
 	laser720_if_  = NULL;
 	laser1080_if_ = NULL;
+	laser_shm_    = NULL;
 
-	bool main_sensor = false;
+	bool        main_sensor = false;
+	std::string shm_id;
 
 	cfg_frame_ = config->get_string((cfg_prefix_ + "frame").c_str());
 
@@ -70,10 +79,19 @@ LaserSensorThread::init()
 	} catch (Exception &e) {
 	} // ignored, assume no
 
+	try {
+		shm_id = config->get_string((cfg_prefix_ + "shm_id").c_str());
+	} catch (Exception &e) {
+	} // ignored, no shared memory buffer
+
 	aqt_->pre_init(config, logger);
 
 	num_values_ = aqt_->get_distance_data_size();
 
+	if (!shm_id.empty()) {
+		laser_shm_ = new SharedMemoryLaserBuffer(shm_id.c_str(), num_values_, 4);
+	}
+
 	std::string if_id = main_sensor ? "Laser" : ("Laser " + cfg_name_);
 
 	if (num_values_ == 360) {
@@ -91,9 +109,10 @@ LaserSensorThread::init()
 		laser1080_if_->set_auto_timestamping(false);
 		laser1080_if_->set_frame(cfg_frame_.c_str());
 		laser1080_if_->write();
-	} else {
+	} else if (!laser_shm_) {
 		throw Exception("Laser acquisition thread must produce either 360, 720, or 1080 "
-		                "distance values, but it produces %u",
+		                "distance values, but it produces %u, configure a shm_id for "
+		                "other sizes",
 		                aqt_->get_distance_data_size());
 	}
 }
@@ -104,6 +123,7 @@ LaserSensorThread::finalize()
 	blackboard->close(laser360_if_);
 	blackboard->close(laser720_if_);
 	blackboard->close(laser1080_if_);
+	delete laser_shm_;
 }
 
 void
@@ -123,6 +143,12 @@ LaserSensorThread::loop()
 			laser1080_if_->set_distances(aqt_->get_distance_data());
 			laser1080_if_->write();
 		}
+		if (laser_shm_) {
+			// acquisition threads provide a full circle counter-clockwise
+			memcpy(laser_shm_->begin_write(), aqt_->get_distance_data(), num_values_ * sizeof(float));
+			laser_shm_->end_write(
+			  num_values_, 0., 2 * M_PI / num_values_, cfg_frame_.c_str(), aqt_->get_timestamp());
+		}
 		aqt_->unlock();
 	}
 }
@@ -35,6 +35,7 @@ namespace fawkes {
 class Laser360Interface;
 class Laser720Interface;
 class Laser1080Interface;
+class SharedMemoryLaserBuffer;
 } // namespace fawkes
 
 class LaserAcquisitionThread;
@@ -65,6 +66,8 @@ private:
 	fawkes::Laser720Interface * laser720_if_;
 	fawkes::Laser1080Interface *laser1080_if_;
 
+	fawkes::SharedMemoryLaserBuffer *laser_shm_;
+
 	LaserAcquisitionThread *aqt_;
 
 	unsigned int num_values_;
@@ -273,8 +273,9 @@ LuaAgentContinuousExecutionThread::LuaThread::LuaThread(fawkes::LuaContext *lua)
 : Thread("LuaAgentContinuousExecutionThread::LuaThread", Thread::OPMODE_CONTINUOUS)
 {
 	set_prepfin_conc_loop(true);
-	lua_    = lua;
-	failed_ = false;
+	lua_         = lua;
+	lua_execute_ = lua_->compile_string("agentenv.execute()");
+	failed_      = false;
 }
 
 /** Loop method continuously calling agentenv.execute() in Lua. */
@@ -284,7 +285,7 @@ LuaAgentContinuousExecutionThread::LuaThread::loop()
 	while (!failed_) {
 		try {
 			// Stack:
-			lua_->do_string("agentenv.execute()");
+			lua_->call_compiled(lua_execute_);
 		} catch (Exception &e) {
 			failed_ = true;
 			logger->log_error(name(), "execute() failed, exception follows");
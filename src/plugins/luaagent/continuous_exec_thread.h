@@ -100,6 +100,7 @@ private: /* methods */
 
 	private:
 		fawkes::LuaContext *lua_;
+		unsigned int        lua_execute_;
 		bool                failed_;
 	};
 
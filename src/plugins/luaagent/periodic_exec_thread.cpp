@@ -155,6 +155,7 @@ LuaAgentPeriodicExecutionThread::init()
 		lua_ifi_->push_interfaces();
 
 		lua_->set_start_script(LUADIR "/luaagent/fawkes/start.lua");
+		lua_execute_ = lua_->compile_string("agentenv.execute()");
 	} catch (Exception &e) {
 		init_failure_cleanup();
 		throw;
@@ -230,7 +231,7 @@ LuaAgentPeriodicExecutionThread::loop()
 
 	try {
 		// Stack:
-		lua_->do_string("agentenv.execute()");
+		lua_->call_compiled(lua_execute_);
 	} catch (Exception &e) {
 		logger->log_error("LuaAgentPeriodicExecutionThread",
 		                  "Execution of %s.execute() failed, exception follows",
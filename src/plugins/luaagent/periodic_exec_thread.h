@@ -90,6 +90,7 @@ private: /* members */
 
 	fawkes::LuaContext *          lua_;
 	fawkes::LuaInterfaceImporter *lua_ifi_;
+	unsigned int                  lua_execute_;
 };
 
 #endif
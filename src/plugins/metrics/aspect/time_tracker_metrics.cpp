@@ -0,0 +1,77 @@
+
+/***************************************************************************
+ *  time_tracker_metrics.cpp - Export time tracker classes as metrics
+ *
+ *  Created: Fri Oct 16 16:12:37 2026
+ *  Copyright  2017-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#include "time_tracker_metrics.h"
+
+#include <utils/time/tracker.h>
+
+namespace fawkes {
+
+/** Export time tracker classes as metrics.
+ * Creates a summary metric family with one metric per tracker class, labeled
+ * with the class name. Times are given in seconds with the 50th, 99th, and
+ * 99.9th percentile as quantiles and the maximum as quantile 1. The tracker
+ * may be used by another thread while it is exported, for example in the
+ * metrics() method of a MetricsSupplier.
+ * @param tracker time tracker to export
+ * @param name name of the metric family
+ * @param help help string of the metric family
+ * @return metric family for the tracker
+ */
+io::prometheus::client::MetricFamily
+time_tracker_metrics(const TimeTracker &tracker, const std::string &name, const std::string &help)
+{
+	static const double quantiles[] = {0.5, 0.99, 0.999};
+
+	io::prometheus::client::MetricFamily mf;
+	mf.set_name(name);
+	mf.set_help(help);
+	mf.set_type(io::prometheus::client::SUMMARY);
+
+	for (unsigned int cls = 0; cls < tracker.num_classes(); ++cls) {
+		const std::string &class_name = tracker.class_name(cls);
+		if (class_name.empty())
+			continue;
+
+		const TimeHistogram &h = tracker.histogram(cls);
+
+		io::prometheus::client::Metric *   m = mf.add_metric();
+		io::prometheus::client::LabelPair *l = m->add_label();
+		l->set_name("class");
+		l->set_value(class_name);
+
+		io::prometheus::client::Summary *s = m->mutable_summary();
+		s->set_sample_count(h.count());
+		s->set_sample_sum(h.sum() / 1e9);
+		for (double q : quantiles) {
+			io::prometheus::client::Quantile *sq = s->add_quantile();
+			sq->set_quantile(q);
+			sq->set_value(h.percentile(q) / 1e9);
+		}
+		io::prometheus::client::Quantile *sq = s->add_quantile();
+		sq->set_quantile(1.0);
+		sq->set_value(h.max() / 1e9);
+	}
+
+	return mf;
+}
+
+} // end namespace fawkes
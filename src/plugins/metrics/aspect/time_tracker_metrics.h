@@ -0,0 +1,39 @@
+
+/***************************************************************************
+ *  time_tracker_metrics.h - Export time tracker classes as metrics
+ *
+ *  Created: Fri Oct 16 16:12:37 2026
+ *  Copyright  2017-2026  Tim Niemueller [www.niemueller.de]
+ ****************************************************************************/
+
+/*  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Library General Public License for more details.
+ *
+ *  Read the full text in the LICENSE.GPL file in the doc directory.
+ */
+
+#ifndef _PLUGINS_METRICS_ASPECT_TIME_TRACKER_METRICS_H_
+#define _PLUGINS_METRICS_ASPECT_TIME_TRACKER_METRICS_H_
+
+#include <plugins/metrics/protobuf/metrics.pb.h>
+
+#include <string>
+
+namespace fawkes {
+
+class TimeTracker;
+
+io::prometheus::client::MetricFamily time_tracker_metrics(const TimeTracker &tracker,
+                                                          const std::string &name,
+                                                          const std::string &help);
+
+} // end namespace fawkes
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "metrics_thread.h"
 
+#include "aspect/time_tracker_metrics.h"
 #include "metrics_processor.h"
 
 #include <core/threading/mutex_locker.h>
@@ -28,6 +29,7 @@
 #include <interfaces/MetricHistogramInterface.h>
 #include <interfaces/MetricUntypedInterface.h>
 #include <utils/misc/string_split.h>
+#include <utils/time/tracker.h>
 #include <webview/url_manager.h>
 
 #include <algorithm>
@@ -41,6 +43,8 @@ using namespace fawkes;
 
 /** @class MetricsThread "metrics_thread.h"
  * Thread to export metrics for Prometheus.
+ * The time required to read the blackboard metrics and to collect the
+ * metrics of all suppliers is tracked and exported as summary, too.
  * @author Tim Niemueller
  */
 
@@ -122,6 +126,11 @@ MetricsThread::init()
 		                 "Internal metric metrics_proctime bucket bounds not configured, disabling");
 	}
 
+	// each class is only tracked while holding the lock guarding its data
+	tt_              = new TimeTracker();
+	ttc_blackboard_  = tt_->add_class("blackboard");
+	ttc_all_metrics_ = tt_->add_class("all");
+
 	metrics_suppliers_.push_back(this);
 
 	req_proc_ = new MetricsRequestProcessor(this, logger, URL_PREFIX);
@@ -137,6 +146,7 @@ MetricsThread::finalize()
 {
 	webview_url_manager->remove_handler(WebRequest::METHOD_GET, URL_PREFIX);
 	delete req_proc_;
+	delete tt_;
 }
 
 void
@@ -194,6 +204,7 @@ MetricsThread::metrics()
 	std::list<io::prometheus::client::MetricFamily> rv;
 
 	MutexLocker lock(metric_bbs_.mutex());
+	tt_->ping_start(ttc_blackboard_);
 	for (auto &mbbp : metric_bbs_) {
 		auto &mfbb = mbbp.second;
 
@@ -256,6 +267,7 @@ MetricsThread::metrics()
 		}
 		rv.push_back(std::move(mf));
 	}
+	tt_->ping_end(ttc_blackboard_);
 
 	if (imf_metrics_proctime_) {
 		std::chrono::high_resolution_clock::time_point proc_end =
@@ -277,6 +289,9 @@ MetricsThread::metrics()
 	for (auto &im : internal_metrics_) {
 		rv.push_back(std::move(*im));
 	}
+	rv.push_back(time_tracker_metrics(*tt_,
+	                                  "fawkes_metrics_collect_seconds",
+	                                  "Time required to collect metrics"));
 
 	return rv;
 }
@@ -286,9 +301,12 @@ MetricsThread::all_metrics()
 {
 	std::list<io::prometheus::client::MetricFamily> metrics;
 
+	MutexLocker lock(metrics_suppliers_.mutex());
+	tt_->ping_start(ttc_all_metrics_);
 	for (auto &s : metrics_suppliers_) {
 		metrics.splice(metrics.begin(), std::move(s->metrics()));
 	}
+	tt_->ping_end(ttc_all_metrics_);
 
 	return metrics;
 }
@@ -41,6 +41,7 @@
 class MetricsRequestProcessor;
 
 namespace fawkes {
+class TimeTracker;
 class MetricCounterInterface;
 class MetricGaugeInterface;
 class MetricUntypedInterface;
@@ -139,6 +140,10 @@ private:
 
 	std::vector<std::shared_ptr<io::prometheus::client::MetricFamily>> internal_metrics_;
 
+	fawkes::TimeTracker *tt_;
+	unsigned int         ttc_blackboard_;
+	unsigned int         ttc_all_metrics_;
+
 	fawkes::LockList<MetricsSupplier *> metrics_suppliers_;
 };
 
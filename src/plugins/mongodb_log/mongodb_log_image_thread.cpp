@@ -137,6 +137,13 @@ MongoLogImagesThread::loop()
 		fawkes::Time cap_time = imginfo.img->capture_time();
 
 		if ((imginfo.last_sent != cap_time)) {
+			// copy the image first, uploading from the segment would stall the writer
+			SharedMemoryImageBuffer::Frame frame;
+			imginfo.buffer.resize(imginfo.img->image_size());
+			if (!imginfo.img->copy_latest(imginfo.buffer.data(), frame))
+				continue;
+			cap_time = frame.capture_time;
+
 			using namespace bsoncxx::builder;
 			basic::document document;
 			imginfo.last_sent = cap_time;
@@ -151,7 +158,7 @@ MongoLogImagesThread::loop()
 				std::stringstream name;
 				name << imginfo.topic_name << "_" << cap_time.in_msec();
 				auto uploader = gridfs_.open_upload_stream(name.str());
-				uploader.write((uint8_t *)imginfo.img->buffer(), imginfo.img->data_size());
+				uploader.write(imginfo.buffer.data(), imginfo.buffer.size());
 				auto result = uploader.close();
 				subdoc.append(basic::kvp("data", [&](basic::sub_document subdoc) {
 					subdoc.append(basic::kvp("id", result.id()));
@@ -38,6 +38,7 @@
 #include <queue>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace firevision {
 class SharedMemoryImageBuffer;
@@ -86,6 +87,7 @@ private:
 		std::string                          topic_name;
 		fawkes::Time                         last_sent;
 		firevision::SharedMemoryImageBuffer *img;
+		std::vector<uint8_t>                 buffer;
 	} ImageInfo;
 	/// @endcond
 	std::map<std::string, ImageInfo> imgs_;
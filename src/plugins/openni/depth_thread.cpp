@@ -77,8 +77,11 @@ OpenNiDepthThread::init()
 	depth_width_  = depth_md_->XRes();
 	depth_height_ = depth_md_->YRes();
 
-	depth_buf_ =
-	  new SharedMemoryImageBuffer("openni-depth", RAW16, depth_md_->XRes(), depth_md_->YRes());
+	depth_buf_ = new SharedMemoryImageBuffer("openni-depth",
+	                                         RAW16,
+	                                         depth_md_->XRes(),
+	                                         depth_md_->YRes(),
+	                                         /* slots */ 1);
 	depth_bufsize_ = colorspace_buffer_size(RAW16, depth_md_->XRes(), depth_md_->YRes());
 
 	depth_gen_->StartGenerating();
@@ -152,10 +152,14 @@ OpenNiImageThread::init()
 	image_buf_yuv_ = new SharedMemoryImageBuffer("openni-image-yuv",
 	                                             YUV422_PLANAR,
 	                                             image_md_->XRes(),
-	                                             image_md_->YRes());
+	                                             image_md_->YRes(),
+	                                             /* slots */ 1);
 
-	image_buf_rgb_ =
-	  new SharedMemoryImageBuffer("openni-image-rgb", RGB, image_md_->XRes(), image_md_->YRes());
+	image_buf_rgb_ = new SharedMemoryImageBuffer("openni-image-rgb",
+	                                             RGB,
+	                                             image_md_->XRes(),
+	                                             image_md_->YRes(),
+	                                             /* slots */ 1);
 
 	image_gen_->StartGenerating();
 
@@ -103,7 +103,8 @@ OpenNiPointCloudThread::init()
 	pcl_xyz_buf_ = new SharedMemoryImageBuffer("openni-pointcloud-xyz",
 	                                           CARTESIAN_3D_FLOAT,
 	                                           depth_md_->XRes(),
-	                                           depth_md_->YRes());
+	                                           depth_md_->YRes(),
+	                                           /* slots */ 1);
 
 	pcl_xyz_buf_->set_frame_id(cfg_register_depth_image_ ? cfg_frame_image_.c_str()
 	                                                     : cfg_frame_depth_.c_str());
@@ -111,7 +112,8 @@ OpenNiPointCloudThread::init()
 	pcl_xyzrgb_buf_ = new SharedMemoryImageBuffer("openni-pointcloud-xyzrgb",
 	                                              CARTESIAN_3D_FLOAT_RGB,
 	                                              depth_md_->XRes(),
-	                                              depth_md_->YRes());
+	                                              depth_md_->YRes(),
+	                                              /* slots */ 1);
 
 	pcl_xyzrgb_buf_->set_frame_id(cfg_register_depth_image_ ? cfg_frame_image_.c_str()
 	                                                        : cfg_frame_depth_.c_str());
@@ -196,8 +196,11 @@ OpenNiUserTrackerThread::init()
 	depth_gen_->StartGenerating();
 	user_gen_->StartGenerating();
 
-	label_buf_ =
-	  new SharedMemoryImageBuffer("openni-labels", RAW16, scene_md_->XRes(), scene_md_->YRes());
+	label_buf_ = new SharedMemoryImageBuffer("openni-labels",
+	                                         RAW16,
+	                                         scene_md_->XRes(),
+	                                         scene_md_->YRes(),
+	                                         /* slots */ 1);
 	label_bufsize_ = colorspace_buffer_size(RAW16, scene_md_->XRes(), scene_md_->YRes());
 
 	usergen_autoptr.release();
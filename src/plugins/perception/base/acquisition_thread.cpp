@@ -33,6 +33,7 @@
 #	include <utils/time/clock.h>
 #	include <utils/time/tracker.h>
 #endif
+#include <fvcams/external_buffers.h>
 #include <fvcams/shmem.h>
 #include <fvutils/color/conversions.h>
 #include <interfaces/SwitchInterface.h>
@@ -55,6 +56,11 @@ using namespace firevision;
  * This thread is used by the base application to acquire images from a camera
  * and call dependant threads when new images are available so that these
  * threads can start processing the images.
+ *
+ * If the camera can capture to external buffers and there are at least three
+ * image slots, images are captured directly to the shared memory segment of
+ * the camera's colorspace. Conversions to other colorspaces are only done if
+ * a vision thread requested them.
  * @author Tim Niemueller
  */
 
@@ -64,11 +70,15 @@ using namespace firevision;
  * to the base thread
  * @param camera camera to manage
  * @param clock clock to use for timeout measurement (system time)
+ * @param num_image_slots number of images in the ring buffer of each
+ * shared memory segment, with more than one the images are written
+ * without locking the segment
  */
-FvAcquisitionThread::FvAcquisitionThread(const char *id,
-                                         Camera *    camera,
-                                         Logger *    logger,
-                                         Clock *     clock)
+FvAcquisitionThread::FvAcquisitionThread(const char * id,
+                                         Camera *     camera,
+                                         Logger *     logger,
+                                         Clock *      clock,
+                                         unsigned int num_image_slots)
 : Thread("FvAcquisitionThread"), BlackBoardInterfaceListener("FvAcquisitionThread::%s", id)
 {
 	set_prepfin_conc_loop(true);
@@ -87,6 +97,36 @@ FvAcquisitionThread::FvAcquisitionThread(const char *id,
 	height_     = camera_->pixel_height();
 	colorspace_ = camera_->colorspace();
 
+	num_image_slots_ = num_image_slots;
+
+	// one slot holds the latest image, at least two are needed for capturing
+	extbuf_camera_ = NULL;
+	extbuf_shm_    = NULL;
+	CameraExternalBuffers *ebc = dynamic_cast<CameraExternalBuffers *>(camera_);
+	if (ebc && ebc->external_buffers_supported() && (num_image_slots_ >= 3)
+	    && (colorspace_buffer_size(colorspace_, width_, height_) >= ebc->external_buffer_size())) {
+		char *tmp;
+		if (asprintf(&tmp, "%s.%zu", image_id_, shm_.size()) == -1) {
+			throw OutOfMemoryException("FvAcqThread: Could not create image ID");
+		}
+		SharedMemoryImageBuffer *shm =
+		  new SharedMemoryImageBuffer(tmp, colorspace_, width_, height_, num_image_slots_);
+		free(tmp);
+		shm_[colorspace_] = shm;
+
+		for (unsigned int i = 0; i < num_image_slots_; ++i) {
+			extbuf_buffers_.push_back(shm->slot_buffer(i));
+		}
+		try {
+			ebc->set_external_buffers(num_image_slots_, extbuf_buffers_.data(), shm->image_size());
+			extbuf_camera_ = ebc;
+			extbuf_shm_    = shm;
+		} catch (Exception &e) {
+			// capture to the camera's buffers and copy
+			extbuf_buffers_.clear();
+		}
+	}
+
 	mode_    = AqtContinuous;
 	enabled_ = false;
 
@@ -123,6 +163,21 @@ FvAcquisitionThread::init()
 {
 	logger->log_debug(
 	  name(), "Camera opened, w=%u  h=%u  c=%s", width_, height_, colorspace_to_string(colorspace_));
+	if (extbuf_camera_) {
+		logger->log_debug(name(), "Capturing to %s without copying", extbuf_shm_->image_id());
+	} else {
+		CameraExternalBuffers *ebc = dynamic_cast<CameraExternalBuffers *>(camera_);
+		if (ebc && ebc->external_buffers_supported()) {
+			if (num_image_slots_ < 3) {
+				logger->log_info(name(),
+				                 "Copying images, capturing without copying needs at least "
+				                 "3 image slots, configured are %u",
+				                 num_image_slots_);
+			} else {
+				logger->log_info(name(), "Copying images, camera cannot capture to shared memory");
+			}
+		}
+	}
 
 	std::string if_id = std::string("Camera ") + image_id_;
 	enabled_if_       = blackboard->open_for_writing<SwitchInterface>(if_id.c_str());
@@ -192,7 +247,8 @@ FvAcquisitionThread::camera_instance(colorspace_t cspace, bool deep_copy)
 				throw OutOfMemoryException("FvAcqThread::camera_instance(): Could not create image ID");
 			}
 			img_id       = tmp;
-			shm_[cspace] = new SharedMemoryImageBuffer(img_id, cspace, width_, height_);
+			shm_[cspace] =
+			  new SharedMemoryImageBuffer(img_id, cspace, width_, height_, num_image_slots_);
 		} else {
 			img_id = shm_[cspace]->image_id();
 		}
@@ -254,6 +310,14 @@ FvAcquisitionThread::set_enabled(bool enabled)
 	} else if (!enabled_ && enabled) {
 		// enabling thread
 		camera_->start();
+		if (extbuf_camera_) {
+			try {
+				queue_external_buffers();
+			} catch (Exception &e) {
+				logger->log_warn(name(), e);
+				capture_to_camera_buffers();
+			}
+		}
 		enabled_if_->set_enabled(true);
 		enabled_if_->write();
 
@@ -313,30 +377,45 @@ FvAcquisitionThread::loop()
 	Thread::CancelState old_cancel_state;
 	set_cancel_state(Thread::CANCEL_DISABLED, &old_cancel_state);
 
+	bool extbuf_queued = true;
+
 #ifdef FVBASE_TIMETRACKER
 	try {
 		if (enabled_) {
 			tt_->ping_start(ttc_capture_);
 			camera_->capture();
+			if (extbuf_camera_) {
+				extbuf_queued = publish_external_buffer();
+			}
 			tt_->ping_end(ttc_capture_);
 
 			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
+				if ((shmit_->first == CS_UNKNOWN) || (shmit_->second == extbuf_shm_))
 					continue;
+				// with multiple slots readers never access the slot being written
+				bool locked = (shmit_->second->num_slots() == 1);
 				tt_->ping_start(ttc_lock_);
-				shmit_->second->lock_for_write();
+				if (locked)
+					shmit_->second->lock_for_write();
 				tt_->ping_end(ttc_lock_);
 				tt_->ping_start(ttc_convert_);
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
+				convert(colorspace_,
+				        shmit_->first,
+				        camera_->buffer(),
+				        shmit_->second->begin_write(),
+				        width_,
+				        height_);
+				Time *capture_time = NULL;
 				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
+					capture_time = camera_->capture_time();
 				} catch (NotImplementedException &e) {
 					// ignored
 				}
+				shmit_->second->end_write(capture_time);
 				tt_->ping_end(ttc_convert_);
 				tt_->ping_start(ttc_unlock_);
-				shmit_->second->unlock();
+				if (locked)
+					shmit_->second->unlock();
 				tt_->ping_end(ttc_unlock_);
 			}
 		}
@@ -348,6 +427,9 @@ FvAcquisitionThread::loop()
 		tt_->ping_start(ttc_dispose_);
 		camera_->dispose_buffer();
 		tt_->ping_end(ttc_dispose_);
+		if (!extbuf_queued) {
+			capture_to_camera_buffers();
+		}
 	}
 
 	if ((++loop_count_ % FVBASE_TT_PRINT_INT) == 0) {
@@ -358,18 +440,31 @@ FvAcquisitionThread::loop()
 	try {
 		if (enabled_) {
 			camera_->capture();
+			if (extbuf_camera_) {
+				extbuf_queued = publish_external_buffer();
+			}
 			for (shmit_ = shm_.begin(); shmit_ != shm_.end(); ++shmit_) {
-				if (shmit_->first == CS_UNKNOWN)
+				if ((shmit_->first == CS_UNKNOWN) || (shmit_->second == extbuf_shm_))
 					continue;
-				shmit_->second->lock_for_write();
-				convert(
-				  colorspace_, shmit_->first, camera_->buffer(), shmit_->second->buffer(), width_, height_);
+				// with multiple slots readers never access the slot being written
+				bool locked = (shmit_->second->num_slots() == 1);
+				if (locked)
+					shmit_->second->lock_for_write();
+				convert(colorspace_,
+				        shmit_->first,
+				        camera_->buffer(),
+				        shmit_->second->begin_write(),
+				        width_,
+				        height_);
+				Time *capture_time = NULL;
 				try {
-					shmit_->second->set_capture_time(camera_->capture_time());
+					capture_time = camera_->capture_time();
 				} catch (NotImplementedException &e) {
 					// ignored
 				}
-				shmit_->second->unlock();
+				shmit_->second->end_write(capture_time);
+				if (locked)
+					shmit_->second->unlock();
 			}
 		}
 	} catch (Exception &e) {
@@ -377,6 +472,9 @@ FvAcquisitionThread::loop()
 	}
 	if (enabled_) {
 		camera_->dispose_buffer();
+		if (!extbuf_queued) {
+			capture_to_camera_buffers();
+		}
 	}
 #endif
 
@@ -393,6 +491,88 @@ FvAcquisitionThread::loop()
 	}
 }
 
+/** Queue all slots but the one of the latest image for capturing. */
+void
+FvAcquisitionThread::queue_external_buffers()
+{
+	for (unsigned int i = 0; i + 1 < num_image_slots_; ++i) {
+		extbuf_camera_->queue_external_buffer(external_buffer_index(extbuf_shm_->begin_write(i)));
+	}
+}
+
+/** Publish captured image and queue the slot of the previous image.
+ * @return true if the slot has been queued, false if the camera rejected
+ * it, capture_to_camera_buffers() must be called after dispose_buffer()
+ * in that case
+ */
+bool
+FvAcquisitionThread::publish_external_buffer()
+{
+	int index = extbuf_camera_->current_external_buffer();
+	if (index < 0)
+		return true;
+
+	if (extbuf_buffers_[index] != extbuf_shm_->begin_write()) {
+		// images are published in order, hence the buffers must be filled in order
+		logger->log_warn(name(), "Image captured out of order, dropping");
+		try {
+			extbuf_camera_->queue_external_buffer(index);
+		} catch (Exception &e) {
+			logger->log_warn(name(), e);
+			return false;
+		}
+		return true;
+	}
+
+	Time *capture_time = NULL;
+	try {
+		capture_time = camera_->capture_time();
+	} catch (NotImplementedException &e) {
+		// ignored
+	}
+	extbuf_shm_->end_write(capture_time);
+
+	// the previous image is no longer the latest and may be overwritten
+	unsigned char *next = extbuf_shm_->begin_write(num_image_slots_ - 2);
+	try {
+		extbuf_camera_->queue_external_buffer(external_buffer_index(next));
+	} catch (Exception &e) {
+		logger->log_warn(name(), e);
+		return false;
+	}
+	return true;
+}
+
+/** Stop capturing to the shared memory slots.
+ * Called if the camera rejected a slot. The camera is restarted with its
+ * own buffers and images are copied to the shared memory segment like to
+ * those of all other colorspaces.
+ */
+void
+FvAcquisitionThread::capture_to_camera_buffers()
+{
+	logger->log_warn(name(),
+	                 "Cannot capture to %s without copying, falling back to copying",
+	                 extbuf_shm_->image_id());
+	camera_->stop();
+	extbuf_camera_->unset_external_buffers();
+	extbuf_camera_ = NULL;
+	extbuf_shm_    = NULL;
+	extbuf_buffers_.clear();
+	camera_->start();
+}
+
+/** Get index of a slot's buffer as registered with the camera.
+ * @param buffer slot buffer
+ * @return buffer index
+ */
+unsigned int
+FvAcquisitionThread::external_buffer_index(unsigned char *buffer)
+{
+	return std::find(extbuf_buffers_.begin(), extbuf_buffers_.end(), buffer)
+	       - extbuf_buffers_.begin();
+}
+
 bool
 FvAcquisitionThread::bb_interface_message_received(Interface *interface, Message *message) throw()
 {
@@ -31,6 +31,7 @@
 #include <fvutils/color/colorspaces.h>
 
 #include <map>
+#include <vector>
 
 namespace fawkes {
 class Logger;
@@ -44,7 +45,8 @@ class TimeTracker;
 } // namespace fawkes
 namespace firevision {
 class SharedMemoryImageBuffer;
-}
+class CameraExternalBuffers;
+} // namespace firevision
 class FvBaseThread;
 class FvAqtVisionThreads;
 
@@ -65,7 +67,8 @@ public:
 	FvAcquisitionThread(const char *        id,
 	                    firevision::Camera *camera,
 	                    fawkes::Logger *    logger,
-	                    fawkes::Clock *     clock);
+	                    fawkes::Clock *     clock,
+	                    unsigned int        num_image_slots = 3);
 	virtual ~FvAcquisitionThread();
 
 	virtual void init();
@@ -100,6 +103,10 @@ protected:
 private:
 	virtual bool bb_interface_message_received(fawkes::Interface *interface,
 	                                           fawkes::Message *  message) throw();
+	void         queue_external_buffers();
+	bool         publish_external_buffer();
+	void         capture_to_camera_buffers();
+	unsigned int external_buffer_index(unsigned char *buffer);
 
 private:
 	bool                   enabled_;
@@ -112,12 +119,17 @@ private:
 	firevision::colorspace_t colorspace_;
 	unsigned int             width_;
 	unsigned int             height_;
+	unsigned int             num_image_slots_;
 
 	AqtMode mode_;
 
 	std::map<firevision::colorspace_t, firevision::SharedMemoryImageBuffer *>           shm_;
 	std::map<firevision::colorspace_t, firevision::SharedMemoryImageBuffer *>::iterator shmit_;
 
+	firevision::CameraExternalBuffers *  extbuf_camera_;
+	firevision::SharedMemoryImageBuffer *extbuf_shm_;
+	std::vector<unsigned char *>         extbuf_buffers_;
+
 	fawkes::SwitchInterface *enabled_if_;
 
 #ifdef FVBASE_TIMETRACKER
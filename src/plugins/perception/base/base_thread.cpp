@@ -59,6 +59,9 @@ FvBaseThread::FvBaseThread()
 {
 	// default to 30 seconds
 	aqt_timeout_ = 30;
+	// triple buffering, the acquisition thread never waits for readers and
+	// cameras can capture to the shared memory segment directly
+	aqt_image_slots_ = 3;
 	aqt_barrier_ = new Barrier(1);
 }
 
@@ -75,6 +78,11 @@ FvBaseThread::init()
 	// that are orphaned
 	SharedMemoryImageBuffer::cleanup(/* use lister */ false);
 	SharedMemoryLookupTable::cleanup(/* use lister */ false);
+
+	try {
+		aqt_image_slots_ = std::max(1u, config->get_uint("/firevision/base/image_slots"));
+	} catch (Exception &e) {
+	} // ignored, use default
 }
 
 void
@@ -255,7 +263,8 @@ FvBaseThread::register_for_camera(const char *camera_string, Thread *thread, col
 				throw;
 			}
 
-			FvAcquisitionThread *aqt = new FvAcquisitionThread(id.c_str(), cam, logger, clock);
+			FvAcquisitionThread *aqt =
+			  new FvAcquisitionThread(id.c_str(), cam, logger, clock, aqt_image_slots_);
 
 			c = aqt->camera_instance(cspace,
 			                         (vision_thread->vision_thread_mode() == VisionAspect::CONTINUOUS));
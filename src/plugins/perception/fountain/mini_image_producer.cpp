@@ -72,7 +72,8 @@ MiniImageProducer::MiniImageProducer(const char *    orig_id,
 		mini_shmem = new SharedMemoryImageBuffer(mini_id,
 		                                         YUV422_PLANAR,
 		                                         scaler->needed_scaled_width(),
-		                                         scaler->needed_scaled_height());
+		                                         scaler->needed_scaled_height(),
+		                                         /* slots */ 1);
 
 		if (!mini_shmem->is_valid()) {
 			logger->log_error("MiniImageProducer", "Could not open mini image");
@@ -98,7 +98,8 @@ FvRetrieverThread::init()
 		shm = new SharedMemoryImageBuffer(imgbufname,
 		                                  cam->colorspace(),
 		                                  cam->pixel_width(),
-		                                  cam->pixel_height());
+		                                  cam->pixel_height(),
+		                                  /* slots */ 1);
 
 		free(imgbufname);
 		if (!shm->is_valid()) {
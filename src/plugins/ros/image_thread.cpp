@@ -83,9 +83,36 @@ RosImagesThread::loop()
 	std::map<std::string, PublisherInfo>::iterator p;
 	for (p = pubs_.begin(); p != pubs_.end(); ++p) {
 		PublisherInfo &pubinfo = p->second;
+		if (pubinfo.pub.getNumSubscribers() == 0) {
+			continue;
+		}
+
+		if (pubinfo.img->num_slots() > 1) {
+			// the writer does not lock ring buffers, only publish images
+			// which have not been overwritten during conversion
+			SharedMemoryImageBuffer::Frame frame;
+			if (!pubinfo.img->read_latest(frame) || (pubinfo.last_sent == frame.capture_time)) {
+				continue;
+			}
+			convert(pubinfo.img->colorspace(),
+			        RGB,
+			        frame.buffer,
+			        &pubinfo.msg.data[0],
+			        pubinfo.msg.width,
+			        pubinfo.msg.height);
+			if (!pubinfo.img->is_valid(frame)) {
+				continue;
+			}
+			pubinfo.last_sent = frame.capture_time;
+			pubinfo.msg.header.seq += 1;
+			pubinfo.msg.header.stamp =
+			  ros::Time(frame.capture_time.get_sec(), frame.capture_time.get_usec() * 1000);
+			pubinfo.pub.publish(pubinfo.msg);
+			continue;
+		}
 
 		fawkes::Time cap_time = pubinfo.img->capture_time();
-		if ((pubinfo.last_sent != cap_time) && (pubinfo.pub.getNumSubscribers() > 0)) {
+		if (pubinfo.last_sent != cap_time) {
 			pubinfo.last_sent = cap_time;
 
 			//logger->log_debug(name(), "Need to send %s", p->first.c_str());
@@ -128,6 +128,7 @@ SkillerExecutionThread::init()
 		                             "skiller.fawkes.finalize_cancel()");
 
 		lua_->set_start_script(LUADIR "/skiller/fawkes/start.lua");
+		lua_loop_ = lua_->compile_string("skillenv.loop()");
 
 		lua_->add_watcher(this);
 
@@ -228,5 +229,5 @@ SkillerExecutionThread::loop()
 	}
 	skiller_if_removed_readers_.unlock();
 
-	lua_->do_string("skillenv.loop()");
+	lua_->call_compiled(lua_loop_);
 }
@@ -105,6 +105,7 @@ private: /* members */
 	fawkes::SkillerInterface *skiller_if_;
 
 	fawkes::LuaContext *lua_;
+	unsigned int        lua_loop_;
 
 	std::list<SkillerFeature *> features_;
 };
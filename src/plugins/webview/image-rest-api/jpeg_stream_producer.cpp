@@ -150,7 +150,8 @@ WebviewJpegStreamProducer::wait_for_next_frame()
 void
 WebviewJpegStreamProducer::init()
 {
-	cam_  = new SharedMemoryCamera(image_id_.c_str(), /* deep copy */ false);
+	// copy on capture, compression must not hold up the image writer
+	cam_  = new SharedMemoryCamera(image_id_.c_str(), /* deep copy */ true);
 	jpeg_ = new JpegImageCompressor(quality_);
 	jpeg_->set_image_dimensions(cam_->pixel_width(), cam_->pixel_height());
 	jpeg_->set_compression_destination(ImageCompressor::COMP_DEST_MEM);
@@ -177,7 +178,6 @@ WebviewJpegStreamProducer::loop()
 	unsigned char *buffer = (unsigned char *)malloc(size);
 	jpeg_->set_destination_buffer(buffer, size);
 
-	cam_->lock_for_read();
 	cam_->capture();
 	firevision::convert(cam_->colorspace(),
 	                    YUV422_PLANAR,
@@ -187,7 +187,6 @@ WebviewJpegStreamProducer::loop()
 	                    cam_->pixel_height());
 	jpeg_->compress();
 	cam_->dispose_buffer();
-	cam_->unlock();
 
 	std::shared_ptr<Buffer> shared_buf = std::make_shared<Buffer>(buffer, jpeg_->compressed_size());
 	subs_.lock();
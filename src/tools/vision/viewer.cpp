@@ -214,7 +214,8 @@ main(int argc, char **argv)
 		buf = new SharedMemoryImageBuffer(argp.arg("o"),
 		                                  cam->colorspace(),
 		                                  cam->pixel_width(),
-		                                  cam->pixel_height());
+		                                  cam->pixel_height(),
+		                                  /* slots */ 1);
 	}
 
 	print_keys();